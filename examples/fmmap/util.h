@@ -31,17 +31,6 @@
 
 using namespace nvbio;
 
-// divide by two
-//
-struct divide_by_two
-{
-    typedef uint32  argument_type;
-    typedef uint32  result_type;
-
-    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-    result_type operator() (const argument_type op) const { return op / 2u; }
-};
-
 // return 1 or 0 depending on whether a number is >= than a given threshold
 struct above_threshold
 {
@@ -58,35 +47,3 @@ struct above_threshold
 
     const int16 t;
 };
-
-// update the best scores vector
-//
-__global__
-void update_scores_kernel(
-    const uint32  n,
-    const uint32* reads,
-    const int16*  scores,
-        int16*    best)
-{
-    const uint32 i = threadIdx.x + blockIdx.x * blockDim.x;
-    if (i >= n) return;
-
-    const uint32 read_id = reads[i];
-    const int16  score   = scores[i];
-
-    best[ read_id ] = nvbio::max( best[ read_id ], score );
-}
-
-// update the best scores vector
-//
-void update_scores(
-    const uint32  n,
-    const uint32* reads,
-    const int16*  scores,
-        int16*    best)
-{
-    const uint32 block_dim = 128;
-    const uint32 n_blocks = util::divide_ri( n, block_dim );
-
-    update_scores_kernel<<<n_blocks,block_dim>>>( n, reads, scores, best );
-}
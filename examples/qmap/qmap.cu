@@ -40,6 +40,7 @@
 #include <nvbio/strings/seeds.h>
 #include <nvbio/qgram/qgram.h>
 #include <nvbio/qgram/filter.h>
+#include <nvbio/qgram/qmap.h>
 #include <nvbio/io/sequence/sequence.h>
 
 #include "alignment.h"
@@ -319,6 +320,108 @@ void map(
     }
 }
 
+// map all reads on the host, streaming the reference against an index of each read batch
+//
+int map_host(
+    const QMapParams&           params,
+    const char*                 reference,
+    io::SequenceDataStream*     read_file,
+    const uint32                batch_reads,
+    const uint32                batch_bps,
+    const int16                 score_threshold,
+    const char*                 output_name)
+{
+    // open the reference as a stream, so as to keep a single chunk in memory at a time;
+    // notice that io::next() never splits a sequence, so that a chunk can exceed chunk_bps
+    SharedPointer<io::SequenceDataStream> ref_file( io::open_sequence_file( reference ) );
+    if (ref_file == NULL || ref_file->is_ok() == false)
+    {
+        log_error(stderr, "    failed opening reference \"%s\"\n", reference);
+        return 1u;
+    }
+
+    FILE* output = NULL;
+    if (output_name && (output = fopen( output_name, "w" )) == NULL)
+    {
+        log_error(stderr, "    failed opening output \"%s\"\n", output_name);
+        return 1u;
+    }
+
+    QMapper<> mapper( params );
+
+    io::SequenceDataHost            h_read_data;
+    io::SequenceDataHost            h_ref_chunk;
+    nvbio::vector<host_tag,QMapHit> best_hits;
+
+    uint64 n_reads   = 0;
+    uint64 n_aligned = 0;
+
+    Timer timer;
+    timer.start();
+
+    while (io::next( DNA_N, &h_read_data, read_file, batch_reads, batch_bps ))
+    {
+        log_info(stderr, "  indexing %u reads\n", h_read_data.size() / 2);
+
+        mapper.index( h_read_data );
+
+        // stream the whole reference through the read index
+        if (ref_file->rewind() == false)
+        {
+            log_error(stderr, "    failed rewinding reference \"%s\"\n", reference);
+            if (output)
+                fclose( output );
+            return 1u;
+        }
+
+        uint64 ref_offset = 0;
+        while (io::next( DNA, &h_ref_chunk, ref_file.get(), uint32(-1), params.chunk_bps ))
+        {
+            mapper.map( h_ref_chunk, ref_offset );
+
+            ref_offset += h_ref_chunk.bps();
+
+            log_verbose(stderr, "\r  streamed %.2f M bps of reference", 1.0e-6f * float( ref_offset ));
+        }
+        log_verbose_cont(stderr, "\n");
+
+        // collect the best hits of this batch
+        mapper.best_hits( best_hits );
+
+        for (uint32 i = 0; i < uint32( best_hits.size() ); ++i)
+        {
+            const QMapHit hit = best_hits[i];
+
+            n_aligned += above_threshold( score_threshold )( hit.score );
+
+            if (output && hit.is_valid())
+                fprintf( output, "%llu\t%d\t%c\t%llu\n", (unsigned long long)(n_reads + i), int( hit.score ), hit.strand ? '-' : '+', (unsigned long long)hit.pos );
+        }
+        n_reads += best_hits.size();
+
+        log_info(stderr, "  aligned %6.2f %% reads (%.2f M reads)\n", 100.0f * float( n_aligned ) / float( n_reads ), 1.0e-6f * float( n_reads ));
+    }
+
+    timer.stop();
+    const float time = timer.seconds();
+
+    if (output)
+        fclose( output );
+
+    const QMapStats stats = mapper.stats();
+
+    log_info(stderr, "  aligned %6.2f %% reads (%6.2f K reads/s)\n", 100.0f * float( n_aligned ) / float( n_reads ), (1.0e-3f * float( n_reads )) / time);
+    log_verbose(stderr, "  breakdown (thread-seconds):\n");
+    log_verbose(stderr, "    index time         : %.2f s\n", stats.index_time);
+    log_verbose(stderr, "    extract throughput : %.2f B q-grams/s\n", (1.0e-9f * float( stats.queries )) / stats.extract_time);
+    log_verbose(stderr, "    rank throughput    : %6.2f B q-grams/s\n", (1.0e-9f * float( stats.queries )) / stats.rank_time);
+    log_verbose(stderr, "    locate throughput  : %6.2f M hits/s\n", (1.0e-6f * float( stats.occurrences )) / stats.locate_time);
+    log_verbose(stderr, "    align throughput   : %6.2f M hits/s\n", (1.0e-6f * float( stats.merged )) / stats.align_time);
+    log_verbose(stderr, "    occurrences        : %.3f B\n", 1.0e-9f * float( stats.occurrences ) );
+    log_verbose(stderr, "    merged occurrences : %.3f B (%.1f %%)\n", 1.0e-9f * float( stats.merged ), 100.0f * float(stats.merged)/float(stats.occurrences));
+    return 0;
+}
+
 // main test entry point
 //
 int main(int argc, char* argv[])
@@ -339,6 +442,9 @@ int main(int argc, char* argv[])
     uint32 merge_intv       = 16;
     uint32 max_reads        = uint32(-1);
     int16  score_threshold  = -20;
+    bool   host             = false;
+    uint32 chunk_bps        = 64*1024*1024;
+    const char* output_name = NULL;
 
     for (int i = 0; i < argc; ++i)
     {
@@ -353,10 +459,56 @@ int main(int argc, char* argv[])
             max_reads = uint32( atoi( argv[++i] ) );
         else if (strcmp( argv[i], "-t" ) == 0)
             score_threshold = int16( atoi( argv[++i] ) );
+        else if (strcmp( argv[i], "-cpu" ) == 0)
+            host = true;
+        else if (strcmp( argv[i], "-chunk" ) == 0)
+            chunk_bps = uint32( atoi( argv[++i] ) );
+        else if (strcmp( argv[i], "-o" ) == 0)
+            output_name = argv[++i];
     }
 
     log_info(stderr, "qmap... started\n");
 
+    // open a read file
+    log_info(stderr, "  opening reads file... started\n");
+
+    SharedPointer<io::SequenceDataStream> read_data_file(
+        io::open_sequence_file(
+            reads,
+            io::Phred33,
+            2*max_reads,
+            uint32(-1),
+            io::SequenceEncoding( io::FORWARD | io::REVERSE_COMPLEMENT ) ) );
+
+    // check whether the file opened correctly
+    if (read_data_file == NULL || read_data_file->is_ok() == false)
+    {
+        log_error(stderr, "    failed opening file \"%s\"\n", reads);
+        return 1u;
+    }
+    log_info(stderr, "  opening reads file... done\n");
+
+    if (host)
+    {
+        QMapParams params;
+        params.Q          = Q;
+        params.Q_intv     = Q_intv;
+        params.merge_intv = merge_intv;
+        params.chunk_bps  = chunk_bps;
+
+        const int r = map_host(
+            params,
+            index,
+            read_data_file.get(),
+            batch_reads,
+            batch_bps,
+            score_threshold,
+            output_name );
+
+        log_info(stderr, "qmap... done\n");
+        return r;
+    }
+
     // load a genome archive...
     log_visible(stderr, "  loading reference index ... started\n");
     log_info(stderr, "  file: \"%s\"\n", index);
@@ -386,25 +538,6 @@ int main(int argc, char* argv[])
     const uint32      genome_len = d_genome_data.bps();
     const genome_type d_genome( d_genome_access.sequence_stream() );
 
-    // open a read file
-    log_info(stderr, "  opening reads file... started\n");
-
-    SharedPointer<io::SequenceDataStream> read_data_file(
-        io::open_sequence_file(
-            reads,
-            io::Phred33,
-            2*max_reads,
-            uint32(-1),
-            io::SequenceEncoding( io::FORWARD | io::REVERSE_COMPLEMENT ) ) );
-
-    // check whether the file opened correctly
-    if (read_data_file == NULL || read_data_file->is_ok() == false)
-    {
-        log_error(stderr, "    failed opening file \"%s\"\n", reads);
-        return 1u;
-    }
-    log_info(stderr, "  opening reads file... done\n");
-
     // keep stats
     Stats stats;
 
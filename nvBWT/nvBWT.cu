@@ -353,6 +353,75 @@ void save_ssa(const uint32 seq_length, const uint32 sa_intv, const uint32 ssa_le
     log_info(stderr, "writing \"%s\"... done\n", sa_name);
 }
 
+//
+// .lcp file
+//
+struct LCPWriter
+{
+    LCPWriter(FILE* _file) : file( _file ) {}
+
+    // write a block of the LCP array
+    void process(const uint32 block_begin, const uint32 block_end, const uint32* lcp)
+    {
+        fwrite( lcp, sizeof(uint32), block_end - block_begin, file );
+    }
+
+    FILE* file;
+};
+
+template <typename lcp_handler_type>
+void save_lcp(const uint32 seq_length, const lcp_handler_type& lcp_handler, const char* lcp_name)
+{
+    // the PLCP sampling rate and the LCP block size used to stream the array to disk
+    const uint32 LCP_SAMPLING   = 32u;
+    const uint32 LCP_BLOCK_SIZE = 16*1024*1024;
+
+    log_info(stderr, "\nwriting \"%s\"... started\n", lcp_name);
+    FILE* output_file = fopen( lcp_name, "wb" );
+    if (output_file == NULL)
+    {
+        log_error(stderr, "  could not open output file \"%s\"!\n", lcp_name );
+        exit(1);
+    }
+
+    fwrite( &seq_length,    sizeof(uint32),     1u,         output_file );
+
+    LCPWriter writer( output_file );
+    lcp_handler.lcp( LCP_SAMPLING, LCP_BLOCK_SIZE, writer );
+
+    fclose( output_file );
+    log_info(stderr, "writing \"%s\"... done\n", lcp_name);
+}
+
+// a StringSuffixHandler computing both the BWT and the full SA needed to derive the LCP
+//
+template <typename bwt_handler_type, typename lcp_handler_type>
+struct BWTLCPHandler
+{
+    BWTLCPHandler(bwt_handler_type& _bwt_handler, lcp_handler_type& _lcp_handler) :
+        bwt_handler( _bwt_handler ), lcp_handler( _lcp_handler ) {}
+
+    void process_batch(
+        const uint32  n_suffixes,
+        const uint32* d_suffixes)
+    {
+        bwt_handler.process_batch( n_suffixes, d_suffixes );
+        lcp_handler.process_batch( n_suffixes, d_suffixes );
+    }
+
+    void process_scattered(
+        const uint32  n_suffixes,
+        const uint32* d_suffixes,
+        const uint32* d_slots)
+    {
+        bwt_handler.process_scattered( n_suffixes, d_suffixes, d_slots );
+        lcp_handler.process_scattered( n_suffixes, d_suffixes, d_slots );
+    }
+
+    bwt_handler_type& bwt_handler;
+    lcp_handler_type& lcp_handler;
+};
+
 int build(
     const char*  input_name,
     const char*  output_name,
@@ -362,6 +431,7 @@ int build(
     const char*  rbwt_name,
     const char*  sa_name,
     const char*  rsa_name,
+    const char*  lcp_name,
     const uint64 max_length,
     const PacType pac_type,
     const bool    compute_crc)
@@ -473,6 +543,49 @@ int build(
 
         log_info(stderr, "\nbuilding forward BWT... started\n");
         timer.start();
+        if (lcp_name)
+        {
+            // keep the full SA on the host, to derive both the SSA and the LCP
+            thrust::host_vector<uint32> h_sa( seq_length+1 );
+
+            typedef StringBWTHandler<const_stream_type,stream_type>     bwt_handler_type;
+            typedef StringLCPHandler<const_stream_type,uint32*>         lcp_handler_type;
+
+            bwt_handler_type bwt_handler(
+                seq_length,                         // string length
+                d_string,                           // string
+                d_bwt );                            // output bwt iterator
+
+            lcp_handler_type lcp_handler(
+                seq_length,                         // string length
+                const_stream_type( nvbio::plain_view( h_string_storage ) ), // host string
+                nvbio::plain_view( h_sa ) );        // output sa iterator
+
+            BWTLCPHandler<bwt_handler_type,lcp_handler_type> output( bwt_handler, lcp_handler );
+
+            cuda::blockwise_suffix_sort(
+                seq_length,
+                d_string,
+                output,
+                &params );
+
+            // remove the dollar symbol
+            bwt_handler.remove_dollar();
+
+            primary = bwt_handler.primary;
+
+            // sample the SA
+            for (uint32 i = 0; i < ssa_len; ++i)
+                h_ssa[i] = h_sa[ i * sa_intv ];
+
+            timer.stop();
+            log_info(stderr, "building forward BWT... done: %um:%us\n", uint32(timer.seconds()/60), uint32(timer.seconds())%60);
+
+            // compute the LCP and stream it to disk
+            timer.start();
+            save_lcp( seq_length, lcp_handler, lcp_name );
+        }
+        else
         {
             StringBWTSSAHandler<const_stream_type,stream_type,uint32*> output(
                 seq_length,                         // string length
@@ -493,7 +606,7 @@ int build(
             primary = output.primary();
         }
         timer.stop();
-        log_info(stderr, "building forward BWT... done: %um:%us\n", uint32(timer.seconds()/60), uint32(timer.seconds())%60);
+        log_info(stderr, "building %s... done: %um:%us\n", lcp_name ? "forward LCP" : "forward BWT", uint32(timer.seconds()/60), uint32(timer.seconds())%60);
         log_info(stderr, "  primary: %u\n", primary);
 
         // save everything to disk
@@ -635,6 +748,7 @@ int main(int argc, char* argv[])
         log_info(stderr, "    -w | --word-packing   output word packed .wpac\n");
         log_info(stderr, "    -c | --crc            compute crcs\n");
         log_info(stderr, "    -d | --device         cuda device\n");
+        log_info(stderr, "    -l | --lcp            output the LCP array of the forward string (.lcp)\n");
         exit(0);
     }
 
@@ -642,6 +756,7 @@ int main(int argc, char* argv[])
     uint64  max_length  = uint64(-1);
     PacType pac_type    = BPAC;
     bool    crc         = false;
+    bool    lcp         = false;
     int     cuda_device = -1;
 
     uint32 n_files = 0;
@@ -680,6 +795,11 @@ int main(int argc, char* argv[])
         {
             cuda_device = atoi( argv[++i] );
         }
+        else if ((strcmp( arg, "-l" )               == 0) ||
+                 (strcmp( arg, "--lcp" )            == 0))
+        {
+            lcp = true;
+        }
         else
             file_names[ n_files++ ] = argv[i];
     }
@@ -698,6 +818,8 @@ int main(int argc, char* argv[])
     const char* sa_name     = sa_string.c_str();
     std::string rsa_string  = std::string( output_name ) + ".rsa";
     const char* rsa_name    = rsa_string.c_str();
+    std::string lcp_string  = std::string( output_name ) + ".lcp";
+    const char* lcp_name    = lcp ? lcp_string.c_str() : NULL;
 
     log_info(stderr, "max length : %lld\n", max_length);
     log_info(stderr, "input      : \"%s\"\n", input_name);
@@ -754,7 +876,7 @@ int main(int argc, char* argv[])
 
         cuda::check_error("cuda-memory-check");
 
-        return build( input_name, output_name, pac_name, rpac_name, bwt_name, rbwt_name, sa_name, rsa_name, max_length, pac_type, crc );
+        return build( input_name, output_name, pac_name, rpac_name, bwt_name, rbwt_name, sa_name, rsa_name, lcp_name, max_length, pac_type, crc );
     }
     catch (nvbio::cuda_error &e)
     {
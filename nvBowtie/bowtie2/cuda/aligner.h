@@ -57,6 +57,7 @@
 #include <nvbio/fmindex/ssa.h>
 #include <nvbio/fmindex/fmindex.h>
 #include <nvbio/fmindex/fmindex_device.h>
+#include <nvbio/fmindex/seed_cache.h>
 #include <thrust/host_vector.h>
 #include <thrust/device_vector.h>
 #include <thrust/scan.h>
@@ -102,6 +103,7 @@ struct Aligner
     SeedHitDequeArray                   hit_deques;
 
     nvbio::cuda::PingPongQueues<uint32> seed_queues;
+    SeedIntervalCache<device_tag>       seed_cache;     // memoized SA ranges of repetitive seeds, persistent across batches
     ScoringQueues                       scoring_queues;
 
     thrust::device_vector<uint32>       idx_queue_dvec;
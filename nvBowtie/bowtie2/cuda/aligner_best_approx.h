@@ -231,7 +231,8 @@ void Aligner::best_approx(
                 hits,
                 params,
                 params.fw,
-                params.rc );
+                params.rc,
+                plain_view( seed_cache ) );
 
             optional_device_synchronize();
             nvbio::cuda::check_error("mapping kernel");
@@ -514,7 +515,9 @@ void Aligner::best_approx(
             const io::BestAlignments best( h_best_data[i], h_best_data[i + BATCH_SIZE] );
             const uint8 mapq = h_mapq[i];
 
-            stats.track_alignment_statistics( &stats.mate1, best, mapq );
+            // account for all the collapsed duplicates of this read
+            for (uint32 d = 0; d < cpu_batch.multiplicity(i); ++d)
+                stats.track_alignment_statistics( &stats.mate1, best, mapq );
         }
     }
 }
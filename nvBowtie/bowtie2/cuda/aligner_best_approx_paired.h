@@ -207,7 +207,8 @@ void Aligner::best_approx(
                     hits,
                     params,
                     fw,
-                    rc );
+                    rc,
+                    plain_view( seed_cache ) );
 
                 optional_device_synchronize();
                 nvbio::cuda::check_error("mapping kernel");
@@ -807,7 +808,9 @@ void Aligner::best_approx(
             const io::BestAlignments best_o( h_best_data_o[i], h_best_data_o[i + BATCH_SIZE] );
             const uint8 mapq = h_mapq[i];
 
-            stats.track_alignment_statistics( best, best_o, mapq );
+            // account for all the collapsed duplicates of this pair
+            for (uint32 d = 0; d < cpu_batch.multiplicity(i); ++d)
+                stats.track_alignment_statistics( best, best_o, mapq );
         }
     }
 
@@ -83,6 +83,18 @@ bool Aligner::init_alloc(const uint32 BATCH_SIZE, const Params& params, const En
 
     // alloc the hit deques
     d_allocated_bytes += hit_deques.resize( BATCH_SIZE, params.max_hits, do_alloc );
+
+    // alloc the seed interval cache, shared by all batches
+    if (params.seed_cache && params.mode != AllMapping)
+    {
+        const uint64 slot_bytes = sizeof(uint64) + 4u*sizeof(uint32);
+        const uint32 n_slots    = uint32( (uint64(params.seed_cache)*1024u*1024u) / slot_bytes );
+
+        if (do_alloc)
+            seed_cache.resize( n_slots, params.seed_cache_min_occ, params.seed_cache_stats );
+
+        d_allocated_bytes += do_alloc ? seed_cache.allocated_bytes() : n_slots * slot_bytes;
+    }
     if (params.randomized)
         rseeds_dptr = resize( do_alloc, rseeds_dvec, BATCH_SIZE, d_allocated_bytes );
 
@@ -43,6 +43,7 @@
 #include <nvBowtie/bowtie2/cuda/aligner.h>
 #include <nvBowtie/bowtie2/cuda/aligner_inst.h>
 #include <nvBowtie/bowtie2/cuda/input_thread.h>
+#include <nvbio/io/sequence/sequence_dedup.h>
 #include <nvbio/basic/cuda/arch.h>
 #include <nvbio/basic/timer.h>
 #include <nvbio/basic/console.h>
@@ -185,7 +186,10 @@ void ComputeThreadSE::do_run()
 
     const uint32 BATCH_SIZE = input_thread->batch_size();
 
-    log_stats(stderr, "[%u]   processing reads in batches of %uK\n", thread_id, BATCH_SIZE/1024);
+    if (input_thread->controller().min_batch_size() < BATCH_SIZE)
+        log_stats(stderr, "[%u]   processing reads in adaptive batches of up to %uK\n", thread_id, BATCH_SIZE/1024);
+    else
+        log_stats(stderr, "[%u]   processing reads in batches of %uK\n", thread_id, BATCH_SIZE/1024);
 
     // setup the output file
     aligner->output_file = output_file;
@@ -207,6 +211,7 @@ void ComputeThreadSE::do_run()
     uint32 n_reads = 0;
 
     io::SequenceDataHost   local_read_data_host;
+    io::SequenceDataHost   local_unique_data_host;
     io::HostOutputBatchSE  local_output_batch_host;
 
     // loop through the batches of reads
@@ -228,6 +233,9 @@ void ComputeThreadSE::do_run()
             break;
         }
 
+        // let the input thread know how long we starved
+        input_thread->controller().record_wait( io_timer.seconds() );
+
         if (read_data_host->max_sequence_len() > Aligner::MAX_READ_LEN)
         {
             log_error(stderr, "[%u] unsupported read length %u (maximum is %u)\n", thread_id,
@@ -242,19 +250,49 @@ void ComputeThreadSE::do_run()
         // mark this set as ready to be reused
         input_thread->release( read_data_host );
 
+        // time the whole batch, to feed back the input thread's batch size controller
+        Timer batch_timer;
+        batch_timer.start();
+
         Timer timer;
         timer.start();
 
         //aligner.output_file->start_batch( &local_read_data_host );
         local_output_batch_host.read_data = &local_read_data_host;
+        local_output_batch_host.dup_map.resize( 0 );
+        local_output_batch_host.dup_count.resize( 0 );
 
-        io::SequenceDataDevice read_data( local_read_data_host );
+        // optionally collapse exact duplicates, aligning a single representative per group:
+        // the output batch will fan the results back out to all reads
+        const io::SequenceDataHost* align_data_host = &local_read_data_host;
+
+        if (params.collapse_dups && params.mode != AllMapping)
+        {
+            const uint32 n_unique = io::collapse_duplicates(
+                local_read_data_host,
+                &local_unique_data_host,
+                local_output_batch_host.dup_map,
+                local_output_batch_host.dup_count );
+
+            if (n_unique < local_read_data_host.size())
+            {
+                log_verbose(stderr, "[%u]   collapsed %u duplicate reads\n", thread_id, local_read_data_host.size() - n_unique);
+                align_data_host = &local_unique_data_host;
+            }
+            else
+            {
+                local_output_batch_host.dup_map.resize( 0 );
+                local_output_batch_host.dup_count.resize( 0 );
+            }
+        }
+
+        io::SequenceDataDevice read_data( *align_data_host );
         cudaThreadSynchronize();
 
         timer.stop();
         stats.read_HtoD.add( read_data.size(), timer.seconds() );
 
-        const uint32 count = read_data.size();
+        const uint32 count = local_read_data_host.size();
         log_info(stderr, "[%u] aligning reads [%u, %u]\n", thread_id, read_begin, read_begin + count - 1u);
         log_verbose(stderr, "[%u]   %u reads\n", thread_id, count);
         log_verbose(stderr, "[%u]   %.3f M bps (%.1f MB)\n", thread_id, float(read_data.bps())/1.0e6f, float(read_data.words()*sizeof(uint32)+read_data.bps()*sizeof(char))/float(1024*1024));
@@ -323,6 +361,9 @@ void ComputeThreadSE::do_run()
             }
         }
 
+        batch_timer.stop();
+        input_thread->controller().record( BatchSizeController::CONSUMER, count, batch_timer.seconds() );
+
         global_timer.stop();
         stats.global_time += global_timer.seconds();
         global_timer.start();
@@ -356,6 +397,8 @@ void ComputeThreadSE::do_run()
     log_stats(stderr, "[%u]   results I/O  : %.2f sec (avg: %.3fM reads/s, max: %.3fM reads/s).\n", thread_id, stats.io.time, 1.0e-6f * stats.io.avg_speed(), 1.0e-6f * stats.io.max_speed);
     log_stats(stderr, "[%u]   reads HtoD   : %.2f sec (avg: %.3fM reads/s, max: %.3fM reads/s).\n", thread_id, stats.read_HtoD.time, 1.0e-6f * stats.read_HtoD.avg_speed(), 1.0e-6f * stats.read_HtoD.max_speed);
     log_stats(stderr, "[%u]   reads I/O    : %.2f sec (avg: %.3fM reads/s, max: %.3fM reads/s).\n", thread_id, stats.read_io.time, 1.0e-6f * stats.read_io.avg_speed(), 1.0e-6f * stats.read_io.max_speed);
+    if (aligner->seed_cache.has_stats())
+        log_stats(stderr, "[%u]   seed cache   : %.1f%% hit rate (%.2fM lookups, %.1f MB).\n", thread_id, 100.0f * aligner->seed_cache.hit_rate(), 1.0e-6f * float(aligner->seed_cache.lookups()), float(aligner->seed_cache.allocated_bytes()) / float(1024*1024));
 }
 
 
@@ -517,7 +560,10 @@ void ComputeThreadPE::do_run()
 
     const uint32 BATCH_SIZE = input_thread->batch_size();
 
-    log_stats(stderr, "[%u]   processing reads in batches of %uK\n", thread_id, BATCH_SIZE/1024);
+    if (input_thread->controller().min_batch_size() < BATCH_SIZE)
+        log_stats(stderr, "[%u]   processing reads in adaptive batches of up to %uK\n", thread_id, BATCH_SIZE/1024);
+    else
+        log_stats(stderr, "[%u]   processing reads in batches of %uK\n", thread_id, BATCH_SIZE/1024);
 
     // setup the output file
     aligner->output_file = output_file;
@@ -544,6 +590,8 @@ void ComputeThreadPE::do_run()
 
     io::SequenceDataHost    local_read_data_host1;
     io::SequenceDataHost    local_read_data_host2;
+    io::SequenceDataHost    local_unique_data_host1;
+    io::SequenceDataHost    local_unique_data_host2;
     io::HostOutputBatchPE   local_output_batch_host;
 
     // loop through the batches of reads
@@ -569,6 +617,9 @@ void ComputeThreadPE::do_run()
             break;
         }
 
+        // let the input thread know how long we starved
+        input_thread->controller().record_wait( io_timer.seconds() );
+
         if ((read_data_host1->max_sequence_len() > Aligner::MAX_READ_LEN) ||
             (read_data_host2->max_sequence_len() > Aligner::MAX_READ_LEN))
         {
@@ -586,20 +637,54 @@ void ComputeThreadPE::do_run()
         // mark this set as ready to be reused
         input_thread->release( read_data_host_pair );
 
+        // time the whole batch, to feed back the input thread's batch size controller
+        Timer batch_timer;
+        batch_timer.start();
+
         Timer timer;
         timer.start();
 
         //aligner.output_file->start_batch( &local_read_data_host1, &local_read_data_host2 );
         local_output_batch_host.read_data[0] = &local_read_data_host1;
         local_output_batch_host.read_data[1] = &local_read_data_host2;
+        local_output_batch_host.dup_map.resize( 0 );
+        local_output_batch_host.dup_count.resize( 0 );
+
+        // optionally collapse exact duplicate pairs, aligning a single representative per group:
+        // the output batch will fan the results back out to all pairs
+        const io::SequenceDataHost* align_data_host1 = &local_read_data_host1;
+        const io::SequenceDataHost* align_data_host2 = &local_read_data_host2;
+
+        if (params.collapse_dups)
+        {
+            const uint32 n_unique = io::collapse_duplicates(
+                local_read_data_host1,
+                local_read_data_host2,
+                &local_unique_data_host1,
+                &local_unique_data_host2,
+                local_output_batch_host.dup_map,
+                local_output_batch_host.dup_count );
+
+            if (n_unique < local_read_data_host1.size())
+            {
+                log_verbose(stderr, "[%u]   collapsed %u duplicate pairs\n", thread_id, local_read_data_host1.size() - n_unique);
+                align_data_host1 = &local_unique_data_host1;
+                align_data_host2 = &local_unique_data_host2;
+            }
+            else
+            {
+                local_output_batch_host.dup_map.resize( 0 );
+                local_output_batch_host.dup_count.resize( 0 );
+            }
+        }
 
-        io::SequenceDataDevice read_data1( local_read_data_host1/*, io::ReadDataDevice::READS | io::ReadDataDevice::QUALS*/ );
-        io::SequenceDataDevice read_data2( local_read_data_host2/*, io::ReadDataDevice::READS | io::ReadDataDevice::QUALS*/ );
+        io::SequenceDataDevice read_data1( *align_data_host1/*, io::ReadDataDevice::READS | io::ReadDataDevice::QUALS*/ );
+        io::SequenceDataDevice read_data2( *align_data_host2/*, io::ReadDataDevice::READS | io::ReadDataDevice::QUALS*/ );
 
         timer.stop();
         stats.read_HtoD.add( read_data1.size(), timer.seconds() );
 
-        const uint32 count = read_data1.size();
+        const uint32 count = local_read_data_host1.size();
         log_info(stderr, "[%u] aligning reads [%u, %u]\n", thread_id, read_begin, read_begin + count - 1u);
         log_verbose(stderr, "[%u]   %u reads\n", thread_id, count);
         log_verbose(stderr, "[%u]   %.3f M bps (%.1f MB)\n", thread_id,
@@ -650,6 +735,9 @@ void ComputeThreadPE::do_run()
             }
         }
 
+        batch_timer.stop();
+        input_thread->controller().record( BatchSizeController::CONSUMER, count, batch_timer.seconds() );
+
         global_timer.stop();
         stats.global_time += global_timer.seconds();
         global_timer.start();
@@ -685,6 +773,8 @@ void ComputeThreadPE::do_run()
     log_stats(stderr, "[%u]   results I/O    : %.2f sec (avg: %.3fM reads/s, max: %.3fM reads/s).\n", thread_id, stats.io.time, 1.0e-6f * stats.io.avg_speed(), 1.0e-6f * stats.io.max_speed);
     log_stats(stderr, "[%u]   reads HtoD     : %.2f sec (avg: %.3fM reads/s, max: %.3fM reads/s).\n", thread_id, stats.read_HtoD.time, 1.0e-6f * stats.read_HtoD.avg_speed(), 1.0e-6f * stats.read_HtoD.max_speed);
     log_stats(stderr, "[%u]   reads I/O      : %.2f sec (avg: %.3fM reads/s, max: %.3fM reads/s).\n", thread_id, stats.read_io.time, 1.0e-6f * stats.read_io.avg_speed(), 1.0e-6f * stats.read_io.max_speed);
+    if (aligner->seed_cache.has_stats())
+        log_stats(stderr, "[%u]   seed cache     : %.1f%% hit rate (%.2fM lookups, %.1f MB).\n", thread_id, 100.0f * aligner->seed_cache.hit_rate(), 1.0e-6f * float(aligner->seed_cache.lookups()), float(aligner->seed_cache.allocated_bytes()) / float(1024*1024));
 }
 
 void ComputeThreadPE::run()
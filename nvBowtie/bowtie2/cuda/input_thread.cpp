@@ -34,6 +34,7 @@
 #include <nvbio/basic/atomics.h>
 #include <nvbio/basic/timer.h>
 #include <nvbio/basic/exceptions.h>
+#include <string.h>
 
 namespace nvbio {
 namespace bowtie2 {
@@ -56,12 +57,13 @@ void InputThreadSE::run()
         {
             io::SequenceDataHost* read_data = NULL;
 
-            // loop until the free pool gets filled
+            // loop until the free pool gets filled and the controller allows one more batch in flight
             while (read_data == NULL)
             {
                 ScopedLock lock( &m_free_pool_lock );
 
-                if (m_free_pool.empty() == false)
+                if (m_free_pool.empty() == false &&
+                    BUFFERS - uint32( m_free_pool.size() ) < m_controller.in_flight())
                 {
                     read_data = m_free_pool.top();
                     m_free_pool.pop();
@@ -70,12 +72,14 @@ void InputThreadSE::run()
                 yield();
             }
 
-            log_debug( stderr, "  reading input batch %u\n", m_set );
+            const uint32 batch_size = m_controller.batch_size();
+
+            log_debug( stderr, "  reading input batch %u (%u reads)\n", m_set, batch_size );
 
             Timer timer;
             timer.start();
 
-            const int ret = io::next( DNA_N, read_data, m_read_data_stream, m_batch_size, m_batch_size*m_read_length );
+            const int ret = io::next( DNA_N, read_data, m_read_data_stream, batch_size, batch_size*m_read_length );
 
             timer.stop();
 
@@ -88,6 +92,8 @@ void InputThreadSE::run()
                 m_reads += read_data->size();
 
                 m_stats.read_io.add( read_data->size(), timer.seconds() );
+
+                m_controller.record( BatchSizeController::PRODUCER, read_data->size(), timer.seconds() );
             }
             else
             {
@@ -181,6 +187,120 @@ void InputThreadSE::release(io::SequenceDataHost* read_data)
     m_free_pool.push( read_data );
 }
 
+namespace {
+
+// return the length of a mate name, excluding any comment and the trailing /1 or /2 mate suffix
+//
+uint32 mate_name_length(const char* name)
+{
+    uint32 len = 0;
+    while (name[len] != '\0' && name[len] != ' ' && name[len] != '\t')
+        ++len;
+
+    if (len >= 2 && name[len-2] == '/' && (name[len-1] == '1' || name[len-1] == '2'))
+        len -= 2;
+
+    return len;
+}
+
+} // anonymous namespace
+
+// check whether two mates carry the same name
+//
+bool same_mate_names(const char* name1, const char* name2)
+{
+    const uint32 len1 = mate_name_length( name1 );
+    const uint32 len2 = mate_name_length( name2 );
+    return len1 == len2 && strncmp( name1, name2, len1 ) == 0;
+}
+
+// top up the shorter of two mate batches from its own stream, so that both
+// contain the same number of reads
+//
+void balance_mate_batches(
+    io::SequenceDataHost*   read_data1,
+    io::SequenceDataStream* read_data_stream1,
+    io::SequenceDataHost*   read_data2,
+    io::SequenceDataStream* read_data_stream2)
+{
+    if (read_data1->size() < read_data2->size())
+        io::append( DNA_N, read_data1, read_data_stream1, read_data2->size() - read_data1->size() );
+    else if (read_data2->size() < read_data1->size())
+        io::append( DNA_N, read_data2, read_data_stream2, read_data1->size() - read_data2->size() );
+}
+
+void InputMateThread::run()
+{
+    try
+    {
+        while (1u)
+        {
+            // wait for a new request
+            while (m_completed == m_requested && m_quit == false)
+                yield();
+
+            if (m_completed == m_requested)
+                break;
+
+            host_acquire_fence();
+
+            m_ret = io::next( DNA_N, m_read_data, m_read_data_stream, m_batch_size, m_batch_bps );
+
+            // publish the batch
+            host_release_fence();
+            m_completed = m_requested;
+        }
+    }
+    catch (nvbio::bad_alloc &e)
+    {
+        log_error(stderr, "caught a nvbio::bad_alloc exception reading the second mate file:\n");
+        log_error(stderr, "  %s\n", e.what());
+        exit(1);
+    }
+    catch (std::bad_alloc &e)
+    {
+        log_error(stderr, "caught a std::bad_alloc exception reading the second mate file:\n");
+        log_error(stderr, "  %s\n", e.what());
+        exit(1);
+    }
+    catch (...)
+    {
+        log_error(stderr, "caught an unknown exception reading the second mate file!\n");
+        exit(1);
+    }
+}
+
+// request the asynchronous decoding of a batch of a given size
+//
+void InputMateThread::request(io::SequenceDataHost* read_data, const uint32 batch_size, const uint32 batch_bps)
+{
+    m_read_data  = read_data;
+    m_batch_size = batch_size;
+    m_batch_bps  = batch_bps;
+
+    host_release_fence();
+    m_requested = m_requested + 1u;
+}
+
+// wait for the last requested batch, returning the result of io::next()
+//
+int InputMateThread::wait()
+{
+    while (m_completed != m_requested)
+        yield();
+
+    host_acquire_fence();
+    return m_ret;
+}
+
+// stop the thread
+//
+void InputMateThread::stop()
+{
+    m_quit = true;
+    host_release_fence();
+}
+
 void InputThreadPE::run()
 {
     log_verbose( stderr, "starting background paired-end input thread\n" );
@@ -197,18 +317,22 @@ void InputThreadPE::run()
             }
         }
 
+        // start decoding the second mate stream in the background
+        m_mate_thread.create();
+
         while (1u)
         {
             io::SequenceDataHost* read_data1 = NULL;
             io::SequenceDataHost* read_data2 = NULL;
 
-            // loop until the free pool gets filled
+            // loop until the free pool gets filled and the controller allows one more batch in flight
             while (read_data1 == NULL || read_data2 == NULL)
             {
                 ScopedLock lock( &m_free_pool_lock );
 
                 if (m_free_pool1.empty() == false &&
-                    m_free_pool2.empty() == false)
+                    m_free_pool2.empty() == false &&
+                    BUFFERS - uint32( m_free_pool1.size() ) < m_controller.in_flight())
                 {
                     read_data1 = m_free_pool1.top(); m_free_pool1.pop();
                     read_data2 = m_free_pool2.top(); m_free_pool2.pop();
@@ -217,16 +341,65 @@ void InputThreadPE::run()
                 yield();
             }
 
-            log_debug( stderr, "  reading input batch %u\n", m_set );
+            const uint32 batch_size = m_controller.batch_size();
+
+            log_debug( stderr, "  reading input batch %u (%u reads)\n", m_set, batch_size );
 
             Timer timer;
             timer.start();
 
-            const int ret1 = io::next( DNA_N, read_data1, m_read_data_stream1, m_batch_size, m_batch_size*m_read_length );
-            const int ret2 = io::next( DNA_N, read_data2, m_read_data_stream2, read_data1->size() );
+            // decode the two mates concurrently, capping both by the same number of bps
+            m_mate_thread.request( read_data2, batch_size, batch_size*m_read_length );
+
+            const int ret1 = io::next( DNA_N, read_data1, m_read_data_stream1, batch_size, batch_size*m_read_length );
+            const int ret2 = m_mate_thread.wait();
+
+            if (ret1 < 0 || ret2 < 0)
+            {
+                log_error(stderr, "failed reading input batch %u\n", m_set);
+                exit(1);
+            }
+
+            // the bp cap may cut the two streams at different reads: as the mate batches
+            // are joined by index, top up the shorter one so that the pairs are preserved
+            if (ret1 && ret2)
+                balance_mate_batches( read_data1, m_read_data_stream1, read_data2, m_read_data_stream2 );
 
             timer.stop();
 
+            const uint32 n_reads1 = ret1 ? read_data1->size() : 0u;
+            const uint32 n_reads2 = ret2 ? read_data2->size() : 0u;
+
+            if (n_reads1 != n_reads2)
+            {
+                log_error(stderr, "the mate files contain a different number of reads (%u vs %u after read %u)\n",
+                    m_reads + n_reads1,
+                    m_reads + n_reads2,
+                    m_reads);
+                exit(1);
+            }
+
+            // check that the mates carry the same names
+            if (ret1)
+            {
+                const io::SequenceDataHost::const_plain_view_type view1( *read_data1 );
+                const io::SequenceDataHost::const_plain_view_type view2( *read_data2 );
+
+                for (uint32 i = 0; i < read_data1->size(); ++i)
+                {
+                    const char* name1 = view1.name_stream() + view1.name_index()[i];
+                    const char* name2 = view2.name_stream() + view2.name_index()[i];
+
+                    if (same_mate_names( name1, name2 ) == false)
+                    {
+                        if (m_name_mismatches == 0)
+                            log_warning(stderr, "mate names differ at read %u: \"%s\" vs \"%s\"\n", m_reads + i, name1, name2);
+
+                        ++m_name_mismatches;
+                    }
+                }
+            }
+
             if (ret1 && ret2)
             {
                 ScopedLock lock( &m_ready_pool_lock );
@@ -237,10 +410,18 @@ void InputThreadPE::run()
                 m_reads += read_data1->size();
 
                 m_stats.read_io.add( read_data1->size(), timer.seconds() );
+
+                m_controller.record( BatchSizeController::PRODUCER, read_data1->size(), timer.seconds() );
             }
             else
             {
-                // stop the thread
+                if (m_name_mismatches)
+                    log_warning(stderr, "%u mate pairs with inconsistent names\n", m_name_mismatches);
+
+                // stop the threads
+                m_mate_thread.stop();
+                m_mate_thread.join();
+
                 m_done = true;
                 host_release_fence();
                 break;
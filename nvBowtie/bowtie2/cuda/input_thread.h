@@ -43,14 +43,27 @@ namespace cuda {
 // A class implementing a background input thread, providing
 // a set of input read-streams which are read in parallel to the
 // operations performed by the main thread.
+// Unless adaptive batching is disabled, the size of the batches and
+// the number of batches read ahead are adjusted at run-time, based on
+// the throughput of the input and compute stages.
 //
 
 struct InputThreadSE : public Thread<InputThreadSE>
 {
-    static const uint32 BUFFERS = 4;
-
-    InputThreadSE(io::SequenceDataStream* read_data_stream, Stats& _stats, const uint32 batch_size, const uint32 read_length) :
-        m_read_data_stream( read_data_stream ), m_stats( _stats ), m_batch_size( batch_size ), m_read_length( read_length ), m_set(0), m_reads(0), m_done(false)
+    static const uint32 BUFFERS         = 8;    // maximum number of batches in flight
+    static const uint32 FIXED_BUFFERS   = 4;    // number of batches in flight with adaptive batching disabled
+    static const uint32 MIN_BATCH_SIZE  = 16*1024;
+
+    InputThreadSE(io::SequenceDataStream* read_data_stream, Stats& _stats, const uint32 batch_size, const uint32 read_length, const uint32 consumers = 1u, const bool adaptive = false, const uint64 memory_cap = uint64(-1)) :
+        m_read_data_stream( read_data_stream ), m_stats( _stats ), m_batch_size( batch_size ), m_read_length( read_length ), m_set(0), m_reads(0), m_done(false),
+        m_controller(
+            adaptive ? MIN_BATCH_SIZE : batch_size,
+            batch_size,
+            adaptive ? 2u : FIXED_BUFFERS,
+            adaptive ? BUFFERS : FIXED_BUFFERS,
+            consumers,
+            memory_cap,
+            read_bytes( read_length ) )
     {}
 
     void run();
@@ -63,10 +76,18 @@ struct InputThreadSE : public Thread<InputThreadSE>
     //
     void release(io::SequenceDataHost* read_data);
 
-    // return the batch size
+    // return the maximum batch size
     //
     uint32 batch_size() const { return m_batch_size; }
 
+    // return the batch size controller, to which consumers report their timings
+    //
+    BatchSizeController& controller() { return m_controller; }
+
+    // estimate the host memory taken by a read of a given length
+    //
+    static uint32 read_bytes(const uint32 read_length) { return uint32( float( read_length ) * 1.5f ) + 32u; }
+
 private:
     io::SequenceDataStream* m_read_data_stream;
     Stats&                  m_stats;
@@ -85,20 +106,86 @@ private:
     std::deque<uint32>                   m_ready_poolN;
 
     volatile bool m_done;
+
+    BatchSizeController                  m_controller;
+};
+
+// check whether two mates carry the same name, ignoring any comment and the trailing /1 or /2 suffix
+//
+bool same_mate_names(const char* name1, const char* name2);
+
+// top up the shorter of two mate batches from its own stream, so that both
+// contain the same number of reads
+//
+void balance_mate_batches(
+    io::SequenceDataHost*   read_data1,
+    io::SequenceDataStream* read_data_stream1,
+    io::SequenceDataHost*   read_data2,
+    io::SequenceDataStream* read_data_stream2);
+
+//
+// A helper thread decoding batches of a single mate stream on behalf of
+// InputThreadPE, so that the two mate files are parsed (and inflated)
+// concurrently.
+//
+
+struct InputMateThread : public Thread<InputMateThread>
+{
+    InputMateThread(io::SequenceDataStream* read_data_stream) :
+        m_read_data_stream( read_data_stream ), m_read_data( NULL ), m_batch_size( 0 ), m_batch_bps( uint32(-1) ), m_ret( 0 ), m_requested( 0 ), m_completed( 0 ), m_quit( false ) {}
+
+    void run();
+
+    // request the asynchronous decoding of a batch of a given size
+    //
+    void request(io::SequenceDataHost* read_data, const uint32 batch_size, const uint32 batch_bps = uint32(-1));
+
+    // wait for the last requested batch, returning the result of io::next()
+    //
+    int wait();
+
+    // stop the thread
+    //
+    void stop();
+
+private:
+    io::SequenceDataStream* m_read_data_stream;
+    io::SequenceDataHost*   m_read_data;
+    uint32                  m_batch_size;
+    uint32                  m_batch_bps;
+    int                     m_ret;
+
+    volatile uint32         m_requested;
+    volatile uint32         m_completed;
+    volatile bool           m_quit;
 };
 
 //
 // A class implementing a background input thread, providing
 // a set of input read-streams which are read in parallel to the
 // operations performed by the main thread.
+// The two mate streams are decoded concurrently, the second one by
+// an InputMateThread, and the resulting batches are joined by index
+// and checked for consistency.
 //
 
 struct InputThreadPE : public Thread<InputThreadPE>
 {
-    static const uint32 BUFFERS = 4;
-
-    InputThreadPE(io::SequenceDataStream* read_data_stream1, io::SequenceDataStream* read_data_stream2, Stats& _stats, const uint32 batch_size, const uint32 read_length) :
-        m_read_data_stream1( read_data_stream1 ), m_read_data_stream2( read_data_stream2 ), m_stats( _stats ), m_batch_size( batch_size ), m_read_length( read_length ), m_set(0), m_reads(0), m_done(false)
+    static const uint32 BUFFERS         = 8;    // maximum number of batches in flight
+    static const uint32 FIXED_BUFFERS   = 4;    // number of batches in flight with adaptive batching disabled
+    static const uint32 MIN_BATCH_SIZE  = 16*1024;
+
+    InputThreadPE(io::SequenceDataStream* read_data_stream1, io::SequenceDataStream* read_data_stream2, Stats& _stats, const uint32 batch_size, const uint32 read_length, const uint32 consumers = 1u, const bool adaptive = false, const uint64 memory_cap = uint64(-1)) :
+        m_read_data_stream1( read_data_stream1 ), m_read_data_stream2( read_data_stream2 ), m_stats( _stats ), m_batch_size( batch_size ), m_read_length( read_length ), m_set(0), m_reads(0), m_name_mismatches(0), m_done(false),
+        m_mate_thread( read_data_stream2 ),
+        m_controller(
+            adaptive ? MIN_BATCH_SIZE : batch_size,
+            batch_size,
+            adaptive ? 2u : FIXED_BUFFERS,
+            adaptive ? BUFFERS : FIXED_BUFFERS,
+            consumers,
+            memory_cap,
+            2u * InputThreadSE::read_bytes( read_length ) )
     {}
 
     void run();
@@ -111,10 +198,14 @@ struct InputThreadPE : public Thread<InputThreadPE>
     //
     void release(std::pair<io::SequenceDataHost*,io::SequenceDataHost*> read_data);
 
-    // return the batch size
+    // return the maximum batch size
     //
     uint32 batch_size() const { return m_batch_size; }
 
+    // return the batch size controller, to which consumers report their timings
+    //
+    BatchSizeController& controller() { return m_controller; }
+
 private:
     io::SequenceDataStream* m_read_data_stream1;
     io::SequenceDataStream* m_read_data_stream2;
@@ -123,6 +214,7 @@ private:
     uint32                  m_read_length;
     uint32                  m_set;
     uint32                  m_reads;
+    uint32                  m_name_mismatches;
 
     io::SequenceDataHost    m_read_data_storage1[BUFFERS];
     io::SequenceDataHost    m_read_data_storage2[BUFFERS];
@@ -137,6 +229,9 @@ private:
     std::deque<uint32>                   m_ready_poolN;
 
     volatile bool m_done;
+
+    InputMateThread                      m_mate_thread;
+    BatchSizeController                  m_controller;
 };
 
 } // namespace cuda
@@ -0,0 +1,237 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// input_thread_test.cpp
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <nvbio/basic/console.h>
+#include <nvbio/basic/shared_pointer.h>
+#include <nvbio/io/sequence/sequence.h>
+#include <nvBowtie/bowtie2/cuda/input_thread.h>
+#include <nvBowtie/bowtie2/cuda/stats.h>
+
+namespace nvbio {
+namespace bowtie2 {
+namespace cuda {
+
+namespace { // anonymous namespace
+
+// write a FASTQ file of n_reads mates of a given length, named "pair<i>/<mate>"
+//
+void write_mates(const char* file_name, const uint32 n_reads, const uint32 read_len, const uint32 mate)
+{
+    FILE* file = fopen( file_name, "w" );
+    if (file == NULL)
+    {
+        log_error( stderr, "test InputThreadPE... failed! (unable to create \"%s\")\n", file_name );
+        exit(1);
+    }
+
+    for (uint32 i = 0; i < n_reads; ++i)
+    {
+        fprintf( file, "@pair%u/%u\n", i, mate );
+        for (uint32 j = 0; j < read_len; ++j)
+            fputc( "ACGT"[ rand() % 4 ], file );
+        fprintf( file, "\n+\n" );
+        for (uint32 j = 0; j < read_len; ++j)
+            fputc( 'I', file );
+        fprintf( file, "\n" );
+    }
+    fclose( file );
+}
+
+// check that the i-th mates of two batches carry the same name
+//
+void check_mate_names(const io::SequenceDataHost& read_data1, const io::SequenceDataHost& read_data2, const uint32 offset)
+{
+    const io::SequenceDataHost::const_plain_view_type view1( read_data1 );
+    const io::SequenceDataHost::const_plain_view_type view2( read_data2 );
+
+    for (uint32 i = 0; i < read_data1.size(); ++i)
+    {
+        const char* name1 = view1.name_stream() + view1.name_index()[i];
+        const char* name2 = view2.name_stream() + view2.name_index()[i];
+
+        if (same_mate_names( name1, name2 ) == false)
+        {
+            log_error( stderr, "test InputThreadPE... failed! (read %u paired \"%s\" with \"%s\")\n", offset + i, name1, name2 );
+            exit(1);
+        }
+    }
+}
+
+} // anonymous namespace
+
+void test_input_thread()
+{
+    log_info( stderr, "test InputThreadPE... started\n" );
+
+    // test the mate name comparisons
+    {
+        const char* same[][2] = {
+            { "pair0/1",         "pair0/2" },
+            { "pair0",           "pair0" },
+            { "pair0/1 comment", "pair0/2\tcomment" },
+            { "pair0 1:N:0",     "pair0 2:N:0" } };
+
+        const char* different[][2] = {
+            { "pair0/1",         "pair1/2" },
+            { "pair0/1",         "pair01/2" },
+            { "pair0/3",         "pair0/4" } };
+
+        for (uint32 i = 0; i < sizeof(same)/sizeof(same[0]); ++i)
+        {
+            if (same_mate_names( same[i][0], same[i][1] ) == false)
+            {
+                log_error( stderr, "test InputThreadPE... failed! (\"%s\" and \"%s\" should match)\n", same[i][0], same[i][1] );
+                exit(1);
+            }
+        }
+        for (uint32 i = 0; i < sizeof(different)/sizeof(different[0]); ++i)
+        {
+            if (same_mate_names( different[i][0], different[i][1] ) == true)
+            {
+                log_error( stderr, "test InputThreadPE... failed! (\"%s\" and \"%s\" should not match)\n", different[i][0], different[i][1] );
+                exit(1);
+            }
+        }
+    }
+
+    // write two mate files with reads of very different lengths, so that the same bp cap
+    // cuts the two streams at different reads
+    const uint32 N_PAIRS     = 5000;
+    const uint32 MATE1_LEN   = 40;
+    const uint32 MATE2_LEN   = 150;
+    const uint32 BATCH_SIZE  = 512;
+    const uint32 READ_LENGTH = 100;
+
+    srand(0);
+    write_mates( "./input_thread_test_1.fastq", N_PAIRS, MATE1_LEN, 1u );
+    write_mates( "./input_thread_test_2.fastq", N_PAIRS, MATE2_LEN, 2u );
+
+    // check that balancing two batches cut at different reads preserves the pairing
+    {
+        SharedPointer<io::SequenceDataStream> read_data_file1( io::open_sequence_file( "./input_thread_test_1.fastq" ) );
+        SharedPointer<io::SequenceDataStream> read_data_file2( io::open_sequence_file( "./input_thread_test_2.fastq" ) );
+
+        io::SequenceDataHost read_data1;
+        io::SequenceDataHost read_data2;
+
+        uint32 n_pairs = 0;
+        while (1)
+        {
+            const int ret1 = io::next( DNA_N, &read_data1, read_data_file1.get(), BATCH_SIZE, BATCH_SIZE*READ_LENGTH );
+            const int ret2 = io::next( DNA_N, &read_data2, read_data_file2.get(), BATCH_SIZE, BATCH_SIZE*READ_LENGTH );
+            if (ret1 == 0 && ret2 == 0)
+                break;
+
+            if (n_pairs == 0 && ret1 == ret2)
+            {
+                log_error( stderr, "test InputThreadPE... failed! (the bp cap cut both streams at %d reads)\n", ret1 );
+                exit(1);
+            }
+
+            if (ret1 && ret2)
+                balance_mate_batches( &read_data1, read_data_file1.get(), &read_data2, read_data_file2.get() );
+
+            if (ret1 == 0 || ret2 == 0 || read_data1.size() != read_data2.size())
+            {
+                log_error( stderr, "test InputThreadPE... failed! (unbalanced batches: %d vs %d reads)\n",
+                    ret1 ? int( read_data1.size() ) : 0,
+                    ret2 ? int( read_data2.size() ) : 0 );
+                exit(1);
+            }
+
+            check_mate_names( read_data1, read_data2, n_pairs );
+
+            n_pairs += read_data1.size();
+        }
+
+        if (n_pairs != N_PAIRS)
+        {
+            log_error( stderr, "test InputThreadPE... failed! (%u pairs read, expected %u)\n", n_pairs, N_PAIRS );
+            exit(1);
+        }
+    }
+
+    // and check the pairing of the batches produced by the paired-end input thread
+    {
+        SharedPointer<io::SequenceDataStream> read_data_file1( io::open_sequence_file( "./input_thread_test_1.fastq" ) );
+        SharedPointer<io::SequenceDataStream> read_data_file2( io::open_sequence_file( "./input_thread_test_2.fastq" ) );
+
+        Stats stats;
+
+        InputThreadPE input_thread(
+            read_data_file1.get(),
+            read_data_file2.get(),
+            stats,
+            BATCH_SIZE,
+            READ_LENGTH );
+        input_thread.create();
+
+        uint32 n_pairs = 0;
+        while (1)
+        {
+            uint32 offset;
+            const std::pair<io::SequenceDataHost*,io::SequenceDataHost*> read_data = input_thread.next( &offset );
+            if (read_data.first == NULL)
+                break;
+
+            if (offset != n_pairs ||
+                read_data.first->size() != read_data.second->size())
+            {
+                log_error( stderr, "test InputThreadPE... failed! (batch at read %u: offset %u, %u vs %u reads)\n",
+                    n_pairs, offset, read_data.first->size(), read_data.second->size() );
+                exit(1);
+            }
+
+            check_mate_names( *read_data.first, *read_data.second, n_pairs );
+
+            n_pairs += read_data.first->size();
+
+            input_thread.release( read_data );
+        }
+        input_thread.join();
+
+        if (n_pairs != N_PAIRS)
+        {
+            log_error( stderr, "test InputThreadPE... failed! (%u pairs read, expected %u)\n", n_pairs, N_PAIRS );
+            exit(1);
+        }
+    }
+
+    remove( "./input_thread_test_1.fastq" );
+    remove( "./input_thread_test_2.fastq" );
+
+    log_info( stderr, "test InputThreadPE... done\n" );
+}
+
+} // namespace cuda
+} // namespace bowtie2
+} // namespace nvbio
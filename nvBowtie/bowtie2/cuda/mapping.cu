@@ -112,9 +112,10 @@ void map_exact(
     SeedHitDequeArrayDeviceView                     hits,
     const ParamsPOD                                 params,
     const bool                                      fw,
-    const bool                                      rc)
+    const bool                                      rc,
+    const SeedIntervalCacheView<uint32>             cache)
 {
-    map_exact_t( read_batch, fmi, rfmi, retry, queues, reseed, hits, params, fw, rc );
+    map_exact_t( read_batch, fmi, rfmi, retry, queues, reseed, hits, params, fw, rc, cache );
 }
 
 //
@@ -181,9 +182,10 @@ void map(
     SeedHitDequeArrayDeviceView                     hits,
     const ParamsPOD                                 params,
     const bool                                      fw,
-    const bool                                      rc)
+    const bool                                      rc,
+    const SeedIntervalCacheView<uint32>             cache)
 {
-    map_t( read_batch, fmi, rfmi, retry, queues, reseed, hits, params, fw, rc );
+    map_t( read_batch, fmi, rfmi, retry, queues, reseed, hits, params, fw, rc, cache );
 }
 
 } // namespace cuda
@@ -45,6 +45,7 @@
 #include <nvbio/basic/priority_deque.h>
 #include <nvbio/basic/strided_iterator.h>
 #include <nvbio/basic/algorithms.h>
+#include <nvbio/fmindex/seed_cache.h>
 
 namespace nvbio {
 namespace bowtie2 {
@@ -101,7 +102,8 @@ void map_whole_read(
 
 ///
 /// perform one run of exact seed mapping for all the reads in the input queue,
-/// writing reads that need another run in the output queue
+/// writing reads that need another run in the output queue; if a seed interval
+/// cache is provided, the ranges of repetitive seeds are memoized across reads
 ///
 void map_exact(
     const ReadsDef::type&                           read_batch,
@@ -113,7 +115,8 @@ void map_exact(
     SeedHitDequeArrayDeviceView                     hits,
     const ParamsPOD                                 params,
     const bool                                      fw,
-    const bool                                      rc);
+    const bool                                      rc,
+    const SeedIntervalCacheView<uint32>             cache = SeedIntervalCacheView<uint32>());
 
 ///
 /// perform multiple runs of exact seed mapping in one go and keep the best
@@ -170,7 +173,8 @@ void map(
     SeedHitDequeArrayDeviceView                     hits,
     const ParamsPOD                                 params,
     const bool                                      fw,
-    const bool                                      rc);
+    const bool                                      rc,
+    const SeedIntervalCacheView<uint32>             cache = SeedIntervalCacheView<uint32>());
 
 ///@}  // group Mapping
 ///@}  // group nvBowtie
@@ -42,6 +42,7 @@
 #include <nvbio/basic/transform_iterator.h>
 #include <nvbio/basic/index_transform_iterator.h>
 #include <nvbio/basic/algorithms.h>
+#include <nvbio/fmindex/seed_cache.h>
 
 namespace nvbio {
 namespace bowtie2 {
@@ -242,7 +243,8 @@ struct seed_mapper<EXACT_MAPPING>
         uint32&             range_count,
         const ParamsPOD&    params,
         const bool          fw,
-        const bool          rc)
+        const bool          rc,
+        const SeedIntervalCacheView<uint32>& cache = SeedIntervalCacheView<uint32>())
     {
         const OffsetXform <typename SeedIterator::index_type> forward_offset(0);
         const ReverseXform<typename SeedIterator::index_type> reverse_offset(seed_len);
@@ -251,61 +253,74 @@ struct seed_mapper<EXACT_MAPPING>
         typedef index_transform_iterator< SeedIterator, ReverseXform<typename SeedIterator::index_type> > rSeedReader;
 
         SeedHit::Flags flags;
-        uint2          range;
+        uint2          f_range = make_uint2(1u,0u);
+        uint2          r_range = make_uint2(1u,0u);
 
         // forward scan, forward index=0
         const fSeedReader f_reader(seed, forward_offset);
         if (util::count_occurrences( f_reader, seed_len, 4u, 1u ))
             return;
 
-        if (fw)
+        // the cache stores both strands' ranges, so it's only used when both are requested
+        uint64 seed_key;
+        const bool cached = cache.enabled() && fw && rc && pack_seed( f_reader, seed_len, &seed_key );
+
+        if (cached == false || cache.find( seed_key, &f_range, &r_range ) == false)
         {
-            range = make_uint2(0, fmi.length());
-            range = match_range(range, fmi, f_reader, 0, seed_len);
-            if (range.x <= range.y)
+            if (fw)
             {
-                flags = SeedHit::build_flags(STANDARD, FORWARD, read_range.y-pos-seed_len);
-                if (hitheap.size() == params.max_hits)
-                    hitheap.pop_bottom();
-                hitheap.push(SeedHit(flags, inclusive_to_exclusive(range)));
+                f_range = make_uint2(0, fmi.length());
+                f_range = match_range(f_range, fmi, f_reader, 0, seed_len);
+            }
 
-                range_sum += range.y - range.x + 1u;
-                range_count++;
+            if (rc)
+            {
+            #if USE_REVERSE_INDEX
+                // Complement seed=1, forward scan, reverse index=1
+                const transform_iterator<fSeedReader, complement_functor<4> > cf_reader(f_reader, complement_functor<4>());
+
+                r_range = make_uint2(0, rfmi.length());
+                r_range = match_range(r_range, rfmi, cf_reader, 0, seed_len);
+            #else
+                // Complement seed=1, reverse scan, forward index=0
+                const rSeedReader r_reader(seed, reverse_offset);                        
+                const transform_iterator<rSeedReader, complement_functor<4> > cr_reader(r_reader, complement_functor<4>());
+
+                r_range = make_uint2(0, fmi.length());
+                r_range = match_range(r_range, fmi, cr_reader, 0, seed_len);
+            #endif
             }
+
+            if (cached)
+                cache.insert( seed_key, f_range, r_range );
         }
 
-        if (rc)
+        if (fw && f_range.x <= f_range.y)
         {
-        #if USE_REVERSE_INDEX
-            // Complement seed=1, forward scan, reverse index=1
-            const transform_iterator<fSeedReader, complement_functor<4> > cf_reader(f_reader, complement_functor<4>());
+            flags = SeedHit::build_flags(STANDARD, FORWARD, read_range.y-pos-seed_len);
+            if (hitheap.size() == params.max_hits)
+                hitheap.pop_bottom();
+            hitheap.push(SeedHit(flags, inclusive_to_exclusive(f_range)));
 
-            range = make_uint2(0, rfmi.length());
-            range = match_range(range, rfmi, cf_reader, 0, seed_len);
-            if (range.x <= range.y)
-            {
-                flags = SeedHit::build_flags(COMPLEMENT, REVERSE, pos-read_range.x+seed_len-1);
-                if (hitheap.size() == params.max_hits)
-                    hitheap.pop_bottom();
-                hitheap.push(SeedHit(flags, inclusive_to_exclusive(range)));
-            }
-        #else
-            // Complement seed=1, reverse scan, forward index=0
-            const rSeedReader r_reader(seed, reverse_offset);                        
-            const transform_iterator<rSeedReader, complement_functor<4> > cr_reader(r_reader, complement_functor<4>());
+            range_sum += f_range.y - f_range.x + 1u;
+            range_count++;
+        }
 
-            range = make_uint2(0, fmi.length());
-            range = match_range(range, fmi, cr_reader, 0, seed_len);
-            if (range.x <= range.y)
-            {
-                flags = SeedHit::build_flags(COMPLEMENT, FORWARD, pos-read_range.x);
-                if (hitheap.size() == params.max_hits)
-                    hitheap.pop_bottom();
-                hitheap.push(SeedHit(flags, inclusive_to_exclusive(range)));
+        if (rc && r_range.x <= r_range.y)
+        {
+        #if USE_REVERSE_INDEX
+            flags = SeedHit::build_flags(COMPLEMENT, REVERSE, pos-read_range.x+seed_len-1);
+            if (hitheap.size() == params.max_hits)
+                hitheap.pop_bottom();
+            hitheap.push(SeedHit(flags, inclusive_to_exclusive(r_range)));
+        #else
+            flags = SeedHit::build_flags(COMPLEMENT, FORWARD, pos-read_range.x);
+            if (hitheap.size() == params.max_hits)
+                hitheap.pop_bottom();
+            hitheap.push(SeedHit(flags, inclusive_to_exclusive(r_range)));
 
-                range_sum += range.y - range.x + 1u;
-                range_count++;
-            }
+            range_sum += r_range.y - r_range.x + 1u;
+            range_count++;
         #endif
         }
     }
@@ -331,7 +346,8 @@ struct seed_mapper<APPROX_MAPPING>
         uint32&             range_count,
         const ParamsPOD&    params,
         const bool          fw,
-        const bool          rc)
+        const bool          rc,
+        const SeedIntervalCacheView<uint32>& cache = SeedIntervalCacheView<uint32>())
     {
         const OffsetXform <typename SeedIterator::index_type> forward_offset(0);
         const ReverseXform<typename SeedIterator::index_type> reverse_offset(seed_len);
@@ -385,7 +401,8 @@ struct seed_mapper<CASE_PRUNING_MAPPING>
         uint32&             range_count,
         const ParamsPOD&    params,
         const bool          fw,
-        const bool          rc)
+        const bool          rc,
+        const SeedIntervalCacheView<uint32>& cache = SeedIntervalCacheView<uint32>())
     {
         const OffsetXform <typename SeedIterator::index_type> forward_offset(0);
         const ReverseXform<typename SeedIterator::index_type> reverse_offset(seed_len);
@@ -517,7 +534,8 @@ void map_queues_kernel(
     SeedHitDequeArrayDeviceView                     hits,
     const ParamsPOD                                 params,
     const bool                                      fw,
-    const bool                                      rc)
+    const bool                                      rc,
+    const SeedIntervalCacheView<uint32>             cache)
 {
     typedef PackedStringLoader<
         typename BatchType::sequence_storage_iterator,
@@ -577,7 +595,8 @@ void map_queues_kernel(
                 range_count,
                 params,
                 fw,
-                rc );
+                rc,
+                cache );
         }
 
         // save the hits
@@ -711,7 +730,7 @@ void map_case_pruning_t(
 {
     const int blocks = nvbio::cuda::max_active_blocks( detail::map_queues_kernel<detail::CASE_PRUNING_MAPPING,BatchType,FMType,rFMType>, BLOCKDIM, 0 );
     detail::map_queues_kernel<detail::CASE_PRUNING_MAPPING> <<<blocks, BLOCKDIM>>>(
-        read_batch, fmi, rfmi, retry, queues, reseed, hits, params, fw, rc );
+        read_batch, fmi, rfmi, retry, queues, reseed, hits, params, fw, rc, SeedIntervalCacheView<uint32>() );
 }
 
 //
@@ -730,7 +749,7 @@ void map_approx_t(
 {
     const int blocks = nvbio::cuda::max_active_blocks( detail::map_queues_kernel<detail::APPROX_MAPPING,BatchType,FMType,rFMType>, BLOCKDIM, 0 );
     detail::map_queues_kernel<detail::APPROX_MAPPING> <<<blocks, BLOCKDIM>>>(
-        read_batch, fmi, rfmi, retry, queues, reseed, hits, params, fw, rc );
+        read_batch, fmi, rfmi, retry, queues, reseed, hits, params, fw, rc, SeedIntervalCacheView<uint32>() );
 }
 
 //
@@ -780,11 +799,12 @@ void map_exact_t(
     SeedHitDequeArrayDeviceView                     hits,
     const ParamsPOD                                 params,
     const bool                                      fw,
-    const bool                                      rc)
+    const bool                                      rc,
+    const SeedIntervalCacheView<uint32>             cache)
 {
     const uint32 blocks = nvbio::cuda::max_active_blocks( detail::map_queues_kernel<detail::EXACT_MAPPING,BatchType,FMType,rFMType>, BLOCKDIM, 0 );
     detail::map_queues_kernel<detail::EXACT_MAPPING> <<<blocks, BLOCKDIM>>>(
-        read_batch, fmi, rfmi, retry, queues, reseed, hits, params, fw, rc );
+        read_batch, fmi, rfmi, retry, queues, reseed, hits, params, fw, rc, cache );
 }
 
 //
@@ -816,7 +836,8 @@ void map_t(
     SeedHitDequeArrayDeviceView                     hits,
     const ParamsPOD                                 params,
     const bool                                      fw,
-    const bool                                      rc)
+    const bool                                      rc,
+    const SeedIntervalCacheView<uint32>             cache)
 {
     // check whether we allow substitutions
     if (params.allow_sub)
@@ -839,7 +860,7 @@ void map_t(
     {
         // call the hybrid exact mapping kernel
         map_exact_t(
-            read_batch, fmi, rfmi, retry, queues, reseed, hits, params, fw, rc );
+            read_batch, fmi, rfmi, retry, queues, reseed, hits, params, fw, rc, cache );
     }
 }
 
@@ -174,6 +174,13 @@ void parse_options(Params& params, const std::map<std::string,std::string>& opti
     // the maximum batch of reads processed in parallel
     params.max_batch_size  = uint_option(options, "batch-size",      init ? 1024u           : params.max_batch_size );  // maximum batch size
     params.avg_read_length = uint_option(options, "read-length",     init ? AVG_READ_LENGTH : params.avg_read_length ); // average read length
+    params.adaptive_batch  = bool_option(options, "adaptive-batch",  init ? true            : params.adaptive_batch );  // resize batches at run-time
+    params.adaptive_batch  =!bool_option(options, "fixed-batch",                              !params.adaptive_batch );  // use fixed-size batches
+    params.max_input_memory= uint_option(options, "input-memory",    init ? 2048u           : params.max_input_memory );// host memory cap for the input batches (MB)
+    params.collapse_dups   = bool_option(options, "collapse-dups",   init ? false           : params.collapse_dups );   // align exact duplicate reads only once
+    params.seed_cache      = uint_option(options, "seed-cache",      init ? 64u             : params.seed_cache );      // seed interval cache size (MB)
+    params.seed_cache_min_occ = uint_option(options, "seed-cache-occ", init ? 8u           : params.seed_cache_min_occ ); // minimum occurrences for a seed to be cached
+    params.seed_cache_stats = bool_option(options, "seed-cache-stats", init ? false         : params.seed_cache_stats );// count seed cache lookups and hits
 
     // internal controls
     params.scoring_window   = uint_option(options, "scoring-window",        init ? 32u  : params.scoring_window);       // scoring window size
@@ -118,6 +118,12 @@ struct ParamsPOD
     uint32        min_read_len;
     uint32        max_batch_size;
     uint32        avg_read_length;
+    bool          adaptive_batch;
+    uint32        max_input_memory;
+    bool          collapse_dups;
+    uint32        seed_cache;
+    uint32        seed_cache_min_occ;
+    bool          seed_cache_stats;
     bool          ungapped_mates;
 
     // paired-end options
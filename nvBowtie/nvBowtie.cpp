@@ -54,6 +54,7 @@ namespace cuda {
 
     void test_seed_hit_deques();
     void test_scoring_queues();
+    void test_input_thread();
 
 } // namespace cuda
 } // namespace bowtie2
@@ -138,6 +139,12 @@ int main(int argc, char* argv[])
         log_info(stderr,"    --nofw                             do not align the forward strand\n");
         log_info(stderr,"    --norc                             do not align the reverse-complemented strand\n");
         log_info(stderr,"    --device            int [0]        select the given cuda device(s) (e.g. --device 0 --device 1 ...)\n");
+        log_info(stderr,"    --fixed-batch                      do not adapt the batch size to the measured throughput\n");
+        log_info(stderr,"    --input-memory      int [2048]     host memory cap for the input batches (MB)\n");
+        log_info(stderr,"    --collapse-dups                    align exact duplicate reads (bases and qualities) only once\n");
+        log_info(stderr,"    --seed-cache        int [64]       seed interval cache size, in MB (0 = disabled)\n");
+        log_info(stderr,"    --seed-cache-occ    int [8]        cache only seeds occurring at least this many times\n");
+        log_info(stderr,"    --seed-cache-stats                 report the seed cache hit rate (slows down seed mapping)\n");
         log_info(stderr,"    --file-ref                         load reference from file\n");
         log_info(stderr,"    --server-ref                       load reference from server\n");
         log_info(stderr,"    --phred33                          qualities are ASCII characters equal to Phred quality + 33\n");
@@ -196,6 +203,7 @@ int main(int argc, char* argv[])
         log_visible(stderr, "nvBowtie tests... started\n");
         nvbio::bowtie2::cuda::test_seed_hit_deques();
         nvbio::bowtie2::cuda::test_scoring_queues();
+        nvbio::bowtie2::cuda::test_input_thread();
         log_visible(stderr, "nvBowtie tests... done\n");
         exit(0);
     }
@@ -669,7 +677,15 @@ int main(int argc, char* argv[])
 
             bowtie2::cuda::Stats input_stats( params );
 
-            bowtie2::cuda::InputThreadPE input_thread( read_data_file1.get(),  read_data_file2.get(), input_stats, batch_size, params.avg_read_length );
+            bowtie2::cuda::InputThreadPE input_thread(
+                read_data_file1.get(),
+                read_data_file2.get(),
+                input_stats,
+                batch_size,
+                params.avg_read_length,
+                uint32( cuda_devices.size() ),
+                params.adaptive_batch,
+                uint64( params.max_input_memory )*1024u*1024u );
             input_thread.create();
 
             for (uint32 i = 0; i < cuda_devices.size(); ++i)
@@ -840,7 +856,14 @@ int main(int argc, char* argv[])
 
             bowtie2::cuda::Stats input_stats( params );
 
-            bowtie2::cuda::InputThreadSE input_thread( read_data_file.get(), input_stats, batch_size, params.avg_read_length );
+            bowtie2::cuda::InputThreadSE input_thread(
+                read_data_file.get(),
+                input_stats,
+                batch_size,
+                params.avg_read_length,
+                uint32( cuda_devices.size() ),
+                params.adaptive_batch,
+                uint64( params.max_input_memory )*1024u*1024u );
             input_thread.create();
 
             for (uint32 i = 0; i < cuda_devices.size(); ++i)
@@ -33,6 +33,7 @@
 #include <nvbio/basic/numbers.h>
 #include <nvbio/basic/threads.h>
 #include <nvbio/basic/cuda/arch.h>
+#include <nvbio/strings/kmers.h>
 
 enum {
     ERROR_FREE    = 0,
@@ -72,70 +73,8 @@ struct hash_functor2
 
 enum { MAX_READ_LENGTH = 2048 };
 
-struct KmerCode
-{
-    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-    KmerCode() : mask(0), code(0), len(0), invalid(-1) {}
-
-    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-    KmerCode(const int l) : mask(0), code(0), len(l), invalid(-1)
-    {
-        for (int i = 0 ; i < len; ++i)
-        {
-            mask = mask << 2u;
-            mask = mask | 3u;
-        }
-    }
-    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-    KmerCode(const KmerCode& k) : mask(k.mask), code(k.code), len(k.len), invalid(k.invalid)
-    {}
-
-    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-    void restart() { code = 0ull ; invalid = -1 ; } 
-
-    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-    void push_back(const uint8 c)
-    {
-        if (invalid != -1)
-            invalid++;
-
-        code = ((code << 2ull) & mask) | uint64(c & 3);
-        if (c >= 4)
-            invalid = 0;
-
-        if (invalid >= len)
-            invalid = -1;
-    }
-    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-    void push_front(const uint8 c)
-    {
-        shift_right( 1 );
-
-        if (c >= 4)
-            invalid = len - 1;
-
-        code = (code | ((uint64(c & 3)) << (2ull * (len - 1)))) & mask;
-    }
-
-    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-    void shift_right(int k)
-    {
-        if (invalid != -1)
-            invalid -= k;
-
-        code = (code >> (2ull * k)) & (mask >> (2ull * k));
-        if (invalid < 0)
-            invalid = -1;
-    }
-
-    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-    bool is_valid() const { return invalid == -1; }
-
-    uint64 mask;
-    uint64 code;
-    int    len;
-    int    invalid;
-};
+// the 2-bit rolling k-mer used throughout the error correction pipeline
+typedef nvbio::RollingKmer KmerCode;
 
 struct SequenceStats
 {
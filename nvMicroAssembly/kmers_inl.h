@@ -32,6 +32,7 @@
 #include <nvbio/basic/cuda/sort.h>
 #include <nvbio/basic/cuda/primitives.h>
 #include <nvbio/strings/seeds.h>
+#include <nvbio/strings/kmers.h>
 
 #include "assembly_types.h"
 #include <thrust/iterator/discard_iterator.h>
@@ -247,11 +248,7 @@ struct kmers_to_64b_functor
         const uint32 seq_pos = kmer_coord.y;
         const uint32 seq_len = seq.length();
 
-        uint64 kmer_key = 0u;
-        for (uint32 i = 0; i < kmer_size; i++) {
-        	kmer_key |= uint64(seq_pos + i < seq_len ? (seq[seq_pos + i] & symbol_mask) : 0u) << ((kmer_size-1-i)*dna_symbol_size); //(i*dna_symbol_size);
-        }
-        return kmer_key;
+        return load_kmer<false>( seq, seq_len, seq_pos, kmer_size, dna_symbol_size );
     }
 };
 
@@ -113,9 +113,9 @@ struct SinkStage
 
     /// constructor
     ///
-    ///\param file          input sequence file
-    ///\param max_strings   maximum number of strings per batch
-    ///\param max_bps       maximum number of base pairs per batch
+    ///\param context       the BWTE context
+    ///\param bwt           the output BWT, possibly already holding a previously loaded collection
+    ///\param dollars       the output dollars
     ///
     SinkStage(
         BWTE_context_type&                  context,
@@ -124,6 +124,7 @@ struct SinkStage
         m_context( context ),
         m_bwt( bwt ),
         m_dollars( dollars ),
+        m_id_offset( dollars.size() ),
         n_reads( 0 ),
         m_time( 0.0f )
     {}
@@ -159,6 +160,9 @@ struct SinkStage
         // fetch the second input
         BWTEBlock* block = context.input<BWTEBlock>( 1 );
 
+        // turn the block-local string ids into global ones, following any previously loaded strings
+        block->offset_dollar_ids( m_id_offset + n_reads );
+
         m_context.merge_block(
             0u,
             h_read_data->size(),
@@ -175,6 +179,7 @@ struct SinkStage
     BWTE_context_type&                  m_context;
     PagedText<SYMBOL_SIZE,BIG_ENDIAN>&  m_bwt;
     SparseSymbolSet&                    m_dollars;
+    uint32                              m_id_offset;
     uint32                              n_reads;
     float                               m_time;
 };
@@ -193,6 +198,8 @@ int main(int argc, char* argv[])
         log_info(stderr, "   -b       | --bucketing     int       [16]   (# of bits used for bucketing)\n");
         log_info(stderr, "   -F       | --skip-forward\n");
         log_info(stderr, "   -R       | --skip-reverse\n");
+        log_info(stderr, "   -a       | --append        string    (existing .bwt|.bwt.gz|.bwt.bgz file to merge the input reads into)\n");
+        log_info(stderr, "   -O       | --occ           int       [0]    (also output a .occ FM-index occurrence table sampled every int symbols)\n");
         log_info(stderr, "  output formats:\n");
         log_info(stderr, "    .txt      ASCII\n");
         log_info(stderr, "    .txt.gz   ASCII, gzip compressed\n");
@@ -213,6 +220,8 @@ int main(int argc, char* argv[])
     const char* comp_level        = "1R";
     io::QualityEncoding qencoding = io::Phred33;
     int   threads                 = 0;
+    const char* append_name       = NULL;
+    uint32      occ_intv          = 0;
 
     for (int i = 0; i < argc - 2; ++i)
     {
@@ -242,14 +251,42 @@ int main(int argc, char* argv[])
         {
             threads = atoi( argv[++i] );
         }
+        else if ((strcmp( argv[i], "-a" )             == 0) ||
+                 (strcmp( argv[i], "--append" )       == 0))  // append to an existing BWT
+        {
+            append_name = argv[++i];
+        }
+        else if ((strcmp( argv[i], "-O" )             == 0) ||
+                 (strcmp( argv[i], "--occ" )          == 0))  // output an occurrence table
+        {
+            occ_intv = atoi( argv[++i] );
+        }
     }
 
     try
     {
         log_visible(stderr,"nvSetBWT... started\n");
 
+        // output vectors
+        PagedText<SYMBOL_SIZE,BIG_ENDIAN> bwt;
+        SparseSymbolSet                   dollars;
+
+        // load the existing BWT before opening the output, which might overwrite it
+        if (append_name)
+        {
+            log_visible(stderr, "loading BWT file \"%s\"\n", append_name);
+            if (load_bwt_file( append_name, bwt, dollars ) == false)
+            {
+                log_error(stderr, "    failed loading file \"%s\"\n", append_name);
+                return 1;
+            }
+            log_info(stderr, "  %u strings, %.2fG symbols\n", dollars.size(), 1.0e-9f * bwt.size());
+        }
+
         // build an output file
-        SharedPointer<SetBWTHandler> output_handler = SharedPointer<SetBWTHandler>( open_bwt_file( output_name, comp_level ) );
+        SharedPointer<SetBWTHandler> output_handler = SharedPointer<SetBWTHandler>( occ_intv ?
+            open_fmindex_file( output_name, comp_level, occ_intv ) :
+            open_bwt_file( output_name, comp_level ) );
         if (output_handler == NULL)
         {
             log_error(stderr, "  failed to create an output handler\n");
@@ -294,10 +331,6 @@ int main(int argc, char* argv[])
             return false;
         }
 
-        // output vectors
-        PagedText<SYMBOL_SIZE,BIG_ENDIAN> bwt;
-        SparseSymbolSet                   dollars;
-
         // get the current device
         int current_device;
         cudaGetDevice( &current_device );
@@ -347,33 +380,7 @@ int main(int argc, char* argv[])
         log_info(stderr,"  writing output... started\n");
 
         // write out the results
-        for (uint32 i = 0; i < bwt.page_count(); ++i)
-        {
-            // find the dollars corresponding to this page
-            const uint64 page_begin = bwt.get_page_offset(i);
-            const uint64 page_end   = bwt.get_page_offset(i+1);
-
-            const uint64 dollars_begin = nvbio::lower_bound_index(
-                page_begin,
-                dollars.pos(),
-                dollars.size() );
-
-            const uint64 dollars_end = nvbio::lower_bound_index(
-                page_end,
-                dollars.pos(),
-                dollars.size() );
-
-            //log_debug(stderr,"    page[%u] : %llu symbols (%llu,%llu), %llu dollars (%llu,%llu)\n", i, page_end - page_begin, page_begin, page_end, dollars_end - dollars_begin, dollars_begin, dollars_end);
-
-            // and output the page
-            output_handler->process(
-                bwt.get_page_size(i),
-                SYMBOL_SIZE,
-                (const uint32*)bwt.get_page(i),
-                dollars_end - dollars_begin,
-                dollars.pos() + dollars_begin,
-                dollars.ids() + dollars_begin );
-        }
+        output_bwt( bwt, dollars, *output_handler );
 
         log_info(stderr,"  writing output... done\n");
 
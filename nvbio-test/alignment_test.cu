@@ -39,6 +39,7 @@
 #include <nvbio/basic/vector.h>
 #include <nvbio/basic/shared_pointer.h>
 #include <nvbio/basic/dna.h>
+#include <nvbio/strings/string_set.h>
 #include <nvbio/alignment/alignment.h>
 #include <nvbio/alignment/batched.h>
 #include <nvbio/alignment/sink.h>
@@ -610,6 +611,870 @@ void banded_edit_distance_test(
         fprintf(stderr, "  synthetic Edit Distance test %u... passed!\n", test_id);
 }
 
+// a simple X-drop/Z-drop extension test
+//
+template <ExtensionDirection DIR, typename string_type>
+void extension_test(
+    const uint32      test_id,
+    const string_type pattern,
+    const string_type text,
+    const int32       ref_score,
+    const uint2       ref_sink,
+    const int32       ref_global_score)
+{
+    int2 row[64];
+
+    ExtensionSink<int32> sink;
+    extension_score<DIR>(
+        make_gotoh_aligner<aln::LOCAL>( aln::SimpleGotohScheme( 1, -4, -7, -1 ) ),
+        ExtensionParams( 0, 100, 0 ),
+        pattern,
+        trivial_quality_string(),
+        text,
+        10,
+        sink,
+        row );
+
+    if (sink.score != ref_score || sink.sink.x != ref_sink.x || sink.sink.y != ref_sink.y || sink.global_score != ref_global_score)
+    {
+        log_error(stderr, "  synthetic extension test %u... failed\n", test_id);
+        log_error(stderr, "    expected %d @ (%u,%u) / %d, got: %d @ (%u,%u) / %d - pattern: %s text: %s\n",
+            ref_score, ref_sink.x, ref_sink.y, ref_global_score,
+            sink.score, sink.sink.x, sink.sink.y, sink.global_score,
+            pattern.begin(), text.begin());
+        exit(1);
+    }
+    else
+        fprintf(stderr, "  synthetic extension test %u... passed!\n", test_id);
+}
+
+// a linear-space traceback test on a pair of long strings, checking that the backtracked
+// alignment achieves the optimal score
+//
+template <typename aligner_type>
+void hirschberg_test(
+    const char*         test,
+    const aligner_type  aligner,
+    const uint32        M,
+    const uint32        N,
+    const uint8*        str,
+    const uint8*        ref)
+{
+    const uint32 CHECKPOINTS = 16u;
+    const uint32 BITS        = direction_vector_traits<aligner_type>::BITS;
+
+    typedef typename checkpoint_storage_type<aligner_type>::type checkpoint_type;
+    typedef typename column_storage_type<aligner_type>::type     cell_type;
+
+    // linear-space temporary storage
+    std::vector<cell_type>       column( N );
+    std::vector<checkpoint_type> checkpoints( N+1 );
+    std::vector<uint32>          submatrix_words( util::divide_ri( N*CHECKPOINTS*BITS, 32u ) );
+    std::vector<int4>            hcolumns( 2*(N+1) );
+
+    PackedStream<uint32*,uint8,BITS,false> submatrix( &submatrix_words[0] );
+
+    aln::BestSink<int32> sink;
+    aln::alignment_score(
+        aligner,
+        vector_view<const uint8*>( M, str ),
+        trivial_quality_string(),
+        vector_view<const uint8*>( N, ref ),
+        -10000,
+        sink,
+        &column[0] );
+
+    TestBacktracker backtracker;
+    backtracker.clear();
+
+    const Alignment<int32> aln = hirschberg_alignment_traceback<CHECKPOINTS>(
+        aligner,
+        vector_view<const uint8*>( M, str ),
+        trivial_quality_string(),
+        vector_view<const uint8*>( N, ref ),
+        -10000,
+        backtracker,
+        &checkpoints[0],
+        submatrix,
+        &column[0],
+        &hcolumns[0] );
+
+    const int32 aln_score = backtracker.score( aligner, aln.source.x, str, ref );
+
+    if (aln.score != sink.score || aln_score != sink.score || aln.sink.y != M)
+    {
+        log_error(stderr, "  linear-space traceback test %s... failed\n", test);
+        log_error(stderr, "    expected score %d, got %d (backtracked: %d) - [%u, %u] x [%u, %u]\n",
+            sink.score, aln.score, aln_score, aln.source.x, aln.sink.x, aln.source.y, aln.sink.y);
+        exit(1);
+    }
+    else
+        fprintf(stderr, "  linear-space traceback test %s... passed!\n", test);
+}
+
+// A traceback stream over a batch of fixed-stride patterns and texts, to be used in conjunction
+// with the BatchAlignmentTraceback class
+//
+template <typename t_aligner_type>
+struct TracebackTestStream
+{
+    typedef t_aligner_type                                                          aligner_type;
+    typedef vector_view<const uint8*>                                               string_type;
+
+    // an alignment context
+    struct context_type
+    {
+        int32               min_score;
+        TestBacktracker     backtracer;
+        Alignment<int32>    alignment;
+    };
+    // a container for the strings to be aligned
+    struct strings_type
+    {
+        string_type             pattern;
+        trivial_quality_string  quals;
+        string_type             text;
+    };
+
+    // constructor
+    TracebackTestStream(
+        aligner_type        _aligner,
+        const uint32        _count,
+        const uint8*        _patterns,
+        const uint32*       _pattern_lengths,
+        const uint32        _pattern_stride,
+        const uint8*        _texts,
+        const uint32*       _text_lengths,
+        const uint32        _text_stride,
+        Alignment<int32>*   _alignments,
+        TestBacktracker*    _backtracers) :
+        m_aligner( _aligner ), m_count(_count),
+        m_patterns(_patterns), m_pattern_lengths(_pattern_lengths), m_pattern_stride(_pattern_stride),
+        m_texts(_texts), m_text_lengths(_text_lengths), m_text_stride(_text_stride),
+        m_alignments(_alignments), m_backtracers(_backtracers) {}
+
+    // get the aligner
+    const aligner_type& aligner() const { return m_aligner; };
+
+    // return the maximum pattern length
+    uint32 max_pattern_length() const { return m_pattern_stride; }
+
+    // return the maximum text length
+    uint32 max_text_length() const { return m_text_stride; }
+
+    // return the stream size
+    uint32 size() const { return m_count; }
+
+    // return the i-th pattern's length
+    uint32 pattern_length(const uint32 i, context_type* context) const { return m_pattern_lengths[i]; }
+
+    // return the i-th text's length
+    uint32 text_length(const uint32 i, context_type* context) const { return m_text_lengths[i]; }
+
+    // initialize the i-th context
+    bool init_context(
+        const uint32    i,
+        context_type*   context) const
+    {
+        context->min_score = -10000;
+        context->backtracer.clear();
+        return true;
+    }
+
+    // initialize the i-th context
+    void load_strings(
+        const uint32        i,
+        const uint32        window_begin,
+        const uint32        window_end,
+        const context_type* context,
+              strings_type* strings) const
+    {
+        strings->pattern = string_type( m_pattern_lengths[i], m_patterns + i * m_pattern_stride );
+        strings->text    = string_type( m_text_lengths[i],    m_texts    + i * m_text_stride );
+    }
+
+    // handle the output
+    void output(
+        const uint32        i,
+        const context_type* context) const
+    {
+        m_alignments[i]  = context->alignment;
+        m_backtracers[i] = context->backtracer;
+    }
+
+    aligner_type        m_aligner;
+    uint32              m_count;
+    const uint8*        m_patterns;
+    const uint32*       m_pattern_lengths;
+    uint32              m_pattern_stride;
+    const uint8*        m_texts;
+    const uint32*       m_text_lengths;
+    uint32              m_text_stride;
+    Alignment<int32>*   m_alignments;
+    TestBacktracker*    m_backtracers;
+};
+
+// a host batched traceback test, checking each job of the batch against the single-job
+// checkpointed traceback
+//
+template <typename aligner_type>
+void batch_alignment_traceback_test(
+    const char*         test,
+    const aligner_type  aligner,
+    const uint32        n_jobs,
+    const uint8*        patterns,
+    const uint32*       pattern_lengths,
+    const uint32        M,
+    const uint8*        texts,
+    const uint32*       text_lengths,
+    const uint32        N)
+{
+    const uint32 CHECKPOINTS = 16u;
+    const uint32 BITS        = direction_vector_traits<aligner_type>::BITS;
+
+    typedef TracebackTestStream<aligner_type>                                               stream_type;
+    typedef BatchedAlignmentTraceback<CHECKPOINTS,stream_type,HostThreadScheduler>          batch_type;
+
+    std::vector< Alignment<int32> > alignments( n_jobs );
+    std::vector<TestBacktracker>    backtracers( n_jobs );
+
+    stream_type stream(
+        aligner,
+        n_jobs,
+        patterns, pattern_lengths, M,
+        texts,    text_lengths,    N,
+        &alignments[0],
+        &backtracers[0] );
+
+    batch_type batch;
+    batch.enact( stream );
+
+    typedef typename checkpoint_storage_type<aligner_type>::type checkpoint_type;
+    typedef typename column_storage_type<aligner_type>::type     cell_type;
+
+    // single-job checkpointed traceback storage, large enough for either blocking direction
+    const uint32 L = nvbio::max( M, N );
+
+    std::vector<cell_type>       column( L );
+    std::vector<checkpoint_type> checkpoints( (L+1) * util::divide_ri( L, CHECKPOINTS ) );
+    std::vector<uint32>          submatrix_words( util::divide_ri( L*CHECKPOINTS*BITS, 32u ) );
+
+    PackedStream<uint32*,uint8,BITS,false> submatrix( &submatrix_words[0] );
+
+    for (uint32 i = 0; i < n_jobs; ++i)
+    {
+        const uint8* str = patterns + i * M;
+        const uint8* ref = texts    + i * N;
+
+        TestBacktracker backtracker;
+        backtracker.clear();
+
+        const Alignment<int32> ref_aln = alignment_traceback<CHECKPOINTS>(
+            aligner,
+            vector_view<const uint8*>( pattern_lengths[i], str ),
+            trivial_quality_string(),
+            vector_view<const uint8*>( text_lengths[i], ref ),
+            -10000,
+            backtracker,
+            &checkpoints[0],
+            submatrix,
+            &column[0] );
+
+        const Alignment<int32> aln       = alignments[i];
+        const int32            aln_score = backtracers[i].score( aligner, aln.source.x, str, ref );
+
+        if (aln.score     != ref_aln.score  ||
+            aln_score     != ref_aln.score  ||
+            aln.sink.x    != ref_aln.sink.x ||
+            aln.sink.y    != ref_aln.sink.y)
+        {
+            log_error(stderr, "  batched traceback test %s... failed at job %u\n", test, i);
+            log_error(stderr, "    expected score %d @ (%u,%u), got %d (backtracked: %d) @ (%u,%u)\n",
+                ref_aln.score, ref_aln.sink.x, ref_aln.sink.y,
+                aln.score, aln_score, aln.sink.x, aln.sink.y);
+            exit(1);
+        }
+    }
+    fprintf(stderr, "  batched traceback test %s... passed!\n", test);
+}
+
+// A scoring stream over a batch of fixed-stride patterns and texts, to be used in conjunction
+// with the BatchedAlignmentScore class, recording how many times each context is loaded
+// and the order in which the jobs are scored
+//
+template <typename t_aligner_type>
+struct ScoreTestStream
+{
+    typedef t_aligner_type                                                          aligner_type;
+    typedef vector_view<const uint8*>                                               string_type;
+
+    // an alignment context
+    struct context_type
+    {
+        int32                   min_score;
+        aln::BestSink<int32>    sink;
+    };
+    // a container for the strings to be aligned
+    struct strings_type
+    {
+        string_type             pattern;
+        trivial_quality_string  quals;
+        string_type             text;
+    };
+
+    // constructor
+    ScoreTestStream(
+        aligner_type        _aligner,
+        const uint32        _count,
+        const uint8*        _patterns,
+        const uint32*       _pattern_lengths,
+        const uint32        _pattern_stride,
+        const uint8*        _texts,
+        const uint32*       _text_lengths,
+        const uint32        _text_stride,
+        int32*              _scores,
+        uint32*             _init_counts,
+        uint32*             _order,
+        uint32*             _order_counter) :
+        m_aligner( _aligner ), m_count(_count),
+        m_patterns(_patterns), m_pattern_lengths(_pattern_lengths), m_pattern_stride(_pattern_stride),
+        m_texts(_texts), m_text_lengths(_text_lengths), m_text_stride(_text_stride),
+        m_scores(_scores), m_init_counts(_init_counts), m_order(_order), m_order_counter(_order_counter) {}
+
+    // get the aligner
+    const aligner_type& aligner() const { return m_aligner; };
+
+    // return the maximum pattern length
+    uint32 max_pattern_length() const { return m_pattern_stride; }
+
+    // return the maximum text length
+    uint32 max_text_length() const { return m_text_stride; }
+
+    // return the stream size
+    uint32 size() const { return m_count; }
+
+    // return the i-th pattern's length
+    uint32 pattern_length(const uint32 i, context_type* context) const { return m_pattern_lengths[i]; }
+
+    // return the i-th text's length
+    uint32 text_length(const uint32 i, context_type* context) const { return m_text_lengths[i]; }
+
+    // initialize the i-th context
+    bool init_context(
+        const uint32    i,
+        context_type*   context) const
+    {
+        host_atomic_add( m_init_counts + i, 1u );
+
+        context->min_score = -10000;
+        context->sink      = aln::BestSink<int32>();
+        return true;
+    }
+
+    // load the i-th strings, recording the scoring order
+    void load_strings(
+        const uint32        i,
+        const uint32        window_begin,
+        const uint32        window_end,
+        const context_type* context,
+              strings_type* strings) const
+    {
+        m_order[ host_atomic_add( m_order_counter, 1u ) ] = i;
+
+        strings->pattern = string_type( m_pattern_lengths[i], m_patterns + i * m_pattern_stride );
+        strings->text    = string_type( m_text_lengths[i],    m_texts    + i * m_text_stride );
+    }
+
+    // handle the output
+    void output(
+        const uint32        i,
+        const context_type* context) const
+    {
+        m_scores[i] = context->sink.score;
+    }
+
+    aligner_type        m_aligner;
+    uint32              m_count;
+    const uint8*        m_patterns;
+    const uint32*       m_pattern_lengths;
+    uint32              m_pattern_stride;
+    const uint8*        m_texts;
+    const uint32*       m_text_lengths;
+    uint32              m_text_stride;
+    int32*              m_scores;
+    uint32*             m_init_counts;
+    uint32*             m_order;
+    uint32*             m_order_counter;
+};
+
+// a host batched scoring test over jobs of widely different sizes, checking the scores against
+// the single-job scoring, that each context is loaded once, that a single thread processes the jobs
+// most expensive first, and that the per-thread statistics account for all the DP cells
+//
+template <typename aligner_type>
+void batch_alignment_score_test(
+    const char*         test,
+    const aligner_type  aligner)
+{
+    const uint32 n_jobs = 300;
+    const uint32 M      = 256;
+    const uint32 N      = M + 32;
+
+    typedef ScoreTestStream<aligner_type>                                   stream_type;
+    typedef aln::BatchedAlignmentScore<stream_type,HostThreadScheduler>     batch_type;
+    typedef typename column_storage_type<aligner_type>::type                cell_type;
+
+    std::vector<uint8>  patterns( n_jobs * M );
+    std::vector<uint8>  texts( n_jobs * N );
+    std::vector<uint32> pattern_lengths( n_jobs );
+    std::vector<uint32> text_lengths( n_jobs );
+    std::vector<uint64> job_cells( n_jobs );
+
+    uint64 total_cells = 0u;
+
+    srand( 1357 );
+    for (uint32 job = 0; job < n_jobs; ++job)
+    {
+        // spread the job sizes over several cost bins
+        pattern_lengths[ job ] = 4u + rand() % (M - 4u);
+        text_lengths[ job ]    = pattern_lengths[ job ] + rand() % (N - M);
+
+        for (uint32 i = 0; i < text_lengths[ job ]; ++i)
+            texts[ job * N + i ] = uint8( rand() & 3 );
+
+        for (uint32 i = 0; i < pattern_lengths[ job ]; ++i)
+            patterns[ job * M + i ] = (rand() % 10) ? texts[ job * N + i ] : uint8( rand() & 3 );
+
+        job_cells[ job ] = uint64( pattern_lengths[ job ] ) * uint64( text_lengths[ job ] );
+        total_cells     += job_cells[ job ];
+    }
+
+    std::vector<cell_type> column( N );
+
+    // run the batch on a single thread first, and then on all of them
+    for (uint32 pass = 0; pass < 2; ++pass)
+    {
+        const bool single_thread = (pass == 0);
+
+        std::vector<int32>  scores( n_jobs );
+        std::vector<uint32> init_counts( n_jobs, 0u );
+        std::vector<uint32> order( n_jobs );
+        uint32              order_counter = 0u;
+
+        stream_type stream(
+            aligner,
+            n_jobs,
+            &patterns[0], &pattern_lengths[0], M,
+            &texts[0],    &text_lengths[0],    N,
+            &scores[0],
+            &init_counts[0],
+            &order[0],
+            &order_counter );
+
+      #if defined(_OPENMP)
+        const int max_threads = omp_get_max_threads();
+        if (single_thread)
+            omp_set_num_threads( 1 );
+      #endif
+
+        batch_type batch;
+        batch.enact( stream );
+
+      #if defined(_OPENMP)
+        omp_set_num_threads( max_threads );
+      #endif
+
+        if (order_counter != n_jobs)
+        {
+            log_error(stderr, "  batched score test %s... failed: %u jobs scored, expected %u\n", test, order_counter, n_jobs);
+            exit(1);
+        }
+
+        for (uint32 i = 0; i < n_jobs; ++i)
+        {
+            aln::BestSink<int32> sink;
+            aln::alignment_score(
+                aligner,
+                vector_view<const uint8*>( pattern_lengths[i], &patterns[ i * M ] ),
+                trivial_quality_string(),
+                vector_view<const uint8*>( text_lengths[i], &texts[ i * N ] ),
+                -10000,
+                sink,
+                &column[0] );
+
+            if (scores[i] != sink.score || init_counts[i] != 1u)
+            {
+                log_error(stderr, "  batched score test %s... failed at job %u\n", test, i);
+                log_error(stderr, "    expected score %d, got %d (context loaded %u times)\n", sink.score, scores[i], init_counts[i]);
+                exit(1);
+            }
+        }
+
+        // a single thread must process the jobs by decreasing cost bin
+        if (single_thread)
+        {
+            for (uint32 i = 1; i < n_jobs; ++i)
+            {
+                if (nvbio::log2( uint32( job_cells[ order[i] ] ) ) > nvbio::log2( uint32( job_cells[ order[i-1] ] ) ))
+                {
+                    log_error(stderr, "  batched score test %s... failed: job %u (%llu cells) scored after job %u (%llu cells)\n",
+                        test, order[i], job_cells[ order[i] ], order[i-1], job_cells[ order[i-1] ]);
+                    exit(1);
+                }
+            }
+        }
+
+        // the per-thread statistics must account for all the cells
+        uint64 thread_cells = 0u;
+        for (uint32 t = 0; t < batch.n_threads; ++t)
+        {
+            thread_cells += batch.thread_cells[t];
+
+            if (batch.thread_time[t] < 0.0f)
+            {
+                log_error(stderr, "  batched score test %s... failed: thread %u has negative time\n", test, t);
+                exit(1);
+            }
+        }
+
+        const float utilization = batch.utilization();
+
+        if ((single_thread && batch.n_threads != 1u) ||
+            thread_cells != total_cells ||
+            utilization < 0.0f || utilization > 1.0f)
+        {
+            log_error(stderr, "  batched score test %s... failed: %u threads, %llu cells (expected %llu), %.2f utilization\n",
+                test, batch.n_threads, thread_cells, total_cells, utilization);
+            exit(1);
+        }
+    }
+    fprintf(stderr, "  batched score test %s... passed!\n", test);
+}
+
+template <typename aligner_type>
+void adaptive_banded_test(
+    const char*         test,
+    const aligner_type  aligner,
+    const uint32        M,
+    const uint32        N,
+    const uint8*        str,
+    const uint8*        ref)
+{
+    const uint32 BAND_LEN    = 16u;
+    const uint32 CHECKPOINTS = 16u;
+
+    typedef typename column_storage_type<aligner_type>::type cell_type;
+
+    // the optimal score, from the whole DP matrix
+    std::vector<cell_type> column( N );
+
+    aln::BestSink<int32> sink;
+    aln::alignment_score(
+        aligner,
+        vector_view<const uint8*>( M, str ),
+        trivial_quality_string(),
+        vector_view<const uint8*>( N, ref ),
+        -10000,
+        sink,
+        &column[0] );
+
+    const int32 band_score = adaptive_banded_alignment_score<BAND_LEN>(
+        aligner,
+        vector_view<const uint8*>( M, str ),
+        vector_view<const uint8*>( N, ref ),
+        -10000 );
+
+    TestBacktracker backtracker;
+    backtracker.clear();
+
+    const Alignment<int32> aln = adaptive_banded_alignment_traceback<BAND_LEN,512u,CHECKPOINTS>(
+        aligner,
+        vector_view<const uint8*>( M, str ),
+        trivial_quality_string(),
+        vector_view<const uint8*>( N, ref ),
+        -10000,
+        backtracker );
+
+    const int32 aln_score = backtracker.score( aligner, aln.source.x, str, ref );
+
+    if (band_score != sink.score || aln.score != sink.score || aln_score != sink.score)
+    {
+        log_error(stderr, "  adaptive banded test %s... failed\n", test);
+        log_error(stderr, "    expected score %d, got %d (traceback: %d, backtracked: %d) - [%u, %u] x [%u, %u]\n",
+            sink.score, band_score, aln.score, aln_score, aln.source.x, aln.sink.x, aln.source.y, aln.sink.y);
+        exit(1);
+    }
+    else
+        fprintf(stderr, "  adaptive banded test %s... passed!\n", test);
+}
+
+// test the host batched adaptive banded scoring against the single-job scoring, on a batch
+// of suffixes of the given pattern and text
+//
+template <typename aligner_type>
+void batch_adaptive_banded_test(
+    const char*         test,
+    const aligner_type  aligner,
+    const uint32        M,
+    const uint32        N,
+    const uint8*        str,
+    const uint8*        ref)
+{
+    const uint32 BAND_LEN = 16u;
+    const uint32 n_jobs   = 32u;
+    const uint32 STEP     = 4u;
+
+    std::vector<uint8>  patterns;
+    std::vector<uint8>  texts;
+    std::vector<uint32> pattern_offsets( 1u, 0u );
+    std::vector<uint32> text_offsets( 1u, 0u );
+
+    for (uint32 job = 0; job < n_jobs; ++job)
+    {
+        patterns.insert( patterns.end(), str + job*STEP, str + M );
+        texts.insert( texts.end(), ref + job*STEP, ref + N );
+        pattern_offsets.push_back( uint32( patterns.size() ) );
+        text_offsets.push_back( uint32( texts.size() ) );
+    }
+
+    typedef ConcatenatedStringSet<const uint8*,const uint32*> string_set_type;
+
+    const string_set_type pattern_set( n_jobs, &patterns[0], &pattern_offsets[0] );
+    const string_set_type text_set( n_jobs, &texts[0], &text_offsets[0] );
+
+    std::vector< aln::BestSink<int32> > sinks( n_jobs );
+
+    aln::batch_adaptive_banded_alignment_score<BAND_LEN>(
+        aligner,
+        pattern_set,
+        text_set,
+        -10000,
+        &sinks[0],
+        aln::HostThreadScheduler() );
+
+    for (uint32 job = 0; job < n_jobs; ++job)
+    {
+        const int32 score = adaptive_banded_alignment_score<BAND_LEN>(
+            aligner,
+            pattern_set[ job ],
+            text_set[ job ],
+            -10000 );
+
+        if (sinks[ job ].score != score)
+        {
+            log_error(stderr, "  batched adaptive banded test %s... failed\n", test);
+            log_error(stderr, "    job %u: expected score %d, got %d\n", job, score, sinks[ job ].score);
+            exit(1);
+        }
+    }
+    fprintf(stderr, "  batched adaptive banded test %s... passed!\n", test);
+}
+
+// a Gotoh scheme charging text gaps differently from pattern gaps
+//
+struct AsymmetricGotohScheme : public aln::SimpleGotohScheme
+{
+    AsymmetricGotohScheme(const int32 match, const int32 mm, const int32 gap_open, const int32 gap_ext, const int32 text_gap_open, const int32 text_gap_ext) :
+        aln::SimpleGotohScheme( match, mm, gap_open, gap_ext ), m_text_gap_open( text_gap_open ), m_text_gap_ext( text_gap_ext ) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE int32 text_gap_open()               const { return m_text_gap_open; };
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE int32 text_gap_extension()          const { return m_text_gap_ext; };
+
+    int32 m_text_gap_open;
+    int32 m_text_gap_ext;
+};
+
+// check that the SIMD difference recurrence rejects a scheme whose text and pattern gap scores differ,
+// as it only models symmetric gaps
+//
+template <typename simd_type>
+void diff_asymmetric_test(const char* test, const AsymmetricGotohScheme scoring)
+{
+    const uint32 LANES = simd_traits<simd_type>::LANES;
+    const uint32 M     = 8u;
+
+    uint32 lengths[LANES];
+    for (uint32 l = 0; l < LANES; ++l)
+        lengths[l] = M;
+
+    simd_type strings[ M ];
+    for (uint32 i = 0; i < M; ++i)
+        strings[i] = simd_type( uint8( i & 3u ) );
+
+    simd_type column[ 2*(M+1) ];
+
+    aln::BestSink<int32> sinks[LANES];
+
+    const bool ok = diff_alignment_score(
+        make_gotoh_aligner<aln::GLOBAL>( scoring ),
+        vector_view<const simd_type*>( M, strings ),
+        lengths,
+        vector_view<const simd_type*>( M, strings ),
+        lengths,
+        sinks,
+        column );
+
+    const bool band_ok = diff_banded_alignment_score<4u>(
+        make_gotoh_aligner<aln::GLOBAL>( scoring ),
+        vector_view<const simd_type*>( M, strings ),
+        lengths,
+        vector_view<const simd_type*>( M, strings ),
+        lengths,
+        sinks );
+
+    if (ok || band_ok)
+    {
+        log_error(stderr, "  difference recurrence test %s... failed: asymmetric scheme accepted\n", test);
+        exit(1);
+    }
+    fprintf(stderr, "  difference recurrence test %s... passed!\n", test);
+}
+
+// test the SIMD difference recurrence against the scalar whole-matrix scoring, aligning reads
+// with a few substitutions to the text position text_offset
+//
+template <typename simd_type, typename aligner_type>
+void diff_test(
+    const char*         test,
+    const aligner_type  aligner,
+    const uint32        text_offset,
+    const uint32        text_extra)
+{
+    const uint32 LANES    = simd_traits<simd_type>::LANES;
+    const uint32 BAND_LEN = 16u;
+    const uint32 MAX_M    = 160u;
+    const uint32 MAX_N    = MAX_M + 16u;
+
+    typedef typename column_storage_type<aligner_type>::type cell_type;
+
+    uint32 pattern_lengths[LANES];
+    uint32 text_lengths[LANES];
+
+    std::vector<uint8> str( LANES*MAX_M );
+    std::vector<uint8> ref( LANES*MAX_N );
+
+    srand( 5678 );
+    for (uint32 l = 0; l < LANES; ++l)
+    {
+        pattern_lengths[l] = 100u + (rand() % (MAX_M - 100u));
+        text_lengths[l]    = pattern_lengths[l] + text_extra;
+
+        for (uint32 k = 0; k < MAX_N; ++k)
+            ref[ l*MAX_N + k ] = uint8( rand() & 3 );
+
+        for (uint32 i = 0; i < pattern_lengths[l]; ++i)
+        {
+            const uint8 c = ref[ l*MAX_N + i + 3 ];
+            str[ l*MAX_M + i ] = ((i + l) % 17 == 0) ? uint8( (c + 1) & 3 ) : c;
+        }
+    }
+
+    // pack the problems in the SIMD lanes
+    // NOTE: the packed strings are kept on the stack, as std::vector doesn't honor the alignment of AVX2 types
+    simd_type patterns[ MAX_M ];
+    simd_type texts[ MAX_N ];
+    {
+        uint8 lanes[LANES];
+        for (uint32 i = 0; i < MAX_M; ++i)
+        {
+            for (uint32 l = 0; l < LANES; ++l)
+                lanes[l] = str[ l*MAX_M + i ];
+            patterns[i] = simd_type::load( lanes );
+        }
+        for (uint32 k = 0; k < MAX_N - text_offset; ++k)
+        {
+            for (uint32 l = 0; l < LANES; ++l)
+                lanes[l] = ref[ l*MAX_N + text_offset + k ];
+            texts[k] = simd_type::load( lanes );
+        }
+    }
+
+    // the band length selectors must treat any SIMD symbol type alike
+    if (aln::priv::sw_bandlen_selector<aln::GLOBAL,1u,simd_type>::BAND_LEN      != aln::priv::sw_bandlen_selector<aln::GLOBAL,1u,simd4u8>::BAND_LEN ||
+        aln::priv::gotoh_bandlen_selector<aln::GLOBAL,1u,simd_type>::BAND_LEN   != aln::priv::gotoh_bandlen_selector<aln::GLOBAL,1u,simd4u8>::BAND_LEN ||
+        aln::priv::hamming_bandlen_selector<aln::GLOBAL,1u,simd_type>::BAND_LEN != aln::priv::hamming_bandlen_selector<aln::GLOBAL,1u,simd4u8>::BAND_LEN)
+    {
+        log_error(stderr, "  difference recurrence test %s... failed: wrong SIMD band length\n", test);
+        exit(1);
+    }
+
+    // a SIMD sink must keep the maximum of each lane
+    {
+        aln::BestSink<simd_type> lane_sink;
+        for (uint32 i = 0; i < MAX_M; ++i)
+            lane_sink.report( patterns[i] );
+
+        uint8 lanes[LANES];
+        store_lanes( lane_sink.score, lanes );
+        for (uint32 l = 0; l < LANES; ++l)
+        {
+            uint8 best = 0;
+            for (uint32 i = 0; i < MAX_M; ++i)
+                best = nvbio::max( best, str[ l*MAX_M + i ] );
+
+            if (lanes[l] != best)
+            {
+                log_error(stderr, "  difference recurrence test %s... failed\n", test);
+                log_error(stderr, "    lane %u: expected SIMD sink score %u, got %u\n", l, uint32(best), uint32(lanes[l]));
+                exit(1);
+            }
+        }
+    }
+
+    simd_type column[ 2*(MAX_N+1) ];
+
+    aln::BestSink<int32> sinks[LANES];
+    aln::BestSink<int32> band_sinks[LANES];
+
+    const bool ok = diff_alignment_score(
+        aligner,
+        vector_view<const simd_type*>( MAX_M, patterns ),
+        pattern_lengths,
+        vector_view<const simd_type*>( MAX_N, texts ),
+        text_lengths,
+        sinks,
+        column );
+
+    const bool band_ok = diff_banded_alignment_score<BAND_LEN>(
+        aligner,
+        vector_view<const simd_type*>( MAX_M, patterns ),
+        pattern_lengths,
+        vector_view<const simd_type*>( MAX_N, texts ),
+        text_lengths,
+        band_sinks );
+
+    if (ok == false || band_ok == false)
+    {
+        log_error(stderr, "  difference recurrence test %s... failed: scheme not supported\n", test);
+        exit(1);
+    }
+
+    std::vector<cell_type> scalar_column( MAX_N );
+
+    for (uint32 l = 0; l < LANES; ++l)
+    {
+        aln::BestSink<int32> sink;
+        aln::alignment_score(
+            aligner,
+            vector_view<const uint8*>( pattern_lengths[l], &str[ l*MAX_M ] ),
+            trivial_quality_string(),
+            vector_view<const uint8*>( text_lengths[l], &ref[ l*MAX_N + text_offset ] ),
+            -10000,
+            sink,
+            &scalar_column[0] );
+
+        // the reads follow a single diagonal within the band, so that the banded score is optimal too
+        if (sinks[l].score != sink.score || sinks[l].sink.x != sink.sink.x || band_sinks[l].score != sink.score)
+        {
+            log_error(stderr, "  difference recurrence test %s... failed\n", test);
+            log_error(stderr, "    lane %u: expected score %d at %u, got %d at %u (banded: %d)\n",
+                l, sink.score, sink.sink.x, sinks[l].score, sinks[l].sink.x, band_sinks[l].score);
+            exit(1);
+        }
+    }
+    fprintf(stderr, "  difference recurrence test %s... passed!\n", test);
+}
+
 void test(int argc, char* argv[])
 {
                      uint32 n_tests          = 1;
@@ -744,6 +1609,194 @@ void test(int argc, char* argv[])
                 text,       // text
                 -2 );       // expected score
         }
+        // right extension, exact match
+        {
+            const_string   text = make_string("GGGTGCTCAA");
+            const_string pattern  = make_string("GGGTGCTCAA");
+
+            extension_test<EXTEND_RIGHT>(
+                1u,                     // test id
+                pattern,                // pattern
+                text,                   // text
+                20,                     // expected score
+                make_uint2( 10, 10 ),   // expected sink
+                20 );                   // expected end-to-end score
+        }
+        // right extension, 1 deletion
+        {
+            const_string   text = make_string("ACGTACGTACGTACGTAC");
+            const_string pattern  = make_string("ACGTAGTACGTACGTAC");
+
+            extension_test<EXTEND_RIGHT>(
+                2u,                     // test id
+                pattern,                // pattern
+                text,                   // text
+                20,                     // expected score
+                make_uint2( 18, 17 ),   // expected sink
+                20 );                   // expected end-to-end score
+        }
+        // left extension, clipped
+        {
+            const_string   text = make_string("GGGGGGGGGGACGTACGTAC");
+            const_string pattern  = make_string("TTTTTTTTTTACGTACGTAC");
+
+            extension_test<EXTEND_LEFT>(
+                3u,                     // test id
+                pattern,                // pattern
+                text,                   // text
+                20,                     // expected score
+                make_uint2( 10, 10 ),   // expected sink
+                4 );                    // expected end-to-end score
+        }
+        // linear-space traceback of a long pattern, with a few substitutions and gaps
+        {
+            const uint32 N = 400;
+
+            uint8 ref[N];
+            uint8 str[N];
+
+            srand( 1234 );
+            for (uint32 i = 0; i < N; ++i)
+                ref[i] = uint8( rand() & 3 );
+
+            uint32 M = 0;
+            for (uint32 i = 50; i < 350; ++i)
+            {
+                // a 5bp insertion
+                if (i == 120)
+                {
+                    for (uint32 k = 0; k < 5; ++k)
+                        str[M++] = uint8( rand() & 3 );
+                }
+                // a 7bp deletion
+                if (i >= 200 && i < 207)
+                    continue;
+
+                str[M++] = (i % 23 == 0) ? uint8( (ref[i] + 1) & 3 ) : ref[i];
+            }
+
+            const aln::SimpleGotohScheme scoring( 2, -3, -5, -2 );
+
+            hirschberg_test( "gotoh-global",        make_gotoh_aligner<aln::GLOBAL>( scoring ),      M, 320u, str, ref + 40 );
+            hirschberg_test( "gotoh-semi-global",   make_gotoh_aligner<aln::SEMI_GLOBAL>( scoring ), M, N,    str, ref );
+            hirschberg_test( "ed-global",           make_edit_distance_aligner<aln::GLOBAL>(),       M, 320u, str, ref + 40 );
+            hirschberg_test( "ed-semi-global",      make_edit_distance_aligner<aln::SEMI_GLOBAL>(),  M, N,    str, ref );
+        }
+        // host batched traceback of long patterns with random substitutions and gaps, using the
+        // linear-space path for the Gotoh and edit distance aligners, and the checkpointed one otherwise
+        {
+            const uint32 n_jobs = 64;
+            const uint32 M      = 320;
+            const uint32 N      = 400;
+            const uint32 N_g    = 320;
+
+            std::vector<uint8>  patterns( n_jobs * M );
+            std::vector<uint8>  texts( n_jobs * N );
+            std::vector<uint8>  global_texts( n_jobs * N_g );
+            std::vector<uint32> pattern_lengths( n_jobs );
+            std::vector<uint32> text_lengths( n_jobs, N );
+            std::vector<uint32> global_text_lengths( n_jobs, N_g );
+
+            srand( 2468 );
+            for (uint32 job = 0; job < n_jobs; ++job)
+            {
+                uint8* ref = &texts[ job * N ];
+                uint8* str = &patterns[ job * M ];
+
+                for (uint32 i = 0; i < N; ++i)
+                    ref[i] = uint8( rand() & 3 );
+
+                for (uint32 i = 0; i < N_g; ++i)
+                    global_texts[ job * N_g + i ] = ref[ 40 + i ];
+
+                uint32 m = 0;
+                for (uint32 i = 50; i < 350 && m < M; ++i)
+                {
+                    const uint32 r = rand() % 100;
+                    if (r == 0)
+                    {
+                        // a short insertion
+                        for (uint32 k = rand() % 4; k < 4 && m < M; ++k)
+                            str[m++] = uint8( rand() & 3 );
+                    }
+                    else if (r == 1)
+                    {
+                        // a short deletion
+                        i += rand() % 4;
+                        continue;
+                    }
+                    if (m < M)
+                        str[m++] = (r < 4) ? uint8( (ref[i] + 1) & 3 ) : ref[i];
+                }
+                pattern_lengths[ job ] = m;
+            }
+
+            const aln::SimpleGotohScheme gotoh( 2, -3, -5, -2 );
+            const aln::SimpleSmithWatermanScheme sw( 2, -3, -5, -4 );
+
+            batch_alignment_traceback_test( "gotoh-global",      make_gotoh_aligner<aln::GLOBAL>( gotoh ),            n_jobs, &patterns[0], &pattern_lengths[0], M, &global_texts[0], &global_text_lengths[0], N_g );
+            batch_alignment_traceback_test( "gotoh-semi-global", make_gotoh_aligner<aln::SEMI_GLOBAL>( gotoh ),       n_jobs, &patterns[0], &pattern_lengths[0], M, &texts[0],        &text_lengths[0],        N );
+            batch_alignment_traceback_test( "ed-global",         make_edit_distance_aligner<aln::GLOBAL>(),           n_jobs, &patterns[0], &pattern_lengths[0], M, &global_texts[0], &global_text_lengths[0], N_g );
+            batch_alignment_traceback_test( "ed-semi-global",    make_edit_distance_aligner<aln::SEMI_GLOBAL>(),      n_jobs, &patterns[0], &pattern_lengths[0], M, &texts[0],        &text_lengths[0],        N );
+            batch_alignment_traceback_test( "sw-semi-global",    make_smith_waterman_aligner<aln::SEMI_GLOBAL>( sw ), n_jobs, &patterns[0], &pattern_lengths[0], M, &texts[0],        &text_lengths[0],        N );
+
+            batch_alignment_score_test( "gotoh-semi-global", make_gotoh_aligner<aln::SEMI_GLOBAL>( gotoh ) );
+            batch_alignment_score_test( "ed-global",         make_edit_distance_aligner<aln::GLOBAL>() );
+        }
+        // adaptive banded alignment of a long pattern with three 4bp deletions, drifting the optimal
+        // alignment 12 diagonals away from its start, i.e. past the reach of a fixed 16-wide band
+        {
+            const uint32 N = 400;
+
+            uint8 ref[N];
+            uint8 str[N];
+
+            srand( 4321 );
+            for (uint32 i = 0; i < N; ++i)
+                ref[i] = uint8( rand() & 3 );
+
+            uint32 M = 0;
+            for (uint32 i = 50; i < 350; ++i)
+            {
+                if ((i >= 120 && i < 124) ||
+                    (i >= 200 && i < 204) ||
+                    (i >= 280 && i < 284))
+                    continue;
+
+                str[M++] = (i % 23 == 0) ? uint8( (ref[i] + 1) & 3 ) : ref[i];
+            }
+
+            const aln::SimpleGotohScheme gotoh_scoring( 2, -3, -5, -2 );
+
+            const aln::SimpleSmithWatermanScheme sw_scoring( 2, -1, -2, -2 );
+
+            adaptive_banded_test( "gotoh-global",       make_gotoh_aligner<aln::GLOBAL>( gotoh_scoring ),                 M, 300u, str, ref + 50 );
+            adaptive_banded_test( "gotoh-semi-global",  make_gotoh_aligner<aln::SEMI_GLOBAL>( gotoh_scoring ),            M, 355u, str, ref + 45 );
+            adaptive_banded_test( "gotoh-local",        make_gotoh_aligner<aln::LOCAL>( gotoh_scoring ),                  M, 355u, str, ref + 45 );
+            adaptive_banded_test( "sw-global",          make_smith_waterman_aligner<aln::GLOBAL>( sw_scoring ),           M, 300u, str, ref + 50 );
+            adaptive_banded_test( "sw-semi-global",     make_smith_waterman_aligner<aln::SEMI_GLOBAL>( sw_scoring ),      M, 355u, str, ref + 45 );
+            adaptive_banded_test( "sw-local",           make_smith_waterman_aligner<aln::LOCAL>( sw_scoring ),            M, 355u, str, ref + 45 );
+            adaptive_banded_test( "ed-global",          make_edit_distance_aligner<aln::GLOBAL>(),                        M, 300u, str, ref + 50 );
+            adaptive_banded_test( "ed-semi-global",     make_edit_distance_aligner<aln::SEMI_GLOBAL>(),                   M, 355u, str, ref + 45 );
+
+            batch_adaptive_banded_test( "gotoh-global",      make_gotoh_aligner<aln::GLOBAL>( gotoh_scoring ),            M, 300u, str, ref + 50 );
+            batch_adaptive_banded_test( "sw-semi-global",    make_smith_waterman_aligner<aln::SEMI_GLOBAL>( sw_scoring ), M, 355u, str, ref + 45 );
+            batch_adaptive_banded_test( "ed-global",         make_edit_distance_aligner<aln::GLOBAL>(),                   M, 300u, str, ref + 50 );
+        }
+        // 8-bit difference recurrence, processing many problems packed in SIMD lanes
+        {
+            const aln::SimpleGotohScheme scoring( 2, -3, -5, -2 );
+
+            diff_test<simd4u8>(  "simd4u8-global",       make_gotoh_aligner<aln::GLOBAL>( scoring ),      3u, 0u );
+            diff_test<simd4u8>(  "simd4u8-semi-global",  make_gotoh_aligner<aln::SEMI_GLOBAL>( scoring ), 0u, 8u );
+            diff_test<simd16u8>( "simd16u8-global",      make_gotoh_aligner<aln::GLOBAL>( scoring ),      3u, 0u );
+            diff_test<simd16u8>( "simd16u8-semi-global", make_gotoh_aligner<aln::SEMI_GLOBAL>( scoring ), 0u, 8u );
+            diff_test<simd32u8>( "simd32u8-global",      make_gotoh_aligner<aln::GLOBAL>( scoring ),      3u, 0u );
+            diff_test<simd32u8>( "simd32u8-semi-global", make_gotoh_aligner<aln::SEMI_GLOBAL>( scoring ), 0u, 8u );
+
+            diff_asymmetric_test<simd16u8>( "simd16u8-asymmetric-open", AsymmetricGotohScheme( 2, -3, -5, -2, -6, -2 ) );
+            diff_asymmetric_test<simd16u8>( "simd16u8-asymmetric-ext",  AsymmetricGotohScheme( 2, -3, -5, -2, -5, -1 ) );
+        }
     }
 
     if (TEST_MASK & FUNCTIONAL)
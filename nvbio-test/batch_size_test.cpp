@@ -0,0 +1,185 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// batch_size_test.cpp
+//
+
+#include <nvbio/basic/threads.h>
+#include <nvbio/basic/console.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace nvbio {
+
+namespace {
+
+// a synthetic stage cost model, t(n) = a + b * n
+//
+struct StageCost
+{
+    StageCost(const float _a, const float _b) : a( _a ), b( _b ) {}
+
+    float operator() (const uint32 n) const { return a + b * float(n); }
+
+    float a;
+    float b;
+};
+
+// run a number of producer / consumer batches through the controller, checking that the batch
+// size always stays within [min_batch, cap] and never moves by more than a factor of two per
+// update; returns the last batch size
+//
+uint32 run_batches(
+    const char*             name,
+    BatchSizeController&    controller,
+    const StageCost         producer,
+    const StageCost         consumer,
+    const float             wait,
+    const uint32            n_batches,
+    const uint32            cap)
+{
+    uint32 batch = controller.batch_size();
+
+    for (uint32 i = 0; i < n_batches; ++i)
+    {
+        controller.record( BatchSizeController::PRODUCER, batch, producer( batch ) );
+        const uint32 next_p = controller.batch_size();
+
+        controller.record_wait( wait );
+        controller.record( BatchSizeController::CONSUMER, batch, consumer( batch ) );
+        const uint32 next_c = controller.batch_size();
+
+        if (next_p < controller.min_batch_size() || next_p > cap ||
+            next_c < controller.min_batch_size() || next_c > cap)
+        {
+            log_error(stderr, "  %s: batch size %u/%u out of [%u,%u]\n", name, next_p, next_c, controller.min_batch_size(), cap);
+            exit(1);
+        }
+        if (next_p > batch * 2u || next_p < batch / 2u ||
+            next_c > next_p * 2u || next_c < next_p / 2u)
+        {
+            log_error(stderr, "  %s: batch size jumped from %u to %u and %u\n", name, batch, next_p, next_c);
+            exit(1);
+        }
+        batch = next_c;
+    }
+    return batch;
+}
+
+} // anonymous namespace
+
+int batch_size_test()
+{
+    log_info(stderr, "batch size controller test... started\n");
+
+    const uint32 MIN_BATCH = 1024u;
+    const uint32 MAX_BATCH = 64u*1024u;
+
+    // a consumer with a large per-batch overhead: the batch size must grow to max_batch
+    {
+        BatchSizeController controller( MIN_BATCH, MAX_BATCH, 2u, 8u );
+
+        if (controller.batch_size() != MIN_BATCH || controller.in_flight() != 2u)
+        {
+            log_error(stderr, "  initial batch size %u (in flight %u), expected %u (2)\n", controller.batch_size(), controller.in_flight(), MIN_BATCH);
+            exit(1);
+        }
+
+        const uint32 grown = run_batches( "grow", controller, StageCost( 0.01f, 1.0e-7f ), StageCost( 0.1f, 1.0e-6f ), 0.0f, 32u, MAX_BATCH );
+        if (grown != MAX_BATCH)
+        {
+            log_error(stderr, "  grow: batch size %u, expected %u\n", grown, MAX_BATCH);
+            exit(1);
+        }
+
+        // once the overhead vanishes, the batch size must shrink back to min_batch, even though
+        // all the recent batches had the same size
+        const uint32 shrunk = run_batches( "shrink", controller, StageCost( 1.0e-6f, 1.0e-7f ), StageCost( 1.0e-6f, 1.0e-6f ), 0.0f, 128u, MAX_BATCH );
+        if (shrunk != MIN_BATCH)
+        {
+            log_error(stderr, "  shrink: batch size %u, expected %u\n", shrunk, MIN_BATCH);
+            exit(1);
+        }
+
+        // with no starvation, the read-ahead depth must stay put
+        if (controller.in_flight() != 2u)
+        {
+            log_error(stderr, "  in flight %u, expected 2\n", controller.in_flight());
+            exit(1);
+        }
+    }
+
+    // a starving consumer: the read-ahead depth must grow up to max_in_flight, and no further
+    {
+        BatchSizeController controller( MIN_BATCH, MAX_BATCH, 2u, 8u );
+
+        run_batches( "starving", controller, StageCost( 0.001f, 1.0e-9f ), StageCost( 0.1f, 1.0e-6f ), 10.0f, 64u, MAX_BATCH );
+        if (controller.in_flight() != 8u)
+        {
+            log_error(stderr, "  starving: in flight %u, expected 8\n", controller.in_flight());
+            exit(1);
+        }
+    }
+
+    // a memory cap fitting 3 live batches of 4096 items: the batch size must be clamped
+    // to it, and the read-ahead depth must not grow past it
+    {
+        const uint32 ITEM_BYTES = 100u;
+        const uint32 MEM_BATCH  = 4096u;
+
+        BatchSizeController controller( MIN_BATCH, 1024u*1024u, 2u, 8u, 1u, uint64(3u) * MEM_BATCH * ITEM_BYTES, ITEM_BYTES );
+
+        const uint32 clamped = run_batches( "memory cap", controller, StageCost( 0.01f, 1.0e-7f ), StageCost( 0.1f, 1.0e-6f ), 10.0f, 32u, MEM_BATCH );
+        if (clamped != MEM_BATCH || controller.in_flight() != 2u)
+        {
+            log_error(stderr, "  memory cap: batch size %u (in flight %u), expected %u (2)\n", clamped, controller.in_flight(), MEM_BATCH);
+            exit(1);
+        }
+    }
+
+    // inconsistent constructor arguments must be clamped
+    {
+        BatchSizeController controller( 4096u, 1024u, 16u, 4u );
+
+        if (controller.min_batch_size() != 1024u ||
+            controller.max_batch_size() != 1024u ||
+            controller.batch_size()     != 1024u ||
+            controller.in_flight()      != 4u)
+        {
+            log_error(stderr, "  clamped arguments: batch size in [%u,%u], %u, in flight %u\n",
+                controller.min_batch_size(), controller.max_batch_size(), controller.batch_size(), controller.in_flight());
+            exit(1);
+        }
+
+        run_batches( "fixed", controller, StageCost( 0.01f, 1.0e-7f ), StageCost( 0.1f, 1.0e-6f ), 0.0f, 16u, 1024u );
+    }
+
+    log_info(stderr, "batch size controller test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
@@ -36,9 +36,27 @@
 #include <nvbio/basic/dna.h>
 #include <nvbio/basic/packedstream.h>
 #include <nvbio/fmindex/bwt.h>
+#include <nvbio/sufsort/lcp.h>
 
 using namespace nvbio;
 
+namespace {
+
+// a virtual string made of pairs of equal symbols, 0 0 1 1 2 2 ..., whose suffix array
+// is the identity and whose LCP array is LCP[i] = i & 1
+struct pairs_string
+{
+    uint32 operator[] (const uint64 i) const { return uint32( i >> 1 ); }
+};
+
+// the identity suffix array
+struct identity_sa
+{
+    uint32 operator[] (const uint64 i) const { return uint32( i ); }
+};
+
+} // anonymous namespace
+
 int bwt_test()
 {
     fprintf(stderr, "bwt test... started\n");
@@ -77,6 +95,99 @@ int bwt_test()
     timer.stop();
     fprintf(stderr, "  construction... done: %um:%us\n", uint32(timer.seconds()/60), uint32(timer.seconds())%60);
 
+    // test the LCP construction on a smaller string with long repeats
+    {
+        fprintf(stderr, "  lcp construction... started\n");
+
+        const uint32 LCP_LEN = 1000000;
+
+        // plant copies of the string prefix along the string
+        for (uint32 i = 50000; i + 20000 < LCP_LEN; i += 100000)
+        {
+            for (uint32 j = 0; j < 20000; ++j)
+                stream[i + j] = stream[j];
+        }
+
+        std::vector<int32>  sa( LCP_LEN+1 );
+        std::vector<uint32> lcp( LCP_LEN );
+        std::vector<uint32> lcp_block( LCP_LEN );
+
+        gen_sa( LCP_LEN, stream.begin(), &sa[0] );
+
+        const int32* h_sa = &sa[1];    // skip the padding
+
+        timer.start();
+
+        nvbio::lcp( LCP_LEN, stream, h_sa, &lcp[0] );
+
+        timer.stop();
+        fprintf(stderr, "  lcp construction... done: %.2fs\n", timer.seconds());
+
+        // check the result against a plain comparison of adjacent suffixes
+        for (uint32 i = 1; i < LCP_LEN; ++i)
+        {
+            const uint32 a = h_sa[i-1];
+            const uint32 b = h_sa[i];
+
+            uint32 l = 0;
+            while (a + l < LCP_LEN && b + l < LCP_LEN && stream[a + l] == stream[b + l])
+                ++l;
+
+            if (lcp[i] != l)
+            {
+                fprintf(stderr, "  error: lcp[%u] = %u, expected %u\n", i, lcp[i], l);
+                exit(1);
+            }
+        }
+
+        // and check the block-wise, sampled construction against the full one
+        SampledPLCP sampled_plcp;
+        sampled_plcp.build( LCP_LEN, stream, h_sa, 16u );
+
+        const uint32 BLOCK_SIZE = 100000;
+        for (uint32 block_begin = 0; block_begin < LCP_LEN; block_begin += BLOCK_SIZE)
+        {
+            const uint32 block_end = nvbio::min( block_begin + BLOCK_SIZE, LCP_LEN );
+
+            sampled_plcp.lcp( LCP_LEN, stream, h_sa, block_begin, block_end, &lcp_block[ block_begin ] );
+        }
+
+        for (uint32 i = 0; i < LCP_LEN; ++i)
+        {
+            if (lcp_block[i] != lcp[i])
+            {
+                fprintf(stderr, "  error: sampled lcp[%u] = %u, expected %u\n", i, lcp_block[i], lcp[i]);
+                exit(1);
+            }
+        }
+
+        // check that the loop indices don't wrap around on strings longer than INT_MAX,
+        // computing a block straddling 2^31 of a virtual string with all-zero PLCP samples
+        {
+            const uint32 BIG_LEN      = (1u << 31) + 1024u;
+            const uint32 BIG_SAMPLING = 1u << 20;
+            const uint32 BIG_BLOCK    = 64u;
+            const uint32 big_begin    = (1u << 31) - BIG_BLOCK/2;
+
+            SampledPLCP big_plcp;
+            big_plcp.m_sampling = BIG_SAMPLING;
+            big_plcp.m_plcp.resize( util::divide_ri( BIG_LEN, BIG_SAMPLING ), 0u );
+
+            std::vector<uint32> big_lcp( BIG_BLOCK, uint32(-1) );
+
+            big_plcp.lcp( BIG_LEN, pairs_string(), identity_sa(), big_begin, big_begin + BIG_BLOCK, &big_lcp[0] );
+
+            for (uint32 i = 0; i < BIG_BLOCK; ++i)
+            {
+                if (big_lcp[i] != ((big_begin + i) & 1u))
+                {
+                    fprintf(stderr, "  error: sampled lcp[%u] = %u, expected %u\n", big_begin + i, big_lcp[i], (big_begin + i) & 1u);
+                    exit(1);
+                }
+            }
+        }
+    }
+
     fprintf(stderr, "bwt test... done\n");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+// bwte_append_test.cu
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/basic/console.h>
+#include <nvbio/basic/dna.h>
+#include <nvbio/basic/shared_pointer.h>
+#include <nvbio/fmindex/paged_text.h>
+#include <nvbio/sufsort/bwte.h>
+#include <nvbio/sufsort/file_bwt.h>
+#include <nvbio/io/sequence/sequence.h>
+#include <nvbio/io/sequence/sequence_access.h>
+#include <nvbio/io/sequence/sequence_encoder.h>
+
+namespace nvbio {
+
+namespace {
+
+typedef io::SequenceDataAccess<DNA>::sequence_storage_iterator  storage_iterator;
+typedef io::SequenceDataAccess<DNA>::index_iterator             offsets_iterator;
+
+typedef BWTEContext<2u,true,storage_iterator,offsets_iterator>  bwte_context_type;
+typedef PagedText<2u,true>                                      paged_text_type;
+
+// encode a set of random reads
+//
+void encode_reads(const uint32 n_reads, io::SequenceDataHost* reads)
+{
+    const uint32 MIN_LEN = 50;
+    const uint32 MAX_LEN = 150;
+
+    std::vector<uint8> bps( MAX_LEN );
+    std::vector<uint8> quals( MAX_LEN, uint8('~') );
+
+    SharedPointer<io::SequenceDataEncoder> encoder( io::create_encoder( DNA, reads ) );
+    encoder->begin_batch();
+    for (uint32 i = 0; i < n_reads; ++i)
+    {
+        const uint32 len = MIN_LEN + uint32( rand() ) % (MAX_LEN - MIN_LEN);
+        for (uint32 j = 0; j < len; ++j)
+            bps[j] = uint8( dna_to_char( uint8( rand() & 3 ) ) );
+
+        encoder->push_back(
+            len,
+            "read",
+            &bps[0],
+            &quals[0],
+            io::Phred33,
+            uint32(-1),
+            0u,
+            0u,
+            io::SequenceDataEncoder::NO_OP );
+    }
+    encoder->end_batch();
+}
+
+// merge a batch of reads into a BWT, turning their block-local string ids into global ones as nvSetBWT does
+//
+void merge_reads(
+    bwte_context_type&          context,
+    const io::SequenceDataHost& reads,
+    paged_text_type&            bwt,
+    SparseSymbolSet&            dollars)
+{
+    const io::SequenceDataAccess<DNA> reads_view( reads );
+
+    BWTEBlock block;
+    context.sort_block(
+        0u,
+        reads.size(),
+        reads_view.sequence_string_set(),
+        block );
+
+    block.offset_dollar_ids( dollars.size() );
+
+    context.merge_block(
+        0u,
+        reads.size(),
+        reads_view.sequence_string_set(),
+        block,
+        bwt,
+        dollars,
+        true );
+}
+
+// write a BWT to disk, as nvSetBWT does
+//
+void write_bwt(const char* name, const paged_text_type& bwt, const SparseSymbolSet& dollars)
+{
+    SetBWTHandler* handler = open_bwt_file( name, "" );
+    if (handler == NULL)
+    {
+        log_error(stderr, "  unable to open \"%s\"\n", name);
+        exit(1);
+    }
+
+    output_bwt( bwt, dollars, *handler );
+
+    delete handler;
+}
+
+// check that two string-set BWTs are identical, dollar positions and ids included
+//
+void check_bwt(
+    const char*             name,
+    const paged_text_type&  bwt,
+    const SparseSymbolSet&  dollars,
+    const paged_text_type&  ref_bwt,
+    const SparseSymbolSet&  ref_dollars)
+{
+    if (bwt.size() != ref_bwt.size() || dollars.size() != ref_dollars.size())
+    {
+        log_error(stderr, "  %s: expected %llu symbols and %u dollars, got %llu and %u\n",
+            name, ref_bwt.size(), ref_dollars.size(), bwt.size(), dollars.size());
+        exit(1);
+    }
+    for (uint64 i = 0; i < bwt.size(); ++i)
+    {
+        if (bwt[i] != ref_bwt[i])
+        {
+            log_error(stderr, "  %s: mismatching symbol at %llu: expected %u, got %u\n", name, i, ref_bwt[i], bwt[i]);
+            exit(1);
+        }
+    }
+    for (uint32 i = 0; i < dollars.size(); ++i)
+    {
+        if (dollars.pos()[i] != ref_dollars.pos()[i] ||
+            dollars.ids()[i] != ref_dollars.ids()[i])
+        {
+            log_error(stderr, "  %s: mismatching dollar %u: expected (%llu,%llu), got (%llu,%llu)\n", name, i,
+                ref_dollars.pos()[i], ref_dollars.ids()[i], dollars.pos()[i], dollars.ids()[i]);
+            exit(1);
+        }
+    }
+}
+
+} // anonymous namespace
+
+int bwte_append_test()
+{
+    log_info(stderr, "bwte append test... started\n");
+
+    const char* bwt_name     = "./bwte_append_test.bwt";
+    const char* pri_name     = "./bwte_append_test.pri";
+    const char* out_bwt_name = "./bwte_append_test_out.bwt";
+    const char* out_pri_name = "./bwte_append_test_out.pri";
+
+    srand( 19 );
+
+    // the first set is built in two batches, so as to give it global ids already
+    io::SequenceDataHost reads[3];
+    encode_reads( 300, &reads[0] );
+    encode_reads( 200, &reads[1] );
+    encode_reads( 250, &reads[2] );
+
+    const uint32 n_strings = reads[0].size() + reads[1].size() + reads[2].size();
+
+    int device;
+    cudaGetDevice( &device );
+
+    bwte_context_type context( device );
+    context.reserve( 1024u, 1024u*1024u );
+
+    // build the BWT of the union in a single run
+    paged_text_type ref_bwt;
+    SparseSymbolSet ref_dollars;
+    for (uint32 i = 0; i < 3; ++i)
+        merge_reads( context, reads[i], ref_bwt, ref_dollars );
+
+    // every string must be assigned a distinct global id
+    {
+        std::vector<uint32> id_count( n_strings, 0u );
+        for (uint32 i = 0; i < ref_dollars.size(); ++i)
+        {
+            const uint64 id = ref_dollars.ids()[i];
+            if (id >= n_strings || id_count[ id ]++)
+            {
+                log_error(stderr, "  dollar %u: invalid or duplicate string id %llu\n", i, id);
+                exit(1);
+            }
+        }
+        if (ref_dollars.size() != n_strings)
+        {
+            log_error(stderr, "  expected %u dollars, got %u\n", n_strings, ref_dollars.size());
+            exit(1);
+        }
+    }
+
+    // build the BWT of the first set, and write it to disk
+    {
+        paged_text_type bwt;
+        SparseSymbolSet dollars;
+        for (uint32 i = 0; i < 2; ++i)
+            merge_reads( context, reads[i], bwt, dollars );
+
+        write_bwt( bwt_name, bwt, dollars );
+
+        // check it loads back as is
+        paged_text_type loaded_bwt;
+        SparseSymbolSet loaded_dollars;
+        if (load_bwt_file( bwt_name, loaded_bwt, loaded_dollars ) == false)
+        {
+            log_error(stderr, "  failed loading \"%s\"\n", bwt_name);
+            exit(1);
+        }
+        check_bwt( "round-trip", loaded_bwt, loaded_dollars, bwt, dollars );
+    }
+
+    // load it back, append the second set, and compare with the single run
+    {
+        paged_text_type bwt;
+        SparseSymbolSet dollars;
+        if (load_bwt_file( bwt_name, bwt, dollars ) == false)
+        {
+            log_error(stderr, "  failed loading \"%s\"\n", bwt_name);
+            exit(1);
+        }
+
+        merge_reads( context, reads[2], bwt, dollars );
+
+        check_bwt( "append", bwt, dollars, ref_bwt, ref_dollars );
+
+        // and check the appended BWT survives being written out and loaded back
+        write_bwt( out_bwt_name, bwt, dollars );
+
+        paged_text_type out_bwt;
+        SparseSymbolSet out_dollars;
+        if (load_bwt_file( out_bwt_name, out_bwt, out_dollars ) == false)
+        {
+            log_error(stderr, "  failed loading \"%s\"\n", out_bwt_name);
+            exit(1);
+        }
+        check_bwt( "append round-trip", out_bwt, out_dollars, ref_bwt, ref_dollars );
+    }
+
+    // an index without the (length,-1) terminator, as written by older versions, must be rejected
+    {
+        std::vector<uint8> index;
+        {
+            FILE* file = fopen( pri_name, "rb" );
+            if (file == NULL)
+            {
+                log_error(stderr, "  unable to open \"%s\"\n", pri_name);
+                exit(1);
+            }
+            uint8 buffer[4096];
+            for (size_t n; (n = fread( buffer, 1u, sizeof(buffer), file )) > 0;)
+                index.insert( index.end(), buffer, buffer + n );
+
+            fclose( file );
+        }
+        {
+            FILE* file = fopen( pri_name, "wb" );
+            if (file == NULL)
+            {
+                log_error(stderr, "  unable to create \"%s\"\n", pri_name);
+                exit(1);
+            }
+            fwrite( &index[0], 1u, index.size() - 2u*sizeof(uint64), file );
+            fclose( file );
+        }
+
+        paged_text_type bwt;
+        SparseSymbolSet dollars;
+        if (load_bwt_file( bwt_name, bwt, dollars ))
+        {
+            log_error(stderr, "  expected \"%s\" to be rejected without a terminator\n", pri_name);
+            exit(1);
+        }
+    }
+
+    remove( bwt_name );
+    remove( pri_name );
+    remove( out_bwt_name );
+    remove( out_pri_name );
+
+    log_info(stderr, "bwte append test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
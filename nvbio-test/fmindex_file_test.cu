@@ -0,0 +1,434 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+// fmindex_file_test.cu
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/basic/console.h>
+#include <nvbio/basic/exceptions.h>
+#include <nvbio/basic/packedstream.h>
+#include <nvbio/fmindex/rank_dictionary.h>
+#include <nvbio/fmindex/fmindex.h>
+#include <nvbio/fmindex/bwt.h>
+#include <nvbio/sufsort/file_bwt.h>
+
+namespace nvbio {
+
+namespace {
+
+// build the BWT of a single random string in memory, write it out with its occurrence table
+// as a one-dollar string-set BWT, and check that the loaded FM-index answers rank and match
+// queries just like the in-memory one
+//
+void fmindex_file_query_test()
+{
+    const uint32 OCC_INT    = 64;
+    const uint32 LEN        = 20*1000 + 11;
+    const uint32 N_QUERIES  = 2000;
+
+    const char* bwt_name = "./fmindex_file_query_test.bwt";
+    const char* pri_name = "./fmindex_file_query_test.pri";
+    const char* occ_name = "./fmindex_file_query_test.occ";
+
+    typedef PackedStream<uint32*,uint8,2,true>                                  stream_type;
+    typedef PackedStream<const uint32*,uint8,2,true>                            bwt_type;
+    typedef rank_dictionary<2u, OCC_INT, bwt_type, const uint32*, const uint32*> rank_dict_type;
+    typedef fm_index<rank_dict_type, null_type>                                 ref_fm_index_type;
+    typedef SetBWTFMIndex::fm_index_type                                        fm_index_type;
+
+    const uint32 WORDS = util::divide_ri( LEN, 16u );
+
+    std::vector<uint32> text_words( align<4>( WORDS ), 0u );
+    std::vector<uint32> bwt_words( align<4>( WORDS ), 0u );
+    std::vector<uint32> occ( util::divide_ri( LEN, OCC_INT ) * 4u );
+    std::vector<uint32> L2( 5 );
+    std::vector<uint32> count_table( 256 );
+
+    stream_type text( &text_words[0] );
+    for (uint32 i = 0; i < LEN; ++i)
+        text[i] = uint8( rand() & 3 );
+
+    // build the in-memory FM-index
+    std::vector<int32> sa( LEN+1 );
+    gen_sa( LEN, text, &sa[0] );
+
+    stream_type bwt( &bwt_words[0] );
+    const uint32 primary = gen_bwt_from_sa( LEN, text, &sa[0], bwt );
+
+    build_occurrence_table<2u,OCC_INT>( bwt, bwt + LEN, &occ[0], &L2[1] );
+
+    L2[0] = 0;
+    for (uint32 c = 0; c < 4; ++c)
+        L2[c+1] += L2[c];
+
+    gen_bwt_count_table( &count_table[0] );
+
+    const ref_fm_index_type ref_fmi(
+        LEN,
+        primary,
+        &L2[0],
+        rank_dict_type(
+            bwt_type( &bwt_words[0] ),
+            &occ[0],
+            &count_table[0] ),
+        null_type() );
+
+    // stream out the BWT with the dollar at the primary position, in two batches
+    {
+        SetBWTHandler* handler = open_fmindex_file( bwt_name, "", OCC_INT );
+        if (handler == NULL)
+        {
+            log_error(stderr, "  unable to open \"%s\"\n", bwt_name);
+            exit(1);
+        }
+
+        std::vector<uint8> bytes( LEN+1 );
+        for (uint32 i = 0; i <= LEN; ++i)
+            bytes[i] = i < primary ? uint8( bwt[i] ) : i == primary ? uint8(255u) : uint8( bwt[i-1] );
+
+        const uint64 dollar_pos = primary;
+        const uint64 dollar_id  = 0;
+
+        const uint32 split = LEN / 3;
+        if (primary < split)
+        {
+            handler->process( split,           &bytes[0],     1u, &dollar_pos, &dollar_id );
+            handler->process( LEN+1u - split,  &bytes[split], 0u, NULL,        NULL );
+        }
+        else
+        {
+            handler->process( split,           &bytes[0],     0u, NULL,        NULL );
+            handler->process( LEN+1u - split,  &bytes[split], 1u, &dollar_pos, &dollar_id );
+        }
+        delete handler;
+    }
+
+    SetBWTFMIndex set_index;
+    if (load_fmindex_file( bwt_name, set_index ) == false)
+    {
+        log_error(stderr, "  unable to load \"%s\"\n", bwt_name);
+        exit(1);
+    }
+    if (set_index.length() != LEN+1u || set_index.n_dollars() != 1u)
+    {
+        log_error(stderr, "  expected %u symbols and 1 dollar, got %llu and %llu\n", LEN+1u, set_index.length(), set_index.n_dollars());
+        exit(1);
+    }
+
+    const fm_index_type fmi = set_index.index();
+
+    // check all ranks, past the ends included
+    for (uint32 c = 0; c < 4; ++c)
+    {
+        for (uint32 k = 0; k <= LEN+1u; ++k)
+        {
+            const uint64 i = uint64(k) - 1u;
+            const uint64 r = rank( fmi, i, uint8(c) );
+            const uint64 ref_r = rank( ref_fmi, uint32(i), uint8(c) );
+            if (r != ref_r)
+            {
+                log_error(stderr, "  rank(%lld,%u): expected %llu, got %llu\n", int64(i), c, ref_r, r);
+                exit(1);
+            }
+        }
+    }
+
+    // and match both substrings of the text and random patterns
+    for (uint32 q = 0; q < N_QUERIES; ++q)
+    {
+        const uint32 len = 1u + uint32( rand() ) % 16u;
+
+        uint8 pattern[16];
+        if (q & 1)
+        {
+            const uint32 pos = uint32( rand() ) % (LEN - len);
+            for (uint32 i = 0; i < len; ++i)
+                pattern[i] = text[pos + i];
+        }
+        else
+        {
+            for (uint32 i = 0; i < len; ++i)
+                pattern[i] = uint8( rand() & 3 );
+        }
+
+        const uint64_2 range  = match( fmi,     pattern, len );
+        const uint2    ref    = match( ref_fmi, pattern, len );
+
+        const bool found     = range.x <= range.y;
+        const bool ref_found = ref.x   <= ref.y;
+
+        if (found != ref_found || (found && (range.x != ref.x || range.y != ref.y)))
+        {
+            log_error(stderr, "  match(%u): expected [%u,%u], got [%llu,%llu]\n", q, ref.x, ref.y, range.x, range.y);
+            exit(1);
+        }
+        if ((q & 1) && found == false)
+        {
+            log_error(stderr, "  match(%u): substring of the text not found\n", q);
+            exit(1);
+        }
+    }
+
+    remove( bwt_name );
+    remove( pri_name );
+    remove( occ_name );
+}
+
+} // anonymous namespace
+
+int fmindex_file_test()
+{
+    log_info(stderr, "fmindex file test... started\n");
+
+    const uint32 OCC_INT    = 64;
+    const uint32 N          = 50*1000 + 37;
+    const uint32 N_DOLLARS  = 500;
+    const uint32 MAX_BATCH  = 5000;
+
+    const char* bwt_name = "./fmindex_file_test.bwt";
+    const char* pri_name = "./fmindex_file_test.pri";
+    const char* occ_name = "./fmindex_file_test.occ";
+
+    // build a random BWT with a set of sorted dollars
+    std::vector<uint8>  symbols( N );
+    std::vector<uint64> dollar_pos;
+    std::vector<uint64> dollar_ids;
+
+    srand( 17 );
+    for (uint32 i = 0; i < N; ++i)
+        symbols[i] = uint8( rand() & 3 );
+
+    for (uint32 i = 0; i < N; ++i)
+    {
+        if (uint32( rand() ) % (N / N_DOLLARS) == 0)
+        {
+            dollar_pos.push_back( i );
+            dollar_ids.push_back( dollar_ids.size() );
+        }
+    }
+    const uint32 n_dollars = uint32( dollar_pos.size() );
+
+    // stream it out in batches of random size, alternating packed and byte batches
+    {
+        SetBWTHandler* handler = open_fmindex_file( bwt_name, "", OCC_INT );
+        if (handler == NULL)
+        {
+            log_error(stderr, "  unable to open \"%s\"\n", bwt_name);
+            exit(1);
+        }
+
+        uint32 d = 0;
+        for (uint32 begin = 0, batch = 0; begin < N; ++batch)
+        {
+            const uint32 end = nvbio::min( begin + 1u + uint32( rand() ) % MAX_BATCH, N );
+
+            const uint32 d_begin = d;
+            while (d < n_dollars && dollar_pos[d] < end)
+                ++d;
+
+            if (batch & 1)
+            {
+                // packed batches store the dollars as regular symbols
+                std::vector<uint32> words( util::divide_ri( end - begin, 16u ), 0u );
+
+                PackedStream<uint32*,uint8,2,true> stream( &words[0] );
+                for (uint32 i = begin; i < end; ++i)
+                    stream[i - begin] = symbols[i];
+
+                handler->process( end - begin, 2u, &words[0], d - d_begin, &dollar_pos[0] + d_begin, &dollar_ids[0] + d_begin );
+            }
+            else
+            {
+                // byte batches mark the dollars with 255
+                std::vector<uint8> bytes( symbols.begin() + begin, symbols.begin() + end );
+                for (uint32 j = d_begin; j < d; ++j)
+                    bytes[ dollar_pos[j] - begin ] = 255u;
+
+                handler->process( end - begin, &bytes[0], d - d_begin, &dollar_pos[0] + d_begin, &dollar_ids[0] + d_begin );
+            }
+            begin = end;
+        }
+
+        delete handler;
+    }
+
+    // build the same occurrence table in memory
+    const uint32 n_samples = util::divide_ri( N, OCC_INT );
+
+    std::vector<uint64> ref_occ( n_samples * 4 );
+    uint64              ref_cnt[4];
+
+    build_occurrence_table<2u,OCC_INT>( symbols.begin(), symbols.end(), &ref_occ[0], ref_cnt );
+
+    // and remove the dollars, which the streamed table doesn't count
+    for (uint32 j = 0; j < n_dollars; ++j)
+    {
+        const uint8 c = symbols[ dollar_pos[j] ];
+        for (uint32 k = uint32( dollar_pos[j] / OCC_INT ) + 1u; k < n_samples; ++k)
+            --ref_occ[ k*4 + c ];
+
+        --ref_cnt[c];
+    }
+
+    // read back the streamed table
+    {
+        FILE* file = fopen( occ_name, "rb" );
+        if (file == NULL)
+        {
+            log_error(stderr, "  unable to open \"%s\"\n", occ_name);
+            exit(1);
+        }
+
+        char   magic[4];
+        uint32 occ_intv;
+        uint64 header[2 + 4 + 5];
+        std::vector<uint64> occ( n_samples * 4 + 1 );
+
+        const bool ok =
+            fread( magic,     sizeof(char),   4,                 file ) == 4 &&
+            fread( &occ_intv, sizeof(uint32), 1,                 file ) == 1 &&
+            fread( header,    sizeof(uint64), sizeof(header)/8u, file ) == sizeof(header)/8u &&
+            fread( &occ[0],   sizeof(uint64), occ.size(),        file ) == n_samples * 4;
+
+        fclose( file );
+
+        if (ok == false || strncmp( magic, "OCCB", 4 ) != 0 || occ_intv != OCC_INT)
+        {
+            log_error(stderr, "  malformed occurrence table file \"%s\"\n", occ_name);
+            exit(1);
+        }
+        if (header[0] != N || header[1] != n_dollars)
+        {
+            log_error(stderr, "  expected %u symbols and %u dollars, got %llu and %llu\n", N, n_dollars, header[0], header[1]);
+            exit(1);
+        }
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            if (header[2 + c] != ref_cnt[c])
+            {
+                log_error(stderr, "  symbol %u: expected a count of %llu, got %llu\n", c, ref_cnt[c], header[2 + c]);
+                exit(1);
+            }
+        }
+
+        uint64 L2 = n_dollars;
+        for (uint32 c = 0; c <= 4; ++c)
+        {
+            if (header[6 + c] != L2)
+            {
+                log_error(stderr, "  L2[%u]: expected %llu, got %llu\n", c, L2, header[6 + c]);
+                exit(1);
+            }
+            L2 += c < 4 ? ref_cnt[c] : 0u;
+        }
+
+        for (uint32 k = 0; k < n_samples * 4; ++k)
+        {
+            if (occ[k] != ref_occ[k])
+            {
+                log_error(stderr, "  occ[%u][%u]: expected %llu, got %llu\n", k / 4, k % 4, ref_occ[k], occ[k]);
+                exit(1);
+            }
+        }
+    }
+
+    // load the streamed table back as an FM-index, and check its ranks skip the dollars
+    {
+        SetBWTFMIndex set_index;
+        if (load_fmindex_file( bwt_name, set_index ) == false)
+        {
+            log_error(stderr, "  unable to load \"%s\"\n", bwt_name);
+            exit(1);
+        }
+        const SetBWTFMIndex::fm_index_type fmi = set_index.index();
+
+        uint64 cnt[4] = { 0 };
+        for (uint32 i = 0, d = 0; i < N; ++i)
+        {
+            if (d < n_dollars && dollar_pos[d] == i)
+                ++d;
+            else
+                ++cnt[ symbols[i] ];
+
+            for (uint32 c = 0; c < 4; ++c)
+            {
+                const uint64 r = rank( fmi, uint64(i), uint8(c) );
+                if (r != cnt[c])
+                {
+                    log_error(stderr, "  rank(%u,%u): expected %llu, got %llu\n", i, c, cnt[c], r);
+                    exit(1);
+                }
+            }
+        }
+    }
+
+    // check that anything but 2-bit DNA is rejected
+    {
+        SetBWTHandler* handler = open_fmindex_file( bwt_name, "", OCC_INT );
+        if (handler == NULL)
+        {
+            log_error(stderr, "  unable to open \"%s\"\n", bwt_name);
+            exit(1);
+        }
+
+        uint32 words[4] = { 0u };
+        uint8  bytes[16] = { 0u };
+        bytes[5] = 4u;
+
+        bool rejected_packed = false;
+        try { handler->process( 8u, 4u, words, 0u, NULL, NULL ); }
+        catch (runtime_error&) { rejected_packed = true; }
+
+        bool rejected_bytes = false;
+        try { handler->process( 16u, bytes, 0u, NULL, NULL ); }
+        catch (runtime_error&) { rejected_bytes = true; }
+
+        delete handler;
+
+        if (rejected_packed == false || rejected_bytes == false)
+        {
+            log_error(stderr, "  expected 4-bit and out of alphabet input to be rejected\n");
+            exit(1);
+        }
+    }
+
+    remove( bwt_name );
+    remove( pri_name );
+    remove( occ_name );
+
+    fmindex_file_query_test();
+
+    log_info(stderr, "fmindex file test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
@@ -0,0 +1,333 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+// fmmap_test.cu
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/console.h>
+#include <nvbio/basic/dna.h>
+#include <nvbio/basic/packedstream.h>
+#include <nvbio/basic/pipeline.h>
+#include <nvbio/basic/shared_pointer.h>
+#include <nvbio/fmindex/bwt.h>
+#include <nvbio/fmindex/ssa.h>
+#include <nvbio/fmindex/fmindex.h>
+#include <nvbio/fmindex/fmmap.h>
+#include <nvbio/io/sequence/sequence.h>
+#include <nvbio/io/sequence/sequence_encoder.h>
+
+namespace nvbio {
+
+namespace {
+
+// a pipeline sink scattering the best scores of each read batch to a global vector
+//
+struct FMMapTestSink
+{
+    typedef FMMapResults argument_type;
+
+    FMMapTestSink(std::vector<int16>& scores) : m_scores( &scores ), n_batches( 0 ), n_hit_batches( 0 ) {}
+
+    bool process(PipelineContext& context)
+    {
+        const FMMapResults* results = context.input<FMMapResults>( 0 );
+
+        const uint32 n_reads = uint32( results->best_scores.size() );
+        for (uint32 i = 0; i < n_reads; ++i)
+            (*m_scores)[ results->read_offset + i ] = results->best_scores[i];
+
+        n_batches     += n_reads ? 1u : 0u;
+        n_hit_batches += 1u;
+        return true;
+    }
+
+    std::vector<int16>* m_scores;
+    uint32              n_batches;
+    uint32              n_hit_batches;
+};
+
+} // anonymous namespace
+
+int fmmap_test(int argc, char* argv[])
+{
+    log_info(stderr, "fmmap test... started\n");
+
+    // a seed matching near the beginning of the genome must not wrap its diagonal around
+    {
+        const string_set_infix_coord_type seeds[2] = {
+            make_uint4( 7u, 40u, 56u, 0u ),
+            make_uint4( 9u,  2u, 18u, 0u ) };
+
+        const priv::fmmap_hit_to_diagonal hit_to_diagonal( seeds );
+
+        const uint2 clamped = hit_to_diagonal( make_uint2( 3u, 0u ) );
+        const uint2 regular = hit_to_diagonal( make_uint2( 3u, 1u ) );
+        if (clamped.x != 0u || clamped.y != 7u ||
+            regular.x != 1u || regular.y != 9u)
+        {
+            log_error(stderr, "  wrong hit diagonals: (%u,%u), (%u,%u)\n", clamped.x, clamped.y, regular.x, regular.y);
+            exit(1);
+        }
+    }
+
+    const uint32 GENOME_LEN  = 16*1024;
+    const uint32 N_READS     = 200;
+    const uint32 READ_LEN    = 60;
+    const uint32 REPEAT_LEN  = 200;
+    const uint32 N_REPEATS   = 8;
+    const uint32 OCC_INT     = 64;
+    const uint32 SA_INT      = 32;
+
+    const char* reads_name = "./fmmap_test.txt";
+
+    // build a random genome with a few copies of the same segment, so as to get multiple hits
+    std::vector<uint8> genome( GENOME_LEN );
+
+    srand( 11 );
+    for (uint32 i = 0; i < GENOME_LEN; ++i)
+        genome[i] = uint8( rand() & 3 );
+
+    for (uint32 r = 1; r <= N_REPEATS; ++r)
+    {
+        for (uint32 i = 0; i < REPEAT_LEN; ++i)
+            genome[ r * (GENOME_LEN / (N_REPEATS+1)) + i ] = genome[i];
+    }
+
+    // pack it
+    const uint32 WORDS     = util::divide_ri( GENOME_LEN, 16u );
+    const uint32 OCC_WORDS = util::divide_ri( GENOME_LEN, OCC_INT ) * 4;
+
+    std::vector<uint32> text_words( align<4>( WORDS ), 0u );
+    std::vector<uint32> bwt_words( align<4>( WORDS ), 0u );
+    std::vector<uint32> occ( align<4>( OCC_WORDS ), 0u );
+    std::vector<uint32> L2( 5, 0u );
+    std::vector<uint32> count_table( 256 );
+
+    typedef PackedStream<uint32*,uint8,2,true,uint32> stream_type;
+    stream_type text( &text_words[0] );
+    for (uint32 i = 0; i < GENOME_LEN; ++i)
+        text[i] = genome[i];
+
+    // build its FM-index
+    std::vector<int32> sa( GENOME_LEN+1 );
+    gen_sa( GENOME_LEN, text, &sa[0] );
+
+    stream_type bwt( &bwt_words[0] );
+    const uint32 primary = gen_bwt_from_sa( GENOME_LEN, text, &sa[0], bwt );
+
+    build_occurrence_table<2u,OCC_INT>(
+        bwt,
+        bwt + GENOME_LEN,
+        &occ[0],
+        &L2[1] );
+
+    for (uint32 c = 0; c < 4; ++c)
+        L2[c+1] += L2[c];
+
+    gen_bwt_count_table( &count_table[0] );
+
+    typedef PackedStream<const uint32*,uint8,2u,true,uint32>                        bwt_type;
+    typedef rank_dictionary<2u, OCC_INT, bwt_type, const uint32*, const uint32*>    rank_dict_type;
+    typedef fm_index<rank_dict_type, null_type>                                     temp_fm_index_type;
+    typedef SSA_index_multiple<SA_INT,uint32>                                       ssa_type;
+    typedef fm_index<rank_dict_type, ssa_type::context_type>                        fm_index_type;
+
+    const bwt_type bwt_stream( &bwt_words[0] );
+    const rank_dict_type rank_dict(
+        bwt_stream,
+        &occ[0],
+        &count_table[0] );
+
+    const temp_fm_index_type temp_fmi( GENOME_LEN, primary, &L2[0], rank_dict, null_type() );
+
+    const ssa_type ssa( temp_fmi );
+
+    const fm_index_type fmi( GENOME_LEN, primary, &L2[0], rank_dict, ssa.get_context() );
+
+    // encode the genome as sequence data
+    io::SequenceDataHost genome_data;
+    {
+        std::vector<uint8> genome_bps( GENOME_LEN );
+        std::vector<uint8> genome_quals( GENOME_LEN, uint8('~') );
+        for (uint32 i = 0; i < GENOME_LEN; ++i)
+            genome_bps[i] = uint8( dna_to_char( genome[i] ) );
+
+        SharedPointer<io::SequenceDataEncoder> encoder( io::create_encoder( DNA, &genome_data ) );
+        encoder->begin_batch();
+        encoder->push_back(
+            GENOME_LEN,
+            "genome",
+            &genome_bps[0],
+            &genome_quals[0],
+            io::Phred33,
+            uint32(-1),
+            0u,
+            0u,
+            io::SequenceDataEncoder::NO_OP );
+        encoder->end_batch();
+    }
+
+    // write a set of reads sampled from the genome, a third of them reverse-complemented, and
+    // half of them with a mismatch; the reads starting within the repeats have many hits
+    {
+        FILE* file = fopen( reads_name, "w" );
+        if (file == NULL)
+        {
+            log_error(stderr, "  unable to create \"%s\"\n", reads_name);
+            exit(1);
+        }
+
+        char read[READ_LEN+1];
+        for (uint32 i = 0; i < N_READS; ++i)
+        {
+            const uint32 pos = (i % 10 == 0) ?
+                rand() % (REPEAT_LEN - READ_LEN) :
+                rand() % (GENOME_LEN - READ_LEN);
+
+            for (uint32 j = 0; j < READ_LEN; ++j)
+            {
+                const uint8 c = (i % 3 == 0) ?
+                    uint8( 3u - genome[ pos + READ_LEN-1-j ] ) :
+                    genome[ pos + j ];
+
+                read[j] = dna_to_char( (i & 1) && j == READ_LEN/2 ? uint8( (c + 1) & 3 ) : c );
+            }
+            read[READ_LEN] = '\0';
+
+            fprintf( file, "%s\n", read );
+        }
+        fclose( file );
+    }
+
+    typedef FMMapper<host_tag,fm_index_type> mapper_type;
+
+    FMMapParams params;
+    params.seed_len  = 16;
+    params.seed_intv = 8;
+
+    // map all reads with a single hit batch, and with many small ones
+    std::vector<int16> ref_scores( N_READS );
+    std::vector<int16> split_scores( N_READS );
+    {
+        SharedPointer<io::SequenceDataStream> read_file( io::open_sequence_file(
+            reads_name,
+            io::Phred33,
+            2*N_READS,
+            uint32(-1),
+            io::SequenceEncoding( io::FORWARD | io::REVERSE_COMPLEMENT ) ) );
+
+        io::SequenceDataHost reads;
+        io::next( DNA_N, &reads, read_file.get(), 2*N_READS, uint32(-1) );
+
+        nvbio::vector<host_tag,int16> best_scores;
+
+        mapper_type ref_mapper( params, fmi, nvbio::plain_view( genome_data ) );
+        ref_mapper.map( reads, best_scores );
+
+        for (uint32 i = 0; i < N_READS; ++i)
+            ref_scores[i] = best_scores[i];
+
+        params.hits_batch_size = 37;
+
+        mapper_type split_mapper( params, fmi, nvbio::plain_view( genome_data ) );
+        split_mapper.map( reads, best_scores );
+
+        for (uint32 i = 0; i < N_READS; ++i)
+            split_scores[i] = best_scores[i];
+
+        if (split_mapper.filter_stats().occurrences <= 4u * params.hits_batch_size)
+        {
+            log_error(stderr, "  expected more than %u hits, got %llu\n", 4u * params.hits_batch_size, split_mapper.filter_stats().occurrences);
+            exit(1);
+        }
+    }
+
+    // and run the filter and verify stages through a pipeline, with small read and hit batches
+    std::vector<int16> pipeline_scores( N_READS, 0 );
+    {
+        SharedPointer<io::SequenceDataStream> read_file( io::open_sequence_file(
+            reads_name,
+            io::Phred33,
+            2*N_READS,
+            uint32(-1),
+            io::SequenceEncoding( io::FORWARD | io::REVERSE_COMPLEMENT ) ) );
+
+        mapper_type mapper( params, fmi, nvbio::plain_view( genome_data ) );
+
+        FMMapFilterStage<mapper_type>   filter_stage( mapper, read_file.get(), 2*32, uint32(-1) );
+        FMMapVerifyStage<mapper_type>   verify_stage( mapper );
+        FMMapTestSink                   sink_stage( pipeline_scores );
+
+        Pipeline pipeline;
+        const uint32 s0 = pipeline.append_stage( &filter_stage, params.buffers );
+        const uint32 s1 = pipeline.append_stage( &verify_stage, params.buffers );
+        const uint32 s2 = pipeline.append_sink( &sink_stage );
+        pipeline.add_dependency( s0, s1 );
+        pipeline.add_dependency( s1, s2 );
+        pipeline.run();
+
+        if (sink_stage.n_batches != util::divide_ri( N_READS, 32u ) ||
+            sink_stage.n_hit_batches <= sink_stage.n_batches)
+        {
+            log_error(stderr, "  expected %u read batches split in more hit batches, got %u read batches and %u hit batches\n",
+                util::divide_ri( N_READS, 32u ), sink_stage.n_batches, sink_stage.n_hit_batches);
+            exit(1);
+        }
+    }
+
+    remove( reads_name );
+
+    for (uint32 i = 0; i < N_READS; ++i)
+    {
+        // every read comes from the genome with at most one mismatch
+        if (ref_scores[i] < -1)
+        {
+            log_error(stderr, "  read %u: expected a score of at least -1, got %d\n", i, ref_scores[i]);
+            exit(1);
+        }
+        if (split_scores[i] != ref_scores[i])
+        {
+            log_error(stderr, "  read %u: split hit batches score %d, expected %d\n", i, split_scores[i], ref_scores[i]);
+            exit(1);
+        }
+        if (pipeline_scores[i] != ref_scores[i])
+        {
+            log_error(stderr, "  read %u: pipeline score %d, expected %d\n", i, pipeline_scores[i], ref_scores[i]);
+            exit(1);
+        }
+    }
+
+    log_info(stderr, "fmmap test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
@@ -0,0 +1,225 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// host_allocator_test.cpp
+//
+
+#include <nvbio/basic/host_allocator.h>
+#include <nvbio/basic/vector.h>
+#include <nvbio/basic/packed_vector.h>
+#include <nvbio/basic/console.h>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace nvbio {
+
+namespace {
+
+// a private arena, so as to leave the default one alone
+struct test_arena_tag {};
+
+#define NVBIO_ALLOC_CHECK(cond, msg)                    \
+    if (!(cond))                                        \
+    {                                                   \
+        log_error(stderr, "  %s\n", msg);               \
+        exit(1);                                        \
+    }
+
+void test_host_arena()
+{
+    const uint64 CHUNK_SIZE = 1024u*1024u;
+
+    HostArena arena( CHUNK_SIZE );
+
+    // carve a few blocks with different alignments, and fill them
+    const uint64 sizes[]      = { 100u, 1000u, 3u, 64u*1024u, 200u*1024u };
+    const uint64 alignments[] = { 16u, 64u, 8u, 4096u, 16u };
+    const uint32 N_BLOCKS     = 5;
+
+    uint8* blocks[N_BLOCKS];
+    uint64 total = 0u;
+    for (uint32 i = 0; i < N_BLOCKS; ++i)
+    {
+        blocks[i] = (uint8*)arena.alloc( sizes[i], alignments[i] );
+        NVBIO_ALLOC_CHECK( blocks[i] != NULL,                           "HostArena::alloc() failed" );
+        NVBIO_ALLOC_CHECK( size_t( blocks[i] ) % alignments[i] == 0u,   "HostArena::alloc() returned a misaligned block" );
+
+        memset( blocks[i], int(i+1), sizes[i] );
+        total += sizes[i];
+    }
+    NVBIO_ALLOC_CHECK( arena.allocated_size() == total,      "HostArena::allocated_size() mismatch" );
+    NVBIO_ALLOC_CHECK( arena.reserved_size()  == CHUNK_SIZE, "HostArena: small blocks should fit a single chunk" );
+
+    // blocks must not overlap
+    for (uint32 i = 0; i < N_BLOCKS; ++i)
+        for (uint64 j = 0; j < sizes[i]; ++j)
+            NVBIO_ALLOC_CHECK( blocks[i][j] == uint8(i+1), "HostArena: overlapping blocks" );
+
+    // a block larger than the chunk size gets a chunk of its own
+    uint8* large = (uint8*)arena.alloc( 3u*CHUNK_SIZE );
+    NVBIO_ALLOC_CHECK( large != NULL, "HostArena::alloc() of a large block failed" );
+    memset( large, 0xFF, 3u*CHUNK_SIZE );
+
+    const uint64 reserved = arena.reserved_size();
+    NVBIO_ALLOC_CHECK( reserved > 3u*CHUNK_SIZE, "HostArena: large block not reserved" );
+
+    // reset the arena: the same allocations must reuse the same memory, without reserving more
+    arena.reset();
+    NVBIO_ALLOC_CHECK( arena.allocated_size() == 0u,     "HostArena::reset() did not clear the allocated size" );
+    NVBIO_ALLOC_CHECK( arena.reserved_size() == reserved, "HostArena::reset() released its chunks" );
+
+    for (uint32 i = 0; i < N_BLOCKS; ++i)
+        NVBIO_ALLOC_CHECK( arena.alloc( sizes[i], alignments[i] ) == blocks[i], "HostArena: memory not reused after reset()" );
+
+    NVBIO_ALLOC_CHECK( arena.alloc( 3u*CHUNK_SIZE ) == large,   "HostArena: large chunk not reused after reset()" );
+    NVBIO_ALLOC_CHECK( arena.reserved_size() == reserved,       "HostArena: reserved more memory after reset()" );
+}
+
+void test_arena_allocator()
+{
+    typedef nvbio::vector<host_tag, uint32, arena_allocator<uint32,test_arena_tag> >                 vector_type;
+    typedef PackedVector<host_tag, 2u, false, uint64, arena_allocator<uint32,test_arena_tag> >      packed_vector_type;
+
+    HostArena& arena = host_arena<test_arena_tag>();
+
+    for (uint32 round = 0; round < 2; ++round)
+    {
+        const uint64 reserved = arena.reserved_size();
+        {
+            vector_type vec( 1000u, 7u );
+            NVBIO_ALLOC_CHECK( arena.allocated_size() >= 1000u * sizeof(uint32), "arena_allocator: vector not allocated from the arena" );
+
+            for (uint32 i = 0; i < 1000u; ++i)
+                NVBIO_ALLOC_CHECK( vec[i] == 7u, "arena_allocator: vector initialization mismatch" );
+
+            packed_vector_type packed( 10000u );
+            for (uint32 i = 0; i < 10000u; ++i)
+                packed[i] = uint8( i & 3u );
+            for (uint32 i = 0; i < 10000u; ++i)
+                NVBIO_ALLOC_CHECK( packed[i] == uint8( i & 3u ), "arena_allocator: packed vector mismatch" );
+        }
+        // recycle the storage of the destroyed containers
+        arena.reset();
+
+        // the second round must be served from the chunks reserved by the first
+        if (round)
+            NVBIO_ALLOC_CHECK( arena.reserved_size() == reserved, "arena_allocator: arena not reused after reset()" );
+    }
+}
+
+void test_uninitialized_allocator()
+{
+    typedef nvbio::vector<host_tag, uint32, uninitialized_allocator< uint32, huge_page_allocator<uint32> > >         vector_type;
+    typedef PackedVector<host_tag, 4u, false, uint64, uninitialized_allocator< uint32, huge_page_allocator<uint32> > > packed_vector_type;
+
+    // grow a vector past the huge page threshold, checking its contents are preserved
+    const uint32 N = 1u << 20;
+
+    vector_type vec;
+    vec.resize( 1000u );
+    for (uint32 i = 0; i < 1000u; ++i)
+        vec[i] = i;
+
+    vec.resize( N );
+    for (uint32 i = 1000u; i < N; ++i)
+        vec[i] = i;
+
+    for (uint32 i = 0; i < N; ++i)
+        NVBIO_ALLOC_CHECK( vec[i] == i, "uninitialized_allocator: vector contents lost on resize" );
+
+    // resize with a value must still fill the new elements
+    vec.resize( 10u );
+    vec.resize( 5000u, 3u );
+    for (uint32 i = 0; i < 10u; ++i)
+        NVBIO_ALLOC_CHECK( vec[i] == i,  "uninitialized_allocator: vector contents lost on shrink" );
+    for (uint32 i = 10u; i < 5000u; ++i)
+        NVBIO_ALLOC_CHECK( vec[i] == 3u, "uninitialized_allocator: resize(n,value) did not fill" );
+
+    // and a packed vector
+    packed_vector_type packed( 1000u );
+    for (uint32 i = 0; i < 1000u; ++i)
+        packed[i] = uint8( i % 13u );
+
+    packed.resize( 3u*N );
+    for (uint32 i = 1000u; i < 3u*N; ++i)
+        packed[i] = uint8( i % 11u );
+
+    for (uint32 i = 0; i < 3u*N; ++i)
+        NVBIO_ALLOC_CHECK( packed[i] == uint8( i < 1000u ? i % 13u : i % 11u ), "uninitialized_allocator: packed vector mismatch" );
+}
+
+void test_huge_page_alloc()
+{
+    const uint64 HUGE_PAGE_SIZE = 2u*1024u*1024u;
+
+    // small blocks, huge blocks, and huge blocks preferring NUMA nodes which don't exist:
+    // the latter make mbind fail, and the allocation must go through regardless
+    const uint64 sizes[]      = { 100u, HUGE_PAGE_SIZE, 3u*HUGE_PAGE_SIZE + 5u, 3u*HUGE_PAGE_SIZE + 5u, 3u*HUGE_PAGE_SIZE + 5u };
+    const int32  numa_nodes[] = { -1,   -1,             -1,                     60,                     1000 };
+
+    for (uint32 i = 0; i < 5; ++i)
+    {
+        uint8* ptr = (uint8*)huge_page_alloc( sizes[i], numa_nodes[i] );
+        NVBIO_ALLOC_CHECK( ptr != NULL, "huge_page_alloc() failed" );
+
+      #if defined(__linux__)
+        if (sizes[i] >= HUGE_PAGE_SIZE)
+            NVBIO_ALLOC_CHECK( size_t( ptr ) % HUGE_PAGE_SIZE == 0u, "huge_page_alloc() returned a block not aligned to a huge page" );
+      #endif
+
+        // touch all the pages
+        memset( ptr, 0xAB, sizes[i] );
+        NVBIO_ALLOC_CHECK( ptr[0] == 0xAB && ptr[ sizes[i]-1 ] == 0xAB, "huge_page_alloc() returned an unusable block" );
+
+        huge_page_free( ptr );
+    }
+
+    // and through the allocator interface
+    std::vector< uint64, huge_page_allocator<uint64,60> > vec( HUGE_PAGE_SIZE, 1u );
+    NVBIO_ALLOC_CHECK( vec[0] == 1u && vec[ HUGE_PAGE_SIZE-1 ] == 1u, "huge_page_allocator: allocation with an invalid NUMA node failed" );
+}
+
+#undef NVBIO_ALLOC_CHECK
+
+} // anonymous namespace
+
+int host_allocator_test()
+{
+    log_info(stderr, "host allocator test... started\n");
+
+    test_host_arena();
+    test_arena_allocator();
+    test_uninitialized_allocator();
+    test_huge_page_alloc();
+
+    log_info(stderr, "host allocator test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
@@ -0,0 +1,210 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// kmer_counter_test.cpp
+//
+
+#include <nvbio/strings/kmer_counter.h>
+#include <nvbio/strings/string_set.h>
+#include <nvbio/basic/console.h>
+#include <map>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace nvbio {
+
+namespace {
+
+typedef std::map<uint64,uint32> kmer_map;
+
+// count the canonical k-mers of a set of strings by brute force, skipping those containing N's
+//
+void count_kmers(
+    const uint32                K,
+    const uint32                n_strings,
+    const uint32                len,
+    const std::vector<uint8>&   text,
+    kmer_map&                   counts)
+{
+    for (uint32 i = 0; i < n_strings; ++i)
+    {
+        for (uint32 j = 0; j + K <= len; ++j)
+        {
+            uint64 kmer  = 0u;
+            bool   valid = true;
+            for (uint32 c = 0; c < K && valid; ++c)
+            {
+                const uint8 s = text[ i*len + j + c ];
+                valid = (s <= 3u);
+                kmer  = (kmer << 2) | (s & 3u);
+            }
+            if (valid)
+                counts[ kmer_canonical( kmer, K ) ]++;
+        }
+    }
+}
+
+// count the k-mers of the given strings with a KmerCounter, check the resulting table against
+// the brute-force counts, and return the number of spilled k-mers
+//
+uint64 check_kmer_counter(
+    const uint32                K,
+    const uint32                n_strings,
+    const uint32                len,
+    const std::vector<uint8>&   text,
+    const uint64                memory_budget,
+    const uint32                min_count,
+    const kmer_map&             ref)
+{
+    const char* table_name = "./kmer_counter_test.kcnt";
+
+    std::vector<uint32> offsets( n_strings+1 );
+    for (uint32 i = 0; i <= n_strings; ++i)
+        offsets[i] = i * len;
+
+    typedef ConcatenatedStringSet<const uint8*,const uint32*> string_set_type;
+
+    uint64 n_spilled;
+    uint64 n_written;
+    {
+        KmerCounter counter( K, memory_budget, ".", 64u, 9u );
+
+        // add the strings in two batches, so as to spill the buckets more than once
+        const uint32 n_first = n_strings / 2;
+
+        counter.add( string_set_type( n_first,             &text[0], &offsets[0] ) );
+        counter.add( string_set_type( n_strings - n_first, &text[0], &offsets[n_first] ) );
+
+        n_spilled = counter.n_spilled();
+        n_written = counter.finalize( table_name, min_count );
+    }
+
+    uint64 n_expected = 0u;
+    for (kmer_map::const_iterator it = ref.begin(); it != ref.end(); ++it)
+        n_expected += (it->second >= min_count) ? 1u : 0u;
+
+    if (n_written != n_expected)
+    {
+        log_error(stderr, "  K=%u, min-count=%u: expected %llu k-mers, got %llu\n", K, min_count, n_expected, n_written);
+        exit(1);
+    }
+
+    KmerCountTable table;
+    table.load( table_name );
+
+    if (table.k() != K || table.size() != n_expected)
+    {
+        log_error(stderr, "  K=%u, min-count=%u: table has K=%u and %llu k-mers\n", K, min_count, table.k(), table.size());
+        exit(1);
+    }
+
+    // check the sorted table against the brute-force counts, and the lookups on both strands
+    uint64 i = 0;
+    for (kmer_map::const_iterator it = ref.begin(); it != ref.end(); ++it)
+    {
+        const uint32 expected = (it->second >= min_count) ? it->second : 0u;
+
+        if (expected)
+        {
+            if (table.kmers()[i] != it->first || table.counts()[i] != expected)
+            {
+                log_error(stderr, "  K=%u, min-count=%u: entry %llu is (%llx, %u), expected (%llx, %u)\n",
+                    K, min_count, i, table.kmers()[i], table.counts()[i], it->first, expected);
+                exit(1);
+            }
+            ++i;
+        }
+
+        if (table.count( it->first ) != expected ||
+            table.count( kmer_reverse_complement( it->first, K ) ) != expected)
+        {
+            log_error(stderr, "  K=%u, min-count=%u: k-mer %llx has count %u, expected %u\n",
+                K, min_count, it->first, table.count( it->first ), expected);
+            exit(1);
+        }
+    }
+
+    remove( table_name );
+    return n_spilled;
+}
+
+} // anonymous namespace
+
+int kmer_counter_test()
+{
+    log_info(stderr, "kmer counter test... started\n");
+
+    const uint32 GENOME_LEN = 20000;
+    const uint32 N_STRINGS  = 3000;
+    const uint32 LEN        = 150;
+
+    srand(3);
+
+    // sample reads with a sprinkle of N's from a small genome, so that most k-mers are repeated
+    std::vector<uint8> genome( GENOME_LEN );
+    for (uint32 i = 0; i < GENOME_LEN; ++i)
+        genome[i] = uint8( rand() & 3 );
+
+    std::vector<uint8> text( N_STRINGS * LEN );
+    for (uint32 i = 0; i < N_STRINGS; ++i)
+    {
+        const uint32 pos = rand() % (GENOME_LEN - LEN);
+        for (uint32 j = 0; j < LEN; ++j)
+            text[ i*LEN + j ] = (rand() % 500 == 0) ? uint8(4) : genome[ pos + j ];
+    }
+
+    const uint32 Ks[] = { 13, 21, 32 };
+    for (uint32 k = 0; k < 3; ++k)
+    {
+        const uint32 K = Ks[k];
+
+        kmer_map ref;
+        count_kmers( K, N_STRINGS, LEN, text, ref );
+
+        // use a tiny memory budget, so that the buckets are spilled to disk; the reads cover
+        // the genome about 20 times, so that a minimum count of 16 drops a good share of the k-mers
+        const uint32 min_counts[] = { 1, 16 };
+        for (uint32 m = 0; m < 2; ++m)
+        {
+            const uint64 n_spilled = check_kmer_counter( K, N_STRINGS, LEN, text, 64u*1024u, min_counts[m], ref );
+            if (n_spilled == 0u)
+            {
+                log_error(stderr, "  K=%u: expected the k-mers to be spilled to disk\n", K);
+                exit(1);
+            }
+        }
+
+        // and a budget large enough to keep everything in memory
+        check_kmer_counter( K, N_STRINGS, LEN, text, uint64(1u) << 30, 2u, ref );
+    }
+
+    log_info(stderr, "kmer counter test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
@@ -0,0 +1,205 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+// kmers_test.cpp
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/console.h>
+#include <nvbio/basic/packedstream.h>
+#include <nvbio/basic/vector_view.h>
+#include <nvbio/basic/exceptions.h>
+#include <nvbio/strings/string_set.h>
+#include <nvbio/strings/kmers.h>
+
+namespace nvbio {
+
+namespace {
+
+// check load_kmer() against the symbol-by-symbol loader for all the k-mers of a random
+// packed string, read both from the beginning of the stream and from an offset within it
+//
+template <uint32 SYMBOL_SIZE, bool BIG_ENDIAN>
+void test_load_kmer()
+{
+    typedef PackedStream<const uint32*,uint8,SYMBOL_SIZE,BIG_ENDIAN,uint32> stream_type;
+
+    const uint32 N_WORDS    = 64;
+    const uint32 STRING_LEN = (N_WORDS * 32u) / SYMBOL_SIZE - 3u;   // leave the last word partially used
+    const uint32 OFFSET     = 13;
+
+    std::vector<uint32> words( N_WORDS, 0u );
+    {
+        PackedStream<uint32*,uint8,SYMBOL_SIZE,BIG_ENDIAN,uint32> stream( &words[0] );
+        for (uint32 i = 0; i < STRING_LEN; ++i)
+            stream[i] = uint8( rand() & ((1u << SYMBOL_SIZE) - 1u) );
+    }
+
+    const stream_type string( &words[0] );
+    const stream_type suffix = string + OFFSET;
+
+    const vector_view<stream_type> string_view( STRING_LEN, string );
+
+    for (uint32 K = 1; K * SYMBOL_SIZE <= 64u; ++K)
+    {
+        // include the positions whose k-mers run past the end of the string
+        for (uint32 pos = 0; pos < STRING_LEN; ++pos)
+        {
+            const uint64 ref_msb = priv::load_kmer_symbols<false>( string, STRING_LEN, pos, K, SYMBOL_SIZE );
+            const uint64 ref_lsb = priv::load_kmer_symbols<true>(  string, STRING_LEN, pos, K, SYMBOL_SIZE );
+
+            const uint64 msb = load_kmer<false>( string, STRING_LEN, pos, K, SYMBOL_SIZE );
+            const uint64 lsb = load_kmer<true>(  string, STRING_LEN, pos, K, SYMBOL_SIZE );
+
+            const uint64 view_msb = load_kmer<false>( string_view, STRING_LEN, pos, K, SYMBOL_SIZE );
+
+            if (msb != ref_msb || lsb != ref_lsb || view_msb != ref_msb)
+            {
+                log_error(stderr, "  load_kmer<S=%u,%s>(pos=%u, K=%u): expected (%llx, %llx), got (%llx, %llx, %llx)\n",
+                    SYMBOL_SIZE, BIG_ENDIAN ? "BE" : "LE", pos, K, ref_msb, ref_lsb, msb, lsb, view_msb);
+                exit(1);
+            }
+
+            if (pos < STRING_LEN - OFFSET)
+            {
+                const uint64 suffix_msb = load_kmer<false>( suffix, STRING_LEN - OFFSET, pos, K, SYMBOL_SIZE );
+                const uint64 suffix_ref = priv::load_kmer_symbols<false>( suffix, STRING_LEN - OFFSET, pos, K, SYMBOL_SIZE );
+                if (suffix_msb != suffix_ref)
+                {
+                    log_error(stderr, "  load_kmer<S=%u,%s>(offset=%u, pos=%u, K=%u): expected %llx, got %llx\n",
+                        SYMBOL_SIZE, BIG_ENDIAN ? "BE" : "LE", OFFSET, pos, K, suffix_ref, suffix_msb);
+                    exit(1);
+                }
+            }
+        }
+    }
+}
+
+// reverse-complement a 2-bit k-mer one symbol at a time
+//
+uint64 reverse_complement_symbols(const uint64 kmer, const uint32 K)
+{
+    uint64 r = 0u;
+    for (uint32 i = 0; i < K; ++i)
+        r |= (3u - ((kmer >> (2u*i)) & 3u)) << (2u*(K - 1u - i));
+
+    return r;
+}
+
+// check that extract_kmers() rejects k-mer lengths not fitting in a 64-bit code
+//
+void test_kmer_length()
+{
+    const uint8  string[8]  = { 0, 1, 2, 3, 0, 1, 2, 3 };
+    const uint32 offsets[2] = { 0, 8 };
+
+    const ConcatenatedStringSet<const uint8*,const uint32*> string_set( 1u, string, offsets );
+
+    nvbio::vector<host_tag,uint64> kmers;
+    nvbio::vector<host_tag,uint2>  coords;
+
+    const uint32 K[2] = { 0u, 33u };
+    for (uint32 i = 0; i < 2; ++i)
+    {
+        bool thrown = false;
+        try
+        {
+            extract_kmers( K[i], string_set, KMER_FORWARD, kmers, coords );
+        }
+        catch (runtime_error)
+        {
+            thrown = true;
+        }
+
+        if (thrown == false)
+        {
+            log_error(stderr, "  extract_kmers(K=%u): expected an exception\n", K[i]);
+            exit(1);
+        }
+    }
+
+    if (extract_kmers( 4u, string_set, KMER_FORWARD, kmers, coords ) != 5u)
+    {
+        log_error(stderr, "  extract_kmers(K=4): expected 5 k-mers\n");
+        exit(1);
+    }
+}
+
+} // anonymous namespace
+
+int kmers_test()
+{
+    log_info(stderr, "kmers test... started\n");
+
+    srand( 23 );
+
+    test_load_kmer<1,false>();
+    test_load_kmer<1,true>();
+    test_load_kmer<2,false>();
+    test_load_kmer<2,true>();
+    test_load_kmer<3,false>();
+    test_load_kmer<3,true>();
+    test_load_kmer<4,false>();
+    test_load_kmer<4,true>();
+    test_load_kmer<5,false>();
+    test_load_kmer<5,true>();
+    test_load_kmer<8,false>();
+    test_load_kmer<8,true>();
+
+    test_kmer_length();
+
+    for (uint32 K = 1; K <= 32; ++K)
+    {
+        const uint64 mask = K == 32 ? uint64(-1) : (uint64(1u) << (2u*K)) - 1u;
+
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            const uint64 kmer = ((uint64( rand() ) << 40) ^ (uint64( rand() ) << 20) ^ uint64( rand() )) & mask;
+
+            const uint64 rc  = kmer_reverse_complement( kmer, K );
+            const uint64 ref = reverse_complement_symbols( kmer, K );
+
+            if (rc != ref || kmer_reverse_complement( rc, K ) != kmer)
+            {
+                log_error(stderr, "  kmer_reverse_complement(%llx, K=%u): expected %llx, got %llx\n", kmer, K, ref, rc);
+                exit(1);
+            }
+            if (kmer_canonical( kmer, K ) != nvbio::min( kmer, ref ))
+            {
+                log_error(stderr, "  kmer_canonical(%llx, K=%u): expected %llx, got %llx\n", kmer, K, nvbio::min( kmer, ref ), kmer_canonical( kmer, K ));
+                exit(1);
+            }
+        }
+    }
+
+    log_info(stderr, "kmers test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
@@ -58,6 +58,21 @@ int qgram_test(int argc, char* argv[]);
 int sequence_test(int argc, char* argv[]);
 int wavelet_test(int argc, char* argv[]);
 int bloom_filter_test(int argc, char* argv[]);
+int primitives_test(int argc, char* argv[]);
+int simd_test();
+int fmmap_test(int argc, char* argv[]);
+int kmer_counter_test();
+int packed_mmap_test();
+int priority_queue_test();
+int host_allocator_test();
+int qmap_test();
+int fmindex_file_test();
+int bwte_append_test();
+int kmers_test();
+int paged_text_test();
+int seed_cache_test();
+int batch_size_test();
+int sequence_dedup_test();
 
 namespace cuda { void scan_test(); }
 namespace aln { void test(int argc, char* argv[]); }
@@ -86,7 +101,22 @@ enum Tests {
     kSequence       = 131072u,
     kWaveletTree    = 262144u,
     kBloomFilter    = 524288u,
-    kALL            = 0xFFFFFFFFu
+    kPrimitives     = 1048576u,
+    kSIMD           = 2097152u,
+    kFMMap          = 4194304u,
+    kKmerCounter    = 8388608u,
+    kPackedMMap     = 16777216u,
+    kPriorityQueue  = 33554432u,
+    kHostAllocator  = 67108864u,
+    kQMap           = 134217728u,
+    kFMIndexFile    = 268435456u,
+    kBWTEAppend     = 536870912u,
+    kKmers          = 1073741824u,
+    kPagedText      = 2147483648u,
+    kSeedCache      = 4294967296ull,
+    kBatchSize      = 8589934592ull,
+    kDedup          = 17179869184ull,
+    kALL            = 0xFFFFFFFFFFFFFFFFull
 };
 
 int main(int argc, char* argv[])
@@ -102,7 +132,7 @@ int main(int argc, char* argv[])
 
         log_verbose(stderr, "  cuda devices : %d\n", device_count);
 
-        uint32 tests = kALL;
+        uint64 tests = kALL;
 
         int arg = 1;
         if (argc > 1)
@@ -151,6 +181,36 @@ int main(int argc, char* argv[])
                     tests = kWaveletTree;
                 else if (strcmp( argv[arg], "-bloom-filter" ) == 0)
                     tests = kBloomFilter;
+                else if (strcmp( argv[arg], "-primitives" ) == 0)
+                    tests = kPrimitives;
+                else if (strcmp( argv[arg], "-simd" ) == 0)
+                    tests = kSIMD;
+                else if (strcmp( argv[arg], "-fmmap" ) == 0)
+                    tests = kFMMap;
+                else if (strcmp( argv[arg], "-kmer-counter" ) == 0)
+                    tests = kKmerCounter;
+                else if (strcmp( argv[arg], "-packed-mmap" ) == 0)
+                    tests = kPackedMMap;
+                else if (strcmp( argv[arg], "-priority-queue" ) == 0)
+                    tests = kPriorityQueue;
+                else if (strcmp( argv[arg], "-host-alloc" ) == 0)
+                    tests = kHostAllocator;
+                else if (strcmp( argv[arg], "-qmap" ) == 0)
+                    tests = kQMap;
+                else if (strcmp( argv[arg], "-fmindex-file" ) == 0)
+                    tests = kFMIndexFile;
+                else if (strcmp( argv[arg], "-bwte-append" ) == 0)
+                    tests = kBWTEAppend;
+                else if (strcmp( argv[arg], "-kmers" ) == 0)
+                    tests = kKmers;
+                else if (strcmp( argv[arg], "-paged-text" ) == 0)
+                    tests = kPagedText;
+                else if (strcmp( argv[arg], "-seed-cache" ) == 0)
+                    tests = kSeedCache;
+                else if (strcmp( argv[arg], "-batch-size" ) == 0)
+                    tests = kBatchSize;
+                else if (strcmp( argv[arg], "-dedup" ) == 0)
+                    tests = kDedup;
 
                 ++arg;
             }
@@ -216,6 +276,21 @@ int main(int argc, char* argv[])
         if (tests & kSequence)      sequence_test( argc, argv+arg );
         if (tests & kWaveletTree)   wavelet_test( argc, argv+arg );
         if (tests & kBloomFilter)   bloom_filter_test( argc, argv+arg );
+        if (tests & kPrimitives)    primitives_test( argc, argv+arg );
+        if (tests & kSIMD)          simd_test();
+        if (tests & kFMMap)         fmmap_test( argc, argv+arg );
+        if (tests & kKmerCounter)   kmer_counter_test();
+        if (tests & kPackedMMap)    packed_mmap_test();
+        if (tests & kPriorityQueue) priority_queue_test();
+        if (tests & kHostAllocator) host_allocator_test();
+        if (tests & kQMap)          qmap_test();
+        if (tests & kFMIndexFile)   fmindex_file_test();
+        if (tests & kBWTEAppend)    bwte_append_test();
+        if (tests & kKmers)         kmers_test();
+        if (tests & kPagedText)     paged_text_test();
+        if (tests & kSeedCache)     seed_cache_test();
+        if (tests & kBatchSize)     batch_size_test();
+        if (tests & kDedup)         sequence_dedup_test();
 
         cudaDeviceReset();
     	return 0;
@@ -0,0 +1,314 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// packed_mmap_test.cpp
+//
+
+#include <nvbio/basic/packed_vector_mmap.h>
+#include <nvbio/strings/string_set_mmap.h>
+#include <nvbio/basic/exceptions.h>
+#include <nvbio/basic/console.h>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace nvbio {
+
+namespace {
+
+// save a random packed vector, map it back and compare all of its symbols
+//
+template <uint32 SYMBOL_SIZE, bool BIG_ENDIAN>
+void test_packed_vector_mmap(const char* file_name, const uint32 n)
+{
+    const uint32 SYMBOL_COUNT = 1u << SYMBOL_SIZE;
+
+    PackedVector<host_tag,SYMBOL_SIZE,BIG_ENDIAN> vec( n );
+    for (uint32 i = 0; i < n; ++i)
+        vec[i] = uint8( rand() % SYMBOL_COUNT );
+
+    if (save_packed_vector( file_name, vec ) == false)
+    {
+        log_error(stderr, "  unable to save \"%s\"\n", file_name);
+        exit(1);
+    }
+
+    MappedPackedVector<SYMBOL_SIZE,BIG_ENDIAN> mapped;
+    mapped.load( file_name );
+
+    if (mapped.size() != n)
+    {
+        log_error(stderr, "  %u-bit packed vector: size %llu, expected %u\n", SYMBOL_SIZE, uint64( mapped.size() ), n);
+        exit(1);
+    }
+
+    typename MappedPackedVector<SYMBOL_SIZE,BIG_ENDIAN>::const_plain_view_type view = plain_view( mapped );
+    typename MappedPackedVector<SYMBOL_SIZE,BIG_ENDIAN>::const_iterator        it   = mapped.begin();
+
+    for (uint32 i = 0; i < n; ++i, ++it)
+    {
+        const uint8 c = vec[i];
+        if (mapped[i] != c || view[i] != c || *it != c)
+        {
+            log_error(stderr, "  %u-bit packed vector: symbol %u mismatch\n", SYMBOL_SIZE, i);
+            exit(1);
+        }
+    }
+    if (it != mapped.end())
+    {
+        log_error(stderr, "  %u-bit packed vector: wrong end iterator\n", SYMBOL_SIZE);
+        exit(1);
+    }
+}
+
+// write a random 2-bit big-endian vector in nvBWT's .wpac layout, map it back and compare all of its symbols
+//
+void test_wpac_mmap(const char* file_name, const uint32 n)
+{
+    PackedVector<host_tag,2u,true> vec( n );
+    for (uint32 i = 0; i < n; ++i)
+        vec[i] = uint8( rand() & 3 );
+
+    const uint32 n_words = uint32( util::divide_ri( n, 16u ) );
+
+    FILE* file = fopen( file_name, "wb" );
+    if (file == NULL)
+    {
+        log_error(stderr, "  unable to open \"%s\"\n", file_name);
+        exit(1);
+    }
+    const uint64 len = n;
+    fwrite( &len, sizeof(len), 1u, file );
+    fwrite( &vec.m_storage[0], sizeof(uint32), n_words, file );
+    fclose( file );
+
+    MappedPackedVector<2u,true> mapped;
+    mapped.load_wpac( file_name );
+
+    if (mapped.size() != n)
+    {
+        log_error(stderr, "  wpac vector: size %llu, expected %u\n", uint64( mapped.size() ), n);
+        exit(1);
+    }
+    for (uint32 i = 0; i < n; ++i)
+    {
+        if (mapped[i] != vec[i])
+        {
+            log_error(stderr, "  wpac vector: symbol %u mismatch\n", i);
+            exit(1);
+        }
+    }
+
+    // rewrite the file dropping its last word, which must then be rejected as truncated
+    file = fopen( file_name, "wb" );
+    fwrite( &len, sizeof(len), 1u, file );
+    fwrite( &vec.m_storage[0], sizeof(uint32), n_words-1, file );
+    fclose( file );
+
+    bool rejected = false;
+    try
+    {
+        MappedPackedVector<2u,true> truncated;
+        truncated.load_wpac( file_name );
+    }
+    catch (runtime_error&)
+    {
+        rejected = true;
+    }
+    if (rejected == false)
+    {
+        log_error(stderr, "  truncated wpac file was not rejected\n");
+        exit(1);
+    }
+}
+
+// check that loading a file into the given mapped type throws a runtime_error
+//
+template <typename mapped_type>
+void test_mmap_rejection(const char* file_name, const char* what)
+{
+    bool rejected = false;
+    try
+    {
+        mapped_type mapped;
+        mapped.load( file_name );
+    }
+    catch (runtime_error&)
+    {
+        rejected = true;
+    }
+
+    if (rejected == false)
+    {
+        log_error(stderr, "  \"%s\" was not rejected as %s\n", file_name, what);
+        exit(1);
+    }
+}
+
+// check that two string sets hold the same strings
+//
+template <typename string_set_type1, typename string_set_type2>
+void check_string_sets(const char* name, const string_set_type1& set1, const string_set_type2& set2)
+{
+    if (set1.size() != set2.size())
+    {
+        log_error(stderr, "  %s: %u strings, expected %u\n", name, set2.size(), set1.size());
+        exit(1);
+    }
+
+    for (uint32 i = 0; i < set1.size(); ++i)
+    {
+        const typename string_set_type1::string_type string1 = set1[i];
+        const typename string_set_type2::string_type string2 = set2[i];
+
+        if (string1.length() != string2.length())
+        {
+            log_error(stderr, "  %s: string %u has length %u, expected %u\n", name, i, string2.length(), string1.length());
+            exit(1);
+        }
+
+        for (uint32 j = 0; j < string1.length(); ++j)
+        {
+            if (uint8( string1[j] ) != uint8( string2[j] ))
+            {
+                log_error(stderr, "  %s: string %u mismatch at %u\n", name, i, j);
+                exit(1);
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+int packed_mmap_test()
+{
+    log_info(stderr, "packed mmap test... started\n");
+
+    const char* vec2_name   = "./packed_mmap_test.2.pvec";
+    const char* vec4_name   = "./packed_mmap_test.4.pvec";
+    const char* cset_name   = "./packed_mmap_test.cset";
+    const char* sset_name   = "./packed_mmap_test.sset";
+    const char* wpac_name   = "./packed_mmap_test.wpac";
+
+    srand(66);
+
+    // round-trip a 2-bit and a 4-bit vector, with lengths not multiple of the word size
+    test_packed_vector_mmap<2u,false>( vec2_name, 10001 );
+    test_packed_vector_mmap<4u,true> ( vec4_name, 3333 );
+
+    // map a vector in the .wpac layout written by nvBWT
+    test_wpac_mmap( wpac_name, 10001 );
+
+    // build a random string set over a 4 letter alphabet, including a few empty strings
+    const uint32 N_STRINGS = 200;
+
+    std::vector<uint32> offsets( N_STRINGS+1 );
+    std::vector<uint8>  symbols;
+    offsets[0] = 0;
+    for (uint32 i = 0; i < N_STRINGS; ++i)
+    {
+        const uint32 len = (i % 17 == 0) ? 0u : uint32( rand() % 100 );
+        for (uint32 j = 0; j < len; ++j)
+            symbols.push_back( uint8( rand() & 3 ) );
+
+        offsets[i+1] = uint32( symbols.size() );
+    }
+
+    typedef ConcatenatedStringSet<const uint8*,const uint32*> concat_string_set_type;
+    const concat_string_set_type concat_set( N_STRINGS, &symbols[0], &offsets[0] );
+
+    // round-trip it as a concatenated string set
+    {
+        if (save_concatenated_string_set<2u,false>( cset_name, concat_set ) == false)
+        {
+            log_error(stderr, "  unable to save \"%s\"\n", cset_name);
+            exit(1);
+        }
+
+        MappedConcatenatedStringSet<2u,false> mapped;
+        mapped.load( cset_name );
+
+        if (mapped.n_symbols() != symbols.size())
+        {
+            log_error(stderr, "  concatenated string set: %llu symbols, expected %llu\n", mapped.n_symbols(), uint64( symbols.size() ));
+            exit(1);
+        }
+        check_string_sets( "concatenated string set", concat_set, plain_view( mapped ) );
+    }
+
+    // and as a sparse string set, made of overlapping ranges of the concatenated symbols
+    {
+        const uint32 n_symbols = uint32( symbols.size() );
+
+        std::vector<uint2> ranges( N_STRINGS );
+        for (uint32 i = 0; i < N_STRINGS; ++i)
+        {
+            const uint32 begin = rand() % n_symbols;
+            const uint32 end   = nvbio::min( begin + uint32( rand() % 50 ), n_symbols );
+            ranges[i] = make_uint2( begin, end );
+        }
+
+        typedef SparseStringSet<const uint8*,const uint2*> sparse_string_set_type;
+        const sparse_string_set_type sparse_set( N_STRINGS, &symbols[0], &ranges[0] );
+
+        if (save_sparse_string_set<4u,true>( sset_name, n_symbols, &symbols[0], N_STRINGS, &ranges[0] ) == false)
+        {
+            log_error(stderr, "  unable to save \"%s\"\n", sset_name);
+            exit(1);
+        }
+
+        MappedSparseStringSet<4u,true> mapped;
+        mapped.load( sset_name );
+
+        if (mapped.n_symbols() != n_symbols)
+        {
+            log_error(stderr, "  sparse string set: %llu symbols, expected %u\n", mapped.n_symbols(), n_symbols);
+            exit(1);
+        }
+        check_string_sets( "sparse string set", sparse_set, plain_view( mapped ) );
+    }
+
+    // files must be rejected if their type or packing format does not match
+    test_mmap_rejection< MappedPackedVector<4u,false> >         ( vec2_name, "a 4-bit vector" );
+    test_mmap_rejection< MappedPackedVector<2u,true> >          ( vec2_name, "a big-endian vector" );
+    test_mmap_rejection< MappedConcatenatedStringSet<2u,false> >( vec2_name, "a string set" );
+    test_mmap_rejection< MappedPackedVector<2u,false> >         ( cset_name, "a packed vector" );
+    test_mmap_rejection< MappedSparseStringSet<2u,false> >      ( cset_name, "a sparse string set" );
+    test_mmap_rejection< MappedSparseStringSet<2u,true> >       ( sset_name, "a 2-bit string set" );
+    test_mmap_rejection< MappedConcatenatedStringSet<4u,true> > ( sset_name, "a concatenated string set" );
+
+    remove( vec2_name );
+    remove( vec4_name );
+    remove( cset_name );
+    remove( sset_name );
+    remove( wpac_name );
+
+    log_info(stderr, "packed mmap test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
@@ -0,0 +1,170 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// paged_text_test.cpp
+//
+
+#include <nvbio/fmindex/paged_text.h>
+#include <nvbio/basic/atomics.h>
+#include <nvbio/basic/console.h>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+
+namespace nvbio {
+
+namespace {
+
+typedef PagedText<2u,true>              paged_text_type;
+typedef paged_text_type::word_type      word_type;
+
+uint32 page_id(const word_type* page) { return uint32( page[ -int32(paged_text_type::PAGE_HEADER_WORDS) ] ); }
+
+// have each thread repeatedly grab its share of the whole pool and give it back, checking that
+// no page is ever owned by two threads at once; with the pool running dry at every round, the
+// allocators must find the pages parked in the other threads' caches
+//
+uint32 stress_page_pool(paged_text_type& text, const uint32 n_pages, const uint32 n_rounds)
+{
+    std::vector<uint32> owners( n_pages, 0u );
+    uint32 n_errors = 0u;
+
+    const uint32 n_threads = omp_get_max_threads();
+    const uint32 quota     = n_pages / n_threads;
+
+    #pragma omp parallel num_threads(n_threads)
+    {
+        const uint32 tid = omp_get_thread_num();
+
+        std::vector<word_type*> pages;
+        pages.reserve( quota );
+
+        uint32 seed = tid + 1u;
+
+        for (uint32 r = 0; r < n_rounds; ++r)
+        {
+            // every other round take the full quota, so that the pool gets exhausted
+            const uint32 n = (r & 1u) ? quota : 1u + (seed = seed * 1103515245u + 12345u) % quota;
+
+            for (uint32 i = 0; i < n; ++i)
+            {
+                word_type* page = text.alloc_page();
+
+                if (host_atomic_cas( &owners[ page_id( page ) ], 0u, tid+1u ) != 0u)
+                    host_atomic_add( &n_errors, 1u );
+
+                page[0] = tid;
+                pages.push_back( page );
+            }
+
+            // check nobody scribbled over our pages
+            for (uint32 i = 0; i < pages.size(); ++i)
+            {
+                if (pages[i][0] != tid)
+                    host_atomic_add( &n_errors, 1u );
+            }
+
+            // and release them in a shuffled order
+            while (pages.size())
+            {
+                const uint32 i = (seed = seed * 1103515245u + 12345u) % uint32( pages.size() );
+                word_type* page = pages[i];
+                pages[i] = pages.back();
+                pages.pop_back();
+
+                host_atomic_cas( &owners[ page_id( page ) ], tid+1u, 0u );
+                text.release_page( page );
+            }
+        }
+    }
+    return n_errors;
+}
+
+} // anonymous namespace
+
+int paged_text_test()
+{
+    log_info(stderr, "paged text test... started\n");
+
+    const uint32 PAGE_SIZE = 4096u;
+    const uint32 N_ROUNDS  = 2000u;
+    const uint32 n_threads = omp_get_max_threads();
+    const uint32 n_pages   = 16u * n_threads;
+
+    paged_text_type text( PAGE_SIZE, PAGE_SIZE * n_pages );
+    text.grow();
+
+    // each page cache must sit on its own cache line
+    if (sizeof(paged_text_type::PageCache) != 64u || size_t( text.m_caches ) % 64u)
+    {
+        log_error(stderr, "  page caches not aligned to 64-byte lines\n");
+        exit(1);
+    }
+
+    if (text.free_page_count() != n_pages)
+    {
+        log_error(stderr, "  expected %u free pages, got %u\n", n_pages, text.free_page_count());
+        exit(1);
+    }
+
+    const uint32 n_errors = stress_page_pool( text, n_pages, N_ROUNDS );
+    if (n_errors)
+    {
+        log_error(stderr, "  %u pages handed out twice or overwritten\n", n_errors);
+        exit(1);
+    }
+
+    // all pages must be back in the pool
+    if (text.free_page_count() != n_pages)
+    {
+        log_error(stderr, "  lost %u pages\n", n_pages - text.free_page_count());
+        exit(1);
+    }
+
+    // and draining it from a single thread must return each of them exactly once
+    std::vector<uint32>     seen( n_pages, 0u );
+    std::vector<word_type*> pages( n_pages );
+    for (uint32 i = 0; i < n_pages; ++i)
+    {
+        pages[i] = text.alloc_page();
+
+        const uint32 id = page_id( pages[i] );
+        if (id >= n_pages || seen[id]++)
+        {
+            log_error(stderr, "  page %u handed out twice\n", id);
+            exit(1);
+        }
+    }
+    for (uint32 i = 0; i < n_pages; ++i)
+        text.release_page( pages[i] );
+
+    log_info(stderr, "paged text test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
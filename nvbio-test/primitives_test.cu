@@ -0,0 +1,253 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// primitives_test.cu
+//
+
+#include <nvbio/basic/timer.h>
+#include <nvbio/basic/console.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/basic/primitives.h>
+#include <nvbio/basic/vector.h>
+#include <nvbio/basic/omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+
+namespace nvbio {
+
+namespace {
+
+struct is_odd_functor
+{
+    typedef uint32 argument_type;
+    typedef bool   result_type;
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    bool operator() (const uint32 x) const { return (x & 1u) != 0u; }
+};
+
+} // anonymous namespace
+
+// test the host primitives on inputs large enough to trigger the OpenMP backend,
+// checking them against straightforward serial implementations
+//
+int primitives_test(int argc, char* argv[])
+{
+    uint32 N = 4*1024*1024;
+
+    for (int i = 0; i < argc; ++i)
+    {
+        if (strcmp( argv[i], "-size" ) == 0)
+            N = atoi( argv[++i] )*1024;
+    }
+
+    log_info(stderr, "primitives test... started (%u items)\n", N);
+
+    omp_set_num_threads( omp_get_num_procs() );
+    log_verbose(stderr, "  cpu: %u threads\n", omp_get_num_procs() );
+
+    nvbio::vector<host_tag,uint8>  temp_storage;
+    nvbio::vector<host_tag,uint32> h_keys( N );
+    nvbio::vector<host_tag,uint32> h_values( N );
+    nvbio::vector<host_tag,uint32> h_out( N );
+    nvbio::vector<host_tag,uint32> h_counts( N );
+
+    // generate keys with many repeats
+    for (uint32 i = 0; i < N; ++i)
+    {
+        h_keys[i]   = uint32( rand() ) & 1023u;
+        h_values[i] = i;
+    }
+
+    // reduce
+    {
+        uint32 ref = 0;
+        for (uint32 i = 0; i < N; ++i)
+            ref = nvbio::max( ref, h_keys[i] );
+
+        const uint32 r = nvbio::reduce<host_tag>( N, h_keys.begin(), max_functor(), temp_storage );
+        if (r != ref)
+        {
+            log_error(stderr, "  reduce: %u != %u\n", r, ref);
+            exit(1);
+        }
+    }
+
+    // reduce with an initial value, accumulating in its (wider) type
+    {
+        uint64 ref = 1ull << 40;
+        for (uint32 i = 0; i < N; ++i)
+            ref += h_keys[i];
+
+        const uint64 r = omp::reduce( N, h_keys.begin(), add_functor(), uint64(1ull << 40), temp_storage );
+        if (r != ref)
+        {
+            log_error(stderr, "  omp::reduce: %llu != %llu\n", r, ref);
+            exit(1);
+        }
+    }
+
+    // inclusive & exclusive scans
+    {
+        nvbio::inclusive_scan<host_tag>( N, h_keys.begin(), h_out.begin(), add_functor(), temp_storage );
+
+        uint32 sum = 0;
+        for (uint32 i = 0; i < N; ++i)
+        {
+            sum += h_keys[i];
+            if (h_out[i] != sum)
+            {
+                log_error(stderr, "  inclusive_scan: mismatch at %u: %u != %u\n", i, h_out[i], sum);
+                exit(1);
+            }
+        }
+
+        nvbio::exclusive_scan<host_tag>( N, h_keys.begin(), h_out.begin(), add_functor(), 0u, temp_storage );
+
+        sum = 0;
+        for (uint32 i = 0; i < N; ++i)
+        {
+            if (h_out[i] != sum)
+            {
+                log_error(stderr, "  exclusive_scan: mismatch at %u: %u != %u\n", i, h_out[i], sum);
+                exit(1);
+            }
+            sum += h_keys[i];
+        }
+    }
+
+    // copy_if
+    {
+        const uint32 n_copied = nvbio::copy_if<host_tag>( N, h_keys.begin(), h_out.begin(), is_odd_functor(), temp_storage );
+
+        uint32 j = 0;
+        for (uint32 i = 0; i < N; ++i)
+        {
+            if ((h_keys[i] & 1u) == 0u)
+                continue;
+
+            if (j >= n_copied || h_out[j] != h_keys[i])
+            {
+                log_error(stderr, "  copy_if: mismatch at %u\n", j);
+                exit(1);
+            }
+            ++j;
+        }
+        if (j != n_copied)
+        {
+            log_error(stderr, "  copy_if: wrong count %u != %u\n", n_copied, j);
+            exit(1);
+        }
+    }
+
+    // radix sort by key
+    {
+        nvbio::vector<host_tag,uint32> h_sorted_keys( h_keys );
+        nvbio::vector<host_tag,uint32> h_sorted_values( h_values );
+
+        Timer timer;
+        timer.start();
+
+        nvbio::radix_sort<host_tag>( N, h_sorted_keys.begin(), h_sorted_values.begin(), temp_storage );
+
+        timer.stop();
+        log_verbose(stderr, "  radix_sort: %.1f M keys/s\n", 1.0e-6f * float(N)/timer.seconds());
+
+        for (uint32 i = 1; i < N; ++i)
+        {
+            // check the keys are sorted, and that equal keys preserved their order
+            if ( h_sorted_keys[i-1] >  h_sorted_keys[i] ||
+                (h_sorted_keys[i-1] == h_sorted_keys[i] && h_sorted_values[i-1] > h_sorted_values[i]))
+            {
+                log_error(stderr, "  radix_sort: mismatch at %u\n", i);
+                exit(1);
+            }
+        }
+        for (uint32 i = 0; i < N; ++i)
+        {
+            if (h_keys[ h_sorted_values[i] ] != h_sorted_keys[i])
+            {
+                log_error(stderr, "  radix_sort: values not permuted at %u\n", i);
+                exit(1);
+            }
+        }
+
+        // run-length encode & reduce by key
+        const uint32 n_runs = nvbio::runlength_encode<host_tag>( N, h_sorted_keys.begin(), h_out.begin(), h_counts.begin(), temp_storage );
+
+        uint32 n_ref_runs = 0;
+        for (uint32 i = 0; i < N; ++n_ref_runs)
+        {
+            uint32 j = i;
+            while (j < N && h_sorted_keys[j] == h_sorted_keys[i])
+                ++j;
+
+            if (n_ref_runs >= n_runs || h_out[n_ref_runs] != h_sorted_keys[i] || h_counts[n_ref_runs] != j - i)
+            {
+                log_error(stderr, "  runlength_encode: mismatch at run %u\n", n_ref_runs);
+                exit(1);
+            }
+            i = j;
+        }
+        if (n_ref_runs != n_runs)
+        {
+            log_error(stderr, "  runlength_encode: wrong count %u != %u\n", n_runs, n_ref_runs);
+            exit(1);
+        }
+
+        const nvbio::vector<host_tag,uint32> h_run_counts( h_counts );
+
+        const uint32 n_segments = nvbio::reduce_by_key<host_tag>(
+            N,
+            h_sorted_keys.begin(),
+            thrust::make_constant_iterator<uint32>( 2u ),
+            h_out.begin(),
+            h_counts.begin(),
+            add_functor(),
+            temp_storage );
+
+        if (n_segments != n_runs)
+        {
+            log_error(stderr, "  reduce_by_key: wrong count %u != %u\n", n_segments, n_runs);
+            exit(1);
+        }
+        for (uint32 i = 0; i < n_segments; ++i)
+        {
+            if (h_counts[i] != 2u * h_run_counts[i])
+            {
+                log_error(stderr, "  reduce_by_key: mismatch at segment %u: %u != %u\n", i, h_counts[i], 2u * h_run_counts[i]);
+                exit(1);
+            }
+        }
+    }
+
+    log_info(stderr, "primitives test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
@@ -0,0 +1,321 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// priority_queue_test.cpp
+//
+
+#include <nvbio/basic/small_heap.h>
+#include <nvbio/basic/priority_queue.h>
+#include <nvbio/basic/priority_deque.h>
+#include <nvbio/basic/vector_view.h>
+#include <nvbio/alignment/sink.h>
+#include <nvbio/basic/console.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace nvbio {
+
+namespace {
+
+// a key tagged with its insertion order, compared by key only, so as to tell ties apart
+//
+struct tagged_key
+{
+    uint32 key;
+    uint32 id;
+};
+
+struct tagged_key_less
+{
+    bool operator() (const tagged_key a, const tagged_key b) const { return a.key < b.key; }
+};
+
+struct tagged_key_greater
+{
+    bool operator() (const tagged_key a, const tagged_key b) const { return a.key > b.key; }
+};
+
+// the reference best-N list: sorted by decreasing key, with the most recent key first among ties
+//
+void ref_push(std::vector<tagged_key>& ref, const uint32 capacity, const tagged_key key)
+{
+    ref.insert( ref.begin(), key );
+    std::stable_sort( ref.begin(), ref.end(), tagged_key_greater() );
+    if (ref.size() > capacity)
+        ref.resize( capacity );
+}
+
+// check a small_heap of tagged keys against its reference list, tie-breaking order included
+//
+template <uint32 N>
+void check_small_heap(const char* what, const small_heap<tagged_key,N,tagged_key_less>& heap, const std::vector<tagged_key>& ref)
+{
+    bool ok = (heap.size() == ref.size());
+    for (uint32 i = 0; ok && i < heap.size(); ++i)
+        ok = (heap[i].key == ref[i].key && heap[i].id == ref[i].id);
+
+    if (ok == false)
+    {
+        log_error(stderr, "  small_heap<%u>: %s mismatch\n", N, what);
+        exit(1);
+    }
+}
+
+// random keys in a small range, so that there are plenty of ties
+//
+tagged_key random_key(uint32& id)
+{
+    tagged_key key;
+    key.key = rand() % 16;
+    key.id  = id++;
+    return key;
+}
+
+template <uint32 N, uint32 M>
+void test_small_heap()
+{
+    uint32 id = 0;
+
+    for (uint32 test = 0; test < 1000; ++test)
+    {
+        small_heap<tagged_key,N,tagged_key_less> heap;
+        std::vector<tagged_key>                  ref;
+
+        // push a few keys one by one
+        const uint32 n_keys = rand() % (2*N + 1);
+        for (uint32 i = 0; i < n_keys; ++i)
+        {
+            const tagged_key key = random_key( id );
+            heap.push( key );
+            ref_push( ref, N, key );
+        }
+        check_small_heap( "push", heap, ref );
+
+        // and a range of keys
+        std::vector<tagged_key> keys( rand() % (2*N + 1) );
+        for (uint32 i = 0; i < keys.size(); ++i)
+        {
+            keys[i] = random_key( id );
+            ref_push( ref, N, keys[i] );
+        }
+        if (keys.size())
+            heap.push( &keys[0], &keys[0] + keys.size() );
+
+        check_small_heap( "push(first,last)", heap, ref );
+
+        // merge a queue of a different capacity, whose keys count as the most recent ones
+        small_heap<tagged_key,M,tagged_key_less> other;
+        std::vector<tagged_key>                  other_ref;
+
+        const uint32 n_other = rand() % (2*M + 1);
+        for (uint32 i = 0; i < n_other; ++i)
+        {
+            const tagged_key key = random_key( id );
+            other.push( key );
+            ref_push( other_ref, M, key );
+        }
+        for (uint32 i = 0; i < other_ref.size(); ++i)
+            ref_push( ref, N, other_ref[i] );
+
+        heap.merge( other );
+        check_small_heap( "merge", heap, ref );
+
+        // pop from both ends
+        if (heap.size())
+        {
+            heap.pop();
+            ref.erase( ref.begin() );
+            check_small_heap( "pop", heap, ref );
+        }
+        if (heap.size())
+        {
+            heap.pop_bottom();
+            ref.pop_back();
+            check_small_heap( "pop_bottom", heap, ref );
+        }
+    }
+}
+
+// check a max-queue by popping all of its elements against a sorted reference
+//
+template <typename queue_type>
+void check_queue(const char* what, queue_type& queue, std::vector<uint32> ref)
+{
+    std::sort( ref.begin(), ref.end(), std::greater<uint32>() );
+
+    if (queue.size() != ref.size())
+    {
+        log_error(stderr, "  %s: size %u, expected %u\n", what, uint32( queue.size() ), uint32( ref.size() ));
+        exit(1);
+    }
+    for (uint32 i = 0; i < ref.size(); ++i)
+    {
+        if (queue.top() != ref[i])
+        {
+            log_error(stderr, "  %s: element %u is %u, expected %u\n", what, i, uint32( queue.top() ), ref[i]);
+            exit(1);
+        }
+        queue.pop();
+    }
+}
+
+void test_priority_queue()
+{
+    typedef vector_view<uint32*>                                    vector_type;
+    typedef priority_queue<uint32, vector_type, std::less<uint32> > queue_type;
+
+    std::vector<uint32> storage( 256 );
+
+    for (uint32 test = 0; test < 1000; ++test)
+    {
+        queue_type          queue( vector_type( 0u, &storage[0] ) );
+        std::vector<uint32> ref;
+
+        const uint32 n_keys = rand() % 40;
+        for (uint32 i = 0; i < n_keys; ++i)
+        {
+            const uint32 key = rand() % 32;
+            queue.push( key );
+            ref.push_back( key );
+        }
+
+        // alternate ranges smaller than the queue, which are sifted up one by one,
+        // and at least as large, which trigger the Floyd rebuild
+        const uint32 n_range = (test & 1) ?
+            rand() % (n_keys + 1) :
+            n_keys + rand() % 40;
+
+        std::vector<uint32> keys( n_range );
+        for (uint32 i = 0; i < n_range; ++i)
+            keys[i] = rand() % 32;
+
+        queue.push( keys.begin(), keys.end() );
+        ref.insert( ref.end(), keys.begin(), keys.end() );
+
+        check_queue( (n_range < n_keys) ? "priority_queue::push(first,last)" : "priority_queue::push(first,last) rebuild", queue, ref );
+    }
+}
+
+void test_priority_deque()
+{
+    typedef priority_deque<uint32> deque_type;
+
+    for (uint32 test = 0; test < 1000; ++test)
+    {
+        deque_type          deque;
+        std::vector<uint32> ref;
+
+        const uint32 n_keys = rand() % 40;
+        for (uint32 i = 0; i < n_keys; ++i)
+        {
+            const uint32 key = rand() % 32;
+            deque.push( key );
+            ref.push_back( key );
+        }
+
+        // push a short range, sifted up one element at a time, or a long one, triggering a rebuild
+        std::vector<uint32> keys( (test & 1) ? rand() % 3 : rand() % 80 );
+        for (uint32 i = 0; i < keys.size(); ++i)
+            keys[i] = rand() % 32;
+
+        deque.push( keys.begin(), keys.end() );
+        ref.insert( ref.end(), keys.begin(), keys.end() );
+
+        // keep the top k elements, with k ranging from 0 to more than the current size,
+        // so as to exercise the initial pruning of the deque
+        std::vector<uint32> top_keys( rand() % 40 );
+        for (uint32 i = 0; i < top_keys.size(); ++i)
+            top_keys[i] = rand() % 32;
+
+        const uint32 k = (test % 7 == 0) ? 0u : rand() % (uint32( ref.size() ) + 8u);
+
+        deque.push_top( top_keys.begin(), top_keys.end(), k );
+        ref.insert( ref.end(), top_keys.begin(), top_keys.end() );
+
+        std::sort( ref.begin(), ref.end(), std::greater<uint32>() );
+        ref.resize( nvbio::min( uint32( ref.size() ), k ) );
+
+        check_queue( "priority_deque::push_top", deque, ref );
+    }
+}
+
+void test_best_n_sink()
+{
+    const uint32 N = 4;
+
+    for (uint32 test = 0; test < 1000; ++test)
+    {
+        aln::BestNSink<int32,N> sink;
+        std::vector<tagged_key> ref;
+
+        // report alignments with few distinct scores, tagging each with its end column
+        const uint32 n_reports = rand() % 12;
+        for (uint32 i = 0; i < n_reports; ++i)
+        {
+            tagged_key key;
+            key.key = rand() % 6;
+            key.id  = i;
+
+            sink.report( int32( key.key ), make_uint2( key.id, 0u ) );
+            ref_push( ref, N, key );
+        }
+
+        bool ok = (sink.size() == ref.size());
+        for (uint32 i = 0; ok && i < sink.size(); ++i)
+            ok = (sink.score(i) == int32( ref[i].key ) && sink.sink(i).x == ref[i].id);
+
+        if (ok == false)
+        {
+            log_error(stderr, "  BestNSink mismatch\n");
+            exit(1);
+        }
+    }
+}
+
+} // anonymous namespace
+
+int priority_queue_test()
+{
+    log_info(stderr, "priority queue test... started\n");
+
+    srand(70);
+
+    test_small_heap<1,3>();
+    test_small_heap<5,3>();
+    test_small_heap<4,8>();
+    test_priority_queue();
+    test_priority_deque();
+    test_best_n_sink();
+
+    log_info(stderr, "priority queue test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
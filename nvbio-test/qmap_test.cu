@@ -0,0 +1,343 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+// qmap_test.cu
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <algorithm>
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/console.h>
+#include <nvbio/basic/dna.h>
+#include <nvbio/basic/vector.h>
+#include <nvbio/basic/shared_pointer.h>
+#include <nvbio/strings/seeds.h>
+#include <nvbio/io/sequence/sequence.h>
+#include <nvbio/io/sequence/sequence_access.h>
+#include <nvbio/io/sequence/sequence_encoder.h>
+#include <nvbio/qgram/qgram.h>
+#include <nvbio/qgram/qmap.h>
+
+namespace nvbio {
+
+namespace {
+
+// encode a segment of a 2-bit genome as a single-sequence chunk
+//
+void encode_chunk(const std::vector<uint8>& genome, const uint32 begin, const uint32 end, io::SequenceDataHost* chunk)
+{
+    const uint32 len = end - begin;
+
+    std::vector<uint8> bps( len );
+    std::vector<uint8> quals( len, uint8('~') );
+    for (uint32 i = 0; i < len; ++i)
+        bps[i] = uint8( dna_to_char( genome[ begin + i ] ) );
+
+    SharedPointer<io::SequenceDataEncoder> encoder( io::create_encoder( DNA, chunk ) );
+    encoder->begin_batch();
+    encoder->push_back(
+        len,
+        "chunk",
+        &bps[0],
+        &quals[0],
+        io::Phred33,
+        uint32(-1),
+        0u,
+        0u,
+        io::SequenceDataEncoder::NO_OP );
+    encoder->end_batch();
+}
+
+// check that two q-gram set-indices have the same contents; the occurrences of each q-gram
+// are compared as sets, as their order within a slot depends on the sorting algorithm
+//
+void check_qgram_set_index(const QGramSetIndexHost& h_index, const QGramSetIndexHost& d_index)
+{
+    if (h_index.Q               != d_index.Q               ||
+        h_index.symbol_size     != d_index.symbol_size     ||
+        h_index.n_qgrams        != d_index.n_qgrams        ||
+        h_index.n_unique_qgrams != d_index.n_unique_qgrams ||
+        h_index.QL              != d_index.QL              ||
+        h_index.QLS             != d_index.QLS)
+    {
+        log_error(stderr, "  q-gram set-index mismatch: host (Q %u, n_qgrams %u, unique %u, QL %u), device (Q %u, n_qgrams %u, unique %u, QL %u)\n",
+            h_index.Q, h_index.n_qgrams, h_index.n_unique_qgrams, h_index.QL,
+            d_index.Q, d_index.n_qgrams, d_index.n_unique_qgrams, d_index.QL);
+        exit(1);
+    }
+
+    for (uint32 i = 0; i < h_index.n_unique_qgrams; ++i)
+    {
+        if (h_index.qgrams[i] != d_index.qgrams[i])
+        {
+            log_error(stderr, "  q-gram set-index mismatch at q-gram %u\n", i);
+            exit(1);
+        }
+    }
+    for (uint32 i = 0; i <= h_index.n_unique_qgrams; ++i)
+    {
+        if (h_index.slots[i] != d_index.slots[i])
+        {
+            log_error(stderr, "  q-gram set-index mismatch at slot %u: host %u, device %u\n", i, h_index.slots[i], d_index.slots[i]);
+            exit(1);
+        }
+    }
+    if (h_index.lut.size() != d_index.lut.size())
+    {
+        log_error(stderr, "  q-gram set-index LUT size mismatch: host %u, device %u\n", uint32( h_index.lut.size() ), uint32( d_index.lut.size() ));
+        exit(1);
+    }
+    for (uint32 i = 0; i < uint32( h_index.lut.size() ); ++i)
+    {
+        if (h_index.lut[i] != d_index.lut[i])
+        {
+            log_error(stderr, "  q-gram set-index LUT mismatch at %u: host %u, device %u\n", i, h_index.lut[i], d_index.lut[i]);
+            exit(1);
+        }
+    }
+
+    for (uint32 i = 0; i < h_index.n_unique_qgrams; ++i)
+    {
+        std::vector<uint64> h_occ;
+        std::vector<uint64> d_occ;
+        for (uint32 j = h_index.slots[i]; j < h_index.slots[i+1]; ++j)
+        {
+            const uint2 h_coord = h_index.index[j];
+            const uint2 d_coord = d_index.index[j];
+            h_occ.push_back( (uint64( h_coord.x ) << 32) | h_coord.y );
+            d_occ.push_back( (uint64( d_coord.x ) << 32) | d_coord.y );
+        }
+        std::sort( h_occ.begin(), h_occ.end() );
+        std::sort( d_occ.begin(), d_occ.end() );
+
+        if (h_occ != d_occ)
+        {
+            log_error(stderr, "  q-gram set-index mismatch in the occurrences of q-gram %u\n", i);
+            exit(1);
+        }
+    }
+}
+
+} // anonymous namespace
+
+int qmap_test()
+{
+    log_info(stderr, "qmap test... started\n");
+
+    const uint32 GENOME_LEN  = 40*1024;
+    const uint32 N_CHUNKS    = 3;
+    const uint32 N_READS     = 64;
+    const uint32 N_CROSSING  = 8;
+    const uint32 N_RANDOM    = 4;
+    const uint32 N_MAPPED    = N_READS + N_CROSSING;
+    const uint32 READ_LEN    = 60;
+
+    const char* reads_name = "./qmap_test.txt";
+
+    // build a random genome
+    std::vector<uint8> genome( GENOME_LEN );
+
+    srand( 13 );
+    for (uint32 i = 0; i < GENOME_LEN; ++i)
+        genome[i] = uint8( rand() & 3 );
+
+    // split it in chunks of uneven size
+    const uint32 chunk_begin[N_CHUNKS+1] = { 0u, 11*1024 + 7, 29*1024 + 3, GENOME_LEN };
+
+    // write a set of reads sampled from the genome away from the chunk boundaries, a few more
+    // crossing them, half of them reverse-complemented, and a few random ones which shouldn't map at all
+    std::vector<uint32> read_pos( N_MAPPED );
+    std::vector<uint32> read_strand( N_MAPPED );
+    {
+        FILE* file = fopen( reads_name, "w" );
+        if (file == NULL)
+        {
+            log_error(stderr, "  unable to create \"%s\"\n", reads_name);
+            exit(1);
+        }
+
+        char read[READ_LEN+1];
+        for (uint32 i = 0; i < N_MAPPED + N_RANDOM; ++i)
+        {
+            if (i < N_MAPPED)
+            {
+                const uint32 k   = i < N_READS ? i % N_CHUNKS : 1u + i % (N_CHUNKS-1);
+                const uint32 pos = i < N_READS ?
+                    chunk_begin[k] + rand() % (chunk_begin[k+1] - chunk_begin[k] - READ_LEN) :
+                    chunk_begin[k] - 1u - rand() % (READ_LEN-1);
+
+                read_pos[i]    = pos;
+                read_strand[i] = i & 1u;
+
+                for (uint32 j = 0; j < READ_LEN; ++j)
+                {
+                    const uint8 c = read_strand[i] ?
+                        uint8( 3u - genome[ pos + READ_LEN-1-j ] ) :
+                        genome[ pos + j ];
+
+                    read[j] = dna_to_char( c );
+                }
+            }
+            else
+            {
+                for (uint32 j = 0; j < READ_LEN; ++j)
+                    read[j] = dna_to_char( uint8( rand() & 3 ) );
+            }
+            read[READ_LEN] = '\0';
+
+            fprintf( file, "%s\n", read );
+        }
+        fclose( file );
+    }
+
+    io::SequenceDataHost reads;
+    {
+        SharedPointer<io::SequenceDataStream> read_file( io::open_sequence_file(
+            reads_name,
+            io::Phred33,
+            2*(N_MAPPED + N_RANDOM),
+            uint32(-1),
+            io::SequenceEncoding( io::FORWARD | io::REVERSE_COMPLEMENT ) ) );
+
+        if (read_file == NULL || read_file->is_ok() == false ||
+            io::next( DNA_N, &reads, read_file.get(), 2*(N_MAPPED + N_RANDOM), uint32(-1) ) != int( 2*(N_MAPPED + N_RANDOM) ))
+        {
+            log_error(stderr, "  unable to load \"%s\"\n", reads_name);
+            exit(1);
+        }
+    }
+    remove( reads_name );
+
+    QMapParams params;
+    params.slice_len       = 1000;
+    params.hits_batch_size = 50;
+
+    // build the q-gram set-index of the reads on the host and on the device, with the same
+    // parameters used by the mapper, and check they match
+    {
+        typedef io::SequenceDataAccess<DNA_N> read_access_type;
+
+        const io::SequenceDataDevice d_reads( reads );
+        const read_access_type       h_read_access( reads );
+        const read_access_type       d_read_access( d_reads );
+
+        QGramSetIndexHost h_qgram_index;
+        h_qgram_index.build(
+            params.Q,
+            2u,
+            h_read_access.sequence_string_set(),
+            uniform_seeds_functor<>( params.Q, params.Q_intv ),
+            12u );
+
+        QGramSetIndexDevice d_qgram_index;
+        d_qgram_index.build(
+            params.Q,
+            2u,
+            d_read_access.sequence_string_set(),
+            uniform_seeds_functor<>( params.Q, params.Q_intv ),
+            12u );
+
+        QGramSetIndexHost d_qgram_index_copy;
+        d_qgram_index_copy = d_qgram_index;
+
+        const uint32 n_seeds = 2*(N_MAPPED + N_RANDOM) * ((READ_LEN - params.Q) / params.Q_intv + 1u);
+        if (h_qgram_index.n_qgrams != n_seeds)
+        {
+            log_error(stderr, "  expected %u indexed q-grams, got %u\n", n_seeds, h_qgram_index.n_qgrams);
+            exit(1);
+        }
+
+        check_qgram_set_index( h_qgram_index, d_qgram_index_copy );
+    }
+
+    // map the reads streaming the reference through the mapper one chunk at a time, extending
+    // each chunk backwards so as to overlap the previous one, as if a single sequence were split
+    QMapper<> mapper( params );
+    mapper.index( reads );
+
+    const uint32 overlap = QMapper<>::chunk_overlap( READ_LEN );
+
+    for (uint32 c = 0; c < N_CHUNKS; ++c)
+    {
+        const uint32 begin = c ? chunk_begin[c] - overlap : 0u;
+
+        io::SequenceDataHost chunk;
+        encode_chunk( genome, begin, chunk_begin[c+1], &chunk );
+
+        mapper.map( chunk, begin );
+    }
+
+    nvbio::vector<host_tag,QMapHit> best_hits;
+    mapper.best_hits( best_hits );
+
+    if (best_hits.size() != N_MAPPED + N_RANDOM)
+    {
+        log_error(stderr, "  expected %u best hits, got %u\n", N_MAPPED + N_RANDOM, uint32( best_hits.size() ));
+        exit(1);
+    }
+
+    for (uint32 i = 0; i < N_MAPPED + N_RANDOM; ++i)
+    {
+        const QMapHit hit = best_hits[i];
+
+        if (i >= N_MAPPED)
+        {
+            if (hit.is_valid())
+            {
+                log_error(stderr, "  random read %u: expected no hit, got one at %llu\n", i, hit.pos);
+                exit(1);
+            }
+            continue;
+        }
+
+        // hits are reported on the merged diagonal, i.e. up to merge_intv bps before the read start
+        if (hit.is_valid() == false ||
+            hit.score  != 0 ||
+            hit.strand != read_strand[i] ||
+            hit.pos > read_pos[i] ||
+            hit.pos + params.merge_intv <= read_pos[i])
+        {
+            log_error(stderr, "  read %u: expected an exact hit at %u on strand %u, got score %d at %llu on strand %u\n",
+                i, read_pos[i], read_strand[i], hit.score, hit.pos, hit.strand);
+            exit(1);
+        }
+    }
+
+    const uint32    n_queries = GENOME_LEN + (N_CHUNKS-1) * overlap;
+    const QMapStats stats     = mapper.stats();
+    if (stats.reads != N_MAPPED + N_RANDOM || stats.queries != n_queries)
+    {
+        log_error(stderr, "  expected %u reads and %u queries, got %llu and %llu\n", N_MAPPED + N_RANDOM, n_queries, stats.reads, stats.queries);
+        exit(1);
+    }
+
+    log_info(stderr, "qmap test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
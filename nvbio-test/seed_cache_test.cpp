@@ -0,0 +1,174 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// seed_cache_test.cpp
+//
+
+#include <nvbio/fmindex/seed_cache.h>
+#include <nvbio/basic/console.h>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace nvbio {
+
+namespace {
+
+typedef SeedIntervalCache<host_tag>         cache_type;
+typedef cache_type::view_type               view_type;
+typedef view_type::range_type               range_type;
+
+#define NVBIO_CACHE_CHECK(cond, msg)                    \
+    if (!(cond))                                        \
+    {                                                   \
+        log_error(stderr, "  %s\n", msg);               \
+        exit(1);                                        \
+    }
+
+// the ranges stored for the i-th test seed, spanning 'occ' occurrences
+//
+range_type fw_range(const uint32 i, const uint32 occ) { return make_uint2( i*100u, i*100u + occ - 1u ); }
+range_type rc_range(const uint32 i, const uint32 occ) { return make_uint2( i*100u + 50u, i*100u + 50u + occ - 1u ); }
+
+void test_pack_seed()
+{
+    const uint8 seed[] = { 0, 1, 2, 3, 0 };
+    const uint8 with_n[] = { 0, 1, 4, 3 };
+    uint64 key;
+
+    NVBIO_CACHE_CHECK( pack_seed( seed, 5u, &key ) && key == ((1u << 10) | 0x06Cu), "pack_seed() mismatch" );
+
+    // the sentinel bit tells apart seeds which only differ by leading A's
+    uint64 key4;
+    NVBIO_CACHE_CHECK( pack_seed( seed + 1, 4u, &key4 ) && key4 != key, "pack_seed() collides on different lengths" );
+
+    NVBIO_CACHE_CHECK( pack_seed( with_n, 4u, &key ) == false, "pack_seed() accepted an N" );
+
+    std::vector<uint8> long_seed( 32u, 1u );
+    NVBIO_CACHE_CHECK( pack_seed( &long_seed[0], 31u, &key ) == true,  "pack_seed() rejected a 31-mer" );
+    NVBIO_CACHE_CHECK( pack_seed( &long_seed[0], 32u, &key ) == false, "pack_seed() accepted a 32-mer" );
+}
+
+void test_insert_find()
+{
+    const uint32 MIN_OCC = 4u;
+    const uint32 N_SEEDS = 64u;
+
+    cache_type cache;
+    cache.resize( 100u, MIN_OCC, true );
+    NVBIO_CACHE_CHECK( cache.size() == 64u, "resize() did not round down to a power of 2" );
+
+    const view_type view = plain_view( cache );
+
+    range_type f, r;
+    NVBIO_CACHE_CHECK( view.find( 12345u, &f, &r ) == false, "an empty cache returned a hit" );
+
+    // seeds with too few occurrences are not worth caching
+    NVBIO_CACHE_CHECK( view.insert( 12345u, fw_range(1,MIN_OCC-1), rc_range(1,MIN_OCC-1) ) == false, "cached a rare seed" );
+    NVBIO_CACHE_CHECK( view.find( 12345u, &f, &r ) == false, "found a rare seed" );
+
+    // one frequent strand is enough
+    NVBIO_CACHE_CHECK( view.insert( 12345u, fw_range(1,1), rc_range(1,MIN_OCC) ), "insert() failed" );
+    NVBIO_CACHE_CHECK( view.find( 12345u, &f, &r ) &&
+                       f.x == fw_range(1,1).x && f.y == fw_range(1,1).y &&
+                       r.x == rc_range(1,MIN_OCC).x && r.y == rc_range(1,MIN_OCC).y, "find() returned the wrong ranges" );
+
+    // inserting a seed twice keeps the original entry
+    NVBIO_CACHE_CHECK( view.insert( 12345u, fw_range(2,MIN_OCC), rc_range(2,MIN_OCC) ), "re-insert() failed" );
+    NVBIO_CACHE_CHECK( view.find( 12345u, &f, &r ) && f.x == fw_range(1,1).x, "re-insert() replaced the entry" );
+
+    cache.clear();
+    NVBIO_CACHE_CHECK( cache.lookups() == 0u && cache.hits() == 0u, "clear() did not reset the statistics" );
+    NVBIO_CACHE_CHECK( view.find( 12345u, &f, &r ) == false, "clear() did not drop the cached seeds" );
+    NVBIO_CACHE_CHECK( cache.lookups() == 1u && cache.hits() == 0u, "a miss was not counted" );
+
+    // overfill the cache: once the probe sequences are full, insertions must fail,
+    // while all the seeds which made it in must still be found with their own ranges
+    std::vector<bool> inserted( N_SEEDS * 2u );
+    uint32 n_inserted = 0u;
+    for (uint32 i = 0; i < N_SEEDS * 2u; ++i)
+    {
+        inserted[i] = view.insert( i+1u, fw_range(i,MIN_OCC), rc_range(i,MIN_OCC+i) );
+        n_inserted += inserted[i] ? 1u : 0u;
+    }
+    NVBIO_CACHE_CHECK( n_inserted >= view_type::MAX_PROBES, "too few insertions succeeded" );
+    NVBIO_CACHE_CHECK( n_inserted <= cache.size(),          "more insertions than slots" );
+    NVBIO_CACHE_CHECK( cache.counter( view_type::INSERTS ) == n_inserted,               "wrong insertion count" );
+    NVBIO_CACHE_CHECK( cache.counter( view_type::FAILED )  == N_SEEDS*2u - n_inserted,  "wrong failed insertion count" );
+
+    uint32 n_hits = 0u;
+    for (uint32 i = 0; i < N_SEEDS * 2u; ++i)
+    {
+        const bool hit = view.find( i+1u, &f, &r );
+        NVBIO_CACHE_CHECK( hit == inserted[i], "find() disagrees with insert()" );
+        if (hit)
+        {
+            NVBIO_CACHE_CHECK( f.x == fw_range(i,MIN_OCC).x   && f.y == fw_range(i,MIN_OCC).y &&
+                               r.x == rc_range(i,MIN_OCC+i).x && r.y == rc_range(i,MIN_OCC+i).y, "find() returned another seed's ranges" );
+            ++n_hits;
+        }
+    }
+    NVBIO_CACHE_CHECK( cache.lookups() == N_SEEDS*2u + 1u && cache.hits() == n_hits, "wrong lookup statistics" );
+}
+
+void test_no_stats()
+{
+    // without statistics the cache must work just the same
+    cache_type cache;
+    cache.resize( 16u, 1u );
+    NVBIO_CACHE_CHECK( cache.has_stats() == false, "statistics enabled by default" );
+
+    const view_type view = plain_view( cache );
+
+    range_type f, r;
+    NVBIO_CACHE_CHECK( view.insert( 7u, fw_range(3,2), rc_range(3,2) ), "insert() failed" );
+    NVBIO_CACHE_CHECK( view.find( 7u, &f, &r ) && f.x == fw_range(3,2).x, "find() failed" );
+    NVBIO_CACHE_CHECK( cache.lookups() == 0u && cache.hit_rate() == 0.0f, "statistics counted while disabled" );
+
+    // and a disabled cache always misses
+    cache.resize( 0u, 1u );
+    NVBIO_CACHE_CHECK( plain_view( cache ).insert( 7u, fw_range(3,2), rc_range(3,2) ) == false, "a disabled cache accepted a seed" );
+    NVBIO_CACHE_CHECK( plain_view( cache ).find( 7u, &f, &r ) == false,                         "a disabled cache returned a hit" );
+}
+
+#undef NVBIO_CACHE_CHECK
+
+} // anonymous namespace
+
+int seed_cache_test()
+{
+    log_info(stderr, "seed cache test... started\n");
+
+    test_pack_seed();
+    test_insert_find();
+    test_no_stats();
+
+    log_info(stderr, "seed cache test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
@@ -0,0 +1,320 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// packed_mmap_test.cpp
+// sequence_dedup_test.cpp
+//
+
+#include <nvbio/io/sequence/sequence_dedup.h>
+#include <nvbio/io/sequence/sequence_encoder.h>
+#include <nvbio/io/sequence/sequence_access.h>
+#include <nvbio/io/output/output_priv.h>
+#include <nvbio/strings/alphabet.h>
+#include <nvbio/basic/shared_pointer.h>
+#include <nvbio/basic/exceptions.h>
+#include <nvbio/basic/console.h>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace nvbio {
+
+namespace {
+
+struct TestRead
+{
+    const char* name;
+    const char* bps;
+    const char* quals;
+};
+
+// the test batch: exact duplicates, a read differing from another only in its qualities,
+// and a reverse complement, which is not considered a duplicate
+//
+const TestRead s_reads[] = {
+    { "r0", "ACGTTGCA", "IIIIIIII" },
+    { "r1", "GGATCCAA", "IIIIIIII" },
+    { "r2", "ACGTTGCA", "IIIIIIII" },   // duplicate of r0
+    { "r3", "ACGTTGCA", "IIIII###" },   // same bases as r0, different qualities
+    { "r4", "TGCAACGT", "IIIIIIII" },   // reverse complement of r0
+    { "r5", "GGATCCAA", "IIIIIIII" },   // duplicate of r1
+    { "r6", "ACGTTGCA", "IIIIIIII" },   // duplicate of r0
+    { "r7", "CCCCAAAA", "IIIIIIII" },
+};
+const uint32 N_READS = sizeof(s_reads) / sizeof(s_reads[0]);
+
+// the expected representative of each read, and the expected names of the representatives
+//
+const uint32 s_dup_map[N_READS]   = { 0u, 1u, 0u, 2u, 3u, 1u, 0u, 4u };
+const uint32 s_dup_count[]        = { 3u, 2u, 1u, 1u, 1u };
+const char*  s_unique_names[]     = { "r0", "r1", "r3", "r4", "r7" };
+const uint32 N_UNIQUE             = sizeof(s_dup_count) / sizeof(s_dup_count[0]);
+
+// encode a list of reads in a host batch, suffixing their names
+//
+void encode_reads(const TestRead* reads, const uint32 n_reads, const char* suffix, io::SequenceDataHost* batch)
+{
+    SharedPointer<io::SequenceDataEncoder> encoder( io::create_encoder( DNA_N, batch ) );
+    encoder->begin_batch();
+    for (uint32 i = 0; i < n_reads; ++i)
+    {
+        const std::string name = std::string( reads[i].name ) + suffix;
+
+        encoder->push_back(
+            uint32( strlen( reads[i].bps ) ),
+            name.c_str(),
+            (const uint8*)reads[i].bps,
+            (const uint8*)reads[i].quals,
+            io::Phred33,
+            uint32(-1),
+            0u,
+            0u,
+            io::SequenceDataEncoder::NO_OP );
+    }
+    encoder->end_batch();
+}
+
+// return the i-th sequence of a batch as a string
+//
+std::string read_bases(const io::SequenceDataHost& batch, const uint32 i)
+{
+    const io::SequenceDataAccess<DNA_N> access( batch );
+    const io::SequenceDataAccess<DNA_N>::sequence_string read = access.get_read( i );
+
+    std::string r( read.length(), ' ' );
+    for (uint32 j = 0; j < read.length(); ++j)
+        r[j] = to_char<DNA_N>( read[j] );
+    return r;
+}
+
+// return the i-th qualities of a batch as a string
+//
+std::string read_quals(const io::SequenceDataHost& batch, const uint32 i)
+{
+    const io::SequenceDataAccess<DNA_N> access( batch );
+    const uint32 begin = access.sequence_index()[i];
+    const uint32 end   = access.sequence_index()[i+1];
+    return std::string( access.qual_stream() + begin, access.qual_stream() + end );
+}
+
+// return the i-th name of a batch
+//
+const char* read_name(const io::SequenceDataHost& batch, const uint32 i)
+{
+    const io::SequenceDataAccess<DNA_N> access( batch );
+    return access.name_stream() + access.name_index()[i];
+}
+
+// check the output of a collapsing pass against the expected groups
+//
+void check_collapsed(
+    const char*                             test,
+    const uint32                            n_unique,
+    const io::SequenceDataHost&             in,
+    const io::SequenceDataHost&             out,
+    const nvbio::vector<host_tag,uint32>&   dup_map,
+    const nvbio::vector<host_tag,uint32>&   dup_count,
+    const char*                             suffix)
+{
+    if (n_unique != N_UNIQUE || out.size() != N_UNIQUE)
+    {
+        log_error(stderr, "  %s: expected %u unique reads, got %u (%u in the batch)\n", test, N_UNIQUE, n_unique, out.size());
+        exit(1);
+    }
+    if (dup_map.size() != N_READS || dup_count.size() != N_UNIQUE)
+    {
+        log_error(stderr, "  %s: wrong map sizes: %u, %u\n", test, uint32( dup_map.size() ), uint32( dup_count.size() ));
+        exit(1);
+    }
+    for (uint32 i = 0; i < N_READS; ++i)
+    {
+        if (dup_map[i] != s_dup_map[i])
+        {
+            log_error(stderr, "  %s: read %u mapped to %u, expected %u\n", test, i, uint32( dup_map[i] ), s_dup_map[i]);
+            exit(1);
+        }
+        // each read must be identical to its representative
+        if (read_bases( in, i ) != read_bases( out, dup_map[i] ) ||
+            read_quals( in, i ) != read_quals( out, dup_map[i] ))
+        {
+            log_error(stderr, "  %s: read %u differs from its representative\n", test, i);
+            exit(1);
+        }
+    }
+    for (uint32 i = 0; i < N_UNIQUE; ++i)
+    {
+        const std::string name = std::string( s_unique_names[i] ) + suffix;
+
+        if (dup_count[i] != s_dup_count[i])
+        {
+            log_error(stderr, "  %s: representative %u counts %u reads, expected %u\n", test, i, uint32( dup_count[i] ), s_dup_count[i]);
+            exit(1);
+        }
+        if (strcmp( read_name( out, i ), name.c_str() ) != 0)
+        {
+            log_error(stderr, "  %s: representative %u is \"%s\", expected \"%s\"\n", test, i, read_name( out, i ), name.c_str());
+            exit(1);
+        }
+    }
+}
+
+// collapse a single-end batch, and check that expanding one alignment per representative
+// through the output dup map gives back one record per input read
+//
+void test_collapse_se()
+{
+    io::SequenceDataHost in;
+    encode_reads( s_reads, N_READS, "", &in );
+
+    io::SequenceDataHost out;
+    nvbio::vector<host_tag,uint32> dup_map;
+    nvbio::vector<host_tag,uint32> dup_count;
+
+    const uint32 n_unique = io::collapse_duplicates( in, &out, dup_map, dup_count );
+
+    check_collapsed( "single-end", n_unique, in, out, dup_map, dup_count, "" );
+
+    // fake an alignment for each representative
+    io::HostOutputBatchSE batch;
+    batch.alignments.resize( n_unique );
+    batch.mapq.resize( n_unique );
+    batch.cigar.array.resize( n_unique, 0u );
+    batch.cigar.coords.resize( n_unique, make_uint2( 0u, 0u ) );
+    batch.mds.resize( n_unique, 0u );
+    for (uint32 i = 0; i < n_unique; ++i)
+    {
+        batch.alignments[i] = io::Alignment( 1000u * i, 0u, 0, 0u );
+        batch.mapq[i]       = uint8( 10u + i );
+    }
+    batch.read_data = &in;
+    batch.dup_map   = dup_map;
+    batch.dup_count = dup_count;
+    batch.count     = in.size();
+
+    uint32 n_records = 0;
+    for (uint32 i = 0; i < batch.count; ++i)
+    {
+        const io::AlignmentData data = io::get( batch, i );
+
+        if (data.read_id != i ||
+            data.aln_id  != s_dup_map[i] ||
+            data.aln     != &batch.alignments[ s_dup_map[i] ] ||
+            data.mapq    != 10u + s_dup_map[i])
+        {
+            log_error(stderr, "  single-end: record %u expanded to read %u, alignment %u\n", i, data.read_id, data.aln_id);
+            exit(1);
+        }
+        if (strcmp( data.read_name, s_reads[i].name ) != 0)
+        {
+            log_error(stderr, "  single-end: record %u carries name \"%s\", expected \"%s\"\n", i, data.read_name, s_reads[i].name);
+            exit(1);
+        }
+        ++n_records;
+    }
+
+    // the multiplicities of the representatives must add up to the input reads
+    uint32 n_expanded = 0;
+    for (uint32 i = 0; i < n_unique; ++i)
+        n_expanded += batch.multiplicity( i );
+
+    if (n_records != N_READS || n_expanded != N_READS)
+    {
+        log_error(stderr, "  single-end: expanded to %u records, %u by multiplicity, expected %u\n", n_records, n_expanded, N_READS);
+        exit(1);
+    }
+}
+
+// collapse a paired-end batch: a pair is a duplicate only if both of its mates are
+//
+void test_collapse_pe()
+{
+    // use the same reads for both mates, so the groups are the same as in the single-end case
+    io::SequenceDataHost in1, in2;
+    encode_reads( s_reads, N_READS, "/1", &in1 );
+    encode_reads( s_reads, N_READS, "/2", &in2 );
+
+    io::SequenceDataHost out1, out2;
+    nvbio::vector<host_tag,uint32> dup_map;
+    nvbio::vector<host_tag,uint32> dup_count;
+
+    const uint32 n_unique = io::collapse_duplicates( in1, in2, &out1, &out2, dup_map, dup_count );
+
+    check_collapsed( "paired-end mate 1", n_unique, in1, out1, dup_map, dup_count, "/1" );
+    check_collapsed( "paired-end mate 2", n_unique, in2, out2, dup_map, dup_count, "/2" );
+
+    // change the second mate of a duplicate pair: it must now stand on its own
+    TestRead reads2[N_READS];
+    for (uint32 i = 0; i < N_READS; ++i)
+        reads2[i] = s_reads[i];
+    reads2[2].bps = "CCCCAAAA";
+
+    io::SequenceDataHost in2b;
+    encode_reads( reads2, N_READS, "/2", &in2b );
+
+    const uint32 n_unique_b = io::collapse_duplicates( in1, in2b, &out1, &out2, dup_map, dup_count );
+    if (n_unique_b != N_UNIQUE + 1u || dup_map[2] == dup_map[0] || dup_count[0] != 2u)
+    {
+        log_error(stderr, "  paired-end: a pair with distinct second mates was collapsed (%u unique)\n", n_unique_b);
+        exit(1);
+    }
+
+    // mismatched batches must be rejected
+    io::SequenceDataHost in2c;
+    encode_reads( s_reads, N_READS - 1u, "/2", &in2c );
+
+    bool rejected = false;
+    try
+    {
+        io::collapse_duplicates( in1, in2c, &out1, &out2, dup_map, dup_count );
+    }
+    catch (logic_error)
+    {
+        rejected = true;
+    }
+    if (rejected == false)
+    {
+        log_error(stderr, "  paired-end: mismatched mate batches were not rejected\n");
+        exit(1);
+    }
+}
+
+} // anonymous namespace
+
+int sequence_dedup_test()
+{
+    log_info(stderr, "sequence dedup test... started\n");
+
+    test_collapse_se();
+    test_collapse_pe();
+
+    log_info(stderr, "sequence dedup test... done\n");
+    return 0;
+}
+
+} // namespace nvbio
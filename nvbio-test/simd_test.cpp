@@ -0,0 +1,140 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// simd_test.cpp
+//
+
+#include <nvbio/basic/simd.h>
+#include <nvbio/basic/console.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace nvbio {
+
+namespace {
+
+template <typename T> T lane_mask(const bool p) { return p ? T(~T(0)) : T(0); }
+
+// check all the operators of a SIMD type against their scalar counterparts,
+// lane by lane, on random inputs
+//
+template <typename simd_type>
+bool check_simd(const char* name)
+{
+    typedef typename simd_traits<simd_type>::lane_type lane_type;
+    const uint32 LANES = simd_traits<simd_type>::LANES;
+
+    for (uint32 test = 0; test < 1000; ++test)
+    {
+        lane_type a[LANES], b[LANES], m[LANES], r[LANES];
+        for (uint32 i = 0; i < LANES; ++i)
+        {
+            a[i] = lane_type( rand() );
+            b[i] = (rand() & 3) ? lane_type( rand() ) : a[i];
+            m[i] = lane_mask<lane_type>( rand() & 1 );
+        }
+
+        const simd_type va = simd_type::load( a );
+        const simd_type vb = simd_type::load( b );
+        const simd_type vm = simd_type::load( m );
+
+        #define NVBIO_SIMD_CHECK(expr, ref)                                             \
+        {                                                                               \
+            store_lanes( expr, r );                                                     \
+            for (uint32 i = 0; i < LANES; ++i)                                          \
+            {                                                                           \
+                if (r[i] != lane_type(ref))                                             \
+                {                                                                       \
+                    log_error(stderr, "  %s: %s failed at lane %u\n", name, #expr, i);  \
+                    return false;                                                       \
+                }                                                                       \
+            }                                                                           \
+        }
+
+        NVBIO_SIMD_CHECK( va == vb, lane_mask<lane_type>( a[i] == b[i] ) );
+        NVBIO_SIMD_CHECK( va != vb, lane_mask<lane_type>( a[i] != b[i] ) );
+        NVBIO_SIMD_CHECK( va >= vb, lane_mask<lane_type>( a[i] >= b[i] ) );
+        NVBIO_SIMD_CHECK( va >  vb, lane_mask<lane_type>( a[i] >  b[i] ) );
+        NVBIO_SIMD_CHECK( va <= vb, lane_mask<lane_type>( a[i] <= b[i] ) );
+        NVBIO_SIMD_CHECK( va <  vb, lane_mask<lane_type>( a[i] <  b[i] ) );
+        NVBIO_SIMD_CHECK( va + vb,  a[i] + b[i] );
+        NVBIO_SIMD_CHECK( va - vb,  a[i] - b[i] );
+        NVBIO_SIMD_CHECK( ~va,      ~a[i] );
+        NVBIO_SIMD_CHECK( max( va, vb ),  nvbio::max( a[i], b[i] ) );
+        NVBIO_SIMD_CHECK( min( va, vb ),  nvbio::min( a[i], b[i] ) );
+        NVBIO_SIMD_CHECK( adds( va, vb ), nvbio::min( uint32( a[i] ) + uint32( b[i] ), uint32( lane_type(~lane_type(0)) ) ) );
+        NVBIO_SIMD_CHECK( subs( va, vb ), a[i] > b[i] ? a[i] - b[i] : 0u );
+        NVBIO_SIMD_CHECK( ternary_op( vm, va, vb ), m[i] ? a[i] : b[i] );
+        NVBIO_SIMD_CHECK( simd_type( a[1] ), a[1] );
+
+        #undef NVBIO_SIMD_CHECK
+
+        if (get<1>( va ) != a[1] || get<LANES-1>( va ) != a[LANES-1])
+        {
+            log_error(stderr, "  %s: get() failed\n", name);
+            return false;
+        }
+
+        simd_type c = va;
+        set<0>( c, b[0] );
+        if (get<0>( c ) != b[0] || get<1>( c ) != a[1])
+        {
+            log_error(stderr, "  %s: set() failed\n", name);
+            return false;
+        }
+
+        bool any_m = false;
+        for (uint32 i = 0; i < LANES; ++i)
+            any_m |= (m[i] != 0);
+
+        if (any( vm ) != any_m)
+        {
+            log_error(stderr, "  %s: any() failed\n", name);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+int simd_test()
+{
+    printf("simd... started\n");
+
+    if (check_simd<simd4u8>( "simd4u8" )   == false ||
+        check_simd<simd16u8>( "simd16u8" ) == false ||
+        check_simd<simd32u8>( "simd32u8" ) == false ||
+        check_simd<simd8u16>( "simd8u16" ) == false ||
+        check_simd<simd16u16>( "simd16u16" ) == false)
+        exit(1);
+
+    printf("simd... done\n");
+    return 0;
+}
+
+} // namespace nvbio
@@ -37,6 +37,7 @@
 #include <nvbio/basic/cuda/arch.h>
 #include <nvbio/basic/cuda/ldg.h>
 #include <nvbio/strings/string_set.h>
+#include <nvbio/strings/window_gather.h>
 #include <thrust/device_vector.h>
 
 namespace nvbio {
@@ -58,6 +59,7 @@ enum StringSetTest
     CONCAT_TO_STRIDED_PACKED            = 256u,
     PACKED_CONCAT_TO_STRIDED_PACKED     = 512u,
     PACKED_SPARSE_TO_STRIDED_PACKED     = 1024u,
+    WINDOW_GATHER                       = 2048u,
 };
 
 }
@@ -188,6 +190,8 @@ int string_set_test(int argc, char* argv[])
                     TEST_MASK |= PACKED_CONCAT_TO_STRIDED_PACKED;
                 else if (strcmp( temp, "packed-sparse-to-strided-packed" ) == 0)
                     TEST_MASK |= PACKED_SPARSE_TO_STRIDED_PACKED;
+                else if (strcmp( temp, "window-gather" ) == 0)
+                    TEST_MASK |= WINDOW_GATHER;
 
                 if (end[i] == '\0')
                     break;
@@ -333,6 +337,81 @@ int string_set_test(int argc, char* argv[])
         fprintf(stderr, "  test cpu packed-sparse  -> strided-packed copy... done:   %.2f GSYMS\n", (1.0e-9f*float(N_strings*N))*(float(N_tests)/timer.seconds()));
     }
 
+    // gather a batch of overlapping windows of a packed reference
+    if ((TEST_MASK & WINDOW_GATHER) && (TEST_MASK & CPU))
+    {
+        fprintf(stderr, "  test cpu packed-windows -> gathered       copy... started\n");
+        const uint32 REF_SYMBOL_SIZE = 2;
+        const uint32 ref_len         = 64u*1024u*1024u;
+        const uint32 ref_words       = ref_len / ((8u*sizeof(uint32)) / REF_SYMBOL_SIZE);
+
+        typedef PackedStream<const uint32*,uint8,REF_SYMBOL_SIZE,false> packed_stream_type;
+
+        typedef SparseStringSet<packed_stream_type,const uint2*> input_set;
+
+        thrust::host_vector<uint32>  h_ref_words( ref_words );
+        thrust::host_vector<uint2>   h_windows( N_strings );
+
+        LCG_random rand;
+        for (uint32 i = 0; i < ref_words; ++i)
+            h_ref_words[i] = rand.next();
+
+        // pick random windows, half of them overlapping their predecessor
+        for (uint32 i = 0; i < N_strings; ++i)
+        {
+            const uint32 begin = (i & 1) ?
+                h_windows[i-1].x + (rand.next() % N) :
+                rand.next() % (ref_len - 2*N);
+
+            h_windows[i] = make_uint2( begin, begin + N );
+        }
+
+        const packed_stream_type h_packed_stream(
+            thrust::raw_pointer_cast( &h_ref_words.front() ) );
+
+        const input_set h_in_string_set(
+            N_strings,
+            h_packed_stream,
+            thrust::raw_pointer_cast( &h_windows.front() ) );
+
+        WindowGather gather;
+
+        Timer timer;
+        timer.start();
+
+        for (uint32 i = 0; i < N_tests; ++i)
+            gather.gather( h_packed_stream, ref_len, N_strings, thrust::raw_pointer_cast( &h_windows.front() ) );
+
+        timer.stop();
+
+        check( h_in_string_set, gather.strings() );
+
+        // windows exceeding the reference must be rejected
+        {
+            const uint2 bad_window = make_uint2( uint32( ref_len - N/2 ), uint32( ref_len + N/2 ) );
+
+            bool rejected = false;
+            try
+            {
+                gather.gather( h_packed_stream, ref_len, 1u, &bad_window );
+            }
+            catch (nvbio::logic_error)
+            {
+                rejected = true;
+            }
+            if (rejected == false)
+            {
+                fprintf(stderr, "  window exceeding the reference not rejected\n");
+                exit(1);
+            }
+        }
+
+        fprintf(stderr, "  test cpu packed-windows -> gathered       copy... done:   %.2f GSYMS (%u runs, %.2f%% of the requested symbols)\n",
+            (1.0e-9f*float(N_strings*N))*(float(N_tests)/timer.seconds()),
+            gather.runs(),
+            100.0f * float(gather.gathered_symbols()) / float(gather.requested_symbols()));
+    }
+
     // copy a sparse string set into a concatenated one
     if (TEST_MASK & SPARSE_TO_CONCAT)
     {
@@ -33,6 +33,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <vector>
+#include <algorithm>
 
 namespace nvbio {
 
@@ -193,6 +194,91 @@ int sum_tree_test()
             }
         }
     }
+    // batch of trees
+    {
+        const uint32 n_trees  = 1000;
+        const uint32 max_size = 64;
+
+        std::vector<uint32> sizes( n_trees );
+        std::vector<float>  batch_cells( SumTreeBatch<float*>::node_count( n_trees, max_size ) );
+        std::vector<float>  tree_cells( n_trees * SumTree<float*>::node_count( max_size ) );
+
+        SumTreeBatch<float*> batch( n_trees, max_size, &batch_cells[0], &sizes[0] );
+
+        srand(0);
+        for (uint32 t = 0; t < n_trees; ++t)
+        {
+            // keep all sizes within the same power of 2, so that the single trees
+            // have the same shape (and rounding) as the batched ones
+            sizes[t] = max_size/2 + 1u + (rand() % (max_size/2));
+
+            float* cells = &tree_cells[0] + t * SumTree<float*>::node_count( max_size );
+            for (uint32 i = 0; i < sizes[t]; ++i)
+                cells[i] = batch.node( t, i ) = float( rand() % 8 );
+
+            SumTree<float*> tree( sizes[t], cells );
+            tree.setup();
+        }
+        batch.setup();
+
+        std::vector<uint32> tree_ids( n_trees );
+        std::vector<uint32> leaves( n_trees );
+        std::vector<float>  values( n_trees );
+        std::vector<float>  deltas( n_trees );
+
+        // sample and decrement the batch and the single trees in lock-step
+        for (uint32 round = 0; round < 20; ++round)
+        {
+            // pick each tree at most once per round, as the batch is sampled before any update
+            for (uint32 k = 0; k < n_trees; ++k)
+                tree_ids[k] = k;
+
+            for (uint32 k = 0; k < n_trees; ++k)
+            {
+                std::swap( tree_ids[k], tree_ids[ k + rand() % (n_trees - k) ] );
+                values[k] = float(rand()) / float(RAND_MAX);
+            }
+
+            sample( batch, n_trees, &tree_ids[0], &values[0], &leaves[0] );
+
+            for (uint32 k = 0; k < n_trees; ++k)
+            {
+                const uint32 t = tree_ids[k];
+                SumTree<float*> tree( sizes[t], &tree_cells[0] + t * SumTree<float*>::node_count( max_size ) );
+
+                const uint32 c = sample( tree, values[k] );
+                if (c != leaves[k])
+                {
+                    log_error( stderr, "error in batch test(%u):\n  tree[%u] c(%f) = %u (!= %u)\n", round, t, values[k], leaves[k], c );
+                    exit(1);
+                }
+
+                deltas[k] = tree.cell( c ) > 0.0f ? -1.0f : 0.0f;
+                tree.add( c, deltas[k] );
+            }
+
+            if (round & 1)
+                add( batch, n_trees, &tree_ids[0], &leaves[0], &deltas[0] );
+            else
+            {
+                // replay the same updates using set
+                for (uint32 k = 0; k < n_trees; ++k)
+                    deltas[k] = tree_cells[ tree_ids[k] * SumTree<float*>::node_count( max_size ) + leaves[k] ];
+
+                set( batch, n_trees, &tree_ids[0], &leaves[0], &deltas[0] );
+            }
+
+            for (uint32 t = 0; t < n_trees; ++t)
+            {
+                SumTree<float*> tree( sizes[t], &tree_cells[0] + t * SumTree<float*>::node_count( max_size ) );
+                if (tree.sum() != batch.sum( t ))
+                {
+                    log_error( stderr, "error in batch test(%u):\n  tree[%u] sum = %f (!= %f)\n", round, t, batch.sum( t ), tree.sum() );
+                    exit(1);
+                }
+            }
+        }
+    }
     printf("sum tree... done\n");
 
     return 0;
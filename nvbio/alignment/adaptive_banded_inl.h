@@ -0,0 +1,661 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/basic/packedstream.h>
+#include <nvbio/alignment/utils.h>
+#include <nvbio/alignment/alignment_base_inl.h>
+
+namespace nvbio {
+namespace aln {
+
+namespace priv {
+
+///@addtogroup private
+///@{
+
+// initialize the band of the first DP row, which always starts at text position 0
+//
+template <uint32 BAND_LEN, AlignmentType TYPE, typename scoring_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void adaptive_banded_init_row_zero(
+    const scoring_type& scoring,
+    const uint32        N,
+    int32*              H_band,
+    int32*              F_band,
+    uint32&             offset,
+    const int32         infimum)
+{
+    offset = 0u;
+
+    #pragma unroll
+    for (uint32 j = 0; j < BAND_LEN; ++j)
+    {
+        H_band[j] = (j > N) ? infimum :
+                    (TYPE == GLOBAL && j > 0) ? scoring.del_open + int32(j-1)*scoring.del_ext : 0;
+        F_band[j] = infimum;
+    }
+}
+
+// select how many diagonals the band of row i+1 must move right with respect to the band of row i,
+// i.e. by how much its starting text position must advance beyond the i+1 of a fixed band:
+// the result is 0, 1 or 2, where 1 keeps following the same diagonals.
+// The band is re-centered on the range of entries attaining the best score of row i, ties being
+// resolved by not moving, so that rows with no clear winner (e.g. the all-zero rows preceding a local
+// alignment) do not make the band drift.
+//
+template <uint32 BAND_LEN, AlignmentType TYPE>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint32 adaptive_band_shift(
+    const int32*    H_band,
+    const uint32    offset,
+    const uint32    i,
+    const uint32    M,
+    const uint32    N)
+{
+    int32  best  = H_band[0];
+    uint32 first = 0u;
+    uint32 last  = 0u;
+
+    #pragma unroll
+    for (uint32 j = 1; j < BAND_LEN; ++j)
+    {
+        if (H_band[j] > best)
+        {
+            best  = H_band[j];
+            first = last = j;
+        }
+        else if (H_band[j] == best)
+            last = j;
+    }
+
+    const uint32 center = (BAND_LEN-1u)/2u;
+
+    uint32 delta = (last < center) ? 0u :
+                   (first > center) ? 2u : 1u;
+
+    // GLOBAL alignments must end in the bottom-right cell: make sure the band can still reach it
+    // moving at most 2 diagonals per row
+    if (TYPE == GLOBAL)
+    {
+        const int32 rows_left = int32(M) - int32(i) - 1;
+        const int32 min_delta = int32(N) - int32(BAND_LEN-1u) - int32(offset) - 2*rows_left;
+        if (int32(delta) < min_delta)
+            delta = nvbio::min( uint32(min_delta), 2u );
+    }
+
+    // never start the band past the end of the text
+    return nvbio::min( delta, N - offset );
+}
+
+// the adaptive banded DP engine: band entry j of DP row i (i.e. after consuming i pattern symbols)
+// covers the text position offset_i + j, where offset_0 = 0 and offset_{i+1} = offset_i + delta_i,
+// with delta_i chosen by adaptive_band_shift().
+// The engine processes the rows in [row_begin, row_end), and interacts with a context through the
+// following interface:
+//
+//   init(row_begin, H_band, F_band, offset)   : setup the band of the row row_begin
+//   previous_row(i, H_band, F_band, offset)   : called with the band of row i before computing row i+1
+//   last_row(row_end, H_band, F_band, offset) : called with the band of the last computed row
+//   new_cell(i, j, dir)                        : called with the direction vector of entry j of row i+1
+//
+template <uint32 BAND_LEN, AlignmentType TYPE, bool AFFINE>
+struct adaptive_banded_dp
+{
+    template <
+        typename scoring_type,
+        typename pattern_string,
+        typename qual_string,
+        typename text_string,
+        typename context_type,
+        typename sink_type>
+    static NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void run(
+        const scoring_type&     scoring,
+        const pattern_string    pattern,
+        const qual_string       quals,
+        const text_string       text,
+        const uint32            row_begin,
+        const uint32            row_end,
+              context_type&     context,
+              sink_type&        sink)
+    {
+        const uint32 M = pattern.length();
+        const uint32 N = text.length();
+
+        const int32 infimum = Field_traits<int32>::min() / 2;
+
+        int32  H_band[BAND_LEN];
+        int32  F_band[BAND_LEN];
+        uint32 offset;
+
+        context.init( row_begin, H_band, F_band, offset );
+
+        for (uint32 i = row_begin; i < row_end; ++i)
+        {
+            // pass the previous row to the context
+            context.previous_row( i, H_band, F_band, offset );
+
+            // move the band, realigning the previous row so that entry j holds the diagonal predecessor
+            // of the new entry j, and entry j+1 its vertical predecessor
+            const uint32 delta = adaptive_band_shift<BAND_LEN,TYPE>( H_band, offset, i, M, N );
+            if (delta == 0u)
+            {
+                #pragma unroll
+                for (uint32 j = BAND_LEN-1; j > 0; --j)
+                {
+                    H_band[j] = H_band[j-1];
+                    F_band[j] = F_band[j-1];
+                }
+                H_band[0] = infimum;
+                F_band[0] = infimum;
+            }
+            else if (delta == 2u)
+            {
+                #pragma unroll
+                for (uint32 j = 0; j < BAND_LEN-1; ++j)
+                {
+                    H_band[j] = H_band[j+1];
+                    F_band[j] = F_band[j+1];
+                }
+                H_band[BAND_LEN-1] = infimum;
+                F_band[BAND_LEN-1] = infimum;
+            }
+            offset += delta;
+
+            // load the new pattern character
+            const uint8 q  = pattern[i];
+            const uint8 qq = quals[i];
+
+            int32 E    = infimum;
+            uint8 edir = SUBSTITUTION;
+
+            #pragma unroll
+            for (uint32 j = 0; j < BAND_LEN; ++j)
+            {
+                const uint32 k = offset + j;
+
+                // vertical move, from the entry j+1 of the previous row
+                const int32 h_top = (j+1 < BAND_LEN) ? H_band[j+1] : infimum;
+                const int32 f_top = (j+1 < BAND_LEN) ? F_band[j+1] : infimum;
+
+                const int32 f_ext  = f_top + scoring.ins_ext;
+                const int32 f_open = h_top + scoring.ins_open;
+
+                int32 F    = AFFINE ? nvbio::max( f_ext, f_open ) : f_open;
+                uint8 fdir = (AFFINE && f_ext > f_open) ? DELETION_EXT : SUBSTITUTION;
+
+                int32 H;
+                uint8 hdir;
+                if (k > N)
+                {
+                    // past the end of the text
+                    H    = infimum;
+                    F    = infimum;
+                    hdir = SUBSTITUTION;
+                }
+                else
+                {
+                    const int32 diagonal = (k > 0u) ?
+                        H_band[j] + scoring.substitution( k-1, i, text[k-1], q, qq ) :
+                        infimum;
+
+                    H    = nvbio::max3( diagonal, E, F );
+                    hdir = F > E ? (F > diagonal ? INSERTION : SUBSTITUTION) :
+                                   (E > diagonal ? DELETION  : SUBSTITUTION);
+
+                    if (TYPE == LOCAL)
+                    {
+                        if (H <= 0)
+                        {
+                            H    = 0;
+                            hdir = SINK;
+                        }
+                        sink.report( H, make_uint2( k, i+1 ) );
+                    }
+                }
+
+                H_band[j] = H;
+                F_band[j] = F;
+
+                // pass the new cell to the context
+                context.new_cell( i, j, AFFINE ? uint8(hdir | edir | fdir) : hdir );
+
+                // horizontal move, to the entry j+1 of this row
+                const int32 e_ext  = E + scoring.del_ext;
+                const int32 e_open = H + scoring.del_open;
+                if (AFFINE)
+                {
+                    edir = e_ext > e_open ? INSERTION_EXT : SUBSTITUTION;
+                    E    = nvbio::max( e_ext, e_open );
+                }
+                else
+                    E = e_open;
+            }
+        }
+
+        // pass the last row to the context
+        context.last_row( row_end, H_band, F_band, offset );
+
+        if (row_end == M)
+        {
+            if (TYPE == GLOBAL)
+            {
+                // report the bottom-right cell, if the band reached it
+                if (offset <= N && N < offset + BAND_LEN)
+                    sink.report( H_band[ N - offset ], make_uint2( N, M ) );
+            }
+            else if (TYPE == SEMI_GLOBAL)
+            {
+                // report all the cells of the last row lying within the text
+                #pragma unroll
+                for (uint32 j = 0; j < BAND_LEN; ++j)
+                {
+                    if (offset + j <= N)
+                        sink.report( H_band[j], make_uint2( offset + j, M ) );
+                }
+            }
+        }
+    }
+};
+
+// a context computing the scores only
+//
+template <uint32 BAND_LEN, AlignmentType TYPE, typename scoring_type>
+struct AdaptiveBandedScoringContext
+{
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    AdaptiveBandedScoringContext(const scoring_type& _scoring, const uint32 _N) : scoring( _scoring ), N( _N ) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void init(const uint32 i, int32* H_band, int32* F_band, uint32& offset)
+    {
+        adaptive_banded_init_row_zero<BAND_LEN,TYPE>( scoring, N, H_band, F_band, offset, Field_traits<int32>::min() / 2 );
+    }
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void previous_row(const uint32 i, const int32* H_band, const int32* F_band, const uint32 offset) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void last_row(const uint32 i, const int32* H_band, const int32* F_band, const uint32 offset) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void new_cell(const uint32 i, const uint32 j, const uint8 dir) {}
+
+    const scoring_type& scoring;
+    const uint32        N;
+};
+
+// a context saving a checkpoint of BAND_LEN+1 (H,F) cells every CHECKPOINTS rows,
+// the last cell holding the band offset
+//
+template <uint32 BAND_LEN, uint32 CHECKPOINTS, AlignmentType TYPE, typename scoring_type, typename checkpoints_type>
+struct AdaptiveBandedCheckpointContext
+{
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    AdaptiveBandedCheckpointContext(const scoring_type& _scoring, const uint32 _N, checkpoints_type _checkpoints) :
+        scoring( _scoring ), N( _N ), checkpoints( _checkpoints ) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void init(const uint32 i, int32* H_band, int32* F_band, uint32& offset)
+    {
+        adaptive_banded_init_row_zero<BAND_LEN,TYPE>( scoring, N, H_band, F_band, offset, Field_traits<int32>::min() / 2 );
+    }
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void previous_row(const uint32 i, const int32* H_band, const int32* F_band, const uint32 offset)
+    {
+        if ((i % CHECKPOINTS) == 0u)
+        {
+            const uint32 base = (i / CHECKPOINTS) * (BAND_LEN+1u);
+            for (uint32 j = 0; j < BAND_LEN; ++j)
+                checkpoints[ base + j ] = make_int2( H_band[j], F_band[j] );
+
+            checkpoints[ base + BAND_LEN ] = make_int2( int32(offset), 0 );
+        }
+    }
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void last_row(const uint32 i, const int32* H_band, const int32* F_band, const uint32 offset) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void new_cell(const uint32 i, const uint32 j, const uint8 dir) {}
+
+    const scoring_type& scoring;
+    const uint32        N;
+    checkpoints_type    checkpoints;
+};
+
+// a context restoring a checkpoint and saving the flow submatrix of the following CHECKPOINTS rows,
+// together with their band offsets
+//
+template <uint32 BAND_LEN, uint32 CHECKPOINTS, typename checkpoints_type, typename submatrix_type>
+struct AdaptiveBandedSubmatrixContext
+{
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    AdaptiveBandedSubmatrixContext(
+        checkpoints_type    _checkpoints,
+        const uint32        _checkpoint_id,
+        submatrix_type      _submatrix,
+        uint32*             _offsets) :
+        checkpoints( _checkpoints ),
+        checkpoint_id( _checkpoint_id ),
+        submatrix( _submatrix ),
+        offsets( _offsets ) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void init(const uint32 i, int32* H_band, int32* F_band, uint32& offset)
+    {
+        const uint32 base = checkpoint_id * (BAND_LEN+1u);
+        for (uint32 j = 0; j < BAND_LEN; ++j)
+        {
+            const int2 cell = checkpoints[ base + j ];
+            H_band[j] = cell.x;
+            F_band[j] = cell.y;
+        }
+        offset = uint32( checkpoints[ base + BAND_LEN ].x );
+    }
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void previous_row(const uint32 i, const int32* H_band, const int32* F_band, const uint32 offset)
+    {
+        offsets[ i - checkpoint_id*CHECKPOINTS ] = offset;
+    }
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void last_row(const uint32 i, const int32* H_band, const int32* F_band, const uint32 offset)
+    {
+        offsets[ i - checkpoint_id*CHECKPOINTS ] = offset;
+    }
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void new_cell(const uint32 i, const uint32 j, const uint8 dir)
+    {
+        submatrix[ (i - checkpoint_id*CHECKPOINTS)*BAND_LEN + j ] = dir;
+    }
+
+    checkpoints_type    checkpoints;
+    const uint32        checkpoint_id;
+    submatrix_type      submatrix;
+    uint32*             offsets;
+};
+
+///@} // end of private group
+
+} // namespace priv
+
+//
+// Compute the alignment score between a pattern and a text string
+// with adaptive banded DP alignment.
+//
+template <
+    uint32          BAND_LEN,
+    typename        aligner_type,
+    typename        pattern_string,
+    typename        qual_string,
+    typename        text_string,
+    typename        sink_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+bool adaptive_banded_alignment_score(
+    const aligner_type      aligner,
+    const pattern_string    pattern,
+    const qual_string       quals,
+    const text_string       text,
+    const  int32            min_score,
+          sink_type&        sink)
+{
+    typedef priv::dp_scoring<aligner_type> scoring_type;
+
+    const scoring_type scoring( aligner );
+
+    priv::AdaptiveBandedScoringContext<BAND_LEN,aligner_type::TYPE,scoring_type> context( scoring, text.length() );
+
+    priv::adaptive_banded_dp<BAND_LEN,aligner_type::TYPE,scoring_type::AFFINE>::run(
+        scoring, pattern, quals, text, 0u, pattern.length(), context, sink );
+    return true;
+}
+
+//
+// Compute the alignment score between a pattern and a text string
+// with adaptive banded DP alignment.
+//
+template <
+    uint32          BAND_LEN,
+    typename        aligner_type,
+    typename        pattern_string,
+    typename        text_string>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+int32 adaptive_banded_alignment_score(
+    const aligner_type      aligner,
+    const pattern_string    pattern,
+    const text_string       text,
+    const  int32            min_score)
+{
+    BestSink<int32> sink;
+    adaptive_banded_alignment_score<BAND_LEN>(
+        aligner,
+        pattern,
+        trivial_quality_string(),
+        text,
+        min_score,
+        sink );
+
+    return sink.score;
+}
+
+//
+// Backtrace an alignment using an adaptive banded DP algorithm.
+//
+template <
+    uint32          BAND_LEN,
+    uint32          CHECKPOINTS,
+    typename        aligner_type,
+    typename        pattern_string,
+    typename        qual_string,
+    typename        text_string,
+    typename        backtracer_type,
+    typename        checkpoints_type,
+    typename        submatrix_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+Alignment<int32> adaptive_banded_alignment_traceback(
+    const aligner_type      aligner,
+    const pattern_string    pattern,
+    const qual_string       quals,
+    const text_string       text,
+    const int32             min_score,
+    backtracer_type&        backtracer,
+    checkpoints_type        checkpoints,
+    submatrix_type          submatrix)
+{
+    typedef priv::dp_scoring<aligner_type> scoring_type;
+    typedef priv::adaptive_banded_dp<BAND_LEN,aligner_type::TYPE,scoring_type::AFFINE> dp_type;
+
+    const bool AFFINE = scoring_type::AFFINE;
+
+    const scoring_type scoring( aligner );
+
+    const uint32 M = pattern.length();
+
+    // compute the scores, saving the checkpoints
+    BestSink<int32> best;
+    {
+        priv::AdaptiveBandedCheckpointContext<BAND_LEN,CHECKPOINTS,aligner_type::TYPE,scoring_type,checkpoints_type> context(
+            scoring, text.length(), checkpoints );
+
+        dp_type::run( scoring, pattern, quals, text, 0u, M, context, best );
+    }
+
+    const uint2 sink = best.sink;
+    if (sink.x == uint32(-1) ||
+        sink.y == uint32(-1) ||
+        best.score < min_score)
+        return Alignment<int32>( best.score, make_uint2( uint32(-1), uint32(-1) ), make_uint2( uint32(-1), uint32(-1) ) );
+
+    // clip the end of the alignment
+    backtracer.clip( M - sink.y );
+
+    uint32 offsets[ CHECKPOINTS+1 ];
+
+    uint32 i     = sink.y;      // the current DP row
+    uint32 k     = sink.x;      // the current text position
+    uint8  state = HSTATE;      // the current state (H, E, or F)
+    bool   done  = false;
+
+    while (i > 0u && !done)
+    {
+        // recompute the flow submatrix of the rows following the closest checkpoint above row i
+        const uint32 checkpoint_id = (i-1u) / CHECKPOINTS;
+        const uint32 row_begin     = checkpoint_id * CHECKPOINTS;
+        const uint32 row_end       = nvbio::min( row_begin + CHECKPOINTS, M );
+
+        priv::AdaptiveBandedSubmatrixContext<BAND_LEN,CHECKPOINTS,checkpoints_type,submatrix_type> context(
+            checkpoints, checkpoint_id, submatrix, offsets );
+
+        NullSink null_sink;
+        dp_type::run( scoring, pattern, quals, text, row_begin, row_end, context, null_sink );
+
+        // and walk back through it
+        while (i > row_begin)
+        {
+            const uint32 j  = k - offsets[ i - row_begin ];
+            const uint8  op = submatrix[ (i - row_begin - 1u)*BAND_LEN + j ];
+
+            if (AFFINE && state == ESTATE)
+            {
+                if ((op & INSERTION_EXT) == 0)
+                    state = HSTATE;
+
+                --k;
+                backtracer.push( DELETION );
+            }
+            else if (AFFINE && state == FSTATE)
+            {
+                if ((op & DELETION_EXT) == 0)
+                    state = HSTATE;
+
+                --i;
+                backtracer.push( INSERTION );
+            }
+            else
+            {
+                const uint8 h_op = op & HMASK;
+
+                if (aligner_type::TYPE == LOCAL && h_op == SINK)
+                {
+                    done = true;
+                    break;
+                }
+                else if (h_op == SUBSTITUTION)
+                {
+                    --i;
+                    --k;
+                    backtracer.push( SUBSTITUTION );
+                }
+                else if (h_op == DELETION)
+                {
+                    if (AFFINE)
+                        state = ESTATE;
+                    else
+                    {
+                        --k;
+                        backtracer.push( DELETION );
+                    }
+                }
+                else // h_op == INSERTION
+                {
+                    if (AFFINE)
+                        state = FSTATE;
+                    else
+                    {
+                        --i;
+                        backtracer.push( INSERTION );
+                    }
+                }
+            }
+        }
+    }
+
+    // GLOBAL alignments start from the top-left cell, reached along the first row
+    if (aligner_type::TYPE == GLOBAL && !done)
+    {
+        for (; k > 0u; --k)
+            backtracer.push( DELETION );
+    }
+
+    // clip the beginning of the alignment
+    backtracer.clip( i );
+
+    return Alignment<int32>( best.score, make_uint2( k, i ), sink );
+}
+
+//
+// Backtrace an alignment using an adaptive banded DP algorithm,
+// allocating all temporary storage on the stack.
+//
+template <
+    uint32          BAND_LEN,
+    uint32          MAX_PATTERN_LEN,
+    uint32          CHECKPOINTS,
+    typename        aligner_type,
+    typename        pattern_string,
+    typename        qual_string,
+    typename        text_string,
+    typename        backtracer_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+Alignment<int32> adaptive_banded_alignment_traceback(
+    const aligner_type      aligner,
+    const pattern_string    pattern,
+    const qual_string       quals,
+    const text_string       text,
+    const int32             min_score,
+    backtracer_type&        backtracer)
+{
+    const uint32 BITS = direction_vector_traits<aligner_type>::BITS;
+    const uint32 ELEMENTS_PER_WORD = 32 / BITS;
+
+    int2 checkpoints[ (BAND_LEN+1u)*(1u + MAX_PATTERN_LEN/CHECKPOINTS) ];
+
+    NVBIO_VAR_UNUSED const uint32 SUBMATRIX_WORDS = (BAND_LEN*CHECKPOINTS + ELEMENTS_PER_WORD-1) / ELEMENTS_PER_WORD;
+    uint32 submatrix_base[ SUBMATRIX_WORDS ];
+    PackedStream<uint32*,uint8,BITS,false> submatrix( submatrix_base );
+
+    return adaptive_banded_alignment_traceback<BAND_LEN,CHECKPOINTS>(
+        aligner,
+        pattern,
+        quals,
+        text,
+        min_score,
+        backtracer,
+        checkpoints,
+        submatrix );
+}
+
+} // namespace aln
+} // namespace nvbio
@@ -64,7 +64,15 @@
 /// The module exposes several variants of the following functions:
 ///
 /// - banded_alignment_score()
+/// - adaptive_banded_alignment_score()
 /// - alignment_score()
+/// - extension_score()
+///\par
+/// as well as SIMD scoring functions, processing several independent problems packed in the lanes of
+/// an 8-bit SIMD type with the difference recurrence:
+///
+/// - diff_alignment_score()
+/// - diff_banded_alignment_score()
 ///\par
 /// according to whether one wants to process a pattern with qualities or not, whether he's interested
 /// in a single best score or the best N, and so on.
@@ -131,7 +139,13 @@
 /// Again, the module exposes both banded and whole-matrix traceback:
 ///
 /// - banded_alignment_traceback()
+/// - adaptive_banded_alignment_traceback()
 /// - alignment_traceback()
+///\par
+/// as well as a linear-space whole-matrix traceback for long global and semi-global alignments,
+/// whose temporary storage doesn't depend on the pattern length:
+///
+/// - hirschberg_alignment_traceback()
 ///
 /// \subsection Backtracer Backtracer Model
 ///\par
@@ -401,6 +415,155 @@ Alignment<int32> banded_alignment_traceback(
     checkpoints_type        checkpoints,
     submatrix_type          submatrix);
 
+/// Compute the alignment score between a pattern and a text string
+/// with adaptive banded DP alignment.
+///\par
+/// Unlike banded_alignment_score(), whose band is fixed around the main diagonal, here the band
+/// follows the best scoring diagonal: after each DP row the band is moved by at most one diagonal
+/// in either direction so as to re-center it on the row's best entries.
+/// This allows a narrow band to follow alignments whose indels accumulate a net drift larger than
+/// the band itself (as is typical of long, indel-rich reads), at the same cost per row as the fixed band.
+/// GLOBAL alignments are forced to drift towards the bottom-right cell when needed to reach it.
+///
+/// \tparam BAND_LEN            size of the DP band
+/// \tparam aligner_type        a GotohAligner, SmithWatermanAligner or EditDistanceAligner
+///
+/// \param aligner             alignment algorithm
+/// \param pattern             pattern string
+/// \param quals               quality string
+/// \param text                text string
+/// \param min_score           threshold alignment score
+/// \param sink                output sink
+///
+template <
+    uint32          BAND_LEN,
+    typename        aligner_type,
+    typename        pattern_string,
+    typename        qual_string,
+    typename        text_string,
+    typename        sink_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+bool adaptive_banded_alignment_score(
+    const aligner_type      aligner,
+    const pattern_string    pattern,
+    const qual_string       quals,
+    const text_string       text,
+    const  int32            min_score,
+          sink_type&        sink);
+
+/// Compute the alignment score between a pattern and a text string
+/// with adaptive banded DP alignment.
+///
+/// \tparam BAND_LEN            size of the DP band
+/// \tparam aligner_type        a GotohAligner, SmithWatermanAligner or EditDistanceAligner
+///
+/// \param aligner              alignment algorithm
+/// \param pattern              pattern string
+/// \param text                 text string
+/// \param min_score            threshold alignment score
+///
+/// \return                     best alignment score
+///
+template <
+    uint32          BAND_LEN,
+    typename        aligner_type,
+    typename        pattern_string,
+    typename        text_string>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+int32 adaptive_banded_alignment_score(
+    const aligner_type      aligner,
+    const pattern_string    pattern,
+    const text_string       text,
+    const  int32            min_score);
+
+///
+/// Backtrace an alignment using an adaptive banded DP algorithm, see adaptive_banded_alignment_score().
+///
+/// \tparam BAND_LEN            size of the DP band
+/// \tparam CHECKPOINTS         number of DP rows between each checkpoint
+/// \tparam aligner_type        a GotohAligner, SmithWatermanAligner or EditDistanceAligner
+/// \tparam pattern_string      a string representing the pattern.
+/// \tparam qual_string         an array representing the pattern qualities.
+/// \tparam text_string         a string representing the text.
+/// \tparam checkpoints_type    an array-like class of int2 cells defining operator[], used to store the band of all
+///                             the DP rows whose index is a multiple of CHECKPOINTS, together with its offset;
+///                             the array must contain at least (BAND_LEN+1)*(1 + pattern.length()/CHECKPOINTS) cells
+/// \tparam submatrix_type      an array-like class defining operator[], used to represent a temporary DP flow submatrix
+///                             of BAND_LEN*CHECKPOINTS cells of direction_vector_traits<aligner_type>::BITS bits
+/// \tparam backtracer_type     a model of \ref Backtracer.
+///
+/// \param aligner              alignment algorithm
+/// \param pattern              pattern to be aligned
+/// \param quals                pattern quality scores
+/// \param text                 text to align the pattern to
+/// \param min_score            minimum accepted score
+/// \param backtracer           backtracking delegate
+/// \param checkpoints          temporary checkpoints storage
+/// \param submatrix            temporary submatrix storage
+///
+/// \return                     reported alignment
+///
+template <
+    uint32          BAND_LEN,
+    uint32          CHECKPOINTS,
+    typename        aligner_type,
+    typename        pattern_string,
+    typename        qual_string,
+    typename        text_string,
+    typename        backtracer_type,
+    typename        checkpoints_type,
+    typename        submatrix_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+Alignment<int32> adaptive_banded_alignment_traceback(
+    const aligner_type      aligner,
+    const pattern_string    pattern,
+    const qual_string       quals,
+    const text_string       text,
+    const int32             min_score,
+    backtracer_type&        backtracer,
+    checkpoints_type        checkpoints,
+    submatrix_type          submatrix);
+
+///
+/// Backtrace an alignment using an adaptive banded DP algorithm,
+/// allocating all temporary storage on the stack.
+///
+/// \tparam BAND_LEN            size of the DP band
+/// \tparam MAX_PATTERN_LEN     maximum pattern length
+/// \tparam CHECKPOINTS         number of DP rows between each checkpoint
+/// \tparam aligner_type        a GotohAligner, SmithWatermanAligner or EditDistanceAligner
+/// \tparam pattern_string      a string representing the pattern.
+/// \tparam qual_string         an array representing the pattern qualities.
+/// \tparam text_string         a string representing the text.
+/// \tparam backtracer_type     a model of \ref Backtracer.
+///
+/// \param aligner              alignment algorithm
+/// \param pattern              pattern to be aligned
+/// \param quals                pattern quality scores
+/// \param text                 text to align the pattern to
+/// \param min_score            minimum accepted score
+/// \param backtracer           backtracking delegate
+///
+/// \return                     reported alignment
+///
+template <
+    uint32          BAND_LEN,
+    uint32          MAX_PATTERN_LEN,
+    uint32          CHECKPOINTS,
+    typename        aligner_type,
+    typename        pattern_string,
+    typename        qual_string,
+    typename        text_string,
+    typename        backtracer_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+Alignment<int32> adaptive_banded_alignment_traceback(
+    const aligner_type      aligner,
+    const pattern_string    pattern,
+    const qual_string       quals,
+    const text_string       text,
+    const int32             min_score,
+    backtracer_type&        backtracer);
+
 
 /// Compute the alignment score between a pattern and a text string 
 /// with full DP alignment.
@@ -670,6 +833,238 @@ Alignment<int32> alignment_traceback(
     const int32             min_score,
     backtracer_type&        backtracer);
 
+/// A meta-function telling whether a given \ref Aligner "Aligner" supports the linear-space
+/// traceback, see hirschberg_alignment_traceback(): at present, only GLOBAL and SEMI_GLOBAL
+/// GotohAligner's and EditDistanceAligner's do.
+///
+/// \tparam aligner_type        the queries \ref Aligner "Aligner" type
+///
+template <typename aligner_type> struct supports_linear_space_traceback {
+    static const bool VALUE = false;    ///< true iff hirschberg_alignment_traceback() can be used
+};
+template <AlignmentType TYPE, typename scoring_type, typename algorithm_tag> struct supports_linear_space_traceback< GotohAligner<TYPE,scoring_type,algorithm_tag> > {
+    static const bool VALUE = (TYPE == GLOBAL || TYPE == SEMI_GLOBAL);
+};
+template <AlignmentType TYPE, typename algorithm_tag> struct supports_linear_space_traceback< EditDistanceAligner<TYPE,algorithm_tag> > {
+    static const bool VALUE = (TYPE == GLOBAL || TYPE == SEMI_GLOBAL);
+};
+
+///
+/// Backtrace an optimal alignment in linear space, using Hirschberg's divide-and-conquer
+/// strategy (in the affine-gap variant due to Myers and Miller).
+///\par
+/// Unlike alignment_traceback(), whose checkpoint storage grows with the product of the text length
+/// and the number of checkpointed columns, this function only needs storage proportional to
+/// the text length, independently of the pattern length: it splits the DP matrix at the middle
+/// pattern column with two linear-space scoring passes, a forward one over the first half of the
+/// pattern and a backward one over the second half, and recurses on the two resulting
+/// subproblems, until the pattern span of the subproblems drops below CHECKPOINTS symbols,
+/// at which point it reverts to the checkpointed traceback.
+/// The total amount of work is roughly twice that of a single scoring pass.
+///\par
+/// The scoring passes keep 32-bit scores, so that long patterns (e.g. assembled contigs or long reads)
+/// do not overflow.
+/// With a GotohAligner, the splitting passes score insertions with the scheme's pattern gap scores
+/// and deletions with its text gap scores; the subproblems below CHECKPOINTS symbols are however
+/// solved by the checkpointed Gotoh traceback, which uses the pattern gap scores for the gaps
+/// inside the DP matrix, so that alignments are only guaranteed optimal when the two coincide.
+///
+/// \tparam CHECKPOINTS         number of DP rows between each checkpoint, and the pattern span below
+///                             which subproblems are handed to the checkpointed traceback
+/// \tparam aligner_type        a GLOBAL or SEMI_GLOBAL GotohAligner or EditDistanceAligner,
+///                             see supports_linear_space_traceback
+/// \tparam pattern_string      a string representing the pattern.
+/// \tparam qual_string         an array representing the pattern qualities.
+/// \tparam text_string         a string representing the text.
+/// \tparam backtracer_type     a model of \ref Backtracer.
+/// \tparam checkpoints_type    an array-like class defining operator[], with cells of type
+///                             typename checkpoint_storage_type<aligner_type>::type;
+///                             the array must contain at least text.length()+1 entries
+/// \tparam submatrix_type      an array-like class defining operator[], used to represent a temporary DP flow submatrix
+///                             of text.length()*CHECKPOINTS cells of direction_vector_traits<aligner_type>::BITS bits
+/// \tparam column_type         an array-like class defining operator[], with cells of type
+///                             typename column_storage_type<aligner_type>::type, at least as large as the text
+/// \tparam hcolumn_type        an array-like class of int4 cells defining operator[] and operator+,
+///                             used to store the scoring passes' columns, at least 2*(text.length()+1) large
+///
+/// \param aligner              alignment algorithm
+/// \param pattern              pattern to be aligned
+/// \param quals                pattern quality scores
+/// \param text                 text to align the pattern to
+/// \param min_score            minimum accepted score
+/// \param backtracer           backtracking delegate
+/// \param checkpoints          temporary checkpoints storage
+/// \param submatrix            temporary submatrix storage
+/// \param column               temporary column storage
+/// \param hcolumns             temporary storage for the scoring passes
+///
+/// \return                     reported alignment
+///
+template <
+    uint32          CHECKPOINTS,
+    typename        aligner_type,
+    typename        pattern_string,
+    typename        qual_string,
+    typename        text_string,
+    typename        backtracer_type,
+    typename        checkpoints_type,
+    typename        submatrix_type,
+    typename        column_type,
+    typename        hcolumn_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+Alignment<int32> hirschberg_alignment_traceback(
+    const aligner_type      aligner,
+    const pattern_string    pattern,
+    const qual_string       quals,
+    const text_string       text,
+    const int32             min_score,
+    backtracer_type&        backtracer,
+    checkpoints_type        checkpoints,
+    submatrix_type          submatrix,
+    column_type             column,
+    hcolumn_type            hcolumns);
+
+/// Compute the alignment scores of several independent problems, packed in the lanes of a SIMD type,
+/// with the difference recurrence of Suzuki and Kasahara.
+///\par
+/// Rather than the H, E and F scores of the Gotoh recurrence, the DP keeps the differences between
+/// neighboring cells, which are bounded by the scoring scheme alone and fit in 8-bit lanes
+/// independently of the string lengths: a simd32u8 processes 32 problems per AVX2 instruction,
+/// while the exact final scores are recovered summing the differences along the last row of each problem.
+/// Unlike the saturating 8-bit SIMD paths of the other aligners, this works for GLOBAL and SEMI_GLOBAL
+/// alignments of any length.
+///\par
+/// The scheme's match and mismatch scores must not depend on the symbols or their qualities, its text
+/// and pattern gap penalties must coincide, and match - 2*gap_open must not exceed 255.
+///
+/// \tparam aligner_type        a GLOBAL or SEMI_GLOBAL GotohAligner
+/// \tparam pattern_string      a string of SIMD symbols, i.e. simd4u8, simd16u8 or simd32u8, whose lane l
+///                             holds the symbols of the l-th pattern
+/// \tparam text_string         a string of SIMD symbols, whose lane l holds the symbols of the l-th text
+/// \tparam sink_type           an \ref AlignmentSink "Alignment Sink"
+/// \tparam column_type         an array-like class of SIMD cells defining operator[] and operator+,
+///                             at least 2*(max text length + 1) large
+///
+/// \param aligner              alignment algorithm
+/// \param patterns             packed pattern strings, as long as the longest pattern
+/// \param pattern_lengths      the length of each pattern
+/// \param texts                packed text strings, as long as the longest text
+/// \param text_lengths         the length of each text
+/// \param sinks                an output sink per lane, receiving the exact scores and their end cells
+/// \param column               temporary column storage
+///
+/// \return                     false iff the aligner isn't supported, the scheme's gaps are asymmetric or its differences don't fit in 8 bits
+///
+template <
+    AlignmentType   TYPE,
+    typename        scheme_type,
+    typename        algorithm_tag,
+    typename        pattern_string,
+    typename        text_string,
+    typename        sink_type,
+    typename        column_type>
+NVBIO_FORCEINLINE NVBIO_HOST
+bool diff_alignment_score(
+    const GotohAligner<TYPE,scheme_type,algorithm_tag>  aligner,
+    const pattern_string                                patterns,
+    const uint32*                                       pattern_lengths,
+    const text_string                                   texts,
+    const uint32*                                       text_lengths,
+          sink_type*                                    sinks,
+          column_type                                   column);
+
+/// Compute the alignment scores of several independent problems, packed in the lanes of a SIMD type,
+/// with the banded difference recurrence, see diff_alignment_score().
+///\par
+/// As for banded_alignment_score(), row i of the band covers the text positions [i, i + BAND_LEN);
+/// the cells just outside the band are treated as reachable through a gap opened inside it, so that the reported
+/// scores, while always the exact scores of valid alignments, can exceed the ones of a strict band.
+///
+/// \tparam BAND_LEN            size of the DP band
+/// \tparam aligner_type        a GLOBAL or SEMI_GLOBAL GotohAligner
+/// \tparam pattern_string      a string of SIMD symbols, whose lane l holds the symbols of the l-th pattern
+/// \tparam text_string         a string of SIMD symbols, whose lane l holds the symbols of the l-th text
+/// \tparam sink_type           an \ref AlignmentSink "Alignment Sink"
+///
+/// \param aligner              alignment algorithm
+/// \param patterns             packed pattern strings, as long as the longest pattern
+/// \param pattern_lengths      the length of each pattern
+/// \param texts                packed text strings, as long as the longest text
+/// \param text_lengths         the length of each text
+/// \param sinks                an output sink per lane, receiving the exact scores and their end cells
+///
+/// \return                     false iff the aligner isn't supported, the scheme's gaps are asymmetric or its differences don't fit in 8 bits
+///
+template <
+    uint32          BAND_LEN,
+    AlignmentType   TYPE,
+    typename        scheme_type,
+    typename        algorithm_tag,
+    typename        pattern_string,
+    typename        text_string,
+    typename        sink_type>
+NVBIO_FORCEINLINE NVBIO_HOST
+bool diff_banded_alignment_score(
+    const GotohAligner<TYPE,scheme_type,algorithm_tag>  aligner,
+    const pattern_string                                patterns,
+    const uint32*                                       pattern_lengths,
+    const text_string                                   texts,
+    const uint32*                                       text_lengths,
+          sink_type*                                    sinks);
+
+/// Extend an alignment from an anchor, i.e. a cell with a known score (typically
+/// the end of a seed match), using X-drop/Z-drop affine-gap DP.
+/// The anchor is located before the first symbol of the pattern and of the text
+/// when extending to the right, and after their last symbol when extending to the left.
+///\par
+/// Unlike alignment_score(), which fills the entire DP matrix (or band), the extension keeps
+/// a dynamic band of live cells, dropping the ones whose score falls to zero or below the
+/// X-drop threshold, and terminates as soon as no cell is alive or the Z-drop criterion fires:
+/// on long reads and chimeric alignments this visits only a small fraction of the matrix.
+///\par
+/// The sink will receive the best scoring cell of the extension, as well as the best score
+/// of an extension consuming the whole pattern (see ExtensionSink).
+///
+/// \tparam DIR                 the \ref ExtensionDirection
+/// \tparam aligner_type        a GotohAligner or a SmithWatermanAligner (the alignment type is ignored,
+///                             as extensions are always local at their far end)
+/// \tparam pattern_string      a string representing the pattern.
+/// \tparam qual_string         an array representing the pattern qualities.
+/// \tparam text_string         a string representing the text.
+/// \tparam sink_type           a sink modeling the ExtensionSink interface
+/// \tparam column_type         an array-like class defining operator[], used to represent a matrix row
+///                             of int2 cells, which must be at least pattern.length()+1 large
+///
+/// \param aligner             alignment algorithm
+/// \param params              extension parameters
+/// \param pattern             pattern string
+/// \param quals               quality string
+/// \param text                text string
+/// \param init_score          the score of the anchor, must be positive
+/// \param sink                output sink
+/// \param column              temporary storage
+///
+/// \return                    the best extension score
+///
+template <
+    ExtensionDirection  DIR,
+    typename            aligner_type,
+    typename            pattern_string,
+    typename            qual_string,
+    typename            text_string,
+    typename            sink_type,
+    typename            column_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+int32 extension_score(
+    const aligner_type      aligner,
+    const ExtensionParams   params,
+    const pattern_string    pattern,
+    const qual_string       quals,
+    const text_string       text,
+    const int32             init_score,
+          sink_type&        sink,
+          column_type       column);
+
 #if defined(__CUDACC__)
 namespace warp {
 
@@ -722,4 +1117,8 @@ int32 alignment_score(
 
 #include <nvbio/alignment/alignment_inl.h>
 #include <nvbio/alignment/banded_inl.h>
+#include <nvbio/alignment/adaptive_banded_inl.h>
+#include <nvbio/alignment/gotoh/gotoh_diff_inl.h>
+#include <nvbio/alignment/extension_inl.h>
+#include <nvbio/alignment/hirschberg_inl.h>
 #include <nvbio/alignment/utils.h>
@@ -55,6 +55,36 @@ enum AlignmentType { GLOBAL, LOCAL, SEMI_GLOBAL };
 
 ///@} // end of AlignerTagModule group
 
+///@defgroup ExtensionModule Seed Extension
+/// Seed extension is a form of local alignment anchored at one end of the pattern and of the text
+/// (typically the end of an exact seed match), which is terminated as soon as the alignment
+/// cannot improve anymore - see extension_score().
+///@{
+
+/// extension direction specifier: extending to the right scans the strings forward from
+/// their beginning, extending to the left scans them backwards from their end
+///
+enum ExtensionDirection { EXTEND_RIGHT, EXTEND_LEFT };
+
+/// seed extension parameters
+///
+struct ExtensionParams
+{
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    ExtensionParams(
+        const int32  _x_drop = 0,
+        const int32  _z_drop = 100,
+        const uint32 _band   = 0) :
+        x_drop( _x_drop ), z_drop( _z_drop ), band( _band ) {}
+
+    int32  x_drop;  ///< discard cells scoring more than x_drop below the best score so far (0 = disabled)
+    int32  z_drop;  ///< stop when the best score of a row falls more than z_drop below the best one,
+                    ///< after accounting for the gaps needed to connect them (0 = disabled)
+    uint32 band;    ///< maximum distance from the main diagonal (0 = unbanded)
+};
+
+///@} // end of ExtensionModule group
+
 ///@defgroup AlgorithmTag Algorithm Tags
 /// Algorithm tags are used to specify a DP algorithm.
 /// In order to avoid expensive memory transactions, the algorithms we designed block the
@@ -69,6 +69,112 @@ template <
     typename        text_string>
 struct banded_alignment_checkpointed_dispatch {};
 
+//
+// The scores of an aligner as seen by the DP engines working directly on its scheme
+// (i.e. the extension, Hirschberg and adaptive banded aligners).
+// Gaps follow the boundary conditions of the Smith-Waterman and Gotoh kernels:
+//
+//   ins_open, ins_ext : gaps consuming pattern symbols only (INSERTION's), scored by
+//                       insertion() and by the pattern gap scores respectively;
+//   del_open, del_ext : gaps consuming text symbols only (DELETION's), scored by
+//                       deletion() and by the text gap scores respectively.
+//
+// All scores keep the sign of the scheme, and a gap of n symbols scores open + (n-1) * ext.
+//
+template <typename aligner_type>
+struct dp_scoring {};
+
+template <AlignmentType TYPE, typename scoring_scheme_type, typename algorithm_tag>
+struct dp_scoring< GotohAligner<TYPE,scoring_scheme_type,algorithm_tag> >
+{
+    static const bool AFFINE = true;
+
+    typedef GotohAligner<GLOBAL,scoring_scheme_type,PatternBlockingTag> global_aligner_type;
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    dp_scoring(const GotohAligner<TYPE,scoring_scheme_type,algorithm_tag>& aligner) :
+        scheme( aligner.scheme ),
+        ins_open( aligner.scheme.pattern_gap_open() ),
+        ins_ext( aligner.scheme.pattern_gap_extension() ),
+        del_open( aligner.scheme.text_gap_open() ),
+        del_ext( aligner.scheme.text_gap_extension() ) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    int32 substitution(const uint32 r_i, const uint32 q_j, const uint8 r, const uint8 q, const uint8 qq) const
+    {
+        return scheme.substitution( r_i, q_j, r, q, qq );
+    }
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    global_aligner_type global_aligner() const { return global_aligner_type( scheme ); }
+
+    const scoring_scheme_type scheme;
+    const int32 ins_open;
+    const int32 ins_ext;
+    const int32 del_open;
+    const int32 del_ext;
+};
+
+template <AlignmentType TYPE, typename scoring_scheme_type, typename algorithm_tag>
+struct dp_scoring< SmithWatermanAligner<TYPE,scoring_scheme_type,algorithm_tag> >
+{
+    static const bool AFFINE = false;
+
+    typedef SmithWatermanAligner<GLOBAL,scoring_scheme_type,PatternBlockingTag> global_aligner_type;
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    dp_scoring(const SmithWatermanAligner<TYPE,scoring_scheme_type,algorithm_tag>& aligner) :
+        scheme( aligner.scheme ),
+        ins_open( aligner.scheme.insertion() ),
+        ins_ext( aligner.scheme.insertion() ),
+        del_open( aligner.scheme.deletion() ),
+        del_ext( aligner.scheme.deletion() ) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    int32 substitution(const uint32 r_i, const uint32 q_j, const uint8 r, const uint8 q, const uint8 qq) const
+    {
+        return (r == q) ? scheme.match( qq ) : scheme.mismatch( r, q, qq );
+    }
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    global_aligner_type global_aligner() const { return global_aligner_type( scheme ); }
+
+    const scoring_scheme_type scheme;
+    const int32 ins_open;
+    const int32 ins_ext;
+    const int32 del_open;
+    const int32 del_ext;
+};
+
+template <AlignmentType TYPE, typename algorithm_tag>
+struct dp_scoring< EditDistanceAligner<TYPE,algorithm_tag> >
+{
+    static const bool AFFINE = false;
+
+    typedef EditDistanceAligner<GLOBAL,PatternBlockingTag> global_aligner_type;
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    dp_scoring(const EditDistanceAligner<TYPE,algorithm_tag>& aligner) :
+        ins_open( -1 ),
+        ins_ext( -1 ),
+        del_open( -1 ),
+        del_ext( -1 ) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    int32 substitution(const uint32 r_i, const uint32 q_j, const uint8 r, const uint8 q, const uint8 qq) const
+    {
+        return r == q ? 0 : -1;
+    }
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    global_aligner_type global_aligner() const { return global_aligner_type(); }
+
+    const int32 ins_open;
+    const int32 ins_ext;
+    const int32 del_open;
+    const int32 del_ext;
+};
+
 //
 // Helper class for banded alignment
 //
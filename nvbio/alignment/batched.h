@@ -230,6 +230,159 @@ void batch_banded_alignment_score(
     const uint32            max_pattern_length,
     const uint32            max_text_length);
 
+///
+/// A convenience function for scoring a batch of patterns against a corresponding batch of texts
+/// on the host, using adaptive banded DP (see adaptive_banded_alignment_score()).
+/// The band state lives in registers, so that no temporary storage is needed.
+///\par
+/// All the involved string sets and iterators must reside in <em>host memory</em>.
+///
+/// \tparam BAND_LEN            size of the DP band
+/// \tparam aligner_type        a GotohAligner, SmithWatermanAligner or EditDistanceAligner
+/// \tparam pattern_set_type    a string set storing the patterns
+/// \tparam qualities_set_type  a string set storing the qualities
+/// \tparam text_set_type       a string set storing the texts
+/// \tparam sink_iterator       a random access iterator to the output alignment sinks
+///
+/// \param aligner              the \ref Aligner "Aligner" algorithm
+/// \param patterns             the patterns string set
+/// \param quals                the pattern qualities string set
+/// \param texts                the texts string set
+/// \param min_score            threshold alignment score
+/// \param sinks                the output alignment sinks
+/// \param scheduler            the \ref BatchScheduler "Batch Scheduler"
+///
+template <
+    uint32   BAND_LEN,
+    typename aligner_type,
+    typename pattern_set_type,
+    typename qualities_set_type,
+    typename text_set_type,
+    typename sink_iterator>
+void batch_adaptive_banded_alignment_score(
+    const aligner_type          aligner,
+    const pattern_set_type      patterns,
+    const qualities_set_type    quals,
+    const text_set_type         texts,
+    const int32                 min_score,
+          sink_iterator         sinks,
+    const HostThreadScheduler   scheduler);
+
+///
+/// A convenience function for scoring a batch of patterns against a corresponding batch of texts
+/// on the host, using adaptive banded DP (see adaptive_banded_alignment_score()).
+///\par
+/// All the involved string sets and iterators must reside in <em>host memory</em>.
+///
+/// \tparam BAND_LEN            size of the DP band
+/// \tparam aligner_type        a GotohAligner, SmithWatermanAligner or EditDistanceAligner
+/// \tparam pattern_set_type    a string set storing the patterns
+/// \tparam text_set_type       a string set storing the texts
+/// \tparam sink_iterator       a random access iterator to the output alignment sinks
+///
+/// \param aligner              the \ref Aligner "Aligner" algorithm
+/// \param patterns             the patterns string set
+/// \param texts                the texts string set
+/// \param min_score            threshold alignment score
+/// \param sinks                the output alignment sinks
+/// \param scheduler            the \ref BatchScheduler "Batch Scheduler"
+///
+template <
+    uint32   BAND_LEN,
+    typename aligner_type,
+    typename pattern_set_type,
+    typename text_set_type,
+    typename sink_iterator>
+void batch_adaptive_banded_alignment_score(
+    const aligner_type          aligner,
+    const pattern_set_type      patterns,
+    const text_set_type         texts,
+    const int32                 min_score,
+          sink_iterator         sinks,
+    const HostThreadScheduler   scheduler);
+
+///
+/// A convenience function for extending a batch of alignments from their anchors on the host,
+/// using X-drop/Z-drop DP (see extension_score()).
+///\par
+/// All the involved string sets and iterators must reside in <em>host memory</em>.
+///
+/// \tparam DIR                 the \ref ExtensionDirection
+/// \tparam aligner_type        a GotohAligner or a SmithWatermanAligner
+/// \tparam pattern_set_type    a string set storing the patterns
+/// \tparam qualities_set_type  a string set storing the qualities
+/// \tparam text_set_type       a string set storing the texts
+/// \tparam score_iterator      a random access iterator to the anchor scores
+/// \tparam sink_iterator       a random access iterator to the output extension sinks
+///
+/// \param aligner              the \ref Aligner "Aligner" algorithm
+/// \param params               the extension parameters
+/// \param patterns             the patterns string set
+/// \param quals                the pattern qualities string set
+/// \param texts                the texts string set
+/// \param init_scores          the scores of the anchors
+/// \param sinks                the output extension sinks
+/// \param scheduler            the \ref BatchScheduler "Batch Scheduler"
+/// \param max_pattern_length   the maximum pattern length
+///
+template <
+    ExtensionDirection DIR,
+    typename aligner_type,
+    typename pattern_set_type,
+    typename qualities_set_type,
+    typename text_set_type,
+    typename score_iterator,
+    typename sink_iterator>
+void batch_extension_score(
+    const aligner_type          aligner,
+    const ExtensionParams       params,
+    const pattern_set_type      patterns,
+    const qualities_set_type    quals,
+    const text_set_type         texts,
+    const score_iterator        init_scores,
+          sink_iterator         sinks,
+    const HostThreadScheduler   scheduler,
+    const uint32                max_pattern_length);
+
+///
+/// A convenience function for extending a batch of alignments from their anchors on the host,
+/// using X-drop/Z-drop DP (see extension_score()).
+///\par
+/// All the involved string sets and iterators must reside in <em>host memory</em>.
+///
+/// \tparam DIR                 the \ref ExtensionDirection
+/// \tparam aligner_type        a GotohAligner or a SmithWatermanAligner
+/// \tparam pattern_set_type    a string set storing the patterns
+/// \tparam text_set_type       a string set storing the texts
+/// \tparam score_iterator      a random access iterator to the anchor scores
+/// \tparam sink_iterator       a random access iterator to the output extension sinks
+///
+/// \param aligner              the \ref Aligner "Aligner" algorithm
+/// \param params               the extension parameters
+/// \param patterns             the patterns string set
+/// \param texts                the texts string set
+/// \param init_scores          the scores of the anchors
+/// \param sinks                the output extension sinks
+/// \param scheduler            the \ref BatchScheduler "Batch Scheduler"
+/// \param max_pattern_length   the maximum pattern length
+///
+template <
+    ExtensionDirection DIR,
+    typename aligner_type,
+    typename pattern_set_type,
+    typename text_set_type,
+    typename score_iterator,
+    typename sink_iterator>
+void batch_extension_score(
+    const aligner_type          aligner,
+    const ExtensionParams       params,
+    const pattern_set_type      patterns,
+    const text_set_type         texts,
+    const score_iterator        init_scores,
+          sink_iterator         sinks,
+    const HostThreadScheduler   scheduler,
+    const uint32                max_pattern_length);
+
 ///
 /// Execution context for a batch of alignment jobs.
 ///
@@ -358,6 +511,10 @@ struct BatchedBandedAlignmentScore
 /// \tparam stream_type     the stream of alignment jobs
 /// \tparam algorithm_type  a \ref BatchScheduler "Batch Scheduler" specifier
 ///
+/// With the HostThreadScheduler, jobs whose aligner supports it (i.e. GLOBAL and SEMI_GLOBAL
+/// Gotoh and edit distance aligners, see supports_linear_space_traceback) are backtraced in linear
+/// space with hirschberg_alignment_traceback().
+///
 /// This class has to provide the following interface:
 ///
 /// \code
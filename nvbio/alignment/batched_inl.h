@@ -30,11 +30,14 @@
 #include <nvbio/alignment/utils.h>
 #include <nvbio/alignment/batched_stream.h>
 #include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/basic/timer.h>
 #include <nvbio/basic/thrust_view.h>
 #include <nvbio/basic/cuda/work_queue.h>
 #include <nvbio/basic/strided_iterator.h>
 #include <nvbio/basic/vector.h>
 #include <nvbio/strings/prefetcher.h>
+#include <vector>
 #if defined(_OPENMP)
 #include <omp.h>
 #endif
@@ -45,17 +48,22 @@ namespace aln {
 ///@addtogroup private
 ///@{
 
+// score a job whose context has already been loaded, with the given init_context() result
+//
 template <typename stream_type, typename column_type>
 NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-void batched_alignment_score(stream_type& stream, column_type column, const uint32 work_id, const uint32 thread_id)
+void batched_alignment_score(
+    stream_type&                            stream,
+    column_type                             column,
+    const uint32                            work_id,
+    const uint32                            thread_id,
+    const bool                              valid,
+    typename stream_type::context_type&     context)
 {
     typedef typename stream_type::aligner_type  aligner_type;
-    typedef typename stream_type::context_type  context_type;
     typedef typename stream_type::strings_type  strings_type;
 
-    // load the alignment context
-    context_type context;
-    if (stream.init_context( work_id, &context ) == false)
+    if (valid == false)
     {
         // handle the output
         stream.output( work_id, &context );
@@ -85,6 +93,19 @@ void batched_alignment_score(stream_type& stream, column_type column, const uint
     stream.output( work_id, &context );
 }
 
+template <typename stream_type, typename column_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void batched_alignment_score(stream_type& stream, column_type column, const uint32 work_id, const uint32 thread_id)
+{
+    typedef typename stream_type::context_type  context_type;
+
+    // load the alignment context
+    context_type context;
+    const bool valid = stream.init_context( work_id, &context );
+
+    batched_alignment_score( stream, column, work_id, thread_id, valid, context );
+}
+
 template <uint32 BLOCKDIM, uint32 MINBLOCKS, uint32 COLUMN_SIZE, typename stream_type, typename cell_type>
 __global__ void
 __launch_bounds__(BLOCKDIM,MINBLOCKS)
@@ -239,6 +260,7 @@ struct BatchedAlignmentScore<stream_type,HostThreadScheduler>
     static const uint32 MAX_THREADS = 128; // whatever CPU we have, we assume we are never going to have more than this number of threads
 
     typedef typename stream_type::aligner_type                  aligner_type;
+    typedef typename stream_type::context_type                  context_type;
     typedef typename column_storage_type<aligner_type>::type    cell_type;
 
     /// return the per-element column storage size
@@ -260,9 +282,33 @@ struct BatchedAlignmentScore<stream_type,HostThreadScheduler>
     ///
     static uint64 max_temp_storage(const uint32 max_pattern_len, const uint32 max_text_len, const uint32 stream_size);
 
+    /// number of cost bins used to order the jobs, indexed by the log2 of
+    /// their estimated DP cells
+    ///
+    static const uint32 COST_BINS = 33;
+
+    /// constructor
+    ///
+    BatchedAlignmentScore() : n_threads(0u) {}
+
     /// enact the batch execution
     ///
+    /// Jobs are binned by their estimated number of DP cells (pattern length x text length)
+    /// and dispatched largest first with dynamic chunking, so that a few long pattern/text
+    /// pairs don't end up being picked at the very end of the batch.
+    /// The estimates are read from the job contexts, which are loaded once and kept for
+    /// the scoring pass.
+    ///
     void enact(stream_type stream, uint64 temp_size = 0u, uint8* temp = NULL);
+
+    /// return the thread utilization of the last enacted batch, i.e. the ratio between
+    /// the average and the maximum per-thread busy time
+    ///
+    float utilization() const;
+
+    uint32 n_threads;                   ///< number of threads used by the last batch
+    uint64 thread_cells[MAX_THREADS];   ///< per-thread number of DP cells processed by the last batch
+    float  thread_time[MAX_THREADS];    ///< per-thread busy time of the last batch
 };
 
 // return the minimum number of bytes required by the algorithm
@@ -298,10 +344,69 @@ void BatchedAlignmentScore<stream_type,HostThreadScheduler>::enact(stream_type s
     nvbio::vector<host_tag,uint8> temp_vec( min_temp_size );
     cell_type* columns = (cell_type*)nvbio::raw_pointer( temp_vec );
 
+    const uint32 n_jobs = stream.size();
+
+  #if defined(_OPENMP)
+    n_threads = nvbio::min( uint32( omp_get_max_threads() ), uint32( MAX_THREADS ) );
+  #else
+    n_threads = 1u;
+  #endif
+
+    // load the context of each job and estimate its number of DP cells; the contexts are
+    // kept for the scoring pass, so as to load each of them only once
+    std::vector<context_type>      job_contexts( n_jobs );
+    nvbio::vector<host_tag,uint8>  job_valid( n_jobs );
+    nvbio::vector<host_tag,uint64> job_cells( n_jobs );
+    nvbio::vector<host_tag,uint32> job_bins( n_jobs );
+
+    #if defined(_OPENMP)
+    #pragma omp parallel for num_threads( n_threads )
+    #endif
+    for (int work_id = 0; work_id < int( n_jobs ); ++work_id)
+    {
+        context_type& context = job_contexts[ work_id ];
+
+        const bool valid = stream.init_context( work_id, &context );
+
+        const uint64 cells = valid ?
+            uint64( stream.pattern_length( work_id, &context ) ) *
+            uint64( stream.text_length( work_id, &context ) ) : 0u;
+
+        job_valid[ work_id ] = valid ? 1u : 0u;
+        job_cells[ work_id ] = cells;
+        job_bins[ work_id ]  = cells ?
+            (COST_BINS - 2u) - log2( uint32( nvbio::min( cells, uint64(0xFFFFFFFFu) ) ) ) :
+            COST_BINS - 1u;
+    }
+
+    // counting sort the jobs by bin, so as to process the most expensive ones first
+    uint32 bin_offsets[COST_BINS+1] = { 0u };
+    for (uint32 i = 0; i < n_jobs; ++i)
+        ++bin_offsets[ job_bins[i] + 1u ];
+    for (uint32 b = 0; b < COST_BINS; ++b)
+        bin_offsets[b+1] += bin_offsets[b];
+
+    nvbio::vector<host_tag,uint32> job_order( n_jobs );
+    for (uint32 i = 0; i < n_jobs; ++i)
+        job_order[ bin_offsets[ job_bins[i] ]++ ] = i;
+
+    // use small chunks, so that the tail of cheap jobs can fill in the gaps left by
+    // the expensive ones at the front of the queue
+    const uint32 chunk_size = nvbio::max( nvbio::min( n_jobs / (n_threads * 32u), 64u ), 1u );
+
+    const uint64* job_cells_ptr = nvbio::raw_pointer( job_cells );
+    const uint32* job_order_ptr = nvbio::raw_pointer( job_order );
+    const uint8*  job_valid_ptr = nvbio::raw_pointer( job_valid );
+
+    for (uint32 i = 0; i < n_threads; ++i)
+    {
+        thread_cells[i] = 0u;
+        thread_time[i]  = 0.0f;
+    }
+
     #if defined(_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel num_threads( n_threads )
     #endif
-    for (int work_id = 0; work_id < int( stream.size() ); ++work_id)
     {
       #if defined(_OPENMP)
         const uint32 thread_id = omp_get_thread_num();
@@ -316,9 +421,44 @@ void BatchedAlignmentScore<stream_type,HostThreadScheduler>::enact(stream_type s
         // for the CPU it might be better to keep column storage contiguous
         cell_type* column = columns + thread_id * column_size;
 
-        // and solve the actual alignment problem
-        batched_alignment_score( stream, column, work_id, thread_id );
+        uint64 cells = 0u;
+
+        Timer timer;
+        timer.start();
+
+        #if defined(_OPENMP)
+        #pragma omp for schedule(dynamic,chunk_size) nowait
+        #endif
+        for (int i = 0; i < int( n_jobs ); ++i)
+        {
+            const uint32 work_id = job_order_ptr[i];
+
+            // solve the actual alignment problem
+            batched_alignment_score( stream, column, work_id, thread_id, job_valid_ptr[ work_id ] != 0u, job_contexts[ work_id ] );
+
+            cells += job_cells_ptr[ work_id ];
+        }
+
+        timer.stop();
+
+        thread_cells[ thread_id ] = cells;
+        thread_time[ thread_id ]  = timer.seconds();
+    }
+}
+
+// return the thread utilization of the last enacted batch
+//
+template <typename stream_type>
+float BatchedAlignmentScore<stream_type,HostThreadScheduler>::utilization() const
+{
+    float sum_time = 0.0f;
+    float max_time = 0.0f;
+    for (uint32 i = 0; i < n_threads; ++i)
+    {
+        sum_time += thread_time[i];
+        max_time  = nvbio::max( max_time, thread_time[i] );
     }
+    return max_time > 0.0f ? sum_time / (float( n_threads ) * max_time) : 1.0f;
 }
 
 ///
@@ -851,6 +991,260 @@ void BatchedAlignmentTraceback<CHECKPOINTS,stream_type,DeviceThreadBlockSchedule
 
 namespace priv {
 
+///@addtogroup private
+///@{
+
+// dispatch a host traceback job to the checkpointed traceback
+//
+template <uint32 CHECKPOINTS, bool LINEAR_SPACE>
+struct host_alignment_traceback_dispatch
+{
+    template <typename aligner_type, typename strings_type, typename context_type, typename checkpoint_type, typename submatrix_type, typename column_type>
+    static Alignment<int32> enact(
+        const aligner_type  aligner,
+        strings_type&       strings,
+        context_type&       context,
+        checkpoint_type     checkpoints,
+        submatrix_type      submatrix,
+        column_type         column,
+        int4*               hcolumns)
+    {
+        return alignment_traceback<CHECKPOINTS>(
+            aligner,
+            strings.pattern,
+            strings.quals,
+            strings.text,
+            context.min_score,
+            context.backtracer,
+            checkpoints,
+            submatrix,
+            column );
+    }
+};
+
+// dispatch a host traceback job to the linear-space traceback
+//
+template <uint32 CHECKPOINTS>
+struct host_alignment_traceback_dispatch<CHECKPOINTS,true>
+{
+    template <typename aligner_type, typename strings_type, typename context_type, typename checkpoint_type, typename submatrix_type, typename column_type>
+    static Alignment<int32> enact(
+        const aligner_type  aligner,
+        strings_type&       strings,
+        context_type&       context,
+        checkpoint_type     checkpoints,
+        submatrix_type      submatrix,
+        column_type         column,
+        int4*               hcolumns)
+    {
+        return hirschberg_alignment_traceback<CHECKPOINTS>(
+            aligner,
+            strings.pattern,
+            strings.quals,
+            strings.text,
+            context.min_score,
+            context.backtracer,
+            checkpoints,
+            submatrix,
+            column,
+            hcolumns );
+    }
+};
+
+///@} // end of private group
+
+} // namespace priv
+
+///
+/// HostThreadScheduler specialization of BatchedAlignmentTraceback.
+///
+/// Whenever the aligner supports it (see supports_linear_space_traceback), the jobs are backtraced
+/// in linear space with hirschberg_alignment_traceback(), so that the per-thread temporary storage
+/// only grows with the maximum text length, rather than with the product of the text and pattern lengths.
+///
+/// \tparam stream_type     the stream of alignment jobs
+///
+template <uint32 CHECKPOINTS, typename stream_type>
+struct BatchedAlignmentTraceback<CHECKPOINTS,stream_type,HostThreadScheduler>
+{
+    static const uint32 MAX_THREADS = 128; // whatever CPU we have, we assume we are never going to have more than this number of threads
+
+    typedef typename stream_type::aligner_type                      aligner_type;
+    typedef typename column_storage_type<aligner_type>::type        cell_type;
+    typedef typename checkpoint_storage_type<aligner_type>::type    checkpoint_type;
+
+    static const bool LINEAR_SPACE = supports_linear_space_traceback<aligner_type>::VALUE;
+
+    /// return the per-thread column storage size
+    ///
+    static uint64 column_storage(const uint32 max_pattern_len, const uint32 max_text_len)
+    {
+        const uint32 column_size = (LINEAR_SPACE || equal<typename aligner_type::algorithm_tag,PatternBlockingTag>()) ?
+            max_text_len :
+            max_pattern_len;
+
+        return align<16>( uint64( column_size ) * sizeof(cell_type) );
+    }
+
+    /// return the per-thread checkpoint storage size
+    ///
+    static uint64 checkpoint_storage(const uint32 max_pattern_len, const uint32 max_text_len)
+    {
+        if (LINEAR_SPACE)
+            return align<16>( uint64( max_text_len + 1u ) * sizeof(checkpoint_type) );
+        else if (equal<typename aligner_type::algorithm_tag,PatternBlockingTag>())
+            return align<16>( uint64( max_text_len + 1u ) * ((max_pattern_len + CHECKPOINTS-1) / CHECKPOINTS) * sizeof(checkpoint_type) );
+        else
+            return align<16>( uint64( max_pattern_len + 1u ) * ((max_text_len + CHECKPOINTS-1) / CHECKPOINTS) * sizeof(checkpoint_type) );
+    }
+
+    /// return the per-thread submatrix storage size
+    ///
+    static uint64 submatrix_storage(const uint32 max_pattern_len, const uint32 max_text_len)
+    {
+        const uint32 BITS = direction_vector_traits<aligner_type>::BITS;
+        const uint32 ELEMENTS_PER_WORD = 32 / BITS;
+
+        const uint32 column_size = (LINEAR_SPACE || equal<typename aligner_type::algorithm_tag,PatternBlockingTag>()) ?
+            max_text_len :
+            max_pattern_len;
+
+        return align<16>( ((uint64( column_size ) * CHECKPOINTS + ELEMENTS_PER_WORD-1) / ELEMENTS_PER_WORD) * sizeof(uint32) );
+    }
+
+    /// return the per-thread storage size of the linear-space scoring passes
+    ///
+    static uint64 hcolumn_storage(const uint32 max_pattern_len, const uint32 max_text_len)
+    {
+        return LINEAR_SPACE ? uint64( max_text_len + 1u ) * 2u * sizeof(int4) : 0u;
+    }
+
+    /// return the per-thread storage size
+    ///
+    static uint64 thread_storage(const uint32 max_pattern_len, const uint32 max_text_len)
+    {
+        return     column_storage( max_pattern_len, max_text_len ) +
+               checkpoint_storage( max_pattern_len, max_text_len ) +
+                submatrix_storage( max_pattern_len, max_text_len ) +
+                  hcolumn_storage( max_pattern_len, max_text_len );
+    }
+
+    /// return the minimum number of bytes required by the algorithm
+    ///
+    static uint64 min_temp_storage(const uint32 max_pattern_len, const uint32 max_text_len, const uint32 stream_size);
+
+    /// return the maximum number of bytes required by the algorithm
+    ///
+    static uint64 max_temp_storage(const uint32 max_pattern_len, const uint32 max_text_len, const uint32 stream_size);
+
+    /// enact the batch execution
+    ///
+    void enact(stream_type stream, uint64 temp_size = 0u, uint8* temp = NULL);
+};
+
+// return the minimum number of bytes required by the algorithm
+//
+template <uint32 CHECKPOINTS, typename stream_type>
+uint64 BatchedAlignmentTraceback<CHECKPOINTS,stream_type,HostThreadScheduler>::min_temp_storage(const uint32 max_pattern_len, const uint32 max_text_len, const uint32 stream_size)
+{
+    return thread_storage( max_pattern_len, max_text_len ) * MAX_THREADS;
+}
+
+// return the maximum number of bytes required by the algorithm
+//
+template <uint32 CHECKPOINTS, typename stream_type>
+uint64 BatchedAlignmentTraceback<CHECKPOINTS,stream_type,HostThreadScheduler>::max_temp_storage(const uint32 max_pattern_len, const uint32 max_text_len, const uint32 stream_size)
+{
+    return thread_storage( max_pattern_len, max_text_len ) * MAX_THREADS;
+}
+
+// enact the batch execution
+//
+template <uint32 CHECKPOINTS, typename stream_type>
+void BatchedAlignmentTraceback<CHECKPOINTS,stream_type,HostThreadScheduler>::enact(stream_type stream, uint64 temp_size, uint8* temp)
+{
+    const uint32 max_pattern_len = stream.max_pattern_length();
+    const uint32 max_text_len    = stream.max_text_length();
+
+    const uint64 column_size     =     column_storage( max_pattern_len, max_text_len );
+    const uint64 checkpoint_size = checkpoint_storage( max_pattern_len, max_text_len );
+    const uint64 submatrix_size  =  submatrix_storage( max_pattern_len, max_text_len );
+    const uint64 thread_size     =     thread_storage( max_pattern_len, max_text_len );
+
+  #if defined(_OPENMP)
+    const uint32 n_threads = nvbio::min( uint32( omp_get_max_threads() ), uint32( MAX_THREADS ) );
+  #else
+    const uint32 n_threads = 1u;
+  #endif
+
+    // only allocate storage for the threads we are actually going to use
+    nvbio::vector<host_tag,uint8> temp_vec;
+    if (temp == NULL || temp_size < thread_size * n_threads)
+    {
+        temp_vec.resize( thread_size * n_threads );
+        temp = nvbio::raw_pointer( temp_vec );
+    }
+
+    const uint32 n_jobs = stream.size();
+
+    #if defined(_OPENMP)
+    #pragma omp parallel num_threads( n_threads )
+    #endif
+    {
+      #if defined(_OPENMP)
+        const uint32 thread_id = omp_get_thread_num();
+      #else
+        const uint32 thread_id = 0;
+      #endif
+
+        // for the CPU it's better to keep the per-thread storage contiguous
+        uint8* thread_temp = temp + thread_size * thread_id;
+
+        cell_type*       column          = (cell_type*)      (thread_temp);
+        checkpoint_type* checkpoints     = (checkpoint_type*)(thread_temp + column_size);
+        uint32*          submatrix_words = (uint32*)         (thread_temp + column_size + checkpoint_size);
+        int4*            hcolumns        = (int4*)           (thread_temp + column_size + checkpoint_size + submatrix_size);
+
+        const uint32 BITS = direction_vector_traits<aligner_type>::BITS;
+        PackedStream<uint32*,uint8,BITS,false> submatrix( submatrix_words );
+
+        // the cost of the jobs varies widely, so use dynamic scheduling with small chunks
+        #if defined(_OPENMP)
+        #pragma omp for schedule(dynamic,16) nowait
+        #endif
+        for (int work_id = 0; work_id < int( n_jobs ); ++work_id)
+        {
+            typedef typename stream_type::context_type  context_type;
+            typedef typename stream_type::strings_type  strings_type;
+
+            // load the alignment context
+            context_type context;
+            if (stream.init_context( work_id, &context ) == true)
+            {
+                // load the strings to be aligned
+                const uint32 pattern_len = stream.pattern_length( work_id, &context );
+
+                strings_type strings;
+                stream.load_strings( work_id, 0, pattern_len, &context, &strings );
+
+                context.alignment = priv::host_alignment_traceback_dispatch<CHECKPOINTS,LINEAR_SPACE>::enact(
+                    stream.aligner(),
+                    strings,
+                    context,
+                    checkpoints,
+                    submatrix,
+                    column,
+                    hcolumns );
+            }
+
+            // handle the output
+            stream.output( work_id, &context );
+        }
+    }
+}
+
+namespace priv {
+
 //
 // An alignment stream class to be used in conjunction with the BatchAlignmentScore class
 //
@@ -1100,6 +1494,160 @@ void batch_banded_alignment_score(
     batch.enact( stream );
 }
 
+//
+// A convenience function for scoring a batch of patterns against a corresponding batch of texts
+// on the host, using adaptive banded DP.
+//
+template <
+    uint32   BAND_LEN,
+    typename aligner_type,
+    typename pattern_set_type,
+    typename qualities_set_type,
+    typename text_set_type,
+    typename sink_iterator>
+void batch_adaptive_banded_alignment_score(
+    const aligner_type          aligner,
+    const pattern_set_type      patterns,
+    const qualities_set_type    quals,
+    const text_set_type         texts,
+    const int32                 min_score,
+          sink_iterator         sinks,
+    const HostThreadScheduler   scheduler)
+{
+    // the cost of each job is proportional to its pattern length only, hence we use guided scheduling
+    #if defined(_OPENMP)
+    #pragma omp parallel for schedule(guided)
+    #endif
+    for (int work_id = 0; work_id < int( patterns.size() ); ++work_id)
+    {
+        adaptive_banded_alignment_score<BAND_LEN>(
+            aligner,
+            patterns[ work_id ],
+            quals[ work_id ],
+            texts[ work_id ],
+            min_score,
+            sinks[ work_id ] );
+    }
+}
+
+//
+// A convenience function for scoring a batch of patterns against a corresponding batch of texts
+// on the host, using adaptive banded DP.
+//
+template <
+    uint32   BAND_LEN,
+    typename aligner_type,
+    typename pattern_set_type,
+    typename text_set_type,
+    typename sink_iterator>
+void batch_adaptive_banded_alignment_score(
+    const aligner_type          aligner,
+    const pattern_set_type      patterns,
+    const text_set_type         texts,
+    const int32                 min_score,
+          sink_iterator         sinks,
+    const HostThreadScheduler   scheduler)
+{
+    batch_adaptive_banded_alignment_score<BAND_LEN>(
+        aligner,
+        patterns,
+        trivial_quality_string_set(),
+        texts,
+        min_score,
+        sinks,
+        scheduler );
+}
+
+//
+// A convenience function for extending a batch of alignments from their anchors on the host.
+//
+template <
+    ExtensionDirection DIR,
+    typename aligner_type,
+    typename pattern_set_type,
+    typename qualities_set_type,
+    typename text_set_type,
+    typename score_iterator,
+    typename sink_iterator>
+void batch_extension_score(
+    const aligner_type          aligner,
+    const ExtensionParams       params,
+    const pattern_set_type      patterns,
+    const qualities_set_type    quals,
+    const text_set_type         texts,
+    const score_iterator        init_scores,
+          sink_iterator         sinks,
+    const HostThreadScheduler   scheduler,
+    const uint32                max_pattern_length)
+{
+  #if defined(_OPENMP)
+    const uint32 n_threads = omp_get_max_threads();
+  #else
+    const uint32 n_threads = 1u;
+  #endif
+
+    // allocate a row of (H,E) cells per thread
+    const uint32 row_size = max_pattern_length + 1u;
+
+    nvbio::vector<host_tag,int2> rows( row_size * n_threads );
+    int2* rows_ptr = nvbio::raw_pointer( rows );
+
+    // extensions are very irregular, hence we use dynamic scheduling
+    #if defined(_OPENMP)
+    #pragma omp parallel for schedule(dynamic,64)
+    #endif
+    for (int work_id = 0; work_id < int( patterns.size() ); ++work_id)
+    {
+      #if defined(_OPENMP)
+        const uint32 thread_id = omp_get_thread_num();
+      #else
+        const uint32 thread_id = 0;
+      #endif
+
+        extension_score<DIR>(
+            aligner,
+            params,
+            patterns[ work_id ],
+            quals[ work_id ],
+            texts[ work_id ],
+            int32( init_scores[ work_id ] ),
+            sinks[ work_id ],
+            rows_ptr + thread_id * row_size );
+    }
+}
+
+//
+// A convenience function for extending a batch of alignments from their anchors on the host.
+//
+template <
+    ExtensionDirection DIR,
+    typename aligner_type,
+    typename pattern_set_type,
+    typename text_set_type,
+    typename score_iterator,
+    typename sink_iterator>
+void batch_extension_score(
+    const aligner_type          aligner,
+    const ExtensionParams       params,
+    const pattern_set_type      patterns,
+    const text_set_type         texts,
+    const score_iterator        init_scores,
+          sink_iterator         sinks,
+    const HostThreadScheduler   scheduler,
+    const uint32                max_pattern_length)
+{
+    batch_extension_score<DIR>(
+        aligner,
+        params,
+        patterns,
+        trivial_quality_string_set(),
+        texts,
+        init_scores,
+        sinks,
+        scheduler,
+        max_pattern_length );
+}
+
 ///@} // end of BatchAlignment group
 
 ///@} // end of the Alignment group
@@ -0,0 +1,224 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/alignment/utils.h>
+#include <nvbio/alignment/alignment_base_inl.h>
+
+namespace nvbio {
+namespace aln {
+
+namespace priv {
+
+///@addtogroup private
+///@{
+
+// a helper to access the strings in the extension direction
+//
+template <ExtensionDirection DIR, typename string_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint8 extension_symbol(const string_type& string, const uint32 len, const uint32 i)
+{
+    return DIR == EXTEND_RIGHT ? uint8( string[i] ) : uint8( string[len - i - 1u] );
+}
+
+///@} // end of private group
+
+} // namespace priv
+
+// Extend an alignment from an anchor with X-drop/Z-drop affine-gap DP.
+//
+// The DP proceeds row by row along the text, keeping for each pattern column the pair
+// (H,E), where H is the best score of the previous row's diagonal predecessor and E
+// the best score of an alignment ending with a deletion (i.e. a gap in the pattern).
+// A score of zero marks a dead cell: dead cells can't be extended, and the live range
+// [beg,end) of each row is shrunk accordingly.
+//
+template <
+    ExtensionDirection  DIR,
+    typename            aligner_type,
+    typename            pattern_string,
+    typename            qual_string,
+    typename            text_string,
+    typename            sink_type,
+    typename            column_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+int32 extension_score(
+    const aligner_type      aligner,
+    const ExtensionParams   params,
+    const pattern_string    pattern,
+    const qual_string       quals,
+    const text_string       text,
+    const int32             init_score,
+          sink_type&        sink,
+          column_type       column)
+{
+    const priv::dp_scoring<aligner_type> scoring( aligner );
+
+    // the DP works with positive gap penalties
+    const int32 del_open = -scoring.del_open;
+    const int32 del_ext  = -scoring.del_ext;
+    const int32 ins_open = -scoring.ins_open;
+    const int32 ins_ext  = -scoring.ins_ext;
+
+    const int32 qlen = int32( pattern.length() );
+    const int32 tlen = int32( text.length() );
+
+    const int32 w = params.band ? int32( params.band ) : qlen + tlen;
+
+    // the anchor cell alone
+    sink.report( init_score, make_uint2( 0u, 0u ) );
+    if (qlen == 0)
+        sink.report_global( init_score, 0u );
+
+    if (init_score <= 0 || qlen == 0 || tlen == 0)
+        return init_score;
+
+    // initialize the first row, consuming the pattern without the text
+    for (int32 j = 0; j <= qlen; ++j)
+        column[j] = make_int2( 0, 0 );
+
+    column[0] = make_int2( init_score, 0 );
+    column[1] = make_int2( init_score > ins_open ? init_score - ins_open : 0, 0 );
+    for (int32 j = 2; j <= qlen && column[j-1].x > ins_ext; ++j)
+        column[j] = make_int2( column[j-1].x - ins_ext, 0 );
+
+    int32 beg = 0;
+    int32 end = qlen;
+
+    int32 max_score = init_score;
+    int32 max_i     = -1;
+    int32 max_j     = -1;
+
+    for (int32 i = 0; i < tlen; ++i)
+    {
+        const uint8 r_i = priv::extension_symbol<DIR>( text, uint32( tlen ), uint32( i ) );
+
+        // apply the static band
+        if (beg < i - w)     beg = i - w;
+        if (end > i + w + 1) end = i + w + 1;
+        if (end > qlen)      end = qlen;
+
+        // the score of the first column, consuming the text without the pattern
+        int32 h1;
+        if (beg == 0)
+        {
+            h1 = init_score - (del_open + del_ext * i);
+            if (h1 < 0) h1 = 0;
+        }
+        else
+            h1 = 0;
+
+        int32 f     = 0;
+        int32 row_m = 0;
+        int32 row_j = -1;
+
+        const int32 x_floor = params.x_drop > 0 ? max_score - params.x_drop : 0;
+
+        int32 j;
+        for (j = beg; j < end; ++j)
+        {
+            // here column[j] = (H(i-1,j-1), E(i,j))
+            int32       M = column[j].x;
+            int32       e = column[j].y;
+            column[j].x = h1;                       // save H(i,j-1) for the next row
+
+            const uint8 q_j  = priv::extension_symbol<DIR>( pattern, uint32( qlen ), uint32( j ) );
+            const uint8 qq_j = priv::extension_symbol<DIR>( quals,   uint32( qlen ), uint32( j ) );
+
+            // dead predecessors can't be extended by a substitution
+            M = M ? M + scoring.substitution( uint32( i ), uint32( j ), r_i, q_j, qq_j ) : 0;
+
+            int32 h = nvbio::max( M, e );
+            h       = nvbio::max( h, f );
+
+            // X-drop: kill the cells that fell too far below the best score
+            if (h < x_floor)
+                h = M = e = f = 0;
+
+            h1 = h;                                 // save H(i,j) for the next column
+
+            if (row_m <= h) { row_m = h; row_j = j; }
+
+            // E(i+1,j)
+            int32 t = M - del_open; t = nvbio::max( t, 0 );
+            e -= del_ext;           e = nvbio::max( e, t );
+            column[j].y = e;
+
+            // F(i,j+1)
+            t  = M - ins_open;      t = nvbio::max( t, 0 );
+            f -= ins_ext;           f = nvbio::max( f, t );
+        }
+        column[end] = make_int2( h1, 0 );
+
+        // check whether this row reached the end of the pattern
+        if (j == qlen)
+            sink.report_global( h1, uint32( i+1 ) );
+
+        // no cell alive, stop here
+        if (row_m == 0)
+            break;
+
+        if (row_m > max_score)
+        {
+            max_score = row_m;
+            max_i     = i;
+            max_j     = row_j;
+
+            sink.report( max_score, make_uint2( uint32( max_i+1 ), uint32( max_j+1 ) ) );
+        }
+        else if (params.z_drop > 0)
+        {
+            // Z-drop: stop if the score dropped too much, after accounting for the gaps
+            // needed to connect this row's best cell to the overall best one
+            const int32 di = i - max_i;
+            const int32 dj = row_j - max_j;
+            const int32 gap_cost = di > dj ?
+                (di - dj) * del_ext :
+                (dj - di) * ins_ext;
+
+            if (max_score - row_m - gap_cost > params.z_drop)
+            {
+                sink.report_drop();
+                break;
+            }
+        }
+
+        // shrink the live range of the next row
+        for (j = beg; j < end && column[j].x == 0 && column[j].y == 0; ++j) {}
+        beg = j;
+        for (j = end; j >= beg && column[j].x == 0 && column[j].y == 0; --j) {}
+        end = j + 2 < qlen ? j + 2 : qlen;
+    }
+    return max_score;
+}
+
+} // namespace aln
+} // namespace nvbio
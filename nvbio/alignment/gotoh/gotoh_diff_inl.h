@@ -0,0 +1,378 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/basic/simd.h>
+#include <nvbio/alignment/utils.h>
+#include <nvbio/alignment/alignment_base_inl.h>
+
+namespace nvbio {
+namespace aln {
+
+namespace priv {
+
+///@addtogroup private
+///@{
+
+//
+// The difference recurrence of Suzuki and Kasahara replaces the Gotoh H, E and F scores with
+// the following differences between neighboring cells, with rows i along the pattern and
+// columns k along the text:
+//
+//   z(i,k) = H(i,k) - H(i-1,k-1)
+//   u(i,k) = H(i,k) - H(i-1,k)         (vertical)
+//   v(i,k) = H(i,k) - H(i,k-1)         (horizontal)
+//   x(i,k) = E(i+1,k) - H(i,k)         (vertical gap, consuming pattern symbols)
+//   y(i,k) = F(i,k+1) - H(i,k)         (horizontal gap, consuming text symbols)
+//
+// which satisfy:
+//
+//   z(i,k) = max( s(i,k), x(i-1,k) + v(i-1,k), y(i,k-1) + u(i,k-1) )
+//   u(i,k) = z(i,k) - v(i-1,k)
+//   v(i,k) = z(i,k) - u(i,k-1)
+//   x(i,k) = max( 0, x(i-1,k) + v(i-1,k) - z(i,k) + q ) - Q
+//   y(i,k) = max( 0, y(i,k-1) + u(i,k-1) - z(i,k) + q ) - Q
+//
+// where Q = -gap_open is the cost of a gap's first symbol, e = -gap_ext the cost of any further
+// symbol, and q = Q - e.
+// All differences are bounded by the scoring scheme alone: biasing u, v, x, y by Q and z by 2Q,
+// they fall in [0, match + 2Q], and can be stored in 8-bit lanes however long the strings are;
+// exact scores are recovered only where needed, summing the horizontal differences of a row.
+//
+
+// the biased 8-bit scoring constants of the difference recurrence
+//
+template <typename simd_type>
+struct diff_scoring
+{
+    template <typename scheme_type>
+    NVBIO_FORCEINLINE NVBIO_HOST
+    diff_scoring(const scheme_type& scheme) :
+        gap_open( scheme.pattern_gap_open() ),
+        gap_ext( scheme.pattern_gap_extension() ),
+        Q( -gap_open ),
+        valid(
+            scheme.text_gap_open()      == gap_open &&
+            scheme.text_gap_extension() == gap_ext &&
+            gap_ext  <= 0 &&
+            gap_open <= gap_ext &&
+            scheme.mismatch(0) <= scheme.match(0) &&
+            scheme.match(0) >= 0 &&
+            scheme.match(0) + 2*Q <= 255 ),
+        match(    uint8( valid ? scheme.match(0) + 2*Q : 0 ) ),
+        mismatch( uint8( valid ? nvbio::max( scheme.mismatch(0) + 2*Q, 0 ) : 0 ) ),
+        q(        uint8( valid ? gap_ext - gap_open : 0 ) ) {}
+
+    const int32     gap_open;   // the score of a gap's first symbol
+    const int32     gap_ext;    // the score of any further gap symbol
+    const int32     Q;          // the bias of u, v, x, y
+    const bool      valid;      // true iff the gap scores are symmetric and the differences fit in 8 bits
+    const simd_type match;      // s + 2Q for matches
+    const simd_type mismatch;   // s + 2Q for mismatches, clamped to zero as z >= -2Q anyway
+    const simd_type q;
+};
+
+// the per-cell update of the difference recurrence, taking the vertical predecessor's (V,X)
+// and the horizontal predecessor's (U,Y), and returning z + 2Q
+//
+template <typename simd_type>
+NVBIO_FORCEINLINE NVBIO_HOST
+simd_type diff_update(
+    const diff_scoring<simd_type>&  scoring,
+    const simd_type                 S,
+          simd_type&                V,
+          simd_type&                X,
+          simd_type&                U,
+          simd_type&                Y)
+{
+    const simd_type XV = adds( X, V );
+    const simd_type YU = adds( Y, U );
+    const simd_type Z  = nvbio::max( S, nvbio::max( XV, YU ) );
+
+    const simd_type U_new = subs( Z, V );
+    V = subs( Z, U );
+    U = U_new;
+    X = subs( scoring.q, subs( Z, XV ) );
+    Y = subs( scoring.q, subs( Z, YU ) );
+    return Z;
+}
+
+// recover the exact scores of the row ending the lanes whose pattern is `row` symbols long,
+// given the exact score of the row's first cell, and report them to the sinks:
+// the cell `first + j` is described by the horizontal difference V[j]
+//
+template <AlignmentType TYPE, typename simd_type, typename row_type, typename sink_type>
+NVBIO_FORCEINLINE NVBIO_HOST
+void diff_report_row(
+    const uint32                    row,
+    const uint32                    first,
+    const uint32                    row_len,
+    const row_type                  V,
+    const int32*                    anchors,
+    const int32                     Q,
+    const uint32*                   pattern_lengths,
+    const uint32*                   text_lengths,
+          sink_type*                sinks)
+{
+    const uint32 LANES = simd_traits<simd_type>::LANES;
+
+    bool ending = false;
+    int32 H[LANES];
+    for (uint32 l = 0; l < LANES; ++l)
+    {
+        H[l] = anchors[l];
+        ending |= (pattern_lengths[l] == row);
+    }
+    if (ending == false)
+        return;
+
+    uint8 lanes[LANES];
+    for (uint32 j = 0; j < row_len; ++j)
+    {
+        const uint32 k = first + j;
+
+        if (j)
+        {
+            store_lanes( V[j], lanes );
+            for (uint32 l = 0; l < LANES; ++l)
+                H[l] += int32( lanes[l] ) - Q;
+        }
+
+        for (uint32 l = 0; l < LANES; ++l)
+        {
+            if (pattern_lengths[l] != row)
+                continue;
+
+            // GLOBAL alignments end in the last cell, SEMI_GLOBAL ones anywhere along the row
+            if ((TYPE == GLOBAL      && k == text_lengths[l]) ||
+                (TYPE == SEMI_GLOBAL && k >= 1u && k <= text_lengths[l]))
+                sinks[l].report( H[l], make_uint2( k, row ) );
+        }
+    }
+}
+
+///@} // end of private group
+
+} // namespace priv
+
+//
+// Compute the alignment scores of several independent problems packed in the lanes of a SIMD type
+// with the 8-bit difference recurrence.
+//
+template <
+    AlignmentType   TYPE,
+    typename        scheme_type,
+    typename        algorithm_tag,
+    typename        pattern_string,
+    typename        text_string,
+    typename        sink_type,
+    typename        column_type>
+NVBIO_FORCEINLINE NVBIO_HOST
+bool diff_alignment_score(
+    const GotohAligner<TYPE,scheme_type,algorithm_tag>  aligner,
+    const pattern_string                                patterns,
+    const uint32*                                       pattern_lengths,
+    const text_string                                   texts,
+    const uint32*                                       text_lengths,
+          sink_type*                                    sinks,
+          column_type                                   column)
+{
+    typedef typename pattern_string::value_type simd_type;
+
+    const uint32 LANES = simd_traits<simd_type>::LANES;
+
+    const priv::diff_scoring<simd_type> scoring( aligner.scheme );
+    if (TYPE == LOCAL || scoring.valid == false)
+        return false;
+
+    const int32 Q = scoring.Q;
+    const uint8 q = uint8( scoring.gap_ext - scoring.gap_open );
+
+    uint32 M = 0;
+    uint32 N = 0;
+    for (uint32 l = 0; l < LANES; ++l)
+    {
+        M = nvbio::max( M, pattern_lengths[l] );
+        N = nvbio::max( N, text_lengths[l] );
+    }
+
+    // the column storage keeps the (V,X) differences of the previous row, for text positions 0..N
+    column_type V = column;
+    column_type X = column + (N+1);
+
+    // the first row: H(0,k) is a text gap for GLOBAL alignments, and zero otherwise
+    for (uint32 k = 0; k <= N; ++k)
+    {
+        V[k] = simd_type( uint8( TYPE == GLOBAL ? (k <= 1u ? 0u : q) : Q ) );
+        X[k] = simd_type( uint8(0) );
+    }
+
+    int32 anchors[LANES];
+    for (uint32 l = 0; l < LANES; ++l)
+        anchors[l] = 0;
+
+    priv::diff_report_row<TYPE,simd_type>( 0u, 0u, N+1, V, anchors, Q, pattern_lengths, text_lengths, sinks );
+
+    for (uint32 i = 0; i < M; ++i)
+    {
+        const simd_type p = patterns[i];
+
+        // the first column: H(i,0) is a pattern gap
+        simd_type U = simd_type( uint8( i == 0 ? 0u : q ) );
+        simd_type Y = simd_type( uint8(0) );
+
+        for (uint32 k = 1; k <= N; ++k)
+        {
+            const simd_type S = ternary_op( p == texts[k-1], scoring.match, scoring.mismatch );
+
+            simd_type V_k = V[k];
+            simd_type X_k = X[k];
+
+            priv::diff_update( scoring, S, V_k, X_k, U, Y );
+
+            V[k] = V_k;
+            X[k] = X_k;
+        }
+
+        // the exact score of the first cell of row i+1
+        for (uint32 l = 0; l < LANES; ++l)
+            anchors[l] = scoring.gap_open + int32(i)*scoring.gap_ext;
+
+        priv::diff_report_row<TYPE,simd_type>( i+1, 0u, N+1, V, anchors, Q, pattern_lengths, text_lengths, sinks );
+    }
+    return true;
+}
+
+//
+// Compute the alignment scores of several independent problems packed in the lanes of a SIMD type
+// with the banded 8-bit difference recurrence.
+//
+template <
+    uint32          BAND_LEN,
+    AlignmentType   TYPE,
+    typename        scheme_type,
+    typename        algorithm_tag,
+    typename        pattern_string,
+    typename        text_string,
+    typename        sink_type>
+NVBIO_FORCEINLINE NVBIO_HOST
+bool diff_banded_alignment_score(
+    const GotohAligner<TYPE,scheme_type,algorithm_tag>  aligner,
+    const pattern_string                                patterns,
+    const uint32*                                       pattern_lengths,
+    const text_string                                   texts,
+    const uint32*                                       text_lengths,
+          sink_type*                                    sinks)
+{
+    typedef typename pattern_string::value_type simd_type;
+
+    const uint32 LANES = simd_traits<simd_type>::LANES;
+
+    const priv::diff_scoring<simd_type> scoring( aligner.scheme );
+    if (TYPE == LOCAL || scoring.valid == false)
+        return false;
+
+    const int32 Q = scoring.Q;
+    const uint8 q = uint8( scoring.gap_ext - scoring.gap_open );
+
+    uint32 M = 0;
+    uint32 N = 0;
+    for (uint32 l = 0; l < LANES; ++l)
+    {
+        M = nvbio::max( M, pattern_lengths[l] );
+        N = nvbio::max( N, text_lengths[l] );
+    }
+
+    // entry j of the band of row i holds the (V,X) differences of the text position i+j
+    simd_type V_band[BAND_LEN];
+    simd_type X_band[BAND_LEN];
+
+    #pragma unroll
+    for (uint32 j = 0; j < BAND_LEN; ++j)
+    {
+        V_band[j] = simd_type( uint8( TYPE == GLOBAL ? (j <= 1u ? 0u : q) : Q ) );
+        X_band[j] = simd_type( uint8(0) );
+    }
+
+    // the cells just past the right end of the band are seen as reached by a gap opened
+    // in the band: their differences are those of a gap's first symbol, i.e. zero once biased
+    const simd_type edge = simd_type( uint8(0) );
+
+    // the exact scores of the first cell of the band, H(i,i)
+    int32 anchors[LANES];
+    for (uint32 l = 0; l < LANES; ++l)
+        anchors[l] = 0;
+
+    priv::diff_report_row<TYPE,simd_type>( 0u, 0u, BAND_LEN, V_band, anchors, Q, pattern_lengths, text_lengths, sinks );
+
+    uint8 lanes[LANES];
+
+    for (uint32 i = 0; i < M; ++i)
+    {
+        const simd_type p = patterns[i];
+
+        // the cell left of the band is seen as reached by a gap opened in the band as well
+        // (for the first row, this is exactly the boundary cell H(1,0))
+        simd_type U = edge;
+        simd_type Y = edge;
+
+        #pragma unroll
+        for (uint32 j = 0; j < BAND_LEN; ++j)
+        {
+            const uint32 k = i + j + 1u;
+
+            const simd_type S = (k <= N) ?
+                ternary_op( p == texts[k-1], scoring.match, scoring.mismatch ) :
+                scoring.mismatch;
+
+            simd_type V_k = (j+1 < BAND_LEN) ? V_band[j+1] : edge;
+            simd_type X_k = (j+1 < BAND_LEN) ? X_band[j+1] : edge;
+
+            const simd_type Z = priv::diff_update( scoring, S, V_k, X_k, U, Y );
+
+            V_band[j] = V_k;
+            X_band[j] = X_k;
+
+            // H(i+1,i+1) = H(i,i) + z(i+1,i+1)
+            if (j == 0)
+            {
+                store_lanes( Z, lanes );
+                for (uint32 l = 0; l < LANES; ++l)
+                    anchors[l] += int32( lanes[l] ) - 2*Q;
+            }
+        }
+
+        priv::diff_report_row<TYPE,simd_type>( i+1, i+1, BAND_LEN, V_band, anchors, Q, pattern_lengths, text_lengths, sinks );
+    }
+    return true;
+}
+
+} // namespace aln
+} // namespace nvbio
@@ -0,0 +1,359 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/alignment/utils.h>
+#include <nvbio/alignment/alignment_base_inl.h>
+
+namespace nvbio {
+namespace aln {
+
+namespace priv {
+
+///@addtogroup private
+///@{
+
+// a light-weight window over a string, used to hand the small subproblems to the checkpointed traceback;
+// like trivial_quality_string, it serves as its own iterator
+//
+template <typename string_type>
+struct hirschberg_infix
+{
+    static const uint32 SYMBOL_SIZE = 8u;
+
+    typedef uint8               value_type;
+    typedef uint8               reference;
+    typedef uint32              index_type;
+    typedef hirschberg_infix    iterator;
+    typedef hirschberg_infix    const_iterator;
+    typedef hirschberg_infix    forward_iterator;
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    hirschberg_infix(const string_type string, const uint32 begin, const uint32 end) :
+        m_string( string ), m_begin( begin ), m_end( end ) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint32 size() const { return m_end - m_begin; }
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint32 length() const { return m_end - m_begin; }
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    value_type operator[] (const uint32 i) const { return value_type( m_string[ m_begin + i ] ); }
+
+    string_type m_string;
+    uint32      m_begin;
+    uint32      m_end;
+};
+
+template <typename string_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint32 length(const hirschberg_infix<string_type>& infix) { return infix.length(); }
+
+// Score the submatrix [p_begin,p_end) x [t_begin,t_end) as a GLOBAL alignment (or, if free_start
+// is set, as an alignment which may start anywhere along the text), keeping a single column.
+// If REVERSE is set, the pattern and the text are both consumed backwards from their end.
+//
+// On exit, column[i] holds, for the i-th row of the last column (i.e. after consuming i text symbols):
+//      x : the best score of a path reaching the cell
+//      y : the best score of a path reaching the cell with an insertion
+//      z : the column (i.e. the number of consumed pattern symbols) where such an insertion was opened
+//
+template <bool REVERSE, typename scoring_type, typename pattern_string, typename qual_string, typename text_string, typename column_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void hirschberg_score(
+    const scoring_type&     scoring,
+    const pattern_string    pattern,
+    const qual_string       quals,
+    const text_string       text,
+    const uint32            p_begin,
+    const uint32            p_end,
+    const uint32            t_begin,
+    const uint32            t_end,
+    const bool              free_start,
+    column_type             column)
+{
+    const int32 infimum = Field_traits<int32>::min() / 2;
+
+    const uint32 M = p_end - p_begin;
+    const uint32 N = t_end - t_begin;
+
+    // initialize the first column
+    column[0] = make_int4( 0, infimum, 0, 0 );
+    for (uint32 i = 1; i <= N; ++i)
+        column[i] = make_int4( free_start ? 0 : scoring.del_open + scoring.del_ext * int32(i-1), infimum, 0, 0 );
+
+    for (uint32 j = 1; j <= M; ++j)
+    {
+        const uint32 q_j = REVERSE ? p_end - j : p_begin + j - 1u;
+        const uint8  q   = pattern[ q_j ];
+        const uint8  qq  = quals[ q_j ];
+
+        // the first row is made of insertions only
+        const int32 h_first = scoring.ins_open + scoring.ins_ext * int32(j-1);
+
+        int32 h_diag = column[0].x;
+        int32 h_top  = h_first;
+        int32 f      = infimum;
+
+        column[0] = make_int4( h_first, h_first, 0, 0 );
+
+        for (uint32 i = 1; i <= N; ++i)
+        {
+            const uint32 r_i = REVERSE ? t_end - i : t_begin + i - 1u;
+            const uint8  r   = text[ r_i ];
+
+            const int4 left = column[i];
+
+            // extend or open an insertion, keeping track of where it was opened
+            const int32 e_ext  = left.y + scoring.ins_ext;
+            const int32 e_open = left.x + scoring.ins_open;
+            const int32 e      = nvbio::max( e_ext, e_open );
+            const int32 e_col  = e_ext >= e_open ? left.z : int32(j-1);
+
+            // extend or open a deletion
+            f = nvbio::max( f + scoring.del_ext, h_top + scoring.del_open );
+
+            const int32 h = nvbio::max( h_diag + scoring.substitution( r_i, q_j, r, q, qq ), nvbio::max( e, f ) );
+
+            column[i] = make_int4( h, e, e_col, 0 );
+
+            h_diag = left.x;
+            h_top  = h;
+        }
+    }
+}
+
+///@} // end of private group
+
+} // namespace priv
+
+// Backtrace an optimal alignment in linear space.
+//
+// Each subproblem [p_begin,p_end) x [t_begin,t_end) is a GLOBAL alignment. If it's too large for
+// the checkpointed traceback, it's split at its middle pattern column p_mid: a forward pass over
+// [p_begin,p_mid) and a backward pass over [p_mid,p_end) give, for each text row, the best score
+// of the paths crossing the middle column through that row, either in any state (i.e. H+H), or
+// within an insertion spanning the middle column (i.e. E+E, plus a refund of the second gap opening).
+// In the former case the subproblem is split in two at the best row, while in the latter the whole
+// insertion, whose extremes have been tracked by the passes, is emitted explicitly between the two
+// halves, so that no gap is ever charged twice.
+// Subproblems are kept on an explicit stack, and since the backtracer expects the operations from the
+// end of the alignment backwards, the last subproblem is always processed first.
+//
+template <
+    uint32          CHECKPOINTS,
+    typename        aligner_type,
+    typename        pattern_string,
+    typename        qual_string,
+    typename        text_string,
+    typename        backtracer_type,
+    typename        checkpoints_type,
+    typename        submatrix_type,
+    typename        column_type,
+    typename        hcolumn_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+Alignment<int32> hirschberg_alignment_traceback(
+    const aligner_type      aligner,
+    const pattern_string    pattern,
+    const qual_string       quals,
+    const text_string       text,
+    const int32             min_score,
+    backtracer_type&        backtracer,
+    checkpoints_type        checkpoints,
+    submatrix_type          submatrix,
+    column_type             column,
+    hcolumn_type            hcolumns)
+{
+    NVBIO_CUDA_ASSERT( supports_linear_space_traceback<aligner_type>::VALUE );
+
+    typedef priv::dp_scoring<aligner_type> scoring_type;
+
+    // the maximum depth of the subproblem stack: each split leaves at most two pending
+    // subproblems behind, and at least halves the pattern span
+    const uint32 MAX_STACK = 2u*32u + 8u;
+
+    const scoring_type scoring( aligner );
+
+    const uint32 M = pattern.length();
+    const uint32 N = text.length();
+
+    hcolumn_type fwd = hcolumns;
+    hcolumn_type bwd = hcolumns + (N+1);
+
+    // find the extremes of the alignment along the text
+    uint32 t_begin = 0u;
+    uint32 t_end   = N;
+    int32  score;
+
+    if (aligner_type::TYPE == SEMI_GLOBAL)
+    {
+        // a forward pass locates the best end along the last column, keeping the last of
+        // equally scoring ends like BestSink does
+        priv::hirschberg_score<false>( scoring, pattern, quals, text, 0u, M, 0u, N, true, fwd );
+
+        score = Field_traits<int32>::min();
+        t_end = uint32(-1);
+        for (uint32 i = 1; i <= N; ++i)
+        {
+            if (score <= fwd[i].x)
+            {
+                score = fwd[i].x;
+                t_end = i;
+            }
+        }
+
+        if (t_end == uint32(-1) || score < min_score)
+            return Alignment<int32>( score, make_uint2( uint32(-1), uint32(-1) ), make_uint2( uint32(-1), uint32(-1) ) );
+
+        // a backward pass from the end locates the best beginning
+        priv::hirschberg_score<true>( scoring, pattern, quals, text, 0u, M, 0u, t_end, false, bwd );
+
+        int32 best = Field_traits<int32>::min();
+        for (uint32 i = 0; i <= t_end; ++i)
+        {
+            if (best < bwd[i].x)
+            {
+                best    = bwd[i].x;
+                t_begin = t_end - i;
+            }
+        }
+    }
+    else
+    {
+        priv::hirschberg_score<false>( scoring, pattern, quals, text, 0u, M, 0u, N, false, fwd );
+
+        score = fwd[N].x;
+        if (score < min_score)
+            return Alignment<int32>( score, make_uint2( uint32(-1), uint32(-1) ), make_uint2( uint32(-1), uint32(-1) ) );
+    }
+
+    uint4  stack[ MAX_STACK ];
+    uint32 stack_size = 0u;
+
+    stack[ stack_size++ ] = make_uint4( 0u, M, t_begin, t_end );
+
+    while (stack_size)
+    {
+        const uint4 problem = stack[ --stack_size ];
+
+        const uint32 p_begin = problem.x;
+        const uint32 p_end   = problem.y;
+        const uint32 t_b     = problem.z;
+        const uint32 t_e     = problem.w;
+
+        if (t_b == t_e)
+        {
+            // no text left, only insertions
+            for (uint32 j = p_begin; j < p_end; ++j)
+                backtracer.push( INSERTION );
+        }
+        else if (p_begin == p_end)
+        {
+            // no pattern left, only deletions
+            for (uint32 i = t_b; i < t_e; ++i)
+                backtracer.push( DELETION );
+        }
+        else if (p_end - p_begin <= CHECKPOINTS)
+        {
+            // small enough for the checkpointed traceback
+            alignment_traceback<CHECKPOINTS>(
+                scoring.global_aligner(),
+                priv::hirschberg_infix<pattern_string>( pattern, p_begin, p_end ),
+                priv::hirschberg_infix<qual_string>( quals, p_begin, p_end ),
+                priv::hirschberg_infix<text_string>( text, t_b, t_e ),
+                Field_traits<int32>::min(),
+                backtracer,
+                checkpoints,
+                submatrix,
+                column );
+        }
+        else
+        {
+            const uint32 p_mid = (p_begin + p_end) / 2u;
+            const uint32 n     = t_e - t_b;
+
+            priv::hirschberg_score<false>( scoring, pattern, quals, text, p_begin, p_mid, t_b, t_e, false, fwd );
+            priv::hirschberg_score<true> ( scoring, pattern, quals, text, p_mid,   p_end, t_b, t_e, false, bwd );
+
+            // find the best crossing of the middle column
+            int32  best_score = Field_traits<int32>::min();
+            uint32 best_row   = 0u;
+            bool   best_gap   = false;
+
+            for (uint32 i = 0; i <= n; ++i)
+            {
+                const int4 f = fwd[i];
+                const int4 b = bwd[n - i];
+
+                const int32 h_score = f.x + b.x;
+                const int32 e_score = f.y + b.y + (scoring.ins_ext - scoring.ins_open);
+
+                if (best_score < h_score)
+                {
+                    best_score = h_score;
+                    best_row   = i;
+                    best_gap   = false;
+                }
+                if (best_score < e_score)
+                {
+                    best_score = e_score;
+                    best_row   = i;
+                    best_gap   = true;
+                }
+            }
+
+            const uint32 t_mid = t_b + best_row;
+
+            NVBIO_CUDA_ASSERT( stack_size + 3u <= MAX_STACK );
+
+            if (best_gap == false)
+            {
+                stack[ stack_size++ ] = make_uint4( p_begin, p_mid, t_b,   t_mid );
+                stack[ stack_size++ ] = make_uint4( p_mid,   p_end, t_mid, t_e );
+            }
+            else
+            {
+                // the insertion crossing the middle column
+                const uint32 gap_begin = p_begin + fwd[ best_row ].z;
+                const uint32 gap_end   = p_end   - bwd[ n - best_row ].z;
+
+                stack[ stack_size++ ] = make_uint4( p_begin,   gap_begin, t_b,   t_mid );
+                stack[ stack_size++ ] = make_uint4( gap_begin, gap_end,   t_mid, t_mid );
+                stack[ stack_size++ ] = make_uint4( gap_end,   p_end,     t_mid, t_e );
+            }
+        }
+    }
+
+    return Alignment<int32>( score, make_uint2( t_begin, 0u ), make_uint2( t_end, M ) );
+}
+
+} // namespace aln
+} // namespace nvbio
@@ -235,7 +235,7 @@ NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
 bool banded_myers(
     const pattern_string pattern,
     const text_string    text,
-    const int16          min_score,
+    const int32          min_score,
           sink_type&     sink)
 {
     const uint32 pattern_len = pattern.length();
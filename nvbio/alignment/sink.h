@@ -29,6 +29,7 @@
 
 #include <nvbio/basic/types.h>
 #include <nvbio/basic/simd.h>
+#include <nvbio/basic/small_heap.h>
 
 namespace nvbio {
 namespace aln {
@@ -89,24 +90,33 @@ struct BestSink
 };
 
 ///
-/// A sink for valid alignments, mantaining only a single best alignment
+/// A sink for valid alignments of several independent problems packed in the lanes
+/// of a SIMD score type, mantaining only the best score of each lane
 ///
-template <>
-struct BestSink<simd4u8>
+template <typename simd_type>
+struct BestSimdSink
 {
+    NVBIO_HOST_DEVICE_TEMPLATE
     NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-    BestSink() : score( uint32(0) ) {}
+    BestSimdSink() : score( typename simd_traits<simd_type>::lane_type(0) ) {}
 
     /// store a valid alignment
     ///
     /// \param _score    alignment's score
     ///
+    NVBIO_HOST_DEVICE_TEMPLATE
     NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-    void report(const simd4u8 _score) { score = nvbio::max( score, _score ); }
+    void report(const simd_type _score) { score = nvbio::max( score, _score ); }
 
-    simd4u8 score;
+    simd_type score;
 };
 
+template <> struct BestSink<simd4u8>   : public BestSimdSink<simd4u8>   {};
+template <> struct BestSink<simd16u8>  : public BestSimdSink<simd16u8>  {};
+template <> struct BestSink<simd32u8>  : public BestSimdSink<simd32u8>  {};
+template <> struct BestSink<simd8u16>  : public BestSimdSink<simd8u16>  {};
+template <> struct BestSink<simd16u16> : public BestSimdSink<simd16u16> {};
+
 ///
 /// A sink for valid alignments, mantaining the best two alignments
 ///
@@ -141,6 +151,67 @@ private:
     uint32    m_distinct_dist;
 };
 
+///
+/// A sink for valid alignments, mantaining the best N alignments sorted by decreasing score.
+/// As in BestSink, ties are resolved in favor of the most recently reported alignment.
+/// The alignments are kept in a fixed-capacity small_heap, so that each report()
+/// costs a constant number of branch-free conditional moves.
+///
+template <typename ScoreType, uint32 N>
+struct BestNSink
+{
+    /// a reported alignment
+    ///
+    struct entry_type
+    {
+        ScoreType score;
+        uint2     sink;
+    };
+
+    /// order alignments by score
+    ///
+    struct entry_compare
+    {
+        NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+        bool operator() (const entry_type& a, const entry_type& b) const { return a.score < b.score; }
+    };
+
+    /// constructor
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    BestNSink() {}
+
+    /// invalidate
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void invalidate() { best.clear(); }
+
+    /// store a valid alignment
+    ///
+    /// \param score    alignment's score
+    /// \param sink     alignment's end
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void report(const ScoreType score, const uint2 sink);
+
+    /// return the number of stored alignments
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint32 size() const { return best.size(); }
+
+    /// return the score of the i-th best alignment
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    ScoreType score(const uint32 i) const { return best[i].score; }
+
+    /// return the end of the i-th best alignment
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint2 sink(const uint32 i) const { return best[i].sink; }
+
+    small_heap<entry_type,N,entry_compare> best;
+};
+
 ///
 /// A sink for valid alignments, mantaining the best alignments by "column",
 /// where columns have a specified width
@@ -190,6 +261,52 @@ private:
     ScoreType m_min_score;
 };
 
+///
+/// A sink for seed extensions (see extension_score()), keeping track of the best
+/// scoring cell of the extension, and of the best extension reaching the end of
+/// the pattern (i.e. the best end-to-end, unclipped extension).
+/// All coordinates are expressed as the number of symbols consumed from the anchor,
+/// with sink.x referring to the text and sink.y to the pattern.
+///
+template <typename ScoreType>
+struct ExtensionSink
+{
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    ExtensionSink();
+
+    /// invalidate
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void invalidate();
+
+    /// store the best scoring cell of the extension
+    ///
+    /// \param _score    extension's score
+    /// \param _sink     extension's end
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void report(const ScoreType _score, const uint2 _sink);
+
+    /// store the best score of an extension consuming the whole pattern
+    ///
+    /// \param _score    extension's score
+    /// \param _text_end extension's end in the text
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void report_global(const ScoreType _score, const uint32 _text_end);
+
+    /// signal the extension was terminated early by the X-drop or Z-drop criteria
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void report_drop() { dropped = true; }
+
+    ScoreType score;            ///< best extension score
+    uint2     sink;             ///< best extension end
+    ScoreType global_score;     ///< best score of an extension reaching the end of the pattern
+    uint32    global_sink;      ///< text end of the best extension reaching the end of the pattern
+    bool      dropped;          ///< whether the extension was terminated early
+};
+
 ///@} // end of the AlignmentSink group
 
 ///@} // end Alignment group
@@ -113,6 +113,22 @@ void Best2Sink<ScoreType>::report(const ScoreType score, const uint2 sink)
     }
 }
 
+// store a valid alignment
+//
+// \param score    alignment's score
+// \param sink     alignment's end
+//
+template <typename ScoreType, uint32 N>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void BestNSink<ScoreType,N>::report(const ScoreType score, const uint2 sink)
+{
+    entry_type entry;
+    entry.score = score;
+    entry.sink  = sink;
+
+    best.push( entry );
+}
+
 // A sink for valid alignments, mantaining the best two alignments
 //
 template <typename ScoreType, uint32 N>
@@ -196,5 +212,56 @@ void BestColumnSink<ScoreType,N>::best2(uint32& i1, uint32& i2, const uint32 min
     }
 }
 
+// A sink for seed extensions
+//
+template <typename ScoreType>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+ExtensionSink<ScoreType>::ExtensionSink() :
+    score( Field_traits<ScoreType>::min() ),
+    sink( make_uint2( uint32(-1), uint32(-1) ) ),
+    global_score( Field_traits<ScoreType>::min() ),
+    global_sink( uint32(-1) ),
+    dropped( false ) {}
+
+// invalidate
+//
+template <typename ScoreType>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void ExtensionSink<ScoreType>::invalidate()
+{
+    score        = Field_traits<ScoreType>::min();
+    sink         = make_uint2( uint32(-1), uint32(-1) );
+    global_score = Field_traits<ScoreType>::min();
+    global_sink  = uint32(-1);
+    dropped      = false;
+}
+
+// store the best scoring cell of the extension
+//
+template <typename ScoreType>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void ExtensionSink<ScoreType>::report(const ScoreType _score, const uint2 _sink)
+{
+    if (score < _score)
+    {
+        score = _score;
+        sink  = _sink;
+    }
+}
+
+// store the best score of an extension consuming the whole pattern
+//
+template <typename ScoreType>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void ExtensionSink<ScoreType>::report_global(const ScoreType _score, const uint32 _text_end)
+{
+    // NOTE: use <= to pick the longest extension in case of ties
+    if (global_score <= _score)
+    {
+        global_score = _score;
+        global_sink  = _text_end;
+    }
+}
+
 } // namespace aln
 } // namespace nvbio
@@ -1327,14 +1327,16 @@ struct sw_alignment_score_dispatch<BAND_LEN,TYPE,TextBlockingTag,symbol_type>
     }
 };
 
-template <AlignmentType TYPE, uint32 DIM, typename symbol_type>
+template <AlignmentType TYPE, uint32 DIM, typename symbol_type, bool IS_SIMD = simd_traits<symbol_type>::IS_SIMD>
 struct sw_bandlen_selector
 {
     static const uint32 BAND_LEN = 16u / DIM;
 };
 
-template <AlignmentType TYPE, uint32 DIM>
-struct sw_bandlen_selector<TYPE,DIM,simd4u8>
+// SIMD symbol types, packing several independent problems in their lanes
+//
+template <AlignmentType TYPE, uint32 DIM, typename symbol_type>
+struct sw_bandlen_selector<TYPE,DIM,symbol_type,true>
 {
 #if __CUDA_ARCH__ >= 300
     static const uint32 BAND_LEN = 8u;
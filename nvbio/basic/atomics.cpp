@@ -194,5 +194,37 @@ uint64 host_atomic_or(uint64* value, const uint64 op)
     return old;
 #endif
 }
+uint32 host_atomic_cas(uint32* value, const uint32 compare, const uint32 op)
+{
+#if defined(__GNUC__)
+    uint32 old = compare;
+    __atomic_compare_exchange_n( value, &old, op, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE );
+    return old;
+#else
+    Mutex mutex;
+    ScopedLock lock( &mutex );
+
+    const uint32 old = *value;
+    if (old == compare)
+        *value = op;
+    return old;
+#endif
+}
+uint64 host_atomic_cas(uint64* value, const uint64 compare, const uint64 op)
+{
+#if defined(__GNUC__)
+    uint64 old = compare;
+    __atomic_compare_exchange_n( value, &old, op, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE );
+    return old;
+#else
+    Mutex mutex;
+    ScopedLock lock( &mutex );
+
+    const uint64 old = *value;
+    if (old == compare)
+        *value = op;
+    return old;
+#endif
+}
 
 } // namespace nvbio
@@ -71,6 +71,9 @@ uint64 host_atomic_sub(uint64* value, const uint64 op);
 uint32 host_atomic_or(uint32* value, const uint32 op);
 uint64 host_atomic_or(uint64* value, const uint64 op);
 
+uint32 host_atomic_cas(uint32* value, const uint32 compare, const uint32 op);
+uint64 host_atomic_cas(uint64* value, const uint64 compare, const uint64 op);
+
 NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
 int32 atomic_add(int32* value, const int32 op)
 {
@@ -141,6 +144,30 @@ uint64 atomic_or(uint64* value, const uint64 op)
   #endif
 }
 
+/// atomically replace *value with op if it equals compare, returning the old value
+///
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint32 atomic_cas(uint32* value, const uint32 compare, const uint32 op)
+{
+  #if defined(NVBIO_DEVICE_COMPILATION)
+    return atomicCAS( value, compare, op );
+  #else
+    return host_atomic_cas( value, compare, op );
+  #endif
+}
+
+/// atomically replace *value with op if it equals compare, returning the old value
+///
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 atomic_cas(uint64* value, const uint64 compare, const uint64 op)
+{
+  #if defined(NVBIO_DEVICE_COMPILATION)
+    return atomicCAS( (unsigned long long int*)value, (unsigned long long int)compare, (unsigned long long int)op );
+  #else
+    return host_atomic_cas( value, compare, op );
+  #endif
+}
+
 #if defined(WIN32)
 
 int32 atomic_increment(int32 volatile *value);
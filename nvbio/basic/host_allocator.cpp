@@ -0,0 +1,165 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <nvbio/basic/host_allocator.h>
+#include <nvbio/basic/numbers.h>
+#include <stdlib.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace nvbio {
+
+namespace {
+
+const uint64 HUGE_PAGE_SIZE = 2u*1024u*1024u;
+
+#if defined(__linux__) && defined(SYS_mbind)
+// set a preferred NUMA node for a page-aligned memory range, without depending on libnuma
+//
+void set_preferred_node(void* ptr, const uint64 size, const int32 node)
+{
+    const int MPOL_PREFERRED_MODE = 1; // MPOL_PREFERRED, from <numaif.h>
+
+    if (node < 0 || node >= int32( 8u*sizeof(unsigned long) ))
+        return;
+
+    const unsigned long node_mask = 1ul << node;
+    syscall( SYS_mbind, ptr, size, MPOL_PREFERRED_MODE, &node_mask, 8u*sizeof(unsigned long), 0 );
+}
+#else
+void set_preferred_node(void* ptr, const uint64 size, const int32 node) {}
+#endif
+
+} // anonymous namespace
+
+// allocate a host memory block
+//
+void* huge_page_alloc(const uint64 size, const int32 numa_node)
+{
+#if defined(__linux__)
+    if (size >= HUGE_PAGE_SIZE)
+    {
+        void* ptr = NULL;
+        if (posix_memalign( &ptr, HUGE_PAGE_SIZE, size ) != 0)
+            return NULL;
+
+      #if defined(MADV_HUGEPAGE)
+        madvise( ptr, size, MADV_HUGEPAGE );
+      #endif
+
+        // the pages have not been touched yet, so the NUMA policy will apply to all of them
+        set_preferred_node( ptr, size, numa_node );
+        return ptr;
+    }
+#endif
+    return malloc( size );
+}
+
+// free a host memory block allocated by huge_page_alloc()
+//
+void huge_page_free(void* ptr)
+{
+    free( ptr );
+}
+
+// constructor
+//
+HostArena::HostArena(const uint64 chunk_size, const int32 numa_node) :
+    m_chunk_size( chunk_size ),
+    m_numa_node( numa_node ),
+    m_chunk( 0 ),
+    m_offset( 0 ),
+    m_allocated( 0 )
+{}
+
+// destructor
+//
+HostArena::~HostArena()
+{
+    for (uint32 i = 0; i < m_chunks.size(); ++i)
+        huge_page_free( m_chunks[i].ptr );
+}
+
+// allocate a block of memory
+//
+void* HostArena::alloc(const uint64 size, const uint64 alignment)
+{
+    // look for the first chunk with enough space, starting from the current one
+    for (; m_chunk < m_chunks.size(); ++m_chunk, m_offset = 0)
+    {
+        const Chunk& chunk = m_chunks[ m_chunk ];
+
+        const uint64 base   = uint64( size_t( chunk.ptr ) );
+        const uint64 offset = util::round_i( base + m_offset, alignment ) - base;
+        if (offset + size <= chunk.size)
+        {
+            m_offset     = offset + size;
+            m_allocated += size;
+            return chunk.ptr + offset;
+        }
+    }
+
+    // allocate a new chunk, large enough to hold this block
+    Chunk chunk;
+    chunk.size = nvbio::max( m_chunk_size, size + alignment );
+    chunk.ptr  = (uint8*)huge_page_alloc( chunk.size, m_numa_node );
+    if (chunk.ptr == NULL)
+        throw nvbio::bad_alloc( "HostArena: failed allocating %llu bytes", chunk.size );
+
+    m_chunks.push_back( chunk );
+    m_chunk  = uint32( m_chunks.size() - 1u );
+    m_offset = 0;
+
+    return alloc( size, alignment );
+}
+
+// recycle all allocations at once
+//
+void HostArena::reset()
+{
+    m_chunk     = 0;
+    m_offset    = 0;
+    m_allocated = 0;
+}
+
+// return the amount of memory reserved by the arena
+//
+uint64 HostArena::reserved_size() const
+{
+    uint64 size = 0;
+    for (uint32 i = 0; i < m_chunks.size(); ++i)
+        size += m_chunks[i].size;
+
+    return size;
+}
+
+} // namespace nvbio
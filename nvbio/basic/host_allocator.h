@@ -0,0 +1,265 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/exceptions.h>
+#include <memory>
+#include <vector>
+
+namespace nvbio {
+
+///@addtogroup Basic
+///@{
+
+///\defgroup HostAllocatorsModule Host Allocators
+///
+/// This module defines a set of STL-compatible host allocators which can be plugged into
+/// nvbio::vector<host_tag,T,Allocator>, HostVectorArray<T,Allocator> and
+/// PackedVector<host_tag,...,Allocator>:
+///
+/// - huge_page_allocator : allocates large blocks on 2MB aligned, transparent huge pages,
+///   optionally preferring a given NUMA node, so as to reduce TLB misses on large indices
+/// - arena_allocator : allocates from a resettable HostArena, so that per-batch containers
+///   can be rebuilt at the cost of a pointer bump rather than a trip to the system heap
+/// - uninitialized_allocator : an adaptor turning resize(n) into an uninitialized resize,
+///   avoiding to zero-fill large buffers which are about to be overwritten anyway
+///
+/// e.g.
+///\code
+/// // a batch buffer which is neither zero-filled on resize nor backed by 4KB pages
+/// nvbio::vector<host_tag, uint32, uninitialized_allocator< uint32, huge_page_allocator<uint32> > > buffer;
+///
+/// buffer.resize( n );     // leaves the contents uninitialized
+///\endcode
+///
+///@{
+
+/// allocate a host memory block; blocks of at least 2MB are aligned to the huge page size
+/// and advised to be backed by transparent huge pages, where the OS supports them.
+///
+/// \param size         size of the block, in bytes
+/// \param numa_node    the preferred NUMA node for the block's pages, or -1 for the default policy
+/// \return             the block, or NULL on failure
+///
+void* huge_page_alloc(const uint64 size, const int32 numa_node = -1);
+
+/// free a host memory block allocated by huge_page_alloc()
+///
+void huge_page_free(void* ptr);
+
+///
+/// A simple, resettable bump allocator carving allocations out of a list of large chunks,
+/// themselves allocated by huge_page_alloc().
+/// Individual allocations are never freed: the whole arena is recycled at once by reset(),
+/// which keeps the chunks around for the next round of allocations.
+/// The arena is not thread-safe.
+///
+struct HostArena
+{
+    /// constructor
+    ///
+    /// \param chunk_size   the minimum size of the arena chunks, in bytes
+    /// \param numa_node    the preferred NUMA node, or -1 for the default policy
+    ///
+    HostArena(const uint64 chunk_size = 64u*1024u*1024u, const int32 numa_node = -1);
+
+    /// destructor
+    ///
+    ~HostArena();
+
+    /// allocate a block of memory
+    ///
+    /// \param size         size of the block, in bytes
+    /// \param alignment    alignment of the block, a power of 2
+    ///
+    void* alloc(const uint64 size, const uint64 alignment = 16u);
+
+    /// recycle all allocations at once; all containers using this arena must have been
+    /// destroyed or released their storage beforehand
+    ///
+    void reset();
+
+    /// return the amount of memory currently allocated from the arena
+    ///
+    uint64 allocated_size() const { return m_allocated; }
+
+    /// return the amount of memory reserved by the arena
+    ///
+    uint64 reserved_size() const;
+
+private:
+    struct Chunk
+    {
+        uint8*  ptr;
+        uint64  size;
+    };
+
+    HostArena(const HostArena&);
+    HostArena& operator=(const HostArena&);
+
+    std::vector<Chunk>  m_chunks;
+    uint64              m_chunk_size;
+    int32               m_numa_node;
+    uint32              m_chunk;
+    uint64              m_offset;
+    uint64              m_allocated;
+};
+
+/// the default tag identifying the global arena used by arena_allocator
+///
+struct default_arena_tag {};
+
+/// return the global arena associated to a given tag
+///
+template <typename ArenaTag>
+HostArena& host_arena()
+{
+    static HostArena arena;
+    return arena;
+}
+
+///
+/// An allocator backed by huge_page_alloc()
+///
+/// \tparam T           the value type
+/// \tparam NUMA_NODE   the preferred NUMA node, or -1 for the default policy
+///
+template <typename T, int32 NUMA_NODE = -1>
+struct huge_page_allocator
+{
+    typedef T value_type;
+
+    template <typename U> struct rebind { typedef huge_page_allocator<U,NUMA_NODE> other; };
+
+    huge_page_allocator() {}
+    template <typename U>
+    huge_page_allocator(const huge_page_allocator<U,NUMA_NODE>&) {}
+
+    /// allocate n elements
+    ///
+    T* allocate(const size_t n)
+    {
+        void* ptr = huge_page_alloc( uint64( n ) * sizeof(T), NUMA_NODE );
+        if (ptr == NULL && n)
+            throw nvbio::bad_alloc( "huge_page_allocator: failed allocating %llu bytes", uint64( n ) * sizeof(T) );
+
+        return static_cast<T*>( ptr );
+    }
+
+    /// deallocate n elements
+    ///
+    void deallocate(T* p, const size_t n) { huge_page_free( p ); }
+};
+
+template <typename T, typename U, int32 NUMA_NODE>
+bool operator==(const huge_page_allocator<T,NUMA_NODE>&, const huge_page_allocator<U,NUMA_NODE>&) { return true; }
+template <typename T, typename U, int32 NUMA_NODE>
+bool operator!=(const huge_page_allocator<T,NUMA_NODE>&, const huge_page_allocator<U,NUMA_NODE>&) { return false; }
+
+///
+/// An allocator carving its allocations out of the global arena identified by ArenaTag,
+/// see host_arena(). Deallocation is a no-op: the storage is recycled by resetting the arena.
+///
+/// \tparam T           the value type
+/// \tparam ArenaTag    the arena tag
+///
+template <typename T, typename ArenaTag = default_arena_tag>
+struct arena_allocator
+{
+    typedef T value_type;
+
+    template <typename U> struct rebind { typedef arena_allocator<U,ArenaTag> other; };
+
+    arena_allocator() {}
+    template <typename U>
+    arena_allocator(const arena_allocator<U,ArenaTag>&) {}
+
+    /// allocate n elements
+    ///
+    T* allocate(const size_t n)
+    {
+        return static_cast<T*>( host_arena<ArenaTag>().alloc( uint64( n ) * sizeof(T), sizeof(T) < 16u ? 16u : sizeof(T) ) );
+    }
+
+    /// deallocate n elements
+    ///
+    void deallocate(T* p, const size_t n) {}
+};
+
+template <typename T, typename U, typename ArenaTag>
+bool operator==(const arena_allocator<T,ArenaTag>&, const arena_allocator<U,ArenaTag>&) { return true; }
+template <typename T, typename U, typename ArenaTag>
+bool operator!=(const arena_allocator<T,ArenaTag>&, const arena_allocator<U,ArenaTag>&) { return false; }
+
+///
+/// An allocator adaptor whose default construction is a no-op, so that resize(n) leaves
+/// the new elements uninitialized (while resize(n,value) still fills them).
+/// Only meant for plain-old-data types.
+///
+/// \tparam T               the value type
+/// \tparam BaseAllocator   the underlying allocator
+///
+template <typename T, typename BaseAllocator = std::allocator<T> >
+struct uninitialized_allocator : public BaseAllocator
+{
+    typedef BaseAllocator                                           base_type;
+    typedef typename std::allocator_traits<base_type>::pointer      pointer;
+    typedef typename std::allocator_traits<base_type>::size_type    size_type;
+
+    template <typename U> struct rebind
+    {
+        typedef uninitialized_allocator<U, typename std::allocator_traits<BaseAllocator>::template rebind_alloc<U> > other;
+    };
+
+    uninitialized_allocator() {}
+    uninitialized_allocator(const uninitialized_allocator& other) : base_type( other ) {}
+    template <typename U, typename OtherAllocator>
+    uninitialized_allocator(const uninitialized_allocator<U,OtherAllocator>& other) : base_type( other ) {}
+
+    /// default construction is a no-op
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void construct(T* p) {}
+
+    /// copy construction, forwarded to the base allocator
+    ///
+    template <typename U, typename Arg>
+    void construct(U* p, const Arg& arg) { std::allocator_traits<base_type>::construct( static_cast<base_type&>( *this ), p, arg ); }
+};
+
+template <typename T, typename U, typename A, typename B>
+bool operator==(const uninitialized_allocator<T,A>& a, const uninitialized_allocator<U,B>& b) { return static_cast<const A&>( a ) == static_cast<const B&>( b ); }
+template <typename T, typename U, typename A, typename B>
+bool operator!=(const uninitialized_allocator<T,A>& a, const uninitialized_allocator<U,B>& b) { return !(a == b); }
+
+///@} HostAllocatorsModule
+///@} Basic
+
+} // namespace nvbio
@@ -142,6 +142,88 @@ ServerMappedFile::~ServerMappedFile()
     delete impl;
 }
 
+struct DiskMappedFile::Impl
+{
+    Impl() : h_file( INVALID_HANDLE_VALUE ), h_mapping( NULL ), buffer( NULL ), file_size( 0 ) {}
+
+    HANDLE h_file;
+    HANDLE h_mapping;
+    void*  buffer;
+    uint64 file_size;
+};
+
+DiskMappedFile::DiskMappedFile() : impl( new Impl() ) {}
+
+const void* DiskMappedFile::init(const char* file_name)
+{
+    release();
+
+    impl->h_file = CreateFileA(
+        file_name,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL );
+
+    if (impl->h_file == INVALID_HANDLE_VALUE)
+        throw mapping_error( file_name, GetLastError() );
+
+    LARGE_INTEGER file_size;
+    if (GetFileSizeEx( impl->h_file, &file_size ) == FALSE)
+        throw mapping_error( file_name, GetLastError() );
+
+    impl->file_size = uint64( file_size.QuadPart );
+    if (impl->file_size == 0)
+        return NULL;
+
+    impl->h_mapping = CreateFileMapping(
+        impl->h_file,
+        NULL,
+        PAGE_READONLY,
+        0,
+        0,
+        NULL );
+
+    if (impl->h_mapping == NULL)
+        throw mapping_error( file_name, GetLastError() );
+
+    impl->buffer = MapViewOfFile(
+        impl->h_mapping,
+        FILE_MAP_READ,
+        0,
+        0,
+        0 );
+
+    if (impl->buffer == NULL)
+        throw view_error( file_name, GetLastError() );
+
+    log_verbose(stderr, "mapped file \"%s\" (%.2f %s)\n", file_name, (impl->file_size > 1024*1024 ? float(impl->file_size)/float(1024*1024) : float(impl->file_size)), (impl->file_size > 1024*1024 ? "MB" : "B"));
+    return impl->buffer;
+}
+void DiskMappedFile::release()
+{
+    if (impl->buffer != NULL)                 UnmapViewOfFile( impl->buffer );
+    if (impl->h_mapping != NULL)              CloseHandle( impl->h_mapping );
+    if (impl->h_file != INVALID_HANDLE_VALUE) CloseHandle( impl->h_file );
+
+    impl->h_file    = INVALID_HANDLE_VALUE;
+    impl->h_mapping = NULL;
+    impl->buffer    = NULL;
+    impl->file_size = 0;
+}
+
+DiskMappedFile::~DiskMappedFile()
+{
+    release();
+
+    delete impl;
+}
+
+const void* DiskMappedFile::data() const { return impl->buffer; }
+uint64      DiskMappedFile::size() const { return impl->file_size; }
+
 } // namespace nvbio
 
 #else
@@ -257,6 +339,69 @@ ServerMappedFile::~ServerMappedFile()
     delete impl;
 }
 
+struct DiskMappedFile::Impl
+{
+    Impl() : h_file( -1 ), buffer( NULL ), file_size( 0 ) {}
+
+    int         h_file;
+    void*       buffer;
+    uint64      file_size;
+};
+
+DiskMappedFile::DiskMappedFile() : impl( new Impl() ) {}
+
+const void* DiskMappedFile::init(const char* file_name)
+{
+    release();
+
+    impl->h_file = open( file_name, O_RDONLY );
+    if (impl->h_file == -1)
+        throw mapping_error( file_name, errno );
+
+    struct stat file_stat;
+    if (fstat( impl->h_file, &file_stat ) == -1)
+        throw mapping_error( file_name, errno );
+
+    impl->file_size = uint64( file_stat.st_size );
+    if (impl->file_size == 0)
+        return NULL;
+
+    void* buffer = mmap(
+        NULL,
+        impl->file_size,
+        PROT_READ,
+        MAP_SHARED,
+        impl->h_file,
+        0 );
+
+    if (buffer == MAP_FAILED)
+        throw view_error( file_name, errno );
+
+    impl->buffer = buffer;
+
+    log_verbose(stderr, "mapped file \"%s\" (%.2f %s)\n", file_name, (impl->file_size > 1024*1024 ? float(impl->file_size)/float(1024*1024) : float(impl->file_size)), (impl->file_size > 1024*1024 ? "MB" : "B"));
+    return impl->buffer;
+}
+void DiskMappedFile::release()
+{
+    if (impl->buffer != NULL) munmap( impl->buffer, impl->file_size );
+    if (impl->h_file != -1)   close( impl->h_file );
+
+    impl->h_file    = -1;
+    impl->buffer    = NULL;
+    impl->file_size = 0;
+}
+
+DiskMappedFile::~DiskMappedFile()
+{
+    release();
+
+    delete impl;
+}
+
+const void* DiskMappedFile::data() const { return impl->buffer; }
+uint64      DiskMappedFile::size() const { return impl->file_size; }
+
 } // namespace nvbio
 
 #endif
@@ -39,6 +39,7 @@ namespace nvbio {
 ///
 /// - MappedFile
 /// - ServerMappedFile
+/// - DiskMappedFile
 ///
 /// \section MMAPExampleSection Example
 ///
@@ -162,6 +163,60 @@ private:
     Impl* impl;
 };
 
+///
+/// A class to map a regular file read-only into the process address space.
+/// The mapping is shared through the OS page cache, so that several processes
+/// mapping the same file share the same physical pages.
+///
+struct DiskMappedFile
+{
+    struct mapping_error
+    {
+        mapping_error(const char* name, int32 code) : m_file_name( name ), m_code( code ) {}
+
+        const char* m_file_name;
+        int32       m_code;
+    };
+    struct view_error
+    {
+        view_error(const char* name, uint32 code) : m_file_name( name ), m_code( code ) {}
+
+        const char* m_file_name;
+        int32       m_code;
+    };
+
+    /// constructor
+    ///
+    DiskMappedFile();
+
+    /// destructor
+    ///
+    ~DiskMappedFile();
+
+    /// map the given file, releasing any previous mapping
+    ///
+    /// \return     the address of the mapped file
+    ///
+    const void* init(const char* file_name);
+
+    /// return the address of the mapped file
+    ///
+    const void* data() const;
+
+    /// return the size of the mapped file
+    ///
+    uint64 size() const;
+
+private:
+    DiskMappedFile(const DiskMappedFile&);
+    DiskMappedFile& operator=(const DiskMappedFile&);
+
+    void release();
+
+    struct Impl;
+    Impl* impl;
+};
+
 ///@} MemoryMappingModule
 ///@} Basic
 
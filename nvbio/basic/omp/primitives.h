@@ -0,0 +1,259 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/basic/console.h>
+#include <nvbio/basic/omp.h>
+#include <iterator>
+
+/// \page omp_primitives_page Host Parallel Primitives
+///
+/// This module provides a set of OpenMP-based host-wide parallel primitives,
+/// which are automatically used by the \ref Primitives "system-wide primitives"
+/// whenever the host_tag backend is selected and the input is large enough
+/// to amortize the threading overhead.
+/// All temporary storage is allocated within a single vector passed by the user,
+/// which can be safely reused across function calls.
+///
+/// - omp::reduce()
+/// - omp::inclusive_scan()
+/// - omp::exclusive_scan()
+/// - omp::copy_flagged()
+/// - omp::copy_if()
+/// - omp::runlength_encode()
+/// - omp::reduce_by_key()
+/// - omp::radix_sort()
+///
+
+namespace nvbio {
+namespace omp {
+
+///@addtogroup Basic
+///@{
+
+///@defgroup OMPPrimitives Host Parallel Primitives
+/// This module provides a set of OpenMP-based host-wide parallel primitives.
+/// All temporary storage is allocated within a single host vector
+/// passed by the user, which can be safely reused across function calls.
+///@{
+
+/// the minimum input size for which the system-wide host primitives
+/// dispatch to the parallel implementations
+///
+static const uint32 PARALLEL_THRESHOLD = 64u*1024u;
+
+/// number of bits processed by each radix sort pass
+///
+static const uint32 RADIX_BITS = 8u;
+
+/// a trait class specifying whether a key type can be radix-sorted,
+/// and how to map it to an order-preserving unsigned word
+///
+template <typename T> struct radix_traits { static const bool is_sortable = false; };
+
+template <> struct radix_traits<uint8>  { static const bool is_sortable = true; typedef uint8  word_type; static word_type word(const uint8  k) { return k; } };
+template <> struct radix_traits<uint16> { static const bool is_sortable = true; typedef uint16 word_type; static word_type word(const uint16 k) { return k; } };
+template <> struct radix_traits<uint32> { static const bool is_sortable = true; typedef uint32 word_type; static word_type word(const uint32 k) { return k; } };
+template <> struct radix_traits<uint64> { static const bool is_sortable = true; typedef uint64 word_type; static word_type word(const uint64 k) { return k; } };
+template <> struct radix_traits<int8>   { static const bool is_sortable = true; typedef uint8  word_type; static word_type word(const int8   k) { return word_type(k) ^ 0x80u; } };
+template <> struct radix_traits<int16>  { static const bool is_sortable = true; typedef uint16 word_type; static word_type word(const int16  k) { return word_type(k) ^ 0x8000u; } };
+template <> struct radix_traits<int32>  { static const bool is_sortable = true; typedef uint32 word_type; static word_type word(const int32  k) { return word_type(k) ^ 0x80000000u; } };
+template <> struct radix_traits<int64>  { static const bool is_sortable = true; typedef uint64 word_type; static word_type word(const int64  k) { return word_type(k) ^ 0x8000000000000000ull; } };
+
+/// make sure a given buffer is as big as size;
+/// <b>note:</b> upon reallocations, the contents of the buffer are invalidated
+///
+template <typename VectorType>
+void alloc_temp_storage(VectorType& vec, const uint64 size);
+
+/// host-wide reduce, returning op( ... op( op( init, in[0] ), in[1] ) ..., in[n-1] ),
+/// with the items grouped in any order allowed by the associativity of op
+///
+/// \param n                    number of items to reduce
+/// \param in                   a host input iterator
+/// \param op                   the binary reduction operator
+/// \param init                 the initial value, whose type is the type of the result
+/// \param temp_storage         some temporary storage
+///
+template <typename InputIterator, typename BinaryOp, typename T, typename VectorType>
+T reduce(
+    const uint32                        n,
+    InputIterator                       in,
+    BinaryOp                            op,
+    const T                             init,
+    VectorType&                         temp_storage);
+
+/// host-wide inclusive scan
+///
+/// \param n                    number of items to reduce
+/// \param in                   a host input iterator
+/// \param out                  a host output iterator
+/// \param op                   the binary reduction operator
+/// \param temp_storage         some temporary storage
+///
+template <typename InputIterator, typename OutputIterator, typename BinaryOp, typename VectorType>
+void inclusive_scan(
+    const uint32                        n,
+    InputIterator                       in,
+    OutputIterator                      out,
+    BinaryOp                            op,
+    VectorType&                         temp_storage);
+
+/// host-wide exclusive scan
+///
+/// \param n                    number of items to reduce
+/// \param in                   a host input iterator
+/// \param out                  a host output iterator
+/// \param op                   the binary reduction operator
+/// \param identity             the identity element
+/// \param temp_storage         some temporary storage
+///
+template <typename InputIterator, typename OutputIterator, typename BinaryOp, typename Identity, typename VectorType>
+void exclusive_scan(
+    const uint32                        n,
+    InputIterator                       in,
+    OutputIterator                      out,
+    BinaryOp                            op,
+    Identity                            identity,
+    VectorType&                         temp_storage);
+
+/// host-wide copy of flagged items
+///
+/// \param n                    number of input items
+/// \param in                   a host input iterator
+/// \param flags                a host flags iterator
+/// \param out                  a host output iterator
+/// \param temp_storage         some temporary storage
+///
+/// \return                     the number of copied items
+///
+template <typename InputIterator, typename FlagsIterator, typename OutputIterator, typename VectorType>
+uint32 copy_flagged(
+    const uint32                        n,
+    InputIterator                       in,
+    FlagsIterator                       flags,
+    OutputIterator                      out,
+    VectorType&                         temp_storage);
+
+/// host-wide copy of predicated items
+///
+/// \param n                    number of input items
+/// \param in                   a host input iterator
+/// \param out                  a host output iterator
+/// \param pred                 a unary predicate functor
+/// \param temp_storage         some temporary storage
+///
+/// \return                     the number of copied items
+///
+template <typename InputIterator, typename OutputIterator, typename Predicate, typename VectorType>
+uint32 copy_if(
+    const uint32                        n,
+    InputIterator                       in,
+    OutputIterator                      out,
+    const Predicate                     pred,
+    VectorType&                         temp_storage);
+
+/// host-wide run-length encode
+///
+/// \param n                    number of input items
+/// \param in                   a host input iterator
+/// \param out                  a host output iterator
+/// \param counts               a host output count iterator
+/// \param temp_storage         some temporary storage
+///
+/// \return                     the number of runs
+///
+template <typename InputIterator, typename OutputIterator, typename CountIterator, typename VectorType>
+uint32 runlength_encode(
+    const uint32                        n,
+    InputIterator                       in,
+    OutputIterator                      out,
+    CountIterator                       counts,
+    VectorType&                         temp_storage);
+
+/// host-wide reduce by key
+///
+/// \param n                    number of input items
+/// \param keys_in              a host input iterator
+/// \param values_in            a host input iterator
+/// \param keys_out             a host output iterator
+/// \param values_out           a host output iterator; must be readable, as partial
+///                             segments spanning several threads are merged in place
+/// \param reduction_op         a reduction operator
+/// \param temp_storage         some temporary storage
+///
+/// \return                     the number of segments
+///
+template <typename KeyIterator, typename ValueIterator, typename OutputKeyIterator, typename OutputValueIterator, typename ReductionOp, typename VectorType>
+uint32 reduce_by_key(
+    const uint32                        n,
+    KeyIterator                         keys_in,
+    ValueIterator                       values_in,
+    OutputKeyIterator                   keys_out,
+    OutputValueIterator                 values_out,
+    ReductionOp                         reduction_op,
+    VectorType&                         temp_storage);
+
+/// host-wide LSD radix-sort, using per-thread digit histograms;
+/// the key type must be an integer type (see radix_traits)
+///
+/// \param n                    number of input items
+/// \param keys                 a host input iterator of keys to be sorted
+/// \param temp_storage         some temporary storage
+///
+template <typename KeyIterator, typename VectorType>
+void radix_sort(
+    const uint32                        n,
+    KeyIterator                         keys,
+    VectorType&                         temp_storage);
+
+/// host-wide LSD radix-sort by key, using per-thread digit histograms;
+/// the key type must be an integer type (see radix_traits)
+///
+/// \param n                    number of input items
+/// \param keys                 a host input iterator of keys to be sorted
+/// \param values               a host input iterator of values to be sorted
+/// \param temp_storage         some temporary storage
+///
+template <typename KeyIterator, typename ValueIterator, typename VectorType>
+void radix_sort(
+    const uint32                        n,
+    KeyIterator                         keys,
+    ValueIterator                       values,
+    VectorType&                         temp_storage);
+
+///@} // end of the OMPPrimitives group
+///@} // end of the Basic group
+
+} // namespace omp
+} // namespace nvbio
+
+#include <nvbio/basic/omp/primitives_inl.h>
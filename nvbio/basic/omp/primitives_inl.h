@@ -0,0 +1,691 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+
+namespace nvbio {
+namespace omp {
+
+namespace priv {
+
+// a block partition of the range [0,n) in n_blocks contiguous chunks
+//
+struct block_partition
+{
+    block_partition(const uint32 _n, const uint32 _n_blocks) : n( _n ), n_blocks( _n_blocks ) {}
+
+    uint32 begin(const uint32 i) const { return uint32( (uint64(n) * i) / n_blocks ); }
+    uint32 end(const uint32 i)   const { return uint32( (uint64(n) * (i+1)) / n_blocks ); }
+
+    uint32 n;
+    uint32 n_blocks;
+};
+
+// return the number of blocks to use for a given problem size
+//
+inline uint32 suggested_blocks(const uint32 n)
+{
+    const uint32 n_threads = uint32( omp_get_max_threads() );
+
+    // make sure each block has at least a few thousand items
+    return nvbio::max( nvbio::min( n_threads, n / 4096u ), 1u );
+}
+
+// carve a typed array out of a byte buffer, advancing the offset
+//
+template <typename T>
+T* carve(uint8* base, uint64& offset, const uint64 count)
+{
+    T* ptr = reinterpret_cast<T*>( base + offset );
+    offset += align<16>( count * sizeof(T) );
+    return ptr;
+}
+
+// a value accessor returning the i-th element of an iterator
+//
+template <typename Iterator>
+struct iterator_values
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+    iterator_values(const Iterator _it) : it( _it ) {}
+
+    value_type operator() (const uint32 i) const { return it[i]; }
+
+    Iterator it;
+};
+
+// a value accessor returning 1 for each element (used to implement run-length encoding)
+//
+struct unit_values
+{
+    typedef uint32 value_type;
+
+    uint32 operator() (const uint32 i) const { return 1u; }
+};
+
+// a segmented reduction, where segments are identified by runs of equal keys:
+//  - pass 1 counts the segment heads in each block;
+//  - pass 2 reduces, in each block, the segments starting in that block up to the block
+//    boundary, and separately the leading partial segment started in a previous block;
+//  - a final serial pass over the blocks merges the leading partials into their segments.
+//
+template <typename KeyIterator, typename ValueAccessor, typename OutputKeyIterator, typename OutputValueIterator, typename ReductionOp, typename VectorType>
+uint32 reduce_segments(
+    const uint32            n,
+    KeyIterator             keys_in,
+    const ValueAccessor     values_in,
+    OutputKeyIterator       keys_out,
+    OutputValueIterator     values_out,
+    ReductionOp             op,
+    VectorType&             temp_storage)
+{
+    typedef typename ValueAccessor::value_type value_type;
+
+    if (n == 0)
+        return 0u;
+
+    const uint32          n_blocks = suggested_blocks( n );
+    const block_partition blocks( n, n_blocks );
+
+    alloc_temp_storage( temp_storage, align<16>( (n_blocks+1) * sizeof(uint32) ) + align<16>( n_blocks * sizeof(value_type) ) );
+
+    uint64 offset = 0;
+    uint32*     block_offsets  = carve<uint32>(     (uint8*)&temp_storage[0], offset, n_blocks+1 );
+    value_type* block_partials = carve<value_type>( (uint8*)&temp_storage[0], offset, n_blocks );
+
+    // count the segment heads in each block
+    #pragma omp parallel for num_threads(n_blocks)
+    for (int32 b = 0; b < int32( n_blocks ); ++b)
+    {
+        uint32 n_heads = 0;
+        for (uint32 i = blocks.begin(b); i < blocks.end(b); ++i)
+            n_heads += (i == 0 || !(keys_in[i] == keys_in[i-1])) ? 1u : 0u;
+
+        block_offsets[b] = n_heads;
+    }
+
+    // scan the block counts
+    uint32 n_segments = 0;
+    for (uint32 b = 0; b < n_blocks; ++b)
+    {
+        const uint32 c = block_offsets[b];
+        block_offsets[b] = n_segments;
+        n_segments += c;
+    }
+    block_offsets[ n_blocks ] = n_segments;
+
+    // reduce the segments within each block
+    #pragma omp parallel for num_threads(n_blocks)
+    for (int32 b = 0; b < int32( n_blocks ); ++b)
+    {
+        const uint32 begin = blocks.begin(b);
+        const uint32 end   = blocks.end(b);
+
+        uint32 i = begin;
+
+        // reduce the leading partial segment, if any
+        if (i < end && i > 0 && keys_in[i] == keys_in[i-1])
+        {
+            value_type partial = values_in(i);
+            for (++i; i < end && keys_in[i] == keys_in[i-1]; ++i)
+                partial = op( partial, values_in(i) );
+
+            block_partials[b] = partial;
+        }
+
+        // reduce all segments starting in this block
+        uint32 out_idx = block_offsets[b];
+        while (i < end)
+        {
+            keys_out[ out_idx ] = keys_in[i];
+
+            value_type partial = values_in(i);
+            for (++i; i < end && keys_in[i] == keys_in[i-1]; ++i)
+                partial = op( partial, values_in(i) );
+
+            values_out[ out_idx++ ] = partial;
+        }
+    }
+
+    // merge the leading partial segments of each block, left to right
+    for (uint32 b = 1; b < n_blocks; ++b)
+    {
+        const uint32 begin = blocks.begin(b);
+        if (begin < blocks.end(b) && keys_in[begin] == keys_in[begin-1])
+        {
+            const uint32 out_idx = block_offsets[b] - 1u;
+            values_out[ out_idx ] = op( value_type( values_out[ out_idx ] ), block_partials[b] );
+        }
+    }
+    return n_segments;
+}
+
+// a block-wise compaction:
+//  - pass 1 counts the selected items in each block;
+//  - pass 2 scatters them at the scanned block offsets
+//
+template <typename InputIterator, typename Selector, typename OutputIterator, typename VectorType>
+uint32 compact(
+    const uint32        n,
+    InputIterator       in,
+    const Selector      sel,
+    OutputIterator      out,
+    VectorType&         temp_storage)
+{
+    if (n == 0)
+        return 0u;
+
+    const uint32          n_blocks = suggested_blocks( n );
+    const block_partition blocks( n, n_blocks );
+
+    alloc_temp_storage( temp_storage, (n_blocks+1) * sizeof(uint32) );
+
+    uint32* block_offsets = reinterpret_cast<uint32*>( &temp_storage[0] );
+
+    #pragma omp parallel for num_threads(n_blocks)
+    for (int32 b = 0; b < int32( n_blocks ); ++b)
+    {
+        uint32 n_selected = 0;
+        for (uint32 i = blocks.begin(b); i < blocks.end(b); ++i)
+            n_selected += sel(i) ? 1u : 0u;
+
+        block_offsets[b] = n_selected;
+    }
+
+    uint32 n_selected = 0;
+    for (uint32 b = 0; b < n_blocks; ++b)
+    {
+        const uint32 c = block_offsets[b];
+        block_offsets[b] = n_selected;
+        n_selected += c;
+    }
+
+    #pragma omp parallel for num_threads(n_blocks)
+    for (int32 b = 0; b < int32( n_blocks ); ++b)
+    {
+        uint32 out_idx = block_offsets[b];
+        for (uint32 i = blocks.begin(b); i < blocks.end(b); ++i)
+        {
+            if (sel(i))
+                out[ out_idx++ ] = in[i];
+        }
+    }
+    return n_selected;
+}
+
+// a selector evaluating a flag iterator
+//
+template <typename FlagsIterator>
+struct flag_selector
+{
+    flag_selector(const FlagsIterator _flags) : flags( _flags ) {}
+
+    bool operator() (const uint32 i) const { return flags[i] ? true : false; }
+
+    FlagsIterator flags;
+};
+
+// a selector evaluating a predicate over an input iterator
+//
+template <typename InputIterator, typename Predicate>
+struct predicate_selector
+{
+    predicate_selector(const InputIterator _in, const Predicate _pred) : in( _in ), pred( _pred ) {}
+
+    bool operator() (const uint32 i) const { return pred( in[i] ) ? true : false; }
+
+    InputIterator   in;
+    Predicate       pred;
+};
+
+// the core of the LSD radix sort: sort the keys in keys_buf[0], using keys_buf[1] as
+// a ping-pong buffer, optionally permuting the values in values_buf[0] alongside;
+// returns the index of the buffer holding the final result.
+//
+// Each thread builds a histogram of the current digit over its own block of keys;
+// the histograms are then scanned in (digit, thread) order, so that each thread
+// can scatter its keys to disjoint, stable output ranges.
+// Passes where all keys share the same digit are skipped altogether.
+//
+template <typename key_type, typename value_type, bool VALUES>
+uint32 radix_sort_passes(
+    const uint32        n,
+    key_type*           keys_buf[2],
+    value_type*         values_buf[2],
+    uint32*             histograms)
+{
+    typedef radix_traits<key_type>                  traits_type;
+    typedef typename traits_type::word_type         word_type;
+
+    const uint32 N_DIGITS  = 1u << RADIX_BITS;
+    const uint32 N_PASSES  = util::divide_ri( uint32( sizeof(word_type)*8u ), RADIX_BITS );
+
+    const uint32          n_blocks = suggested_blocks( n );
+    const block_partition blocks( n, n_blocks );
+
+    uint32 selector = 0;
+
+    for (uint32 pass = 0; pass < N_PASSES; ++pass)
+    {
+        const uint32 shift = pass * RADIX_BITS;
+
+        const key_type* in_keys  = keys_buf[ selector ];
+              key_type* out_keys = keys_buf[ selector ^ 1u ];
+
+        // build the per-thread histograms
+        #pragma omp parallel for num_threads(n_blocks)
+        for (int32 b = 0; b < int32( n_blocks ); ++b)
+        {
+            uint32* hist = histograms + b * N_DIGITS;
+            for (uint32 d = 0; d < N_DIGITS; ++d)
+                hist[d] = 0u;
+
+            for (uint32 i = blocks.begin(b); i < blocks.end(b); ++i)
+                ++hist[ uint32( traits_type::word( in_keys[i] ) >> shift ) & (N_DIGITS-1u) ];
+        }
+
+        // scan the histograms in digit-major order, checking whether this pass is trivial
+        uint32 sum     = 0;
+        bool   trivial = false;
+        for (uint32 d = 0; d < N_DIGITS; ++d)
+        {
+            const uint32 digit_begin = sum;
+            for (uint32 b = 0; b < n_blocks; ++b)
+            {
+                const uint32 c = histograms[ b * N_DIGITS + d ];
+                histograms[ b * N_DIGITS + d ] = sum;
+                sum += c;
+            }
+            if (sum - digit_begin == n)
+                trivial = true;
+        }
+        if (trivial)
+            continue;
+
+        // scatter the keys (and values) to their final positions
+        #pragma omp parallel for num_threads(n_blocks)
+        for (int32 b = 0; b < int32( n_blocks ); ++b)
+        {
+            uint32* offsets = histograms + b * N_DIGITS;
+
+            for (uint32 i = blocks.begin(b); i < blocks.end(b); ++i)
+            {
+                const key_type key   = in_keys[i];
+                const uint32   digit = uint32( traits_type::word( key ) >> shift ) & (N_DIGITS-1u);
+                const uint32   slot  = offsets[ digit ]++;
+
+                out_keys[ slot ] = key;
+                if (VALUES)
+                    values_buf[ selector ^ 1u ][ slot ] = values_buf[ selector ][i];
+            }
+        }
+
+        selector ^= 1u;
+    }
+    return selector;
+}
+
+} // namespace priv
+
+// make sure a given buffer is as big as size;
+// <b>note:</b> upon reallocations, the contents of the buffer are invalidated
+//
+template <typename VectorType>
+void alloc_temp_storage(VectorType& vec, const uint64 size)
+{
+    if (vec.size() < size)
+    {
+        try
+        {
+            vec.clear();
+            vec.resize( size );
+        }
+        catch (...)
+        {
+            log_error(stderr,"alloc_temp_storage() : allocation failed! (%llu entries / %llu bytes)\n", size, size * sizeof(typename VectorType::value_type));
+            throw;
+        }
+    }
+}
+
+// host-wide reduce
+//
+template <typename InputIterator, typename BinaryOp, typename T, typename VectorType>
+T reduce(
+    const uint32                        n,
+    InputIterator                       in,
+    BinaryOp                            op,
+    const T                             init,
+    VectorType&                         temp_storage)
+{
+    if (n == 0)
+        return init;
+
+    const uint32                 n_blocks = priv::suggested_blocks( n );
+    const priv::block_partition  blocks( n, n_blocks );
+
+    alloc_temp_storage( temp_storage, n_blocks * sizeof(T) );
+
+    T* partials = reinterpret_cast<T*>( &temp_storage[0] );
+
+    #pragma omp parallel for num_threads(n_blocks)
+    for (int32 b = 0; b < int32( n_blocks ); ++b)
+    {
+        const uint32 begin = blocks.begin(b);
+        const uint32 end   = blocks.end(b);
+
+        T r = T( in[ begin ] );
+        for (uint32 i = begin + 1; i < end; ++i)
+            r = op( r, T( in[i] ) );
+
+        partials[b] = r;
+    }
+
+    T r = init;
+    for (uint32 b = 0; b < n_blocks; ++b)
+        r = op( r, partials[b] );
+
+    return r;
+}
+
+// host-wide inclusive scan
+//
+template <typename InputIterator, typename OutputIterator, typename BinaryOp, typename VectorType>
+void inclusive_scan(
+    const uint32                        n,
+    InputIterator                       in,
+    OutputIterator                      out,
+    BinaryOp                            op,
+    VectorType&                         temp_storage)
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    if (n == 0)
+        return;
+
+    const uint32                 n_blocks = priv::suggested_blocks( n );
+    const priv::block_partition  blocks( n, n_blocks );
+
+    alloc_temp_storage( temp_storage, n_blocks * sizeof(value_type) );
+
+    value_type* partials = reinterpret_cast<value_type*>( &temp_storage[0] );
+
+    // pass 1: reduce each block
+    #pragma omp parallel for num_threads(n_blocks)
+    for (int32 b = 0; b < int32( n_blocks ); ++b)
+    {
+        const uint32 begin = blocks.begin(b);
+        const uint32 end   = blocks.end(b);
+
+        value_type r = in[ begin ];
+        for (uint32 i = begin + 1; i < end; ++i)
+            r = op( r, value_type( in[i] ) );
+
+        partials[b] = r;
+    }
+
+    // turn the block reductions into inclusive block prefixes
+    for (uint32 b = 1; b < n_blocks; ++b)
+        partials[b] = op( partials[b-1], partials[b] );
+
+    // pass 2: scan each block, seeded with the prefix of all the preceding ones
+    #pragma omp parallel for num_threads(n_blocks)
+    for (int32 b = 0; b < int32( n_blocks ); ++b)
+    {
+        const uint32 begin = blocks.begin(b);
+        const uint32 end   = blocks.end(b);
+
+        value_type r = b ? op( partials[b-1], value_type( in[ begin ] ) ) : value_type( in[ begin ] );
+        out[ begin ] = r;
+
+        for (uint32 i = begin + 1; i < end; ++i)
+        {
+            r = op( r, value_type( in[i] ) );
+            out[i] = r;
+        }
+    }
+}
+
+// host-wide exclusive scan
+//
+template <typename InputIterator, typename OutputIterator, typename BinaryOp, typename Identity, typename VectorType>
+void exclusive_scan(
+    const uint32                        n,
+    InputIterator                       in,
+    OutputIterator                      out,
+    BinaryOp                            op,
+    Identity                            identity,
+    VectorType&                         temp_storage)
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    if (n == 0)
+        return;
+
+    const uint32                 n_blocks = priv::suggested_blocks( n );
+    const priv::block_partition  blocks( n, n_blocks );
+
+    alloc_temp_storage( temp_storage, n_blocks * sizeof(value_type) );
+
+    value_type* partials = reinterpret_cast<value_type*>( &temp_storage[0] );
+
+    // pass 1: reduce each block
+    #pragma omp parallel for num_threads(n_blocks)
+    for (int32 b = 0; b < int32( n_blocks ); ++b)
+    {
+        const uint32 begin = blocks.begin(b);
+        const uint32 end   = blocks.end(b);
+
+        value_type r = in[ begin ];
+        for (uint32 i = begin + 1; i < end; ++i)
+            r = op( r, value_type( in[i] ) );
+
+        partials[b] = r;
+    }
+
+    // turn the block reductions into exclusive block prefixes
+    {
+        value_type r = value_type( identity );
+        for (uint32 b = 0; b < n_blocks; ++b)
+        {
+            const value_type c = partials[b];
+            partials[b] = r;
+            r = op( r, c );
+        }
+    }
+
+    // pass 2: scan each block, seeded with the prefix of all the preceding ones
+    #pragma omp parallel for num_threads(n_blocks)
+    for (int32 b = 0; b < int32( n_blocks ); ++b)
+    {
+        value_type r = partials[b];
+
+        for (uint32 i = blocks.begin(b); i < blocks.end(b); ++i)
+        {
+            const value_type v = in[i]; // read before writing, to allow in-place scans
+            out[i] = r;
+            r = op( r, v );
+        }
+    }
+}
+
+// host-wide copy of flagged items
+//
+template <typename InputIterator, typename FlagsIterator, typename OutputIterator, typename VectorType>
+uint32 copy_flagged(
+    const uint32                        n,
+    InputIterator                       in,
+    FlagsIterator                       flags,
+    OutputIterator                      out,
+    VectorType&                         temp_storage)
+{
+    return priv::compact( n, in, priv::flag_selector<FlagsIterator>( flags ), out, temp_storage );
+}
+
+// host-wide copy of predicated items
+//
+template <typename InputIterator, typename OutputIterator, typename Predicate, typename VectorType>
+uint32 copy_if(
+    const uint32                        n,
+    InputIterator                       in,
+    OutputIterator                      out,
+    const Predicate                     pred,
+    VectorType&                         temp_storage)
+{
+    return priv::compact( n, in, priv::predicate_selector<InputIterator,Predicate>( in, pred ), out, temp_storage );
+}
+
+// host-wide run-length encode
+//
+template <typename InputIterator, typename OutputIterator, typename CountIterator, typename VectorType>
+uint32 runlength_encode(
+    const uint32                        n,
+    InputIterator                       in,
+    OutputIterator                      out,
+    CountIterator                       counts,
+    VectorType&                         temp_storage)
+{
+    return priv::reduce_segments(
+        n,
+        in,
+        priv::unit_values(),
+        out,
+        counts,
+        add_functor(),
+        temp_storage );
+}
+
+// host-wide reduce by key
+//
+template <typename KeyIterator, typename ValueIterator, typename OutputKeyIterator, typename OutputValueIterator, typename ReductionOp, typename VectorType>
+uint32 reduce_by_key(
+    const uint32                        n,
+    KeyIterator                         keys_in,
+    ValueIterator                       values_in,
+    OutputKeyIterator                   keys_out,
+    OutputValueIterator                 values_out,
+    ReductionOp                         reduction_op,
+    VectorType&                         temp_storage)
+{
+    return priv::reduce_segments(
+        n,
+        keys_in,
+        priv::iterator_values<ValueIterator>( values_in ),
+        keys_out,
+        values_out,
+        reduction_op,
+        temp_storage );
+}
+
+// host-wide LSD radix-sort
+//
+template <typename KeyIterator, typename VectorType>
+void radix_sort(
+    const uint32                        n,
+    KeyIterator                         keys,
+    VectorType&                         temp_storage)
+{
+    typedef typename std::iterator_traits<KeyIterator>::value_type key_type;
+
+    const uint32 N_DIGITS = 1u << RADIX_BITS;
+    const uint32 n_blocks = priv::suggested_blocks( n );
+
+    alloc_temp_storage( temp_storage,
+        2u * align<16>( uint64(n) * sizeof(key_type) ) +
+        align<16>( n_blocks * N_DIGITS * sizeof(uint32) ) );
+
+    uint64 offset = 0;
+    key_type* keys_buf[2];
+    keys_buf[0]        = priv::carve<key_type>( (uint8*)&temp_storage[0], offset, n );
+    keys_buf[1]        = priv::carve<key_type>( (uint8*)&temp_storage[0], offset, n );
+    uint32* histograms = priv::carve<uint32>(   (uint8*)&temp_storage[0], offset, n_blocks * N_DIGITS );
+
+    #pragma omp parallel for if (n >= 4096)
+    for (int64 i = 0; i < int64(n); ++i)
+        keys_buf[0][i] = keys[i];
+
+    uint32* null_values[2] = { NULL, NULL };
+
+    const uint32 selector = priv::radix_sort_passes<key_type,uint32,false>( n, keys_buf, null_values, histograms );
+
+    #pragma omp parallel for if (n >= 4096)
+    for (int64 i = 0; i < int64(n); ++i)
+        keys[i] = keys_buf[ selector ][i];
+}
+
+// host-wide LSD radix-sort by key
+//
+template <typename KeyIterator, typename ValueIterator, typename VectorType>
+void radix_sort(
+    const uint32                        n,
+    KeyIterator                         keys,
+    ValueIterator                       values,
+    VectorType&                         temp_storage)
+{
+    typedef typename std::iterator_traits<KeyIterator>::value_type   key_type;
+    typedef typename std::iterator_traits<ValueIterator>::value_type value_type;
+
+    const uint32 N_DIGITS = 1u << RADIX_BITS;
+    const uint32 n_blocks = priv::suggested_blocks( n );
+
+    alloc_temp_storage( temp_storage,
+        2u * align<16>( uint64(n) * sizeof(key_type) ) +
+        2u * align<16>( uint64(n) * sizeof(value_type) ) +
+        align<16>( n_blocks * N_DIGITS * sizeof(uint32) ) );
+
+    uint64 offset = 0;
+    key_type*   keys_buf[2];
+    value_type* values_buf[2];
+    keys_buf[0]        = priv::carve<key_type>(   (uint8*)&temp_storage[0], offset, n );
+    keys_buf[1]        = priv::carve<key_type>(   (uint8*)&temp_storage[0], offset, n );
+    values_buf[0]      = priv::carve<value_type>( (uint8*)&temp_storage[0], offset, n );
+    values_buf[1]      = priv::carve<value_type>( (uint8*)&temp_storage[0], offset, n );
+    uint32* histograms = priv::carve<uint32>(     (uint8*)&temp_storage[0], offset, n_blocks * N_DIGITS );
+
+    #pragma omp parallel for if (n >= 4096)
+    for (int64 i = 0; i < int64(n); ++i)
+    {
+        keys_buf[0][i]   = keys[i];
+        values_buf[0][i] = values[i];
+    }
+
+    const uint32 selector = priv::radix_sort_passes<key_type,value_type,true>( n, keys_buf, values_buf, histograms );
+
+    #pragma omp parallel for if (n >= 4096)
+    for (int64 i = 0; i < int64(n); ++i)
+    {
+        keys[i]   = keys_buf[ selector ][i];
+        values[i] = values_buf[ selector ][i];
+    }
+}
+
+} // namespace omp
+} // namespace nvbio
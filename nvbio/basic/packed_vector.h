@@ -48,8 +48,9 @@ namespace nvbio {
 /// \tparam SYMBOL_SIZE_T       the number of bits needed for each symbol
 /// \tparam BIG_ENDIAN_T        the "endianness" of the words: if true, symbols will be packed from right to left within each word
 /// \tparam IndexType           the type of integer used to address the stream (e.g. uint32, uint64)
+/// \tparam Allocator           the allocator used for the underlying 32-bit words, see \ref HostAllocatorsModule
 ///
-template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T = false, typename IndexType = uint32>
+template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T = false, typename IndexType = uint32, typename Allocator = typename default_allocator<SystemTag,uint32>::type>
 struct PackedVector
 {
     static const uint32 SYMBOL_SIZE = SYMBOL_SIZE_T;
@@ -60,9 +61,11 @@ struct PackedVector
 
     typedef SystemTag   system_tag;
     typedef IndexType   index_type;
+    typedef Allocator   allocator_type;
 
-    typedef typename nvbio::vector<system_tag,uint32>::pointer                                pointer;
-    typedef typename nvbio::vector<system_tag,uint32>::const_pointer                    const_pointer;
+    typedef nvbio::vector<system_tag,uint32,allocator_type>                                   storage_type;
+    typedef typename storage_type::pointer                                                    pointer;
+    typedef typename storage_type::const_pointer                                        const_pointer;
 
     typedef PackedStream<      pointer,uint8,SYMBOL_SIZE,BIG_ENDIAN,IndexType>                stream_type;
     typedef PackedStream<const_pointer,uint8,SYMBOL_SIZE,BIG_ENDIAN,IndexType>          const_stream_type;
@@ -83,8 +86,8 @@ struct PackedVector
 
     /// copy constructor
     ///
-    template <typename other_tag>
-    PackedVector(const PackedVector<other_tag,SYMBOL_SIZE,BIG_ENDIAN,IndexType>& other) :
+    template <typename other_tag, typename other_allocator>
+    PackedVector(const PackedVector<other_tag,SYMBOL_SIZE,BIG_ENDIAN,IndexType,other_allocator>& other) :
         m_storage( other.m_storage ), m_size( other.m_size ) {}
 
     /// reserve
@@ -150,29 +153,29 @@ struct PackedVector
         return stream[i];
     }
 
-    nvbio::vector<system_tag,uint32> m_storage;
-    index_type                       m_size;
+    storage_type    m_storage;
+    index_type      m_size;
 };
 
 /// return a plain view of a PackedVector object
 ///
-template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
+template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType, typename Allocator>
 inline
-typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::plain_view_type
-plain_view(PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>& vec)
+typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::plain_view_type
+plain_view(PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>& vec)
 {
-    typedef typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::plain_view_type stream;
+    typedef typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::plain_view_type stream;
     return stream( &vec.m_storage.front() );
 }
 
 /// return a plain view of a const PackedVector object
 ///
-template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
+template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType, typename Allocator>
 inline
-typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::const_plain_view_type
-plain_view(const PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>& vec)
+typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::const_plain_view_type
+plain_view(const PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>& vec)
 {
-    typedef typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::const_plain_view_type stream;
+    typedef typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::const_plain_view_type stream;
     return stream( &vec.m_storage.front() );
 }
 
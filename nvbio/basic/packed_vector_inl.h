@@ -31,15 +31,15 @@ namespace nvbio {
 
 // constructor
 //
-template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
-PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::PackedVector(const index_type size) :
+template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType, typename Allocator>
+PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::PackedVector(const index_type size) :
     m_storage( util::divide_ri( size, SYMBOLS_PER_WORD ) ), m_size( size )
 {}
 
 // reserve
 //
-template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
-void PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::reserve(const index_type size)
+template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType, typename Allocator>
+void PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::reserve(const index_type size)
 {
     if (m_storage.size() < util::divide_ri( m_size, SYMBOLS_PER_WORD ))
         m_storage.resize( util::divide_ri( m_size, SYMBOLS_PER_WORD ) );
@@ -47,8 +47,8 @@ void PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::reserve(const
 
 // resize
 //
-template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
-void PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::resize(const index_type size)
+template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType, typename Allocator>
+void PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::resize(const index_type size)
 {
     m_size = size;
     reserve(size);
@@ -57,17 +57,17 @@ void PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::resize(const
 
 // clear
 //
-template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
-void PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::clear(void)
+template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType, typename Allocator>
+void PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::clear(void)
 {
     resize(0);
 }
 
 // return the begin iterator
 //
-template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
-typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::iterator
-PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::begin()
+template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType, typename Allocator>
+typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::iterator
+PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::begin()
 {
     stream_type stream( &m_storage.front() );
     return stream.begin();
@@ -75,9 +75,9 @@ PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::begin()
 
 // return the end iterator
 //
-template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
-typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::iterator
-PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::end()
+template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType, typename Allocator>
+typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::iterator
+PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::end()
 {
     stream_type stream( &m_storage.front() );
     return stream.begin() + m_size;
@@ -85,9 +85,9 @@ PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::end()
 
 // return the begin iterator
 //
-template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
-typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::const_iterator
-PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::begin() const
+template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType, typename Allocator>
+typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::const_iterator
+PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::begin() const
 {
     const_stream_type stream( &m_storage.front() );
     return stream.begin();
@@ -95,9 +95,9 @@ PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::begin() const
 
 // return the end iterator
 //
-template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
-typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::const_iterator
-PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::end() const
+template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType, typename Allocator>
+typename PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::const_iterator
+PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::end() const
 {
     const_stream_type stream( &m_storage.front() );
     return stream.begin() + m_size;
@@ -105,8 +105,8 @@ PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::end() const
 
 // push back a symbol
 //
-template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
-void PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::push_back(const uint8 s)
+template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType, typename Allocator>
+void PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>::push_back(const uint8 s)
 {
     if (m_storage.size() < util::divide_ri( m_size+1, SYMBOLS_PER_WORD ))
         m_storage.resize( util::divide_ri( m_size+1, SYMBOLS_PER_WORD ) );
@@ -116,8 +116,8 @@ void PackedVector<SystemTag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::push_back(con
 
 // return the base address of a symbol in the stream
 // note that several symbols may share the same base address
-template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
-void *PackedVector<SystemTag, SYMBOL_SIZE_T, BIG_ENDIAN_T, IndexType>::addrof(const index_type i)
+template <typename SystemTag, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType, typename Allocator>
+void *PackedVector<SystemTag, SYMBOL_SIZE_T, BIG_ENDIAN_T, IndexType,Allocator>::addrof(const index_type i)
 {
     index_type off = i / SYMBOLS_PER_WORD;
     return &m_storage[off];
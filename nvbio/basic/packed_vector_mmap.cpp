@@ -0,0 +1,141 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <nvbio/basic/packed_vector_mmap.h>
+#include <nvbio/basic/console.h>
+#include <nvbio/basic/exceptions.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace nvbio {
+
+// write a packed file
+//
+bool save_packed_file(
+    const char*     file_name,
+    const char*     magic,
+    const uint32    symbol_size,
+    const bool      big_endian,
+    const uint32    n_strings,
+    const uint64    n_symbols,
+    const uint64    index_size,
+    const void*     index,
+    const uint64    n_words,
+    const uint32*   words)
+{
+    FILE* file = fopen( file_name, "wb" );
+    if (file == NULL)
+    {
+        log_error(stderr, "unable to open \"%s\"\n", file_name);
+        return false;
+    }
+
+    PackedFileInfo info;
+    memcpy( info.magic, magic, 4u );
+    info.symbol_size = symbol_size;
+    info.big_endian  = big_endian ? 1u : 0u;
+    info.n_strings   = n_strings;
+    info.n_symbols   = n_symbols;
+    info.index_size  = util::round_i( index_size, 8u );
+    info.n_words     = n_words;
+
+    const uint64 zero = 0;
+
+    const bool ok =
+        fwrite( &info, sizeof(PackedFileInfo), 1u, file ) == 1u &&
+        (index_size == 0 || fwrite( index, 1u, index_size, file ) == index_size) &&
+        (info.index_size == index_size || fwrite( &zero, 1u, info.index_size - index_size, file ) == info.index_size - index_size) &&
+        (n_words == 0 || fwrite( words, sizeof(uint32), n_words, file ) == n_words);
+
+    fclose( file );
+
+    if (ok == false)
+        log_error(stderr, "failed writing \"%s\"\n", file_name);
+
+    return ok;
+}
+
+// map a packed file, checking its type and its packing format
+//
+const uint32* map_packed_file(
+    DiskMappedFile&     file,
+    const char*         file_name,
+    const char*         magic,
+    const uint32        symbol_size,
+    const bool          big_endian,
+    PackedFileInfo*     info,
+    const void**        index)
+{
+    const uint8* data = (const uint8*)file.init( file_name );
+    if (file.size() < sizeof(PackedFileInfo))
+        throw runtime_error( "\"%s\": not a packed file", file_name );
+
+    *info = *reinterpret_cast<const PackedFileInfo*>( data );
+
+    if (strncmp( info->magic, magic, 4u ) != 0)
+        throw runtime_error( "\"%s\": unexpected packed file type, expected %.4s", file_name, magic );
+
+    if (info->symbol_size != symbol_size || (info->big_endian != 0) != big_endian)
+    {
+        throw runtime_error( "\"%s\": packed with %u-bit %s symbols, expected %u-bit %s",
+            file_name,
+            info->symbol_size, info->big_endian ? "big-endian" : "little-endian",
+            symbol_size,       big_endian       ? "big-endian" : "little-endian" );
+    }
+
+    const uint64 required_size = sizeof(PackedFileInfo) + info->index_size + info->n_words * sizeof(uint32);
+    if (file.size() < required_size ||
+        info->n_words < util::divide_ri( info->n_symbols, uint64( 32u / symbol_size ) ))
+        throw runtime_error( "\"%s\": truncated packed file", file_name );
+
+    if (index)
+        *index = data + sizeof(PackedFileInfo);
+
+    return reinterpret_cast<const uint32*>( data + sizeof(PackedFileInfo) + info->index_size );
+}
+
+// map a .wpac file, as written by nvBWT
+//
+const uint32* map_wpac_file(
+    DiskMappedFile&     file,
+    const char*         file_name,
+    uint64*             n_symbols)
+{
+    const uint8* data = (const uint8*)file.init( file_name );
+    if (file.size() < sizeof(uint64))
+        throw runtime_error( "\"%s\": not a .wpac file", file_name );
+
+    *n_symbols = *reinterpret_cast<const uint64*>( data );
+
+    const uint64 n_words = util::divide_ri( *n_symbols, uint64( 16u ) );
+    if (file.size() < sizeof(uint64) + n_words * sizeof(uint32))
+        throw runtime_error( "\"%s\": truncated .wpac file", file_name );
+
+    return reinterpret_cast<const uint32*>( data + sizeof(uint64) );
+}
+
+} // namespace nvbio
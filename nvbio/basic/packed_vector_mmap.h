@@ -0,0 +1,261 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/basic/mmap.h>
+#include <nvbio/basic/exceptions.h>
+#include <nvbio/basic/packedstream.h>
+#include <nvbio/basic/packed_vector.h>
+
+namespace nvbio {
+
+///@addtogroup Basic
+///@{
+
+///@addtogroup PackedStreams
+///@{
+
+///
+/// The header of an on-disk packed file, laid out as:
+///
+///   - the PackedFileInfo header;
+///   - an optional index block of index_size bytes (e.g. string offsets or ranges),
+///     padded to a multiple of 8 bytes;
+///   - n_words 32-bit words holding the packed symbols.
+///
+/// All blocks are 8-byte aligned, so that once the file is memory mapped they can be
+/// addressed in place.
+///
+struct PackedFileInfo
+{
+    char    magic[4];       ///< the file type identifier
+    uint32  symbol_size;    ///< the number of bits per symbol
+    uint32  big_endian;     ///< the endianness of the packed words
+    uint32  n_strings;      ///< the number of strings, for string-set files
+    uint64  n_symbols;      ///< the number of packed symbols
+    uint64  index_size;     ///< the size of the index block, in bytes
+    uint64  n_words;        ///< the number of packed words
+};
+
+/// write a packed file
+///
+/// \param file_name        the output file name
+/// \param magic            the 4 character file type identifier
+/// \param symbol_size      the number of bits per symbol
+/// \param big_endian       the endianness of the packed words
+/// \param n_strings        the number of strings, for string-set files
+/// \param n_symbols        the number of packed symbols
+/// \param index_size       the size of the index block, in bytes
+/// \param index            the index block
+/// \param n_words          the number of packed words
+/// \param words            the packed words
+///
+/// \return                 true on success
+///
+bool save_packed_file(
+    const char*     file_name,
+    const char*     magic,
+    const uint32    symbol_size,
+    const bool      big_endian,
+    const uint32    n_strings,
+    const uint64    n_symbols,
+    const uint64    index_size,
+    const void*     index,
+    const uint64    n_words,
+    const uint32*   words);
+
+/// map a packed file, checking its type and its packing format;
+/// throws a runtime_error if the file is malformed or does not match the requested format.
+///
+/// \param file             the mapped file object
+/// \param file_name        the input file name
+/// \param magic            the expected 4 character file type identifier
+/// \param symbol_size      the expected number of bits per symbol
+/// \param big_endian       the expected endianness of the packed words
+/// \param info             the output file header
+/// \param index            the output address of the index block
+///
+/// \return                 the address of the packed words
+///
+const uint32* map_packed_file(
+    DiskMappedFile&     file,
+    const char*         file_name,
+    const char*         magic,
+    const uint32        symbol_size,
+    const bool          big_endian,
+    PackedFileInfo*     info,
+    const void**        index = NULL);
+
+/// map a .wpac file, as written by nvBWT: a uint64 sequence length followed by the
+/// 2-bit big-endian packed words; throws a runtime_error if the file is truncated.
+///
+/// \param file             the mapped file object
+/// \param file_name        the input file name
+/// \param n_symbols        the output number of packed symbols
+///
+/// \return                 the address of the packed words
+///
+const uint32* map_wpac_file(
+    DiskMappedFile&     file,
+    const char*         file_name,
+    uint64*             n_symbols);
+
+///
+/// A read-only packed vector backed by a memory mapped packed file.
+/// Its plain view is a PackedStream iterator, hence it can be used anywhere a
+/// const PackedVector would be, without loading the file in memory.
+///
+/// \tparam SYMBOL_SIZE_T       the number of bits needed for each symbol
+/// \tparam BIG_ENDIAN_T        the "endianness" of the words: if true, symbols will be packed from right to left within each word
+/// \tparam IndexType           the type of integer used to address the stream (e.g. uint32, uint64)
+///
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T = false, typename IndexType = uint64>
+struct MappedPackedVector
+{
+    static const uint32 SYMBOL_SIZE = SYMBOL_SIZE_T;
+    static const uint32 BIG_ENDIAN  = BIG_ENDIAN_T;
+
+    static const uint32 SYMBOLS_PER_WORD = 32 / SYMBOL_SIZE;
+    static const uint32 VECTOR_WIDTH     = SYMBOLS_PER_WORD;
+
+    static const char* magic() { return "PVEC"; }
+
+    typedef host_tag    system_tag;
+    typedef IndexType   index_type;
+
+    typedef const uint32*                                                                     pointer;
+    typedef const uint32*                                                               const_pointer;
+
+    typedef PackedStream<const_pointer,uint8,SYMBOL_SIZE,BIG_ENDIAN,IndexType>          const_stream_type;
+    typedef const_stream_type                                                                 stream_type;
+    typedef typename const_stream_type::iterator                                        const_iterator;
+    typedef const_iterator                                                                    iterator;
+    typedef ForwardPackedStream<const_pointer,uint8,SYMBOL_SIZE,BIG_ENDIAN,IndexType>   forward_iterator;
+
+    typedef uint8                                                                             value_type;
+    typedef uint8                                                                       const_reference;
+    typedef uint8                                                                             reference;
+
+    typedef const_stream_type                                                                 plain_view_type;
+    typedef const_stream_type                                                           const_plain_view_type;
+
+    /// constructor
+    ///
+    MappedPackedVector() : m_words( NULL ), m_size( 0 ) {}
+
+    /// map a packed vector file written by save_packed_vector()
+    ///
+    void load(const char* file_name)
+    {
+        PackedFileInfo info;
+        m_words = map_packed_file( m_file, file_name, magic(), SYMBOL_SIZE, BIG_ENDIAN, &info );
+        m_size  = index_type( info.n_symbols );
+    }
+
+    /// map a .wpac file written by nvBWT, which is only valid for 2-bit big-endian vectors
+    ///
+    void load_wpac(const char* file_name)
+    {
+        if (SYMBOL_SIZE != 2u || BIG_ENDIAN == false)
+            throw runtime_error( "\"%s\": .wpac files hold 2-bit big-endian symbols", file_name );
+
+        uint64 n_symbols;
+        m_words = map_wpac_file( m_file, file_name, &n_symbols );
+        m_size  = index_type( n_symbols );
+    }
+
+    /// size
+    ///
+    index_type size() const { return m_size; }
+
+    /// length
+    ///
+    index_type length() const { return m_size; }
+
+    /// return the begin iterator
+    ///
+    const_iterator begin() const { return const_stream_type( m_words ); }
+
+    /// return the end iterator
+    ///
+    const_iterator end() const { return const_stream_type( m_words ) + m_size; }
+
+    /// return the packed words
+    ///
+    const uint32* words() const { return m_words; }
+
+    /// get the i-th symbol
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST uint8 operator[] (const index_type i) const
+    {
+        const const_stream_type stream( m_words );
+        return stream[i];
+    }
+
+    DiskMappedFile  m_file;
+    const uint32*   m_words;
+    index_type      m_size;
+};
+
+/// return a plain view of a MappedPackedVector object
+///
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
+inline
+typename MappedPackedVector<SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::const_plain_view_type
+plain_view(const MappedPackedVector<SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>& vec)
+{
+    typedef typename MappedPackedVector<SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::const_plain_view_type stream;
+    return stream( vec.m_words );
+}
+
+/// save a host PackedVector to a packed vector file which can be later mapped by MappedPackedVector
+///
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType, typename Allocator>
+bool save_packed_vector(const char* file_name, const PackedVector<host_tag,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType,Allocator>& vec)
+{
+    const uint64 n_words = util::divide_ri( uint64( vec.size() ), uint64( 32u / SYMBOL_SIZE_T ) );
+
+    return save_packed_file(
+        file_name,
+        MappedPackedVector<SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::magic(),
+        SYMBOL_SIZE_T,
+        BIG_ENDIAN_T,
+        0u,
+        uint64( vec.size() ),
+        0u,
+        NULL,
+        n_words,
+        n_words ? &vec.m_storage[0] : NULL );
+}
+
+///@} PackedStreams
+///@} Basic
+
+} // namespace nvbio
@@ -42,6 +42,8 @@
 #include <thrust/merge.h>
 #include <thrust/iterator/constant_iterator.h>
 
+#include <nvbio/basic/omp/primitives.h>
+
 #if defined(__CUDACC__)
 #include <nvbio/basic/cuda/primitives.h>
 #include <nvbio/basic/cuda/sort.h>
@@ -79,6 +81,10 @@
 ///\par
 /// The complete list can be found in the \ref Primitives module documentation.
 ///
+///\par
+/// On the host, large inputs are processed by the OpenMP backend described
+/// in the \ref omp_primitives_page "Host Parallel Primitives" page.
+///
 
 namespace nvbio {
 
@@ -391,7 +391,12 @@ typename std::iterator_traits<InputIterator>::value_type reduce(
     BinaryOp                            op,
     nvbio::vector<host_tag,uint8>&      temp_storage)
 {
-    return thrust::reduce( in, in + n, 0u, op );
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    if (n >= omp::PARALLEL_THRESHOLD)
+        return omp::reduce( n, in, op, value_type(0), temp_storage );
+
+    return thrust::reduce( in, in + n, value_type(0), op );
 }
 
 // host-wide inclusive scan
@@ -411,6 +416,12 @@ void inclusive_scan(
     BinaryOp                            op,
     nvbio::vector<host_tag,uint8>&      temp_storage)
 {
+    if (n >= omp::PARALLEL_THRESHOLD)
+    {
+        omp::inclusive_scan( n, in, out, op, temp_storage );
+        return;
+    }
+
     thrust::inclusive_scan(
         in,
         in + n,
@@ -437,6 +448,12 @@ void exclusive_scan(
     Identity                            identity,
     nvbio::vector<host_tag,uint8>&      temp_storage)
 {
+    if (n >= omp::PARALLEL_THRESHOLD)
+    {
+        omp::exclusive_scan( n, in, out, op, identity, temp_storage );
+        return;
+    }
+
     thrust::exclusive_scan(
         in,
         in + n,
@@ -603,6 +620,9 @@ uint32 copy_flagged(
     OutputIterator                  out,
     nvbio::vector<host_tag,uint8>&  temp_storage)
 {
+    if (n >= omp::PARALLEL_THRESHOLD)
+        return omp::copy_flagged( n, in, flags, out, temp_storage );
+
     return uint32( thrust::copy_if(
         in,
         in + n,
@@ -630,6 +650,9 @@ uint32 copy_if(
     const Predicate                     pred,
     nvbio::vector<host_tag,uint8>&      temp_storage)
 {
+    if (n >= omp::PARALLEL_THRESHOLD)
+        return omp::copy_if( n, in, out, pred, temp_storage );
+
     return uint32( thrust::copy_if(
         in,
         in + n,
@@ -656,6 +679,9 @@ uint32 runlength_encode(
     CountIterator                       counts,
     nvbio::vector<host_tag,uint8>&      temp_storage)
 {
+    if (n >= omp::PARALLEL_THRESHOLD)
+        return omp::runlength_encode( n, in, out, counts, temp_storage );
+
     return uint32( thrust::reduce_by_key(
         in,
         in + n,
@@ -690,6 +716,9 @@ uint32 reduce_by_key(
 {
     typedef typename std::iterator_traits<KeyIterator>::value_type key_type;
 
+    if (n >= omp::PARALLEL_THRESHOLD)
+        return omp::reduce_by_key( n, keys_in, values_in, keys_out, values_out, reduction_op, temp_storage );
+
     return uint32( thrust::reduce_by_key(
         keys_in,
         keys_in + n,
@@ -1122,6 +1151,47 @@ void radix_sort(
 
 #endif
 
+// host-wide sort dispatcher: integer keys are sorted with the parallel LSD radix sort
+// whenever the input is large enough, all other key types fall back to a comparison sort
+//
+template <bool RADIX_SORTABLE>
+struct host_sort_dispatch
+{
+    template <typename KeyIterator>
+    static void sort(const uint32 n, KeyIterator keys, nvbio::vector<host_tag,uint8>& temp_storage)
+    {
+        thrust::sort( keys, keys + n );
+    }
+
+    template <typename KeyIterator, typename ValueIterator>
+    static void sort(const uint32 n, KeyIterator keys, ValueIterator values, nvbio::vector<host_tag,uint8>& temp_storage)
+    {
+        thrust::sort_by_key( keys, keys + n, values );
+    }
+};
+
+template <>
+struct host_sort_dispatch<true>
+{
+    template <typename KeyIterator>
+    static void sort(const uint32 n, KeyIterator keys, nvbio::vector<host_tag,uint8>& temp_storage)
+    {
+        if (n >= omp::PARALLEL_THRESHOLD)
+            omp::radix_sort( n, keys, temp_storage );
+        else
+            thrust::sort( keys, keys + n );
+    }
+
+    template <typename KeyIterator, typename ValueIterator>
+    static void sort(const uint32 n, KeyIterator keys, ValueIterator values, nvbio::vector<host_tag,uint8>& temp_storage)
+    {
+        if (n >= omp::PARALLEL_THRESHOLD)
+            omp::radix_sort( n, keys, values, temp_storage );
+        else
+            thrust::stable_sort_by_key( keys, keys + n, values );
+    }
+};
+
 // host-wide sort
 //
 // \param n                    number of input items
@@ -1134,7 +1204,9 @@ void radix_sort(
     KeyIterator                         keys,
     nvbio::vector<host_tag,uint8>&      temp_storage)
 {
-    thrust::sort( keys, keys + n );
+    typedef typename std::iterator_traits<KeyIterator>::value_type key_type;
+
+    host_sort_dispatch<omp::radix_traits<key_type>::is_sortable>::sort( n, keys, temp_storage );
 }
 
 // system-wide sort
@@ -1165,7 +1237,9 @@ void radix_sort(
     ValueIterator                       values,
     nvbio::vector<host_tag,uint8>&      temp_storage)
 {
-    thrust::sort_by_key( keys, keys + n, values, temp_storage );
+    typedef typename std::iterator_traits<KeyIterator>::value_type key_type;
+
+    host_sort_dispatch<omp::radix_traits<key_type>::is_sortable>::sort( n, keys, values, temp_storage );
 }
 
 // system-wide sort by key
@@ -198,6 +198,15 @@ class priority_deque {
 //! @brief Copies an element into the priority deque.
   NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
   void                    push        (const value_type&);
+//! @brief Copies a range of elements into the priority deque.
+  template <typename InputIterator>
+  NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+  void                    push        (InputIterator first, InputIterator last);
+//! @brief Merges a range of elements, keeping at most @a k maximal elements.
+  template <typename InputIterator>
+  NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+  void                    push_top    (InputIterator first, InputIterator last,
+                                       const size_type k);
 
 //!@{
 //! @brief Accesses a maximal element in the deque.
@@ -357,6 +366,71 @@ void priority_deque<T, Sequence, Compare>::push (const value_type& value) {
   heap::push_interval_heap(sequence_.begin(), sequence_.end(), compare_);
 }
 
+/** @param first,last Random-access iterators bounding the range [ @a first, @a last)
+//  @post Priority deque contains its original elements, and copies of those in
+//  the range.
+//  @post All iterators and references are invalidated.
+//
+//  Small ranges are pushed one element at a time, while larger ones are
+//  appended and the whole heap is rebuilt, whichever is cheaper.
+//  @remark Complexity: O(min(m log(n+m), n+m))
+*/
+template <typename T, typename Sequence, typename Compare>
+template <typename InputIterator>
+void priority_deque<T, Sequence, Compare>::push (InputIterator first,
+                                                 InputIterator last)
+{
+  const size_type m = size_type(last - first);
+  const size_type n = size() + m;
+
+  // estimate the cost of m sift-ups against a full rebuild
+  size_type log_n = 1;
+  while ((size_type(1) << log_n) < n)
+    ++log_n;
+
+  if (m * log_n < n)
+  {
+    for (; first != last; ++first)
+      push(*first);
+  }
+  else
+    merge(first, last);
+}
+
+/** @param first,last Input iterators bounding the range [ @a first, @a last)
+//  @param k Maximum number of elements to keep.
+//  @post Priority deque contains the @a k maximal elements among its original
+//  ones and those in the range.
+//  @post All iterators and references are invalidated.
+//
+//  Once the deque is full, each element that beats the minimum replaces it
+//  in place, rather than being pushed and then popped from the bottom.
+//  @remark Complexity: O(m log k)
+*/
+template <typename T, typename Sequence, typename Compare>
+template <typename InputIterator>
+void priority_deque<T, Sequence, Compare>::push_top (InputIterator first,
+                                                     InputIterator last,
+                                                     const size_type k)
+{
+  while (size() > k)
+    pop_bottom();
+
+  if (k == 0)
+    return;
+
+  for (; first != last; ++first)
+  {
+    if (size() < k)
+      push(*first);
+    else if (compare_(minimum(), *first))
+    {
+      *sequence_.begin() = *first;
+      heap::update_interval_heap(sequence_.begin(), sequence_.end(), 0, compare_);
+    }
+  }
+}
+
 //---------------------------Observe Maximum/Minimum---------------------------|
 /** @return Const reference to a maximal element in the priority deque.
 //  @pre  Priority deque contains one or more elements.
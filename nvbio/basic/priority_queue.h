@@ -110,6 +110,12 @@ struct priority_queue
     ///
     NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void push(const Key key);
 
+    /// push a range of elements: if the range is at least as large as the queue,
+    /// the heap is rebuilt bottom-up in linear time rather than sifting up each element
+    ///
+    template <typename InputIterator>
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void push(InputIterator first, InputIterator last);
+
     /// pop an element
     ///
     NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void pop();
@@ -155,6 +161,10 @@ struct priority_queue
     ///
     NVBIO_FORCEINLINE NVBIO_HOST_DEVICE iterator upper_bound(const Key& x);
 
+    /// sift down the element at the given (1-based) heap position
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void sift_down(uint32 p);
+
     uint32      m_size;
     Container   m_queue;
     Compare     m_cmp;
@@ -100,6 +100,58 @@ NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void priority_queue<Key,Container,Compare>::
     m_queue[p] = m_queue[m_size+1]; // insert last item in proper place
 }
 
+// push a range of elements
+//
+template <typename Key, typename Container, typename Compare>
+template <typename InputIterator>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void priority_queue<Key,Container,Compare>::push(InputIterator first, InputIterator last)
+{
+    const uint32 n = uint32( last - first );
+
+    // for small ranges, sifting up each element is cheaper than a rebuild
+    if (n < m_size)
+    {
+        for (; first != last; ++first)
+            push( *first );
+
+        return;
+    }
+
+    // append all elements
+    m_queue.resize( m_size + n + 1 );
+    for (uint32 i = 0; i < n; ++i, ++first)
+        m_queue[ m_size + 1 + i ] = *first;
+
+    m_size += n;
+
+    // and rebuild the heap bottom-up (Floyd's algorithm)
+    for (uint32 p = m_size/2; p >= 1; --p)
+        sift_down( p );
+}
+
+// sift down the element at the given heap position
+//
+template <typename Key, typename Container, typename Compare>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void priority_queue<Key,Container,Compare>::sift_down(uint32 p)
+{
+    const Key dn = m_queue[p];   // item out of position
+
+    uint32 r = p << 1;           // left child of p
+
+    while (r <= m_size) // while r is still within the heap
+    {
+        // set r to the larger child of p
+        if (r < m_size && m_cmp( m_queue[r], m_queue[r+1] )) r++;
+        if (! m_cmp( dn, m_queue[r] )) // in proper order
+            break;
+
+        m_queue[p] = m_queue[r];    // else move the child up
+        p = r;                      // advance pointers
+        r = p<<1;
+    }
+    m_queue[p] = dn;
+}
+
 // top of the queue
 //
 template <typename Key, typename Container, typename Compare>
@@ -28,14 +28,39 @@
 #pragma once
 
 #include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
 #ifdef __CUDACC__
 #include <nvbio/basic/cuda/simd_functions.h>
 #endif
 #include <cmath>
 #include <limits>
 
+// select the host SIMD instruction sets backing the wide SIMD types
+#if !defined(NVBIO_DEVICE_COMPILATION) && !defined(NVBIO_NO_HOST_SIMD)
+  #if defined(__AVX2__)
+    #define NVBIO_SIMD_SSE2
+    #define NVBIO_SIMD_AVX2
+    #include <immintrin.h>
+  #elif defined(__SSE2__) || defined(_M_X64)
+    #define NVBIO_SIMD_SSE2
+    #include <emmintrin.h>
+  #endif
+#endif
+
 namespace nvbio {
 
+///
+/// A trait class describing the lanes of a SIMD type; by default, any scalar type
+/// is treated as a single lane
+///
+template <typename T>
+struct simd_traits
+{
+    static const bool   IS_SIMD = false;
+    static const uint32 LANES   = 1u;
+    typedef T lane_type;
+};
+
 ///
 /// A 4-way uint8 SIMD type
 ///
@@ -64,14 +89,21 @@ struct simd4u8
     NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
     simd4u8& operator= (const uchar4 v);
 
+    /// load 4 scalars from memory
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    static simd4u8 load(const uint8* v) { return simd4u8( v[0], v[1], v[2], v[3] ); }
+
     uint32 m;
 };
 
+template <> struct simd_traits<simd4u8> { static const bool IS_SIMD = true; static const uint32 LANES = 4u; typedef uint8 lane_type; };
+
 NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
 bool any(const simd4u8 op) { return op.m != 0; }
 
 NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-simd4u8 operator~(const simd4u8 op) { return simd4u8( ~op.m ); }
+simd4u8 operator~(const simd4u8 op) { return simd4u8( ~op.m, simd4u8::base_rep_tag() ); }
 
 NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
 simd4u8 operator== (const simd4u8 op1, const simd4u8 op2);
@@ -109,6 +141,16 @@ simd4u8 max(const simd4u8 op1, const simd4u8 op2);
 NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
 simd4u8 min(const simd4u8 op1, const simd4u8 op2);
 
+/// per-lane addition with unsigned saturation
+///
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+simd4u8 adds(const simd4u8 op1, const simd4u8 op2);
+
+/// per-lane subtraction with unsigned saturation
+///
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+simd4u8 subs(const simd4u8 op1, const simd4u8 op2);
+
 NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
 simd4u8 and_op(const simd4u8 op1, const simd4u8 op2);
 
@@ -122,6 +164,441 @@ template <uint32 I>
 NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
 uint8 get(const simd4u8 op);
 
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void set(simd4u8& op, const uint8 v);
+
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void store_lanes(const simd4u8 op, uint8* v);
+
+///
+/// A 16-way uint8 SIMD type, backed by SSE2 intrinsics when available
+/// and by a portable lane-by-lane emulation otherwise
+///
+struct simd16u8
+{
+    typedef uint8 lane_type;
+
+    static const uint32 LANES = 16u;
+
+#if defined(NVBIO_SIMD_SSE2)
+    typedef __m128i rep_type;
+#else
+    struct rep_type { lane_type v[16]; };
+#endif
+
+    struct base_rep_tag {};
+
+    NVBIO_FORCEINLINE NVBIO_HOST
+    simd16u8() {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST
+    explicit simd16u8(const rep_type op, const base_rep_tag) : m( op ) {}
+
+    /// broadcast a scalar to all lanes
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST
+    explicit simd16u8(const uint8 v);
+
+    /// load LANES scalars from unaligned memory
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST
+    static simd16u8 load(const uint8* v);
+
+    rep_type m;
+};
+
+NVBIO_FORCEINLINE NVBIO_HOST
+bool any(const simd16u8 op);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator~(const simd16u8 op);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator== (const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator!= (const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator>= (const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator> (const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator<= (const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator< (const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator+ (const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8& operator+= (simd16u8& op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator- (const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8& operator-= (simd16u8& op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 max(const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 min(const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 adds(const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 subs(const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 and_op(const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 or_op(const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 ternary_op(const simd16u8 mask, const simd16u8 op1, const simd16u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+void store_lanes(const simd16u8 op, uint8* v);
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+uint8 get(const simd16u8 op);
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+void set(simd16u8& op, const uint8 v);
+
+template <> struct simd_traits<simd16u8> { static const bool IS_SIMD = true; static const uint32 LANES = 16u; typedef uint8 lane_type; };
+
+///
+/// A 32-way uint8 SIMD type, backed by AVX2 intrinsics when available
+/// and by a portable lane-by-lane emulation otherwise
+///
+struct simd32u8
+{
+    typedef uint8 lane_type;
+
+    static const uint32 LANES = 32u;
+
+#if defined(NVBIO_SIMD_AVX2)
+    typedef __m256i rep_type;
+#else
+    struct rep_type { lane_type v[32]; };
+#endif
+
+    struct base_rep_tag {};
+
+    NVBIO_FORCEINLINE NVBIO_HOST
+    simd32u8() {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST
+    explicit simd32u8(const rep_type op, const base_rep_tag) : m( op ) {}
+
+    /// broadcast a scalar to all lanes
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST
+    explicit simd32u8(const uint8 v);
+
+    /// load LANES scalars from unaligned memory
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST
+    static simd32u8 load(const uint8* v);
+
+    rep_type m;
+};
+
+NVBIO_FORCEINLINE NVBIO_HOST
+bool any(const simd32u8 op);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator~(const simd32u8 op);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator== (const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator!= (const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator>= (const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator> (const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator<= (const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator< (const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator+ (const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8& operator+= (simd32u8& op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator- (const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8& operator-= (simd32u8& op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 max(const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 min(const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 adds(const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 subs(const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 and_op(const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 or_op(const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 ternary_op(const simd32u8 mask, const simd32u8 op1, const simd32u8 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+void store_lanes(const simd32u8 op, uint8* v);
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+uint8 get(const simd32u8 op);
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+void set(simd32u8& op, const uint8 v);
+
+template <> struct simd_traits<simd32u8> { static const bool IS_SIMD = true; static const uint32 LANES = 32u; typedef uint8 lane_type; };
+
+///
+/// A 8-way uint16 SIMD type, backed by SSE2 intrinsics when available
+/// and by a portable lane-by-lane emulation otherwise
+///
+struct simd8u16
+{
+    typedef uint16 lane_type;
+
+    static const uint32 LANES = 8u;
+
+#if defined(NVBIO_SIMD_SSE2)
+    typedef __m128i rep_type;
+#else
+    struct rep_type { lane_type v[8]; };
+#endif
+
+    struct base_rep_tag {};
+
+    NVBIO_FORCEINLINE NVBIO_HOST
+    simd8u16() {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST
+    explicit simd8u16(const rep_type op, const base_rep_tag) : m( op ) {}
+
+    /// broadcast a scalar to all lanes
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST
+    explicit simd8u16(const uint16 v);
+
+    /// load LANES scalars from unaligned memory
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST
+    static simd8u16 load(const uint16* v);
+
+    rep_type m;
+};
+
+NVBIO_FORCEINLINE NVBIO_HOST
+bool any(const simd8u16 op);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator~(const simd8u16 op);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator== (const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator!= (const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator>= (const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator> (const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator<= (const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator< (const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator+ (const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16& operator+= (simd8u16& op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator- (const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16& operator-= (simd8u16& op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 max(const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 min(const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 adds(const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 subs(const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 and_op(const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 or_op(const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 ternary_op(const simd8u16 mask, const simd8u16 op1, const simd8u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+void store_lanes(const simd8u16 op, uint16* v);
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+uint16 get(const simd8u16 op);
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+void set(simd8u16& op, const uint16 v);
+
+template <> struct simd_traits<simd8u16> { static const bool IS_SIMD = true; static const uint32 LANES = 8u; typedef uint16 lane_type; };
+
+///
+/// A 16-way uint16 SIMD type, backed by AVX2 intrinsics when available
+/// and by a portable lane-by-lane emulation otherwise
+///
+struct simd16u16
+{
+    typedef uint16 lane_type;
+
+    static const uint32 LANES = 16u;
+
+#if defined(NVBIO_SIMD_AVX2)
+    typedef __m256i rep_type;
+#else
+    struct rep_type { lane_type v[16]; };
+#endif
+
+    struct base_rep_tag {};
+
+    NVBIO_FORCEINLINE NVBIO_HOST
+    simd16u16() {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST
+    explicit simd16u16(const rep_type op, const base_rep_tag) : m( op ) {}
+
+    /// broadcast a scalar to all lanes
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST
+    explicit simd16u16(const uint16 v);
+
+    /// load LANES scalars from unaligned memory
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST
+    static simd16u16 load(const uint16* v);
+
+    rep_type m;
+};
+
+NVBIO_FORCEINLINE NVBIO_HOST
+bool any(const simd16u16 op);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator~(const simd16u16 op);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator== (const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator!= (const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator>= (const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator> (const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator<= (const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator< (const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator+ (const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16& operator+= (simd16u16& op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator- (const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16& operator-= (simd16u16& op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 max(const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 min(const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 adds(const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 subs(const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 and_op(const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 or_op(const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 ternary_op(const simd16u16 mask, const simd16u16 op1, const simd16u16 op2);
+
+NVBIO_FORCEINLINE NVBIO_HOST
+void store_lanes(const simd16u16 op, uint16* v);
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+uint16 get(const simd16u16 op);
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+void set(simd16u16& op, const uint16 v);
+
+template <> struct simd_traits<simd16u16> { static const bool IS_SIMD = true; static const uint32 LANES = 16u; typedef uint16 lane_type; };
+
 } // namespace nvbio
 
 #include <nvbio/basic/simd_inl.h>
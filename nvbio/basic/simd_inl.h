@@ -106,10 +106,10 @@ simd4u8 operator>= (const simd4u8 op1, const simd4u8 op2)
     return simd4u8( vcmpgeu4( op1.m ,op2.m ), simd4u8::base_rep_tag() );
 #else
     return simd4u8(
-        get<0>(op1) <= get<0>(op2) ? 0xFFu : 0u,
-        get<1>(op1) <= get<1>(op2) ? 0xFFu : 0u,
-        get<2>(op1) <= get<2>(op2) ? 0xFFu : 0u,
-        get<3>(op1) <= get<3>(op2) ? 0xFFu : 0u );
+        get<0>(op1) >= get<0>(op2) ? 0xFFu : 0u,
+        get<1>(op1) >= get<1>(op2) ? 0xFFu : 0u,
+        get<2>(op1) >= get<2>(op2) ? 0xFFu : 0u,
+        get<3>(op1) >= get<3>(op2) ? 0xFFu : 0u );
 #endif
 }
 NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
@@ -233,6 +233,33 @@ simd4u8 min(const simd4u8 op1, const simd4u8 op2)
 #endif
 }
 
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+simd4u8 adds(const simd4u8 op1, const simd4u8 op2)
+{
+#if defined(NVBIO_DEVICE_COMPILATION)
+    return simd4u8( vaddus4( op1.m, op2.m ), simd4u8::base_rep_tag() );
+#else
+    return simd4u8(
+        uint8( nvbio::min( uint32( get<0>(op1) ) + get<0>(op2), 255u ) ),
+        uint8( nvbio::min( uint32( get<1>(op1) ) + get<1>(op2), 255u ) ),
+        uint8( nvbio::min( uint32( get<2>(op1) ) + get<2>(op2), 255u ) ),
+        uint8( nvbio::min( uint32( get<3>(op1) ) + get<3>(op2), 255u ) ) );
+#endif
+}
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+simd4u8 subs(const simd4u8 op1, const simd4u8 op2)
+{
+#if defined(NVBIO_DEVICE_COMPILATION)
+    return simd4u8( vsubus4( op1.m, op2.m ), simd4u8::base_rep_tag() );
+#else
+    return simd4u8(
+        get<0>(op1) > get<0>(op2) ? uint8( get<0>(op1) - get<0>(op2) ) : uint8(0),
+        get<1>(op1) > get<1>(op2) ? uint8( get<1>(op1) - get<1>(op2) ) : uint8(0),
+        get<2>(op1) > get<2>(op2) ? uint8( get<2>(op1) - get<2>(op2) ) : uint8(0),
+        get<3>(op1) > get<3>(op2) ? uint8( get<3>(op1) - get<3>(op2) ) : uint8(0) );
+#endif
+}
+
 NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
 simd4u8 and_op(const simd4u8 op1, const simd4u8 op2)
 {
@@ -252,10 +279,18 @@ uint8 get(const simd4u8 op)
 }
 template <uint32 I>
 NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
-void set(simd4u8 op, const uint8 v)
+void set(simd4u8& op, const uint8 v)
 {
     op.m &= ~(255u << (I*8));
-    op.m |= v << (I*8);
+    op.m |= uint32(v) << (I*8);
+}
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void store_lanes(const simd4u8 op, uint8* v)
+{
+    v[0] = get<0>( op );
+    v[1] = get<1>( op );
+    v[2] = get<2>( op );
+    v[3] = get<3>( op );
 }
 
 NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
@@ -264,4 +299,1042 @@ simd4u8 ternary_op(const simd4u8 mask, const simd4u8 op1, const simd4u8 op2)
     return or_op( and_op( mask, op1 ), and_op( ~mask, op2 ) );
 }
 
+//
+// portable lane-by-lane emulation of the wide host SIMD types
+//
+
+template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T simd_lane_mask(const bool p) { return p ? T(~T(0)) : T(0); }
+
+struct simd_lane_not  { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a) const { return T(~a); } };
+struct simd_lane_eq   { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return simd_lane_mask<T>( a == b ); } };
+struct simd_lane_ne   { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return simd_lane_mask<T>( a != b ); } };
+struct simd_lane_ge   { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return simd_lane_mask<T>( a >= b ); } };
+struct simd_lane_gt   { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return simd_lane_mask<T>( a >  b ); } };
+struct simd_lane_le   { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return simd_lane_mask<T>( a <= b ); } };
+struct simd_lane_lt   { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return simd_lane_mask<T>( a <  b ); } };
+struct simd_lane_add  { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return T(a + b); } };
+struct simd_lane_sub  { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return T(a - b); } };
+struct simd_lane_max  { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return a > b ? a : b; } };
+struct simd_lane_min  { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return a < b ? a : b; } };
+struct simd_lane_adds { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return T(a + b) < a ? T(~T(0)) : T(a + b); } };
+struct simd_lane_subs { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return a > b ? T(a - b) : T(0); } };
+struct simd_lane_and  { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return T(a & b); } };
+struct simd_lane_or   { template <typename T> NVBIO_FORCEINLINE NVBIO_HOST T operator() (const T a, const T b) const { return T(a | b); } };
+
+template <typename simd_type, typename lane_op>
+NVBIO_FORCEINLINE NVBIO_HOST
+simd_type simd_unary_op(const simd_type op, const lane_op f)
+{
+    simd_type r;
+    for (uint32 i = 0; i < simd_type::LANES; ++i)
+        r.m.v[i] = f( op.m.v[i] );
+    return r;
+}
+
+template <typename simd_type, typename lane_op>
+NVBIO_FORCEINLINE NVBIO_HOST
+simd_type simd_binary_op(const simd_type op1, const simd_type op2, const lane_op f)
+{
+    simd_type r;
+    for (uint32 i = 0; i < simd_type::LANES; ++i)
+        r.m.v[i] = f( op1.m.v[i], op2.m.v[i] );
+    return r;
+}
+
+template <typename simd_type>
+NVBIO_FORCEINLINE NVBIO_HOST
+bool simd_any_lane(const simd_type op)
+{
+    for (uint32 i = 0; i < simd_type::LANES; ++i)
+    {
+        if (op.m.v[i])
+            return true;
+    }
+    return false;
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8::simd16u8(const uint8 v)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    m = _mm_set1_epi8( (char)v );
+#else
+    for (uint32 i = 0; i < LANES; ++i)
+        m.v[i] = v;
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 simd16u8::load(const uint8* v)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_loadu_si128( (const rep_type*)v ), base_rep_tag() );
+#else
+    simd16u8 r;
+    for (uint32 i = 0; i < LANES; ++i)
+        r.m.v[i] = v[i];
+    return r;
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+bool any(const simd16u8 op)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return _mm_movemask_epi8( _mm_cmpeq_epi8( op.m, _mm_setzero_si128() ) ) != 0xFFFF;
+#else
+    return simd_any_lane( op );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator~(const simd16u8 op)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_xor_si128( op.m, _mm_cmpeq_epi8( op.m, op.m ) ), simd16u8::base_rep_tag() );
+#else
+    return simd_unary_op( op, simd_lane_not() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator== (const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_cmpeq_epi8( op1.m, op2.m ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_eq() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator!= (const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_xor_si128( _mm_cmpeq_epi8( op1.m, op2.m ), _mm_cmpeq_epi8( op1.m, op1.m ) ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_ne() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator>= (const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_cmpeq_epi8( _mm_max_epu8( op1.m, op2.m ), op1.m ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_ge() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator> (const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_xor_si128( _mm_cmpeq_epi8( _mm_min_epu8( op1.m, op2.m ), op1.m ), _mm_cmpeq_epi8( op1.m, op1.m ) ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_gt() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator<= (const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_cmpeq_epi8( _mm_min_epu8( op1.m, op2.m ), op1.m ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_le() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator< (const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_xor_si128( _mm_cmpeq_epi8( _mm_max_epu8( op1.m, op2.m ), op1.m ), _mm_cmpeq_epi8( op1.m, op1.m ) ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_lt() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator+ (const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_add_epi8( op1.m, op2.m ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_add() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8& operator+= (simd16u8& op1, const simd16u8 op2)
+{
+    op1 = op1 + op2;
+    return op1;
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 operator- (const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_sub_epi8( op1.m, op2.m ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_sub() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8& operator-= (simd16u8& op1, const simd16u8 op2)
+{
+    op1 = op1 - op2;
+    return op1;
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 max(const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_max_epu8( op1.m, op2.m ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_max() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 min(const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_min_epu8( op1.m, op2.m ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_min() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 adds(const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_adds_epu8( op1.m, op2.m ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_adds() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 subs(const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_subs_epu8( op1.m, op2.m ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_subs() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 and_op(const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_and_si128( op1.m, op2.m ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_and() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 or_op(const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_or_si128( op1.m, op2.m ), simd16u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_or() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u8 ternary_op(const simd16u8 mask, const simd16u8 op1, const simd16u8 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd16u8( _mm_or_si128( _mm_and_si128( mask.m, op1.m ), _mm_andnot_si128( mask.m, op2.m ) ), simd16u8::base_rep_tag() );
+#else
+    return or_op( and_op( mask, op1 ), and_op( ~mask, op2 ) );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+void store_lanes(const simd16u8 op, uint8* v)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    _mm_storeu_si128( (simd16u8::rep_type*)v, op.m );
+#else
+    for (uint32 i = 0; i < simd16u8::LANES; ++i)
+        v[i] = op.m.v[i];
+#endif
+}
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+uint8 get(const simd16u8 op)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    uint8 v[ simd16u8::LANES ];
+    store_lanes( op, v );
+    return v[I];
+#else
+    return op.m.v[I];
+#endif
+}
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+void set(simd16u8& op, const uint8 v)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    uint8 r[ simd16u8::LANES ];
+    store_lanes( op, r );
+    r[I] = v;
+    op = simd16u8::load( r );
+#else
+    op.m.v[I] = v;
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8::simd32u8(const uint8 v)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    m = _mm256_set1_epi8( (char)v );
+#else
+    for (uint32 i = 0; i < LANES; ++i)
+        m.v[i] = v;
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 simd32u8::load(const uint8* v)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_loadu_si256( (const rep_type*)v ), base_rep_tag() );
+#else
+    simd32u8 r;
+    for (uint32 i = 0; i < LANES; ++i)
+        r.m.v[i] = v[i];
+    return r;
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+bool any(const simd32u8 op)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return _mm256_testz_si256( op.m, op.m ) == 0;
+#else
+    return simd_any_lane( op );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator~(const simd32u8 op)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_xor_si256( op.m, _mm256_cmpeq_epi8( op.m, op.m ) ), simd32u8::base_rep_tag() );
+#else
+    return simd_unary_op( op, simd_lane_not() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator== (const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_cmpeq_epi8( op1.m, op2.m ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_eq() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator!= (const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_xor_si256( _mm256_cmpeq_epi8( op1.m, op2.m ), _mm256_cmpeq_epi8( op1.m, op1.m ) ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_ne() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator>= (const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_cmpeq_epi8( _mm256_max_epu8( op1.m, op2.m ), op1.m ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_ge() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator> (const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_xor_si256( _mm256_cmpeq_epi8( _mm256_min_epu8( op1.m, op2.m ), op1.m ), _mm256_cmpeq_epi8( op1.m, op1.m ) ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_gt() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator<= (const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_cmpeq_epi8( _mm256_min_epu8( op1.m, op2.m ), op1.m ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_le() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator< (const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_xor_si256( _mm256_cmpeq_epi8( _mm256_max_epu8( op1.m, op2.m ), op1.m ), _mm256_cmpeq_epi8( op1.m, op1.m ) ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_lt() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator+ (const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_add_epi8( op1.m, op2.m ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_add() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8& operator+= (simd32u8& op1, const simd32u8 op2)
+{
+    op1 = op1 + op2;
+    return op1;
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 operator- (const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_sub_epi8( op1.m, op2.m ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_sub() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8& operator-= (simd32u8& op1, const simd32u8 op2)
+{
+    op1 = op1 - op2;
+    return op1;
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 max(const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_max_epu8( op1.m, op2.m ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_max() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 min(const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_min_epu8( op1.m, op2.m ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_min() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 adds(const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_adds_epu8( op1.m, op2.m ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_adds() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 subs(const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_subs_epu8( op1.m, op2.m ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_subs() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 and_op(const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_and_si256( op1.m, op2.m ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_and() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 or_op(const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_or_si256( op1.m, op2.m ), simd32u8::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_or() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd32u8 ternary_op(const simd32u8 mask, const simd32u8 op1, const simd32u8 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd32u8( _mm256_or_si256( _mm256_and_si256( mask.m, op1.m ), _mm256_andnot_si256( mask.m, op2.m ) ), simd32u8::base_rep_tag() );
+#else
+    return or_op( and_op( mask, op1 ), and_op( ~mask, op2 ) );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+void store_lanes(const simd32u8 op, uint8* v)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    _mm256_storeu_si256( (simd32u8::rep_type*)v, op.m );
+#else
+    for (uint32 i = 0; i < simd32u8::LANES; ++i)
+        v[i] = op.m.v[i];
+#endif
+}
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+uint8 get(const simd32u8 op)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    uint8 v[ simd32u8::LANES ];
+    store_lanes( op, v );
+    return v[I];
+#else
+    return op.m.v[I];
+#endif
+}
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+void set(simd32u8& op, const uint8 v)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    uint8 r[ simd32u8::LANES ];
+    store_lanes( op, r );
+    r[I] = v;
+    op = simd32u8::load( r );
+#else
+    op.m.v[I] = v;
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16::simd8u16(const uint16 v)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    m = _mm_set1_epi16( (short)v );
+#else
+    for (uint32 i = 0; i < LANES; ++i)
+        m.v[i] = v;
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 simd8u16::load(const uint16* v)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_loadu_si128( (const rep_type*)v ), base_rep_tag() );
+#else
+    simd8u16 r;
+    for (uint32 i = 0; i < LANES; ++i)
+        r.m.v[i] = v[i];
+    return r;
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+bool any(const simd8u16 op)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return _mm_movemask_epi8( _mm_cmpeq_epi8( op.m, _mm_setzero_si128() ) ) != 0xFFFF;
+#else
+    return simd_any_lane( op );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator~(const simd8u16 op)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_xor_si128( op.m, _mm_cmpeq_epi8( op.m, op.m ) ), simd8u16::base_rep_tag() );
+#else
+    return simd_unary_op( op, simd_lane_not() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator== (const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_cmpeq_epi16( op1.m, op2.m ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_eq() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator!= (const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_xor_si128( _mm_cmpeq_epi16( op1.m, op2.m ), _mm_cmpeq_epi16( op1.m, op1.m ) ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_ne() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator>= (const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_cmpeq_epi16( _mm_adds_epu16( op2.m, _mm_subs_epu16( op1.m, op2.m ) ), op1.m ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_ge() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator> (const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_xor_si128( _mm_cmpeq_epi16( _mm_subs_epu16( op1.m, _mm_subs_epu16( op1.m, op2.m ) ), op1.m ), _mm_cmpeq_epi16( op1.m, op1.m ) ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_gt() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator<= (const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_cmpeq_epi16( _mm_subs_epu16( op1.m, _mm_subs_epu16( op1.m, op2.m ) ), op1.m ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_le() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator< (const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_xor_si128( _mm_cmpeq_epi16( _mm_adds_epu16( op2.m, _mm_subs_epu16( op1.m, op2.m ) ), op1.m ), _mm_cmpeq_epi16( op1.m, op1.m ) ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_lt() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator+ (const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_add_epi16( op1.m, op2.m ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_add() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16& operator+= (simd8u16& op1, const simd8u16 op2)
+{
+    op1 = op1 + op2;
+    return op1;
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 operator- (const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_sub_epi16( op1.m, op2.m ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_sub() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16& operator-= (simd8u16& op1, const simd8u16 op2)
+{
+    op1 = op1 - op2;
+    return op1;
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 max(const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_adds_epu16( op2.m, _mm_subs_epu16( op1.m, op2.m ) ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_max() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 min(const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_subs_epu16( op1.m, _mm_subs_epu16( op1.m, op2.m ) ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_min() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 adds(const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_adds_epu16( op1.m, op2.m ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_adds() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 subs(const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_subs_epu16( op1.m, op2.m ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_subs() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 and_op(const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_and_si128( op1.m, op2.m ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_and() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 or_op(const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_or_si128( op1.m, op2.m ), simd8u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_or() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd8u16 ternary_op(const simd8u16 mask, const simd8u16 op1, const simd8u16 op2)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    return simd8u16( _mm_or_si128( _mm_and_si128( mask.m, op1.m ), _mm_andnot_si128( mask.m, op2.m ) ), simd8u16::base_rep_tag() );
+#else
+    return or_op( and_op( mask, op1 ), and_op( ~mask, op2 ) );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+void store_lanes(const simd8u16 op, uint16* v)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    _mm_storeu_si128( (simd8u16::rep_type*)v, op.m );
+#else
+    for (uint32 i = 0; i < simd8u16::LANES; ++i)
+        v[i] = op.m.v[i];
+#endif
+}
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+uint16 get(const simd8u16 op)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    uint16 v[ simd8u16::LANES ];
+    store_lanes( op, v );
+    return v[I];
+#else
+    return op.m.v[I];
+#endif
+}
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+void set(simd8u16& op, const uint16 v)
+{
+#if defined(NVBIO_SIMD_SSE2)
+    uint16 r[ simd8u16::LANES ];
+    store_lanes( op, r );
+    r[I] = v;
+    op = simd8u16::load( r );
+#else
+    op.m.v[I] = v;
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16::simd16u16(const uint16 v)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    m = _mm256_set1_epi16( (short)v );
+#else
+    for (uint32 i = 0; i < LANES; ++i)
+        m.v[i] = v;
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 simd16u16::load(const uint16* v)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_loadu_si256( (const rep_type*)v ), base_rep_tag() );
+#else
+    simd16u16 r;
+    for (uint32 i = 0; i < LANES; ++i)
+        r.m.v[i] = v[i];
+    return r;
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+bool any(const simd16u16 op)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return _mm256_testz_si256( op.m, op.m ) == 0;
+#else
+    return simd_any_lane( op );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator~(const simd16u16 op)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_xor_si256( op.m, _mm256_cmpeq_epi8( op.m, op.m ) ), simd16u16::base_rep_tag() );
+#else
+    return simd_unary_op( op, simd_lane_not() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator== (const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_cmpeq_epi16( op1.m, op2.m ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_eq() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator!= (const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_xor_si256( _mm256_cmpeq_epi16( op1.m, op2.m ), _mm256_cmpeq_epi16( op1.m, op1.m ) ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_ne() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator>= (const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_cmpeq_epi16( _mm256_max_epu16( op1.m, op2.m ), op1.m ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_ge() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator> (const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_xor_si256( _mm256_cmpeq_epi16( _mm256_min_epu16( op1.m, op2.m ), op1.m ), _mm256_cmpeq_epi16( op1.m, op1.m ) ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_gt() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator<= (const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_cmpeq_epi16( _mm256_min_epu16( op1.m, op2.m ), op1.m ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_le() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator< (const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_xor_si256( _mm256_cmpeq_epi16( _mm256_max_epu16( op1.m, op2.m ), op1.m ), _mm256_cmpeq_epi16( op1.m, op1.m ) ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_lt() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator+ (const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_add_epi16( op1.m, op2.m ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_add() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16& operator+= (simd16u16& op1, const simd16u16 op2)
+{
+    op1 = op1 + op2;
+    return op1;
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 operator- (const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_sub_epi16( op1.m, op2.m ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_sub() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16& operator-= (simd16u16& op1, const simd16u16 op2)
+{
+    op1 = op1 - op2;
+    return op1;
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 max(const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_max_epu16( op1.m, op2.m ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_max() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 min(const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_min_epu16( op1.m, op2.m ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_min() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 adds(const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_adds_epu16( op1.m, op2.m ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_adds() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 subs(const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_subs_epu16( op1.m, op2.m ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_subs() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 and_op(const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_and_si256( op1.m, op2.m ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_and() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 or_op(const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_or_si256( op1.m, op2.m ), simd16u16::base_rep_tag() );
+#else
+    return simd_binary_op( op1, op2, simd_lane_or() );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+simd16u16 ternary_op(const simd16u16 mask, const simd16u16 op1, const simd16u16 op2)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    return simd16u16( _mm256_or_si256( _mm256_and_si256( mask.m, op1.m ), _mm256_andnot_si256( mask.m, op2.m ) ), simd16u16::base_rep_tag() );
+#else
+    return or_op( and_op( mask, op1 ), and_op( ~mask, op2 ) );
+#endif
+}
+
+NVBIO_FORCEINLINE NVBIO_HOST
+void store_lanes(const simd16u16 op, uint16* v)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    _mm256_storeu_si256( (simd16u16::rep_type*)v, op.m );
+#else
+    for (uint32 i = 0; i < simd16u16::LANES; ++i)
+        v[i] = op.m.v[i];
+#endif
+}
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+uint16 get(const simd16u16 op)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    uint16 v[ simd16u16::LANES ];
+    store_lanes( op, v );
+    return v[I];
+#else
+    return op.m.v[I];
+#endif
+}
+
+template <uint32 I>
+NVBIO_FORCEINLINE NVBIO_HOST
+void set(simd16u16& op, const uint16 v)
+{
+#if defined(NVBIO_SIMD_AVX2)
+    uint16 r[ simd16u16::LANES ];
+    store_lanes( op, r );
+    r[I] = v;
+    op = simd16u16::load( r );
+#else
+    op.m.v[I] = v;
+#endif
+}
+
 } // namespace nvbio
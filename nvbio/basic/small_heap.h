@@ -0,0 +1,149 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file small_heap.h
+ *   \brief A CUDA-compatible, fixed-capacity priority queue for tracking the best N items
+ */
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <functional>
+
+namespace nvbio {
+
+///@addtogroup Basic
+///@{
+
+///@addtogroup PriorityQueues
+///@{
+
+///
+/// A fixed-capacity priority queue holding up to N keys in registers or local memory,
+/// meant for tracking the best N items out of a stream (e.g. the best N alignments of a read).
+/// Unlike priority_queue, the capacity is a compile-time constant, and when the queue is full
+/// a push() drops the smallest key.
+/// As N is expected to be small (say, up to 16), the keys are kept in a sorted array, and all
+/// operations are performed with a fixed number of conditional moves, without data-dependent
+/// branches: this makes the queue suitable for SIMD execution and divergence-free on the GPU.
+/// A new key is placed before any other key comparing equal to it, so that in case of ties
+/// the most recently pushed key wins, as in aln::BestSink.
+///
+/// \tparam Key         the key type
+/// \tparam N           the capacity of the queue
+/// \tparam Compare     the comparison binary functor, Compare(a,b) == true iff a < b
+///
+/// \code
+/// small_heap<uint32,2> best2;
+///
+/// best2.push( 3 );
+/// best2.push( 8 );
+/// best2.push( 1 );
+/// best2.push( 5 );
+///
+/// printf( "%u, %u\n", best2[0], best2[1] );   // -> 8, 5
+/// \endcode
+///
+template <typename Key, uint32 N, typename Compare = std::less<Key> >
+struct small_heap
+{
+    typedef Key     value_type;
+    typedef Compare value_compare;
+
+    static const uint32 CAPACITY = N;
+
+    /// constructor
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE small_heap(const Compare cmp = Compare()) : m_size(0), m_cmp(cmp) {}
+
+    /// is queue empty?
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE bool empty() const { return m_size == 0; }
+
+    /// is queue full?
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE bool full() const { return m_size == N; }
+
+    /// return queue size
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE uint32 size() const { return m_size; }
+
+    /// return queue capacity
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE static uint32 capacity() { return N; }
+
+    /// push a key, dropping the smallest one if the queue is full
+    ///
+    /// \return     true if the key was kept
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE bool push(const Key key);
+
+    /// push a sequence of keys, keeping the N largest
+    ///
+    template <typename InputIterator>
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void push(InputIterator first, InputIterator last);
+
+    /// merge the keys of another queue, keeping the N largest
+    ///
+    template <uint32 M>
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void merge(const small_heap<Key,M,Compare>& other);
+
+    /// remove the largest key
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void pop();
+
+    /// remove the smallest key
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void pop_bottom() { --m_size; }
+
+    /// the largest key
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE const Key& top() const { return m_keys[0]; }
+
+    /// the smallest key
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE const Key& bottom() const { return m_keys[ m_size-1 ]; }
+
+    /// return the i-th largest key
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE const Key& operator[] (const uint32 i) const { return m_keys[i]; }
+
+    /// clear the queue
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void clear() { m_size = 0; }
+
+    Key         m_keys[N];
+    uint32      m_size;
+    Compare     m_cmp;
+};
+
+///@} PriorityQueues
+///@} Basic
+
+} // namespace nvbio
+
+#include <nvbio/basic/small_heap_inl.h>
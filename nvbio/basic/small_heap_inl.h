@@ -0,0 +1,93 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+namespace nvbio {
+
+// push a key, dropping the smallest one if the queue is full
+//
+template <typename Key, uint32 N, typename Compare>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE bool small_heap<Key,N,Compare>::push(const Key key)
+{
+    // a key that doesn't beat the smallest of a full queue is rejected
+    const bool keep = m_size < N || !m_cmp( key, m_keys[N-1] );
+
+    // bubble the new key down the sorted array: each slot takes the carried key if this
+    // is not smaller than the slot's, and the displaced key is carried on to the next slot.
+    // Slots past the end are always overwritten.
+    Key carry = key;
+
+    #pragma unroll
+    for (uint32 i = 0; i < N; ++i)
+    {
+        const bool take = keep && (i >= m_size || !m_cmp( carry, m_keys[i] ));
+        const Key  tmp  = m_keys[i];
+        m_keys[i] = take ? carry : tmp;
+        carry     = take ? tmp   : carry;
+    }
+    m_size += (keep && m_size < N) ? 1u : 0u;
+    return keep;
+}
+
+// push a sequence of keys, keeping the N largest
+//
+template <typename Key, uint32 N, typename Compare>
+template <typename InputIterator>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void small_heap<Key,N,Compare>::push(InputIterator first, InputIterator last)
+{
+    for (; first != last; ++first)
+        push( *first );
+}
+
+// merge the keys of another queue, keeping the N largest
+//
+template <typename Key, uint32 N, typename Compare>
+template <uint32 M>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void small_heap<Key,N,Compare>::merge(const small_heap<Key,M,Compare>& other)
+{
+    // the other queue is sorted: as soon as one of its keys is rejected, so are all the following ones
+    for (uint32 i = 0; i < other.size(); ++i)
+    {
+        if (push( other[i] ) == false)
+            break;
+    }
+}
+
+// remove the largest key
+//
+template <typename Key, uint32 N, typename Compare>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE void small_heap<Key,N,Compare>::pop()
+{
+    #pragma unroll
+    for (uint32 i = 0; i + 1 < N; ++i)
+        m_keys[i] = m_keys[i+1];
+
+    --m_size;
+}
+
+} // namespace nvbio
@@ -51,6 +51,7 @@ namespace nvbio {
 ///
 /// - SumTree
 /// - uint32 sample<Iterator>(const SumTree<Iterator>& tree, const float value)
+/// - SumTreeBatch
 ///
 /// \section SumTreeExample Example
 ///
@@ -82,6 +83,38 @@ namespace nvbio {
 /// }
 /// \endcode
 ///
+/// \section SumTreeBatchSection Batches of Sum Trees
+///
+/// When many small trees need to be sampled and updated in lock-step (e.g. one tree of
+/// seed hits per read), SumTreeBatch lays them out as a single structure-of-arrays:
+/// the trees share a common padded size, and node <i>i</i> of tree <i>t</i> is stored
+/// at offset <i>i * n_trees + t</i>, where nodes are numbered exactly as in a single SumTree.
+/// The batched sample() and add() functions then process a whole set of trees one level
+/// at a time, so that each level touches a contiguous slice of memory and the inner loop over
+/// the trees can be vectorized, rather than chasing a separate tree for each request.
+///
+/// \code
+/// // build 1000 trees with up to 16 leaves each
+/// const uint32 n_trees  = 1000;
+/// const uint32 n_leaves = 16;
+/// std::vector<float>  probs( SumTreeBatch<float*>::node_count( n_trees, n_leaves ) );
+/// std::vector<uint32> sizes( n_trees, n_leaves );
+///
+/// SumTreeBatch<float*> trees( n_trees, n_leaves, &probs[0], &sizes[0] );
+/// for (uint32 t = 0; t < n_trees; ++t)
+///     for (uint32 i = 0; i < n_leaves; ++i)
+///         trees.node( t, i ) = 1.0f;
+/// trees.setup();
+///
+/// // sample one leaf from each tree, and decrement its probability
+/// std::vector<uint32> tree_ids( n_trees ), leaves( n_trees );
+/// std::vector<float>  values( n_trees ), deltas( n_trees, -1.0f );
+/// for (uint32 t = 0; t < n_trees; ++t) { tree_ids[t] = t; values[t] = drand48(); }
+///
+/// sample( trees, n_trees, &tree_ids[0], &values[0], &leaves[0] );
+/// add( trees, n_trees, &tree_ids[0], &leaves[0], &deltas[0] );
+/// \endcode
+///
 
 ///@addtogroup Basic
 ///@{
@@ -175,6 +208,150 @@ template <typename Iterator>
 NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
 uint32 sample(const SumTree<Iterator>& tree, const float value);
 
+///
+/// A batch of Sum Trees sharing the same padded size, stored as a structure-of-arrays:
+/// node i of tree t (numbered as in SumTree, i.e. leaves first and the root last)
+/// lives at offset i * n_trees + t.
+/// As SumTree, this class is storage-free: the user provides the combined storage
+/// for all the nodes of all the trees, and optionally the actual number of leaves
+/// of each tree.
+///
+template <typename Iterator, typename SizeIterator = const uint32*>
+struct SumTreeBatch
+{
+    typedef Iterator                                              iterator_type;
+    typedef SizeIterator                                          size_iterator;
+    typedef typename std::iterator_traits<Iterator>::value_type   value_type;
+
+    /// return the number of nodes needed by a batch of trees with up to max_size leaves each
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    static uint64 node_count(const uint32 n_trees, const uint32 max_size);
+
+    /// constructor
+    ///
+    /// \param n_trees      the number of trees
+    /// \param max_size     the maximum number of leaves of each tree
+    /// \param cells        the storage for node_count( n_trees, max_size ) nodes
+    /// \param sizes        the number of leaves of each tree; if not provided, all trees have max_size leaves
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    SumTreeBatch(const uint32 n_trees, const uint32 max_size, iterator_type cells, size_iterator sizes = size_iterator());
+
+    /// return the number of trees
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint32 n_trees() const { return m_n_trees; }
+
+    /// return the number of leaves of a given tree
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint32 size(const uint32 t) const { return m_has_sizes ? uint32( m_sizes[t] ) : m_max_size; }
+
+    /// return the number of leaves of each tree, padded to the nearest power of 2
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint32 padded_size() const { return m_padded_size; }
+
+    /// return the node count of each tree
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint32 nodes() const { return m_padded_size * 2u - 1u; }
+
+    /// return a reference to the i-th node of a given tree; the first size(t) nodes are
+    /// the leaves, which must be filled before calling setup()
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    typename std::iterator_traits<Iterator>::reference node(const uint32 t, const uint32 i) { return m_cells[ uint64(i) * m_n_trees + t ]; }
+
+    /// setup the structure of all trees
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void setup(const value_type zero = value_type(0));
+
+    /// increment a cell's value
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void add(const uint32 t, const uint32 i, const value_type v);
+
+    /// reset a cell's value
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void set(const uint32 t, const uint32 i, const value_type v);
+
+    /// return the total sum of a given tree
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    value_type sum(const uint32 t) const { return m_cells[ uint64( m_padded_size * 2u - 2u ) * m_n_trees + t ]; }
+
+    /// return the i-th node of a given tree
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    value_type cell(const uint32 t, const uint32 i) const { return m_cells[ uint64(i) * m_n_trees + t ]; }
+
+private:
+    iterator_type m_cells;
+    size_iterator m_sizes;
+    uint32        m_n_trees;
+    uint32        m_max_size;
+    uint32        m_padded_size;
+    bool          m_has_sizes;
+};
+
+/// sample a leaf from each of a set of trees in a batch, descending all trees one level at a time;
+/// the result is the same as calling sample() on each tree separately.
+///
+/// \param trees        the batch of trees
+/// \param n            the number of samples
+/// \param tree_ids     the tree to sample for each request
+/// \param values       a value in the range [0,1] for each request
+/// \param leaves       the output sampled leaves
+///
+template <typename Iterator, typename SizeIterator>
+NVBIO_HOST
+void sample(
+    const SumTreeBatch<Iterator,SizeIterator>&  trees,
+    const uint32                                n,
+    const uint32*                               tree_ids,
+    const float*                                values,
+          uint32*                               leaves);
+
+/// add a set of deltas to the leaves of a batch of trees, updating all the ancestors
+/// one level at a time; the same tree may appear multiple times.
+///
+/// \param trees        the batch of trees
+/// \param n            the number of updates
+/// \param tree_ids     the tree of each update
+/// \param leaves       the leaf of each update
+/// \param deltas       the value to add to each leaf
+///
+template <typename Iterator, typename SizeIterator>
+NVBIO_HOST
+void add(
+          SumTreeBatch<Iterator,SizeIterator>&                      trees,
+    const uint32                                                    n,
+    const uint32*                                                   tree_ids,
+    const uint32*                                                   leaves,
+    const typename SumTreeBatch<Iterator,SizeIterator>::value_type* deltas);
+
+/// reset a set of leaves of a batch of trees, recomputing all the ancestors
+/// one level at a time; the same tree may appear multiple times.
+///
+/// \param trees        the batch of trees
+/// \param n            the number of updates
+/// \param tree_ids     the tree of each update
+/// \param leaves       the leaf of each update
+/// \param values       the new value of each leaf
+///
+template <typename Iterator, typename SizeIterator>
+NVBIO_HOST
+void set(
+          SumTreeBatch<Iterator,SizeIterator>&                      trees,
+    const uint32                                                    n,
+    const uint32*                                                   tree_ids,
+    const uint32*                                                   leaves,
+    const typename SumTreeBatch<Iterator,SizeIterator>::value_type* values);
+
 ///@} SumTrees
 ///@} Basic
 
@@ -89,7 +89,7 @@ void SumTree<Iterator>::add(const uint32 i, const value_type v)
 {
     uint32 dst = 0;
     uint32 j   = i;
-    for (uint32 m = m_padded_size; m >= 2; m >>= 1, j >>= 1)
+    for (uint32 m = m_padded_size; m >= 1; m >>= 1, j >>= 1)
     {
         m_cells[ dst + j ] += v;
 
@@ -178,4 +178,237 @@ uint32 sample(const SumTree<Iterator>& tree, const float value)
     return node_index < size ? node_index : size - 1u;
 }
 
+// return the number of nodes needed by a batch of trees with up to max_size leaves each
+//
+template <typename Iterator, typename SizeIterator>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 SumTreeBatch<Iterator,SizeIterator>::node_count(const uint32 n_trees, const uint32 max_size)
+{
+    return uint64( n_trees ) * SumTree<Iterator>::node_count( max_size );
+}
+
+// constructor
+//
+template <typename Iterator, typename SizeIterator>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+SumTreeBatch<Iterator,SizeIterator>::SumTreeBatch(const uint32 n_trees, const uint32 max_size, iterator_type cells, size_iterator sizes) :
+    m_cells( cells ),
+    m_sizes( sizes ),
+    m_n_trees( n_trees ),
+    m_max_size( max_size ),
+    m_padded_size(
+        (1u << nvbio::log2( max_size )) < max_size ?
+            1u << (nvbio::log2( max_size )+1u) :
+            1u <<  nvbio::log2( max_size ) ),
+    m_has_sizes( sizes != size_iterator() )
+{}
+
+// setup the structure of all trees
+//
+template <typename Iterator, typename SizeIterator>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void SumTreeBatch<Iterator,SizeIterator>::setup(const value_type zero)
+{
+    const uint64 n_trees = m_n_trees;
+
+    // zero out padding cells
+    for (uint32 t = 0; t < m_n_trees; ++t)
+    {
+        for (uint32 i = size(t); i < m_padded_size; ++i)
+            m_cells[ i * n_trees + t ] = zero;
+    }
+
+    uint32 src = 0;
+
+    // build each level from the one below, sweeping all trees at once
+    for (uint32 n = m_padded_size; n >= 2; n >>= 1)
+    {
+        const uint32 dst = src + n;
+
+        const uint32 m = n >> 1;
+        for (uint32 i = 0; i < m; ++i)
+        {
+            const uint64 dst_off   = (dst + i)        * n_trees;
+            const uint64 left_off  = (src + i*2)      * n_trees;
+            const uint64 right_off = (src + i*2 + 1u) * n_trees;
+
+            for (uint32 t = 0; t < m_n_trees; ++t)
+                m_cells[ dst_off + t ] = (m_cells[ left_off + t ] + m_cells[ right_off + t ]);
+        }
+
+        src += n;
+    }
+}
+
+// increment a cell's value
+//
+template <typename Iterator, typename SizeIterator>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void SumTreeBatch<Iterator,SizeIterator>::add(const uint32 t, const uint32 i, const value_type v)
+{
+    uint32 dst = 0;
+    uint32 j   = i;
+    for (uint32 m = m_padded_size; m >= 1; m >>= 1, j >>= 1)
+    {
+        m_cells[ uint64( dst + j ) * m_n_trees + t ] += v;
+
+        dst += m;
+    }
+}
+
+// reset a cell's value
+//
+template <typename Iterator, typename SizeIterator>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void SumTreeBatch<Iterator,SizeIterator>::set(const uint32 t, const uint32 i, const value_type v)
+{
+    // sum the left & right values of each ancestor bottom-up
+    m_cells[ uint64(i) * m_n_trees + t ] = v;
+
+    uint32 prev_base   = 0u;
+    uint32 parent_base = m_padded_size;
+    uint32 parent      = i >> 1;
+
+    for (uint32 m = m_padded_size >> 1; parent_base + parent < nodes(); m >>= 1)
+    {
+        m_cells[ uint64( parent_base + parent ) * m_n_trees + t ] =
+            m_cells[ uint64( prev_base + parent*2   ) * m_n_trees + t ] +
+            m_cells[ uint64( prev_base + parent*2+1 ) * m_n_trees + t ];
+
+        prev_base     = parent_base;
+        parent_base  += m;
+        parent      >>= 1;
+    }
+}
+
+// sample a leaf from each of a set of trees in a batch
+//
+template <typename Iterator, typename SizeIterator>
+NVBIO_HOST
+void sample(
+    const SumTreeBatch<Iterator,SizeIterator>&  trees,
+    const uint32                                n,
+    const uint32*                               tree_ids,
+    const float*                                values,
+          uint32*                               leaves)
+{
+    // process the requests in small blocks, keeping the descent state of each block in L1
+    const uint32 BLOCK_SIZE = 128u;
+
+    uint32 node_index[BLOCK_SIZE];
+    float  v[BLOCK_SIZE];
+
+    const uint32 padded_size = trees.padded_size();
+
+    for (uint32 block_begin = 0; block_begin < n; block_begin += BLOCK_SIZE)
+    {
+        const uint32  block_size = nvbio::min( n - block_begin, BLOCK_SIZE );
+        const uint32* block_ids  = tree_ids + block_begin;
+
+        for (uint32 k = 0; k < block_size; ++k)
+        {
+            node_index[k] = 0u;
+            v[k]          = values[ block_begin + k ];
+        }
+
+        // choose the proper child of each internal node, from the roots down to the leaves,
+        // advancing all trees in the block by one level at a time
+        uint32 node_base = padded_size*2u - 4u;
+
+        for (uint32 m = 2; m < padded_size; m *= 2)
+        {
+            for (uint32 k = 0; k < block_size; ++k)
+            {
+                const float l   = float( trees.cell( block_ids[k], node_base + node_index[k]      ) );
+                const float r   = float( trees.cell( block_ids[k], node_base + node_index[k] + 1u ) );
+                const float sum = float( l + r );
+
+                // select the child without branching on the data
+                const bool  left = (sum == 0.0f) || (v[k] * sum < l || r == 0.0f);
+                const float nv   = left ? v[k] * sum / l : (v[k]*sum - l) / r;
+
+                v[k]          = (sum == 0.0f) ? v[k] : nvbio::min( nv, 1.0f );
+                node_index[k] = left ? node_index[k] * 2u : (node_index[k] + 1u) * 2u;
+            }
+
+            node_base -= m*2;
+        }
+
+        // level 0
+        for (uint32 k = 0; k < block_size; ++k)
+        {
+            const uint32 size = trees.size( block_ids[k] );
+
+            // choose the proper leaf among the selected pair.
+            const float l = node_index[k]      < size ? float( trees.cell( block_ids[k], node_index[k] ) )      : 0.0f;
+            const float r = node_index[k] + 1u < size ? float( trees.cell( block_ids[k], node_index[k] + 1u ) ) : 0.0f;
+            const float sum = float( l + r );
+
+            const uint32 leaf = (v[k] * sum < l || r == 0.0f) ? node_index[k] : node_index[k] + 1u;
+
+            // clamp the leaf index to the tree size
+            leaves[ block_begin + k ] = leaf < size ? leaf : size - 1u;
+        }
+    }
+}
+
+// add a set of deltas to the leaves of a batch of trees
+//
+template <typename Iterator, typename SizeIterator>
+NVBIO_HOST
+void add(
+          SumTreeBatch<Iterator,SizeIterator>&                      trees,
+    const uint32                                                    n,
+    const uint32*                                                   tree_ids,
+    const uint32*                                                   leaves,
+    const typename SumTreeBatch<Iterator,SizeIterator>::value_type* deltas)
+{
+    uint32 dst   = 0;
+    uint32 level = 0;
+    for (uint32 m = trees.padded_size(); m >= 1; m >>= 1, ++level)
+    {
+        for (uint32 k = 0; k < n; ++k)
+            trees.node( tree_ids[k], dst + (leaves[k] >> level) ) += deltas[k];
+
+        dst += m;
+    }
+}
+
+// reset a set of leaves of a batch of trees
+//
+template <typename Iterator, typename SizeIterator>
+NVBIO_HOST
+void set(
+          SumTreeBatch<Iterator,SizeIterator>&                      trees,
+    const uint32                                                    n,
+    const uint32*                                                   tree_ids,
+    const uint32*                                                   leaves,
+    const typename SumTreeBatch<Iterator,SizeIterator>::value_type* values)
+{
+    for (uint32 k = 0; k < n; ++k)
+        trees.node( tree_ids[k], leaves[k] ) = values[k];
+
+    // recompute the ancestors bottom-up, one level at a time: since each level only depends
+    // on the one below, updates falling in the same tree are handled correctly
+    uint32 prev_base   = 0u;
+    uint32 parent_base = trees.padded_size();
+    uint32 level       = 1u;
+
+    for (uint32 m = trees.padded_size() >> 1; m >= 1; m >>= 1, ++level)
+    {
+        for (uint32 k = 0; k < n; ++k)
+        {
+            const uint32 t      = tree_ids[k];
+            const uint32 parent = leaves[k] >> level;
+
+            trees.node( t, parent_base + parent ) =
+                trees.cell( t, prev_base + parent*2   ) +
+                trees.cell( t, prev_base + parent*2+1 );
+        }
+
+        prev_base    = parent_base;
+        parent_base += m;
+    }
+}
+
 } // namespace nvbio
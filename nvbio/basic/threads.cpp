@@ -311,4 +311,180 @@ void yield() { pthread_yield(); }
 
 #endif
 
+// weight decay applied to past samples, letting the cost models track changes in the input
+static const double BATCH_SAMPLE_DECAY = 0.9;
+
+// number of consumer batches over which starvation is measured
+static const uint32 BATCH_WAIT_WINDOW = 4u;
+
+void BatchSizeController::CostModel::add(const double _n, const double _t)
+{
+    w  = w  * BATCH_SAMPLE_DECAY + 1.0;
+    n  = n  * BATCH_SAMPLE_DECAY + _n;
+    t  = t  * BATCH_SAMPLE_DECAY + _t;
+    nn = nn * BATCH_SAMPLE_DECAY + _n * _n;
+    nt = nt * BATCH_SAMPLE_DECAY + _n * _t;
+    ++samples;
+}
+
+bool BatchSizeController::CostModel::fit(double* a, double* b) const
+{
+    if (samples < 2u)
+        return false;
+
+    // the fit is ill-conditioned unless the batch sizes seen so far vary enough
+    const double det = w * nn - n * n;
+    if (det <= 1.0e-3 * w * nn)
+        return false;
+
+    *b = (w * nt - n * t) / det;
+    *a = (t - *b * n) / w;
+
+    // clamp to a physically meaningful model
+    if (*b < 0.0) { *b = 0.0; *a = t / w; }
+    if (*a < 0.0) { *a = 0.0; *b = t / n; }
+    return true;
+}
+
+BatchSizeController::BatchSizeController(
+    const uint32 min_batch,
+    const uint32 max_batch,
+    const uint32 min_in_flight,
+    const uint32 max_in_flight,
+    const uint32 consumers,
+    const uint64 memory_cap,
+    const uint32 item_bytes,
+    const float  overhead) :
+    m_min_batch( nvbio::max( nvbio::min( min_batch, max_batch ), 1u ) ),
+    m_max_batch( nvbio::max( max_batch, 1u ) ),
+    m_max_in_flight( nvbio::max( max_in_flight, 1u ) ),
+    m_consumers( nvbio::max( consumers, 1u ) ),
+    m_memory_cap( memory_cap ),
+    m_item_bytes( item_bytes ),
+    m_overhead( overhead ),
+    m_batch( m_min_batch ),
+    m_in_flight( nvbio::max( nvbio::min( min_in_flight, m_max_in_flight ), 1u ) ),
+    m_warmup( m_min_batch < m_max_batch ),
+    m_busy_time( 0.0 ),
+    m_wait_time( 0.0 ),
+    m_busy_batches( 0u )
+{}
+
+// record the time spent by a given stage to process a batch of n items
+//
+void BatchSizeController::record(const Stage stage, const uint32 n, const float seconds)
+{
+    if (n == 0u)
+        return;
+
+    ScopedLock lock( &m_lock );
+
+    m_models[ stage ].add( double(n), double(seconds) );
+
+    if (stage == CONSUMER)
+    {
+        m_busy_time += seconds;
+        ++m_busy_batches;
+    }
+    update();
+}
+
+// record the time a consumer spent waiting for its next batch
+//
+void BatchSizeController::record_wait(const float seconds)
+{
+    ScopedLock lock( &m_lock );
+    m_wait_time += seconds;
+}
+
+// return the size of the next batch
+//
+uint32 BatchSizeController::batch_size() const
+{
+    ScopedLock lock( &m_lock );
+    return m_batch;
+}
+
+// return the number of batches allowed in flight
+//
+uint32 BatchSizeController::in_flight() const
+{
+    ScopedLock lock( &m_lock );
+    return m_in_flight;
+}
+
+// update the controls; must be called with the lock held
+//
+void BatchSizeController::update()
+{
+    // the largest batch which fits in memory given the number of live batches,
+    // i.e. the ones in flight plus the ones held by the consumers
+    const uint64 live_batches = m_in_flight + m_consumers;
+    const uint64 mem_batch    = m_item_bytes ?
+        m_memory_cap / (live_batches * m_item_bytes) :
+        uint64(m_max_batch);
+
+    const uint32 cap = uint32( nvbio::max( nvbio::min( mem_batch, uint64(m_max_batch) ), uint64(m_min_batch) ) );
+
+    double a[2], b[2];
+    const bool fitted = m_models[PRODUCER].fit( &a[PRODUCER], &b[PRODUCER] ) &&
+                        m_models[CONSUMER].fit( &a[CONSUMER], &b[CONSUMER] );
+
+    if (m_warmup)
+    {
+        // keep doubling the batch size until both cost models can be fitted
+        if (fitted == false && m_batch < cap)
+        {
+            m_batch = nvbio::min( m_batch * 2u, cap );
+            return;
+        }
+        m_warmup = false;
+    }
+    if (fitted == false)
+    {
+        // the recent batches all had about the same size, so that the per-batch overhead
+        // can't be told apart from the per-item cost: probe a smaller batch size
+        m_batch = nvbio::max( nvbio::min( m_batch, cap ) / 2u, m_min_batch );
+        return;
+    }
+
+    // find the bottleneck, i.e. the stage with the lowest throughput at the largest batch size
+    const double n_cap = double(cap);
+    const double producer_rate = n_cap / (a[PRODUCER] + b[PRODUCER] * n_cap);
+    const double consumer_rate = n_cap / (a[CONSUMER] + b[CONSUMER] * n_cap) * double(m_consumers);
+    const Stage  bottleneck    = producer_rate < consumer_rate ? PRODUCER : CONSUMER;
+
+    // pick the smallest batch size amortizing the bottleneck's per-batch overhead
+    // down to the target fraction: a / (a + b * n) <= f
+    const double f = m_overhead;
+    const double target = b[bottleneck] > 0.0 ?
+        a[bottleneck] * (1.0 - f) / (f * b[bottleneck]) :
+        n_cap;
+
+    // move gradually, at most by a factor of two per update
+    uint32 batch = uint32( target < n_cap ? target : n_cap );
+    batch = nvbio::min( batch, m_batch * 2u );
+    batch = nvbio::max( batch, m_batch / 2u );
+    if (batch >= 1024u)
+        batch = util::round_i( batch, 1024u );
+
+    m_batch = nvbio::max( nvbio::min( batch, cap ), m_min_batch );
+
+    // grow the read-ahead depth if the consumers have been starving although
+    // the producer keeps up with them, i.e. if the producer's latency is bursty
+    if (m_busy_batches >= BATCH_WAIT_WINDOW)
+    {
+        if (bottleneck == CONSUMER &&
+            m_wait_time > f * m_busy_time &&
+            m_in_flight < m_max_in_flight &&
+            (m_item_bytes == 0u ||
+             uint64(m_in_flight + 1u + m_consumers) * m_batch * m_item_bytes <= m_memory_cap))
+            ++m_in_flight;
+
+        m_busy_time    = 0.0;
+        m_wait_time    = 0.0;
+        m_busy_batches = 0u;
+    }
+}
+
 } // namespace nvbio
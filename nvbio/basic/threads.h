@@ -43,6 +43,7 @@ namespace nvbio {
 /// - Mutex
 /// - ScopedLock
 /// - WorkQueue
+/// - BatchSizeController
 /// - Pipeline
 ///
 
@@ -245,6 +246,118 @@ inline uint32 balance_batch_size(uint32 batch_size, uint32 total_count, uint32 t
     return util::divide_ri(total_count, bal_batches);
 }
 
+/// A feedback controller sizing the batches exchanged between the stages of a
+/// producer / consumer pipeline, e.g. a background input thread feeding one or
+/// more compute threads.
+///
+/// Each stage reports the time it spent on every batch, which is used to fit
+/// a cost model t(n) = a + b * n (per-batch overhead plus per-item cost) to each
+/// stage. The controller then picks the smallest batch size at which the fixed
+/// overhead of the bottleneck stage drops below a given fraction of its time,
+/// clamped to [min_batch, max_batch] and to the memory cap shared by all live batches.
+/// Whenever the recent batches are too uniform in size for the fit to be well-conditioned,
+/// the controller probes a batch half as large.
+/// The number of batches allowed in flight is raised whenever the consumers are found
+/// starving while the producer is not the bottleneck.
+///
+/// \code
+/// BatchSizeController controller( 16*1024, 1024*1024, 2u, 8u );
+///
+/// // producer
+/// const uint32 n = read_batch( controller.batch_size() );
+/// controller.record( BatchSizeController::PRODUCER, n, timer.seconds() );
+///
+/// // consumer
+/// controller.record_wait( wait_timer.seconds() );
+/// controller.record( BatchSizeController::CONSUMER, n, timer.seconds() );
+/// \endcode
+///
+/// All methods are thread-safe.
+///
+class BatchSizeController
+{
+public:
+    enum Stage { PRODUCER = 0, CONSUMER = 1 };
+
+    /// constructor
+    ///
+    /// \param min_batch       minimum batch size
+    /// \param max_batch       maximum batch size
+    /// \param min_in_flight   initial number of batches in flight
+    /// \param max_in_flight   maximum number of batches in flight
+    /// \param consumers       number of parallel consumers
+    /// \param memory_cap      maximum amount of memory, in bytes, to be taken by all live batches
+    /// \param item_bytes      estimated amount of memory taken by each item
+    /// \param overhead        target fraction of the bottleneck stage's time spent in per-batch overhead
+    ///
+    BatchSizeController(
+        const uint32 min_batch,
+        const uint32 max_batch,
+        const uint32 min_in_flight,
+        const uint32 max_in_flight,
+        const uint32 consumers  = 1u,
+        const uint64 memory_cap = uint64(-1),
+        const uint32 item_bytes = 0u,
+        const float  overhead   = 0.05f);
+
+    /// record the time spent by a given stage to process a batch of n items
+    ///
+    void record(const Stage stage, const uint32 n, const float seconds);
+
+    /// record the time a consumer spent waiting for its next batch
+    ///
+    void record_wait(const float seconds);
+
+    /// return the size of the next batch
+    ///
+    uint32 batch_size() const;
+
+    /// return the number of batches allowed in flight
+    ///
+    uint32 in_flight() const;
+
+    /// return the minimum batch size
+    ///
+    uint32 min_batch_size() const { return m_min_batch; }
+
+    /// return the maximum batch size
+    ///
+    uint32 max_batch_size() const { return m_max_batch; }
+
+private:
+    // a decayed least-squares fit of t(n) = a + b * n
+    struct CostModel
+    {
+        CostModel() : w(0.0), n(0.0), t(0.0), nn(0.0), nt(0.0), samples(0u) {}
+
+        void add(const double _n, const double _t);
+        bool fit(double* a, double* b) const;
+
+        double w, n, t, nn, nt;
+        uint32 samples;
+    };
+
+    void update();
+
+    uint32      m_min_batch;
+    uint32      m_max_batch;
+    uint32      m_max_in_flight;
+    uint32      m_consumers;
+    uint64      m_memory_cap;
+    uint32      m_item_bytes;
+    float       m_overhead;
+
+    uint32      m_batch;
+    uint32      m_in_flight;
+    bool        m_warmup;
+    CostModel   m_models[2];
+    double      m_busy_time;
+    double      m_wait_time;
+    uint32      m_busy_batches;
+
+    mutable Mutex m_lock;
+};
+
 void yield();
 
 ///@} Threads
@@ -38,80 +38,80 @@
 
 namespace nvbio {
 
-template <typename T> struct device_view_subtype< thrust::device_vector<T> >        { typedef vector_view<T*,uint64> type; };
-template <typename T> struct plain_view_subtype< thrust::host_vector<T> >           { typedef vector_view<T*,uint64> type; };
-template <typename T> struct plain_view_subtype< thrust::device_vector<T> >         { typedef vector_view<T*,uint64> type; };
-template <typename T> struct plain_view_subtype< const thrust::host_vector<T> >     { typedef vector_view<const T*,uint64> type; };
-template <typename T> struct plain_view_subtype< const thrust::device_vector<T> >   { typedef vector_view<const T*,uint64> type; };
+template <typename T, typename Alloc> struct device_view_subtype< thrust::device_vector<T,Alloc> >        { typedef vector_view<T*,uint64> type; };
+template <typename T, typename Alloc> struct plain_view_subtype< thrust::host_vector<T,Alloc> >           { typedef vector_view<T*,uint64> type; };
+template <typename T, typename Alloc> struct plain_view_subtype< thrust::device_vector<T,Alloc> >         { typedef vector_view<T*,uint64> type; };
+template <typename T, typename Alloc> struct plain_view_subtype< const thrust::host_vector<T,Alloc> >     { typedef vector_view<const T*,uint64> type; };
+template <typename T, typename Alloc> struct plain_view_subtype< const thrust::device_vector<T,Alloc> >   { typedef vector_view<const T*,uint64> type; };
 
 /// return the plain view of a device vector
 ///
-template <typename T>
-vector_view<T*,uint64> device_view(thrust::device_vector<T>& vec) { return vector_view<T*,uint64>( vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL ); }
+template <typename T, typename Alloc>
+vector_view<T*,uint64> device_view(thrust::device_vector<T,Alloc>& vec) { return vector_view<T*,uint64>( vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL ); }
 
 /// return the plain view of a device vector
 ///
-template <typename T>
-vector_view<const T*,uint64> device_view(const thrust::device_vector<T>& vec) { return vector_view<const T*,uint64>( vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL ); }
+template <typename T, typename Alloc>
+vector_view<const T*,uint64> device_view(const thrust::device_vector<T,Alloc>& vec) { return vector_view<const T*,uint64>( vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL ); }
 
 /// return the plain view of a device vector
 ///
-template <typename T>
-vector_view<T*,uint64> plain_view(thrust::device_vector<T>& vec) { return vector_view<T*,uint64>( vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL ); }
+template <typename T, typename Alloc>
+vector_view<T*,uint64> plain_view(thrust::device_vector<T,Alloc>& vec) { return vector_view<T*,uint64>( vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL ); }
 
 /// return the plain view of a device vector
 ///
-template <typename T>
-vector_view<const T*,uint64> plain_view(const thrust::device_vector<T>& vec) { return vector_view<const T*,uint64>( vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL ); }
+template <typename T, typename Alloc>
+vector_view<const T*,uint64> plain_view(const thrust::device_vector<T,Alloc>& vec) { return vector_view<const T*,uint64>( vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL ); }
 
 /// return the plain view of a device vector
 ///
-template <typename T>
-vector_view<T*,uint64> plain_view(thrust::host_vector<T>& vec) { return vector_view<T*,uint64>( vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL ); }
+template <typename T, typename Alloc>
+vector_view<T*,uint64> plain_view(thrust::host_vector<T,Alloc>& vec) { return vector_view<T*,uint64>( vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL ); }
 
 /// return the plain view of a device vector
 ///
-template <typename T>
-vector_view<const T*,uint64> plain_view(const thrust::host_vector<T>& vec) { return vector_view<const T*,uint64>( vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL ); }
+template <typename T, typename Alloc>
+vector_view<const T*,uint64> plain_view(const thrust::host_vector<T,Alloc>& vec) { return vector_view<const T*,uint64>( vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL ); }
 
 /// return the raw pointer of a device vector
 ///
-template <typename T>
-T* raw_pointer(thrust::device_vector<T>& vec) { return vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL; }
+template <typename T, typename Alloc>
+T* raw_pointer(thrust::device_vector<T,Alloc>& vec) { return vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL; }
 
 /// return the raw pointer of a device vector
 ///
-template <typename T>
-const T* raw_pointer(const thrust::device_vector<T>& vec) { return vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL; }
+template <typename T, typename Alloc>
+const T* raw_pointer(const thrust::device_vector<T,Alloc>& vec) { return vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL; }
 
 /// return the raw pointer of a device vector
 ///
-template <typename T>
-T* raw_pointer(thrust::host_vector<T>& vec) { return vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL; }
+template <typename T, typename Alloc>
+T* raw_pointer(thrust::host_vector<T,Alloc>& vec) { return vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL; }
 
 /// return the plain view of a device vector
 ///
-template <typename T>
-const T* raw_pointer(const thrust::host_vector<T>& vec) { return vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL; }
+template <typename T, typename Alloc>
+const T* raw_pointer(const thrust::host_vector<T,Alloc>& vec) { return vec.size(), vec.size() ? thrust::raw_pointer_cast( &vec.front() ) : NULL; }
 
 /// return the begin iterator of a device vector
 ///
-template <typename T>
-typename thrust::device_vector<T>::iterator begin(thrust::device_vector<T>& vec) { return vec.begin; }
+template <typename T, typename Alloc>
+typename thrust::device_vector<T,Alloc>::iterator begin(thrust::device_vector<T,Alloc>& vec) { return vec.begin; }
 
 /// return the begin iterator of a device vector
 ///
-template <typename T>
-typename thrust::device_vector<T>::const_iterator begin(const thrust::device_vector<T>& vec) { return vec.begin; }
+template <typename T, typename Alloc>
+typename thrust::device_vector<T,Alloc>::const_iterator begin(const thrust::device_vector<T,Alloc>& vec) { return vec.begin; }
 
 /// return the begin iterator of a host vector
 ///
-template <typename T>
-typename thrust::host_vector<T>::iterator begin(thrust::host_vector<T>& vec) { return vec.begin; }
+template <typename T, typename Alloc>
+typename thrust::host_vector<T,Alloc>::iterator begin(thrust::host_vector<T,Alloc>& vec) { return vec.begin; }
 
 /// return the begin iterator of a host vector
 ///
-template <typename T>
-typename thrust::host_vector<T>::const_iterator begin(const thrust::host_vector<T>& vec) { return vec.begin; }
+template <typename T, typename Alloc>
+typename thrust::host_vector<T,Alloc>::const_iterator begin(const thrust::host_vector<T,Alloc>& vec) { return vec.begin; }
 
 } // namespace nvbio
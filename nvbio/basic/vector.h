@@ -37,6 +37,7 @@
 #include <nvbio/basic/vector_view.h>
 #include <thrust/host_vector.h>
 #include <thrust/device_vector.h>
+#include <memory>
 
 namespace nvbio {
 namespace cuda {
@@ -69,19 +70,30 @@ static NVBIO_FORCEINLINE void thrust_copy_vector(TTargetVector& target, TSourceV
 
 } // namespace cuda
 
+/// the default allocator used by host/device vectors, i.e. the same as thrust's own
+/// host_vector / device_vector, so that nvbio::vector's keep binding to them
+///
+template <typename system_tag, typename T> struct default_allocator {};
+template <typename T> struct default_allocator<host_tag,T>   { typedef typename thrust::host_vector<T>::allocator_type    type; };
+template <typename T> struct default_allocator<device_tag,T> { typedef typename thrust::device_vector<T>::allocator_type  type; };
+
 /// a dynamic host/device vector class
 ///
-template <typename system_tag, typename T>
+/// \tparam system_tag     the system tag
+/// \tparam T              the value type
+/// \tparam Allocator      the allocator, see \ref HostAllocatorsModule for the available host allocators
+///
+template <typename system_tag, typename T, typename Allocator = typename default_allocator<system_tag,T>::type>
 struct vector {};
 
 /// a dynamic host vector class
 ///
-template <typename T>
-struct vector<host_tag,T> : public thrust::host_vector<T>
+template <typename T, typename Allocator>
+struct vector<host_tag,T,Allocator> : public thrust::host_vector<T,Allocator>
 {
     typedef host_tag                            system_tag;
 
-    typedef thrust::host_vector<T>              base_type;
+    typedef thrust::host_vector<T,Allocator>    base_type;
     typedef typename base_type::const_iterator  const_iterator;
     typedef typename base_type::iterator        iterator;
     typedef typename base_type::value_type      value_type;
@@ -91,12 +103,12 @@ struct vector<host_tag,T> : public thrust::host_vector<T>
 
     /// constructor
     ///
-    vector<host_tag,T>(const size_t size = 0, const T val = T()) : base_type( size, val ) {}
-    vector<host_tag,T>(const thrust::host_vector<T>&   v) : base_type( v ) {}
-    vector<host_tag,T>(const thrust::device_vector<T>& v) : base_type( v ) {}
+    vector(const size_t size = 0, const T val = T()) : base_type( size, val ) {}
+    template <typename OtherAllocator> vector(const thrust::host_vector<T,OtherAllocator>&   v) : base_type( v ) {}
+    template <typename OtherAllocator> vector(const thrust::device_vector<T,OtherAllocator>& v) : base_type( v ) {}
 
-    vector<host_tag,T>& operator= (const thrust::host_vector<T>& v)   { cuda::thrust_copy_vector( *this, v ); return *this; }
-    vector<host_tag,T>& operator= (const thrust::device_vector<T>& v) { cuda::thrust_copy_vector( *this, v ); return *this; }
+    template <typename OtherAllocator> vector& operator= (const thrust::host_vector<T,OtherAllocator>& v)   { cuda::thrust_copy_vector( *this, v ); return *this; }
+    template <typename OtherAllocator> vector& operator= (const thrust::device_vector<T,OtherAllocator>& v) { cuda::thrust_copy_vector( *this, v ); return *this; }
 
     /// conversion to plain_view_type
     ///
@@ -109,12 +121,12 @@ struct vector<host_tag,T> : public thrust::host_vector<T>
 
 /// a dynamic device vector class
 ///
-template <typename T>
-struct vector<device_tag,T> : public thrust::device_vector<T>
+template <typename T, typename Allocator>
+struct vector<device_tag,T,Allocator> : public thrust::device_vector<T,Allocator>
 {
     typedef device_tag                          system_tag;
 
-    typedef thrust::device_vector<T>            base_type;
+    typedef thrust::device_vector<T,Allocator>  base_type;
     typedef typename base_type::const_iterator  const_iterator;
     typedef typename base_type::iterator        iterator;
     typedef typename base_type::value_type      value_type;
@@ -124,12 +136,12 @@ struct vector<device_tag,T> : public thrust::device_vector<T>
 
     /// constructor
     ///
-    vector<device_tag,T>(const size_t size = 0, const T val = T()) : base_type( size, val ) {}
-    vector<device_tag,T>(const thrust::host_vector<T>&   v) : base_type( v ) {}
-    vector<device_tag,T>(const thrust::device_vector<T>& v) : base_type( v ) {}
+    vector(const size_t size = 0, const T val = T()) : base_type( size, val ) {}
+    template <typename OtherAllocator> vector(const thrust::host_vector<T,OtherAllocator>&   v) : base_type( v ) {}
+    template <typename OtherAllocator> vector(const thrust::device_vector<T,OtherAllocator>& v) : base_type( v ) {}
 
-    vector<device_tag,T>& operator= (const thrust::host_vector<T>& v)   { cuda::thrust_copy_vector( *this, v ); return *this; }
-    vector<device_tag,T>& operator= (const thrust::device_vector<T>& v) { cuda::thrust_copy_vector( *this, v ); return *this; }
+    template <typename OtherAllocator> vector& operator= (const thrust::host_vector<T,OtherAllocator>& v)   { cuda::thrust_copy_vector( *this, v ); return *this; }
+    template <typename OtherAllocator> vector& operator= (const thrust::device_vector<T,OtherAllocator>& v) { cuda::thrust_copy_vector( *this, v ); return *this; }
 
     /// conversion to plain_view_type
     ///
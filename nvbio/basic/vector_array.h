@@ -31,6 +31,7 @@
 #include <nvbio/basic/thrust_view.h>
 #include <nvbio/basic/atomics.h>
 #include <nvbio/basic/vector.h>   // thrust_copy_vector
+#include <memory>
 
 namespace nvbio {
 
@@ -283,12 +284,19 @@ struct DeviceVectorArray
 ///
 /// A utility class to manage a vector of dynamically-allocated arrays
 ///
-template <typename T>
+/// \tparam T           the element type
+/// \tparam Allocator   the host allocator used for the arena and the index vectors,
+///                     see \ref HostAllocatorsModule
+///
+template <typename T, typename Allocator = std::allocator<T> >
 struct HostVectorArray
 {
     typedef device_tag            system_tag;
     typedef VectorArrayView<T>    plain_view_type;  ///< this object's plain view type
 
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<T>       arena_allocator_type;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<uint32>  index_allocator_type;
+
     /// constructor
     ///
     HostVectorArray() : m_pool(1,0) {}
@@ -355,7 +363,7 @@ struct HostVectorArray
 
     /// swap
     ///
-    HostVectorArray& swap(HostVectorArray<T>& vec)
+    HostVectorArray& swap(HostVectorArray<T,Allocator>& vec)
     {
         m_arena.swap( vec.m_arena );
         m_index.swap( vec.m_index );
@@ -390,10 +398,10 @@ struct HostVectorArray
             uint32( m_arena.size() ) );
     }
 
-    thrust::host_vector<T>        m_arena;        ///< memory arena
-    thrust::host_vector<uint32>   m_index;        ///< index of the allocated arrays
-    thrust::host_vector<uint32>   m_sizes;        ///< sizes of the allocated arrays
-    thrust::host_vector<uint32>   m_pool;         ///< pool counter
+    thrust::host_vector<T,arena_allocator_type>        m_arena;        ///< memory arena
+    thrust::host_vector<uint32,index_allocator_type>   m_index;        ///< index of the allocated arrays
+    thrust::host_vector<uint32,index_allocator_type>   m_sizes;        ///< sizes of the allocated arrays
+    thrust::host_vector<uint32,index_allocator_type>   m_pool;         ///< pool counter
 };
 
 ///\relates DeviceVectorArray
@@ -411,8 +419,8 @@ VectorArrayView<T> plain_view(DeviceVectorArray<T>& vec) { return vec.device_vie
 ///\relates DeviceVectorArray
 /// return a view of the queues
 ///
-template <typename T>
-VectorArrayView<T> plain_view(HostVectorArray<T>& vec) { return vec.plain_view(); }
+template <typename T, typename Allocator>
+VectorArrayView<T> plain_view(HostVectorArray<T,Allocator>& vec) { return vec.plain_view(); }
 
 ///@} // VectorArrayModule
 ///@} Basic
@@ -28,6 +28,7 @@
 #pragma once
 
 #include <nvbio/fmindex/fmindex.h>
+#include <nvbio/fmindex/seed_cache.h>
 #include <nvbio/basic/types.h>
 #include <nvbio/basic/numbers.h>
 #include <nvbio/basic/algorithms.h>
@@ -85,6 +86,14 @@ struct FMIndexFilter<host_tag, fm_index_type>
     static const uint32                                     hit_dim = coord_dim*2;  ///< hits are either uint2 or uint4
     typedef typename vector_type<coord_type,hit_dim>::type  hit_type;               ///< hits are either uint2 or uint4
 
+    typedef SeedIntervalCacheView<typename vector_traits<coord_type>::value_type> cache_type; ///< the seed interval cache type
+
+    /// set a seed interval cache to be consulted (and filled) by rank() before searching
+    /// the index; note that a cache must only ever be used with a single FM-index, and that
+    /// it is only supported with scalar coordinate types
+    ///
+    void set_cache(const cache_type cache) { m_cache = cache; }
+
     /// enact the filter on an FM-index and a string-set
     ///
     /// \param index            the FM-index
@@ -126,6 +135,7 @@ struct FMIndexFilter<host_tag, fm_index_type>
     uint32                              m_n_queries;
     index_type                          m_index;
     uint64                              m_n_occurrences;
+    cache_type                          m_cache;
     thrust::host_vector<range_type>     m_ranges;
     thrust::host_vector<uint64>         m_slots;
 };
@@ -155,6 +165,14 @@ struct FMIndexFilter<device_tag, fm_index_type>
     static const uint32                                     hit_dim = coord_dim*2;  ///< hits are either uint2 or uint4
     typedef typename vector_type<coord_type,hit_dim>::type  hit_type;               ///< hits are either uint2 or uint4
 
+    typedef SeedIntervalCacheView<typename vector_traits<coord_type>::value_type> cache_type; ///< the seed interval cache type
+
+    /// set a seed interval cache to be consulted (and filled) by rank() before searching
+    /// the index; note that a cache must only ever be used with a single FM-index, and that
+    /// it is only supported with scalar coordinate types
+    ///
+    void set_cache(const cache_type cache) { m_cache = cache; }
+
     /// enact the filter on an FM-index and a string-set
     ///
     /// \param index            the FM-index
@@ -196,6 +214,7 @@ struct FMIndexFilter<device_tag, fm_index_type>
     uint32                              m_n_queries;
     index_type                          m_index;
     uint64                              m_n_occurrences;
+    cache_type                          m_cache;
     thrust::device_vector<range_type>   m_ranges;
     thrust::device_vector<uint64>       m_slots;
     thrust::device_vector<hit_type>     m_hits;
@@ -75,6 +75,70 @@ struct rank_functor
     const string_set_type   string_set;
 };
 
+// a rank_functor memoizing the ranges of repetitive strings in a seed interval cache
+template <typename index_type, typename string_set_type, typename cache_type, bool SCALAR_COORDS>
+struct cached_rank_functor
+{
+    typedef typename index_type::range_type range_type;
+
+    typedef uint32                          argument_type;
+    typedef range_type                      result_type;
+
+    // constructor
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    cached_rank_functor(
+        const index_type        _index,
+        const string_set_type   _string_set,
+        const cache_type        _cache) :
+    index       ( _index ),
+    string_set  ( _string_set ),
+    cache       ( _cache ) {}
+
+    // functor operator
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    result_type operator() (const argument_type string_id) const
+    {
+        typedef typename string_set_type::string_type   string_type;
+
+        // fetch the given string
+        const string_type string = string_set[ string_id ];
+        const uint32      len    = length( string );
+
+        // check whether it can be looked up at all
+        uint64 key;
+        if (pack_seed( string, len, &key ) == false)
+            return match( index, string, len );
+
+        // check whether it's been cached
+        range_type range, unused;
+        if (cache.find( key, &range, &unused ))
+            return range;
+
+        // match it in the FM-index, and store the result if it's repetitive enough;
+        // only the forward range is needed here, so the second one is left empty
+        range = match( index, string, len );
+        cache.insert( key, range, make_vector( range.x + 1u, range.x ) );
+        return range;
+    }
+
+    const index_type        index;
+    const string_set_type   string_set;
+    const cache_type        cache;
+};
+
+// vector coordinates can't be cached: fall back to the plain functor
+template <typename index_type, typename string_set_type, typename cache_type>
+struct cached_rank_functor<index_type,string_set_type,cache_type,false> : public rank_functor<index_type,string_set_type>
+{
+    // constructor
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    cached_rank_functor(
+        const index_type        _index,
+        const string_set_type   _string_set,
+        const cache_type        _cache) :
+    rank_functor<index_type,string_set_type>( _index, _string_set ) {}
+};
+
 template <typename range_type>
 struct filter_results
 {
@@ -212,11 +276,22 @@ uint64 FMIndexFilter<host_tag, fm_index_type>::rank(
     m_slots.resize( m_n_queries );
 
     // search the strings in the index, obtaining a set of ranges
-    thrust::transform(
-        thrust::make_counting_iterator<uint32>(0u),
-        thrust::make_counting_iterator<uint32>(0u) + m_n_queries,
-        m_ranges.begin(),
-        fmindex::rank_functor<fm_index_type,string_set_type>( m_index, string_set ) );
+    if (m_cache.enabled())
+    {
+        thrust::transform(
+            thrust::make_counting_iterator<uint32>(0u),
+            thrust::make_counting_iterator<uint32>(0u) + m_n_queries,
+            m_ranges.begin(),
+            fmindex::cached_rank_functor<fm_index_type,string_set_type,cache_type,coord_dim == 1>( m_index, string_set, m_cache ) );
+    }
+    else
+    {
+        thrust::transform(
+            thrust::make_counting_iterator<uint32>(0u),
+            thrust::make_counting_iterator<uint32>(0u) + m_n_queries,
+            m_ranges.begin(),
+            fmindex::rank_functor<fm_index_type,string_set_type>( m_index, string_set ) );
+    }
 
     // scan their size to determine the slots
     thrust::inclusive_scan(
@@ -280,11 +355,22 @@ uint64 FMIndexFilter<device_tag,fm_index_type>::rank(
     m_slots.resize( m_n_queries );
 
     // search the strings in the index, obtaining a set of ranges
-    thrust::transform(
-        thrust::make_counting_iterator<uint32>(0u),
-        thrust::make_counting_iterator<uint32>(0u) + m_n_queries,
-        m_ranges.begin(),
-        fmindex::rank_functor<fm_index_type,string_set_type>( m_index, string_set ) );
+    if (m_cache.enabled())
+    {
+        thrust::transform(
+            thrust::make_counting_iterator<uint32>(0u),
+            thrust::make_counting_iterator<uint32>(0u) + m_n_queries,
+            m_ranges.begin(),
+            fmindex::cached_rank_functor<fm_index_type,string_set_type,cache_type,coord_dim == 1>( m_index, string_set, m_cache ) );
+    }
+    else
+    {
+        thrust::transform(
+            thrust::make_counting_iterator<uint32>(0u),
+            thrust::make_counting_iterator<uint32>(0u) + m_n_queries,
+            m_ranges.begin(),
+            fmindex::rank_functor<fm_index_type,string_set_type>( m_index, string_set ) );
+    }
 
     // scan their size to determine the slots
     cuda::inclusive_scan(
@@ -281,6 +281,11 @@ namespace nvbio {
 ///    }
 /// }
 ///\endcode
+///\par
+/// When the same seeds recur many times across batches (e.g. seeds falling in highly repetitive
+/// regions of a genome), the filters can be given a \ref SeedCacheModule "seed interval cache" with
+/// set_cache(): the SA ranges of seeds occurring at least a given number of times will then
+/// be memoized in a shared hash table, and looked up before performing any backward search.
 ///
 ///\anchor MEMFilters
 /// \section MEMFiltersSection MEM Filtering
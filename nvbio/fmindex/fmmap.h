@@ -0,0 +1,364 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/fmindex/filter.h>
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/vector.h>
+#include <nvbio/basic/primitives.h>
+#include <nvbio/basic/pipeline_context.h>
+#include <nvbio/basic/timer.h>
+#include <nvbio/basic/atomics.h>
+#include <nvbio/basic/shared_pointer.h>
+#include <nvbio/strings/infix.h>
+#include <nvbio/strings/seeds.h>
+#include <nvbio/strings/string_set.h>
+#include <nvbio/alignment/alignment.h>
+#include <nvbio/alignment/batched.h>
+#include <nvbio/alignment/sink.h>
+#include <nvbio/io/sequence/sequence.h>
+#include <nvbio/io/sequence/sequence_access.h>
+
+namespace nvbio {
+
+///@addtogroup FMIndex
+///@{
+
+///\defgroup FMMapModule FM-index Mapper
+///\par
+/// This module implements a lightweight seed-filter-verify short read mapper on top of
+/// FMIndexFilter and the \ref BatchAlignmentSection "batched banded aligners", running on either
+/// the host or the device backend:
+///\par
+/// - the <i>filter</i> step extracts uniformly spaced seeds from a batch of reads, ranks them against
+///   an FM-index and locates all their occurrences, turning each hit into a diagonal, i.e.
+///   a <i>(text-pos - read-pos, read-id)</i> pair;
+/// - the <i>verify</i> step aligns each read against a band around each of its diagonals,
+///   keeping the best score of each read.
+///\par
+/// The hits of a read batch are located and verified in <i>hit batches</i> of at most
+/// FMMapParams::hits_batch_size hits, so that the memory needed to store them is bounded
+/// regardless of how repetitive the seeds are.
+///\par
+/// The two steps can be called synchronously through FMMapper::map(), or run as separate stages
+/// of an nvbio::Pipeline (FMMapFilterStage and FMMapVerifyStage), whose unit of work is a hit batch,
+/// so that filtering of hit batch <i>i+1</i> overlaps with verification of hit batch <i>i</i>:
+///
+///\code
+/// typedef io::FMIndexDataHost::fm_index_type                 fm_index_type;
+/// typedef FMMapper<host_tag,fm_index_type>                   mapper_type;
+///
+/// mapper_type mapper( params, fm_data.index(), plain_view( genome_data ) );
+///
+/// FMMapFilterStage<mapper_type> filter( mapper, read_file, batch_reads, batch_bps );
+/// FMMapVerifyStage<mapper_type> verify( mapper );
+/// MySinkStage                sink;                  // consuming FMMapResults batches
+///
+/// Pipeline pipeline;
+/// const uint32 s0 = pipeline.append_stage( &filter, params.buffers );
+/// const uint32 s1 = pipeline.append_stage( &verify, params.buffers );
+/// const uint32 s2 = pipeline.append_sink( &sink );
+/// pipeline.add_dependency( s0, s1 );
+/// pipeline.add_dependency( s1, s2 );
+/// pipeline.run();
+///\endcode
+///\par
+/// The reads are expected to be encoded as consecutive forward and reverse-complemented
+/// pairs (i.e. loaded with io::FORWARD | io::REVERSE_COMPLEMENT), and the results of
+/// both strands are merged into a single best score per read.
+///@{
+
+///
+/// FMMapper parameters
+///
+struct FMMapParams
+{
+    FMMapParams() :
+        seed_len( 22 ),
+        seed_intv( 10 ),
+        hits_batch_size( 16*1024*1024 ),
+        buffers( 2 ) {}
+
+    uint32 seed_len;            ///< seed length
+    uint32 seed_intv;           ///< spacing between consecutive seeds
+    uint32 hits_batch_size;     ///< maximum number of hits located and verified at once
+    uint32 buffers;             ///< number of buffers per pipeline stage (a power of 2)
+};
+
+///
+/// FMMapper statistics
+///
+struct FMMapStats
+{
+    FMMapStats() :
+        extract_time(0),
+        rank_time(0),
+        locate_time(0),
+        align_time(0),
+        reads(0),
+        queries(0),
+        occurrences(0) {}
+
+    float   extract_time;
+    float   rank_time;
+    float   locate_time;
+    float   align_time;
+    uint64  reads;
+    uint64  queries;
+    uint64  occurrences;
+};
+
+///
+/// A batch of the hits found by the filtering step for a batch of reads
+///
+template <typename system_tag>
+struct FMMapHits
+{
+    /// return the number of diagonals
+    ///
+    uint64 size() const { return diagonals.size(); }
+
+    nvbio::vector<system_tag,uint2>                         diagonals;      ///< the (text-pos, read-id) diagonals, sorted by read
+};
+
+///
+/// A seed-filter-verify mapper over an FM-index.
+///\par
+/// The filter() and verify() methods touch disjoint state, so that they can be run
+/// concurrently by separate pipeline threads; neither of them is reentrant.
+///
+/// \tparam system_tag      the backend system (host_tag or device_tag)
+/// \tparam fm_index_type   the FM-index type, as returned by io::FMIndexData*::index()
+/// \tparam BAND_LEN        the width of the alignment band around each diagonal
+///
+template <typename system_tag, typename fm_index_type, uint32 BAND_LEN = 31>
+struct FMMapper
+{
+    typedef system_tag                                                  system_type;
+    typedef io::SequenceDataStorage<system_tag>                         read_batch_type;
+    typedef FMIndexFilter<system_tag,fm_index_type>                     fm_filter_type;
+    typedef io::SequenceDataAccess<DNA,io::ConstSequenceDataView>       genome_access_type;
+    typedef typename genome_access_type::sequence_stream_type           genome_string;
+    typedef io::SequenceDataAccess<DNA_N,io::ConstSequenceDataView>     read_access_type;
+    typedef typename read_access_type::sequence_string_set_type         read_string_set_type;
+    typedef typename read_access_type::sequence_stream_type             read_stream;
+
+    /// constructor
+    ///
+    /// \param params       the mapping parameters
+    /// \param index        an FM-index view, residing in the memory space of system_tag
+    /// \param genome       the genome, residing in the memory space of system_tag
+    ///
+    FMMapper(
+        const FMMapParams               params,
+        const fm_index_type             index,
+        const io::ConstSequenceDataView genome);
+
+    /// filter a batch of reads, extracting and ranking its seeds
+    ///
+    /// \param reads        the read batch
+    ///
+    /// \return             the number of hits, to be located with locate()
+    ///
+    uint64 filter(
+        const read_batch_type&          reads);
+
+    /// locate a batch of hits of the last filtered read batch, finding their diagonals
+    ///
+    /// \param hits_begin   the first hit to locate
+    /// \param hits_end     the end of the hits to locate, at most params.hits_batch_size hits past hits_begin
+    /// \param hits         the output hits
+    ///
+    void locate(
+        const uint64                    hits_begin,
+        const uint64                    hits_end,
+        FMMapHits<system_tag>&          hits);
+
+    /// reset the best scores of a batch of reads, before verifying its hits
+    ///
+    /// \param reads        the read batch
+    /// \param best_scores  the output best scores, one per forward/reverse-complemented read pair
+    ///
+    void reset(
+        const read_batch_type&              reads,
+        nvbio::vector<system_tag,int16>&    best_scores);
+
+    /// verify a batch of hits of a batch of reads, folding their scores into the best score of each read
+    ///
+    /// \param reads        the read batch
+    /// \param hits         a batch of hits returned by locate()
+    /// \param best_scores  the best scores, one per forward/reverse-complemented read pair, as initialized by reset()
+    ///
+    void verify(
+        const read_batch_type&              reads,
+        const FMMapHits<system_tag>&        hits,
+        nvbio::vector<system_tag,int16>&    best_scores);
+
+    /// filter and verify a batch of reads synchronously
+    ///
+    /// \param reads        the read batch
+    /// \param best_scores  the output best scores, one per forward/reverse-complemented read pair
+    ///
+    void map(
+        const read_batch_type&              reads,
+        nvbio::vector<system_tag,int16>&    best_scores);
+
+    /// return the filtering statistics
+    ///
+    const FMMapStats& filter_stats() const { return m_filter_stats; }
+
+    /// return the verification statistics
+    ///
+    const FMMapStats& verify_stats() const { return m_verify_stats; }
+
+    FMMapParams                                         params;
+
+private:
+    fm_index_type                                       m_index;
+    io::ConstSequenceDataView                           m_genome;
+
+    // filtering state
+    fm_filter_type                                          m_filter;
+    nvbio::vector<system_tag,string_set_infix_coord_type>   m_seed_coords;
+    nvbio::vector<system_tag,uint2>                         m_located;
+    FMMapStats                                              m_filter_stats;
+    FMMapHits<system_tag>                                   m_hits;
+
+    // verification state
+    nvbio::vector<system_tag,string_infix_coord_type>   m_read_infixes;
+    nvbio::vector<system_tag,string_infix_coord_type>   m_genome_infixes;
+    nvbio::vector<system_tag,aln::BestSink<int16> >     m_sinks;
+    nvbio::vector<system_tag,uint32>                    m_out_reads;
+    nvbio::vector<system_tag,int16>                     m_out_scores;
+    nvbio::vector<system_tag,uint8>                     m_temp_storage;
+    FMMapStats                                          m_verify_stats;
+};
+
+///
+/// A hit batch flowing from the filtering to the verification stage of a mapping pipeline
+///
+template <typename system_tag>
+struct FMMapBatch
+{
+    typedef SharedPointer<io::SequenceDataStorage<system_tag>, AtomicInt32> read_batch_pointer;
+
+    read_batch_pointer                  reads;          ///< the read batch the hits belong to, in the memory space of system_tag,
+                                                        ///< shared by all of its hit batches
+    FMMapHits<system_tag>               hits;           ///< a batch of its hits
+    uint64                              read_offset;    ///< the global index of the first read of the read batch
+    bool                                first;          ///< whether this is the first hit batch of its read batch
+    bool                                last;           ///< whether this is the last hit batch of its read batch
+};
+
+///
+/// The output of a mapping pipeline, one hit batch at a time: the best scores are only
+/// filled in by the last hit batch of each read batch, and are empty otherwise
+///
+struct FMMapResults
+{
+    uint64                              read_offset;    ///< the global index of the first read of the batch
+    nvbio::vector<host_tag,int16>       best_scores;    ///< the best score of each read
+};
+
+///
+/// The source stage of an nvbio::Pipeline, loading batches of reads, copying them to the
+/// mapper's backend, filtering them, and splitting their hits in hit batches
+///
+template <typename mapper_type>
+struct FMMapFilterStage
+{
+    typedef typename mapper_type::system_type   system_tag;
+    typedef void                                argument_type;
+    typedef FMMapBatch<system_tag>              return_type;
+
+    /// constructor
+    ///
+    /// \param mapper       the mapper
+    /// \param read_file    the input reads stream, encoded as forward and reverse-complemented pairs
+    /// \param max_reads    the maximum number of reads in a read batch
+    /// \param max_bps      the maximum number of bps in a read batch
+    ///
+    FMMapFilterStage(
+        mapper_type&            mapper,
+        io::SequenceDataStream* read_file,
+        const uint32            max_reads,
+        const uint32            max_bps) :
+        m_mapper( &mapper ),
+        m_read_file( read_file ),
+        m_max_reads( max_reads ),
+        m_max_bps( max_bps ),
+        m_n_reads( 0 ),
+        m_hits_begin( 0 ),
+        m_n_hits( 0 ),
+        m_loaded( false ) {}
+
+    /// process the next batch
+    ///
+    bool process(PipelineContext& context);
+
+    mapper_type*                            m_mapper;
+    io::SequenceDataStream*                 m_read_file;
+    uint32                                  m_max_reads;
+    uint32                                  m_max_bps;
+    io::SequenceDataHost                    m_h_reads;
+    typename return_type::read_batch_pointer m_reads;
+    uint64                                  m_n_reads;
+    uint64                                  m_hits_begin;
+    uint64                                  m_n_hits;
+    bool                                    m_loaded;
+};
+
+///
+/// An nvbio::Pipeline stage verifying hit batches, and returning the best scores of each
+/// read batch on the host
+///
+template <typename mapper_type>
+struct FMMapVerifyStage
+{
+    typedef typename mapper_type::system_type   system_tag;
+    typedef FMMapBatch<system_tag>              argument_type;
+    typedef FMMapResults                        return_type;
+
+    /// constructor
+    ///
+    FMMapVerifyStage(mapper_type& mapper) : m_mapper( &mapper ) {}
+
+    /// process the next batch
+    ///
+    bool process(PipelineContext& context);
+
+    mapper_type*                        m_mapper;
+    nvbio::vector<system_tag,int16>     m_best_scores;
+};
+
+///@} FMMapModule
+///@} FMIndex
+
+} // namespace nvbio
+
+#include <nvbio/fmindex/fmmap_inl.h>
@@ -0,0 +1,469 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+namespace nvbio {
+
+namespace priv {
+
+// transform an (index-pos,seed-id) hit into a diagonal (text-pos = index-pos - seed-pos, read-id);
+// diagonals starting before the beginning of the genome are clamped to it
+//
+struct fmmap_hit_to_diagonal
+{
+    typedef uint2  argument_type;
+    typedef uint2  result_type;
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    fmmap_hit_to_diagonal(const string_set_infix_coord_type* _seed_coords) : seed_coords(_seed_coords) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint2 operator() (const uint2 hit) const
+    {
+        const uint32 index_pos = hit.x;
+        const uint32 seed_id   = hit.y;
+
+        const string_set_infix_coord_type seed = seed_coords[ seed_id ];
+
+        const uint32 read_pos = infix_begin( seed );
+        const uint32 read_id  =   string_id( seed );
+
+        return make_uint2( index_pos > read_pos ? index_pos - read_pos : 0u, read_id );
+    }
+
+    const string_set_infix_coord_type* seed_coords;
+};
+
+// extract the read infix corresponding to a diagonal
+//
+struct fmmap_read_infixes
+{
+    typedef uint2                   argument_type;
+    typedef string_infix_coord_type result_type;
+
+    NVBIO_HOST_DEVICE
+    fmmap_read_infixes(const io::ConstSequenceDataView reads) : m_reads( reads ) {}
+
+    NVBIO_HOST_DEVICE
+    string_infix_coord_type operator() (const uint2 diagonal) const
+    {
+        const io::SequenceDataAccess<DNA_N> reads( m_reads );
+
+        return reads.get_range( diagonal.y );
+    }
+
+    const io::ConstSequenceDataView m_reads;
+};
+
+// extract the genome infix corresponding to a diagonal, padded by half a band on each side
+//
+template <uint32 BAND_LEN>
+struct fmmap_genome_infixes
+{
+    typedef uint2                   argument_type;
+    typedef string_infix_coord_type result_type;
+
+    NVBIO_HOST_DEVICE
+    fmmap_genome_infixes(const uint32 genome_len, const io::ConstSequenceDataView reads) :
+        m_genome_len( genome_len ),
+        m_reads( reads ) {}
+
+    NVBIO_HOST_DEVICE
+    string_infix_coord_type operator() (const uint2 diagonal) const
+    {
+        const io::SequenceDataAccess<DNA_N> reads( m_reads );
+
+        const uint32 read_id  = diagonal.y;
+        const uint32 text_pos = diagonal.x;
+
+        // fetch the read range
+        const uint2  read_range = reads.get_range( read_id );
+        const uint32 read_len   = read_range.y - read_range.x;
+
+        // compute the segment of text to align to
+        const uint32 genome_begin = text_pos > BAND_LEN/2 ? text_pos - BAND_LEN/2 : 0u;
+        const uint32 genome_end   = nvbio::min( genome_begin + read_len + BAND_LEN, m_genome_len );
+
+        return make_uint2( genome_begin, genome_end );
+    }
+
+    const uint32                    m_genome_len;
+    const io::ConstSequenceDataView m_reads;
+};
+
+// map a diagonal to its read pair, merging the forward and reverse-complemented strands
+//
+struct fmmap_diagonal_to_read
+{
+    typedef uint2  argument_type;
+    typedef uint32 result_type;
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint32 operator() (const uint2 diagonal) const { return diagonal.y / 2u; }
+};
+
+// extract the score from a sink
+//
+struct fmmap_sink_score
+{
+    typedef aln::BestSink<int16> argument_type;
+    typedef int16                result_type;
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    int16 operator() (const aln::BestSink<int16>& sink) const { return sink.score; }
+};
+
+// fold the best scores of a hit batch into the global best scores;
+// within a batch each read appears at most once, hence no atomics are needed
+//
+struct fmmap_update_scores
+{
+    typedef uint32 argument_type;
+    typedef void   result_type;
+
+    NVBIO_HOST_DEVICE
+    fmmap_update_scores(const uint32* _reads, const int16* _scores, int16* _best) :
+        reads( _reads ), scores( _scores ), best( _best ) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void operator() (const uint32 i) const
+    {
+        const uint32 read_id = reads[i];
+        best[ read_id ] = nvbio::max( best[ read_id ], scores[i] );
+    }
+
+    const uint32* reads;
+    const int16*  scores;
+          int16*  best;
+};
+
+// the batch scheduler used on each backend
+//
+template <typename system_tag> struct fmmap_scheduler {};
+template <> struct fmmap_scheduler<host_tag>   { typedef aln::HostThreadScheduler   type; };
+template <> struct fmmap_scheduler<device_tag> { typedef aln::DeviceThreadScheduler type; };
+
+// wait for the given backend to be idle, so as to measure its time
+//
+inline void fmmap_sync(const host_tag)   {}
+inline void fmmap_sync(const device_tag) { cudaDeviceSynchronize(); }
+
+} // namespace priv
+
+// constructor
+//
+template <typename system_tag, typename fm_index_type, uint32 BAND_LEN>
+FMMapper<system_tag,fm_index_type,BAND_LEN>::FMMapper(
+    const FMMapParams               _params,
+    const fm_index_type             index,
+    const io::ConstSequenceDataView genome) :
+    params( _params ),
+    m_index( index ),
+    m_genome( genome )
+{}
+
+// filter a batch of reads, extracting and ranking its seeds
+//
+template <typename system_tag, typename fm_index_type, uint32 BAND_LEN>
+uint64 FMMapper<system_tag,fm_index_type,BAND_LEN>::filter(
+    const read_batch_type&          reads)
+{
+    typedef InfixSet<read_string_set_type, const string_set_infix_coord_type*> seed_string_set_type;
+
+    Timer timer;
+    timer.start();
+
+    // enumerate all seeds
+    const read_access_type     reads_access( nvbio::plain_view( reads ) );
+    const read_string_set_type read_string_set = reads_access.sequence_string_set();
+
+    const uint32 n_seeds = enumerate_string_set_seeds(
+        read_string_set,
+        uniform_seeds_functor<>( params.seed_len, params.seed_intv ),
+        m_seed_coords );
+
+    const seed_string_set_type seed_string_set(
+        n_seeds,
+        read_string_set,
+        nvbio::plain_view( m_seed_coords ) );
+
+    priv::fmmap_sync( system_tag() );
+    timer.stop();
+    m_filter_stats.extract_time += timer.seconds();
+    m_filter_stats.queries      += n_seeds;
+    m_filter_stats.reads        += reads.size() / 2;
+
+    // rank the seeds
+    timer.start();
+
+    const uint64 n_hits = m_filter.rank( m_index, seed_string_set );
+
+    priv::fmmap_sync( system_tag() );
+    timer.stop();
+    m_filter_stats.rank_time   += timer.seconds();
+    m_filter_stats.occurrences += n_hits;
+    return n_hits;
+}
+
+// locate a batch of hits of the last filtered read batch, finding their diagonals
+//
+template <typename system_tag, typename fm_index_type, uint32 BAND_LEN>
+void FMMapper<system_tag,fm_index_type,BAND_LEN>::locate(
+    const uint64                    hits_begin,
+    const uint64                    hits_end,
+    FMMapHits<system_tag>&          hits)
+{
+    const uint32 n_hits = uint32( hits_end - hits_begin );
+
+    Timer timer;
+    timer.start();
+
+    hits.diagonals.resize( n_hits );
+    m_located.resize( n_hits );
+
+    if (n_hits)
+    {
+        m_filter.locate(
+            hits_begin,
+            hits_end,
+            m_located.begin() );
+
+        // transform the hits into diagonals
+        nvbio::transform<system_tag>(
+            n_hits,
+            m_located.begin(),
+            hits.diagonals.begin(),
+            priv::fmmap_hit_to_diagonal( nvbio::plain_view( m_seed_coords ) ) );
+    }
+
+    priv::fmmap_sync( system_tag() );
+    timer.stop();
+    m_filter_stats.locate_time += timer.seconds();
+}
+
+// reset the best scores of a batch of reads, before verifying its hits
+//
+template <typename system_tag, typename fm_index_type, uint32 BAND_LEN>
+void FMMapper<system_tag,fm_index_type,BAND_LEN>::reset(
+    const read_batch_type&              reads,
+    nvbio::vector<system_tag,int16>&    best_scores)
+{
+    // start with no alignments
+    best_scores.resize( reads.size() / 2 );
+    thrust::fill( best_scores.begin(), best_scores.end(), Field_traits<int16>::min() );
+
+    m_verify_stats.reads += reads.size() / 2;
+}
+
+// verify a batch of hits of a batch of reads, folding their scores into the best score of each read
+//
+template <typename system_tag, typename fm_index_type, uint32 BAND_LEN>
+void FMMapper<system_tag,fm_index_type,BAND_LEN>::verify(
+    const read_batch_type&              reads,
+    const FMMapHits<system_tag>&        hits,
+    nvbio::vector<system_tag,int16>&    best_scores)
+{
+    typedef typename nvbio::vector<system_tag,string_infix_coord_type>::const_iterator infix_iterator;
+    typedef typename priv::fmmap_scheduler<system_tag>::type                           scheduler_type;
+    typedef typename nvbio::vector<system_tag,uint2>::const_iterator                   diagonal_iterator;
+
+    const io::ConstSequenceDataView reads_view = nvbio::plain_view( reads );
+    const read_access_type          reads_access( reads_view );
+
+    const genome_access_type genome_access( m_genome );
+    const uint32             genome_len = genome_access.bps();
+    const genome_string      genome( genome_access.sequence_stream() );
+
+    const uint32 n_hits = uint32( hits.size() );
+    if (n_hits == 0)
+        return;
+
+    m_read_infixes.resize( n_hits );
+    m_genome_infixes.resize( n_hits );
+    m_sinks.resize( n_hits );
+    m_out_reads.resize( n_hits );
+    m_out_scores.resize( n_hits );
+
+    Timer timer;
+    timer.start();
+
+    const diagonal_iterator diagonals = hits.diagonals.begin();
+
+    // build the sets of read and genome infixes
+    nvbio::transform<system_tag>(
+        n_hits,
+        diagonals,
+        m_read_infixes.begin(),
+        priv::fmmap_read_infixes( reads_view ) );
+
+    nvbio::transform<system_tag>(
+        n_hits,
+        diagonals,
+        m_genome_infixes.begin(),
+        priv::fmmap_genome_infixes<BAND_LEN>( genome_len, reads_view ) );
+
+    const SparseStringSet<read_stream,infix_iterator> read_infix_set(
+        n_hits,
+        reads_access.sequence_stream(),
+        m_read_infixes.begin() );
+
+    const SparseStringSet<genome_string,infix_iterator> genome_infix_set(
+        n_hits,
+        genome,
+        m_genome_infixes.begin() );
+
+    // align each read against the band around its diagonal
+    aln::batch_banded_alignment_score<BAND_LEN>(
+        aln::make_edit_distance_aligner<aln::SEMI_GLOBAL, aln::MyersTag<5u> >(),
+        read_infix_set,
+        genome_infix_set,
+        m_sinks.begin(),
+        scheduler_type(),
+        reads.max_sequence_len(),
+        reads.max_sequence_len() + BAND_LEN );
+
+    // compute the best score for each read pair in this batch: the diagonals are sorted
+    // by read, so that each read pair appears in at most one run
+    const uint32 n_reads = reduce_by_key<system_tag>(
+        n_hits,
+        thrust::make_transform_iterator( diagonals, priv::fmmap_diagonal_to_read() ),
+        thrust::make_transform_iterator( m_sinks.begin(), priv::fmmap_sink_score() ),
+        m_out_reads.begin(),
+        m_out_scores.begin(),
+        thrust::maximum<int16>(),
+        m_temp_storage );
+
+    // and keep track of the global best, as the hits of a read pair may span several batches
+    nvbio::for_each<system_tag>(
+        n_reads,
+        thrust::make_counting_iterator<uint32>(0u),
+        priv::fmmap_update_scores(
+            nvbio::plain_view( m_out_reads ),
+            nvbio::plain_view( m_out_scores ),
+            nvbio::plain_view( best_scores ) ) );
+
+    priv::fmmap_sync( system_tag() );
+    timer.stop();
+    m_verify_stats.align_time  += timer.seconds();
+    m_verify_stats.occurrences += n_hits;
+}
+
+// filter and verify a batch of reads synchronously
+//
+template <typename system_tag, typename fm_index_type, uint32 BAND_LEN>
+void FMMapper<system_tag,fm_index_type,BAND_LEN>::map(
+    const read_batch_type&              reads,
+    nvbio::vector<system_tag,int16>&    best_scores)
+{
+    reset( reads, best_scores );
+
+    const uint64 n_hits = filter( reads );
+
+    // locate and verify the hits one batch at a time
+    for (uint64 hits_begin = 0; hits_begin < n_hits; hits_begin += params.hits_batch_size)
+    {
+        const uint64 hits_end = nvbio::min( hits_begin + params.hits_batch_size, n_hits );
+
+        locate( hits_begin, hits_end, m_hits );
+        verify( reads, m_hits, best_scores );
+    }
+}
+
+// process the next batch
+//
+template <typename mapper_type>
+bool FMMapFilterStage<mapper_type>::process(PipelineContext& context)
+{
+    if (m_loaded == false)
+    {
+        // load the next read batch
+        if (io::next( DNA_N, &m_h_reads, m_read_file, m_max_reads, m_max_bps ) == 0)
+            return false;
+
+        // copy the reads to the mapper's backend, in a new batch: the hit batches of the
+        // previous one might still be in flight
+        m_reads = typename return_type::read_batch_pointer( new io::SequenceDataStorage<system_tag>() );
+        *m_reads = m_h_reads;
+
+        m_n_hits     = m_mapper->filter( *m_reads );
+        m_hits_begin = 0;
+        m_loaded     = true;
+    }
+
+    // fetch the output
+    return_type* batch = context.output<return_type>();
+
+    // locate the next batch of hits
+    const uint64 hits_end = nvbio::min( m_hits_begin + m_mapper->params.hits_batch_size, m_n_hits );
+
+    batch->reads       = m_reads;
+    batch->read_offset = m_n_reads;
+    batch->first       = (m_hits_begin == 0);
+    batch->last        = (hits_end == m_n_hits);
+
+    m_mapper->locate( m_hits_begin, hits_end, batch->hits );
+
+    m_hits_begin = hits_end;
+
+    // move to the next read batch after the last of its hit batches
+    if (batch->last)
+    {
+        m_n_reads += m_reads->size() / 2;
+        m_loaded   = false;
+    }
+    return true;
+}
+
+// process the next batch
+//
+template <typename mapper_type>
+bool FMMapVerifyStage<mapper_type>::process(PipelineContext& context)
+{
+    // fetch the input
+    const argument_type* batch = context.input<argument_type>( 0 );
+
+    // fetch the output
+    FMMapResults* results = context.output<FMMapResults>();
+
+    if (batch->first)
+        m_mapper->reset( *batch->reads, m_best_scores );
+
+    m_mapper->verify( *batch->reads, batch->hits, m_best_scores );
+
+    results->read_offset = batch->read_offset;
+
+    // copy the results back to the host once all hits of the read batch have been verified
+    if (batch->last)
+        results->best_scores = m_best_scores;
+    else
+        results->best_scores.clear();
+
+    return true;
+}
+
+} // namespace nvbio
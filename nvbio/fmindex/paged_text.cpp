@@ -32,6 +32,7 @@
 #include <nvbio/basic/numbers.h>
 #include <nvbio/basic/primitives.h>
 #include <nvbio/basic/transform_iterator.h>
+#include <nvbio/basic/host_allocator.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -199,6 +200,20 @@ uint32 popc_2bit(const uint64* page, const uint32 n, const uint32 mod, const uin
 #endif
 }
 
+// allocate a large host memory segment, backed by huge pages where the OS supports them
+//
+void* alloc_segment(const uint64 size)
+{
+    return huge_page_alloc( size );
+}
+
+// free a segment allocated by alloc_segment()
+//
+void free_segment(void* segment)
+{
+    huge_page_free( segment );
+}
+
 void SparseSymbolSet::reserve(const uint64 n, const uint32 n_special)
 {
     m_pos.reserve( n_special );
@@ -233,6 +248,26 @@ void SparseSymbolSet::set(const uint64 range, const uint32 n_special, const uint
     set_range( range );
 }
 
+void SparseSymbolSet::set(const uint64 range, const uint32 n_special, const uint64* p, const uint64* id)
+{
+    m_pos.resize( n_special );
+    m_id.resize( n_special );
+
+    thrust::copy(
+        p,
+        p + n_special,
+        m_pos.begin() );
+
+    thrust::copy(
+        id,
+        id + n_special,
+        m_id.begin() );
+
+    m_n_special = n_special;
+
+    set_range( range );
+}
+
 void SparseSymbolSet::insert(
     const uint64    range,
     const uint32    n_block,
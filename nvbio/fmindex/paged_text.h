@@ -35,11 +35,15 @@
 #include <nvbio/basic/exceptions.h>
 #include <nvbio/basic/timer.h>
 #include <nvbio/basic/cast_iterator.h>
+#include <nvbio/basic/atomics.h>
+#include <nvbio/basic/omp.h>
 #include <thrust/adjacent_difference.h>
+#include <thrust/iterator/constant_iterator.h>
 #include <thrust/iterator/counting_iterator.h>
 #include <thrust/iterator/permutation_iterator.h>
 #include <thrust/iterator/transform_iterator.h>
 #include <stack>
+#include <new>
 #include <numeric>
 
 namespace nvbio {
@@ -48,6 +52,14 @@ namespace nvbio {
 ///
 void build_buckets(const uint64 key_range, const uint32 n_keys, const uint64* keys, const uint32 bucket_size, nvbio::vector<host_tag,uint32>& buckets, const bool upper = true);
 
+/// allocate a large host memory segment, backed by huge pages where the OS supports them
+///
+void* alloc_segment(const uint64 size);
+
+/// free a segment allocated by alloc_segment()
+///
+void free_segment(void* segment);
+
 ///
 /// This class represents a packed paged text and rank-dictionary supporting parallel bulk insertions.
 ///
@@ -72,6 +84,23 @@ struct PagedText
     static const uint32 LOG_BUCKET_SIZE = 20u;
     static const uint32     BUCKET_SIZE = 1u << LOG_BUCKET_SIZE;
 
+    static const uint32 PAGE_HEADER_WORDS = 2u;     ///< per-page header holding the page id, keeping pages 16-byte aligned
+    static const uint32 PAGE_CACHE_SIZE   = 7u;     ///< number of pages in each per-thread cache, filling a 64-byte line
+
+    /// a small cache of free pages owned by whichever thread manages to claim it,
+    /// allowing most page allocations and releases to avoid the shared free list;
+    /// each cache is aligned to its own 64-byte line, so that the threads spinning
+    /// on their caches don't falsely share them
+    ///
+    struct __align__(64) PageCache
+    {
+        PageCache() : busy( 0 ), size( 0 ) {}
+
+        uint32      busy;
+        uint32      size;
+        word_type*  pages[PAGE_CACHE_SIZE];
+    };
+
     /// constructor
     ///
     PagedText(
@@ -95,14 +124,34 @@ struct PagedText
     ///
     void grow();
 
-    /// alloc a new page
+    /// alloc a new page; safe to call concurrently from multiple threads
     ///
     word_type* alloc_page();
 
-    /// release a page
+    /// release a page; safe to call concurrently from multiple threads
     ///
     void release_page(word_type* page);
 
+    /// return the number of free pages (not thread-safe)
+    ///
+    uint32 free_page_count() const;
+
+    /// push a page onto the lock-free free list
+    ///
+    void push_free_page(word_type* page);
+
+    /// pop a page from the lock-free free list, returning NULL if empty
+    ///
+    word_type* pop_free_page();
+
+    /// try to claim a page cache, returning NULL if it's busy
+    ///
+    PageCache* acquire_cache(const uint32 i);
+
+    /// claim a page cache, waiting for it to be released if it's busy
+    ///
+    PageCache* lock_cache(const uint32 i);
+
     /// return the i-th page
     ///
     const word_type* get_page(const uint32 i) const { return m_pages[i]; }
@@ -159,6 +208,35 @@ struct PagedText
     ///
     void resize(const uint64 n, const uint8* c = NULL);
 
+    /// resize and copy the symbols of a given sequence, e.g. a packed stream
+    /// previously extracted from the pages of another text
+    ///
+    /// \param n       number of symbols
+    /// \param c       input symbol iterator
+    ///
+    template <typename symbol_iterator>
+    void assign(const uint64 n, const symbol_iterator c);
+
+    /// resize to n symbols without initializing them, so that the pages can be filled in place:
+    /// the i-th page will hold the symbols [i * page_symbols(), (i+1) * page_symbols()),
+    /// and update_counters() must be called once all of them have been written
+    ///
+    /// \param n       number of symbols
+    ///
+    void resize_pages(const uint64 n);
+
+    /// return the number of symbols held by each full page
+    ///
+    uint32 page_symbols() const { return m_page_size * SYMBOLS_PER_WORD; }
+
+    /// return the storage of the i-th page
+    ///
+    word_type* get_page_storage(const uint32 i) { return m_pages[i]; }
+
+    /// rebuild the occurrence tables and the symbol counters from the contents of the pages
+    ///
+    void update_counters();
+
     /// perform a batch of parallel insertions
     ///
     void insert(const uint32 n, const uint64* g, const uint8* c);
@@ -189,10 +267,18 @@ struct PagedText
     nvbio::vector<host_tag,uint64>      m_counters;
     nvbio::vector<host_tag,uint64>      m_new_counters;
     nvbio::vector<host_tag,uint32>      m_buckets;
-    std::vector<word_type*>             m_pool;
-    uint32                              m_pool_size;
-    omp_lock_t                          m_lock;
+    std::vector<word_type*>             m_page_table;       ///< page id -> page storage
+    std::vector<uint32>                 m_free_next;        ///< page id -> next page in the free list
+    uint64                              m_free_head;        ///< lock-free free list head, (ABA tag << 32) | page id
+    uint32                              m_pool_size;        ///< number of pages in the free list
+    std::vector<uint8>                  m_cache_storage;    ///< over-allocated storage for the page caches
+    PageCache*                          m_caches;           ///< per-thread page caches, aligned to 64 bytes within m_cache_storage
+    uint32                              m_n_caches;         ///< number of page caches
     uint32                              m_count_table[256];
+
+private:
+    PagedText(const PagedText&);
+    PagedText& operator=(const PagedText&);
 };
 
 ///
@@ -227,6 +313,16 @@ struct SparseSymbolSet
     ///
     void set(const uint64 range, const uint32 n_special, const uint32* p, const uint32* id);
 
+    /// set the initial set of symbols from a list of absolute 64-bit positions,
+    /// e.g. as loaded back from a previously serialized set
+    ///
+    /// \param range        total number of symbols in the virtual string
+    /// \param n_special    number of special symbols
+    /// \param p            the sorted positions of the special symbols
+    /// \param id           the ids associated to the special symbols
+    ///
+    void set(const uint64 range, const uint32 n_special, const uint64* p, const uint64* id);
+
     /// simulates the insertion of a set of n_block symbols at positions g in a string,
     /// n_special of which are special and will be recorded in this set.
     /// Note that the actual symbols in the block don't need to be known, but in order to adjust the
@@ -276,9 +276,16 @@ PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::PagedText(
     m_occ_intv_w( occ_intv / SYMBOLS_PER_WORD ),
     m_occ_intv_log( nvbio::log2( occ_intv ) ),
     m_page_count( 0 ),
-    m_pool_size( 0 )
+    m_free_head( uint32(-1) ),
+    m_pool_size( 0 ),
+    m_n_caches( omp_get_max_threads() )
 {
-    omp_init_lock( &m_lock );
+    // std::vector doesn't honor the alignment of the caches: over-allocate their storage
+    // and align them by hand
+    m_cache_storage.resize( (m_n_caches + 1u) * sizeof(PageCache) );
+    m_caches = reinterpret_cast<PageCache*>( util::round_i( size_t( &m_cache_storage[0] ), sizeof(PageCache) ) );
+    for (uint32 i = 0; i < m_n_caches; ++i)
+        new (m_caches + i) PageCache();
 
     gen_2bit_count_table( m_count_table );
 }
@@ -289,7 +296,7 @@ template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
 PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::~PagedText()
 {
     for (uint32 i = 0; i < m_segments.size(); ++i)
-        free( m_segments[i] );
+        free_segment( m_segments[i] );
 }
 
 // alloc new pages
@@ -301,10 +308,10 @@ void PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::grow()
                             (m_occ_intv / SYMBOLS_PER_WORD) / SYMBOL_COUNT;
 
     const uint32 n_pages          = m_segment_size / m_page_size;
-    const uint32 ext_page_size    = m_page_size + m_page_size / occ_freq;
-    const uint32 ext_segment_size = n_pages * ext_page_size;
+    const uint32 ext_page_size    = PAGE_HEADER_WORDS + m_page_size + m_page_size / occ_freq;
+    const uint64 ext_segment_size = uint64( n_pages ) * ext_page_size;
 
-    word_type* segment = (word_type*)malloc( ext_segment_size * sizeof(word_type) );
+    word_type* segment = (word_type*)alloc_segment( ext_segment_size * sizeof(word_type) );
 
     if (segment == NULL)
     {
@@ -314,40 +321,148 @@ void PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::grow()
     }
     else
     {
-        // the free page pool has to be able to accomodate all the allocated pages
-        if (m_pool.size() < m_page_count + n_pages)
-            m_pool.resize( m_page_count + n_pages );
-
         m_segments.push_back( segment );
 
+        // assign the new pages their ids, stored in their headers
+        m_page_table.resize( m_page_count + n_pages );
+        m_free_next.resize( m_page_count + n_pages );
+
+        for (uint32 i = 0; i < n_pages; ++i)
+        {
+            word_type* page = segment + uint64( ext_page_size ) * i + PAGE_HEADER_WORDS;
+            page[-int32(PAGE_HEADER_WORDS)] = m_page_count + i;
+
+            m_page_table[ m_page_count + i ] = page;
+        }
+
+        // push them on the free list in reverse order, so as to hand them out sequentially
         for (uint32 i = 0; i < n_pages; ++i)
-            m_pool[ m_pool_size++ ] = segment + ext_page_size * (n_pages - i - 1u);
+            push_free_page( m_page_table[ m_page_count + n_pages - i - 1u ] );
 
         m_page_count += n_pages;
     }
 }
 
+// push a page onto the lock-free free list
+//
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
+void PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::push_free_page(word_type* page)
+{
+    const uint32 id = uint32( page[-int32(PAGE_HEADER_WORDS)] );
+
+    while (1)
+    {
+        const uint64 head = *(volatile uint64*)&m_free_head;
+
+        // link the page to the current head
+        m_free_next[id] = uint32( head );
+
+        // and bump the ABA tag when replacing it
+        const uint64 new_head = (((head >> 32) + 1u) << 32) | id;
+
+        if (host_atomic_cas( &m_free_head, head, new_head ) == head)
+            break;
+    }
+    host_atomic_add( &m_pool_size, 1u );
+}
+
+// pop a page from the lock-free free list
+//
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
+typename PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::word_type*
+PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::pop_free_page()
+{
+    while (1)
+    {
+        const uint64 head = *(volatile uint64*)&m_free_head;
+        host_acquire_fence();
+
+        const uint32 id = uint32( head );
+        if (id == uint32(-1))
+            return NULL;
+
+        // the link might be stale if the page has been concurrently popped,
+        // in which case the tag will have changed and the CAS will fail
+        const uint32 next     = *(volatile uint32*)&m_free_next[id];
+        const uint64 new_head = (((head >> 32) + 1u) << 32) | next;
+
+        if (host_atomic_cas( &m_free_head, head, new_head ) == head)
+        {
+            host_atomic_sub( &m_pool_size, 1u );
+            return m_page_table[id];
+        }
+    }
+}
+
+// try to claim a page cache
+//
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
+typename PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::PageCache*
+PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::acquire_cache(const uint32 i)
+{
+    // note that with nested parallelism several threads might map to the same cache,
+    // in which case all but one will simply fall back to the free list
+    PageCache* cache = &m_caches[ i % m_n_caches ];
+    return host_atomic_cas( &cache->busy, 0u, 1u ) == 0u ? cache : NULL;
+}
+
+// claim a page cache, spinning while it's busy
+//
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
+typename PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::PageCache*
+PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::lock_cache(const uint32 i)
+{
+    // the owners only hold their caches for a handful of instructions, and never
+    // wait on anything while holding them, so spinning here can't deadlock
+    PageCache* cache = &m_caches[ i % m_n_caches ];
+    while (host_atomic_cas( &cache->busy, 0u, 1u ) != 0u) {}
+    return cache;
+}
+
 // alloc a new page
 //
 template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
 typename PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::word_type*
 PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::alloc_page()
 {
-    omp_set_lock( &m_lock );
+    word_type* page = NULL;
 
-    if (m_pool_size == 0)
+    // try the local cache first
+    if (PageCache* cache = acquire_cache( omp_get_thread_num() ))
     {
-        omp_unset_lock( &m_lock );
+        if (cache->size)
+            page = cache->pages[ --cache->size ];
+
+        host_atomic_cas( &cache->busy, 1u, 0u );
+    }
+    if (page)
+        return page;
+
+    // then the global free list
+    if ((page = pop_free_page()) != NULL)
+        return page;
+
+    // and finally try to steal from the other caches: a busy cache can't simply be
+    // skipped, as the pages it holds might be the only free ones left
+    for (uint32 i = 0; i < m_n_caches && page == NULL; ++i)
+    {
+        PageCache* cache = lock_cache( i );
+
+        if (cache->size)
+            page = cache->pages[ --cache->size ];
 
+        host_atomic_cas( &cache->busy, 1u, 0u );
+
+        // a release overflowing an already visited cache goes to the free list
+        if (page == NULL)
+            page = pop_free_page();
+    }
+    if (page == NULL)
+    {
         log_error(stderr, "PagedText: exhausted page pool\n");
         //throw bad_alloc( "PagedText: exhausted page pool\n" );
         exit(1);
     }
-
-    word_type* page = m_pool[ --m_pool_size ];
-    assert( page != NULL );
-
-    omp_unset_lock( &m_lock );
     return page;
 }
 
@@ -357,17 +472,40 @@ template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
 void PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::release_page(word_type* page)
 {
     assert( page != NULL );
-    omp_set_lock( &m_lock );
 
-    if (m_pool_size >= m_page_count)
+    if (uint32( page[-int32(PAGE_HEADER_WORDS)] ) >= m_page_count)
     {
-        log_error(stderr, "exceeded pool size %u - released more pages than have been allocated\n", m_page_count);
+        log_error(stderr, "released an invalid page - not allocated by this pool\n");
         exit(1);
     }
 
-    m_pool[ m_pool_size++ ] = page;
+    // try to keep the page in the local cache
+    if (PageCache* cache = acquire_cache( omp_get_thread_num() ))
+    {
+        const bool cached = cache->size < PAGE_CACHE_SIZE;
+        if (cached)
+            cache->pages[ cache->size++ ] = page;
+
+        host_atomic_cas( &cache->busy, 1u, 0u );
 
-    omp_unset_lock( &m_lock );
+        if (cached)
+            return;
+    }
+
+    // and otherwise return it to the free list
+    push_free_page( page );
+}
+
+// return the number of free pages
+//
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
+uint32 PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::free_page_count() const
+{
+    uint32 n = m_pool_size;
+    for (uint32 i = 0; i < m_n_caches; ++i)
+        n += m_caches[i].size;
+
+    return n;
 }
 
 // indexing operator - return the i-th symbol
@@ -445,7 +583,6 @@ template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
 void PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::reserve_pages(const uint32 n_pages)
 {
     // alloc the pages we need
-    m_pool.reserve( n_pages );
     while (m_page_count < n_pages)
         grow();
 
@@ -463,8 +600,7 @@ template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
 void PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::reserve_free_pages(const uint32 n_pages)
 {
     // alloc the pages we need
-    m_pool.reserve( n_pages );
-    while (m_pool_size < n_pages)
+    while (free_page_count() < n_pages)
         grow();
 }
 
@@ -484,7 +620,7 @@ uint64 PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::needed_host_memory(const uint64 n)
     const uint32 occ_freq = (sizeof(word_type) / sizeof(uint32)) *
                             (m_occ_intv / SYMBOLS_PER_WORD) / SYMBOL_COUNT;
 
-    const uint32 ext_page_size = m_page_size + m_page_size / occ_freq;
+    const uint32 ext_page_size = PAGE_HEADER_WORDS + m_page_size + m_page_size / occ_freq;
 
     const uint64 n_pages = util::divide_ri( n, (m_page_size * SYMBOLS_PER_WORD * 2)/3 );
     return n_pages * ext_page_size * sizeof(word_type);
@@ -495,7 +631,45 @@ uint64 PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::needed_host_memory(const uint64 n)
 template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
 void PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::resize(const uint64 n, const uint8* c)
 {
-    const uint32 PAGE_SYMBOLS = m_page_size * SYMBOLS_PER_WORD;
+    if (c != NULL)
+        assign( n, c );
+    else
+        assign( n, thrust::make_constant_iterator<uint8>(0) );
+}
+
+// resize and copy the symbols of a given sequence
+//
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
+template <typename symbol_iterator>
+void PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::assign(const uint64 n, const symbol_iterator c)
+{
+    const uint32 PAGE_SYMBOLS = page_symbols();
+
+    resize_pages( n );
+
+    const uint32 n_pages = page_count();
+
+    #pragma omp parallel for
+    for (int32 i = 0; i < int32(n_pages); ++i)
+    {
+        const uint64 begin = uint64(i) * PAGE_SYMBOLS;
+        const uint64 end   = nvbio::min( n, begin + PAGE_SYMBOLS );
+
+        packed_page_type page( m_pages[i] );
+
+        // fill the page contents
+        nvbio::assign( uint32( end - begin ), c + begin, page );
+    }
+
+    update_counters();
+}
+
+// resize without initializing the symbols
+//
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
+void PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::resize_pages(const uint64 n)
+{
+    const uint32 PAGE_SYMBOLS = page_symbols();
 
     // alloc the given number of pages
     const uint32 n_pages = util::divide_ri( n, PAGE_SYMBOLS );
@@ -515,44 +689,46 @@ void PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::resize(const uint64 n, const uint8*
         m_offsets[i] = uint64(i) * PAGE_SYMBOLS;
 
     m_offsets[ n_pages ] = n;
+}
+
+// rebuild the occurrence tables and the symbol counters from the contents of the pages
+//
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
+void PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::update_counters()
+{
+    const uint32 n_pages = page_count();
+    const uint64 n       = size();
 
     // setup the symbol counters
-    m_counters.resize( (n_pages+1) * SYMBOL_COUNT, uint64(0) );
+    m_counters.resize( (n_pages+1) * SYMBOL_COUNT );
+    for (uint32 i = 0; i < (n_pages+1) * SYMBOL_COUNT; ++i)
+        m_counters[i] = 0u;
 
-    if (c != NULL)
+    #pragma omp parallel for
+    for (int32 i = 0; i < int32(n_pages); ++i)
     {
-        #pragma omp parallel for
-        for (int32 i = 0; i < int32(n_pages); ++i)
-        {
-            const uint64 begin = uint64(i) * PAGE_SYMBOLS;
-            const uint64 end   = nvbio::min( n, begin + PAGE_SYMBOLS );
+        word_type* page_storage = m_pages[i];
 
-            // get a new page
-            word_type* page_storage = m_pages[i];
+        const const_packed_page_type page( page_storage );
 
-            packed_page_type page( page_storage );
+        // update the occurrence counters
+        uint64* cnts = &m_counters[ i * SYMBOL_COUNT ];
+        uint32* occ  = (uint32*)( page_storage + m_page_size );
 
-            // fill the page contents
-            nvbio::assign( uint32( end - begin ), c + begin, page );
-
-            // update the occurrence counters
-            uint64* cnts = &m_counters[ i * SYMBOL_COUNT ];
-            uint32* occ  = (uint32*)( page_storage + m_page_size );
-
-            for (uint32 j = 0; j < uint32( end - begin ); ++j)
+        const uint32 page_size = get_page_size(i);
+        for (uint32 j = 0; j < page_size; ++j)
+        {
+            // check whether we need to the save the occurrence counters
+            if ((j & (m_occ_intv-1)) == 0)
             {
-                // check whether we need to the save the occurrence counters
-                if ((j & (m_occ_intv-1)) == 0)
-                {
-                    for (uint32 q = 0; q < SYMBOL_COUNT; ++q)
-                        occ[q] = cnts[q];
-
-                    occ += SYMBOL_COUNT;
-                }
+                for (uint32 q = 0; q < SYMBOL_COUNT; ++q)
+                    occ[q] = cnts[q];
 
-                const uint8 cc = c[ begin + j ] & (SYMBOL_COUNT-1);
-                ++cnts[ cc ];
+                occ += SYMBOL_COUNT;
             }
+
+            const uint8 cc = page[j] & (SYMBOL_COUNT-1);
+            ++cnts[ cc ];
         }
     }
 
@@ -1200,7 +1376,8 @@ inline void PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::defrag()
         // release input pages that will no longer be needed
         const uint32 in_leaf_end = upper_bound_index( uint64( batch_end ) * LEAF_SYMBOLS, raw_pointer( m_offsets ), in_leaves+1 ) - 1u;
 
-        for (uint32 i = in_leaf_begin; i < in_leaf_end; ++i)
+        #pragma omp parallel for
+        for (int32 i = int32( in_leaf_begin ); i < int32( in_leaf_end ); ++i)
         {
             release_page( m_pages[i] );
             m_pages[i] = NULL;
@@ -1210,7 +1387,8 @@ inline void PagedText<SYMBOL_SIZE_T,BIG_ENDIAN_T>::defrag()
     }
 
     // release any not yet released input pages
-    for (uint32 i = in_leaf_begin; i < in_leaves; ++i)
+    #pragma omp parallel for
+    for (int32 i = int32( in_leaf_begin ); i < int32( in_leaves ); ++i)
     {
         release_page( m_pages[i] );
         m_pages[i] = NULL;
@@ -0,0 +1,239 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/basic/atomics.h>
+#include <nvbio/basic/vector.h>
+#include <vector_types.h>
+
+namespace nvbio {
+
+///@addtogroup FMIndex
+///@{
+
+///\defgroup SeedCacheModule Seed Interval Caches
+///
+/// A <i>seed interval cache</i> is a fixed-size, concurrent hash table memoizing the
+/// suffix array ranges of frequently occurring seeds, so that the backward search of
+/// a highly repetitive seed (e.g. one falling in an Alu or a centromeric satellite)
+/// is performed only once per batch of reads instead of once per occurrence.
+///\par
+/// The table stores, for each seed packed into a 64-bit key (see pack_seed()), the range
+/// of its forward string in the forward FM-index and that of its reverse-complement
+/// in the reverse FM-index.
+/// Insertions are lock-free and may fail if the probe sequence is full: the cache is
+/// a best-effort accelerator, and a miss only means the caller has to perform the search.
+///\par
+/// The SeedIntervalCache container owns the storage, while the storage-free
+/// SeedIntervalCacheView can be obtained with the usual plain_view() function and be
+/// passed to CUDA kernels.
+///\par
+/// Lookup and insertion statistics are opt-in: when enabled, every lookup performs a
+/// global atomic on a shared counter, which serializes heavily concurrent lookups.
+///
+
+///@{
+
+/// pack a seed of up to 31 2-bit symbols into a 64-bit key, prepending a sentinel bit
+/// to disambiguate seeds of different length
+///
+/// \param string       the seed string
+/// \param len          the seed length
+/// \param key          the output key
+/// \return             false if the seed can't be packed (too long or containing Ns)
+///
+template <typename string_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+bool pack_seed(const string_type& string, const uint32 len, uint64* key);
+
+///
+/// A storage-free view of a seed interval cache
+///
+template <typename coord_type = uint32>
+struct SeedIntervalCacheView
+{
+    typedef typename vector_type<coord_type,2>::type range_type;
+
+    static const uint64 EMPTY      = uint64(-1);
+    static const uint64 LOCKED     = uint64(-2);
+    static const uint32 MAX_PROBES = 8u;
+
+    /// counter slots
+    ///
+    enum Counters {
+        LOOKUPS  = 0,
+        HITS     = 1,
+        INSERTS  = 2,
+        FAILED   = 3,
+        N_COUNTERS = 4,
+    };
+
+    /// empty constructor: an empty cache always misses
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    SeedIntervalCacheView() : m_size(0), m_min_occ(0), m_keys(NULL), m_ranges(NULL), m_counters(NULL) {}
+
+    /// constructor
+    ///
+    /// \param size         the number of slots, a power of 2
+    /// \param min_occ      the minimum number of occurrences a seed must have to be cached
+    /// \param keys         the slot keys
+    /// \param ranges       the slot ranges, 4 coordinates per slot
+    /// \param counters     the statistics counters, or NULL to skip the statistics
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    SeedIntervalCacheView(
+        const uint32 size,
+        const uint32 min_occ,
+        uint64*      keys,
+        coord_type*  ranges,
+        uint64*      counters) :
+        m_size( size ), m_min_occ( min_occ ), m_keys( keys ), m_ranges( ranges ), m_counters( counters ) {}
+
+    /// return true if the cache has any storage
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    bool enabled() const { return m_size != 0; }
+
+    /// return the number of slots
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint32 size() const { return m_size; }
+
+    /// return true if a seed with the given ranges is worth caching
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    bool cacheable(const range_type f, const range_type r) const
+    {
+        return (f.y + 1u >= f.x + m_min_occ) ||
+               (r.y + 1u >= r.x + m_min_occ);
+    }
+
+    /// look up a seed, returning true on a hit
+    ///
+    /// \param key          the packed seed
+    /// \param f            the output forward range
+    /// \param r            the output reverse-complement range
+    ///
+    NVBIO_HOST_DEVICE
+    bool find(const uint64 key, range_type* f, range_type* r) const;
+
+    /// insert a seed, returning true if the seed is now present in the cache
+    ///
+    /// \param key          the packed seed
+    /// \param f            the forward range
+    /// \param r            the reverse-complement range
+    ///
+    NVBIO_HOST_DEVICE
+    bool insert(const uint64 key, const range_type f, const range_type r) const;
+
+    uint32      m_size;
+    uint32      m_min_occ;
+    uint64*     m_keys;
+    coord_type* m_ranges;
+    uint64*     m_counters;
+};
+
+///
+/// A seed interval cache container, holding the storage for a SeedIntervalCacheView
+/// in the memory space specified by system_tag
+///
+template <typename system_tag, typename coord_type = uint32>
+struct SeedIntervalCache
+{
+    typedef SeedIntervalCacheView<coord_type>       view_type;
+    typedef view_type                               plain_view_type;
+
+    /// constructor
+    ///
+    SeedIntervalCache() : m_min_occ(0) {}
+
+    /// allocate up to the given number of slots, rounded down to a power of 2, and clear the cache;
+    /// a size of zero disables the cache
+    ///
+    /// \param size         the number of slots
+    /// \param min_occ      the minimum number of occurrences a seed must have to be cached
+    /// \param stats        whether to keep lookup statistics
+    ///
+    void resize(const uint32 size, const uint32 min_occ, const bool stats = false);
+
+    /// drop all cached seeds and reset the statistics
+    ///
+    void clear();
+
+    /// return the number of slots
+    ///
+    uint32 size() const { return uint32( m_keys.size() ); }
+
+    /// return the amount of allocated memory, in bytes
+    ///
+    uint64 allocated_bytes() const { return m_keys.size() * (sizeof(uint64) + 4u*sizeof(coord_type)); }
+
+    /// return true if the cache keeps lookup statistics
+    ///
+    bool has_stats() const { return m_counters.size() != 0; }
+
+    /// read back a statistics counter
+    ///
+    uint64 counter(const uint32 i) const;
+
+    /// return the number of lookups
+    ///
+    uint64 lookups() const { return counter( view_type::LOOKUPS ); }
+
+    /// return the number of hits
+    ///
+    uint64 hits() const { return counter( view_type::HITS ); }
+
+    /// return the hit rate
+    ///
+    float hit_rate() const { const uint64 n = lookups(); return n ? float(hits()) / float(n) : 0.0f; }
+
+    /// return a plain view
+    ///
+    view_type view();
+
+    uint32                                  m_min_occ;
+    nvbio::vector<system_tag,uint64>        m_keys;
+    nvbio::vector<system_tag,coord_type>    m_ranges;
+    nvbio::vector<system_tag,uint64>        m_counters;
+};
+
+/// return a plain view of a seed interval cache
+///
+template <typename system_tag, typename coord_type>
+SeedIntervalCacheView<coord_type> plain_view(SeedIntervalCache<system_tag,coord_type>& cache) { return cache.view(); }
+
+///@} SeedCacheModule
+///@} FMIndex
+
+} // namespace nvbio
+
+#include <nvbio/fmindex/seed_cache_inl.h>
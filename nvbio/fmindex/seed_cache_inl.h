@@ -0,0 +1,221 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <thrust/fill.h>
+
+namespace nvbio {
+
+namespace seedcache {
+
+// memory fences ordering the publication of a slot's ranges with respect to its key
+//
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void release_fence()
+{
+  #if defined(NVBIO_DEVICE_COMPILATION)
+    __threadfence();
+  #else
+    host_release_fence();
+  #endif
+}
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void acquire_fence()
+{
+  #if defined(NVBIO_DEVICE_COMPILATION)
+    __threadfence();
+  #else
+    host_acquire_fence();
+  #endif
+}
+
+} // namespace seedcache
+
+// pack a seed of up to 31 2-bit symbols into a 64-bit key
+//
+template <typename string_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+bool pack_seed(const string_type& string, const uint32 len, uint64* key)
+{
+    if (len > 31u)
+        return false;
+
+    uint64 k = 1u; // sentinel bit
+    for (uint32 i = 0; i < len; ++i)
+    {
+        const uint8 c = string[i];
+        if (c > 3u)
+            return false;
+
+        k = (k << 2) | c;
+    }
+    *key = k;
+    return true;
+}
+
+// look up a seed
+//
+template <typename coord_type>
+NVBIO_HOST_DEVICE
+bool SeedIntervalCacheView<coord_type>::find(const uint64 key, range_type* f, range_type* r) const
+{
+    if (m_size == 0)
+        return false;
+
+    if (m_counters)
+        atomic_add( m_counters + LOOKUPS, uint64(1u) );
+
+    const uint32 mask = m_size - 1u;
+    uint32 slot = uint32( hash( key ) ) & mask;
+
+    for (uint32 probe = 0; probe < MAX_PROBES; ++probe, slot = (slot + 1u) & mask)
+    {
+        const uint64 slot_key = *(volatile uint64*)(m_keys + slot);
+        if (slot_key == EMPTY)
+            return false;   // seeds are never removed, so the probe sequence ends here
+
+        if (slot_key == key)
+        {
+            seedcache::acquire_fence();
+
+            const volatile coord_type* ranges = m_ranges + slot*4u;
+            f->x = ranges[0];
+            f->y = ranges[1];
+            r->x = ranges[2];
+            r->y = ranges[3];
+
+            if (m_counters)
+                atomic_add( m_counters + HITS, uint64(1u) );
+            return true;
+        }
+        // a LOCKED slot is being filled by another thread: skip it
+    }
+    return false;
+}
+
+// insert a seed
+//
+template <typename coord_type>
+NVBIO_HOST_DEVICE
+bool SeedIntervalCacheView<coord_type>::insert(const uint64 key, const range_type f, const range_type r) const
+{
+    if (m_size == 0 || cacheable( f, r ) == false)
+        return false;
+
+    const uint32 mask = m_size - 1u;
+    uint32 slot = uint32( hash( key ) ) & mask;
+
+    for (uint32 probe = 0; probe < MAX_PROBES; ++probe, slot = (slot + 1u) & mask)
+    {
+        const uint64 slot_key = *(volatile uint64*)(m_keys + slot);
+        if (slot_key == key)
+            return true;    // already there
+
+        // a LOCKED slot might be getting filled with this very seed: rather than
+        // risking a duplicate entry, give up - caching is best-effort
+        if (slot_key == LOCKED)
+            return false;
+
+        if (slot_key != EMPTY)
+            continue;
+
+        // try to claim the slot
+        const uint64 old = atomic_cas( m_keys + slot, EMPTY, LOCKED );
+        if (old == EMPTY)
+        {
+            volatile coord_type* ranges = m_ranges + slot*4u;
+            ranges[0] = f.x;
+            ranges[1] = f.y;
+            ranges[2] = r.x;
+            ranges[3] = r.y;
+
+            // make sure the ranges are visible before the key is published
+            seedcache::release_fence();
+            *(volatile uint64*)(m_keys + slot) = key;
+
+            if (m_counters)
+                atomic_add( m_counters + INSERTS, uint64(1u) );
+            return true;
+        }
+        else if (old == key)
+            return true;
+        else if (old == LOCKED)
+            return false;
+    }
+    if (m_counters)
+        atomic_add( m_counters + FAILED, uint64(1u) );
+    return false;
+}
+
+// allocate the given number of slots
+//
+template <typename system_tag, typename coord_type>
+void SeedIntervalCache<system_tag,coord_type>::resize(const uint32 size, const uint32 min_occ, const bool stats)
+{
+    uint32 n = size ? 1u : 0u;
+    while (n && n*2u <= size)
+        n *= 2u;
+
+    m_min_occ = min_occ;
+    m_keys.resize( n );
+    m_ranges.resize( n * 4u );
+    m_counters.resize( stats ? view_type::N_COUNTERS : 0u );
+    clear();
+}
+
+// drop all cached seeds and reset the statistics
+//
+template <typename system_tag, typename coord_type>
+void SeedIntervalCache<system_tag,coord_type>::clear()
+{
+    thrust::fill( m_keys.begin(),     m_keys.end(),     uint64( view_type::EMPTY ) );
+    thrust::fill( m_counters.begin(), m_counters.end(), uint64(0u) );
+}
+
+// read back a statistics counter
+//
+template <typename system_tag, typename coord_type>
+uint64 SeedIntervalCache<system_tag,coord_type>::counter(const uint32 i) const
+{
+    return m_counters.size() ? uint64( m_counters[i] ) : 0u;
+}
+
+// return a plain view
+//
+template <typename system_tag, typename coord_type>
+SeedIntervalCacheView<coord_type> SeedIntervalCache<system_tag,coord_type>::view()
+{
+    return view_type(
+        size(),
+        m_min_occ,
+        nvbio::raw_pointer( m_keys ),
+        nvbio::raw_pointer( m_ranges ),
+        nvbio::raw_pointer( m_counters ) );
+}
+
+} // namespace nvbio
@@ -0,0 +1,161 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/basic/popcount.h>
+#include <nvbio/basic/packedstream.h>
+#include <nvbio/basic/static_vector.h>
+#include <nvbio/basic/algorithms.h>
+
+namespace nvbio {
+
+///@addtogroup FMIndex
+///@{
+
+///@addtogroup RankDictionaryModule
+///@{
+
+///
+/// A storage-free rank dictionary over a 2-bit packed string-set BWT, as written by
+/// open_fmindex_file(): the BWT is stored as big-endian uint32 words, the occurrence
+/// table is sampled at a run-time power-of-2 interval, and the dollars separating
+/// the strings are stored in the BWT as regular symbols, listed by their sorted positions.
+///\par
+/// The dollars are excluded from all counts, so that, paired with an L2 array sorting all
+/// dollars before any other symbol, the dictionary can back a regular fm_index (see
+/// load_fmindex_file()).
+///
+struct SetBWTRankDictionary
+{
+    static const uint32     SYMBOL_SIZE      = 2u;
+    static const uint32     SYMBOL_COUNT     = 4u;
+    static const uint32     SYMBOLS_PER_WORD = 16u;
+
+    typedef PackedStream<const uint32*,uint8,2,true,uint64> text_type;
+
+    typedef uint64                                  index_type;
+    typedef uint64_2                                range_type;
+    typedef uint64_2                                vec2_type;
+    typedef uint64_4                                vec4_type;
+    typedef StaticVector<index_type,SYMBOL_COUNT>   vector_type;
+
+    /// default constructor
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    SetBWTRankDictionary() {}
+
+    /// constructor
+    ///
+    /// \param _words           the packed BWT words
+    /// \param _occ_intv_log    the logarithm of the occurrence table sampling interval
+    /// \param _occ             the occurrence table, holding the counts of the range [0,k*occ_intv) at k*4
+    /// \param _n_dollars       the number of dollars
+    /// \param _dollars         the sorted dollar positions
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    SetBWTRankDictionary(
+        const uint32*   _words,
+        const uint32    _occ_intv_log,
+        const uint64*   _occ,
+        const uint64    _n_dollars,
+        const uint64*   _dollars) :
+        m_words( _words ),
+        m_occ_intv_log( _occ_intv_log ),
+        m_occ( _occ ),
+        m_n_dollars( _n_dollars ),
+        m_dollars( _dollars ) {}
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE uint32 symbol_count() const { return SYMBOL_COUNT; }
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE uint32 symbol_size()  const { return SYMBOL_SIZE; }
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE text_type text() const { return text_type( m_words ); }
+
+    /// return the i-th BWT symbol, as stored (i.e. including the ones at the dollar positions)
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint8 symbol(const uint64 i) const
+    {
+        return uint8( (m_words[ i / SYMBOLS_PER_WORD ] >> ((SYMBOLS_PER_WORD-1u - (i % SYMBOLS_PER_WORD))*2u)) & 3u );
+    }
+
+    const uint32*   m_words;            ///< the packed BWT
+    uint32          m_occ_intv_log;     ///< the logarithm of the occurrence table sampling interval
+    const uint64*   m_occ;              ///< the sampled occurrence table
+    uint64          m_n_dollars;        ///< the number of dollars
+    const uint64*   m_dollars;          ///< the sorted dollar positions
+};
+
+/// \relates SetBWTRankDictionary
+/// fetch the number of occurrences of character c in the substring [0,i], dollars excluded
+///
+/// \param dict         the rank dictionary
+/// \param i            the end of the query range [0,i]
+/// \param c            the query character
+///
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 rank(const SetBWTRankDictionary& dict, const uint64 i, const uint32 c);
+
+/// \relates SetBWTRankDictionary
+/// fetch the number of occurrences of character c in the substrings [0,l] and [0,r], dollars excluded
+///
+/// \param dict         the rank dictionary
+/// \param range        the ends of the query ranges [0,range.x] and [0,range.y]
+/// \param c            the query character
+///
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64_2 rank(const SetBWTRankDictionary& dict, const uint64_2 range, const uint32 c);
+
+/// \relates SetBWTRankDictionary
+/// fetch the number of occurrences of all characters in the substring [0,i], dollars excluded
+///
+/// \param dict         the rank dictionary
+/// \param i            the end of the query range [0,i]
+/// \param out          the output counts
+///
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void rank_all(const SetBWTRankDictionary& dict, const uint64 i, SetBWTRankDictionary::vector_type* out);
+
+/// \relates SetBWTRankDictionary
+/// fetch the number of occurrences of all characters in the substrings [0,l] and [0,r], dollars excluded
+///
+/// \param dict         the rank dictionary
+/// \param range        the ends of the query ranges [0,range.x] and [0,range.y]
+/// \param outl         the output counts of the first range
+/// \param outh         the output counts of the second range
+///
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void rank_all(const SetBWTRankDictionary& dict, const uint64_2 range, SetBWTRankDictionary::vector_type* outl, SetBWTRankDictionary::vector_type* outh);
+
+///@} RankDictionaryModule
+///@} FMIndex
+
+} // namespace nvbio
+
+#include <nvbio/fmindex/set_rank_dictionary_inl.h>
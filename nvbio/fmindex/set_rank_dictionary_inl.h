@@ -0,0 +1,111 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+namespace nvbio {
+
+namespace setbwt {
+
+// count the occurrences of c in the first n symbols of a big-endian 2-bit packed word
+//
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint32 popc_prefix(const uint32 word, const uint32 c, const uint32 n)
+{
+    return n ? popc_2bit( word, c, SetBWTRankDictionary::SYMBOLS_PER_WORD - n ) : 0u;
+}
+
+} // namespace setbwt
+
+// fetch the number of occurrences of character c in the substring [0,i], dollars excluded
+//
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 rank(const SetBWTRankDictionary& dict, const uint64 i, const uint32 c)
+{
+    const uint32 SYMBOLS_PER_WORD = SetBWTRankDictionary::SYMBOLS_PER_WORD;
+
+    if (i == uint64(-1))
+        return 0u;
+
+    // start from the sample preceding i
+    const uint64 block = i >> dict.m_occ_intv_log;
+    const uint64 first = block << dict.m_occ_intv_log;
+
+    uint64 r = dict.m_occ[ block * SetBWTRankDictionary::SYMBOL_COUNT + c ];
+
+    // count the occurrences in [first,i], word by word
+    const uint64 first_word = first / SYMBOLS_PER_WORD;
+    const uint64 last_word  = i     / SYMBOLS_PER_WORD;
+    for (uint64 w = first_word; w <= last_word; ++w)
+    {
+        const uint32 word = dict.m_words[w];
+        const uint32 lo   = w == first_word ? uint32( first % SYMBOLS_PER_WORD )  : 0u;
+        const uint32 hi   = w == last_word  ? uint32( i % SYMBOLS_PER_WORD ) + 1u : SYMBOLS_PER_WORD;
+
+        r += setbwt::popc_prefix( word, c, hi ) - setbwt::popc_prefix( word, c, lo );
+    }
+
+    // and discount the dollars falling in the same range which are stored as c
+    const uint64* dollars = lower_bound( first, dict.m_dollars, dict.m_n_dollars );
+    const uint64* dollars_end = dict.m_dollars + dict.m_n_dollars;
+    for (; dollars != dollars_end && *dollars <= i; ++dollars)
+    {
+        if (dict.symbol( *dollars ) == c)
+            --r;
+    }
+    return r;
+}
+
+// fetch the number of occurrences of character c in the substrings [0,l] and [0,r], dollars excluded
+//
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64_2 rank(const SetBWTRankDictionary& dict, const uint64_2 range, const uint32 c)
+{
+    return make_vector(
+        rank( dict, range.x, c ),
+        rank( dict, range.y, c ) );
+}
+
+// fetch the number of occurrences of all characters in the substring [0,i], dollars excluded
+//
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void rank_all(const SetBWTRankDictionary& dict, const uint64 i, SetBWTRankDictionary::vector_type* out)
+{
+    for (uint32 c = 0; c < SetBWTRankDictionary::SYMBOL_COUNT; ++c)
+        (*out)[c] = rank( dict, i, c );
+}
+
+// fetch the number of occurrences of all characters in the substrings [0,l] and [0,r], dollars excluded
+//
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void rank_all(const SetBWTRankDictionary& dict, const uint64_2 range, SetBWTRankDictionary::vector_type* outl, SetBWTRankDictionary::vector_type* outh)
+{
+    rank_all( dict, range.x, outl );
+    rank_all( dict, range.y, outh );
+}
+
+} // namespace nvbio
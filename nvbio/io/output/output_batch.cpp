@@ -37,7 +37,8 @@ namespace io {
 
 void HostOutputBatchSE::readback(const DeviceOutputBatchSE batch)
 {
-    count = batch.count;
+    // fan the alignments of the representatives out to all their duplicates
+    count = dup_map.size() ? uint32( dup_map.size() ) : batch.count;
     batch.readback_scores( alignments );
     batch.readback_cigars( cigar );
     batch.readback_mds( mds );
@@ -47,7 +48,8 @@ void HostOutputBatchSE::readback(const DeviceOutputBatchSE batch)
 
 void HostOutputBatchPE::readback(const DeviceOutputBatchSE batch, const AlignmentMate mate)
 {
-    count = batch.count;
+    // fan the alignments of the representatives out to all their duplicates
+    count = dup_map.size() ? uint32( dup_map.size() ) : batch.count;
     batch.readback_scores( alignments[mate] );
     batch.readback_cigars( cigar[mate] );
     batch.readback_mds( mds[mate] );
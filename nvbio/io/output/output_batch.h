@@ -98,8 +98,17 @@ public:
     // pointer to the host-side read data for each mate
     const io::SequenceDataHost*                  read_data;
 
+    // if exact duplicate reads have been collapsed before alignment, the index of the
+    // aligned representative of each read in read_data, and the number of reads
+    // each representative stands for (empty otherwise)
+    nvbio::vector<host_tag,uint32>               dup_map;
+    nvbio::vector<host_tag,uint32>               dup_count;
+
     void readback(const DeviceOutputBatchSE);
 
+    // return the number of reads the given alignment stands for
+    uint32 multiplicity(const uint32 aln_id) const { return dup_count.size() ? dup_count[aln_id] : 1u; }
+
 public:
     /// constructor
     ///
@@ -123,8 +132,17 @@ public:
     // pointer to the host-side read data for each mate
     const io::SequenceDataHost*                  read_data[2];
 
+    // if exact duplicate pairs have been collapsed before alignment, the index of the
+    // aligned representative of each pair in read_data, and the number of pairs
+    // each representative stands for (empty otherwise)
+    nvbio::vector<host_tag,uint32>               dup_map;
+    nvbio::vector<host_tag,uint32>               dup_count;
+
     void readback(const DeviceOutputBatchSE, const AlignmentMate mate);
 
+    // return the number of pairs the given alignment stands for
+    uint32 multiplicity(const uint32 aln_id) const { return dup_count.size() ? dup_count[aln_id] : 1u; }
+
 public:
     /// constructor
     ///
@@ -38,10 +38,13 @@ namespace io {
 
 // extract alignment data for a given mate
 // note that the mates can be different for the cigar, since mate 1 is always the anchor mate for cigars
-AlignmentData get(HostOutputBatchSE& batch, const uint32 aln_id)
+AlignmentData get(HostOutputBatchSE& batch, const uint32 out_id)
 {
-    const uint32 read_id = batch.read_ids.size() ?
-                           batch.read_ids[ aln_id ] : aln_id;
+    // map collapsed duplicates to the alignment of their representative
+    const uint32 aln_id  = batch.dup_map.size() ?
+                           batch.dup_map[ out_id ] : out_id;
+    const uint32 read_id = batch.dup_map.size()  ? out_id :
+                           batch.read_ids.size() ? batch.read_ids[ aln_id ] : aln_id;
 
     return AlignmentData(&batch.alignments[aln_id],
                          batch.mapq[aln_id],
@@ -54,10 +57,13 @@ AlignmentData get(HostOutputBatchSE& batch, const uint32 aln_id)
 
 // extract alignment data for a given mate
 // note that the mates can be different for the cigar, since mate 1 is always the anchor mate for cigars
-AlignmentData get_mate(HostOutputBatchPE& batch, const uint32 aln_id, const AlignmentMate mate)
+AlignmentData get_mate(HostOutputBatchPE& batch, const uint32 out_id, const AlignmentMate mate)
 {
-    const uint32 read_id = batch.read_ids.size() ?
-                           batch.read_ids[ aln_id ] : aln_id;
+    // map collapsed duplicates to the alignment of their representative
+    const uint32 aln_id  = batch.dup_map.size() ?
+                           batch.dup_map[ out_id ] : out_id;
+    const uint32 read_id = batch.dup_map.size()  ? out_id :
+                           batch.read_ids.size() ? batch.read_ids[ aln_id ] : aln_id;
 
     if (batch.alignments[0][aln_id].mate() == mate)
     {
@@ -82,10 +88,13 @@ AlignmentData get_mate(HostOutputBatchPE& batch, const uint32 aln_id, const Alig
 }
 
 // extract alignment data for the anchor mate
-AlignmentData get_anchor_mate(HostOutputBatchPE& batch, const uint32 aln_id)
+AlignmentData get_anchor_mate(HostOutputBatchPE& batch, const uint32 out_id)
 {
-    const uint32 read_id = batch.read_ids.size() ?
-                           batch.read_ids[ aln_id ] : aln_id;
+    // map collapsed duplicates to the alignment of their representative
+    const uint32 aln_id  = batch.dup_map.size() ?
+                           batch.dup_map[ out_id ] : out_id;
+    const uint32 read_id = batch.dup_map.size()  ? out_id :
+                           batch.read_ids.size() ? batch.read_ids[ aln_id ] : aln_id;
     const uint32 mate    = batch.alignments[0][aln_id].mate();
 
     return AlignmentData(&batch.alignments[0][aln_id],
@@ -98,10 +107,13 @@ AlignmentData get_anchor_mate(HostOutputBatchPE& batch, const uint32 aln_id)
 }
 
 // extract alignment data for the opposite mate
-AlignmentData get_opposite_mate(HostOutputBatchPE& batch, const uint32 aln_id)
+AlignmentData get_opposite_mate(HostOutputBatchPE& batch, const uint32 out_id)
 {
-    const uint32 read_id = batch.read_ids.size() ?
-                           batch.read_ids[ aln_id ] : aln_id;
+    // map collapsed duplicates to the alignment of their representative
+    const uint32 aln_id  = batch.dup_map.size() ?
+                           batch.dup_map[ out_id ] : out_id;
+    const uint32 read_id = batch.dup_map.size()  ? out_id :
+                           batch.read_ids.size() ? batch.read_ids[ aln_id ] : aln_id;
     const uint32 mate    = batch.alignments[1][aln_id].mate();
 
     return AlignmentData(&batch.alignments[1][aln_id],
@@ -140,14 +140,14 @@ struct AlignmentData
 
 // extract alignment data for a given mate
 // note that the mates can be different for the cigar, since mate 1 is always the anchor mate for cigars
-AlignmentData get(HostOutputBatchSE& batch, const uint32 aln_id);
+AlignmentData get(HostOutputBatchSE& batch, const uint32 out_id);
 
 // extract alignment data for a given mate
-AlignmentData get_mate(HostOutputBatchPE& batch, const uint32 aln_id, const AlignmentMate mate);
+AlignmentData get_mate(HostOutputBatchPE& batch, const uint32 out_id, const AlignmentMate mate);
 // extract alignment data for the anchor mate
-AlignmentData get_anchor_mate(HostOutputBatchPE& batch, const uint32 aln_id);
+AlignmentData get_anchor_mate(HostOutputBatchPE& batch, const uint32 out_id);
 // extract alignment data for the opposite mate
-AlignmentData get_opposite_mate(HostOutputBatchPE& batch, const uint32 aln_id);
+AlignmentData get_opposite_mate(HostOutputBatchPE& batch, const uint32 out_id);
 
 } // namespace io
 } // namespace nvbio
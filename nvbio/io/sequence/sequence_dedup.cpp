@@ -0,0 +1,299 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <nvbio/io/sequence/sequence_dedup.h>
+#include <nvbio/basic/packedstream.h>
+#include <nvbio/basic/omp.h>
+#include <nvbio/basic/exceptions.h>
+#include <string.h>
+
+namespace nvbio {
+namespace io {
+
+namespace { // anonymous
+
+// 64-bit FNV-1a hashing step
+inline uint64 fnv1a(const uint64 h, const uint32 c)
+{
+    return (h ^ c) * 1099511628211ull;
+}
+
+//
+// A helper providing symbol-level access to the sequences of a batch,
+// templated over the symbol size
+//
+template <uint32 SYMBOL_SIZE>
+struct sequence_accessor
+{
+    typedef PackedStream<const uint32*,uint8,SYMBOL_SIZE,true> const_stream_type;
+    typedef PackedStream<uint32*,uint8,SYMBOL_SIZE,true>       stream_type;
+
+    // constructor
+    sequence_accessor(const SequenceDataHost& data) :
+        index( nvbio::raw_pointer( data.m_sequence_index_vec ) ),
+        stream( nvbio::raw_pointer( data.m_sequence_vec ) ),
+        qual( nvbio::raw_pointer( data.m_qual_vec ) ) {}
+
+    // hash the i-th sequence, bases and qualities
+    uint64 hash(const uint32 i, uint64 h) const
+    {
+        const uint32 begin = index[i];
+        const uint32 end   = index[i+1];
+
+        h = fnv1a( h, end - begin );
+        for (uint32 j = begin; j < end; ++j)
+            h = fnv1a( fnv1a( h, stream[j] ), uint8( qual[j] ) );
+
+        return h;
+    }
+
+    // compare the i-th and j-th sequences, bases and qualities
+    bool equal(const uint32 i, const uint32 j) const
+    {
+        const uint32 len = index[i+1] - index[i];
+        if (index[j+1] - index[j] != len)
+            return false;
+
+        if (memcmp( qual + index[i], qual + index[j], len ) != 0)
+            return false;
+
+        for (uint32 k = 0; k < len; ++k)
+        {
+            if (stream[ index[i] + k ] != stream[ index[j] + k ])
+                return false;
+        }
+        return true;
+    }
+
+    // gather the given sequences in a new batch
+    void gather(const SequenceDataHost& in, const uint32 n, const uint32* seqs, SequenceDataHost* out) const
+    {
+        const uint32* name_index = nvbio::raw_pointer( in.m_name_index_vec );
+        const char*   names      = nvbio::raw_pointer( in.m_name_vec );
+
+        // compute the output sizes
+        uint32 n_bps   = 0;
+        uint32 n_chars = 0;
+        for (uint32 i = 0; i < n; ++i)
+        {
+            n_bps   += index[ seqs[i]+1 ]      - index[ seqs[i] ];
+            n_chars += name_index[ seqs[i]+1 ] - name_index[ seqs[i] ];
+        }
+
+        static const uint32 SYMBOLS_PER_WORD = 32u / SYMBOL_SIZE;
+
+        out->SequenceDataInfo::operator=( SequenceDataInfo() );
+        out->m_alphabet              = in.m_alphabet;
+        out->m_has_qualities         = in.m_has_qualities;
+        out->m_n_seqs                = n;
+        out->m_sequence_stream_len   = n_bps;
+        out->m_sequence_stream_words = util::divide_ri( n_bps, SYMBOLS_PER_WORD );
+        out->m_name_stream_len       = n_chars;
+
+        out->m_sequence_vec.resize( out->m_sequence_stream_words );
+        out->m_sequence_index_vec.resize( n + 1u );
+        out->m_qual_vec.resize( n_bps );
+        out->m_name_vec.resize( n_chars );
+        out->m_name_index_vec.resize( n + 1u );
+
+        stream_type out_stream( nvbio::raw_pointer( out->m_sequence_vec ) );
+        uint32*     out_index      = nvbio::raw_pointer( out->m_sequence_index_vec );
+        char*       out_qual       = nvbio::raw_pointer( out->m_qual_vec );
+        char*       out_names      = nvbio::raw_pointer( out->m_name_vec );
+        uint32*     out_name_index = nvbio::raw_pointer( out->m_name_index_vec );
+
+        out_index[0]      = 0u;
+        out_name_index[0] = 0u;
+
+        for (uint32 i = 0; i < n; ++i)
+        {
+            const uint32 begin = index[ seqs[i] ];
+            const uint32 len   = index[ seqs[i]+1 ] - begin;
+
+            const uint32 out_begin = out_index[i];
+            for (uint32 j = 0; j < len; ++j)
+                out_stream[ out_begin + j ] = stream[ begin + j ];
+
+            memcpy( out_qual + out_begin, qual + begin, len );
+
+            const uint32 name_begin = name_index[ seqs[i] ];
+            const uint32 name_len   = name_index[ seqs[i]+1 ] - name_begin;
+            memcpy( out_names + out_name_index[i], names + name_begin, name_len );
+
+            out_index[i+1]      = out_begin + len;
+            out_name_index[i+1] = out_name_index[i] + name_len;
+
+            out->m_min_sequence_len = nvbio::min( out->m_min_sequence_len, len );
+            out->m_max_sequence_len = nvbio::max( out->m_max_sequence_len, len );
+        }
+        out->m_avg_sequence_len = n ? util::divide_ri( n_bps, n ) : 0u;
+    }
+
+    const uint32*       index;
+    const_stream_type   stream;
+    const char*         qual;
+};
+
+//
+// collapse the exact duplicates of a set of n_mates parallel batches
+//
+template <uint32 SYMBOL_SIZE>
+uint32 collapse_duplicates_t(
+    const uint32                        n_mates,
+    const SequenceDataHost**            in,
+    SequenceDataHost**                  out,
+    nvbio::vector<host_tag,uint32>&     dup_map,
+    nvbio::vector<host_tag,uint32>&     dup_count)
+{
+    const uint32 n = in[0]->size();
+
+    sequence_accessor<SYMBOL_SIZE> mates[2] = {
+        sequence_accessor<SYMBOL_SIZE>( *in[0] ),
+        sequence_accessor<SYMBOL_SIZE>( *in[ n_mates - 1u ] ) };
+
+    // hash all sequences
+    nvbio::vector<host_tag,uint64> hashes( n );
+
+    #pragma omp parallel for
+    for (int i = 0; i < int(n); ++i)
+    {
+        uint64 h = 14695981039346656037ull;
+        for (uint32 m = 0; m < n_mates; ++m)
+            h = mates[m].hash( uint32(i), h );
+
+        hashes[i] = h;
+    }
+
+    // insert all sequences in an open-addressing hash table with linear probing,
+    // keyed by their hash and verified by exact comparison
+    uint32 table_size = 1u;
+    while (table_size < n*2u)
+        table_size *= 2u;
+
+    const uint32 EMPTY = 0xFFFFFFFFu;
+    nvbio::vector<host_tag,uint32> table( table_size, EMPTY );
+    nvbio::vector<host_tag,uint32> reps;
+    reps.reserve( n );
+
+    dup_map.resize( n );
+    dup_count.resize( 0 );
+
+    for (uint32 i = 0; i < n; ++i)
+    {
+        const uint64 h = hashes[i];
+
+        uint32 slot = uint32( h ^ (h >> 32) ) & (table_size - 1u);
+        while (1)
+        {
+            const uint32 j = table[ slot ];
+            if (j == EMPTY)
+            {
+                // a new representative
+                table[ slot ] = i;
+                dup_map[i] = uint32( reps.size() );
+                reps.push_back( i );
+                dup_count.push_back( 1u );
+                break;
+            }
+            if (hashes[j] == h &&
+                mates[0].equal( i, j ) &&
+                (n_mates == 1u || mates[1].equal( i, j )))
+            {
+                // a duplicate of j
+                dup_map[i] = dup_map[j];
+                dup_count[ dup_map[j] ]++;
+                break;
+            }
+            slot = (slot + 1u) & (table_size - 1u);
+        }
+    }
+
+    const uint32 n_unique = uint32( reps.size() );
+    if (n_unique < n)
+    {
+        for (uint32 m = 0; m < n_mates; ++m)
+            mates[m].gather( *in[m], n_unique, nvbio::raw_pointer( reps ), out[m] );
+    }
+    return n_unique;
+}
+
+// dispatch on the symbol size of the input
+uint32 collapse_duplicates_dispatch(
+    const uint32                        n_mates,
+    const SequenceDataHost**            in,
+    SequenceDataHost**                  out,
+    nvbio::vector<host_tag,uint32>&     dup_map,
+    nvbio::vector<host_tag,uint32>&     dup_count)
+{
+    switch (bits_per_symbol( in[0]->alphabet() ))
+    {
+    case 2:
+        return collapse_duplicates_t<2>( n_mates, in, out, dup_map, dup_count );
+    case 4:
+        return collapse_duplicates_t<4>( n_mates, in, out, dup_map, dup_count );
+    default:
+        return collapse_duplicates_t<8>( n_mates, in, out, dup_map, dup_count );
+    }
+}
+
+} // anonymous namespace
+
+// collapse the exact duplicates of a host-side sequence batch
+//
+uint32 collapse_duplicates(
+    const SequenceDataHost&             in,
+    SequenceDataHost*                   out,
+    nvbio::vector<host_tag,uint32>&     dup_map,
+    nvbio::vector<host_tag,uint32>&     dup_count)
+{
+    const SequenceDataHost* in_mates[1]  = { &in };
+    SequenceDataHost*       out_mates[1] = { out };
+
+    return collapse_duplicates_dispatch( 1u, in_mates, out_mates, dup_map, dup_count );
+}
+
+// collapse the exact duplicates of a host-side batch of paired sequences
+//
+uint32 collapse_duplicates(
+    const SequenceDataHost&             in1,
+    const SequenceDataHost&             in2,
+    SequenceDataHost*                   out1,
+    SequenceDataHost*                   out2,
+    nvbio::vector<host_tag,uint32>&     dup_map,
+    nvbio::vector<host_tag,uint32>&     dup_count)
+{
+    if (in1.size() != in2.size())
+        throw nvbio::logic_error( "collapse_duplicates(): mismatching mate batch sizes (%u, %u)", in1.size(), in2.size() );
+
+    const SequenceDataHost* in_mates[2]  = { &in1, &in2 };
+    SequenceDataHost*       out_mates[2] = { out1, out2 };
+
+    return collapse_duplicates_dispatch( 2u, in_mates, out_mates, dup_map, dup_count );
+}
+
+} // namespace io
+} // namespace nvbio
@@ -0,0 +1,90 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/io/sequence/sequence.h>
+#include <nvbio/basic/vector.h>
+
+namespace nvbio {
+namespace io {
+
+///@addtogroup IO
+///@{
+
+///@addtogroup SequenceIO
+///@{
+
+///\relates SequenceDataHost
+/// Collapse the exact duplicates of a host-side sequence batch, i.e. the sequences
+/// sharing the same bases and qualities, gathering a single representative per
+/// group of duplicates into a separate batch.
+/// Representatives are kept in order of first occurrence, and carry the name of the
+/// first sequence of their group.
+/// If the batch contains no duplicates, the output batch is left untouched.
+///
+/// \param in               the input batch
+/// \param out              the output batch of unique representatives
+/// \param dup_map          for each input sequence, the index of its representative in out
+/// \param dup_count        for each representative, the number of input sequences it stands for
+/// \return                 the number of unique sequences
+///
+uint32 collapse_duplicates(
+    const SequenceDataHost&             in,
+    SequenceDataHost*                   out,
+    nvbio::vector<host_tag,uint32>&     dup_map,
+    nvbio::vector<host_tag,uint32>&     dup_count);
+
+///\relates SequenceDataHost
+/// Collapse the exact duplicates of a host-side batch of paired sequences, i.e. the pairs
+/// whose mates share the same bases and qualities, gathering a single representative
+/// pair per group of duplicates into a separate pair of batches.
+/// Representatives are kept in order of first occurrence, and carry the names of the
+/// first pair of their group.
+/// If the batch contains no duplicates, the output batches are left untouched.
+///
+/// \param in1              the input batch of first mates
+/// \param in2              the input batch of second mates
+/// \param out1             the output batch of unique first mates
+/// \param out2             the output batch of unique second mates
+/// \param dup_map          for each input pair, the index of its representative in out1/out2
+/// \param dup_count        for each representative, the number of input pairs it stands for
+/// \return                 the number of unique pairs
+///
+uint32 collapse_duplicates(
+    const SequenceDataHost&             in1,
+    const SequenceDataHost&             in2,
+    SequenceDataHost*                   out1,
+    SequenceDataHost*                   out2,
+    nvbio::vector<host_tag,uint32>&     dup_map,
+    nvbio::vector<host_tag,uint32>&     dup_count);
+
+///@} // SequenceIO
+///@} // IO
+
+} // namespace io
+} // namespace nvbio
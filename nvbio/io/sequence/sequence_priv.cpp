@@ -59,26 +59,32 @@ int SequenceDataFile::next(SequenceDataEncoder* encoder, const uint32 batch_size
     // fetch the sequence info
     const SequenceDataInfo* info = encoder->info();
 
-    while (info->size() < reads_to_load &&
-           info->bps()  < batch_bps)
+    // when appending, the batch may already contain some sequences
+    const uint32 size_begin = info->size();
+    const uint32 bps_begin  = info->bps();
+
+    while (info->size() - size_begin < reads_to_load &&
+           info->bps()  - bps_begin  < batch_bps)
     {
         // load 100 at a time if possible
-        const uint32 chunk_reads = nvbio::min(reads_to_load - info->size(), uint32(100));
-        const uint32 chunk_bps   = batch_bps - info->bps();
+        const uint32 chunk_reads = nvbio::min(reads_to_load - (info->size() - size_begin), uint32(100));
+        const uint32 chunk_bps   = batch_bps - (info->bps() - bps_begin);
 
         const int n = nextChunk( encoder , chunk_reads, chunk_bps );
         assert(n <= (int) chunk_reads);
         if (n == 0)
             break;
 
-        assert(info->size() <= reads_to_load);
+        assert(info->size() - size_begin <= reads_to_load);
     }
 
-    m_loaded += info->size();
+    const uint32 n_loaded = info->size() - size_begin;
+
+    m_loaded += n_loaded;
 
     encoder->end_batch();
 
-    return info->size();
+    return n_loaded;
 }
 
 // factory method to open a read file, tries to detect file type based on file name
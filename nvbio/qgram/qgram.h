@@ -31,11 +31,13 @@
 #include <nvbio/basic/numbers.h>
 #include <nvbio/basic/algorithms.h>
 #include <nvbio/basic/cuda/primitives.h>
+#include <nvbio/basic/primitives.h>
 #include <nvbio/basic/thrust_view.h>
 #include <nvbio/basic/exceptions.h>
 #include <nvbio/basic/iterator.h>
 #include <nvbio/basic/vector.h>
 #include <nvbio/strings/seeds.h>
+#include <nvbio/strings/kmers.h>
 #include <thrust/host_vector.h>
 #include <thrust/device_vector.h>
 #include <thrust/sort.h>
@@ -326,6 +328,12 @@
 /// }
 ///\endcode
 ///
+///\section QGramMappingSection Q-Gram Mapping
+///\par
+/// The \ref QMapModule "Q-Gram Mapper" puts all of the above together into a host-parallel read mapper,
+/// which indexes a batch of reads with a QGramSetIndexHost and streams the reference against it
+/// in chunks, verifying the merged diagonals with a banded aligner (see nvbio/qgram/qmap.h).
+///
 /// \section TechnicalOverviewSection Technical Overview
 ///\par
 /// A complete list of the classes and functions in this module is given in the \ref QGram documentation.
@@ -631,7 +639,7 @@ struct QGramIndexDevice : public QGramIndexCore<device_tag,uint64,uint32,uint32>
     QGramIndexDevice& operator= (const QGramIndexCore<SystemTag,uint64,uint32,uint32>& src);
 };
 
-/// A device-side q-gram index for string-sets (see \ref QGramIndex)
+/// A host-side q-gram index for string-sets (see \ref QGramIndex)
 ///
 struct QGramSetIndexHost : public QGramIndexCore<host_tag,uint64,uint32,uint2>
 {
@@ -651,6 +659,43 @@ struct QGramSetIndexHost : public QGramIndexCore<host_tag,uint64,uint32,uint2>
     typedef core_type::plain_view_type              plain_view_type;
     typedef core_type::const_plain_view_type        const_plain_view_type;
 
+    /// build a q-gram index from a given string-set T
+    ///
+    /// \tparam string_set_type     the string-set type
+    ///
+    /// \param q                the q parameter
+    /// \param symbol_sz        the size of the symbols, in bits
+    /// \param string_set       the string-set
+    /// \param qlut             the number of symbols to include in the LUT (of size O( A^qlut ))
+    ///                         used to accelerate q-gram searches
+    ///
+    template <typename string_set_type>
+    void build(
+        const uint32            q,
+        const uint32            symbol_sz,
+        const string_set_type   string_set,
+        const uint32            qlut = 0);
+
+    /// build a q-gram index from a given string-set T using a \ref SeedFunctor "Seeding Functor"
+    ///
+    /// \tparam string_set_type     the string-set type
+    /// \tparam seed_functor        the \ref SeedFunctor "Seeding Functor" type
+    ///
+    /// \param q                the q parameter
+    /// \param symbol_sz        the size of the symbols, in bits
+    /// \param string_set       the string-set
+    /// \param seeder           the seeding functor
+    /// \param qlut             the number of symbols to include in the LUT (of size O( A^qlut ))
+    ///                         used to accelerate q-gram searches
+    ///
+    template <typename string_set_type, typename seed_functor>
+    void build(
+        const uint32            q,
+        const uint32            symbol_sz,
+        const string_set_type   string_set,
+        const seed_functor      seeder,
+        const uint32            qlut = 0);
+
     /// copy operator
     ///
     template <typename SystemTag>
@@ -826,11 +871,7 @@ struct string_qgram_functor
     NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
     uint64 operator() (const uint32 i) const
     {
-        uint64 qgram = 0u;
-        for (uint32 j = 0; j < Q; ++j)
-            qgram |= uint64(i+j < string_len ? (string[i + j] & symbol_mask) : 0u) << (j*symbol_size);
-
-        return qgram;
+        return load_kmer<true>( string, string_len, i, Q, symbol_size );
     }
 
     const uint32        Q;              ///< q-gram size
@@ -876,13 +917,7 @@ struct string_set_qgram_functor
         const uint32 string_pos = id.y;
         const string_type string = string_set[ string_id ];
 
-        const uint32 string_len = string.length();
-
-        uint64 qgram = 0u;
-        for (uint32 j = 0; j < Q; ++j)
-            qgram |= uint64(string_pos + j < string_len ? (string[string_pos + j] & symbol_mask) : 0u) << (j*symbol_size);
-
-        return qgram;
+        return load_kmer<true>( string, string.length(), string_pos, Q, symbol_size );
     }
 
     const uint32            Q;              ///< q-gram size
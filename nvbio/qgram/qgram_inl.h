@@ -330,6 +330,130 @@ void QGramSetIndexDevice::build(
         qlut );
 }
 
+// build a q-group index from a given string set on the host
+//
+// \param q                the q parameter
+// \param string-set       the string-set
+//
+template <typename string_set_type, typename seed_functor>
+void QGramSetIndexHost::build(
+    const uint32            q,
+    const uint32            symbol_sz,
+    const string_set_type   string_set,
+    const seed_functor      seeder,
+    const uint32            qlut)
+{
+    nvbio::vector<host_tag,uint8> h_temp_storage;
+
+    symbol_size = symbol_sz;
+    Q           = q;
+    QL          = qlut;
+    QLS         = (Q - QL) * symbol_size;
+
+    // extract the list of q-gram coordinates
+    n_qgrams = (uint32)enumerate_string_set_seeds(
+        string_set,
+        seeder,
+        index );
+
+    nvbio::vector<host_tag,qgram_type> h_all_qgrams( n_qgrams );
+
+    // build the list of q-grams
+    nvbio::transform<host_tag>(
+        n_qgrams,
+        index.begin(),
+        h_all_qgrams.begin(),
+        string_set_qgram_functor<string_set_type>( Q, symbol_size, string_set ) );
+
+    // sort the q-grams together with their coordinates, which as in the device
+    // version are moved around as plain 64-bit words
+    radix_sort<host_tag>(
+        n_qgrams,
+        nvbio::raw_pointer( h_all_qgrams ),
+        (uint64*)nvbio::raw_pointer( index ),
+        h_temp_storage );
+
+    // reserve enough storage for the output q-grams
+    qgrams.resize( n_qgrams );
+
+    // copy only the unique q-grams and count them
+    nvbio::vector<host_tag,uint32> h_counts( n_qgrams + 1u );
+
+    n_unique_qgrams = runlength_encode<host_tag>(
+        n_qgrams,
+        h_all_qgrams.begin(),
+        qgrams.begin(),
+        h_counts.begin(),
+        h_temp_storage );
+
+    // now we know how many unique q-grams there are
+    slots.resize( n_unique_qgrams + 1u );
+
+    // scan the counts to get the slots
+    exclusive_scan<host_tag>(
+        n_unique_qgrams + 1u,
+        h_counts.begin(),
+        slots.begin(),
+        thrust::plus<uint32>(),
+        uint32(0),
+        h_temp_storage );
+
+    // shrink the q-gram vector
+    qgrams.resize( n_unique_qgrams );
+
+    const uint32 n_slots = slots[ n_unique_qgrams ];
+    if (n_slots != n_qgrams)
+        throw runtime_error( "mismatching number of q-grams: inserted %u q-grams, got: %u\n", n_qgrams, n_slots );
+
+    //
+    // build a LUT
+    //
+
+    if (QL)
+    {
+        const uint32 ALPHABET_SIZE = 1u << symbol_size;
+
+        uint64 lut_size = 1;
+        for (uint32 i = 0; i < QL; ++i)
+            lut_size *= ALPHABET_SIZE;
+
+        // build a set of spaced q-grams and search them
+        lut.resize( lut_size+1 );
+
+        lower_bound<host_tag>(
+            uint32( lut_size ),
+            thrust::make_transform_iterator( thrust::make_counting_iterator<uint32>(0), shift_left<qgram_type>( QLS ) ),
+            n_unique_qgrams,
+            qgrams.begin(),
+            lut.begin() );
+
+        // and write a sentinel value
+        lut[ lut_size ] = n_unique_qgrams;
+    }
+    else
+        lut.resize(0);
+}
+
+// build a q-group index from a given string set on the host
+//
+// \param q                the q parameter
+// \param string-set       the string-set
+//
+template <typename string_set_type>
+void QGramSetIndexHost::build(
+    const uint32            q,
+    const uint32            symbol_sz,
+    const string_set_type   string_set,
+    const uint32            qlut)
+{
+    build(
+        q,
+        symbol_sz,
+        string_set,
+        uniform_seeds_functor<>( q, 1u ),
+        qlut );
+}
+
 // copy operator
 //
 template <typename SystemTag>
@@ -373,6 +497,7 @@ QGramSetIndexHost& QGramSetIndexHost::operator= (const QGramIndexCore<SystemTag,
 {
     Q               = src.Q;
     symbol_size     = src.symbol_size;
+    n_qgrams        = src.n_qgrams;
     n_unique_qgrams = src.n_unique_qgrams;
     qgrams          = src.qgrams;
     slots           = src.slots;
@@ -390,6 +515,7 @@ QGramSetIndexDevice& QGramSetIndexDevice::operator= (const QGramIndexCore<System
 {
     Q               = src.Q;
     symbol_size     = src.symbol_size;
+    n_qgrams        = src.n_qgrams;
     n_unique_qgrams = src.n_unique_qgrams;
     qgrams          = src.qgrams;
     slots           = src.slots;
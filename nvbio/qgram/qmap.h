@@ -0,0 +1,267 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <nvbio/qgram/qgram.h>
+#include <nvbio/qgram/filter.h>
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/basic/vector.h>
+#include <nvbio/basic/atomics.h>
+#include <nvbio/basic/timer.h>
+#include <nvbio/basic/omp.h>
+#include <nvbio/strings/infix.h>
+#include <nvbio/strings/seeds.h>
+#include <nvbio/alignment/alignment.h>
+#include <nvbio/alignment/sink.h>
+#include <nvbio/io/sequence/sequence.h>
+#include <nvbio/io/sequence/sequence_access.h>
+#include <vector>
+
+namespace nvbio {
+
+///@addtogroup QGram
+///@{
+
+///\defgroup QMapModule Q-Gram Mapper
+///\par
+/// This module implements a host-parallel short read mapper which, rather than indexing the
+/// reference, builds a \ref QGramIndex "q-gram set-index" over a (small) batch of reads, and streams
+/// the (large) reference against it in chunks:
+///\par
+/// - each chunk is split into slices, which are processed independently by the host threads:
+///   each thread extracts and sorts the q-grams of its slice, runs them through its own QGramFilter,
+///   and verifies the merged diagonals with a banded edit-distance aligner;
+/// - the best hit of each read is folded into a single packed word with a lock-free max, so that
+///   the memory footprint of the mapper is O(reads + threads * slice) regardless of the reference size.
+///\par
+/// The reference chunks themselves are owned by the caller. Notice that io::next() never splits a
+/// sequence, so that streaming the reference with it keeps up to chunk_bps plus the length of the
+/// longest sequence in memory at once: callers needing a tighter bound can split long sequences into pieces overlapping
+/// by at least QMapper::chunk_overlap() bps, mapping each at its global offset, so that every read occurrence
+/// is entirely contained in at least one piece.
+///\par
+/// The reads are expected to be encoded as consecutive forward and reverse-complemented
+/// pairs (i.e. loaded with io::FORWARD | io::REVERSE_COMPLEMENT), and the results of
+/// both strands are merged into a single best hit per read:
+///
+///\code
+/// QMapper<> mapper( params );
+///
+/// // index a batch of reads
+/// mapper.index( reads );
+///
+/// // stream the reference through the mapper
+/// uint64 ref_offset = 0;
+/// while (io::next( DNA, &ref_chunk, ref_file, uint32(-1), params.chunk_bps ))
+/// {
+///     mapper.map( ref_chunk, ref_offset );
+///     ref_offset += ref_chunk.bps();
+/// }
+///
+/// // and collect the results
+/// nvbio::vector<host_tag,QMapHit> best_hits;
+/// mapper.best_hits( best_hits );
+///\endcode
+///@{
+
+///
+/// QMapper parameters
+///
+struct QMapParams
+{
+    QMapParams() :
+        Q( 20 ),
+        Q_intv( 10 ),
+        merge_intv( 16 ),
+        chunk_bps( 64*1024*1024 ),
+        slice_len( 1024*1024 ),
+        hits_batch_size( 1024*1024 ) {}
+
+    uint32 Q;                   ///< q-gram length
+    uint32 Q_intv;              ///< spacing between consecutive read q-grams
+    uint32 merge_intv;          ///< diagonal merging interval
+    uint32 chunk_bps;           ///< suggested number of reference bps to stream at once; io::next() exceeds it for longer sequences
+    uint32 slice_len;           ///< number of reference q-grams processed by a thread at once
+    uint32 hits_batch_size;     ///< maximum number of hits located and verified at once by each thread
+};
+
+///
+/// QMapper statistics; all timings are summed across threads
+///
+struct QMapStats
+{
+    QMapStats() :
+        index_time(0),
+        extract_time(0),
+        rank_time(0),
+        locate_time(0),
+        align_time(0),
+        reads(0),
+        queries(0),
+        occurrences(0),
+        merged(0) {}
+
+    /// accumulate another set of statistics
+    ///
+    QMapStats& operator+= (const QMapStats& op);
+
+    float   index_time;
+    float   extract_time;
+    float   rank_time;
+    float   locate_time;
+    float   align_time;
+    uint64  reads;
+    uint64  queries;
+    uint64  occurrences;
+    uint64  merged;
+};
+
+///
+/// The best hit of a read
+///
+struct QMapHit
+{
+    /// return true if the read has been aligned at all
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    bool is_valid() const { return score > Field_traits<int16>::min(); }
+
+    int16   score;      ///< the alignment score
+    uint32  strand;     ///< 0 if the forward strand aligned, 1 if the reverse-complemented one did
+    uint64  pos;        ///< the reference diagonal, i.e. the approximate position of the read start
+};
+
+///
+/// The per-thread scratch state of a QMapper
+///
+struct QMapThreadState
+{
+    typedef QGramFilterHost<QGramSetIndexHost,const uint64*,const uint32*>  qgram_filter_type;
+    typedef qgram_filter_type::hit_type                                     hit_type;
+    typedef qgram_filter_type::diagonal_type                                diagonal_type;
+
+    qgram_filter_type                       filter;
+    nvbio::vector<host_tag,uint64>          qgrams;
+    nvbio::vector<host_tag,uint32>          indices;
+    nvbio::vector<host_tag,hit_type>        hits;
+    nvbio::vector<host_tag,diagonal_type>   merged_hits;
+    nvbio::vector<host_tag,uint16>          merged_counts;
+    nvbio::vector<host_tag,uint64>          packed_hits;
+    nvbio::vector<host_tag,uint32>          out_reads;
+    nvbio::vector<host_tag,uint64>          out_hits;
+    QMapStats                               stats;
+};
+
+///
+/// A host-parallel q-gram mapper, indexing a batch of reads and streaming the reference
+/// against it in chunks.
+///\par
+/// The index() and map() methods are not reentrant: they use all host threads internally.
+///
+/// \tparam BAND_LEN        the width of the alignment band around each diagonal
+///
+template <uint32 BAND_LEN = 31>
+struct QMapper
+{
+    typedef QGramSetIndexHost                                           qgram_index_type;
+    typedef QMapThreadState::qgram_filter_type                          qgram_filter_type;
+    typedef QMapThreadState::hit_type                                   hit_type;
+    typedef QMapThreadState::diagonal_type                              diagonal_type;
+    typedef io::SequenceDataAccess<DNA,io::ConstSequenceDataView>       genome_access_type;
+    typedef typename genome_access_type::sequence_stream_type           genome_string;
+    typedef io::SequenceDataAccess<DNA_N,io::ConstSequenceDataView>     read_access_type;
+    typedef typename read_access_type::sequence_string_set_type         read_string_set_type;
+
+    /// constructor
+    ///
+    /// \param params       the mapping parameters
+    ///
+    QMapper(const QMapParams params = QMapParams());
+
+    /// index a batch of reads, resetting their best hits;
+    /// the reads must stay alive until the last call to map()
+    ///
+    /// \param reads        the read batch
+    ///
+    void index(const io::SequenceDataHost& reads);
+
+    /// map a chunk of the reference against the indexed reads, folding its hits
+    /// into the best hits of each read
+    ///
+    /// \param chunk        the reference chunk
+    /// \param chunk_offset the global offset of the chunk within the reference
+    ///
+    void map(const io::SequenceDataHost& chunk, const uint64 chunk_offset);
+
+    /// return the minimum overlap between consecutive pieces of a sequence split across
+    /// map() calls, guaranteeing each read occurrence is entirely contained in one of them
+    ///
+    /// \param max_read_len the maximum read length
+    ///
+    static uint32 chunk_overlap(const uint32 max_read_len) { return max_read_len + BAND_LEN; }
+
+    /// return the best hit of each forward/reverse-complemented read pair
+    ///
+    /// \param hits         the output hits
+    ///
+    void best_hits(nvbio::vector<host_tag,QMapHit>& hits) const;
+
+    /// return the number of indexed read pairs
+    ///
+    uint32 size() const { return uint32( m_best.size() ); }
+
+    /// return the mapping statistics
+    ///
+    QMapStats stats() const;
+
+    QMapParams                                  params;
+
+private:
+    void map_slice(
+        QMapThreadState&        state,
+        const genome_string     genome,
+        const uint32            genome_len,
+        const uint32            slice_begin,
+        const uint32            slice_end,
+        const uint64            chunk_offset);
+
+    const io::SequenceDataHost*                 m_reads;
+    qgram_index_type                            m_qgram_index;
+    nvbio::vector<host_tag,uint64>              m_best;
+    std::vector<QMapThreadState>                m_threads;
+    QMapStats                                   m_stats;
+};
+
+///@} QMapModule
+///@} QGram
+
+} // namespace nvbio
+
+#include <nvbio/qgram/qmap_inl.h>
@@ -0,0 +1,345 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+namespace nvbio {
+
+namespace priv {
+
+// the number of bits used to encode the (position,strand) pair of a packed hit
+//
+static const uint32 QMAP_LOC_BITS = 48u;
+
+// pack a hit into a 64-bit word whose integer order matches the hit ranking, i.e. higher
+// scores first and, among equal scores, lower reference positions first, so that the
+// best hit of each read doesn't depend on the order in which threads report it
+//
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 qmap_pack_hit(const int16 score, const uint64 pos, const uint32 strand)
+{
+    const uint64 loc_mask = (uint64(1u) << QMAP_LOC_BITS) - 1u;
+    const uint64 loc      = (pos << 1) | strand;
+
+    return (uint64( int32( score ) - int32( Field_traits<int16>::min() ) ) << QMAP_LOC_BITS) | (~loc & loc_mask);
+}
+
+// unpack a hit packed by qmap_pack_hit(); a null word unpacks to an invalid hit
+//
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+QMapHit qmap_unpack_hit(const uint64 packed)
+{
+    const uint64 loc_mask = (uint64(1u) << QMAP_LOC_BITS) - 1u;
+    const uint64 loc      = ~packed & loc_mask;
+
+    QMapHit hit;
+    hit.score  = int16( int32( packed >> QMAP_LOC_BITS ) + int32( Field_traits<int16>::min() ) );
+    hit.strand = uint32( loc & 1u );
+    hit.pos    = loc >> 1;
+    return hit;
+}
+
+// atomically replace a packed hit with a better one
+//
+inline void qmap_atomic_max(uint64* best, const uint64 hit)
+{
+    uint64 old = *best;
+    while (old < hit)
+    {
+        const uint64 prev = host_atomic_cas( best, old, hit );
+        if (prev == old)
+            break;
+
+        old = prev;
+    }
+}
+
+// map a diagonal to its read pair, merging the forward and reverse-complemented strands
+//
+struct qmap_diagonal_to_read
+{
+    typedef uint2  argument_type;
+    typedef uint32 result_type;
+
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint32 operator() (const uint2 diagonal) const { return diagonal.y / 2u; }
+};
+
+} // namespace priv
+
+// accumulate another set of statistics
+//
+inline QMapStats& QMapStats::operator+= (const QMapStats& op)
+{
+    index_time   += op.index_time;
+    extract_time += op.extract_time;
+    rank_time    += op.rank_time;
+    locate_time  += op.locate_time;
+    align_time   += op.align_time;
+    reads        += op.reads;
+    queries      += op.queries;
+    occurrences  += op.occurrences;
+    merged       += op.merged;
+    return *this;
+}
+
+// constructor
+//
+template <uint32 BAND_LEN>
+QMapper<BAND_LEN>::QMapper(const QMapParams _params) :
+    params( _params ),
+    m_reads( NULL ),
+    m_threads( omp_get_max_threads() )
+{}
+
+// index a batch of reads, resetting their best hits
+//
+template <uint32 BAND_LEN>
+void QMapper<BAND_LEN>::index(const io::SequenceDataHost& reads)
+{
+    Timer timer;
+    timer.start();
+
+    m_reads = &reads;
+
+    const read_access_type reads_access( nvbio::plain_view( reads ) );
+
+    // build the q-gram set-index, implicitly converting N to A
+    m_qgram_index.build(
+        params.Q,
+        2u,
+        reads_access.sequence_string_set(),
+        uniform_seeds_functor<>( params.Q, params.Q_intv ),
+        12u );
+
+    // start with no alignments
+    m_best.resize( reads.size() / 2 );
+    thrust::fill( m_best.begin(), m_best.end(), uint64(0) );
+
+    timer.stop();
+    m_stats.index_time += timer.seconds();
+    m_stats.reads      += reads.size() / 2;
+}
+
+// map a chunk of the reference against the indexed reads
+//
+template <uint32 BAND_LEN>
+void QMapper<BAND_LEN>::map(const io::SequenceDataHost& chunk, const uint64 chunk_offset)
+{
+    const genome_access_type genome_access( nvbio::plain_view( chunk ) );
+    const uint32             genome_len = chunk.bps();
+    const genome_string      genome( genome_access.sequence_stream() );
+
+    if (genome_len == 0 || m_best.size() == 0)
+        return;
+
+    const uint32 n_slices = util::divide_ri( genome_len, params.slice_len );
+
+    // all slices have the same size, but the number of hits they produce varies wildly
+    #pragma omp parallel for schedule(dynamic,1)
+    for (int32 s = 0; s < int32( n_slices ); ++s)
+    {
+        const uint32 slice_begin = uint32( s ) * params.slice_len;
+        const uint32 slice_end   = nvbio::min( slice_begin + params.slice_len, genome_len );
+
+        map_slice(
+            m_threads[ omp_get_thread_num() ],
+            genome,
+            genome_len,
+            slice_begin,
+            slice_end,
+            chunk_offset );
+    }
+}
+
+// map a slice of a reference chunk on the calling thread
+//
+template <uint32 BAND_LEN>
+void QMapper<BAND_LEN>::map_slice(
+    QMapThreadState&        state,
+    const genome_string     genome,
+    const uint32            genome_len,
+    const uint32            slice_begin,
+    const uint32            slice_end,
+    const uint64            chunk_offset)
+{
+    const uint32 n_queries = slice_end - slice_begin;
+
+    Timer timer;
+    timer.start();
+
+    // extract the q-grams of the slice, and sort them together with their positions
+    state.qgrams.resize( n_queries );
+    state.indices.resize( n_queries );
+
+    thrust::copy(
+        thrust::make_counting_iterator<uint32>( slice_begin ),
+        thrust::make_counting_iterator<uint32>( slice_begin ) + n_queries,
+        state.indices.begin() );
+
+    generate_qgrams(
+        m_qgram_index.Q,
+        m_qgram_index.symbol_size,
+        genome_len,
+        genome,
+        n_queries,
+        state.indices.begin(),
+        state.qgrams.begin() );
+
+    thrust::sort_by_key( state.qgrams.begin(), state.qgrams.end(), state.indices.begin() );
+
+    timer.stop();
+    state.stats.extract_time += timer.seconds();
+    state.stats.queries      += n_queries;
+
+    // rank them against the read index
+    timer.start();
+
+    const uint64 n_hits = state.filter.rank(
+        m_qgram_index,
+        n_queries,
+        nvbio::raw_pointer( state.qgrams ),
+        nvbio::raw_pointer( state.indices ) );
+
+    timer.stop();
+    state.stats.rank_time   += timer.seconds();
+    state.stats.occurrences += n_hits;
+
+    if (n_hits == 0)
+        return;
+
+    const read_access_type     reads_access( nvbio::plain_view( *m_reads ) );
+    const read_string_set_type reads = reads_access.sequence_string_set();
+
+    const uint32 batch_size = uint32( nvbio::min( n_hits, uint64( params.hits_batch_size ) ) );
+
+    state.hits.resize( batch_size );
+    state.merged_hits.resize( batch_size );
+    state.merged_counts.resize( batch_size );
+    state.packed_hits.resize( batch_size );
+    state.out_reads.resize( batch_size );
+    state.out_hits.resize( batch_size );
+
+    // loop through large batches of hits and locate, merge & verify them
+    for (uint64 hits_begin = 0; hits_begin < n_hits; hits_begin += batch_size)
+    {
+        const uint32 n_batch = uint32( nvbio::min( hits_begin + batch_size, n_hits ) - hits_begin );
+
+        timer.start();
+
+        state.filter.locate(
+            hits_begin,
+            hits_begin + n_batch,
+            state.hits.begin() );
+
+        // merge the hits by diagonal, sorting them by read
+        const uint32 n_merged = state.filter.merge(
+            params.merge_intv,
+            n_batch,
+            state.hits.begin(),
+            state.merged_hits.begin(),
+            state.merged_counts.begin() );
+
+        timer.stop();
+        state.stats.locate_time += timer.seconds();
+        state.stats.merged      += n_merged;
+
+        timer.start();
+
+        // align each read against the band around its diagonal
+        for (uint32 i = 0; i < n_merged; ++i)
+        {
+            const diagonal_type diagonal = state.merged_hits[i];
+            const uint32        read_id  = diagonal.y;
+
+            // diagonals starting before the chunk wrap around: clamp them to its beginning
+            const uint32 text_pos = diagonal.x < genome_len ? diagonal.x : 0u;
+            const uint32 read_len = reads[ read_id ].length();
+
+            // compute the segment of text to align to
+            const uint32 genome_begin = text_pos > BAND_LEN/2 ? text_pos - BAND_LEN/2 : 0u;
+            const uint32 genome_end   = nvbio::min( genome_begin + read_len + BAND_LEN, genome_len );
+
+            aln::BestSink<int16> sink;
+            aln::banded_alignment_score<BAND_LEN>(
+                aln::make_edit_distance_aligner<aln::SEMI_GLOBAL, aln::MyersTag<5u> >(),
+                reads[ read_id ],
+                make_infix( genome, make_uint2( genome_begin, genome_end ) ),
+                Field_traits<int32>::min(),
+                sink );
+
+            state.packed_hits[i] = sink.score > Field_traits<int16>::min() ?
+                priv::qmap_pack_hit( sink.score, chunk_offset + text_pos, read_id & 1u ) :
+                uint64(0);
+        }
+
+        // compute the best hit of each read pair in this batch: the diagonals are sorted
+        // by read, so that each read pair appears in at most one run
+        const uint32 n_reads = uint32( thrust::reduce_by_key(
+            thrust::make_transform_iterator( state.merged_hits.begin(), priv::qmap_diagonal_to_read() ),
+            thrust::make_transform_iterator( state.merged_hits.begin(), priv::qmap_diagonal_to_read() ) + n_merged,
+            state.packed_hits.begin(),
+            state.out_reads.begin(),
+            state.out_hits.begin(),
+            thrust::equal_to<uint32>(),
+            thrust::maximum<uint64>() ).first - state.out_reads.begin() );
+
+        // and fold them into the global best
+        for (uint32 i = 0; i < n_reads; ++i)
+            priv::qmap_atomic_max( nvbio::raw_pointer( m_best ) + state.out_reads[i], state.out_hits[i] );
+
+        timer.stop();
+        state.stats.align_time += timer.seconds();
+    }
+}
+
+// return the best hit of each forward/reverse-complemented read pair
+//
+template <uint32 BAND_LEN>
+void QMapper<BAND_LEN>::best_hits(nvbio::vector<host_tag,QMapHit>& hits) const
+{
+    hits.resize( m_best.size() );
+
+    #pragma omp parallel for
+    for (int32 i = 0; i < int32( m_best.size() ); ++i)
+        hits[i] = priv::qmap_unpack_hit( m_best[i] );
+}
+
+// return the mapping statistics
+//
+template <uint32 BAND_LEN>
+QMapStats QMapper<BAND_LEN>::stats() const
+{
+    QMapStats r = m_stats;
+    for (uint32 i = 0; i < uint32( m_threads.size() ); ++i)
+        r += m_threads[i].stats;
+
+    return r;
+}
+
+} // namespace nvbio
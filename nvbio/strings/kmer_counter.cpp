@@ -0,0 +1,438 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <nvbio/strings/kmer_counter.h>
+#include <nvbio/basic/primitives.h>
+#include <nvbio/basic/exceptions.h>
+#include <nvbio/basic/console.h>
+#include <nvbio/basic/omp.h>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace nvbio {
+
+namespace {
+
+// the header of a k-mer count table file, followed by the sorted k-mers (uint64)
+// and their counts (uint32)
+//
+struct KmerCountTableInfo
+{
+    char    magic[4];
+    uint32  K;
+    uint64  n_kmers;
+    uint64  reserved;
+};
+
+// write a block of data, throwing on failure
+//
+void write_block(FILE* file, const void* data, const uint64 size, const char* file_name)
+{
+    if (size && fwrite( data, 1u, size, file ) != size)
+        throw runtime_error( "KmerCounter: failed writing \"%s\"", file_name );
+}
+
+// seek to an absolute 64-bit file offset
+//
+int seek_file(FILE* file, const uint64 offset)
+{
+#ifdef WIN32
+    return _fseeki64( file, int64( offset ), SEEK_SET );
+#else
+    return fseeko( file, off_t( offset ), SEEK_SET );
+#endif
+}
+
+// a FILE handle closed when going out of scope, so that no error path can leak it
+//
+struct ScopedFile
+{
+    explicit ScopedFile(FILE* _file) : file( _file ) {}
+    ~ScopedFile() { close(); }
+
+    void close()
+    {
+        if (file)
+            fclose( file );
+        file = NULL;
+    }
+
+    FILE* file;
+
+private:
+    ScopedFile(const ScopedFile&);
+    ScopedFile& operator=(const ScopedFile&);
+};
+
+} // anonymous namespace
+
+// constructor
+//
+KmerCounter::KmerCounter(
+    const uint32    K,
+    const uint64    memory_budget,
+    const char*     temp_dir,
+    const uint32    n_buckets,
+    const uint32    minimizer_len) :
+    m_K( K ),
+    m_M( nvbio::max( nvbio::min( minimizer_len, K ), 1u ) ),
+    m_n_buckets( n_buckets ),
+    m_budget( memory_budget ),
+    m_n_kmers( 0 ),
+    m_n_buffered( 0 ),
+    m_n_spilled( 0 ),
+    m_buckets( n_buckets ),
+    m_spilled( n_buckets, 0u ),
+    m_thread_buckets( omp_get_max_threads(), std::vector< std::vector<uint64> >( n_buckets ) )
+{
+    if (K == 0u || K > 32u)
+        throw runtime_error( "KmerCounter: unsupported k-mer length %u", K );
+
+    // build a unique prefix for the temporary files of this counter
+    char suffix[64];
+    sprintf( suffix, "/nvbio-kmers-%u-%p", uint32( getpid() ), (void*)this );
+    m_temp_prefix = std::string( temp_dir ) + std::string( suffix );
+}
+
+// destructor
+//
+KmerCounter::~KmerCounter()
+{
+    for (uint32 b = 0; b < m_n_buckets; ++b)
+    {
+        if (m_spilled[b])
+            remove( bucket_file_name( b ).c_str() );
+    }
+}
+
+// the name of the temporary file of a bucket
+//
+std::string KmerCounter::bucket_file_name(const uint32 b) const
+{
+    char suffix[32];
+    sprintf( suffix, ".%u.tmp", b );
+    return m_temp_prefix + std::string( suffix );
+}
+
+// return the bucket of a given canonical k-mer
+//
+uint32 KmerCounter::bucket(const uint64 kmer) const
+{
+    const uint64 mmask = m_M >= 32u ? uint64(-1) : (uint64(1u) << (2u*m_M)) - 1u;
+
+    // find the smallest hash among the canonical m-mers of the k-mer
+    uint64 min_hash = uint64(-1);
+    for (uint32 p = 0; p + m_M <= m_K; ++p)
+    {
+        const uint64 mmer = (kmer >> (2u*(m_K - m_M - p))) & mmask;
+        min_hash = nvbio::min( min_hash, kmer_hash( kmer_canonical( mmer, m_M ) ) );
+    }
+    return uint32( min_hash % m_n_buckets );
+}
+
+// move the per-thread buffers to the shared buckets, spilling them if needed
+//
+void KmerCounter::merge_thread_buffers()
+{
+    const uint32 n_threads = uint32( m_thread_buckets.size() );
+
+    uint64 n_new = 0u;
+    for (uint32 t = 0; t < n_threads; ++t)
+        for (uint32 b = 0; b < m_n_buckets; ++b)
+            n_new += m_thread_buckets[t][b].size();
+
+    #pragma omp parallel for
+    for (int32 b = 0; b < int32( m_n_buckets ); ++b)
+    {
+        for (uint32 t = 0; t < n_threads; ++t)
+        {
+            std::vector<uint64>& src = m_thread_buckets[t][b];
+            m_buckets[b].insert( m_buckets[b].end(), src.begin(), src.end() );
+            src.clear();
+        }
+    }
+
+    m_n_kmers    += n_new;
+    m_n_buffered += n_new;
+
+    if (m_n_buffered * sizeof(uint64) > m_budget)
+        spill();
+}
+
+// append all the in-memory buckets to their temporary files
+//
+void KmerCounter::spill()
+{
+    for (uint32 b = 0; b < m_n_buckets; ++b)
+    {
+        std::vector<uint64>& bucket = m_buckets[b];
+        if (bucket.empty())
+            continue;
+
+        const std::string file_name = bucket_file_name( b );
+
+        ScopedFile file( fopen( file_name.c_str(), "ab" ) );
+        if (file.file == NULL)
+            throw runtime_error( "KmerCounter: unable to open \"%s\"", file_name.c_str() );
+
+        write_block( file.file, &bucket[0], bucket.size() * sizeof(uint64), file_name.c_str() );
+        file.close();
+
+        m_spilled[b] += bucket.size();
+        m_n_spilled  += bucket.size();
+
+        // release the bucket memory
+        std::vector<uint64>().swap( bucket );
+    }
+    log_verbose(stderr, "  spilled %.1f M k-mers\n", 1.0e-6f * float( m_n_buffered ));
+
+    m_n_buffered = 0u;
+}
+
+// load a bucket from its temporary file and from memory
+//
+void KmerCounter::load_bucket(const uint32 b, std::vector<uint64>& kmers)
+{
+    std::vector<uint64>& bucket = m_buckets[b];
+
+    kmers.resize( m_spilled[b] + bucket.size() );
+
+    if (m_spilled[b])
+    {
+        const std::string file_name = bucket_file_name( b );
+
+        ScopedFile file( fopen( file_name.c_str(), "rb" ) );
+        if (file.file == NULL)
+            throw runtime_error( "KmerCounter: unable to open \"%s\"", file_name.c_str() );
+
+        const uint64 n_read = fread( &kmers[0], sizeof(uint64), m_spilled[b], file.file );
+        file.close();
+
+        if (n_read != m_spilled[b])
+            throw runtime_error( "KmerCounter: failed reading \"%s\"", file_name.c_str() );
+
+        remove( file_name.c_str() );
+        m_spilled[b] = 0u;
+    }
+
+    std::copy( bucket.begin(), bucket.end(), kmers.end() - bucket.size() );
+    std::vector<uint64>().swap( bucket );
+}
+
+// count all the added k-mers, and write the resulting table
+//
+uint64 KmerCounter::finalize(const char* output_name, const uint32 min_count)
+{
+    const std::string runs_name = m_temp_prefix + ".runs";
+
+    ScopedFile runs_file( fopen( runs_name.c_str(), "wb" ) );
+    if (runs_file.file == NULL)
+        throw runtime_error( "KmerCounter: unable to open \"%s\"", runs_name.c_str() );
+
+    // count each bucket, writing its sorted k-mers and counts to the runs file
+    std::vector<uint64> run_offsets( m_n_buckets );
+    std::vector<uint64> run_sizes( m_n_buckets );
+    uint64              run_offset = 0u;
+
+    nvbio::vector<host_tag,uint8>  temp_storage;
+    nvbio::vector<host_tag,uint64> unique_kmers;
+    nvbio::vector<host_tag,uint32> counts;
+    std::vector<uint64>            kmers;
+
+    for (uint32 b = 0; b < m_n_buckets; ++b)
+    {
+        load_bucket( b, kmers );
+
+        if (kmers.size() >= uint64(1u) << 32)
+            throw runtime_error( "KmerCounter: bucket %u is too large, increase the number of buckets", b );
+
+        const uint32 n = uint32( kmers.size() );
+
+        uint32 n_unique = 0u;
+        if (n)
+        {
+            radix_sort<host_tag>( n, &kmers[0], temp_storage );
+
+            unique_kmers.resize( n );
+            counts.resize( n );
+
+            n_unique = runlength_encode<host_tag>(
+                n,
+                &kmers[0],
+                unique_kmers.begin(),
+                counts.begin(),
+                temp_storage );
+
+            // drop the k-mers below the minimum count
+            if (min_count > 1u)
+            {
+                uint32 n_kept = 0u;
+                for (uint32 i = 0; i < n_unique; ++i)
+                {
+                    if (counts[i] >= min_count)
+                    {
+                        unique_kmers[ n_kept ] = unique_kmers[i];
+                        counts[ n_kept ]       = counts[i];
+                        ++n_kept;
+                    }
+                }
+                n_unique = n_kept;
+            }
+
+            write_block( runs_file.file, nvbio::raw_pointer( unique_kmers ), uint64( n_unique ) * sizeof(uint64), runs_name.c_str() );
+            write_block( runs_file.file, nvbio::raw_pointer( counts ),       uint64( n_unique ) * sizeof(uint32), runs_name.c_str() );
+
+            // keep the runs 8-byte aligned
+            if (n_unique & 1u)
+            {
+                const uint32 pad = 0u;
+                write_block( runs_file.file, &pad, sizeof(uint32), runs_name.c_str() );
+            }
+        }
+
+        run_offsets[b] = run_offset;
+        run_sizes[b]   = n_unique;
+        run_offset    += uint64( n_unique ) * (sizeof(uint64) + sizeof(uint32)) + (n_unique & 1u) * sizeof(uint32);
+    }
+    runs_file.close();
+
+    m_n_buffered = 0u;
+
+    uint64 n_total = 0u;
+    for (uint32 b = 0; b < m_n_buckets; ++b)
+        n_total += run_sizes[b];
+
+    // open the output table twice, so that a single merge pass can write the k-mers and the counts
+    // sections side by side
+    ScopedFile kmers_file( fopen( output_name, "wb" ) );
+    if (kmers_file.file == NULL)
+        throw runtime_error( "KmerCounter: unable to open \"%s\"", output_name );
+
+    KmerCountTableInfo info;
+    memcpy( info.magic, "KCNT", 4u );
+    info.K        = m_K;
+    info.n_kmers  = n_total;
+    info.reserved = 0u;
+    write_block( kmers_file.file, &info, sizeof(info), output_name );
+    fflush( kmers_file.file );
+
+    ScopedFile counts_file( fopen( output_name, "r+b" ) );
+    if (counts_file.file == NULL || seek_file( counts_file.file, sizeof(info) + n_total * sizeof(uint64) ) != 0)
+        throw runtime_error( "KmerCounter: unable to open \"%s\"", output_name );
+
+    // merge the sorted runs
+    if (n_total)
+    {
+        DiskMappedFile runs;
+        const uint8* runs_data = (const uint8*)runs.init( runs_name.c_str() );
+
+        typedef std::pair<uint64,uint32> heap_entry;   // (k-mer, bucket)
+        std::priority_queue< heap_entry, std::vector<heap_entry>, std::greater<heap_entry> > heap;
+
+        std::vector<uint64> run_pos( m_n_buckets, 0u );
+        for (uint32 b = 0; b < m_n_buckets; ++b)
+        {
+            if (run_sizes[b])
+                heap.push( heap_entry( *reinterpret_cast<const uint64*>( runs_data + run_offsets[b] ), b ) );
+        }
+
+        const uint32 BUFFER_SIZE = 64u*1024u;
+        std::vector<uint64> out_kmers;  out_kmers.reserve( BUFFER_SIZE );
+        std::vector<uint32> out_counts; out_counts.reserve( BUFFER_SIZE );
+
+        while (heap.empty() == false)
+        {
+            const heap_entry top = heap.top(); heap.pop();
+            const uint32     b   = top.second;
+
+            const uint64* run_kmers  = reinterpret_cast<const uint64*>( runs_data + run_offsets[b] );
+            const uint32* run_counts = reinterpret_cast<const uint32*>( run_kmers + run_sizes[b] );
+
+            out_kmers.push_back( top.first );
+            out_counts.push_back( run_counts[ run_pos[b] ] );
+
+            if (++run_pos[b] < run_sizes[b])
+                heap.push( heap_entry( run_kmers[ run_pos[b] ], b ) );
+
+            if (out_kmers.size() == BUFFER_SIZE || heap.empty())
+            {
+                write_block( kmers_file.file,  &out_kmers[0],  out_kmers.size()  * sizeof(uint64), output_name );
+                write_block( counts_file.file, &out_counts[0], out_counts.size() * sizeof(uint32), output_name );
+                out_kmers.clear();
+                out_counts.clear();
+            }
+        }
+    }
+    kmers_file.close();
+    counts_file.close();
+
+    remove( runs_name.c_str() );
+    return n_total;
+}
+
+// map a k-mer table file
+//
+void KmerCountTable::load(const char* file_name)
+{
+    const uint8* data = (const uint8*)m_file.init( file_name );
+    if (m_file.size() < sizeof(KmerCountTableInfo))
+        throw runtime_error( "\"%s\": not a k-mer table", file_name );
+
+    const KmerCountTableInfo* info = reinterpret_cast<const KmerCountTableInfo*>( data );
+    if (strncmp( info->magic, "KCNT", 4u ) != 0)
+        throw runtime_error( "\"%s\": not a k-mer table", file_name );
+
+    if (m_file.size() < sizeof(KmerCountTableInfo) + info->n_kmers * (sizeof(uint64) + sizeof(uint32)))
+        throw runtime_error( "\"%s\": truncated k-mer table", file_name );
+
+    m_K      = info->K;
+    m_size   = info->n_kmers;
+    m_kmers  = reinterpret_cast<const uint64*>( data + sizeof(KmerCountTableInfo) );
+    m_counts = reinterpret_cast<const uint32*>( m_kmers + m_size );
+}
+
+// return the count of a given k-mer
+//
+uint32 KmerCountTable::count(const uint64 kmer) const
+{
+    const uint64 key = kmer_canonical( kmer, m_K );
+
+    const uint64* it = std::lower_bound( m_kmers, m_kmers + m_size, key );
+    return (it != m_kmers + m_size && *it == key) ? m_counts[ it - m_kmers ] : 0u;
+}
+
+} // namespace nvbio
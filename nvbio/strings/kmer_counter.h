@@ -0,0 +1,205 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/mmap.h>
+#include <nvbio/strings/kmers.h>
+#include <vector>
+#include <string>
+
+namespace nvbio {
+
+///@addtogroup Strings
+///@{
+
+///@addtogroup KmersModule
+///@{
+
+///
+/// An exact, host-side counter of canonical 2-bit DNA k-mers with bounded memory usage.
+///\par
+/// K-mers are partitioned into buckets by the hash of their <i>minimizer</i>, i.e. their smallest
+/// canonical M-mer, so that all occurrences of a k-mer (on either strand) end up in the same
+/// bucket. Buckets are buffered in memory and appended to temporary files whenever the buffered
+/// k-mers exceed the memory budget. Once all the input has been added, finalize() counts
+/// each bucket separately with a parallel radix sort followed by a run-length encoding, and
+/// merges the sorted buckets into a single KmerCountTable file, sorted by k-mer.
+///\par
+/// K-mers containing symbols greater than 3 (e.g. N's) are skipped.
+///
+///\code
+/// KmerCounter counter( 31u, 4ull*1024*1024*1024, "/tmp" );
+///
+/// while (read_batch( &string_set ))
+///     counter.add( string_set );
+///
+/// counter.finalize( "reads.kcnt", 2u );   // drop singletons
+///
+/// KmerCountTable table;
+/// table.load( "reads.kcnt" );
+/// const uint32 count = table.count( kmer );
+///\endcode
+///
+struct KmerCounter
+{
+    static const uint32 DEFAULT_BUCKETS       = 512u;
+    static const uint32 DEFAULT_MINIMIZER_LEN = 11u;
+
+    /// constructor
+    ///
+    /// \param K                the k-mer length, K <= 32
+    /// \param memory_budget    the maximum amount of memory used to buffer k-mers, in bytes
+    /// \param temp_dir         the directory where buckets are spilled
+    /// \param n_buckets        the number of buckets
+    /// \param minimizer_len    the length of the minimizers used for partitioning, clamped to K
+    ///
+    KmerCounter(
+        const uint32    K,
+        const uint64    memory_budget   = 4ull*1024ull*1024ull*1024ull,
+        const char*     temp_dir        = ".",
+        const uint32    n_buckets       = DEFAULT_BUCKETS,
+        const uint32    minimizer_len   = DEFAULT_MINIMIZER_LEN);
+
+    /// destructor: remove all temporary files
+    ///
+    ~KmerCounter();
+
+    /// add all the k-mers of a host string-set, processing the strings in parallel;
+    /// this can be called repeatedly, e.g. once per batch of reads
+    ///
+    template <typename string_set_type>
+    void add(const string_set_type& string_set);
+
+    /// count all the added k-mers, and write the resulting table to a file which can be
+    /// later mapped by KmerCountTable
+    ///
+    /// \param output_name      the output table file name
+    /// \param min_count        the minimum count of the k-mers to output
+    ///
+    /// \return                 the number of distinct k-mers written to the table
+    ///
+    uint64 finalize(const char* output_name, const uint32 min_count = 1u);
+
+    /// return the k-mer length
+    ///
+    uint32 k() const { return m_K; }
+
+    /// return the total number of k-mers added so far
+    ///
+    uint64 n_kmers() const { return m_n_kmers; }
+
+    /// return the total number of k-mers spilled to disk so far
+    ///
+    uint64 n_spilled() const { return m_n_spilled; }
+
+    /// return the bucket of a given canonical k-mer
+    ///
+    uint32 bucket(const uint64 kmer) const;
+
+private:
+    KmerCounter(const KmerCounter&);
+    KmerCounter& operator=(const KmerCounter&);
+
+    // partition the k-mers of a string into the given bucket buffers
+    template <typename string_type>
+    void add_string(const string_type& string, std::vector<uint64>* buckets, std::vector<uint64>& mmer_hashes, std::vector<uint32>& mmer_pos) const;
+
+    // move the per-thread buffers to the shared buckets, spilling them if needed
+    void merge_thread_buffers();
+
+    // append all the in-memory buckets to their temporary files
+    void spill();
+
+    // load a bucket from its temporary file and from memory
+    void load_bucket(const uint32 b, std::vector<uint64>& kmers);
+
+    // the name of the temporary file of a bucket
+    std::string bucket_file_name(const uint32 b) const;
+
+    uint32                                          m_K;
+    uint32                                          m_M;
+    uint32                                          m_n_buckets;
+    uint64                                          m_budget;
+    std::string                                     m_temp_prefix;
+    uint64                                          m_n_kmers;
+    uint64                                          m_n_buffered;
+    uint64                                          m_n_spilled;
+    std::vector< std::vector<uint64> >              m_buckets;
+    std::vector<uint64>                             m_spilled;
+    std::vector< std::vector< std::vector<uint64> > > m_thread_buckets;
+};
+
+///
+/// A read-only table of sorted k-mers and their counts, backed by a memory mapped
+/// file written by KmerCounter::finalize().
+///
+struct KmerCountTable
+{
+    /// constructor
+    ///
+    KmerCountTable() : m_K( 0 ), m_size( 0 ), m_kmers( NULL ), m_counts( NULL ) {}
+
+    /// map a k-mer table file; throws a runtime_error on malformed files
+    ///
+    void load(const char* file_name);
+
+    /// return the k-mer length
+    ///
+    uint32 k() const { return m_K; }
+
+    /// return the number of distinct k-mers
+    ///
+    uint64 size() const { return m_size; }
+
+    /// return the sorted canonical k-mers
+    ///
+    const uint64* kmers() const { return m_kmers; }
+
+    /// return the k-mer counts
+    ///
+    const uint32* counts() const { return m_counts; }
+
+    /// return the count of a given k-mer (on either strand), or 0 if not present
+    ///
+    uint32 count(const uint64 kmer) const;
+
+private:
+    DiskMappedFile  m_file;
+    uint32          m_K;
+    uint64          m_size;
+    const uint64*   m_kmers;
+    const uint32*   m_counts;
+};
+
+///@} KmersModule
+///@} Strings
+
+} // namespace nvbio
+
+#include <nvbio/strings/kmer_counter_inl.h>
@@ -0,0 +1,127 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/basic/omp.h>
+
+namespace nvbio {
+
+// add all the k-mers of a host string-set
+//
+template <typename string_set_type>
+void KmerCounter::add(const string_set_type& string_set)
+{
+    // process the strings in batches, so as to bound the size of the per-thread buffers
+    const uint32 BATCH_SIZE = 64u*1024u;
+
+    const uint32 n_strings = string_set.size();
+
+    for (uint32 batch_begin = 0; batch_begin < n_strings; batch_begin += BATCH_SIZE)
+    {
+        const uint32 batch_end = nvbio::min( batch_begin + BATCH_SIZE, n_strings );
+
+        #pragma omp parallel
+        {
+            std::vector<uint64>* buckets = &m_thread_buckets[ omp_get_thread_num() ][0];
+
+            std::vector<uint64> mmer_hashes;
+            std::vector<uint32> mmer_pos;
+
+            #pragma omp for schedule(dynamic,64)
+            for (int32 i = int32( batch_begin ); i < int32( batch_end ); ++i)
+                add_string( string_set[i], buckets, mmer_hashes, mmer_pos );
+        }
+
+        merge_thread_buffers();
+    }
+}
+
+// partition the k-mers of a string into the given bucket buffers
+//
+template <typename string_type>
+void KmerCounter::add_string(
+    const string_type&      string,
+    std::vector<uint64>*    buckets,
+    std::vector<uint64>&    mmer_hashes,
+    std::vector<uint32>&    mmer_pos) const
+{
+    const uint32 len = length( string );
+    if (len < m_K)
+        return;
+
+    const uint32 K = m_K;
+    const uint32 M = m_M;
+
+    // roll the canonical k-mers and the hashes of the canonical m-mers side by side, so that
+    // the m-mer number p and the k-mer number p - (K-M) end at the same symbol
+    priv::kmer_roller<string_type> kmers( K, KMER_CANONICAL, string );
+    priv::kmer_roller<string_type> mmers( M, KMER_CANONICAL | KMER_HASHED, string );
+
+    // keep the hashes of the canonical m-mers of the current k-mer in a monotone circular deque,
+    // whose front is the minimizer; it holds at most K-M+2 entries before popping the m-mer
+    // falling off the current k-mer
+    const uint32 W = K - M + 2u;
+    mmer_hashes.resize( W );
+    mmer_pos.resize( W );
+    uint32 dq_head = 0u;
+    uint32 dq_size = 0u;
+
+    const uint32 n_mmers = len - M + 1u;
+
+    for (uint32 p = 0; p < n_mmers; ++p)
+    {
+        // push the m-mer starting at p, marking invalid m-mers with the largest hash
+        const uint64 mmer_hash = mmers.next();
+        const uint64 h = mmers.is_valid() ? mmer_hash : uint64(-1);
+
+        while (dq_size && mmer_hashes[ (dq_head + dq_size - 1u) % W ] > h)
+            --dq_size;
+
+        const uint32 slot = (dq_head + dq_size) % W;
+        mmer_hashes[ slot ] = h;
+        mmer_pos[ slot ]    = p;
+        ++dq_size;
+
+        if (p + M >= K)
+        {
+            // pop the m-mers preceding the k-mer starting at s
+            const uint32 s = p + M - K;
+            while (mmer_pos[ dq_head ] < s)
+            {
+                dq_head = (dq_head + 1u) % W;
+                --dq_size;
+            }
+
+            const uint64 kmer = kmers.next();
+            if (kmers.is_valid())
+                buckets[ uint32( mmer_hashes[ dq_head ] % m_n_buckets ) ].push_back( kmer );
+        }
+    }
+}
+
+} // namespace nvbio
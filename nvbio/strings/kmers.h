@@ -0,0 +1,245 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/basic/packedstream.h>
+#include <nvbio/basic/vector_view.h>
+#include <nvbio/basic/vector.h>
+#include <nvbio/strings/string_traits.h>
+
+namespace nvbio {
+
+///@addtogroup Strings
+///@{
+
+///\defgroup KmersModule K-mers
+///\par
+/// This module provides a common facility to extract k-mers out of strings and string-sets,
+/// shared by the q-gram indices, the k-mer counters and the error correction tools:
+///\par
+/// - load_kmer() gathers the k-mer starting at an arbitrary position of a string, shifting
+///   whole words out of packed streams rather than fetching one symbol at a time;
+/// - RollingKmer maintains a 2-bit DNA k-mer over a stream of symbols, keeping track of
+///   invalid (i.e. N) symbols;
+/// - reverse_symbols(), kmer_reverse_complement() and kmer_canonical() operate on all the
+///   symbols of a k-mer code at once with a few word-wide bit operations;
+/// - extract_kmers() and extract_minimizers() stream all the (canonical, hashed) k-mers or
+///   the minimizers of a host string-set, in parallel across strings.
+///\par
+/// Unless otherwise noted, k-mer codes are <i>MSB-first</i>, i.e. the first symbol of the k-mer
+/// occupies the most significant bits of the code, so that codes sort lexicographically.
+/// Q-grams use the opposite, <i>LSB-first</i> convention.
+///@{
+
+/// reverse the order of the first K symbols of a packed code, with all symbols
+/// swapped at once through word-wide bit operations when the symbol size is a power of 2
+///
+/// \tparam SYMBOL_SIZE     the symbol size, in bits
+///
+/// \param code             the input code, holding K symbols in its least significant bits
+/// \param K                the number of symbols, K * SYMBOL_SIZE <= 64
+///
+template <uint32 SYMBOL_SIZE>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 reverse_symbols(const uint64 code, const uint32 K);
+
+/// return the reverse-complement of a 2-bit DNA k-mer (either MSB-first or LSB-first)
+///
+/// \param kmer             the input k-mer
+/// \param K                the k-mer length, K <= 32
+///
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 kmer_reverse_complement(const uint64 kmer, const uint32 K);
+
+/// return the canonical representative of a 2-bit DNA k-mer, i.e. the smallest
+/// between the k-mer and its reverse-complement
+///
+/// \param kmer             the input k-mer
+/// \param K                the k-mer length, K <= 32
+///
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 kmer_canonical(const uint64 kmer, const uint32 K);
+
+/// return the hash of a k-mer code
+///
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 kmer_hash(const uint64 kmer) { return hash( kmer ); }
+
+/// load the K symbols starting at position pos of a string into a k-mer code, padding
+/// the symbols past the end of the string with zeros.
+/// Packed streams of 32-bit words whose symbol size matches the requested one are
+/// read a word at a time.
+///
+/// \tparam LSB_FIRST       if true, the first symbol is stored in the least significant bits
+///                         of the code (i.e. the q-gram convention), otherwise in the most
+///                         significant ones
+/// \tparam string_type     the string type
+///
+/// \param string           the input string
+/// \param string_len       the string length
+/// \param pos              the position of the first symbol of the k-mer
+/// \param K                the k-mer length, K * symbol_size <= 64
+/// \param symbol_size      the symbol size, in bits
+///
+template <bool LSB_FIRST, typename string_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 load_kmer(
+    const string_type   string,
+    const uint32        string_len,
+    const uint32        pos,
+    const uint32        K,
+    const uint32        symbol_size);
+
+///
+/// A 2-bit DNA k-mer rolling over a stream of symbols, where symbols greater than 3
+/// (e.g. N's) invalidate all the k-mers containing them.
+/// The k-mer is MSB-first, i.e. push_back() shifts the new symbol in from the right.
+///
+struct RollingKmer
+{
+    /// empty constructor
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    RollingKmer() : mask(0), code(0), len(0), invalid(-1) {}
+
+    /// constructor
+    ///
+    /// \param l        the k-mer length, l <= 32
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    RollingKmer(const int l) :
+        mask( l >= 32 ? uint64(-1) : (uint64(1u) << (2u*l)) - 1u ),
+        code(0),
+        len(l),
+        invalid(-1) {}
+
+    /// reset the k-mer
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void restart() { code = 0ull; invalid = -1; }
+
+    /// shift a symbol in from the right, dropping the first one
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void push_back(const uint8 c);
+
+    /// shift a symbol in from the left, dropping the last one
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void push_front(const uint8 c);
+
+    /// drop the last k symbols, shifting in k empty ones from the left
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    void shift_right(int k);
+
+    /// return whether the k-mer contains only valid symbols
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    bool is_valid() const { return invalid == -1; }
+
+    /// return the reverse-complement of this k-mer
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint64 reverse_complement() const { return kmer_reverse_complement( code, len ); }
+
+    /// return the canonical representative of this k-mer
+    ///
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    uint64 canonical() const { return kmer_canonical( code, len ); }
+
+    uint64 mask;        ///< the k-mer mask
+    uint64 code;        ///< the k-mer code
+    int    len;         ///< the k-mer length
+    int    invalid;     ///< the position of the last invalid symbol, or -1
+};
+
+/// k-mer extraction flags
+///
+enum KmerFlags
+{
+    KMER_FORWARD    = 0u,   ///< output the k-mers as they appear in the strings
+    KMER_CANONICAL  = 1u,   ///< output canonical k-mers
+    KMER_HASHED     = 2u,   ///< output the k-mer hashes instead of the k-mers
+};
+
+/// extract all the 2-bit DNA k-mers of a host string-set, together with their
+/// string-set coordinates, processing the strings in parallel; each string is
+/// scanned once, rolling both the forward and the reverse-complemented k-mers.
+/// Symbols are masked to their 2 least significant bits.
+///
+/// \tparam string_set_type     the string-set type
+///
+/// \param K                    the k-mer length, K <= 32
+/// \param string_set           the input string-set
+/// \param flags                a combination of KmerFlags
+/// \param kmers                the output k-mers (or hashes)
+/// \param coords               the output (string-id, position) coordinates
+///
+/// \return                     the number of extracted k-mers
+///
+template <typename string_set_type>
+uint64 extract_kmers(
+    const uint32                        K,
+    const string_set_type&              string_set,
+    const uint32                        flags,
+    nvbio::vector<host_tag,uint64>&     kmers,
+    nvbio::vector<host_tag,uint2>&      coords);
+
+/// extract the (w,k)-minimizers of a host string-set, i.e. for each window of W consecutive
+/// k-mers the k-mer with the smallest hash (the rightmost one in case of ties), discarding
+/// consecutive repetitions of the same minimizer; the strings are processed in parallel.
+///
+/// \tparam string_set_type     the string-set type
+///
+/// \param K                    the k-mer length, K <= 32
+/// \param W                    the window size, in k-mers
+/// \param string_set           the input string-set
+/// \param flags                a combination of KmerFlags
+/// \param kmers                the output minimizers (or their hashes)
+/// \param coords               the output (string-id, position) coordinates
+///
+/// \return                     the number of extracted minimizers
+///
+template <typename string_set_type>
+uint64 extract_minimizers(
+    const uint32                        K,
+    const uint32                        W,
+    const string_set_type&              string_set,
+    const uint32                        flags,
+    nvbio::vector<host_tag,uint64>&     kmers,
+    nvbio::vector<host_tag,uint2>&      coords);
+
+///@} KmersModule
+///@} Strings
+
+} // namespace nvbio
+
+#include <nvbio/strings/kmers_inl.h>
@@ -0,0 +1,538 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/basic/omp.h>
+#include <nvbio/basic/exceptions.h>
+#include <vector>
+
+namespace nvbio {
+
+// reverse the order of the first K symbols of a packed code
+//
+template <uint32 SYMBOL_SIZE>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 reverse_symbols(const uint64 code, const uint32 K)
+{
+    if (K == 0u)
+        return 0u;
+
+    if (is_pow2<SYMBOL_SIZE>() && SYMBOL_SIZE <= 32u)
+    {
+        // reverse the whole word one level of granularity at a time, starting
+        // from the symbol size: the K symbols end up in the most significant bits
+        uint64 x = code;
+        if (SYMBOL_SIZE <= 1u)  x = ((x >> 1)  & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+        if (SYMBOL_SIZE <= 2u)  x = ((x >> 2)  & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+        if (SYMBOL_SIZE <= 4u)  x = ((x >> 4)  & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+        if (SYMBOL_SIZE <= 8u)  x = ((x >> 8)  & 0x00FF00FF00FF00FFull) | ((x & 0x00FF00FF00FF00FFull) << 8);
+        if (SYMBOL_SIZE <= 16u) x = ((x >> 16) & 0x0000FFFF0000FFFFull) | ((x & 0x0000FFFF0000FFFFull) << 16);
+        x = (x >> 32) | (x << 32);
+
+        return x >> (64u - K * SYMBOL_SIZE);
+    }
+    else
+    {
+        const uint64 symbol_mask = (uint64(1u) << SYMBOL_SIZE) - 1u;
+
+        uint64 r = 0u;
+        for (uint32 i = 0; i < K; ++i)
+            r |= ((code >> (i * SYMBOL_SIZE)) & symbol_mask) << ((K - 1u - i) * SYMBOL_SIZE);
+
+        return r;
+    }
+}
+
+// return the reverse-complement of a 2-bit DNA k-mer
+//
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 kmer_reverse_complement(const uint64 kmer, const uint32 K)
+{
+    // complementing a 2-bit symbol amounts to flipping its bits, and the bits
+    // above the k-mer are shifted out by reverse_symbols()
+    return reverse_symbols<2u>( ~kmer, K );
+}
+
+// return the canonical representative of a 2-bit DNA k-mer
+//
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 kmer_canonical(const uint64 kmer, const uint32 K)
+{
+    return nvbio::min( kmer, kmer_reverse_complement( kmer, K ) );
+}
+
+namespace priv {
+
+// load a k-mer one symbol at a time
+//
+template <bool LSB_FIRST, typename string_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 load_kmer_symbols(
+    const string_type   string,
+    const uint32        string_len,
+    const uint32        pos,
+    const uint32        K,
+    const uint32        symbol_size)
+{
+    const uint32 symbol_mask = (1u << symbol_size) - 1u;
+
+    uint64 kmer = 0u;
+    for (uint32 j = 0; j < K; ++j)
+    {
+        const uint64 c = pos + j < string_len ? (string[pos + j] & symbol_mask) : 0u;
+        kmer |= c << ((LSB_FIRST ? j : K - 1u - j) * symbol_size);
+    }
+    return kmer;
+}
+
+// load a k-mer shifting it out of the packed words of a stream: the primary template
+// handles the word types without a word-level path
+//
+template <uint32 WORD_SIZE, uint32 SYMBOL_SIZE, bool BIG_ENDIAN>
+struct packed_kmer_window
+{
+    static const bool supported = false;
+
+    template <bool LSB_FIRST, typename word_iterator>
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    static uint64 load(const word_iterator words, const uint64 sym_idx, const uint32 K) { return 0u; }
+};
+
+// load a k-mer shifting it out of the 32-bit words of a packed stream
+//
+template <uint32 SYMBOL_SIZE, bool BIG_ENDIAN>
+struct packed_kmer_window<4u,SYMBOL_SIZE,BIG_ENDIAN>
+{
+    static const bool supported = true;
+
+    template <bool LSB_FIRST, typename word_iterator>
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    static uint64 load(const word_iterator words, const uint64 sym_idx, const uint32 K)
+    {
+        const uint32 n_bits   = K * SYMBOL_SIZE;
+        const uint64 bit_idx  = sym_idx * SYMBOL_SIZE;
+        const uint64 word_idx = bit_idx >> 5u;
+        const uint32 bit_off  = uint32( bit_idx & 31u );
+        const uint32 n_words  = ((bit_off + n_bits - 1u) >> 5u) + 1u;
+
+        // non power of 2 symbols are always packed in little-endian order
+        if (BIG_ENDIAN && is_pow2<SYMBOL_SIZE>())
+        {
+            // the first symbol is in the most significant bits of the first word
+            uint64 x = uint64( uint32( words[ word_idx ] ) ) << 32;
+            if (n_words > 1u) x |= uint64( uint32( words[ word_idx+1 ] ) );
+            x <<= bit_off;
+            if (n_words > 2u) x |= uint64( uint32( words[ word_idx+2 ] ) ) >> (32u - bit_off);
+
+            const uint64 kmer = x >> (64u - n_bits);
+            return LSB_FIRST ? reverse_symbols<SYMBOL_SIZE>( kmer, K ) : kmer;
+        }
+        else
+        {
+            // the first symbol is in the least significant bits of the first word
+            uint64 x = uint64( uint32( words[ word_idx ] ) );
+            if (n_words > 1u) x |= uint64( uint32( words[ word_idx+1 ] ) ) << 32;
+            x >>= bit_off;
+            if (n_words > 2u) x |= uint64( uint32( words[ word_idx+2 ] ) ) << (64u - bit_off);
+
+            const uint64 kmer = n_bits < 64u ? x & ((uint64(1u) << n_bits) - 1u) : x;
+            return LSB_FIRST ? kmer : reverse_symbols<SYMBOL_SIZE>( kmer, K );
+        }
+    }
+};
+
+// a generic k-mer loader
+//
+template <typename string_type>
+struct kmer_loader
+{
+    template <bool LSB_FIRST>
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    static uint64 load(const string_type string, const uint32 string_len, const uint32 pos, const uint32 K, const uint32 symbol_size)
+    {
+        return load_kmer_symbols<LSB_FIRST>( string, string_len, pos, K, symbol_size );
+    }
+};
+
+// a k-mer loader for packed streams
+//
+template <typename InputStream, typename Symbol, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
+struct kmer_loader< PackedStream<InputStream,Symbol,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType> >
+{
+    typedef PackedStream<InputStream,Symbol,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>            string_type;
+    typedef packed_kmer_window<string_type::WORD_SIZE,SYMBOL_SIZE_T,BIG_ENDIAN_T>           window_type;
+
+    template <bool LSB_FIRST>
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    static uint64 load(const string_type string, const uint32 string_len, const uint32 pos, const uint32 K, const uint32 symbol_size)
+    {
+        // the word-level path needs the whole k-mer to lie within the string
+        if (window_type::supported == false ||
+            symbol_size != SYMBOL_SIZE_T    ||
+            K * SYMBOL_SIZE_T > 64u         ||
+            pos + K > string_len)
+            return load_kmer_symbols<LSB_FIRST>( string, string_len, pos, K, symbol_size );
+
+        return window_type::template load<LSB_FIRST>( string.stream(), uint64( string.index() ) + pos, K );
+    }
+};
+
+// a k-mer loader for vector views, forwarding to the underlying iterator
+//
+template <typename Iterator, typename IndexType>
+struct kmer_loader< vector_view<Iterator,IndexType> >
+{
+    template <bool LSB_FIRST>
+    NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+    static uint64 load(const vector_view<Iterator,IndexType> string, const uint32 string_len, const uint32 pos, const uint32 K, const uint32 symbol_size)
+    {
+        return kmer_loader<Iterator>::template load<LSB_FIRST>( string.base(), string_len, pos, K, symbol_size );
+    }
+};
+
+} // namespace priv
+
+// load the K symbols starting at position pos of a string into a k-mer code
+//
+template <bool LSB_FIRST, typename string_type>
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+uint64 load_kmer(
+    const string_type   string,
+    const uint32        string_len,
+    const uint32        pos,
+    const uint32        K,
+    const uint32        symbol_size)
+{
+    if (K == 0u)
+        return 0u;
+
+    return priv::kmer_loader<string_type>::template load<LSB_FIRST>( string, string_len, pos, K, symbol_size );
+}
+
+// shift a symbol in from the right, dropping the first one
+//
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void RollingKmer::push_back(const uint8 c)
+{
+    if (invalid != -1)
+        invalid++;
+
+    code = ((code << 2ull) & mask) | uint64(c & 3);
+    if (c >= 4)
+        invalid = 0;
+
+    if (invalid >= len)
+        invalid = -1;
+}
+
+// shift a symbol in from the left, dropping the last one
+//
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void RollingKmer::push_front(const uint8 c)
+{
+    shift_right( 1 );
+
+    if (c >= 4)
+        invalid = len - 1;
+
+    code = (code | ((uint64(c & 3)) << (2ull * (len - 1)))) & mask;
+}
+
+// drop the last k symbols, shifting in k empty ones from the left
+//
+NVBIO_FORCEINLINE NVBIO_HOST_DEVICE
+void RollingKmer::shift_right(int k)
+{
+    if (invalid != -1)
+        invalid -= k;
+
+    code = (code >> (2ull * k)) & (mask >> (2ull * k));
+    if (invalid < 0)
+        invalid = -1;
+}
+
+namespace priv {
+
+// roll the forward and reverse-complemented 2-bit k-mers along a string, keeping track
+// of the invalid (i.e. greater than 3) symbols
+//
+template <typename string_type>
+struct kmer_roller
+{
+    typedef typename string_traits<string_type>::forward_iterator forward_iterator;
+
+    // constructor: load the first K-1 symbols of the string
+    //
+    kmer_roller(const uint32 _K, const uint32 _flags, const string_type& string) :
+        K( _K ),
+        flags( _flags ),
+        mask( _K >= 32u ? uint64(-1) : (uint64(1u) << (2u*_K)) - 1u ),
+        rc_shift( 2u*(_K - 1u) ),
+        it( string.begin() ),
+        fwd( 0u ),
+        rc( 0u ),
+        pos( 0u ),
+        valid_begin( 0u )
+    {
+        for (uint32 j = 0; j + 1u < K; ++j)
+            push();
+    }
+
+    // shift the next symbol in
+    //
+    NVBIO_FORCEINLINE void push()
+    {
+        const uint32 s = uint32( *it ); ++it;
+        const uint32 c = s & 3u;
+
+        fwd = ((fwd << 2) | c) & mask;
+        rc  = (rc >> 2) | (uint64(3u - c) << rc_shift);
+
+        ++pos;
+        if (s > 3u)
+            valid_begin = pos;
+    }
+
+    // return whether the last k-mer returned by next() is made of valid symbols only
+    //
+    NVBIO_FORCEINLINE bool is_valid() const { return pos >= valid_begin + K; }
+
+    // shift the next symbol in and return the resulting k-mer, in the format specified by the flags
+    //
+    NVBIO_FORCEINLINE uint64 next()
+    {
+        push();
+
+        const uint64 kmer = (flags & KMER_CANONICAL) ? nvbio::min( fwd, rc ) : fwd;
+        return (flags & KMER_HASHED) ? kmer_hash( kmer ) : kmer;
+    }
+
+    const uint32        K;
+    const uint32        flags;
+    const uint64        mask;
+    const uint32        rc_shift;
+    forward_iterator    it;
+    uint64              fwd;
+    uint64              rc;
+    uint32              pos;            // the number of symbols shifted in
+    uint32              valid_begin;    // the position following the last invalid symbol
+};
+
+// check that the k-mers of the given length fit in the 64-bit k-mer codes
+//
+inline
+void check_kmer_length(const char* caller, const uint32 K)
+{
+    if (K < 1u || K > 32u)
+        throw runtime_error( "%s: unsupported k-mer length %u, must be in [1,32]", caller, K );
+}
+
+// compute the number of k-mers of a string
+//
+NVBIO_FORCEINLINE
+uint32 kmer_count(const uint32 string_len, const uint32 K)
+{
+    return string_len >= K ? string_len - K + 1u : 0u;
+}
+
+// compute the minimizers of a single string
+//
+template <typename string_type>
+void string_minimizers(
+    const uint32            K,
+    const uint32            W,
+    const uint32            string_id,
+    const string_type&      string,
+    const uint32            flags,
+    std::vector<uint64>&    window,
+    std::vector<uint64>&    out_kmers,
+    std::vector<uint2>&     out_coords)
+{
+    const uint32 n_kmers = kmer_count( length( string ), K );
+    if (n_kmers == 0u)
+        return;
+
+    // the minimizers are selected on the k-mer hashes, while the output
+    // might be the k-mers themselves
+    kmer_roller<string_type> roller( K, flags & ~uint32( KMER_HASHED ), string );
+
+    // keep a circular buffer of the last W k-mers
+    window.resize( W );
+
+    uint64 min_hash = uint64(-1);
+    uint32 min_pos  = uint32(-1);
+    uint32 last_pos = uint32(-1);
+
+    for (uint32 i = 0; i < n_kmers; ++i)
+    {
+        const uint64 kmer = roller.next();
+        const uint64 h    = kmer_hash( kmer );
+
+        window[ i % W ] = kmer;
+
+        if (min_pos != uint32(-1) && min_pos + W <= i)
+        {
+            // the current minimizer left the window: rescan the whole window
+            min_hash = uint64(-1);
+            for (uint32 j = i + 1u - W; j <= i; ++j)
+            {
+                const uint64 hj = kmer_hash( window[ j % W ] );
+                if (hj <= min_hash)
+                {
+                    min_hash = hj;
+                    min_pos  = j;
+                }
+            }
+        }
+        else if (h <= min_hash)
+        {
+            min_hash = h;
+            min_pos  = i;
+        }
+
+        // output the minimizer of each complete window (or of the only, partial window
+        // of strings shorter than W k-mers) the first time it is selected
+        if ((i + 1u >= W || i + 1u == n_kmers) && min_pos != last_pos)
+        {
+            const uint64 min_kmer = window[ min_pos % W ];
+
+            out_kmers.push_back( (flags & KMER_HASHED) ? min_hash : min_kmer );
+            out_coords.push_back( make_uint2( string_id, min_pos ) );
+            last_pos = min_pos;
+        }
+    }
+}
+
+} // namespace priv
+
+// extract all the 2-bit DNA k-mers of a host string-set
+//
+template <typename string_set_type>
+uint64 extract_kmers(
+    const uint32                        K,
+    const string_set_type&              string_set,
+    const uint32                        flags,
+    nvbio::vector<host_tag,uint64>&     kmers,
+    nvbio::vector<host_tag,uint2>&      coords)
+{
+    typedef typename string_set_type::string_type string_type;
+
+    priv::check_kmer_length( "extract_kmers()", K );
+
+    const uint32 n_strings = string_set.size();
+
+    // compute the output offsets
+    nvbio::vector<host_tag,uint64> offsets( n_strings + 1u );
+    offsets[0] = 0u;
+
+    #pragma omp parallel for
+    for (int32 i = 0; i < int32( n_strings ); ++i)
+        offsets[i+1] = priv::kmer_count( length( string_set[i] ), K );
+
+    for (uint32 i = 0; i < n_strings; ++i)
+        offsets[i+1] += offsets[i];
+
+    const uint64 n_kmers = offsets[ n_strings ];
+
+    kmers.resize( n_kmers );
+    coords.resize( n_kmers );
+
+    // roll along each string, writing its k-mers to its own output slots
+    #pragma omp parallel for schedule(dynamic,64)
+    for (int32 i = 0; i < int32( n_strings ); ++i)
+    {
+        const uint64 offset = offsets[i];
+        const uint32 count  = uint32( offsets[i+1] - offset );
+        if (count == 0u)
+            continue;
+
+        const string_type string = string_set[i];
+
+        priv::kmer_roller<string_type> roller( K, flags, string );
+
+        for (uint32 j = 0; j < count; ++j)
+        {
+            kmers[ offset + j ]  = roller.next();
+            coords[ offset + j ] = make_uint2( uint32(i), j );
+        }
+    }
+    return n_kmers;
+}
+
+// extract the (w,k)-minimizers of a host string-set
+//
+template <typename string_set_type>
+uint64 extract_minimizers(
+    const uint32                        K,
+    const uint32                        W,
+    const string_set_type&              string_set,
+    const uint32                        flags,
+    nvbio::vector<host_tag,uint64>&     kmers,
+    nvbio::vector<host_tag,uint2>&      coords)
+{
+    priv::check_kmer_length( "extract_minimizers()", K );
+
+    const uint32 n_strings = string_set.size();
+    const uint32 n_threads = (uint32)omp_get_max_threads();
+
+    // each thread processes a contiguous range of strings, so that the concatenation
+    // of the per-thread outputs is sorted by string
+    std::vector< std::vector<uint64> > thread_kmers( n_threads );
+    std::vector< std::vector<uint2> >  thread_coords( n_threads );
+
+    #pragma omp parallel for
+    for (int32 t = 0; t < int32( n_threads ); ++t)
+    {
+        const uint32 begin = uint32( (uint64( n_strings ) * uint32(t))      / n_threads );
+        const uint32 end   = uint32( (uint64( n_strings ) * uint32(t + 1u)) / n_threads );
+
+        std::vector<uint64> window;
+
+        for (uint32 i = begin; i < end; ++i)
+            priv::string_minimizers( K, W, i, string_set[i], flags, window, thread_kmers[t], thread_coords[t] );
+    }
+
+    // concatenate the per-thread outputs
+    std::vector<uint64> offsets( n_threads + 1u );
+    offsets[0] = 0u;
+    for (uint32 t = 0; t < n_threads; ++t)
+        offsets[t+1] = offsets[t] + thread_kmers[t].size();
+
+    kmers.resize( offsets[ n_threads ] );
+    coords.resize( offsets[ n_threads ] );
+
+    #pragma omp parallel for
+    for (int32 t = 0; t < int32( n_threads ); ++t)
+    {
+        std::copy( thread_kmers[t].begin(),  thread_kmers[t].end(),  kmers.begin()  + offsets[t] );
+        std::copy( thread_coords[t].begin(), thread_coords[t].end(), coords.begin() + offsets[t] );
+    }
+    return offsets[ n_threads ];
+}
+
+} // namespace nvbio
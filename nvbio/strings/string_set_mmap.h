@@ -0,0 +1,305 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nvbio/strings/string_set.h>
+#include <nvbio/basic/packed_vector_mmap.h>
+#include <nvbio/basic/packedstream.h>
+#include <nvbio/basic/numbers.h>
+#include <vector>
+
+namespace nvbio {
+
+///@addtogroup Strings
+///@{
+
+///@addtogroup StringSetsModule
+///@{
+
+///
+/// A read-only packed ConcatenatedStringSet backed by a memory mapped packed file,
+/// written by save_concatenated_string_set().
+/// Its plain view is a regular ConcatenatedStringSet over a PackedStream, so that it can be
+/// passed to any function accepting a host string set without loading the file in memory.
+///
+/// \tparam SYMBOL_SIZE_T       the number of bits needed for each symbol
+/// \tparam BIG_ENDIAN_T        the "endianness" of the packed words
+///
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T = false>
+struct MappedConcatenatedStringSet
+{
+    static const uint32 SYMBOL_SIZE = SYMBOL_SIZE_T;
+    static const uint32 BIG_ENDIAN  = BIG_ENDIAN_T;
+
+    static const char* magic() { return "CSET"; }
+
+    typedef host_tag                                                            system_tag;
+    typedef PackedStream<const uint32*,uint8,SYMBOL_SIZE,BIG_ENDIAN,uint64>     packed_stream_type;
+    typedef const uint64*                                                       offset_iterator;
+    typedef ConcatenatedStringSet<packed_stream_type,offset_iterator>           string_set_type;
+
+    typedef string_set_type                                                     plain_view_type;
+    typedef string_set_type                                               const_plain_view_type;
+
+    /// constructor
+    ///
+    MappedConcatenatedStringSet() : m_size( 0 ), m_symbols( 0 ), m_words( NULL ), m_offsets( NULL ) {}
+
+    /// map a string-set file written by save_concatenated_string_set()
+    ///
+    void load(const char* file_name)
+    {
+        PackedFileInfo info;
+        const void*    index;
+        m_words   = map_packed_file( m_file, file_name, magic(), SYMBOL_SIZE, BIG_ENDIAN, &info, &index );
+        m_offsets = reinterpret_cast<const uint64*>( index );
+        m_size    = info.n_strings;
+        m_symbols = info.n_symbols;
+
+        if (info.index_size < sizeof(uint64) * (uint64( m_size ) + 1u))
+            throw runtime_error( "\"%s\": truncated string-set file", file_name );
+    }
+
+    /// number of strings
+    ///
+    uint32 size() const { return m_size; }
+
+    /// total number of symbols
+    ///
+    uint64 n_symbols() const { return m_symbols; }
+
+    /// return the plain view
+    ///
+    operator plain_view_type() const
+    {
+        return plain_view_type(
+            m_size,
+            packed_stream_type( m_words ),
+            m_offsets );
+    }
+
+    DiskMappedFile  m_file;
+    uint32          m_size;
+    uint64          m_symbols;
+    const uint32*   m_words;
+    const uint64*   m_offsets;
+};
+
+///
+/// A read-only packed SparseStringSet backed by a memory mapped packed file,
+/// written by save_sparse_string_set().
+/// Its plain view is a regular SparseStringSet over a PackedStream.
+///
+/// \tparam SYMBOL_SIZE_T       the number of bits needed for each symbol
+/// \tparam BIG_ENDIAN_T        the "endianness" of the packed words
+///
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T = false>
+struct MappedSparseStringSet
+{
+    static const uint32 SYMBOL_SIZE = SYMBOL_SIZE_T;
+    static const uint32 BIG_ENDIAN  = BIG_ENDIAN_T;
+
+    static const char* magic() { return "SSET"; }
+
+    typedef host_tag                                                            system_tag;
+    typedef PackedStream<const uint32*,uint8,SYMBOL_SIZE,BIG_ENDIAN,uint64>     packed_stream_type;
+    typedef const uint2*                                                        range_iterator;
+    typedef SparseStringSet<packed_stream_type,range_iterator>                  string_set_type;
+
+    typedef string_set_type                                                     plain_view_type;
+    typedef string_set_type                                               const_plain_view_type;
+
+    /// constructor
+    ///
+    MappedSparseStringSet() : m_size( 0 ), m_symbols( 0 ), m_words( NULL ), m_ranges( NULL ) {}
+
+    /// map a string-set file written by save_sparse_string_set()
+    ///
+    void load(const char* file_name)
+    {
+        PackedFileInfo info;
+        const void*    index;
+        m_words   = map_packed_file( m_file, file_name, magic(), SYMBOL_SIZE, BIG_ENDIAN, &info, &index );
+        m_ranges  = reinterpret_cast<const uint2*>( index );
+        m_size    = info.n_strings;
+        m_symbols = info.n_symbols;
+
+        if (info.index_size < sizeof(uint2) * uint64( m_size ))
+            throw runtime_error( "\"%s\": truncated string-set file", file_name );
+    }
+
+    /// number of strings
+    ///
+    uint32 size() const { return m_size; }
+
+    /// number of symbols of the base string
+    ///
+    uint64 n_symbols() const { return m_symbols; }
+
+    /// return the base string
+    ///
+    packed_stream_type base_string() const { return packed_stream_type( m_words ); }
+
+    /// return the plain view
+    ///
+    operator plain_view_type() const
+    {
+        return plain_view_type(
+            m_size,
+            packed_stream_type( m_words ),
+            m_ranges );
+    }
+
+    DiskMappedFile  m_file;
+    uint32          m_size;
+    uint64          m_symbols;
+    const uint32*   m_words;
+    const uint2*    m_ranges;
+};
+
+///\relates MappedConcatenatedStringSet
+/// return a plain view of a MappedConcatenatedStringSet
+///
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
+typename MappedConcatenatedStringSet<SYMBOL_SIZE_T,BIG_ENDIAN_T>::plain_view_type
+plain_view(const MappedConcatenatedStringSet<SYMBOL_SIZE_T,BIG_ENDIAN_T>& string_set) { return string_set; }
+
+///\relates MappedSparseStringSet
+/// return a plain view of a MappedSparseStringSet
+///
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T>
+typename MappedSparseStringSet<SYMBOL_SIZE_T,BIG_ENDIAN_T>::plain_view_type
+plain_view(const MappedSparseStringSet<SYMBOL_SIZE_T,BIG_ENDIAN_T>& string_set) { return string_set; }
+
+/// pack a host string-set into a concatenated string-set file, which can be later
+/// mapped by MappedConcatenatedStringSet
+///
+/// \tparam SYMBOL_SIZE_T       the number of bits needed for each symbol
+/// \tparam BIG_ENDIAN_T        the "endianness" of the packed words
+/// \tparam string_set_type     the input host string-set type
+///
+/// \return                     true on success
+///
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename string_set_type>
+bool save_concatenated_string_set(const char* file_name, const string_set_type& string_set)
+{
+    typedef PackedStream<uint32*,uint8,SYMBOL_SIZE_T,BIG_ENDIAN_T,uint64> packed_stream_type;
+
+    const uint32 n_strings = string_set.size();
+
+    // compute the string offsets
+    std::vector<uint64> offsets( n_strings + 1u );
+    offsets[0] = 0u;
+    for (uint32 i = 0; i < n_strings; ++i)
+        offsets[i+1] = offsets[i] + string_set[i].length();
+
+    const uint64 n_symbols = offsets[ n_strings ];
+    const uint64 n_words   = util::divide_ri( n_symbols, uint64( 32u / SYMBOL_SIZE_T ) );
+
+    // pack the strings
+    std::vector<uint32> words( n_words, 0u );
+    packed_stream_type  stream( n_words ? &words[0] : (uint32*)NULL );
+
+    for (uint32 i = 0; i < n_strings; ++i)
+    {
+        const typename string_set_type::string_type string = string_set[i];
+
+        for (uint32 j = 0; j < string.length(); ++j)
+            stream[ offsets[i] + j ] = uint8( string[j] );
+    }
+
+    return save_packed_file(
+        file_name,
+        MappedConcatenatedStringSet<SYMBOL_SIZE_T,BIG_ENDIAN_T>::magic(),
+        SYMBOL_SIZE_T,
+        BIG_ENDIAN_T,
+        n_strings,
+        n_symbols,
+        sizeof(uint64) * (uint64( n_strings ) + 1u),
+        &offsets[0],
+        n_words,
+        n_words ? &words[0] : NULL );
+}
+
+/// pack a base string and a set of ranges into a sparse string-set file, which can be later
+/// mapped by MappedSparseStringSet
+///
+/// \tparam SYMBOL_SIZE_T       the number of bits needed for each symbol
+/// \tparam BIG_ENDIAN_T        the "endianness" of the packed words
+/// \tparam symbol_iterator     the base string iterator
+/// \tparam range_iterator      the string ranges iterator, whose value_type must be <i>uint2</i>
+///
+/// \param file_name            the output file name
+/// \param n_symbols            the base string length
+/// \param string               the base string
+/// \param n_strings            the number of strings
+/// \param ranges               the string ranges in the base string
+///
+/// \return                     true on success
+///
+template <uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename symbol_iterator, typename range_iterator>
+bool save_sparse_string_set(
+    const char*             file_name,
+    const uint64            n_symbols,
+    const symbol_iterator   string,
+    const uint32            n_strings,
+    const range_iterator    ranges)
+{
+    typedef PackedStream<uint32*,uint8,SYMBOL_SIZE_T,BIG_ENDIAN_T,uint64> packed_stream_type;
+
+    const uint64 n_words = util::divide_ri( n_symbols, uint64( 32u / SYMBOL_SIZE_T ) );
+
+    // pack the base string
+    std::vector<uint32> words( n_words, 0u );
+    packed_stream_type  stream( n_words ? &words[0] : (uint32*)NULL );
+
+    for (uint64 i = 0; i < n_symbols; ++i)
+        stream[i] = uint8( string[i] );
+
+    // copy the ranges
+    std::vector<uint2> h_ranges( n_strings );
+    for (uint32 i = 0; i < n_strings; ++i)
+        h_ranges[i] = ranges[i];
+
+    return save_packed_file(
+        file_name,
+        MappedSparseStringSet<SYMBOL_SIZE_T,BIG_ENDIAN_T>::magic(),
+        SYMBOL_SIZE_T,
+        BIG_ENDIAN_T,
+        n_strings,
+        n_symbols,
+        sizeof(uint2) * uint64( n_strings ),
+        n_strings ? &h_ranges[0] : NULL,
+        n_words,
+        n_words ? &words[0] : NULL );
+}
+
+///@} StringSetsModule
+///@} Strings
+
+} // namespace nvbio
@@ -0,0 +1,148 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/vector.h>
+#include <nvbio/basic/packedstream.h>
+#include <nvbio/basic/exceptions.h>
+#include <nvbio/strings/string_set.h>
+
+namespace nvbio {
+
+///@addtogroup Strings
+///@{
+
+///
+///@defgroup WindowGatherModule Window Gathering
+/// This module implements a host stage to gather a batch of windows of a large reference string,
+/// e.g. the candidate loci to be verified against a packed genome, into a single contiguous buffer
+/// of unpacked symbols.
+/// The windows are sorted by reference position and overlapping windows are coalesced, so that
+/// each reference region is read only once, sequentially and with software prefetching, instead of
+/// being fetched symbol by symbol with random accesses.
+/// The stage is opt-in: none of the library's pipelines uses it yet.
+///@{
+
+///
+/// A host context gathering a batch of reference windows into a buffer of unpacked symbols,
+/// exposed as a SparseStringSet of plain byte strings which can be directly passed to the
+/// host aligners.
+///
+/// \code
+/// // gather the reference windows of a batch of candidates
+/// WindowGather gather;
+/// gather.gather( genome_stream, genome_len, n_candidates, nvbio::raw_pointer( candidate_windows ) );
+///
+/// // and align the reads against them
+/// aln::batch_alignment_score(
+///     aligner,
+///     reads,
+///     gather.strings(),
+///     sinks,
+///     aln::HostThreadScheduler(),
+///     max_read_len,
+///     max_window_len );
+/// \endcode
+///
+struct WindowGather
+{
+    typedef SparseStringSet<const uint8*,const uint2*>  string_set_type;    ///< the output string set type
+
+    static const uint32 TASK_SIZE           = 16*1024;  ///< maximum number of symbols unpacked by a single task
+    static const uint32 PREFETCH_DISTANCE   = 4;        ///< number of tasks to prefetch ahead
+
+    /// constructor
+    ///
+    /// \param max_gap      windows separated by at most this many symbols are coalesced
+    ///                     in a single run
+    ///
+    WindowGather(const uint32 max_gap = 0u) : m_max_gap( max_gap ), m_runs( 0u ), m_requested( 0u ) {}
+
+    /// gather a batch of windows of a reference string.
+    /// Throws a logic_error if a window is reversed or exceeds the reference, and a
+    /// runtime_error if the gathered symbols do not fit the 32-bit offsets of the output set.
+    ///
+    /// \tparam reference_string    a random access string; PackedStream's with a pointer storage
+    ///                             are unpacked a word at a time and prefetched ahead
+    /// \tparam window_iterator     a uint2 iterator
+    ///
+    /// \param reference            the reference string
+    /// \param reference_len        the length of the reference string
+    /// \param n_windows            the number of windows
+    /// \param windows              the [begin,end) reference coordinates of each window
+    ///
+    template <typename reference_string, typename window_iterator>
+    void gather(
+        const reference_string  reference,
+        const uint64            reference_len,
+        const uint32            n_windows,
+        const window_iterator   windows);
+
+    /// return the number of gathered windows
+    ///
+    uint32 size() const { return uint32( m_ranges.size() ); }
+
+    /// return the gathered windows as a string set, in the order they were given
+    ///
+    string_set_type strings() const
+    {
+        return string_set_type(
+            size(),
+            nvbio::raw_pointer( m_buffer ),
+            nvbio::raw_pointer( m_ranges ) );
+    }
+
+    /// return the number of coalesced reference runs
+    ///
+    uint32 runs() const { return m_runs; }
+
+    /// return the total length of the requested windows
+    ///
+    uint64 requested_symbols() const { return m_requested; }
+
+    /// return the number of unpacked symbols, i.e. the buffer size
+    ///
+    uint64 gathered_symbols() const { return m_buffer.size(); }
+
+    uint32                          m_max_gap;      ///< maximum gap between coalesced windows
+    uint32                          m_runs;         ///< number of coalesced runs
+    uint64                          m_requested;    ///< total length of the requested windows
+    nvbio::vector<host_tag,uint8>   m_buffer;       ///< the unpacked symbols
+    nvbio::vector<host_tag,uint2>   m_ranges;       ///< the range of each window in the buffer
+    nvbio::vector<host_tag,uint64>  m_keys;         ///< the sorting keys
+    nvbio::vector<host_tag,uint4>   m_tasks;        ///< the unpacking tasks: (ref begin, ref end, buffer offset)
+};
+
+///@} WindowGatherModule
+///@} Strings
+
+} // namespace nvbio
+
+#include <nvbio/strings/window_gather_inl.h>
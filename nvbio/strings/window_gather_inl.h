@@ -0,0 +1,227 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace nvbio {
+
+namespace priv {
+
+// the number of symbols of a reference string stored in a 64-byte cache line, i.e. the stride
+// between consecutive prefetches
+//
+template <typename reference_string>
+struct window_prefetch_stride { static const uint32 VALUE = 64u; };
+
+template <typename T>
+struct window_prefetch_stride<const T*> { static const uint32 VALUE = 64u / sizeof(T) ? 64u / sizeof(T) : 1u; };
+
+template <typename T>
+struct window_prefetch_stride<T*> { static const uint32 VALUE = window_prefetch_stride<const T*>::VALUE; };
+
+template <typename W, typename Symbol, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
+struct window_prefetch_stride< PackedStream<const W*,Symbol,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType> >
+{
+    static const uint32 VALUE = (64u / sizeof(W)) * PackedStream<const W*,Symbol,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType>::SYMBOLS_PER_WORD;
+};
+
+template <typename W, typename Symbol, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
+struct window_prefetch_stride< PackedStream<W*,Symbol,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType> >
+{
+    static const uint32 VALUE = window_prefetch_stride< PackedStream<const W*,Symbol,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType> >::VALUE;
+};
+
+// prefetch the storage of a reference string at a given position - a no-op for generic strings
+//
+template <typename reference_string>
+void window_prefetch(const reference_string reference, const uint64 pos) {}
+
+// prefetch the storage of a plain string at a given position
+//
+template <typename T>
+void window_prefetch(const T* reference, const uint64 pos)
+{
+  #if defined(__GNUC__)
+    __builtin_prefetch( reference + pos );
+  #endif
+}
+
+// prefetch the word storage of a packed string at a given position
+//
+template <typename W, typename Symbol, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
+void window_prefetch(const PackedStream<const W*,Symbol,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType> reference, const uint64 pos)
+{
+    typedef PackedStream<const W*,Symbol,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType> packed_stream_type;
+
+  #if defined(__GNUC__)
+    __builtin_prefetch( reference.stream() + (reference.index() + pos) / packed_stream_type::SYMBOLS_PER_WORD );
+  #endif
+}
+
+// prefetch the word storage of a packed string at a given position
+//
+template <typename W, typename Symbol, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
+void window_prefetch(const PackedStream<W*,Symbol,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType> reference, const uint64 pos)
+{
+    typedef PackedStream<W*,Symbol,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType> packed_stream_type;
+
+  #if defined(__GNUC__)
+    __builtin_prefetch( reference.stream() + (reference.index() + pos) / packed_stream_type::SYMBOLS_PER_WORD );
+  #endif
+}
+
+// unpack the [begin,end) range of a generic reference string
+//
+template <typename reference_string>
+void window_unpack(const reference_string reference, const uint32 begin, const uint32 end, uint8* output)
+{
+    for (uint32 i = begin; i < end; ++i)
+        output[i - begin] = reference[i];
+}
+
+// unpack the [begin,end) range of a packed reference string, streaming through its words
+//
+template <typename InputStream, typename Symbol, uint32 SYMBOL_SIZE_T, bool BIG_ENDIAN_T, typename IndexType>
+void window_unpack(const PackedStream<InputStream,Symbol,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType> reference, const uint32 begin, const uint32 end, uint8* output)
+{
+    typedef ForwardPackedStream<InputStream,Symbol,SYMBOL_SIZE_T,BIG_ENDIAN_T,IndexType> forward_stream_type;
+
+    forward_stream_type it( reference.stream(), reference.index() + begin );
+
+    for (uint32 i = begin; i < end; ++i, ++it)
+        output[i - begin] = it.get();
+}
+
+} // namespace priv
+
+// gather a batch of windows of a reference string
+//
+template <typename reference_string, typename window_iterator>
+void WindowGather::gather(
+    const reference_string  reference,
+    const uint64            reference_len,
+    const uint32            n_windows,
+    const window_iterator   windows)
+{
+    m_ranges.resize( n_windows );
+    m_keys.resize( n_windows );
+    m_tasks.resize( 0 );
+    m_runs      = 0u;
+    m_requested = 0u;
+
+    if (n_windows == 0)
+    {
+        m_buffer.resize( 0 );
+        return;
+    }
+
+    // sort the windows by their begin coordinate, keeping track of their index
+    for (uint32 i = 0; i < n_windows; ++i)
+    {
+        const uint2 window = windows[i];
+        if (window.x > window.y || uint64( window.y ) > reference_len)
+            throw nvbio::logic_error( "WindowGather: window %u [%u,%u) exceeds the reference [0,%llu)", i, window.x, window.y, reference_len );
+
+        m_keys[i] = (uint64( window.x ) << 32) | i;
+
+        m_requested += window.y - window.x;
+    }
+    std::sort( m_keys.begin(), m_keys.end() );
+
+    // sweep the sorted windows, coalescing the overlapping ones into runs
+    uint32 run_begin  = windows[ uint32( m_keys[0] ) ].x;
+    uint32 run_end    = run_begin;
+    uint64 run_offset = 0u;
+
+    for (uint32 k = 0; k <= n_windows; ++k)
+    {
+        const uint32 window_id = k < n_windows ? uint32( m_keys[k] ) : 0u;
+        const uint2  window    = k < n_windows ? windows[ window_id ] : make_uint2( 0u, 0u );
+
+        // close the current run
+        if (k == n_windows || uint64( window.x ) > uint64( run_end ) + m_max_gap)
+        {
+            // split it into tasks of bounded size
+            for (uint32 task_begin = run_begin; task_begin < run_end; task_begin += nvbio::min( TASK_SIZE, run_end - task_begin ))
+            {
+                const uint32 task_end = task_begin + nvbio::min( TASK_SIZE, run_end - task_begin );
+                m_tasks.push_back( make_uint4( task_begin, task_end, uint32( run_offset + task_begin - run_begin ), 0u ) );
+            }
+            run_offset += run_end - run_begin;
+            m_runs++;
+
+            if (k == n_windows)
+                break;
+
+            run_begin = run_end = window.x;
+        }
+
+        // assign the window its place in the buffer
+        const uint32 window_offset = uint32( run_offset + window.x - run_begin );
+        m_ranges[ window_id ] = make_uint2( window_offset, window_offset + window.y - window.x );
+
+        run_end = nvbio::max( run_end, window.y );
+
+        // the buffer offsets are stored in 32 bits
+        if (run_offset + (run_end - run_begin) > uint64( uint32(-1) ))
+            throw nvbio::runtime_error( "WindowGather: the gathered windows exceed %u symbols", uint32(-1) );
+    }
+
+    // unpack all runs
+    m_buffer.resize( run_offset );
+
+    uint8*       buffer  = nvbio::raw_pointer( m_buffer );
+    const uint4* tasks   = nvbio::raw_pointer( m_tasks );
+    const int    n_tasks = int( m_tasks.size() );
+
+    #if defined(_OPENMP)
+    #pragma omp parallel for schedule(dynamic,4)
+    #endif
+    for (int i = 0; i < n_tasks; ++i)
+    {
+        // start fetching the reference words of an upcoming task, one cache line at a time
+        if (uint32( i ) + PREFETCH_DISTANCE < uint32( n_tasks ))
+        {
+            const uint32 STRIDE = priv::window_prefetch_stride<reference_string>::VALUE;
+
+            const uint4 next = tasks[ i + PREFETCH_DISTANCE ];
+            for (uint32 pos = next.x; pos < next.y; pos += STRIDE)
+                priv::window_prefetch( reference, pos );
+        }
+
+        const uint4 task = tasks[i];
+        priv::window_unpack( reference, task.x, task.y, buffer + task.z );
+    }
+}
+
+} // namespace nvbio
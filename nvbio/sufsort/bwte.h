@@ -81,6 +81,12 @@ struct BWTEBlock
     /// reserve space for a maximum block size
     ///
     void reserve(const uint32 _max_block_strings, const uint32 _max_block_suffixes);
+
+    /// turn the block-local string ids of the dollars into global ones, i.e. offset them
+    /// by the number of strings preceding the block in the collection (including those
+    /// of a previously loaded BWT)
+    ///
+    void offset_dollar_ids(const uint32 id_offset);
 };
 
 ///
@@ -69,6 +69,17 @@ void BWTEBlock::reserve(const uint32 _max_block_strings, const uint32 _max_block
     max_block_strings  = _max_block_strings;
 }
 
+inline
+void BWTEBlock::offset_dollar_ids(const uint32 id_offset)
+{
+    if (id_offset == 0u)
+        return;
+
+    #pragma omp parallel for
+    for (int32 i = 0; i < int32( n_strings ); ++i)
+        h_dollar_id[i] += id_offset;
+}
+
 /// constructor
 ///
 template <uint32 SYMBOL_SIZE, bool BIG_ENDIAN, typename storage_type, typename offsets_iterator>
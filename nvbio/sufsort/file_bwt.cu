@@ -28,6 +28,7 @@
 #include <nvbio/sufsort/file_bwt.h>
 #include <nvbio/sufsort/file_bwt_bgz.h>
 #include <nvbio/sufsort/sufsort_priv.h>
+#include <nvbio/basic/shared_pointer.h>
 #include <zlib/zlib.h>
 #ifdef _OPENMP
 #include <omp.h>
@@ -102,11 +103,28 @@ struct FileBWTHandler : public SetBWTHandler, public BWTWriter
 
     /// constructor
     ///
-    FileBWTHandler() : offset(0) {}
+    FileBWTHandler() : offset(0), cache_word(0) {}
 
-    /// destructor
+    /// destructor: flush the last partial word and terminate the index with
+    /// a (length,-1) pair recording the total number of symbols
     ///
-    virtual ~FileBWTHandler() {}
+    virtual ~FileBWTHandler()
+    {
+        if (BWTWriter::is_ok() == false)
+            return;
+
+        if (offset & (SYMBOLS_PER_WORD-1))
+        {
+            const uint32 n_bytes = uint32( sizeof(word_type) );
+            if (BWTWriter::bwt_write( n_bytes, &cache_word ) != n_bytes)
+                log_error(stderr, "FileBWTHandler::~FileBWTHandler() : bwt write failed!\n");
+        }
+
+        const uint64 terminator[2] = { offset, uint64(-1) };
+        const uint32 n_bytes = uint32( sizeof(terminator) );
+        if (BWTWriter::index_write( n_bytes, terminator ) != n_bytes)
+            log_error(stderr, "FileBWTHandler::~FileBWTHandler() : index write failed!\n");
+    }
 
     /// write header
     ///
@@ -610,6 +628,219 @@ uint32 BWTGZWriter::index_write(const uint32 n_bytes, const void* buffer)
 bool BWTGZWriter::is_ok() const { return output_file != NULL || index_file != NULL; }
 
 
+/// A class to output the BWT through a nested handler while streaming out the FM-index
+/// occurrence table, the symbol counts and the L2 array of the string-set BWT, so as
+/// to avoid a second pass over the output to make it query-ready.
+///
+/// The dollars are stored as regular symbols in the packed BWT: they are here identified
+/// through their positions and excluded from all counters, which hence only account for
+/// the DNA symbols. Dollar positions are expected to be sorted, and to fall within the
+/// batch they are reported with.
+/// Only 2-bit DNA input is supported: packed batches with a different symbol size, and
+/// byte batches with symbols out of the DNA alphabet outside of the dollar positions,
+/// are rejected with a runtime_error.
+///
+struct FMIndexFileBWTHandler : public SetBWTHandler
+{
+    static const uint32 SYMBOL_COUNT = 4u;
+
+    /// constructor
+    ///
+    /// \param _bwt_handler    the nested handler used to output the BWT itself
+    /// \param _occ_intv       the occurrence table sampling interval, a power of 2
+    ///
+    FMIndexFileBWTHandler(SetBWTHandler* _bwt_handler, const uint32 _occ_intv) :
+        bwt_handler( _bwt_handler ),
+        occ_file( NULL ),
+        occ_intv( _occ_intv ),
+        offset( 0 ),
+        n_dollars_total( 0 )
+    {
+        for (uint32 c = 0; c < SYMBOL_COUNT; ++c)
+            counters[c] = 0u;
+    }
+
+    /// destructor: patch the header with the final symbol counts and the L2 array
+    ///
+    virtual ~FMIndexFileBWTHandler()
+    {
+        if (occ_file == NULL)
+            return;
+
+        // the L2 array sorts all dollars before any other symbol
+        uint64 L2[SYMBOL_COUNT+1];
+        L2[0] = n_dollars_total;
+        for (uint32 c = 0; c < SYMBOL_COUNT; ++c)
+            L2[c+1] = L2[c] + counters[c];
+
+        if (L2[SYMBOL_COUNT] != offset)
+            log_error(stderr, "FMIndexFileBWTHandler : mismatching symbol counts (%llu != %llu)\n", L2[SYMBOL_COUNT], offset);
+
+        if (fseek( occ_file, 0, SEEK_SET ) != 0 ||
+            write_header( L2 ) == false)
+            log_error(stderr, "FMIndexFileBWTHandler : header write failed!\n");
+
+        fclose( occ_file );
+    }
+
+    /// open the occurrence table file
+    ///
+    bool open(const char* occ_name)
+    {
+        log_verbose(stderr,"  opening occurrence table file \"%s\"\n", occ_name);
+        occ_file = fopen( occ_name, "wb" );
+        if (occ_file == NULL)
+            return false;
+
+        // reserve space for the header
+        const uint64 L2[SYMBOL_COUNT+1] = { 0 };
+        return write_header( L2 );
+    }
+
+    /// write the file header
+    ///
+    bool write_header(const uint64* L2)
+    {
+        const char* magic = "OCCB";         // OCCurrences-Binary
+
+        uint64 header[2 + SYMBOL_COUNT + SYMBOL_COUNT+1];
+        header[0] = offset;
+        header[1] = n_dollars_total;
+        for (uint32 c = 0; c < SYMBOL_COUNT; ++c)
+            header[2 + c] = counters[c];
+        for (uint32 c = 0; c <= SYMBOL_COUNT; ++c)
+            header[2 + SYMBOL_COUNT + c] = L2[c];
+
+        return fwrite( magic,     sizeof(char),   4,                 occ_file ) == 4 &&
+               fwrite( &occ_intv, sizeof(uint32), 1,                 occ_file ) == 1 &&
+               fwrite( header,    sizeof(uint64), sizeof(header)/8u, occ_file ) == sizeof(header)/8u;
+    }
+
+    /// update the occurrence table with a batch of BWT symbols
+    ///
+    template <typename bwt_iterator>
+    void count(
+        const uint32        n_suffixes,
+        const bwt_iterator  bwt,
+        const uint32        n_batch_dollars,
+        const uint64*       dollar_pos)
+    {
+        const uint64 begin = offset;
+        const uint64 end   = offset + n_suffixes;
+
+        // the batch is split in a head chunk preceding the first sample, followed by one chunk per sample
+        const uint64 first_sample = util::divide_ri( begin, occ_intv );
+        const uint64 last_sample  = util::divide_ri( end,   occ_intv );
+        const uint32 n_chunks     = uint32( last_sample - first_sample ) + 1u;
+
+        priv::alloc_storage( chunk_counters, n_chunks * SYMBOL_COUNT );
+
+        uint64 n_invalid = 0;
+
+        // count the symbols in each chunk in parallel, skipping the dollars
+        #pragma omp parallel for reduction(+:n_invalid)
+        for (int32 j = 0; j < int32( n_chunks ); ++j)
+        {
+            const uint64 chunk_begin = j ? (first_sample + j-1) * occ_intv : begin;
+            const uint64 chunk_end   = nvbio::min( (first_sample + j) * occ_intv, end );
+
+            uint32 d = uint32( nvbio::lower_bound_index( chunk_begin, dollar_pos, n_batch_dollars ) );
+
+            uint64 cnts[SYMBOL_COUNT] = { 0 };
+            for (uint64 i = chunk_begin; i < chunk_end; ++i)
+            {
+                if (d < n_batch_dollars && dollar_pos[d] == i)
+                {
+                    ++d;
+                    continue;
+                }
+
+                const uint32 c = bwt[ uint32( i - begin ) ];
+                if (c < SYMBOL_COUNT)
+                    ++cnts[c];
+                else
+                    ++n_invalid;
+            }
+
+            for (uint32 c = 0; c < SYMBOL_COUNT; ++c)
+                chunk_counters[ j * SYMBOL_COUNT + c ] = cnts[c];
+        }
+
+        if (n_invalid)
+            throw nvbio::runtime_error("FMIndexFileBWTHandler::process() : %llu symbols out of the DNA alphabet!", n_invalid);
+
+        // scan the chunk counters, emitting the samples at the chunk boundaries
+        const uint32 n_samples = n_chunks - 1u;
+
+        priv::alloc_storage( occ, n_samples * SYMBOL_COUNT );
+
+        for (uint32 c = 0; c < SYMBOL_COUNT; ++c)
+            counters[c] += chunk_counters[c];
+
+        for (uint32 j = 1; j < n_chunks; ++j)
+        {
+            for (uint32 c = 0; c < SYMBOL_COUNT; ++c)
+            {
+                occ[ (j-1) * SYMBOL_COUNT + c ] = counters[c];
+                counters[c] += chunk_counters[ j * SYMBOL_COUNT + c ];
+            }
+        }
+
+        if (n_samples)
+        {
+            const size_t n_words   = size_t( n_samples ) * SYMBOL_COUNT;
+            const size_t n_written = fwrite( &occ[0], sizeof(uint64), n_words, occ_file );
+            if (n_written != n_words)
+                throw nvbio::runtime_error("FMIndexFileBWTHandler::process() : occurrence table write failed! (%llu/%llu words written)", uint64( n_written ), uint64( n_words ));
+        }
+
+        offset          += n_suffixes;
+        n_dollars_total += n_batch_dollars;
+    }
+
+    /// process a batch of BWT symbols
+    ///
+    void process(
+        const uint32  n_suffixes,
+        const uint32  bits_per_symbol,
+        const uint32* bwt,
+        const uint32  n_dollars,
+        const uint64* dollar_pos,
+        const uint64* dollar_ids)
+    {
+        if (bits_per_symbol != 2)
+            throw nvbio::runtime_error("FMIndexFileBWTHandler::process() : unsupported input format! (%u bits per symbol)", bits_per_symbol);
+
+        bwt_handler->process( n_suffixes, bits_per_symbol, bwt, n_dollars, dollar_pos, dollar_ids );
+
+        count( n_suffixes, PackedStream<const uint32*,uint8,2,true>( bwt ), n_dollars, dollar_pos );
+    }
+
+    /// process a batch of BWT symbols
+    ///
+    void process(
+        const uint32  n_suffixes,
+        const uint8*  bwt,
+        const uint32  n_dollars,
+        const uint64* dollar_pos,
+        const uint64* dollar_ids)
+    {
+        // count first, so as to reject invalid symbols before they reach the output
+        count( n_suffixes, bwt, n_dollars, dollar_pos );
+
+        bwt_handler->process( n_suffixes, bwt, n_dollars, dollar_pos, dollar_ids );
+    }
+
+    SharedPointer<SetBWTHandler>    bwt_handler;
+    FILE*                           occ_file;
+    uint32                          occ_intv;
+    uint64                          offset;
+    uint64                          n_dollars_total;
+    uint64                          counters[SYMBOL_COUNT];
+    std::vector<uint64>             chunk_counters;
+    std::vector<uint64>             occ;
+};
+
 // open a BWT file
 //
 SetBWTHandler* open_bwt_file(const char* output_name, const char* params)
@@ -853,4 +1084,386 @@ SetBWTHandler* open_bwt_file(const char* output_name, const char* params)
     return NULL;
 }
 
+namespace {
+
+typedef std::pair<uint64,uint64> bwt_dollar_type;
+
+static const uint32 BWT_SYMBOLS_PER_WORD = 16u;             // the 2-bit files are written as big-endian uint32 words
+static const uint32 BWT_CHUNK_SIZE       = 64*1024*1024;    // maximum number of bytes per gzread() call
+
+// find the primary dollars index name of a 2-bit BWT file from its suffix
+//
+bool bwt_index_name(const char* input_name, std::string& index_string)
+{
+    const char* suffixes[3]       = { ".bwt.bgz", ".bwt.gz", ".bwt" };
+    const char* index_suffixes[3] = { ".pri.bgz", ".pri.gz", ".pri" };
+
+    const uint32 len = (uint32)strlen( input_name );
+
+    index_string = input_name;
+
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        if (len >= strlen( suffixes[i] ) &&
+            strcmp( &input_name[len - strlen( suffixes[i] )], suffixes[i] ) == 0)
+        {
+            index_string.replace( len - strlen( suffixes[i] ), strlen( suffixes[i] ), index_suffixes[i] );
+            return true;
+        }
+    }
+    log_error(stderr,"  unsupported input format \"%s\" (only 2-bit .bwt|.bwt.gz|.bwt.bgz files can be loaded)\n", input_name);
+    return false;
+}
+
+// find the occurrence table name of a BWT file, stripping its suffix
+//
+std::string occ_file_name(const char* bwt_name)
+{
+    std::string occ_string = bwt_name;
+
+    size_t pos = occ_string.rfind( ".bwt" );
+    if (pos == std::string::npos)
+        pos = occ_string.rfind( ".txt" );
+
+    if (pos != std::string::npos)
+        occ_string.erase( pos );
+
+    occ_string.append( ".occ" );
+    return occ_string;
+}
+
+// read a binary primary dollars index, checking it's terminated by a (length,-1) pair;
+// gzread() handles both compressed and uncompressed files
+//
+bool read_bwt_index(const std::string& index_string, std::vector<bwt_dollar_type>& h_dollars)
+{
+    log_verbose(stderr,"  opening index file \"%s\"\n", index_string.c_str());
+    gzFile index_file = gzopen( index_string.c_str(), "rb" );
+    if (index_file == NULL)
+    {
+        log_error(stderr,"  unable to open index file \"%s\"\n", index_string.c_str());
+        return false;
+    }
+
+    char magic[4];
+    if (gzread( index_file, magic, 4 ) != 4 || strncmp( magic, "PRIB", 4 ) != 0)
+    {
+        log_error(stderr,"  \"%s\" is not a binary BWT index file\n", index_string.c_str());
+        gzclose( index_file );
+        return false;
+    }
+
+    const uint32 BATCH_SIZE = 1024*1024;
+    for (;;)
+    {
+        const size_t n = h_dollars.size();
+        h_dollars.resize( n + BATCH_SIZE );
+
+        const int n_bytes = gzread( index_file, &h_dollars[n], uint32( BATCH_SIZE * sizeof(bwt_dollar_type) ) );
+        if (n_bytes < 0)
+        {
+            log_error(stderr,"  failed reading index file \"%s\"\n", index_string.c_str());
+            gzclose( index_file );
+            return false;
+        }
+        h_dollars.resize( n + n_bytes / sizeof(bwt_dollar_type) );
+
+        if (uint32( n_bytes ) < BATCH_SIZE * sizeof(bwt_dollar_type))
+            break;
+    }
+    gzclose( index_file );
+
+    if (h_dollars.empty() || h_dollars.back().second != uint64(-1))
+    {
+        log_error(stderr,"  index file \"%s\" is truncated or was written without a length terminator\n", index_string.c_str());
+        return false;
+    }
+    return true;
+}
+
+// read the packed words of a 2-bit BWT file
+//
+bool read_bwt_words(const char* input_name, const uint64 n_symbols, uint32* words)
+{
+    log_verbose(stderr,"  opening bwt file \"%s\"\n", input_name);
+    gzFile bwt_file = gzopen( input_name, "rb" );
+    if (bwt_file == NULL)
+    {
+        log_error(stderr,"  unable to open bwt file \"%s\"\n", input_name);
+        return false;
+    }
+
+    uint8*       ptr     = (uint8*)words;
+    const uint64 n_bytes = util::divide_ri( n_symbols, BWT_SYMBOLS_PER_WORD ) * sizeof(uint32);
+
+    for (uint64 offset = 0; offset < n_bytes; offset += BWT_CHUNK_SIZE)
+    {
+        const uint32 chunk = uint32( nvbio::min( n_bytes - offset, uint64( BWT_CHUNK_SIZE ) ) );
+        if (gzread( bwt_file, ptr + offset, chunk ) != int( chunk ))
+        {
+            log_error(stderr,"  bwt file \"%s\" is truncated (expected %llu symbols)\n", input_name, n_symbols);
+            gzclose( bwt_file );
+            return false;
+        }
+    }
+    gzclose( bwt_file );
+    return true;
+}
+
+} // anonymous namespace
+
+// load a 2-bit packed string-set BWT file
+//
+bool load_bwt_file(const char* input_name, PagedText<2,true>& bwt, SparseSymbolSet& dollars)
+{
+    std::string index_string;
+    if (bwt_index_name( input_name, index_string ) == false)
+        return false;
+
+    // read the dollars
+    std::vector<bwt_dollar_type> h_dollars;
+    if (read_bwt_index( index_string, h_dollars ) == false)
+        return false;
+
+    const uint64 n_symbols = h_dollars.back().first;
+    const uint32 n_dollars = uint32( h_dollars.size() - 1u );
+
+    // read the packed BWT straight into the pages of the text
+    {
+        typedef PagedText<2,true>::word_type page_word_type;
+
+        log_verbose(stderr,"  opening bwt file \"%s\"\n", input_name);
+        gzFile bwt_file = gzopen( input_name, "rb" );
+        if (bwt_file == NULL)
+        {
+            log_error(stderr,"  unable to open bwt file \"%s\"\n", input_name);
+            return false;
+        }
+
+        bwt.resize_pages( n_symbols );
+
+        for (uint32 p = 0; p < bwt.page_count(); ++p)
+        {
+            // each page holds a whole number of file words, as page_symbols() is a multiple of BWT_SYMBOLS_PER_WORD
+            const uint64 page_words = util::divide_ri( bwt.get_page_size(p), BWT_SYMBOLS_PER_WORD );
+
+            page_word_type* page = bwt.get_page_storage(p);
+            uint8*          ptr  = (uint8*)page;
+
+            // clear the last page word, which might be only half-filled by the file
+            page[ (page_words - 1u) / 2u ] = 0u;
+
+            const uint64 n_bytes = page_words * sizeof(uint32);
+            for (uint64 offset = 0; offset < n_bytes; offset += BWT_CHUNK_SIZE)
+            {
+                const uint32 chunk = uint32( nvbio::min( n_bytes - offset, uint64( BWT_CHUNK_SIZE ) ) );
+                if (gzread( bwt_file, ptr + offset, chunk ) != int( chunk ))
+                {
+                    log_error(stderr,"  bwt file \"%s\" is truncated (expected %llu symbols)\n", input_name, n_symbols);
+                    gzclose( bwt_file );
+                    return false;
+                }
+            }
+
+            // the file stores big-endian packed 32-bit words: each 64-bit page word is made of
+            // a pair of them, the first holding its most significant symbols
+            const uint64 n_page_words = util::divide_ri( page_words, 2u );
+
+            #pragma omp parallel for
+            for (int64 i = 0; i < int64( n_page_words ); ++i)
+                page[i] = (page[i] << 32) | (page[i] >> 32);
+        }
+        gzclose( bwt_file );
+
+        // rebuild the occurrence tables
+        bwt.update_counters();
+    }
+
+    log_verbose(stderr,"  loaded %llu symbols, %u dollars\n", n_symbols, n_dollars);
+
+    // and set the dollars
+    {
+        std::vector<uint64> h_pos( n_dollars + 1u );
+        std::vector<uint64> h_ids( n_dollars + 1u );
+
+        #pragma omp parallel for
+        for (int32 i = 0; i < int32( n_dollars ); ++i)
+        {
+            h_pos[i] = h_dollars[i].first;
+            h_ids[i] = h_dollars[i].second;
+        }
+
+        dollars.set( n_symbols, n_dollars, &h_pos[0], &h_ids[0] );
+    }
+    return true;
+}
+
+// load a string-set FM-index from a 2-bit BWT file and the occurrence table written alongside it
+//
+bool load_fmindex_file(const char* input_name, SetBWTFMIndex& index)
+{
+    static const uint32 SYMBOL_COUNT = 4u;
+
+    std::string index_string;
+    if (bwt_index_name( input_name, index_string ) == false)
+        return false;
+
+    // read the dollars
+    std::vector<bwt_dollar_type> h_dollars;
+    if (read_bwt_index( index_string, h_dollars ) == false)
+        return false;
+
+    const uint64 n_symbols = h_dollars.back().first;
+    const uint64 n_dollars = h_dollars.size() - 1u;
+
+    if (n_symbols == 0u)
+    {
+        log_error(stderr,"  bwt file \"%s\" is empty\n", input_name);
+        return false;
+    }
+
+    // read the occurrence table
+    const std::string occ_string = occ_file_name( input_name );
+    {
+        log_verbose(stderr,"  opening occurrence table file \"%s\"\n", occ_string.c_str());
+        FILE* occ_file = fopen( occ_string.c_str(), "rb" );
+        if (occ_file == NULL)
+        {
+            log_error(stderr,"  unable to open occurrence table file \"%s\"\n", occ_string.c_str());
+            return false;
+        }
+
+        char   magic[4];
+        uint32 occ_intv;
+        uint64 header[2 + SYMBOL_COUNT + SYMBOL_COUNT+1];
+
+        if (fread( magic,     sizeof(char),   4,                 occ_file ) != 4 ||
+            fread( &occ_intv, sizeof(uint32), 1,                 occ_file ) != 1 ||
+            fread( header,    sizeof(uint64), sizeof(header)/8u, occ_file ) != sizeof(header)/8u ||
+            strncmp( magic, "OCCB", 4 ) != 0 ||
+            occ_intv == 0 || (occ_intv & (occ_intv-1)) != 0)
+        {
+            log_error(stderr,"  \"%s\" is not a binary occurrence table file\n", occ_string.c_str());
+            fclose( occ_file );
+            return false;
+        }
+        if (header[0] != n_symbols || header[1] != n_dollars)
+        {
+            log_error(stderr,"  occurrence table file \"%s\" doesn't match the BWT (%llu symbols and %llu dollars, expected %llu and %llu)\n",
+                occ_string.c_str(), header[0], header[1], n_symbols, n_dollars);
+            fclose( occ_file );
+            return false;
+        }
+
+        const uint64 n_samples = util::divide_ri( n_symbols, occ_intv );
+
+        index.m_occ_intv = occ_intv;
+        index.m_occ.resize( n_samples * SYMBOL_COUNT );
+
+        const size_t n_read = fread( nvbio::raw_pointer( index.m_occ ), sizeof(uint64), size_t( n_samples * SYMBOL_COUNT ), occ_file );
+        fclose( occ_file );
+
+        if (n_read != n_samples * SYMBOL_COUNT)
+        {
+            log_error(stderr,"  occurrence table file \"%s\" is truncated\n", occ_string.c_str());
+            return false;
+        }
+
+        // shift the L2 array by one, as fm_index accounts for a single primary dollar sorted first
+        for (uint32 c = 0; c <= SYMBOL_COUNT; ++c)
+            index.m_L2[c] = header[2 + SYMBOL_COUNT + c] - 1u;
+    }
+
+    // read the packed BWT
+    index.m_length = n_symbols;
+    index.m_words.resize( util::divide_ri( n_symbols, BWT_SYMBOLS_PER_WORD ) );
+    if (read_bwt_words( input_name, n_symbols, nvbio::raw_pointer( index.m_words ) ) == false)
+        return false;
+
+    // and set the dollars
+    index.m_dollars.resize( n_dollars );
+
+    #pragma omp parallel for
+    for (int64 i = 0; i < int64( n_dollars ); ++i)
+        index.m_dollars[i] = h_dollars[i].first;
+
+    log_verbose(stderr,"  loaded %llu symbols, %llu dollars\n", n_symbols, n_dollars);
+    return true;
+}
+
+// output a 2-bit paged string-set BWT through a given handler
+//
+void output_bwt(const PagedText<2,true>& bwt, const SparseSymbolSet& dollars, SetBWTHandler& handler)
+{
+    static const uint32 SYMBOLS_PER_WORD = PagedText<2,true>::SYMBOLS_PER_WORD;
+
+    std::vector<uint32> h_words;
+
+    for (uint32 i = 0; i < bwt.page_count(); ++i)
+    {
+        // find the dollars corresponding to this page
+        const uint64 page_begin = bwt.get_page_offset(i);
+        const uint64 page_end   = bwt.get_page_offset(i+1);
+
+        const uint64 dollars_begin = nvbio::lower_bound_index(
+            page_begin,
+            dollars.pos(),
+            dollars.size() );
+
+        const uint64 dollars_end = nvbio::lower_bound_index(
+            page_end,
+            dollars.pos(),
+            dollars.size() );
+
+        // the pages are packed in big-endian 64-bit words, while the handlers expect big-endian
+        // 32-bit words: split each word, most significant half first
+        const uint32  n_symbols = bwt.get_page_size(i);
+        const uint32  n_words   = util::divide_ri( n_symbols, SYMBOLS_PER_WORD );
+        const uint64* page      = bwt.get_page(i);
+
+        h_words.resize( n_words * 2u );
+        for (uint32 w = 0; w < n_words; ++w)
+        {
+            h_words[ w*2u ]      = uint32( page[w] >> 32 );
+            h_words[ w*2u + 1u ] = uint32( page[w] );
+        }
+
+        // and output the page
+        handler.process(
+            n_symbols,
+            2u,
+            n_words ? &h_words[0] : NULL,
+            uint32( dollars_end - dollars_begin ),
+            dollars.pos() + dollars_begin,
+            dollars.ids() + dollars_begin );
+    }
+}
+
+// open a BWT file together with a streamed FM-index occurrence table
+//
+SetBWTHandler* open_fmindex_file(const char* output_name, const char* params, const uint32 occ_intv)
+{
+    if (occ_intv == 0 || (occ_intv & (occ_intv-1)) != 0)
+    {
+        log_error(stderr,"  the occurrence table sampling interval must be a power of 2 (%u)\n", occ_intv);
+        return NULL;
+    }
+
+    // derive the occurrence table name stripping the BWT suffix
+    const std::string occ_string = occ_file_name( output_name );
+
+    SetBWTHandler* bwt_handler = open_bwt_file( output_name, params );
+    if (bwt_handler == NULL)
+        return NULL;
+
+    FMIndexFileBWTHandler* file_handler = new FMIndexFileBWTHandler( bwt_handler, occ_intv );
+    if (file_handler->open( occ_string.c_str() ) == false)
+    {
+        log_error(stderr,"  unable to open output file \"%s\"\n", occ_string.c_str());
+        delete file_handler;
+        return NULL;
+    }
+    return file_handler;
+}
+
 } // namespace nvbio
@@ -28,6 +28,10 @@
 #pragma once
 
 #include <nvbio/sufsort/sufsort_utils.h>
+#include <nvbio/fmindex/paged_text.h>
+#include <nvbio/fmindex/fmindex.h>
+#include <nvbio/fmindex/set_rank_dictionary.h>
+#include <nvbio/basic/vector.h>
 
 namespace nvbio {
 
@@ -66,15 +70,130 @@ namespace nvbio {
 /// The binary file has the form:
 ///\verbatim
 ///char[4] header = "PRIB";
-///struct { uint64 position; uint32 string_id; } pairs[n];
+///struct { uint64 position; uint64 string_id; } pairs[n];
+///struct { uint64 length;   uint64 terminator = -1; } footer;
 ///\endverbatim
 ///
+/// where the footer records the total number of symbols in the BWT, so that the packed
+/// file can be loaded back with load_bwt_file().
+///
 /// \param output_name      output name
 /// \param params           additional compression parameters (e.g. "1R", "9", etc)
 /// \return     a handler that can be used by the string-set BWT construction functions
 ///
 SetBWTHandler* open_bwt_file(const char* output_name, const char* params);
 
+/// open a string-set BWT file as in open_bwt_file(), additionally streaming out the FM-index
+/// occurrence table, symbol counts and L2 array of the BWT as its blocks are emitted, so that
+/// no further pass over the output is needed to make it query-ready.
+/// The table is written to a (.occ) file named after the output, stripped of its extension,
+/// and has the form:
+///\verbatim
+///char[4] header = "OCCB";
+///uint32  occ_intv;
+///uint64  length;
+///uint64  n_dollars;
+///uint64  count[4];
+///uint64  L2[5];
+///uint64  occ[(length + occ_intv-1) / occ_intv][4];
+///\endverbatim
+///
+/// where occ[k][c] counts the occurrences of symbol c in the range [0,k*occ_intv) of the BWT,
+/// dollars excluded, and L2[c] = n_dollars + count[0] + ... + count[c-1], i.e. all dollars are
+/// sorted before any other symbol.
+/// Only 2-bit DNA BWTs are supported: the handler throws a runtime_error on any other input.
+/// The output can be loaded back as a query-ready FM-index with load_fmindex_file().
+///
+/// \param output_name      output name
+/// \param params           additional compression parameters (e.g. "1R", "9", etc)
+/// \param occ_intv         the occurrence table sampling interval, a power of 2
+/// \return     a handler that can be used by the string-set BWT construction functions
+///
+SetBWTHandler* open_fmindex_file(const char* output_name, const char* params, const uint32 occ_intv = 64u);
+
+/// load a 2-bit packed string-set BWT file (.bwt|.bwt.gz|.bwt.bgz) previously written by
+/// open_bwt_file(), together with its primary dollars index, so that new strings can be
+/// merged into it, e.g. by BWTEContext::merge_block().
+///
+/// \param input_name       input name
+/// \param bwt              the output paged text
+/// \param dollars          the output set of dollar positions and string ids
+/// \return                 true on success
+///
+bool load_bwt_file(const char* input_name, PagedText<2,true>& bwt, SparseSymbolSet& dollars);
+
+///
+/// A host string-set FM-index, loaded by load_fmindex_file() from the BWT and occurrence table
+/// files written by open_fmindex_file().
+///\par
+/// The BWT matrix has one row per BWT symbol, the first n_dollars() rows corresponding to the
+/// suffixes starting with a dollar; the fm_index returned by index() spans all of them, i.e.
+/// match() starts from the full range [0,length()-1] and returns ranges in the same coordinates.
+/// No sampled suffix array is available, so that the index can be used for rank() and match(),
+/// but not locate().
+///
+struct SetBWTFMIndex
+{
+    typedef SetBWTRankDictionary                            rank_dictionary_type;
+    typedef fm_index<rank_dictionary_type,null_type>        fm_index_type;
+
+    /// constructor
+    ///
+    SetBWTFMIndex() : m_length( 0 ), m_occ_intv( 0 ) {}
+
+    /// return the number of BWT symbols, dollars included
+    ///
+    uint64 length() const { return m_length; }
+
+    /// return the number of dollars, i.e. of strings
+    ///
+    uint64 n_dollars() const { return m_dollars.size(); }
+
+    /// return the fm_index, valid as long as this object is alive and unmodified
+    ///
+    fm_index_type index() const
+    {
+        // the dictionary excludes all dollars from the counts: hence, setting the
+        // primary past the end avoids fm_index's own single-dollar correction
+        return fm_index_type(
+            m_length - 1u,
+            m_length,
+            m_L2,
+            rank_dictionary_type(
+                nvbio::raw_pointer( m_words ),
+                nvbio::log2( m_occ_intv ),
+                nvbio::raw_pointer( m_occ ),
+                m_dollars.size(),
+                nvbio::raw_pointer( m_dollars ) ),
+            null_type() );
+    }
+
+    uint64                          m_length;       ///< number of BWT symbols
+    uint32                          m_occ_intv;     ///< occurrence table sampling interval
+    uint64                          m_L2[5];        ///< the L2 array, minus the single primary dollar fm_index accounts for
+    nvbio::vector<host_tag,uint32>  m_words;        ///< the packed BWT
+    nvbio::vector<host_tag,uint64>  m_occ;          ///< the sampled occurrence table
+    nvbio::vector<host_tag,uint64>  m_dollars;      ///< the sorted dollar positions
+};
+
+/// load a string-set FM-index from a 2-bit packed BWT file (.bwt|.bwt.gz|.bwt.bgz), its primary
+/// dollars index and the (.occ) occurrence table written alongside them by open_fmindex_file()
+///
+/// \param input_name       input name
+/// \param index            the output FM-index
+/// \return                 true on success
+///
+bool load_fmindex_file(const char* input_name, SetBWTFMIndex& index);
+
+/// output a 2-bit paged string-set BWT, e.g. as built by BWTEContext::merge_block(), through
+/// a given handler one page at a time, together with the dollars falling in each page
+///
+/// \param bwt              the input paged text
+/// \param dollars          the input set of dollar positions and string ids
+/// \param handler          the output handler
+///
+void output_bwt(const PagedText<2,true>& bwt, const SparseSymbolSet& dollars, SetBWTHandler& handler);
+
 ///@}
 
 } // namespace nvbio
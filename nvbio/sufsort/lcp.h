@@ -0,0 +1,176 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <nvbio/basic/types.h>
+#include <nvbio/basic/numbers.h>
+#include <nvbio/basic/vector.h>
+
+namespace nvbio {
+
+///@addtogroup Sufsort
+///@{
+
+///
+///@defgroup LCPModule LCP Construction
+/// This module contains a series of host-side functions to build the LCP array of a string,
+/// i.e. the array of the lengths of the longest common prefixes between consecutive suffixes
+/// in lexicographic order, given its suffix array.
+/// The construction follows the <i>Phi</i> algorithm described in:\n
+/// "Permuted Longest-Common-Prefix Array" \n
+/// J.Karkkainen, G.Manzini, S.J.Puglisi, CPM 2009 \n
+/// which is parallelized by splitting the text in independent ranges.
+/// The suffix arrays are expected <i>not</i> to include the empty suffix, i.e. SA[0] is the
+/// index of the lexicographically smallest non-empty suffix, and by convention LCP[0] = 0.
+///@{
+
+/// Compute the <i>permuted</i> LCP array of a host-side string, given its suffix array:
+/// PLCP[SA[i]] = LCP[i].
+///
+/// \tparam string_type             a random access string
+/// \tparam sa_iterator             a uint32 random access iterator to the suffix array
+/// \tparam plcp_iterator           a uint32 random access iterator to the output PLCP
+///
+/// \param string_len               the length of the string
+/// \param string                   the string
+/// \param sa                       the suffix array
+/// \param plcp                     the output PLCP array, also used as temporary storage
+///
+template <typename string_type, typename sa_iterator, typename plcp_iterator>
+void plcp(
+    const uint32        string_len,
+    const string_type   string,
+    const sa_iterator   sa,
+    plcp_iterator       plcp);
+
+/// Permute a PLCP array into the LCP array: LCP[i] = PLCP[SA[i]].
+///
+/// \param string_len               the length of the string
+/// \param sa                       the suffix array
+/// \param plcp                     the PLCP array
+/// \param lcp                      the output LCP array
+///
+template <typename sa_iterator, typename plcp_iterator, typename lcp_iterator>
+void plcp_to_lcp(
+    const uint32        string_len,
+    const sa_iterator   sa,
+    const plcp_iterator plcp,
+    lcp_iterator        lcp);
+
+/// Compute the LCP array of a host-side string, given its suffix array.
+/// This function needs 4 bytes of temporary host memory per symbol.
+///
+/// \param string_len               the length of the string
+/// \param string                   the string
+/// \param sa                       the suffix array
+/// \param lcp                      the output LCP array
+///
+template <typename string_type, typename sa_iterator, typename lcp_iterator>
+void lcp(
+    const uint32        string_len,
+    const string_type   string,
+    const sa_iterator   sa,
+    lcp_iterator        lcp);
+
+/// A sparse PLCP array, retaining only one every <i>sampling</i> entries, which can be used
+/// to stream out the LCP array of a large string block by block in a confined amount of memory.
+/// The sampled entries bound the remaining ones from below, as PLCP[j] >= PLCP[j-d] - d,
+/// so that computing any LCP entry takes at most sampling extra symbol comparisons.
+///
+/// \code
+/// SampledPLCP plcp;
+/// plcp.build( string_len, string, sa, 32u );
+///
+/// // stream the LCP array in blocks of 16M entries
+/// for (uint32 block_begin = 0; block_begin < string_len; block_begin += 16*1024*1024)
+/// {
+///     const uint32 block_end = nvbio::min( block_begin + 16*1024*1024, string_len );
+///     plcp.lcp( string_len, string, sa, block_begin, block_end, nvbio::raw_pointer( lcp_block ) );
+///     ...
+/// }
+/// \endcode
+///
+struct SampledPLCP
+{
+    static const uint32 BLOCK_SIZE = 1024*1024;     ///< number of entries processed by each parallel task
+
+    /// constructor
+    ///
+    SampledPLCP() : m_sampling( 1u ) {}
+
+    /// build the sampled PLCP array
+    ///
+    /// \param string_len               the length of the string
+    /// \param string                   the string
+    /// \param sa                       the suffix array
+    /// \param sampling                 the PLCP sampling interval
+    ///
+    template <typename string_type, typename sa_iterator>
+    void build(
+        const uint32        string_len,
+        const string_type   string,
+        const sa_iterator   sa,
+        const uint32        sampling);
+
+    /// compute the [begin,end) block of the LCP array
+    ///
+    /// \param string_len               the length of the string
+    /// \param string                   the string
+    /// \param sa                       the suffix array
+    /// \param begin                    the beginning of the LCP block
+    /// \param end                      the end of the LCP block
+    /// \param lcp                      the output LCP block
+    ///
+    template <typename string_type, typename sa_iterator, typename lcp_iterator>
+    void lcp(
+        const uint32        string_len,
+        const string_type   string,
+        const sa_iterator   sa,
+        const uint32        begin,
+        const uint32        end,
+        lcp_iterator        lcp) const;
+
+    /// return the sampling interval
+    ///
+    uint32 sampling() const { return m_sampling; }
+
+    /// return the number of samples
+    ///
+    uint32 size() const { return uint32( m_plcp.size() ); }
+
+    uint32                          m_sampling;
+    nvbio::vector<host_tag,uint32>  m_plcp;
+};
+
+///@} LCPModule
+///@} Sufsort
+
+} // namespace nvbio
+
+#include <nvbio/sufsort/lcp_inl.h>
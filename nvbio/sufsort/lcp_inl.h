@@ -0,0 +1,233 @@
+/*
+ * nvbio
+ * Copyright (c) 2011-2014, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    * Neither the name of the NVIDIA CORPORATION nor the
+ *      names of its contributors may be used to endorse or promote products
+ *      derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <nvbio/basic/omp.h>
+
+namespace nvbio {
+
+namespace priv {
+
+// extend a known common prefix of length l between the suffixes starting at i and j
+//
+template <typename string_type>
+uint32 lcp_extend(
+    const uint32        string_len,
+    const string_type   string,
+    const uint32        i,
+    const uint32        j,
+    uint32              l)
+{
+    while (i + l < string_len &&
+           j + l < string_len &&
+           string[i + l] == string[j + l])
+        ++l;
+
+    return l;
+}
+
+} // namespace priv
+
+// compute the permuted LCP array of a host-side string
+//
+template <typename string_type, typename sa_iterator, typename plcp_iterator>
+void plcp(
+    const uint32        string_len,
+    const string_type   string,
+    const sa_iterator   sa,
+    plcp_iterator       plcp)
+{
+    if (string_len == 0)
+        return;
+
+    // compute the Phi array, storing it in the output: Phi[SA[i]] = SA[i-1],
+    // marking the smallest suffix, which has no predecessor, with string_len
+    plcp[ sa[0] ] = string_len;
+
+    #pragma omp parallel for
+    for (int64 i = 1; i < int64( string_len ); ++i)
+        plcp[ sa[i] ] = sa[i-1];
+
+    // compute the PLCP in place, splitting the text in independent ranges: within a range
+    // the PLCP decreases by at most one per position, so that each extension can restart
+    // from the previous value minus one
+    const uint32 BLOCK_SIZE = SampledPLCP::BLOCK_SIZE;
+    const int64  n_blocks   = int64( util::divide_ri( string_len, BLOCK_SIZE ) );
+
+    #pragma omp parallel for schedule(dynamic,1)
+    for (int64 b = 0; b < n_blocks; ++b)
+    {
+        const uint32 block_begin = uint32( b ) * BLOCK_SIZE;
+        const uint32 block_end   = nvbio::min( block_begin + BLOCK_SIZE, string_len );
+
+        uint32 l = 0;
+        for (uint32 i = block_begin; i < block_end; ++i)
+        {
+            const uint32 phi = plcp[i];
+            if (phi == string_len)
+            {
+                plcp[i] = 0u;
+                l = 0u;
+                continue;
+            }
+
+            l = priv::lcp_extend( string_len, string, i, phi, l );
+
+            plcp[i] = l;
+
+            l = l ? l - 1u : 0u;
+        }
+    }
+}
+
+// permute a PLCP array into the LCP array
+//
+template <typename sa_iterator, typename plcp_iterator, typename lcp_iterator>
+void plcp_to_lcp(
+    const uint32        string_len,
+    const sa_iterator   sa,
+    const plcp_iterator plcp,
+    lcp_iterator        lcp)
+{
+    if (string_len == 0)
+        return;
+
+    lcp[0] = 0u;
+
+    #pragma omp parallel for
+    for (int64 i = 1; i < int64( string_len ); ++i)
+        lcp[i] = plcp[ sa[i] ];
+}
+
+// compute the LCP array of a host-side string
+//
+template <typename string_type, typename sa_iterator, typename lcp_iterator>
+void lcp(
+    const uint32        string_len,
+    const string_type   string,
+    const sa_iterator   sa,
+    lcp_iterator        lcp)
+{
+    nvbio::vector<host_tag,uint32> plcp_vec( string_len );
+
+    plcp( string_len, string, sa, nvbio::raw_pointer( plcp_vec ) );
+    plcp_to_lcp( string_len, sa, nvbio::raw_pointer( plcp_vec ), lcp );
+}
+
+// build the sampled PLCP array
+//
+template <typename string_type, typename sa_iterator>
+void SampledPLCP::build(
+    const uint32        string_len,
+    const string_type   string,
+    const sa_iterator   sa,
+    const uint32        sampling)
+{
+    m_sampling = nvbio::max( sampling, 1u );
+
+    const uint32 n_samples = util::divide_ri( string_len, m_sampling );
+
+    m_plcp.resize( n_samples );
+    if (n_samples == 0)
+        return;
+
+    uint32* plcp = nvbio::raw_pointer( m_plcp );
+
+    // compute the sampled Phi array, Phi[SA[i] / sampling] = SA[i-1], for SA[i] % sampling = 0
+    #pragma omp parallel for
+    for (int64 i = 0; i < int64( string_len ); ++i)
+    {
+        const uint32 j = sa[i];
+        if (j % m_sampling == 0)
+            plcp[ j / m_sampling ] = i ? sa[i-1] : string_len;
+    }
+
+    // compute the sampled PLCP in place: PLCP[j + sampling] >= PLCP[j] - sampling
+    const uint32 BLOCK_SIZE = SampledPLCP::BLOCK_SIZE;
+    const int64  n_blocks   = int64( util::divide_ri( n_samples, BLOCK_SIZE ) );
+
+    #pragma omp parallel for schedule(dynamic,1)
+    for (int64 b = 0; b < n_blocks; ++b)
+    {
+        const uint32 block_begin = uint32( b ) * BLOCK_SIZE;
+        const uint32 block_end   = nvbio::min( block_begin + BLOCK_SIZE, n_samples );
+
+        uint32 l = 0;
+        for (uint32 k = block_begin; k < block_end; ++k)
+        {
+            const uint32 phi = plcp[k];
+            if (phi == string_len)
+            {
+                plcp[k] = 0u;
+                l = 0u;
+                continue;
+            }
+
+            l = priv::lcp_extend( string_len, string, k * m_sampling, phi, l );
+
+            plcp[k] = l;
+
+            l = l > m_sampling ? l - m_sampling : 0u;
+        }
+    }
+}
+
+// compute the [begin,end) block of the LCP array
+//
+template <typename string_type, typename sa_iterator, typename lcp_iterator>
+void SampledPLCP::lcp(
+    const uint32        string_len,
+    const string_type   string,
+    const sa_iterator   sa,
+    const uint32        begin,
+    const uint32        end,
+    lcp_iterator        lcp) const
+{
+    const uint32* plcp = nvbio::raw_pointer( m_plcp );
+
+    #pragma omp parallel for
+    for (int64 i = int64( begin ); i < int64( end ); ++i)
+    {
+        if (i == 0)
+        {
+            lcp[0] = 0u;
+            continue;
+        }
+
+        const uint32 j = sa[i];
+        const uint32 d = j % m_sampling;
+
+        // start from the lower bound given by the preceding sample
+        const uint32 l = plcp[ j / m_sampling ] > d ? plcp[ j / m_sampling ] - d : 0u;
+
+        lcp[i - begin] = priv::lcp_extend( string_len, string, j, sa[i-1], l );
+    }
+}
+
+} // namespace nvbio
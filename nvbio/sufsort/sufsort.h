@@ -63,6 +63,10 @@
 /// "GPU-Accelerated BWT Construction for Large Collection of Short Reads" \n
 /// C.M. Liu, R.Luo, T-W. Lam \n
 /// http://arxiv.org/abs/1401.7457
+///\par
+/// The LCP array of a string can be derived on the host from its suffix array, either directly
+/// or block by block through a sampled PLCP (see \ref LCPModule), and the \ref StringLCPHandler
+/// allows to request it through the same suffix handler interface used for the BWT and the SSA.
 ///
 /// \section PerformanceSection Performance
 ///\par
@@ -28,6 +28,7 @@
 #pragma once
 
 #include <nvbio/sufsort/sufsort_priv.h>
+#include <nvbio/sufsort/lcp.h>
 #include <nvbio/strings/string_set.h>
 #include <nvbio/basic/thrust_view.h>
 #include <nvbio/basic/vector.h>
@@ -580,6 +581,83 @@ struct StringBWTSSAHandler
     StringSSAHandler<output_ssa_iterator>             ssa_handler;
 };
 
+/// a utility \ref StringSuffixHandler to retain the full Suffix Array on the host
+/// and derive the LCP array of the sorted suffixes.
+/// As for the StringSSAHandler, the output suffix array includes the implicit empty
+/// suffix in its first slot, while the LCP array covers the remaining string_len
+/// non-empty suffixes.
+///
+template <typename host_string_type, typename output_sa_iterator>
+struct StringLCPHandler
+{
+    // constructor
+    //
+    StringLCPHandler(
+        const uint32            _string_len,
+        const host_string_type  _string,
+        output_sa_iterator      _sa) :
+        string_len  ( _string_len ),
+        string      ( _string ),
+        sa          ( _sa ),
+        sa_handler  ( _string_len, 1u, _sa ) {}
+
+    // process the next batch of suffixes
+    //
+    void process_batch(
+        const uint32  n_suffixes,
+        const uint32* d_suffixes)
+    {
+        sa_handler.process_batch( n_suffixes, d_suffixes );
+    }
+
+    // process a sparse set of suffixes
+    //
+    void process_scattered(
+        const uint32  n_suffixes,
+        const uint32* d_suffixes,
+        const uint32* d_slots)
+    {
+        sa_handler.process_scattered( n_suffixes, d_suffixes, d_slots );
+    }
+
+    // compute the LCP array, once all suffixes have been sorted
+    //
+    template <typename lcp_iterator>
+    void lcp(lcp_iterator output) const
+    {
+        nvbio::lcp( string_len, string, sa + 1u, output );
+    }
+
+    // compute the LCP array, streaming it out in blocks through a sampled PLCP
+    // to reduce the amount of temporary storage to 4 bytes every sampling symbols;
+    // the block handler must implement:
+    //
+    //   void process(const uint32 block_begin, const uint32 block_end, const uint32* lcp);
+    //
+    template <typename block_handler>
+    void lcp(const uint32 sampling, const uint32 block_size, block_handler& handler) const
+    {
+        SampledPLCP plcp;
+        plcp.build( string_len, string, sa + 1u, sampling );
+
+        nvbio::vector<host_tag,uint32> block( nvbio::min( block_size, string_len ) );
+
+        for (uint32 block_begin = 0; block_begin < string_len; block_begin += block_size)
+        {
+            const uint32 block_end = nvbio::min( block_begin + block_size, string_len );
+
+            plcp.lcp( string_len, string, sa + 1u, block_begin, block_end, nvbio::raw_pointer( block ) );
+
+            handler.process( block_begin, block_end, nvbio::raw_pointer( block ) );
+        }
+    }
+
+    const uint32                            string_len;
+    const host_string_type                  string;
+    output_sa_iterator                      sa;
+    StringSSAHandler<output_sa_iterator>    sa_handler;
+};
+
 ///@} StringSuffixHandlersModule
 
 ///@} Sufsort
@@ -0,0 +1,119 @@
+/*
+ * PROJECT: Pairwise sequence alignments on GPU
+ * FILE: psa_simd_cpu
+ * AUTHOR(S): Alejandro Chacon <alejandro.chacon@uab.es>
+ * DESCRIPTION: Thin wrappers over the x86 SIMD instructions used by the CPU SW-Gotoh
+ *				implementations. Each vector packs SIMD_LANES signed 16 bits cells:
+ *				(A) AVX-512BW: 32 cells per register (compile with -mavx512bw)
+ *				(B) AVX2:      16 cells per register (compile with -mavx2)
+ */
+
+#ifndef PSA_SIMD_CPU_H_
+#define PSA_SIMD_CPU_H_
+
+#include <immintrin.h>
+#include "psa_commons.h"
+
+#if defined(__AVX512BW__)
+
+#define SIMD_ISA				"AVX-512BW"
+#define SIMD_TAG				"avx512"
+#define SIMD_LANES				32
+#define SIMD_ALIGNMENT			64
+
+typedef __m512i simd16_t;
+
+static inline simd16_t simd16_zero()								{ return(_mm512_setzero_si512()); }
+static inline simd16_t simd16_set1(const int16_t a)					{ return(_mm512_set1_epi16(a)); }
+static inline simd16_t simd16_load(const void *p)					{ return(_mm512_load_si512(p)); }
+static inline void     simd16_store(void *p, const simd16_t a)		{ _mm512_store_si512(p, a); }
+static inline simd16_t simd16_adds(const simd16_t a, const simd16_t b)	{ return(_mm512_adds_epi16(a, b)); }
+static inline simd16_t simd16_subs(const simd16_t a, const simd16_t b)	{ return(_mm512_subs_epi16(a, b)); }
+static inline simd16_t simd16_subs_u(const simd16_t a, const simd16_t b)	{ return(_mm512_subs_epu16(a, b)); }
+static inline simd16_t simd16_max(const simd16_t a, const simd16_t b)	{ return(_mm512_max_epi16(a, b)); }
+
+/* a == b ? c : d */
+static inline simd16_t simd16_select_eq(const simd16_t a, const simd16_t b, const simd16_t c, const simd16_t d)
+{
+	return(_mm512_mask_blend_epi16(_mm512_cmpeq_epi16_mask(a, b), d, c));
+}
+
+/* any(a > b) */
+static inline int32_t simd16_any_gt(const simd16_t a, const simd16_t b)
+{
+	return(_mm512_cmpgt_epi16_mask(a, b) != 0);
+}
+
+/* shift all the cells one lane up (cell i moves to cell i+1), inserting a zero in the first lane */
+static inline simd16_t simd16_shift_lane(const simd16_t a)
+{
+	static const int16_t idx[SIMD_LANES] __attribute__((aligned(SIMD_ALIGNMENT))) =
+		{ 0,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+		 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30 };
+	return(_mm512_maskz_permutexvar_epi16(0xFFFFFFFEu, _mm512_load_si512(idx), a));
+}
+
+#elif defined(__AVX2__)
+
+#define SIMD_ISA				"AVX2"
+#define SIMD_TAG				"avx2"
+#define SIMD_LANES				16
+#define SIMD_ALIGNMENT			32
+
+typedef __m256i simd16_t;
+
+static inline simd16_t simd16_zero()								{ return(_mm256_setzero_si256()); }
+static inline simd16_t simd16_set1(const int16_t a)					{ return(_mm256_set1_epi16(a)); }
+static inline simd16_t simd16_load(const void *p)					{ return(_mm256_load_si256((const __m256i *) p)); }
+static inline void     simd16_store(void *p, const simd16_t a)		{ _mm256_store_si256((__m256i *) p, a); }
+static inline simd16_t simd16_adds(const simd16_t a, const simd16_t b)	{ return(_mm256_adds_epi16(a, b)); }
+static inline simd16_t simd16_subs(const simd16_t a, const simd16_t b)	{ return(_mm256_subs_epi16(a, b)); }
+static inline simd16_t simd16_subs_u(const simd16_t a, const simd16_t b)	{ return(_mm256_subs_epu16(a, b)); }
+static inline simd16_t simd16_max(const simd16_t a, const simd16_t b)	{ return(_mm256_max_epi16(a, b)); }
+
+/* a == b ? c : d */
+static inline simd16_t simd16_select_eq(const simd16_t a, const simd16_t b, const simd16_t c, const simd16_t d)
+{
+	return(_mm256_blendv_epi8(d, c, _mm256_cmpeq_epi16(a, b)));
+}
+
+/* any(a > b) */
+static inline int32_t simd16_any_gt(const simd16_t a, const simd16_t b)
+{
+	return(_mm256_movemask_epi8(_mm256_cmpgt_epi16(a, b)) != 0);
+}
+
+/* shift all the cells one lane up (cell i moves to cell i+1), inserting a zero in the first lane */
+static inline simd16_t simd16_shift_lane(const simd16_t a)
+{
+	return(_mm256_alignr_epi8(a, _mm256_permute2x128_si256(a, a, 0x08), 14));
+}
+
+#else
+	#error "the CPU SW-Gotoh SIMD implementations require AVX2 (-mavx2) or AVX-512BW (-mavx512bw)"
+#endif
+
+/* horizontal maximum of all the cells */
+static inline int16_t simd16_hmax(const simd16_t a)
+{
+	int16_t cells[SIMD_LANES] __attribute__((aligned(SIMD_ALIGNMENT)));
+	int16_t maxCell;
+	uint32_t idLane;
+
+	simd16_store(cells, a);
+	maxCell = cells[0];
+	for(idLane = 1; idLane < SIMD_LANES; ++idLane)
+		maxCell = MAX(maxCell, cells[idLane]);
+
+	return(maxCell);
+}
+
+/* aligned allocation of SIMD buffers */
+static inline void* simd_malloc(const size_t size)
+{
+	void *ptr = NULL;
+	if (posix_memalign(&ptr, SIMD_ALIGNMENT, size)) return(NULL);
+	return(ptr);
+}
+
+#endif /* PSA_SIMD_CPU_H_ */
@@ -0,0 +1,192 @@
+/*
+ * PROJECT: Pairwise sequence alignments on GPU
+ * FILE: psa_swgotoh_inter_cpu
+ * AUTHOR(S): Alejandro Chacon <alejandro.chacon@uab.es>
+ * DESCRIPTION: Functions for the SW-Gotoh CPU SIMD implementation using:
+ *				(A) LOCAL alignments
+ *				(B) inter-sequence parallelism: each SIMD lane computes a different alignment
+ *				(C) AVX2 / AVX-512BW with 16 bits per cell
+ *				(D) OpenMP to distribute the groups of alignments among the cores
+ */
+
+#include "../../include/psa_pairwise.h"
+#include "../../include/psa_simd_cpu.h"
+#include <omp.h>
+
+#define MATCH_SCORE			 2
+#define MISMATCH_SCORE 		-5
+#define OPEN_INDEL_SCORE	-2
+#define EXTEND_INDEL_SCORE	-1
+
+/* Padding symbols: they never match, so the padded cells can't exceed the real ones */
+#define QUERY_PAD_SYMBOL		0x10
+#define CANDIDATE_PAD_SYMBOL	0x20
+
+#define BUILD_ALGORITHM	"SMITH & WATERMAN GOTOH"
+#define BUILD_VERSION 	"CPU " SIMD_ISA " INTER-SEQUENCE 16bits per cell"
+#define BUILD_TAG		"sw-gotoh.inter.16b." SIMD_TAG ".cpu"
+
+char* buildTag()
+{
+	return (BUILD_TAG);
+}
+
+psaError_t printBuildInfo()
+{
+	printf("%s \n", BUILD_ALGORITHM);
+	printf("%s \n", BUILD_VERSION);
+	printf("CONFIG - MATCH: %d, MISMATCH: %d, OPEN_INDEL: %d, EXTEND_INDEL: %d \n",
+			MATCH_SCORE, MISMATCH_SCORE, OPEN_INDEL_SCORE, EXTEND_INDEL_SCORE);
+	printf("CONFIG - LANES: %d, THREADS: %d \n", SIMD_LANES, omp_get_max_threads());
+	printf("Build: %s - %s \n", __DATE__, __TIME__ );
+
+	return (SUCCESS);
+}
+
+psaError_t transformDataQueries(sequences_t *queries)
+{
+	uint32_t idBase;
+
+	for (idBase = 0; idBase < queries->numASCIIEntries; ++idBase)
+		queries->h_ASCII[idBase] = ASCIItoIndex(ASCIItoUpperCase(queries->h_ASCII[idBase]));
+
+	queries->formats |= SEQ_ASCII;
+
+	return (SUCCESS);
+}
+
+psaError_t transformDataCandidates(sequences_t *candidates)
+{
+	uint32_t idBase;
+
+	for (idBase = 0; idBase < candidates->numASCIIEntries; ++idBase)
+		candidates->h_ASCII[idBase] = ASCIItoIndex(ASCIItoUpperCase(candidates->h_ASCII[idBase]));
+
+	candidates->formats |= SEQ_ASCII;
+
+	return (SUCCESS);
+}
+
+/* Computes SIMD_LANES alignments at once: the sequences are interleaved one base per lane,
+   padded to the longest query (numRows) and candidate (numColumns) of the group. */
+void localProcessSWGInter(const simd16_t *vQuery, uint32_t numRows, const simd16_t *vCandidate, uint32_t numColumns,
+						  simd16_t *vH, simd16_t *vE, int16_t *scores)
+{
+	const simd16_t vZero	 = simd16_zero();
+	const simd16_t vMatch	 = simd16_set1(MATCH_SCORE);
+	const simd16_t vMismatch = simd16_set1(MISMATCH_SCORE);
+	const simd16_t vGapOpen  = simd16_set1(OPEN_INDEL_SCORE);
+	const simd16_t vGapExt   = simd16_set1(EXTEND_INDEL_SCORE);
+	simd16_t vMaxScore = vZero;
+	simd16_t vHDiag, vHLeft, vHCell, vECell, vF, vBase;
+	uint32_t idColumn, idRow;
+
+	for(idRow = 0; idRow < numRows; ++idRow){
+		simd16_store(vH + idRow, vZero);
+		simd16_store(vE + idRow, vZero);
+	}
+
+	// Compute Score SW-GOTOH: one column per candidate base, one row per query base
+	for(idColumn = 0; idColumn < numColumns; ++idColumn){
+		vBase  = simd16_load(vCandidate + idColumn);
+		vHDiag = vZero;
+		vHCell = vZero;
+		vF	   = vZero;
+
+		for(idRow = 0; idRow < numRows; ++idRow){
+			vHLeft = simd16_load(vH + idRow);
+
+			vECell = simd16_max(simd16_adds(simd16_load(vE + idRow), vGapExt), simd16_adds(vHLeft, vGapOpen));
+			vF	   = simd16_max(simd16_adds(vF, vGapExt), simd16_adds(vHCell, vGapOpen));
+
+			vHCell = simd16_adds(vHDiag, simd16_select_eq(simd16_load(vQuery + idRow), vBase, vMatch, vMismatch));
+			vHCell = simd16_max(vHCell, vECell);
+			vHCell = simd16_max(vHCell, vF);
+			vHCell = simd16_max(vHCell, vZero);
+
+			vMaxScore = simd16_max(vMaxScore, vHCell);
+			simd16_store(vE + idRow, vECell);
+			simd16_store(vH + idRow, vHCell);
+			vHDiag = vHLeft;
+		}
+	}
+
+	simd16_store(scores, vMaxScore);
+}
+
+/* Interleaves the sequences of a group of alignments, one base per lane */
+void interleaveSequences(const char *ASCII, const uint32_t *ASCIIposition, const uint32_t *size, const uint32_t *ids,
+						 uint32_t numLanes, uint32_t numBases, int16_t padSymbol, int16_t *interleaved)
+{
+	uint32_t idBase, idLane;
+
+	for(idLane = 0; idLane < SIMD_LANES; ++idLane){
+		const char *sequence = (idLane < numLanes) ? ASCII + ASCIIposition[ids[idLane]] : NULL;
+		const uint32_t sequenceSize = (idLane < numLanes) ? size[ids[idLane]] : 0;
+		for(idBase = 0; idBase < numBases; ++idBase)
+			interleaved[idBase * SIMD_LANES + idLane] = (idBase < sequenceSize) ? sequence[idBase] : padSymbol;
+	}
+}
+
+psaError_t processPairwiseStream(sequences_t *candidates, sequences_t *queries, alignments_t *alignments)
+{
+	const uint32_t numGroups = DIV_CEIL(candidates->num, SIMD_LANES);
+	uint32_t idQuery, idCandidate, maxQuerySize = 0, maxCandidateSize = 0;
+	int32_t idGroup;
+	psaError_t error = SUCCESS;
+
+	for (idQuery = 0; idQuery < queries->num; ++idQuery)
+		maxQuerySize = MAX(maxQuerySize, queries->h_size[idQuery]);
+	for (idCandidate = 0; idCandidate < candidates->num; ++idCandidate)
+		maxCandidateSize = MAX(maxCandidateSize, candidates->h_size[idCandidate]);
+
+	#pragma omp parallel
+	{
+		simd16_t *vQuery	 = (simd16_t *) simd_malloc(maxQuerySize * sizeof(simd16_t));
+		simd16_t *vCandidate = (simd16_t *) simd_malloc(maxCandidateSize * sizeof(simd16_t));
+		simd16_t *vH		 = (simd16_t *) simd_malloc(maxQuerySize * sizeof(simd16_t));
+		simd16_t *vE		 = (simd16_t *) simd_malloc(maxQuerySize * sizeof(simd16_t));
+		int16_t scores[SIMD_LANES] __attribute__((aligned(SIMD_ALIGNMENT)));
+		uint32_t queryIds[SIMD_LANES], candidateIds[SIMD_LANES];
+
+		if ((vQuery == NULL) || (vCandidate == NULL) || (vH == NULL) || (vE == NULL)){
+			#pragma omp critical
+			error = E_ALLOCATE_MEM;
+		}
+
+		#pragma omp for schedule(dynamic, 4)
+		for (idGroup = 0; idGroup < (int32_t) numGroups; ++idGroup)
+		{
+			const uint32_t firstCandidate = idGroup * SIMD_LANES;
+			const uint32_t numLanes = MIN(SIMD_LANES, candidates->num - firstCandidate);
+			uint32_t idLane, numRows = 0, numColumns = 0;
+			if (error != SUCCESS) continue;
+
+			for(idLane = 0; idLane < numLanes; ++idLane){
+				candidateIds[idLane] = firstCandidate + idLane;
+				queryIds[idLane]	 = alignments->h_info[firstCandidate + idLane];
+				numRows	   = MAX(numRows,	 queries->h_size[queryIds[idLane]]);
+				numColumns = MAX(numColumns, candidates->h_size[candidateIds[idLane]]);
+			}
+
+			interleaveSequences(queries->h_ASCII, queries->h_ASCIIposition, queries->h_size, queryIds,
+								numLanes, numRows, QUERY_PAD_SYMBOL, (int16_t *) vQuery);
+			interleaveSequences(candidates->h_ASCII, candidates->h_ASCIIposition, candidates->h_size, candidateIds,
+								numLanes, numColumns, CANDIDATE_PAD_SYMBOL, (int16_t *) vCandidate);
+
+			localProcessSWGInter(vQuery, numRows, vCandidate, numColumns, vH, vE, scores);
+
+			for(idLane = 0; idLane < numLanes; ++idLane){
+				alignments->h_results[firstCandidate + idLane].column = 0;
+				alignments->h_results[firstCandidate + idLane].score  = scores[idLane];
+			}
+		}
+
+		free(vQuery);
+		free(vCandidate);
+		free(vH);
+		free(vE);
+	}
+
+	return (error);
+}
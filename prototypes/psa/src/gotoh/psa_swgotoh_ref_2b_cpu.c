@@ -0,0 +1,280 @@
+/*
+ * PROJECT: Pairwise sequence alignments on GPU
+ * FILE: psa_swgotoh_ref_2b_cpu
+ * AUTHOR(S): Alejandro Chacon <alejandro.chacon@uab.es>
+ * DESCRIPTION: Functions for the SW-Gotoh CPU SIMD implementation using:
+ *				(A) LOCAL alignments
+ *				(B) inter-sequence parallelism: each SIMD lane computes a different alignment
+ *				(C) AVX2 / AVX-512BW with 16 bits per cell
+ *				(D) bases are represented using 2 bits/base.
+ *				(E) reads the candidates from the reference using SIMD gathers, prefetching
+ *				    the reference entries of the next group of alignments
+ */
+
+#include "../../include/psa_pairwise.h"
+#include "../../include/psa_simd_cpu.h"
+#include <omp.h>
+
+#define MATCH_SCORE			 2
+#define MISMATCH_SCORE 		-5
+#define OPEN_INDEL_SCORE	-2
+#define EXTEND_INDEL_SCORE	-1
+
+#define RAW_BASES_PER_ENTRY		(UINT32_LENGTH / RAW_4B_LENGTH)
+
+/* Padding symbols: they never match, so the padded cells can't exceed the real ones */
+#define QUERY_PAD_SYMBOL		0x10
+#define CANDIDATE_PAD_SYMBOL	0x20
+
+#define BUILD_ALGORITHM	"SW-GOTOH: INTER-SEQUENCE USING REFERENCE POS (LOCAL ALIGNMENT)"
+#define BUILD_VERSION 	"CPU " SIMD_ISA " 16bits per cell"
+#define BUILD_TAG		"gotoh.inter.ref.16b." SIMD_TAG ".cpu"
+
+char* buildTag()
+{
+	return (BUILD_TAG);
+}
+
+psaError_t printBuildInfo()
+{
+	printf("%s \n", BUILD_ALGORITHM);
+	printf("%s \n", BUILD_VERSION);
+	printf("CONFIG - MATCH: %d, MISMATCH: %d, INDEL_OPEN: %d, INDEL_EXTEND %d\n",
+			MATCH_SCORE, MISMATCH_SCORE, OPEN_INDEL_SCORE, EXTEND_INDEL_SCORE);
+	printf("CONFIG - LANES: %d, THREADS: %d \n", SIMD_LANES, omp_get_max_threads());
+	printf("Build: %s - %s \n", __DATE__, __TIME__ );
+
+	return (SUCCESS);
+}
+
+psaError_t transformDataSequences2b(sequences_t *sequences, const uint32_t paddingEntries)
+{
+	uint32_t idSequence, position, size;
+	uint32_t currentHlfRAWEntry = 0, numHlfRAWEntries;
+
+	sequences->numRAWHlfEntries = sequences_totalEntriesHlfRAW(sequences->h_size, sequences->num, RAW_4B_LENGTH);
+
+	sequences->h_HlfRAW = (RAWHlfEntry_t *) calloc(sequences->numRAWHlfEntries + paddingEntries, sizeof(RAWHlfEntry_t));
+	if (sequences->h_HlfRAW == NULL) return (E_ALLOCATE_MEM);
+
+	sequences->h_HlfRAWposition = (uint32_t *) malloc(sequences->num * sizeof(uint32_t));
+	if (sequences->h_HlfRAWposition == NULL) return (E_ALLOCATE_MEM);
+
+	for (idSequence = 0; idSequence < sequences->num; ++idSequence)
+	{
+		position = sequences->h_ASCIIposition[idSequence];
+		size = sequences->h_size[idSequence];
+		numHlfRAWEntries = DIV_CEIL(size, RAW_BASES_PER_ENTRY);
+
+		sequenceASCIItoRAW_2x32bits(sequences->h_ASCII + position, size, sequences->h_HlfRAW + currentHlfRAWEntry);
+		sequences->h_HlfRAWposition[idSequence] = currentHlfRAWEntry;
+		currentHlfRAWEntry += numHlfRAWEntries;
+	}
+
+	sequences->formats |= SEQ_HLF_RAW;
+	return (SUCCESS);
+}
+
+psaError_t transformDataReferences(sequences_t *references)
+{
+	// one extra entry: unaligned candidates always read two consecutive entries
+	return(transformDataSequences2b(references, 1));
+}
+
+psaError_t transformDataQueries(sequences_t *queries)
+{
+	return(transformDataSequences2b(queries, 0));
+}
+
+psaError_t transformDataCandidates(sequences_t *candidates)
+{
+	// candidates are read directly from the reference
+	(void) candidates;
+	return (SUCCESS);
+}
+
+/* Gathers, for every lane, the 16 bases of the reference starting at position[lane] */
+void gatherReferenceEntries(const RAWHlfEntry_t *reference, const uint32_t *position, uint32_t *entries)
+{
+	uint32_t idLane;
+
+	#if defined(__AVX512F__)
+	for(idLane = 0; idLane < SIMD_LANES; idLane += 16){
+		const __m512i vPosition = _mm512_loadu_si512(position + idLane);
+		const __m512i vIndex	= _mm512_srli_epi32(vPosition, 4);
+		const __m512i vShift	= _mm512_slli_epi32(_mm512_and_si512(vPosition, _mm512_set1_epi32(RAW_BASES_PER_ENTRY - 1)), 1);
+		const __m512i vLow		= _mm512_i32gather_epi32(vIndex, (const int *) reference, 4);
+		const __m512i vHigh		= _mm512_i32gather_epi32(_mm512_add_epi32(vIndex, _mm512_set1_epi32(1)), (const int *) reference, 4);
+		// a shift by 32 bits yields zero, handling the aligned positions
+		const __m512i vEntry	= _mm512_or_si512(_mm512_srlv_epi32(vLow, vShift),
+												  _mm512_sllv_epi32(vHigh, _mm512_sub_epi32(_mm512_set1_epi32(UINT32_LENGTH), vShift)));
+		_mm512_storeu_si512(entries + idLane, vEntry);
+	}
+	#else
+	for(idLane = 0; idLane < SIMD_LANES; idLane += 8){
+		const __m256i vPosition = _mm256_loadu_si256((const __m256i *) (position + idLane));
+		const __m256i vIndex	= _mm256_srli_epi32(vPosition, 4);
+		const __m256i vShift	= _mm256_slli_epi32(_mm256_and_si256(vPosition, _mm256_set1_epi32(RAW_BASES_PER_ENTRY - 1)), 1);
+		const __m256i vLow		= _mm256_i32gather_epi32((const int *) reference, vIndex, 4);
+		const __m256i vHigh		= _mm256_i32gather_epi32((const int *) reference, _mm256_add_epi32(vIndex, _mm256_set1_epi32(1)), 4);
+		// a shift by 32 bits yields zero, handling the aligned positions
+		const __m256i vEntry	= _mm256_or_si256(_mm256_srlv_epi32(vLow, vShift),
+												  _mm256_sllv_epi32(vHigh, _mm256_sub_epi32(_mm256_set1_epi32(UINT32_LENGTH), vShift)));
+		_mm256_storeu_si256((__m256i *) (entries + idLane), vEntry);
+	}
+	#endif
+}
+
+/* Interleaves the candidates of a group of alignments, one base per lane, gathering them from the reference */
+void interleaveCandidates(const RAWHlfEntry_t *reference, const uint32_t *refPosition, const uint32_t *size,
+						  uint32_t numColumns, int16_t *interleaved)
+{
+	uint32_t position[SIMD_LANES] __attribute__((aligned(SIMD_ALIGNMENT)));
+	uint32_t entries[SIMD_LANES] __attribute__((aligned(SIMD_ALIGNMENT)));
+	uint32_t idColumn, idBase, idLane;
+
+	for(idColumn = 0; idColumn < numColumns; idColumn += RAW_BASES_PER_ENTRY){
+		// finished candidates are redirected to the reference start to avoid out of bounds accesses
+		for(idLane = 0; idLane < SIMD_LANES; ++idLane)
+			position[idLane] = (idColumn < size[idLane]) ? refPosition[idLane] + idColumn : 0;
+
+		gatherReferenceEntries(reference, position, entries);
+
+		for(idBase = 0; (idBase < RAW_BASES_PER_ENTRY) && (idColumn + idBase < numColumns); ++idBase){
+			for(idLane = 0; idLane < SIMD_LANES; ++idLane){
+				interleaved[(idColumn + idBase) * SIMD_LANES + idLane] = (idColumn + idBase < size[idLane]) ?
+						(entries[idLane] >> (idBase * RAW_4B_LENGTH)) & 0x3 : CANDIDATE_PAD_SYMBOL;
+			}
+		}
+	}
+}
+
+/* Interleaves the 2 bits queries of a group of alignments, one base per lane */
+void interleaveQueries(const RAWHlfEntry_t *queries, const uint32_t *HlfRAWposition, const uint32_t *size,
+					   const uint32_t *ids, uint32_t numLanes, uint32_t numRows, int16_t *interleaved)
+{
+	uint32_t idRow, idLane;
+
+	for(idLane = 0; idLane < SIMD_LANES; ++idLane){
+		const RAWHlfEntry_t *query = (idLane < numLanes) ? queries + HlfRAWposition[ids[idLane]] : NULL;
+		const uint32_t querySize = (idLane < numLanes) ? size[ids[idLane]] : 0;
+		for(idRow = 0; idRow < numRows; ++idRow){
+			interleaved[idRow * SIMD_LANES + idLane] = (idRow < querySize) ?
+					(query[idRow / RAW_BASES_PER_ENTRY] >> ((idRow % RAW_BASES_PER_ENTRY) * RAW_4B_LENGTH)) & 0x3 : QUERY_PAD_SYMBOL;
+		}
+	}
+}
+
+void localProcessSWGInter(const simd16_t *vQuery, uint32_t numRows, const simd16_t *vCandidate, uint32_t numColumns,
+						  simd16_t *vH, simd16_t *vE, int16_t *scores)
+{
+	const simd16_t vZero	 = simd16_zero();
+	const simd16_t vMatch	 = simd16_set1(MATCH_SCORE);
+	const simd16_t vMismatch = simd16_set1(MISMATCH_SCORE);
+	const simd16_t vGapOpen  = simd16_set1(OPEN_INDEL_SCORE);
+	const simd16_t vGapExt   = simd16_set1(EXTEND_INDEL_SCORE);
+	simd16_t vMaxScore = vZero;
+	simd16_t vHDiag, vHLeft, vHCell, vECell, vF, vBase;
+	uint32_t idColumn, idRow;
+
+	for(idRow = 0; idRow < numRows; ++idRow){
+		simd16_store(vH + idRow, vZero);
+		simd16_store(vE + idRow, vZero);
+	}
+
+	// Compute Score SW-GOTOH: one column per candidate base, one row per query base
+	for(idColumn = 0; idColumn < numColumns; ++idColumn){
+		vBase  = simd16_load(vCandidate + idColumn);
+		vHDiag = vZero;
+		vHCell = vZero;
+		vF	   = vZero;
+
+		for(idRow = 0; idRow < numRows; ++idRow){
+			vHLeft = simd16_load(vH + idRow);
+
+			vECell = simd16_max(simd16_adds(simd16_load(vE + idRow), vGapExt), simd16_adds(vHLeft, vGapOpen));
+			vF	   = simd16_max(simd16_adds(vF, vGapExt), simd16_adds(vHCell, vGapOpen));
+
+			vHCell = simd16_adds(vHDiag, simd16_select_eq(simd16_load(vQuery + idRow), vBase, vMatch, vMismatch));
+			vHCell = simd16_max(vHCell, vECell);
+			vHCell = simd16_max(vHCell, vF);
+			vHCell = simd16_max(vHCell, vZero);
+
+			vMaxScore = simd16_max(vMaxScore, vHCell);
+			simd16_store(vE + idRow, vECell);
+			simd16_store(vH + idRow, vHCell);
+			vHDiag = vHLeft;
+		}
+	}
+
+	simd16_store(scores, vMaxScore);
+}
+
+psaError_t processPairwiseReference(sequences_t* references, sequences_t *candidates, sequences_t *queries, alignments_t *alignments)
+{
+	const uint32_t numGroups = DIV_CEIL(candidates->num, SIMD_LANES);
+	uint32_t idQuery, idCandidate, maxQuerySize = 0, maxCandidateSize = 0;
+	int32_t idGroup;
+	psaError_t error = SUCCESS;
+
+	for (idQuery = 0; idQuery < queries->num; ++idQuery)
+		maxQuerySize = MAX(maxQuerySize, queries->h_size[idQuery]);
+	for (idCandidate = 0; idCandidate < candidates->num; ++idCandidate)
+		maxCandidateSize = MAX(maxCandidateSize, candidates->h_size[idCandidate]);
+
+	#pragma omp parallel
+	{
+		simd16_t *vQuery	 = (simd16_t *) simd_malloc(maxQuerySize * sizeof(simd16_t));
+		simd16_t *vCandidate = (simd16_t *) simd_malloc(maxCandidateSize * sizeof(simd16_t));
+		simd16_t *vH		 = (simd16_t *) simd_malloc(maxQuerySize * sizeof(simd16_t));
+		simd16_t *vE		 = (simd16_t *) simd_malloc(maxQuerySize * sizeof(simd16_t));
+		int16_t scores[SIMD_LANES] __attribute__((aligned(SIMD_ALIGNMENT)));
+		uint32_t queryIds[SIMD_LANES], refPosition[SIMD_LANES], candidateSize[SIMD_LANES];
+
+		if ((vQuery == NULL) || (vCandidate == NULL) || (vH == NULL) || (vE == NULL)){
+			#pragma omp critical
+			error = E_ALLOCATE_MEM;
+		}
+
+		#pragma omp for schedule(dynamic, 4)
+		for (idGroup = 0; idGroup < (int32_t) numGroups; ++idGroup)
+		{
+			const uint32_t firstCandidate = idGroup * SIMD_LANES;
+			const uint32_t numLanes = MIN(SIMD_LANES, candidates->num - firstCandidate);
+			const uint32_t nextCandidate = firstCandidate + SIMD_LANES;
+			uint32_t idLane, numRows = 0, numColumns = 0;
+			if (error != SUCCESS) continue;
+
+			for(idLane = 0; idLane < SIMD_LANES; ++idLane){
+				const uint32_t idCandidate = firstCandidate + idLane;
+				queryIds[idLane]	  = (idLane < numLanes) ? alignments->h_info[idCandidate] : 0;
+				refPosition[idLane]	  = (idLane < numLanes) ? candidates->h_refPosition[idCandidate] : 0;
+				candidateSize[idLane] = (idLane < numLanes) ? candidates->h_size[idCandidate] : 0;
+				numRows	   = MAX(numRows, (idLane < numLanes) ? queries->h_size[queryIds[idLane]] : 0);
+				numColumns = MAX(numColumns, candidateSize[idLane]);
+			}
+
+			// start fetching the reference regions of the next group while this one is being aligned
+			for(idLane = 0; (idLane < SIMD_LANES) && (nextCandidate + idLane < candidates->num); ++idLane)
+				_mm_prefetch((const char *) (references->h_HlfRAW + candidates->h_refPosition[nextCandidate + idLane] / RAW_BASES_PER_ENTRY), _MM_HINT_T0);
+
+			interleaveQueries(queries->h_HlfRAW, queries->h_HlfRAWposition, queries->h_size, queryIds,
+							  numLanes, numRows, (int16_t *) vQuery);
+			interleaveCandidates(references->h_HlfRAW, refPosition, candidateSize, numColumns, (int16_t *) vCandidate);
+
+			localProcessSWGInter(vQuery, numRows, vCandidate, numColumns, vH, vE, scores);
+
+			for(idLane = 0; idLane < numLanes; ++idLane){
+				alignments->h_results[firstCandidate + idLane].column = 0;
+				alignments->h_results[firstCandidate + idLane].score  = scores[idLane];
+			}
+		}
+
+		free(vQuery);
+		free(vCandidate);
+		free(vH);
+		free(vE);
+	}
+
+	return (error);
+}
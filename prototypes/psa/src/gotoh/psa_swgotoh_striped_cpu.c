@@ -0,0 +1,195 @@
+/*
+ * PROJECT: Pairwise sequence alignments on GPU
+ * FILE: psa_swgotoh_striped_cpu
+ * AUTHOR(S): Alejandro Chacon <alejandro.chacon@uab.es>
+ * DESCRIPTION: Functions for the SW-Gotoh CPU SIMD implementation using:
+ *				(A) LOCAL alignments
+ *				(B) Farrar striped query profile (intra-sequence parallelism) [1]
+ *				(C) AVX2 / AVX-512BW with 16 bits per cell
+ *				(D) OpenMP to distribute the alignments among the cores
+ *
+ *	[1] Striped Smith-Waterman speeds database searches six times over other SIMD implementations.
+ */
+
+#include "../../include/psa_pairwise.h"
+#include "../../include/psa_simd_cpu.h"
+#include <omp.h>
+
+#define MATCH_SCORE			 2
+#define MISMATCH_SCORE 		-5
+#define OPEN_INDEL_SCORE	-2
+#define EXTEND_INDEL_SCORE	-1
+
+#define BUILD_ALGORITHM	"SMITH & WATERMAN GOTOH"
+#define BUILD_VERSION 	"CPU " SIMD_ISA " STRIPED (FARRAR) 16bits per cell"
+#define BUILD_TAG		"sw-gotoh.striped.16b." SIMD_TAG ".cpu"
+
+char* buildTag()
+{
+	return (BUILD_TAG);
+}
+
+psaError_t printBuildInfo()
+{
+	printf("%s \n", BUILD_ALGORITHM);
+	printf("%s \n", BUILD_VERSION);
+	printf("CONFIG - MATCH: %d, MISMATCH: %d, OPEN_INDEL: %d, EXTEND_INDEL: %d \n",
+			MATCH_SCORE, MISMATCH_SCORE, OPEN_INDEL_SCORE, EXTEND_INDEL_SCORE);
+	printf("CONFIG - LANES: %d, THREADS: %d \n", SIMD_LANES, omp_get_max_threads());
+	printf("Build: %s - %s \n", __DATE__, __TIME__ );
+
+	return (SUCCESS);
+}
+
+psaError_t transformDataQueries(sequences_t *queries)
+{
+	uint32_t idBase;
+
+	for (idBase = 0; idBase < queries->numASCIIEntries; ++idBase)
+		queries->h_ASCII[idBase] = ASCIItoIndex(ASCIItoUpperCase(queries->h_ASCII[idBase]));
+
+	queries->formats |= SEQ_ASCII;
+
+	return (SUCCESS);
+}
+
+psaError_t transformDataCandidates(sequences_t *candidates)
+{
+	uint32_t idBase;
+
+	for (idBase = 0; idBase < candidates->numASCIIEntries; ++idBase)
+		candidates->h_ASCII[idBase] = ASCIItoIndex(ASCIItoUpperCase(candidates->h_ASCII[idBase]));
+
+	candidates->formats |= SEQ_ASCII;
+
+	return (SUCCESS);
+}
+
+/* Builds the striped score profile of a query: the cell (j, lane) of the segment j
+   holds the query position j + lane * segLen. Padding positions always mismatch. */
+void buildStripedProfile(const char *query, uint32_t querySize, uint32_t segLen, simd16_t *profile)
+{
+	int16_t *profileCells = (int16_t *) profile;
+	uint32_t idBase, idSegment, idLane, position;
+
+	for(idBase = 0; idBase < NUM_BASES; ++idBase){
+		for(idSegment = 0; idSegment < segLen; ++idSegment){
+			for(idLane = 0; idLane < SIMD_LANES; ++idLane){
+				position = idSegment + idLane * segLen;
+				profileCells[(idBase * segLen + idSegment) * SIMD_LANES + idLane] =
+					((position < querySize) && ((uint32_t) query[position] == idBase)) ? MATCH_SCORE : MISMATCH_SCORE;
+			}
+		}
+	}
+}
+
+int32_t localProcessSWGStriped(const simd16_t *profile, uint32_t segLen, const char *candidate, uint32_t candidateSize,
+							   simd16_t *vHStore, simd16_t *vHLoad, simd16_t *vE)
+{
+	const simd16_t vZero	 = simd16_zero();
+	const simd16_t vGapOpen  = simd16_set1(-OPEN_INDEL_SCORE);
+	const simd16_t vGapExt   = simd16_set1(-EXTEND_INDEL_SCORE);
+	simd16_t vMaxScore = vZero;
+	simd16_t vH, vF, vTemp;
+	simd16_t *vSwap;
+	uint32_t idColumn, j;
+
+	for(j = 0; j < segLen; ++j){
+		simd16_store(vHStore + j, vZero);
+		simd16_store(vE + j, vZero);
+	}
+
+	// Compute Score SW-GOTOH: one column per candidate base
+	for(idColumn = 0; idColumn < candidateSize; ++idColumn){
+		const simd16_t *vP = profile + candidate[idColumn] * segLen;
+
+		vF = vZero;
+		vH = simd16_shift_lane(simd16_load(vHStore + segLen - 1));
+
+		vSwap = vHLoad; vHLoad = vHStore; vHStore = vSwap;
+
+		for(j = 0; j < segLen; ++j){
+			vH = simd16_adds(vH, simd16_load(vP + j));
+			vH = simd16_max(vH, simd16_load(vE + j));
+			vH = simd16_max(vH, vF);
+			vMaxScore = simd16_max(vMaxScore, vH);
+			simd16_store(vHStore + j, vH);
+
+			// E and F are kept non-negative, which doesn't alter the local H scores
+			vH    = simd16_subs_u(vH, vGapOpen);
+			vTemp = simd16_subs_u(simd16_load(vE + j), vGapExt);
+			simd16_store(vE + j, simd16_max(vTemp, vH));
+			vF    = simd16_max(simd16_subs_u(vF, vGapExt), vH);
+
+			vH = simd16_load(vHLoad + j);
+		}
+
+		// Lazy-F loop: propagate the vertical gaps across the segment boundaries
+		j  = 0;
+		vF = simd16_shift_lane(vF);
+		while(simd16_any_gt(vF, simd16_subs_u(simd16_load(vHStore + j), vGapOpen))){
+			vH = simd16_max(simd16_load(vHStore + j), vF);
+			simd16_store(vHStore + j, vH);
+			vMaxScore = simd16_max(vMaxScore, vH);
+			simd16_store(vE + j, simd16_max(simd16_load(vE + j), simd16_subs_u(vH, vGapOpen)));
+			vF = simd16_subs_u(vF, vGapExt);
+			if(++j >= segLen){
+				j  = 0;
+				vF = simd16_shift_lane(vF);
+			}
+		}
+	}
+
+	return(simd16_hmax(vMaxScore));
+}
+
+psaError_t processPairwiseStream(sequences_t *candidates, sequences_t *queries, alignments_t *alignments)
+{
+	uint32_t idQuery, maxQuerySize = 0;
+	int32_t idCandidate;
+	psaError_t error = SUCCESS;
+
+	for (idQuery = 0; idQuery < queries->num; ++idQuery)
+		maxQuerySize = MAX(maxQuerySize, queries->h_size[idQuery]);
+
+	#pragma omp parallel
+	{
+		const uint32_t maxSegLen = DIV_CEIL(maxQuerySize, SIMD_LANES);
+		simd16_t *profile = (simd16_t *) simd_malloc(NUM_BASES * maxSegLen * sizeof(simd16_t));
+		simd16_t *vHStore = (simd16_t *) simd_malloc(maxSegLen * sizeof(simd16_t));
+		simd16_t *vHLoad  = (simd16_t *) simd_malloc(maxSegLen * sizeof(simd16_t));
+		simd16_t *vE      = (simd16_t *) simd_malloc(maxSegLen * sizeof(simd16_t));
+		uint32_t profileQuery = UINT32_ONES, segLen = 0;
+
+		if ((profile == NULL) || (vHStore == NULL) || (vHLoad == NULL) || (vE == NULL)){
+			#pragma omp critical
+			error = E_ALLOCATE_MEM;
+		}
+
+		// the candidates of the same query are contiguous: keep each thread on a contiguous range
+		#pragma omp for schedule(dynamic, 64)
+		for (idCandidate = 0; idCandidate < (int32_t) candidates->num; ++idCandidate)
+		{
+			const uint32_t query = alignments->h_info[idCandidate];
+			if (error != SUCCESS) continue;
+
+			if (query != profileQuery){
+				segLen = DIV_CEIL(queries->h_size[query], SIMD_LANES);
+				buildStripedProfile(&queries->h_ASCII[queries->h_ASCIIposition[query]], queries->h_size[query], segLen, profile);
+				profileQuery = query;
+			}
+
+			alignments->h_results[idCandidate].column = 0;
+			alignments->h_results[idCandidate].score  = localProcessSWGStriped(profile, segLen,
+					&candidates->h_ASCII[candidates->h_ASCIIposition[idCandidate]], candidates->h_size[idCandidate],
+					vHStore, vHLoad, vE);
+		}
+
+		free(profile);
+		free(vHStore);
+		free(vHLoad);
+		free(vE);
+	}
+
+	return (error);
+}